@@ -0,0 +1,727 @@
+/**************************************************************************
+ *
+ *  Multi-configuration sweep runner implementation file.
+ *
+ */
+
+#include "SweepRunner.h"
+
+#include "perfmodel.h"
+#include "param_loader.hpp"
+#include "MetaStream.h"
+#include "support.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <functional>
+#include <chrono>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+using namespace std;
+
+namespace arch
+{
+
+//  Status of a configuration whose worker has not reported a result.
+static const S32 SWEEP_STATUS_RUNNING = -1;
+
+/**
+ *  Shared memory state of the MetaStream ring buffer.  The ring data follows the structure.
+ *
+ *  The parent process is the only writer.  Positions are absolute byte counts, the writer
+ *  can only advance up to capacity bytes ahead of the slowest active reader.  Workers that
+ *  terminate are detached so they don't stall the writer.
+ */
+struct cgsSweepQueueState
+{
+#ifndef _WIN32
+    pthread_mutex_t mutex;                          //  Protects the positions and flags.
+    pthread_cond_t dataAvailable;                   //  Signaled by the writer when data is added or the ring is closed.
+    pthread_cond_t spaceAvailable;                  //  Signaled by the readers when data is consumed or a reader detaches.
+#endif
+    U64 capacity;                                   //  Size of the ring data in bytes.
+    U64 writePosition;                              //  Bytes written.
+    bool closed;                                    //  Set by the writer after the last MetaStream.
+    U32 numReaders;                                 //  Number of readers (workers).
+    U64 readPosition[SWEEP_MAX_CONFIGS];            //  Bytes read per reader.
+    bool readerActive[SWEEP_MAX_CONFIGS];           //  Reader is attached.
+    cgsSweepResult results[SWEEP_MAX_CONFIGS];      //  Results written by the workers.
+};
+
+#ifndef _WIN32
+
+//  Offset of the ring data from the start of the shared memory region.
+static const U64 SWEEP_QUEUE_DATA_OFFSET = (sizeof(cgsSweepQueueState) + 63) & ~U64(63);
+
+//  Size of the local buffers of the ring writer and readers.
+static const U32 SWEEP_STREAM_BUFFER_SIZE = 256 * 1024;
+
+static inline U08 *queueData(cgsSweepQueueState *queue)
+{
+    return reinterpret_cast<U08 *>(queue) + SWEEP_QUEUE_DATA_OFFSET;
+}
+
+//  Locks the ring mutex.  A worker may die while holding the mutex so the mutex is robust.
+static void lockQueue(cgsSweepQueueState *queue)
+{
+    if (pthread_mutex_lock(&queue->mutex) == EOWNERDEAD)
+        pthread_mutex_consistent(&queue->mutex);
+}
+
+static void unlockQueue(cgsSweepQueueState *queue)
+{
+    pthread_mutex_unlock(&queue->mutex);
+}
+
+//  Waits on a ring condition for up to the defined milliseconds.
+static void waitQueue(cgsSweepQueueState *queue, pthread_cond_t *cond, U32 ms)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += long(ms) * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec = deadline.tv_nsec % 1000000000L;
+
+    if (pthread_cond_timedwait(cond, &queue->mutex, &deadline) == EOWNERDEAD)
+        pthread_mutex_consistent(&queue->mutex);
+}
+
+//  Copies data into or out of the ring at an absolute position.
+static void copyRing(cgsSweepQueueState *queue, U64 position, U08 *buffer, U64 bytes, bool toRing)
+{
+    U64 offset = position % queue->capacity;
+    U64 first = ((queue->capacity - offset) < bytes) ? (queue->capacity - offset) : bytes;
+    U08 *data = queueData(queue);
+
+    if (toRing)
+    {
+        memcpy(&data[offset], buffer, first);
+        memcpy(data, buffer + first, bytes - first);
+    }
+    else
+    {
+        memcpy(buffer, &data[offset], first);
+        memcpy(buffer + first, data, bytes - first);
+    }
+}
+
+/**
+ *  Stream buffer writing into the shared ring.  Blocks while the ring is full.
+ */
+class SweepQueueWriter : public std::streambuf
+{
+private:
+
+    cgsSweepQueueState *queue;
+    std::function<void()> stallHandler;     //  Called periodically while waiting for space in the ring.
+    std::vector<char> buffer;
+
+    void flushBuffer()
+    {
+        U08 *pending = reinterpret_cast<U08 *>(pbase());
+        U64 bytes = U64(pptr() - pbase());
+
+        while (bytes > 0)
+        {
+            lockQueue(queue);
+
+            U64 minRead = queue->writePosition;
+            bool anyReader = false;
+            for(U32 r = 0; r < queue->numReaders; r++)
+            {
+                if (queue->readerActive[r])
+                {
+                    minRead = (queue->readPosition[r] < minRead) ? queue->readPosition[r] : minRead;
+                    anyReader = true;
+                }
+            }
+
+            //  Without readers the data is dropped.
+            if (!anyReader)
+            {
+                queue->writePosition += bytes;
+                unlockQueue(queue);
+                break;
+            }
+
+            U64 space = queue->capacity - (queue->writePosition - minRead);
+
+            if (space == 0)
+            {
+                waitQueue(queue, &queue->spaceAvailable, 100);
+                unlockQueue(queue);
+                stallHandler();
+                continue;
+            }
+
+            U64 position = queue->writePosition;
+            unlockQueue(queue);
+
+            //  The region between the write position and the slowest reader plus the capacity is owned by the writer.
+            U64 chunk = (space < bytes) ? space : bytes;
+            copyRing(queue, position, pending, chunk, true);
+
+            lockQueue(queue);
+            queue->writePosition += chunk;
+            pthread_cond_broadcast(&queue->dataAvailable);
+            unlockQueue(queue);
+
+            pending += chunk;
+            bytes -= chunk;
+        }
+
+        setp(&buffer[0], &buffer[0] + buffer.size());
+    }
+
+protected:
+
+    int overflow(int c)
+    {
+        flushBuffer();
+
+        if (c != EOF)
+        {
+            *pptr() = char(c);
+            pbump(1);
+        }
+
+        return (c == EOF) ? 0 : c;
+    }
+
+    int sync()
+    {
+        flushBuffer();
+        return 0;
+    }
+
+public:
+
+    SweepQueueWriter(cgsSweepQueueState *queue, std::function<void()> stallHandler) :
+        queue(queue), stallHandler(stallHandler), buffer(SWEEP_STREAM_BUFFER_SIZE)
+    {
+        setp(&buffer[0], &buffer[0] + buffer.size());
+    }
+
+    //  Flushes the pending data and marks the end of the MetaStream sequence.
+    void close()
+    {
+        flushBuffer();
+
+        lockQueue(queue);
+        queue->closed = true;
+        pthread_cond_broadcast(&queue->dataAvailable);
+        unlockQueue(queue);
+    }
+};
+
+/**
+ *  Stream buffer reading from the shared ring for a worker.  Blocks while the ring is empty.
+ */
+class SweepQueueReader : public std::streambuf
+{
+private:
+
+    cgsSweepQueueState *queue;
+    U32 id;
+    std::vector<char> buffer;
+
+protected:
+
+    int underflow()
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+        lockQueue(queue);
+
+        while ((queue->readPosition[id] == queue->writePosition) && !queue->closed)
+            waitQueue(queue, &queue->dataAvailable, 1000);
+
+        U64 position = queue->readPosition[id];
+        U64 available = queue->writePosition - position;
+
+        unlockQueue(queue);
+
+        if (available == 0)
+            return EOF;
+
+        //  The data between the reader position and the write position is not modified until the reader advances.
+        U64 chunk = (available < buffer.size()) ? available : buffer.size();
+        copyRing(queue, position, reinterpret_cast<U08 *>(&buffer[0]), chunk, false);
+
+        lockQueue(queue);
+        queue->readPosition[id] += chunk;
+        pthread_cond_broadcast(&queue->spaceAvailable);
+        unlockQueue(queue);
+
+        setg(&buffer[0], &buffer[0], &buffer[0] + chunk);
+
+        return traits_type::to_int_type(*gptr());
+    }
+
+public:
+
+    SweepQueueReader(cgsSweepQueueState *queue, U32 id) :
+        queue(queue), id(id), buffer(SWEEP_STREAM_BUFFER_SIZE)
+    {
+        setg(&buffer[0], &buffer[0], &buffer[0]);
+    }
+
+    //  Stops reading from the ring so the writer doesn't wait for this reader.
+    void detach()
+    {
+        lockQueue(queue);
+        queue->readerActive[id] = false;
+        pthread_cond_broadcast(&queue->spaceAvailable);
+        unlockQueue(queue);
+    }
+};
+
+/**
+ *  Trace driver of a sweep worker.  Provides the MetaStreams read from the shared ring.
+ */
+class SweepTraceDriver : public cgoTraceDriverBase
+{
+private:
+
+    SweepQueueReader reader;
+    std::istream in;
+    U32 position;
+
+public:
+
+    SweepTraceDriver(cgsSweepQueueState *queue, U32 id, TraceTyp type) :
+        reader(queue, id), in(&reader), position(0)
+    {
+        //  The MetaStream trace position can only be saved by the MetaStream trace driver.
+        traceTyp = (type == TraceTypCgp) ? TraceTypOgl : type;
+    }
+
+    ~SweepTraceDriver()
+    {
+        reader.detach();
+    }
+
+    int startTrace()
+    {
+        return 0;
+    }
+
+    cgoMetaStream *nxtMetaStream()
+    {
+        cgoMetaStream *metaStream = cgoMetaStream::deserialize(in);
+
+        if (metaStream != NULL)
+            position++;
+
+        return metaStream;
+    }
+
+    U32 getTracePosition()
+    {
+        return position;
+    }
+};
+
+#endif  // _WIN32
+
+//  Creates a sweep runner.
+cgoSweepRunner::cgoSweepRunner(const char *sweepFile, const char *defaultParamFile, const char *defaultArch,
+                               const char *outDir, U32 queueSizeMB) :
+    baseParamFile(defaultParamFile), baseArchName(defaultArch), outputDir(outDir),
+    queueSize(U64(queueSizeMB) * 1024 * 1024), queue(NULL)
+{
+    ifstream in(sweepFile);
+
+    CG_ASSERT_COND(in.is_open(), "Error opening sweep configuration file %s.", sweepFile);
+    CG_ASSERT_COND(!(queueSize == 0), "The sweep queue size must be at least 1 MByte.");
+
+    string line;
+    U32 lineNumber = 0;
+
+    while (getline(in, line))
+    {
+        lineNumber++;
+
+        istringstream tokens(line);
+        string token;
+
+        if (!(tokens >> token) || (token[0] == '#'))
+            continue;
+
+        cgsSweepConfig config;
+        config.name = token;
+        config.paramFile = defaultParamFile;
+        config.archName = defaultArch;
+
+        while (tokens >> token)
+        {
+            size_t equal = token.find('=');
+
+            if ((token == "--param") && (tokens >> token))
+                config.paramFile = token;
+            else if ((token == "--arch") && (tokens >> token))
+                config.archName = token;
+            else if ((equal != string::npos) && (equal > 0))
+                config.overrides.push_back(make_pair(token.substr(0, equal), token.substr(equal + 1)));
+            else
+                CG_ASSERT("Sweep file %s line %d : unexpected token '%s'.", sweepFile, lineNumber, token.c_str());
+        }
+
+        for(size_t c = 0; c < configs.size(); c++)
+            CG_ASSERT_COND(!(configs[c].name == config.name), "Sweep file %s line %d : configuration %s already defined.",
+                           sweepFile, lineNumber, config.name.c_str());
+
+        configs.push_back(config);
+    }
+
+    CG_ASSERT_COND(!configs.empty(), "No configurations defined in the sweep file %s.", sweepFile);
+    CG_ASSERT_COND(!(configs.size() > SWEEP_MAX_CONFIGS), "Too many configurations in the sweep file (maximum is %d).", SWEEP_MAX_CONFIGS);
+}
+
+cgoSweepRunner::~cgoSweepRunner()
+{
+#ifndef _WIN32
+    if (queue != NULL)
+    {
+        pthread_cond_destroy(&queue->dataAvailable);
+        pthread_cond_destroy(&queue->spaceAvailable);
+        pthread_mutex_destroy(&queue->mutex);
+        munmap(queue, SWEEP_QUEUE_DATA_OFFSET + queueSize);
+    }
+#endif
+}
+
+//  Loads a configuration into the ArchParams singleton.
+void cgoSweepRunner::loadConfig(const cgsSweepConfig &config, const cgsArchConfig &baseConf, cgsArchConfig &archConf)
+{
+    try
+    {
+        ArchParams::init(config.paramFile, config.archName);
+    }
+    catch (const std::exception &e)
+    {
+        CG_ASSERT("Sweep configuration %s : %s", config.name.c_str(), e.what());
+    }
+
+    ArchParams &params = ArchParams::instance();
+
+    for(size_t o = 0; o < config.overrides.size(); o++)
+    {
+        CG_ASSERT_COND(!(params.get_param_map().find(config.overrides[o].first) == params.get_param_map().end()),
+                       "Sweep configuration %s : unknown parameter %s.", config.name.c_str(), config.overrides[o].first.c_str());
+        params.set(config.overrides[o].first, config.overrides[o].second);
+    }
+
+    //  The input trace and the simulated range are shared by all the configurations.
+    params.set("SIMULATOR_INPUT_FILE", baseConf.sim.inputFile);
+    params.set("SIMULATOR_START_FRAME", to_string(baseConf.sim.startFrame));
+    params.set("SIMULATOR_SIM_FRAMES", to_string(baseConf.sim.simFrames));
+    params.set("SIMULATOR_SIM_CYCLES", to_string(baseConf.sim.simCycles));
+
+    params.populateArchConfig(&archConf);
+}
+
+//  Checks the parameters used by the driver (see the HAL configuration in computrender.cpp).
+bool cgoSweepRunner::sameDriverParams(const cgsArchConfig &a, const cgsArchConfig &b)
+{
+    return (a.mem.memSize == b.mem.memSize) &&
+           (a.mem.mappedMemSize == b.mem.mappedMemSize) &&
+           (a.ush.texBlockDim == b.ush.texBlockDim) &&
+           (a.ush.texSuperBlockDim == b.ush.texSuperBlockDim) &&
+           (a.ras.scanWidth == b.ras.scanWidth) &&
+           (a.ras.scanHeight == b.ras.scanHeight) &&
+           (a.ras.overScanWidth == b.ras.overScanWidth) &&
+           (a.ras.overScanHeight == b.ras.overScanHeight) &&
+           (a.sim.colorDoubleBuffer == b.sim.colorDoubleBuffer) &&
+           (a.sim.forceMSAA == b.sim.forceMSAA) &&
+           (a.sim.msaaSamples == b.sim.msaaSamples) &&
+           (a.sim.forceFP16ColorBuffer == b.sim.forceFP16ColorBuffer) &&
+           (a.ush.useVectorShader == b.ush.useVectorShader) &&
+           (strcmp(a.ush.vectorALUConfig, b.ush.vectorALUConfig) == 0) &&
+           (a.ush.fetchRate == b.ush.fetchRate) &&
+           (a.mem.memoryControllerV2 == b.mem.memoryControllerV2) &&
+           (a.mem.v2SecondInterleaving == b.mem.v2SecondInterleaving) &&
+           (a.ush.vAttrLoadFromShader == b.ush.vAttrLoadFromShader) &&
+           (a.sim.enableDriverShaderTranslation == b.sim.enableDriverShaderTranslation) &&
+           (a.ras.useMicroPolRast == b.ras.useMicroPolRast) &&
+           (a.ras.microTrisAsFragments == b.ras.microTrisAsFragments);
+}
+
+#ifndef _WIN32
+
+//  Worker process.
+void cgoSweepRunner::runWorker(U32 id, const cgsArchConfig &baseConf, cgeModelAbstractLevel MAL, TraceTyp traceTyp)
+{
+    cgsSweepResult &result = queue->results[id];
+    S32 status = 1;
+
+    try
+    {
+        //  Load the configuration before changing the directory, parameter file paths may be relative.
+        cgsArchConfig archConf;
+        loadConfig(configs[id], baseConf, archConf);
+
+        string dirName = outputDir + "/" + configs[id].name;
+        CG_ASSERT_COND((changeDirectory(const_cast<char *>(dirName.c_str())) == 0), "Error changing to directory %s.", dirName.c_str());
+
+        //  Keep the simulator output of each configuration apart.
+        CG_ASSERT_COND((freopen("simulation.log", "w", stdout) != NULL), "Error creating the simulation log file.");
+
+        SweepTraceDriver traceDriver(queue, id, traceTyp);
+
+        ModelBase *model;
+        if (MAL == CG_PERF_MODEL)
+            model = new PerfModel(archConf, &traceDriver);
+        else
+            model = new BhavModel(archConf, &traceDriver);
+
+        bool multiClock = (archConf.gpu.gpuClock != archConf.gpu.shaderClock) || (archConf.gpu.gpuClock != archConf.gpu.memoryClock);
+
+        auto start = chrono::steady_clock::now();
+
+        if (multiClock)
+            model->simulationLoopMultiClock();
+        else
+            model->simulationLoop(CG_BEHV_MODEL);
+
+        result.wallTime = chrono::duration<F64>(chrono::steady_clock::now() - start).count();
+
+        U32 frameBatch;
+        model->getCycles(result.gpuCycle, result.shaderCycle, result.memoryCycle);
+        model->getCounters(result.frames, frameBatch, result.batches);
+
+        delete model;
+
+        status = 0;
+    }
+    catch (...)
+    {
+        fprintf(stderr, "Sweep configuration %s : simulation aborted.\n", configs[id].name.c_str());
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    lockQueue(queue);
+    result.status = status;
+    queue->readerActive[id] = false;
+    pthread_cond_broadcast(&queue->spaceAvailable);
+    unlockQueue(queue);
+
+    //  Skip the destructors of the objects inherited from the parent process.
+    _exit(status);
+}
+
+//  Checks for terminated workers.
+void cgoSweepRunner::reapWorkers(bool wait)
+{
+    for(U32 w = 0; w < workers.size(); w++)
+    {
+        if (workers[w] <= 0)
+            continue;
+
+        int status;
+        pid_t pid = waitpid(workers[w], &status, wait ? 0 : WNOHANG);
+
+        if (pid != workers[w])
+            continue;
+
+        workers[w] = 0;
+
+        lockQueue(queue);
+        queue->readerActive[w] = false;
+        if (queue->results[w].status == SWEEP_STATUS_RUNNING)
+            queue->results[w].status = WIFSIGNALED(status) ? -WTERMSIG(status) : SWEEP_STATUS_RUNNING;
+        pthread_cond_broadcast(&queue->spaceAvailable);
+        unlockQueue(queue);
+
+        if (queue->results[w].status < 0)
+            CG_WARN("Sweep configuration %s : worker terminated abnormally.", configs[w].name.c_str());
+    }
+}
+
+#endif  // _WIN32
+
+//  Prints and saves the summary table.
+void cgoSweepRunner::writeSummary()
+{
+    string fileName = outputDir + "/summary.csv";
+    ofstream csv(fileName.c_str());
+
+    CG_WARN_COND(!csv.is_open(), "Error creating sweep summary file %s.", fileName.c_str());
+
+    if (csv.is_open())
+        csv << "Config,Status,GPUCycles,ShaderCycles,MemoryCycles,Frames,Batches,WallTime(s),Cycles/s" << endl;
+
+    printf("\n%-24s %-10s %16s %8s %10s %12s %14s\n", "Config", "Status", "GPU Cycles", "Frames", "Batches", "Wall (s)", "Cycles/s");
+
+    for(U32 c = 0; c < configs.size(); c++)
+    {
+        const cgsSweepResult &result = queue->results[c];
+
+        char status[32];
+        if (result.status == 0)
+            snprintf(status, sizeof(status), "ok");
+        else if (result.status > 0)
+            snprintf(status, sizeof(status), "aborted");
+        else if (result.status == SWEEP_STATUS_RUNNING)
+            snprintf(status, sizeof(status), "failed");
+        else
+            snprintf(status, sizeof(status), "signal %d", -result.status);
+
+        F64 cyclesPerSecond = (result.wallTime > 0.0) ? F64(result.gpuCycle) / result.wallTime : 0.0;
+
+        printf("%-24s %-10s %16llu %8u %10u %12.2f %14.0f\n", configs[c].name.c_str(), status,
+            (unsigned long long) result.gpuCycle, result.frames, result.batches, result.wallTime, cyclesPerSecond);
+
+        if (csv.is_open())
+            csv << configs[c].name << "," << status << "," << result.gpuCycle << "," << result.shaderCycle << ","
+                << result.memoryCycle << "," << result.frames << "," << result.batches << "," << result.wallTime << ","
+                << cyclesPerSecond << endl;
+    }
+
+    printf("\n");
+}
+
+//  Simulates all the configurations.
+U32 cgoSweepRunner::run(cgoTraceDriverBase *frontEnd, const cgsArchConfig &baseConf, cgeModelAbstractLevel MAL)
+{
+#ifdef _WIN32
+    CG_ASSERT("Sweep mode requires fork() and is not supported on Windows.");
+    return getNumConfigs();
+#else
+    //  Check that the driver generates the same MetaStreams for all the configurations.
+    for(U32 c = 0; c < configs.size(); c++)
+    {
+        cgsArchConfig archConf;
+        loadConfig(configs[c], baseConf, archConf);
+        CG_ASSERT_COND(sameDriverParams(baseConf, archConf),
+                       "Sweep configuration %s : the parameters used by the driver differ from the base configuration.",
+                       configs[c].name.c_str());
+    }
+
+    //  The driver reads the parameters while generating the MetaStreams.
+    ArchParams::init(baseParamFile, baseArchName);
+
+    //  Create the output directories.
+    CG_ASSERT_COND(!(createDirectory(const_cast<char *>(outputDir.c_str())) < 0), "Error creating sweep directory %s.", outputDir.c_str());
+    for(U32 c = 0; c < configs.size(); c++)
+    {
+        string dirName = outputDir + "/" + configs[c].name;
+        CG_ASSERT_COND(!(createDirectory(const_cast<char *>(dirName.c_str())) < 0), "Error creating directory %s.", dirName.c_str());
+    }
+
+    //  Create the shared ring buffer.
+    void *region = mmap(NULL, SWEEP_QUEUE_DATA_OFFSET + queueSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    CG_ASSERT_COND(!(region == MAP_FAILED), "Error allocating the sweep shared memory queue.");
+
+    queue = static_cast<cgsSweepQueueState *>(region);
+    memset(queue, 0, sizeof(cgsSweepQueueState));
+    queue->capacity = queueSize;
+    queue->numReaders = U32(configs.size());
+
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init(&mutexAttr);
+    pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&queue->mutex, &mutexAttr);
+    pthread_mutexattr_destroy(&mutexAttr);
+
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&queue->dataAvailable, &condAttr);
+    pthread_cond_init(&queue->spaceAvailable, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+
+    for(U32 c = 0; c < configs.size(); c++)
+    {
+        queue->readerActive[c] = true;
+        queue->results[c].status = SWEEP_STATUS_RUNNING;
+    }
+
+    //  Start the workers.
+    fflush(stdout);
+    fflush(stderr);
+    workers.assign(configs.size(), 0);
+
+    for(U32 c = 0; c < configs.size(); c++)
+    {
+        pid_t pid = fork();
+
+        CG_ASSERT_COND(!(pid < 0), "Error creating the worker process for sweep configuration %s.", configs[c].name.c_str());
+
+        if (pid == 0)
+            runWorker(c, baseConf, MAL, frontEnd->getTraceTyp());
+
+        workers[c] = pid;
+        CG_INFO("Sweep configuration %s : worker %d.", configs[c].name.c_str(), pid);
+    }
+
+    //  Run the driver and share the MetaStreams with the workers.
+    SweepQueueWriter writer(queue, [this]() { reapWorkers(false); });
+    ostream out(&writer);
+
+    auto start = chrono::steady_clock::now();
+    U32 metaStreams = 0;
+    bool activeWorkers = true;
+
+    try
+    {
+        cgoMetaStream *metaStream;
+
+        while (activeWorkers && ((metaStream = frontEnd->nxtMetaStream()) != NULL))
+        {
+            metaStream->serialize(out);
+            delete metaStream;
+            metaStreams++;
+
+            //  Stop the driver when all the workers have finished.
+            if ((metaStreams & 0x3FF) == 0)
+            {
+                reapWorkers(false);
+
+                activeWorkers = false;
+                for(U32 c = 0; c < workers.size(); c++)
+                    activeWorkers = activeWorkers || (workers[c] > 0);
+            }
+        }
+    }
+    catch (...)
+    {
+        fprintf(stderr, "Sweep : exception in the driver, the MetaStream sequence was truncated.\n");
+    }
+
+    writer.close();
+
+    F64 driverTime = chrono::duration<F64>(chrono::steady_clock::now() - start).count();
+
+    CG_INFO("Sweep : %d MetaStreams (%lld bytes) generated in %.2f seconds.", metaStreams, (long long) queue->writePosition, driverTime);
+
+    //  Wait for the workers and report.
+    reapWorkers(true);
+
+    writeSummary();
+
+    U32 failed = 0;
+    for(U32 c = 0; c < configs.size(); c++)
+        failed += (queue->results[c].status == 0) ? 0 : 1;
+
+    return failed;
+#endif
+}
+
+} // namespace arch
@@ -0,0 +1,155 @@
+/**************************************************************************
+ *
+ *  Multi-configuration sweep runner definition file.
+ *  This file defines the class that simulates the same trace with several
+ *  simulator configurations from a single driver front-end.
+ *
+ *  The trace driver runs once in the parent process.  The MetaStreams it
+ *  produces are serialized into a bounded ring buffer in shared memory that
+ *  is read by one forked worker process per configuration.  Each worker loads
+ *  its own ArchParams, changes to its own statistics directory and runs a
+ *  simulator instance fed from the shared ring.  The simulator modules use
+ *  process wide singletons (signal binder, statistics manager, parameters)
+ *  so the instances are isolated in processes instead of threads.
+ *
+ */
+
+#ifndef __SWEEPRUNNER_H__
+#define __SWEEPRUNNER_H__
+
+#include "GPUType.h"
+#include "modelbase.h"
+#include "archParams.h"
+#include "TraceDriverBase.h"
+
+#include <string>
+#include <vector>
+
+namespace arch
+{
+
+//  Maximum number of configurations simulated in a sweep.
+static const U32 SWEEP_MAX_CONFIGS = 64;
+
+//  Default size of the shared MetaStream ring buffer in MBytes.
+static const U32 SWEEP_DEFAULT_QUEUE_SIZE = 64;
+
+/**
+ *  Simulator configuration for a sweep.
+ */
+struct cgsSweepConfig
+{
+    std::string name;                                               //  Name of the configuration (and of its statistics directory).
+    std::string paramFile;                                          //  archParams.csv file.
+    std::string archName;                                           //  ARCH_VERSION column of the parameter file.
+    std::vector<std::pair<std::string, std::string> > overrides;    //  Parameter values overriding the parameter file.
+};
+
+/**
+ *  Result of the simulation of a sweep configuration.
+ */
+struct cgsSweepResult
+{
+    S32 status;             //  0 finished, > 0 simulator assertion or exception, < 0 worker crashed or not started.
+    U64 gpuCycle;           //  Simulated GPU (main clock domain) cycles.
+    U64 shaderCycle;        //  Simulated shader clock domain cycles.
+    U64 memoryCycle;        //  Simulated memory clock domain cycles.
+    U32 frames;             //  Frame counter at the end of the simulation.
+    U32 batches;            //  Batches simulated.
+    F64 wallTime;           //  Host wall clock time of the simulation in seconds.
+};
+
+struct cgsSweepQueueState;
+
+/**
+ *  Multi-configuration sweep runner.
+ *
+ *  The sweep file has a configuration per line (empty lines and lines starting with '#'
+ *  are ignored):
+ *
+ *      <name> [--param <archParams.csv>] [--arch <ARCH_VERSION>] [<PARAMETER>=<value> ...]
+ *
+ *  The parameter file and architecture version default to the ones used by the simulator
+ *  command line.  The parameters that change the MetaStreams generated by the driver
+ *  (memory sizes, display resolution, texture tiling, MSAA, shader translation, ...) must
+ *  be the same for all the configurations.
+ */
+
+class cgoSweepRunner
+{
+private:
+
+    std::vector<cgsSweepConfig> configs;    //  Configurations to simulate.
+    std::string baseParamFile;              //  Parameter file of the base configuration.
+    std::string baseArchName;               //  Architecture version of the base configuration.
+    std::string outputDir;                  //  Directory where the per configuration directories are created.
+    U64 queueSize;                          //  Size in bytes of the shared MetaStream ring buffer.
+    cgsSweepQueueState *queue;              //  Shared ring buffer state.
+    std::vector<S32> workers;               //  Process identifiers of the workers.
+
+    /**
+     *  Loads the configuration into the ArchParams singleton and returns the
+     *  corresponding cgsArchConfig structure.
+     */
+    void loadConfig(const cgsSweepConfig &config, const cgsArchConfig &baseConf, cgsArchConfig &archConf);
+
+    /**
+     *  Checks that the parameters used by the driver to generate the MetaStreams are the
+     *  same in two configurations.
+     */
+    static bool sameDriverParams(const cgsArchConfig &a, const cgsArchConfig &b);
+
+    /**
+     *  Worker process main function.  Never returns.
+     */
+    void runWorker(U32 id, const cgsArchConfig &baseConf, cgeModelAbstractLevel MAL, TraceTyp traceTyp);
+
+    /**
+     *  Checks for terminated workers and detaches them from the ring buffer.
+     *  @param wait Wait until all the workers have terminated.
+     */
+    void reapWorkers(bool wait);
+
+    /**
+     *  Prints the summary table and writes it into the summary.csv file of the output directory.
+     */
+    void writeSummary();
+
+public:
+
+    /**
+     *  Creates a sweep runner.
+     *
+     *  @param sweepFile Path to the file with the configurations to simulate.
+     *  @param defaultParamFile Parameter file used by the configurations that don't define one.
+     *  @param defaultArch Architecture version used by the configurations that don't define one.
+     *  @param outputDir Directory where the per configuration statistics directories are created.
+     *  @param queueSizeMB Size of the shared MetaStream ring buffer in MBytes.
+     */
+    cgoSweepRunner(const char *sweepFile, const char *defaultParamFile, const char *defaultArch,
+                   const char *outputDir, U32 queueSizeMB);
+
+    ~cgoSweepRunner();
+
+    /**
+     *  Returns the number of configurations in the sweep.
+     */
+    U32 getNumConfigs() const { return U32(configs.size()); }
+
+    /**
+     *  Simulates all the configurations.  The trace driver is run in the calling process and
+     *  its MetaStreams are shared with all the workers.  The ArchParams singleton is left with
+     *  the base configuration.
+     *
+     *  @param frontEnd Trace driver producing the MetaStreams.
+     *  @param baseConf Configuration used to create the trace driver and configure the HAL.
+     *  @param MAL Model abstraction level to simulate.
+     *
+     *  @return The number of configurations that didn't finish correctly.
+     */
+    U32 run(cgoTraceDriverBase *frontEnd, const cgsArchConfig &baseConf, cgeModelAbstractLevel MAL);
+};
+
+} // namespace arch
+
+#endif // __SWEEPRUNNER_H__
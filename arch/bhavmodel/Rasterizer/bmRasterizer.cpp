@@ -3647,6 +3647,76 @@ void bmoRasterizer::interpolate(Fragment *fr, Vec4FP32 *attribute)
     }
 }
 
+//  Interpolates the attributes of the fragments of a stamp.  
+void bmoRasterizer::interpolate(Fragment **fr, Vec4FP32 **attributes, U32 fragments, const bool *interpolated)
+{
+    F64 r;
+    F64 f[3][STAMP_FRAGMENTS];
+    F64 p[3][STAMP_FRAGMENTS];
+    F64 res[STAMP_FRAGMENTS];
+    Vec4FP32 *vAttr[3][STAMP_FRAGMENTS];
+    U32 a;
+    U32 c;
+    U32 i;
+
+    //  Check the number of fragments.  
+    CG_ASSERT_COND(!(fragments > STAMP_FRAGMENTS), "Too many fragments in the stamp.");
+
+    /*  Same interpolation than interpolate(fr, attribute) but the
+        interpolation factors and the vertex attribute arrays are
+        computed once per fragment and each attribute component is
+        interpolated for all the fragments of the stamp.  */
+
+    for(i = 0; i < fragments; i++)
+    {
+        //  Check a fragment is passed.  
+        CG_ASSERT_COND(!(fr[i] == NULL), "NULL Fragment pointer.");
+
+        //  Get the fragment edge/barycentric coordinates.  
+        f[0][i] = fr[i]->getCoordinates()[0];
+        f[1][i] = fr[i]->getCoordinates()[1];
+        f[2][i] = fr[i]->getCoordinates()[2];
+
+        //  Calculate reciproque of the edge/barycentric coordinates sum.  
+        r = 1.0 / (f[0][i] + f[1][i] + f[2][i]);
+
+        //  Calculate fragment coordinate factors for interpolation.  
+        f[0][i] = r * f[0][i];
+        f[1][i] = r * f[1][i];
+        f[2][i] = r * f[2][i];
+
+        //  Get the three vertex attributes.  
+        fr[i]->getTriangle()->getVertexAttributes(vAttr[0][i], vAttr[1][i], vAttr[2][i]);
+    }
+
+    for(a = 0; a < MAX_FRAGMENT_ATTRIBUTES; a++)
+    {
+        if (!interpolated[a])
+            continue;
+
+        //  Check attribute index range.  
+        CG_ASSERT_COND(!(a >= fragmentAttributes), "Fragment attribute index out of range.");
+
+        for(c = 0; c < 4; c++)
+        {
+            //  Get parameter vectors for the attribute component.  
+            for(i = 0; i < fragments; i++)
+            {
+                p[0][i] = vAttr[0][i][a][c];
+                p[1][i] = vAttr[1][i][a][c];
+                p[2][i] = vAttr[2][i][a][c];
+            }
+
+            //  Interpolate the attribute component.  
+            for(i = 0; i < fragments; i++)
+                res[i] = p[0][i] * f[0][i] + p[1][i] * f[1][i] + p[2][i] * f[2][i];
+
+            for(i = 0; i < fragments; i++)
+                attributes[i][a][c] = F32(res[i]);
+        }
+    }
+}
+
 
 //  Return an aproximation of the triangle signed area.  
 F64 bmoRasterizer::triangleArea(U32 triangle)
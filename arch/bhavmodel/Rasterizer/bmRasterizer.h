@@ -1407,6 +1407,25 @@ public:
 
     void interpolate(Fragment *f, Vec4FP32 *attribute);
 
+    /**
+     *
+     *  Interpolates the attributes of the fragments of a stamp using
+     *  barycentric coordinates.  The interpolation factors are computed
+     *  once per fragment and each attribute component is interpolated
+     *  for all the fragments.  The result is the same than calling
+     *  interpolate(f, attribute) for each fragment and attribute.
+     *
+     *  @param f Array with the fragments (STAMP_FRAGMENTS at most).
+     *  @param attributes Array with the attribute arrays where to
+     *  store the interpolated attributes of each fragment.
+     *  @param fragments Number of fragments.
+     *  @param interpolated Flags for the attributes to interpolate
+     *  (MAX_FRAGMENT_ATTRIBUTES entries).
+     *
+     */
+
+    void interpolate(Fragment **f, Vec4FP32 **attributes, U32 fragments, const bool *interpolated);
+
     /**
      *
      *  Copies the fragment attribute from one of the setup
@@ -19,7 +19,16 @@
 #include "bmTextureProcessor.h"
 #include "GPUMath.h"
 #include <stdio.h>
-#
+
+//  Select the SIMD instruction set used by the block decompression and filter functions.
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define TEXTURE_DECODE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define TEXTURE_DECODE_SSE2
+#endif
+
 using namespace arch;
 
 //  Texture Behavior Model constructor.
@@ -2435,6 +2444,23 @@ void bmoTextureProcessor::filterTrilinear(TextureAccess &textAccess, U32 triline
     //  Update number of trilinear samples to filter for the current texture access.  
     textAccess.trilinearToFilter--;
 
+    //  Compute the bilinear samples for all the fragments in the stamp.
+    bool bilinearLevel0[STAMP_FRAGMENTS];
+    bool bilinearLevel1[STAMP_FRAGMENTS];
+    Vec4FP32 filteredLevel0[STAMP_FRAGMENTS];
+    Vec4FP32 filteredLevel1[STAMP_FRAGMENTS];
+
+    for(i = 0; i < stampFragments; i++)
+    {
+        FilterMode filterMode = textAccess.filter[i];
+        bilinearLevel0[i] = (filterMode == GPU_LINEAR) || (filterMode == GPU_LINEAR_MIPMAP_NEAREST) ||
+                            (filterMode == GPU_LINEAR_MIPMAP_LINEAR);
+        bilinearLevel1[i] = (filterMode == GPU_LINEAR_MIPMAP_LINEAR) && textAccess.trilinear[trilinearAccess]->sampleFromTwoMips[i];
+    }
+
+    bilinearFilterStamp(textAccess, trilinearAccess, 0, bilinearLevel0, filteredLevel0);
+    bilinearFilterStamp(textAccess, trilinearAccess, 1, bilinearLevel1, filteredLevel1);
+
     //  Filter each fragment.  
     for(i = 0; i < stampFragments; i++)
     {
@@ -2456,7 +2482,7 @@ void bmoTextureProcessor::filterTrilinear(TextureAccess &textAccess, U32 triline
             case GPU_LINEAR_MIPMAP_NEAREST:
 
                 //  Bilinear filtering.
-                t1 = bilinearFilter(textAccess, trilinearAccess, 0, i);
+                t1 = filteredLevel0[i];
                 textAccess.trilinear[trilinearAccess]->sample[i][0] = t1[0];
                 textAccess.trilinear[trilinearAccess]->sample[i][1] = t1[1];
                 textAccess.trilinear[trilinearAccess]->sample[i][2] = t1[2];
@@ -2504,8 +2530,8 @@ void bmoTextureProcessor::filterTrilinear(TextureAccess &textAccess, U32 triline
                     w = textAccess.lod[i] - static_cast<F32>(GPU_FLOOR(textAccess.lod[i]));
 
                     //  Compute bilinear samples for two mipmaps.
-                    t1 = bilinearFilter(textAccess, trilinearAccess, 0, i);
-                    t2 = bilinearFilter(textAccess, trilinearAccess, 1, i);
+                    t1 = filteredLevel0[i];
+                    t2 = filteredLevel1[i];
 
                     /// Interpolate between two mipmaps.
                     textAccess.trilinear[trilinearAccess]->sample[i][0] = (t1[0] * (1.0f - w) + t2[0] * w);
@@ -2525,7 +2551,7 @@ textAccess.trilinear[trilinearAccess]->sample[i][2], textAccess.trilinear[trilin
                 else
                 {
                     //  Compute bilinear sample for a single mipmap.
-                    t1 = bilinearFilter(textAccess, trilinearAccess, 0, i);
+                    t1 = filteredLevel0[i];
                     textAccess.trilinear[trilinearAccess]->sample[i][0] = t1[0];
                     textAccess.trilinear[trilinearAccess]->sample[i][1] = t1[1];
                     textAccess.trilinear[trilinearAccess]->sample[i][2] = t1[2];
@@ -2661,6 +2687,59 @@ printf("   Result -> {%f, %f, %f, %f}\n", sample[0], sample[1], sample[2], sampl
     return sample;
 }
 
+//  Performs bilinear filtering at a mipmap level for all the fragments in a stamp texture access.
+void bmoTextureProcessor::bilinearFilterStamp(TextureAccess &textAccess, U32 trilinearAccess, U32 level,
+                                              const bool *fragMask, Vec4FP32 *samples)
+{
+    TextureAccess::Trilinear *trilinear = textAccess.trilinear[trilinearAccess];
+
+    //  The SIMD path keeps the operation order of bilinearFilter for each component.  When the compiler
+    //  is allowed to fuse multiply-adds in the scalar code the results could differ so use bilinearFilter.
+#if (defined(TEXTURE_DECODE_SSE2) || defined(TEXTURE_DECODE_AVX2)) && !defined(__FMA__)
+    TextureMode mode = textureMode[textAccess.textUnit];
+
+    if ((mode == GPU_TEXTURE2D) || (mode == GPU_TEXTURECUBEMAP))
+    {
+        for(U32 frag = 0; frag < stampFragments; frag++)
+        {
+            if (!fragMask[frag])
+                continue;
+
+            //  Get filter weights.
+            F32 a = trilinear->a[frag][level];
+            F32 b = trilinear->b[frag][level];
+
+            __m128 wA = _mm_set1_ps(a);
+            __m128 wB = _mm_set1_ps(b);
+            __m128 wNotA = _mm_set1_ps(1.0f - a);
+            __m128 wNotB = _mm_set1_ps(1.0f - b);
+
+            //  All four components of the four texels.
+            __m128 t0 = _mm_loadu_ps(trilinear->texel[frag][level * 4 + 0].getVector());
+            __m128 t1 = _mm_loadu_ps(trilinear->texel[frag][level * 4 + 1].getVector());
+            __m128 t2 = _mm_loadu_ps(trilinear->texel[frag][level * 4 + 2].getVector());
+            __m128 t3 = _mm_loadu_ps(trilinear->texel[frag][level * 4 + 3].getVector());
+
+            //  t0 * (1 - a) * (1 - b) + t1 * a * (1 - b) + t2 * (1 - a) * b + t3 * a * b
+            __m128 sample = _mm_mul_ps(_mm_mul_ps(t0, wNotA), wNotB);
+            sample = _mm_add_ps(sample, _mm_mul_ps(_mm_mul_ps(t1, wA), wNotB));
+            sample = _mm_add_ps(sample, _mm_mul_ps(_mm_mul_ps(t2, wNotA), wB));
+            sample = _mm_add_ps(sample, _mm_mul_ps(_mm_mul_ps(t3, wA), wB));
+
+            _mm_storeu_ps(samples[frag].getVector(), sample);
+        }
+
+        return;
+    }
+#endif
+
+    for(U32 frag = 0; frag < stampFragments; frag++)
+    {
+        if (fragMask[frag])
+            samples[frag] = bilinearFilter(textAccess, trilinearAccess, level, frag);
+    }
+}
+
 /*
     Textures are stored in memory in the following manner:
 
@@ -4466,163 +4545,498 @@ void bmoTextureProcessor::transparentS3TCRGB(U32 code, Vec4FP32 RGB0, Vec4FP32 R
     }
 }
 
-//  Decompresses a number of DXT1 RGB blocks.  
-void bmoTextureProcessor::decompressDXT1RGB(U08 *input, U08 *output, U32 size)
+/*
+    Block decompression.
+
+    The texels of a compressed block only take the values of a small palette (4 colors for
+    the S3TC color codes, 8 values for the S3TC alpha and LATC codes).  The decompression
+    functions compute the palette for each block with the same functions used by the
+    decodeBlock* functions, so the result is bit-exact with the per-texel decoders, and
+    then expand the per-texel codes of the block into the palette values in Morton order.
+
+    The code expansion uses AVX2 (variable shifts and a permute from the palette) or SSE2
+    (compare and select) when available, with a scalar fallback.
+
+*/
+
+//  Tables used to expand the codes of a compressed 4x4 block into Morton order.
+struct BlockCodeTables
 {
-    U32 i;
-    U32 numBlocks;
+    alignas(32) U32 shift2[16];         //  Bit offset of the 2-bit code for the texel stored at each Morton position.
+    alignas(32) U32 shift3[16];         //  Bit offset of the 3-bit code inside its 24-bit half of the code bits.
+    alignas(32) U32 half3[16];          //  0xFFFFFFFF if the 3-bit code is stored in the upper 24-bit half.
+    alignas(32) U32 mask2[16];          //  Mask for the 2-bit code (SSE2 compare and select).
+    alignas(32) U32 match2[4][16];      //  2-bit code values at the code bit offset (SSE2 compare and select).
+    alignas(32) U32 mask3[16];          //  Mask for the 3-bit code (SSE2 compare and select).
+    alignas(32) U32 match3[8][16];      //  3-bit code values at the code bit offset (SSE2 compare and select).
+
+    BlockCodeTables()
+    {
+        for(U32 j = 0; j < 4; j++)
+        {
+            for(U32 i = 0; i < 4; i++)
+            {
+                U32 raster = j * 4 + i;
+                U32 m = GPUMath::morton(2, i, j);
+
+                shift2[m] = raster * 2;
+                shift3[m] = (raster & 0x07) * 3;
+                half3[m] = (raster < 8) ? 0 : 0xFFFFFFFF;
+                mask2[m] = 0x03 << shift2[m];
+                mask3[m] = 0x07 << shift3[m];
 
-    //  Determine the number of blocks in the input.  
-    numBlocks = size >> S3TC_DXT1_BLOCK_SIZE_SHIFT;
+                for(U32 c = 0; c < 4; c++)
+                    match2[c][m] = c << shift2[m];
 
-    //  Decode the DXT1 RGB blocks.  
-    for(i = 0; i < numBlocks; i++)
+                for(U32 c = 0; c < 8; c++)
+                    match3[c][m] = c << shift3[m];
+            }
+        }
+    }
+};
+
+static const BlockCodeTables &blockCodeTables()
+{
+    static const BlockCodeTables tables;
+    return tables;
+}
+
+//  Expands the 16 2-bit codes of a block (raster order) into palette values in Morton order.
+static void expandBlockCodes2(U32 codes, const U32 *palette, U32 *output)
+{
+    const BlockCodeTables &tables = blockCodeTables();
+
+#if defined(TEXTURE_DECODE_AVX2)
+
+    __m256i pal = _mm256_setr_epi32(palette[0], palette[1], palette[2], palette[3],
+                                    palette[0], palette[1], palette[2], palette[3]);
+    __m256i bits = _mm256_set1_epi32(S32(codes));
+    __m256i codeMask = _mm256_set1_epi32(0x03);
+
+    for(U32 h = 0; h < 16; h += 8)
     {
-        //  Decode next block.  
-        decodeBlockDXT1RGB(&input[i << S3TC_DXT1_BLOCK_SIZE_SHIFT],
-            &output[i << (S3TC_DXT1_BLOCK_SIZE_SHIFT + DXT1_SPACE_SHIFT)]);
+        __m256i shift = _mm256_load_si256((const __m256i *) &tables.shift2[h]);
+        __m256i index = _mm256_and_si256(_mm256_srlv_epi32(bits, shift), codeMask);
+        _mm256_storeu_si256((__m256i *) &output[h], _mm256_permutevar8x32_epi32(pal, index));
     }
+
+#elif defined(TEXTURE_DECODE_SSE2)
+
+    __m128i bits = _mm_set1_epi32(S32(codes));
+    __m128i pal[4];
+
+    for(U32 c = 0; c < 4; c++)
+        pal[c] = _mm_set1_epi32(S32(palette[c]));
+
+    for(U32 g = 0; g < 16; g += 4)
+    {
+        __m128i code = _mm_and_si128(bits, _mm_load_si128((const __m128i *) &tables.mask2[g]));
+        __m128i result = _mm_setzero_si128();
+
+        for(U32 c = 0; c < 4; c++)
+        {
+            __m128i select = _mm_cmpeq_epi32(code, _mm_load_si128((const __m128i *) &tables.match2[c][g]));
+            result = _mm_or_si128(result, _mm_and_si128(select, pal[c]));
+        }
+
+        _mm_storeu_si128((__m128i *) &output[g], result);
+    }
+
+#else
+
+    for(U32 m = 0; m < 16; m++)
+        output[m] = palette[(codes >> tables.shift2[m]) & 0x03];
+
+#endif
 }
 
-//  Decompresses a number of DXT1 RGBA blocks.  
-void bmoTextureProcessor::decompressDXT1RGBA(U08 *input, U08 *output, U32 size)
+//  Expands the 16 3-bit codes of a block (raster order, 48 bits) into palette values in Morton order.
+static void expandBlockCodes3(U64 codes, const U32 *palette, U32 *output)
 {
-    U32 i;
-    U32 numBlocks;
+    const BlockCodeTables &tables = blockCodeTables();
 
-    //  Determine the number of blocks in the input.  
-    numBlocks = size >> S3TC_DXT1_BLOCK_SIZE_SHIFT;
+    U32 low = U32(codes & 0x00FFFFFF);
+    U32 high = U32((codes >> 24) & 0x00FFFFFF);
 
-//printf("decompressDXT1RGBA => input data : ");
-//for(i = 0; i < size; i++)
-//printf("%2x ", input[i]);
-//printf("\n");
+#if defined(TEXTURE_DECODE_AVX2)
+
+    __m256i pal = _mm256_loadu_si256((const __m256i *) palette);
+    __m256i lowBits = _mm256_set1_epi32(S32(low));
+    __m256i highBits = _mm256_set1_epi32(S32(high));
+    __m256i codeMask = _mm256_set1_epi32(0x07);
+
+    for(U32 h = 0; h < 16; h += 8)
+    {
+        __m256i half = _mm256_load_si256((const __m256i *) &tables.half3[h]);
+        __m256i bits = _mm256_blendv_epi8(lowBits, highBits, half);
+        __m256i shift = _mm256_load_si256((const __m256i *) &tables.shift3[h]);
+        __m256i index = _mm256_and_si256(_mm256_srlv_epi32(bits, shift), codeMask);
+        _mm256_storeu_si256((__m256i *) &output[h], _mm256_permutevar8x32_epi32(pal, index));
+    }
 
-//printf("decompressDXT1RGBA => numBlocks %d size %d\n", numBlocks, size);
+#elif defined(TEXTURE_DECODE_SSE2)
 
-//printf("TxEm > decompressing data %p size %d blocks %d\n", input, size, numBlocks);
+    __m128i lowBits = _mm_set1_epi32(S32(low));
+    __m128i highBits = _mm_set1_epi32(S32(high));
+    __m128i pal[8];
 
-    //  Decode the DXT1 RGB blocks.  
-    for(i = 0; i < numBlocks; i++)
+    for(U32 c = 0; c < 8; c++)
+        pal[c] = _mm_set1_epi32(S32(palette[c]));
+
+    for(U32 g = 0; g < 16; g += 4)
     {
-        //  Decode next block.  
-        decodeBlockDXT1RGBA(&input[i << S3TC_DXT1_BLOCK_SIZE_SHIFT],
-            &output[i << (S3TC_DXT1_BLOCK_SIZE_SHIFT + DXT1_SPACE_SHIFT)]);
+        __m128i half = _mm_load_si128((const __m128i *) &tables.half3[g]);
+        __m128i bits = _mm_or_si128(_mm_andnot_si128(half, lowBits), _mm_and_si128(half, highBits));
+        __m128i code = _mm_and_si128(bits, _mm_load_si128((const __m128i *) &tables.mask3[g]));
+        __m128i result = _mm_setzero_si128();
+
+        for(U32 c = 0; c < 8; c++)
+        {
+            __m128i select = _mm_cmpeq_epi32(code, _mm_load_si128((const __m128i *) &tables.match3[c][g]));
+            result = _mm_or_si128(result, _mm_and_si128(select, pal[c]));
+        }
+
+        _mm_storeu_si128((__m128i *) &output[g], result);
     }
 
+#else
 
-//printf("decompressDXT1RGBA => output data : ");
-//for(i = 0; i < (size << DXT1_SPACE_SHIFT); i++)
-//printf("%2x ", output[i]);
-//printf("\n");
+    for(U32 m = 0; m < 16; m++)
+    {
+        U32 bits = (tables.half3[m] != 0) ? high : low;
+        output[m] = palette[(bits >> tables.shift3[m]) & 0x07];
+    }
+
+#endif
+}
+
+//  Merges (bitwise or) two expanded blocks.
+static void mergeBlock(U32 *output, const U32 *input)
+{
+#if defined(TEXTURE_DECODE_SSE2) || defined(TEXTURE_DECODE_AVX2)
+    for(U32 g = 0; g < 16; g += 4)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *) &output[g]);
+        __m128i b = _mm_loadu_si128((const __m128i *) &input[g]);
+        _mm_storeu_si128((__m128i *) &output[g], _mm_or_si128(a, b));
+    }
+#else
+    for(U32 m = 0; m < 16; m++)
+        output[m] = output[m] | input[m];
+#endif
+}
+
+//  Reads the 32-bit little endian word at the start of a buffer.
+static inline U32 readBlockWord(const U08 *buffer)
+{
+    return U32(buffer[0]) + (U32(buffer[1]) << 8) + (U32(buffer[2]) << 16) + (U32(buffer[3]) << 24);
+}
 
+//  Reads the 48-bit little endian code bits at the start of a buffer.
+static inline U64 readBlockCodes48(const U08 *buffer)
+{
+    return ((U64) buffer[0]) + (((U64) buffer[1]) << 8) + (((U64) buffer[2]) << 16) +
+        (((U64) buffer[3]) << 24) + (((U64) buffer[4]) << 32) + (((U64) buffer[5]) << 40);
 }
 
-//  Decompresses a number of DXT3 RGBA blocks.  
+//  Computes the color palette of a S3TC compressed block.
+void bmoTextureProcessor::paletteS3TCRGB(U08 *inBuffer, S3TCPaletteMode mode, U32 *palette)
+{
+    U32 color0, color1;
+    Vec4FP32 RGBA0, RGBA1;
+    Vec4FP32 decodedColor;
+
+    //  Convert first reference color of the compressed block to RGBA.
+    color0 = (inBuffer[1] << 8) + inBuffer[0];
+    RGBA0[0] = ((F32) (color0 >> 11)) * (1.0f / 31.0f);
+    RGBA0[1] = ((F32) ((color0 >> 5) & 0x3f)) * (1.0f / 63.0f);
+    RGBA0[2] = ((F32) (color0 & 0x1f)) * (1.0f / 31.0f);
+
+    //  Convert second reference color of the compressed block to RGBA.
+    color1 = (inBuffer[3] << 8) + inBuffer[2];
+    RGBA1[0] = ((F32) (color1 >> 11)) * (1.0f / 31.0f);
+    RGBA1[1] = ((F32) ((color1 >> 5) & 0x3f)) * (1.0f / 63.0f);
+    RGBA1[2] = ((F32) (color1 & 0x1f)) * (1.0f / 31.0f);
+
+    for(U32 code = 0; code < 4; code++)
+    {
+        //  DXT3 and DXT5 always use the non-transparent encoding.
+        if ((mode == S3TC_PALETTE_RGB_NO_ALPHA) || (color0 > color1))
+        {
+            nonTransparentS3TCRGB(code, RGBA0, RGBA1, decodedColor);
+            decodedColor[3] = (mode == S3TC_PALETTE_RGB_NO_ALPHA) ? 0.0f : 1.0f;
+        }
+        else
+        {
+            transparentS3TCRGB(code, RGBA0, RGBA1, decodedColor);
+
+            if (mode == S3TC_PALETTE_RGB)
+                decodedColor[3] = 1.0f;
+            else
+                decodedColor[3] = (code != 0x03) ? 1.0f : 0.0f;
+        }
+
+        palette[code] = format(GPU_RGBA8888, decodedColor);
+    }
+}
+
+//  Computes the palette for the 3-bit S3TC alpha (and LATC) codes.
+void bmoTextureProcessor::paletteS3TCAlpha(F32 alpha0, F32 alpha1, TextureFormat texFormat, bool luminance, U32 *palette)
+{
+    Vec4FP32 decodedColor;
+
+    for(U32 code = 0; code < 8; code++)
+    {
+        F32 value = decodeS3TCAlpha(code, alpha0, alpha1);
+
+        //  The components not encoded by the codes are set to 0 so the palettes
+        //  for different components can be merged.
+        decodedColor[0] = decodedColor[1] = decodedColor[2] = luminance ? value : 0.0f;
+        decodedColor[3] = luminance ? 0.0f : value;
+
+        palette[code] = format(texFormat, decodedColor);
+    }
+}
+
+//  Decompresses a number of DXT1 RGB blocks.
+void bmoTextureProcessor::decompressDXT1RGB(U08 *input, U08 *output, U32 size)
+{
+    U32 numBlocks = size >> S3TC_DXT1_BLOCK_SIZE_SHIFT;
+    U32 palette[4];
+
+    for(U32 b = 0; b < numBlocks; b++)
+    {
+        U08 *inBuffer = &input[b << S3TC_DXT1_BLOCK_SIZE_SHIFT];
+        U32 *outBuffer = (U32 *) &output[b << (S3TC_DXT1_BLOCK_SIZE_SHIFT + DXT1_SPACE_SHIFT)];
+
+        //  Patch to detect use of non initialized memory.
+        if (readBlockWord(inBuffer) == 0xDEADCAFE)
+        {
+            for(U32 t = 0; t < 16; t++)
+                outBuffer[t] = 0xFFFFFFFF;
+            continue;
+        }
+
+        paletteS3TCRGB(inBuffer, S3TC_PALETTE_RGB, palette);
+        expandBlockCodes2(readBlockWord(&inBuffer[4]), palette, outBuffer);
+    }
+}
+
+//  Decompresses a number of DXT1 RGBA blocks.
+void bmoTextureProcessor::decompressDXT1RGBA(U08 *input, U08 *output, U32 size)
+{
+    U32 numBlocks = size >> S3TC_DXT1_BLOCK_SIZE_SHIFT;
+    U32 palette[4];
+
+    for(U32 b = 0; b < numBlocks; b++)
+    {
+        U08 *inBuffer = &input[b << S3TC_DXT1_BLOCK_SIZE_SHIFT];
+        U32 *outBuffer = (U32 *) &output[b << (S3TC_DXT1_BLOCK_SIZE_SHIFT + DXT1_SPACE_SHIFT)];
+
+        //  Patch to detect use of non initialized memory.
+        if (readBlockWord(inBuffer) == 0xDEADCAFE)
+        {
+            for(U32 t = 0; t < 16; t++)
+                outBuffer[t] = 0xFFFFFFFF;
+            continue;
+        }
+
+        paletteS3TCRGB(inBuffer, S3TC_PALETTE_RGBA, palette);
+        expandBlockCodes2(readBlockWord(&inBuffer[4]), palette, outBuffer);
+    }
+}
+
+//  Decompresses a number of DXT3 RGBA blocks.
 void bmoTextureProcessor::decompressDXT3RGBA(U08 *input, U08 *output, U32 size)
 {
-    U32 i;
-    U32 numBlocks;
+    //  DXT3 alpha is stored as 4-bit literals.  Alpha component of the decoded color for each literal.
+    static const struct AlphaTable
+    {
+        U32 alpha[16];
 
-    //  Determine the number of blocks in the input.  
-    numBlocks = size >> S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT;
+        AlphaTable()
+        {
+            Vec4FP32 decodedColor;
 
-    //  Decode the DXT1 RGB blocks.  
-    for(i = 0; i < numBlocks; i++)
+            for(U32 a = 0; a < 16; a++)
+            {
+                decodedColor[3] = F32(a) * (1.0f / 15.0f);
+                alpha[a] = format(GPU_RGBA8888, decodedColor);
+            }
+        }
+    } alphaTable;
+
+    U32 numBlocks = size >> S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT;
+    U32 palette[4];
+    U32 alpha[16];
+
+    for(U32 b = 0; b < numBlocks; b++)
     {
-        //  Decode next block.  
-        decodeBlockDXT3RGBA(&input[i << S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT],
-            &output[i << (S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT + DXT3_DXT5_SPACE_SHIFT)]);
+        U08 *inBuffer = &input[b << S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT];
+        U32 *outBuffer = (U32 *) &output[b << (S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT + DXT3_DXT5_SPACE_SHIFT)];
+
+        //  Patch to detect use of non initialized memory.
+        if (readBlockWord(inBuffer) == 0xDEADCAFE)
+        {
+            for(U32 t = 0; t < 16; t++)
+                outBuffer[t] = 0xFFFFFFFF;
+            continue;
+        }
+
+        paletteS3TCRGB(&inBuffer[8], S3TC_PALETTE_RGB_NO_ALPHA, palette);
+        expandBlockCodes2(readBlockWord(&inBuffer[12]), palette, outBuffer);
+
+        //  Expand the alpha literals into Morton order.
+        for(U32 j = 0; j < 4; j++)
+        {
+            for(U32 i = 0; i < 4; i++)
+            {
+                U32 texel = j * 4 + i;
+                U32 literal = (inBuffer[texel >> 1] >> ((texel & 0x01) * 4)) & 0x0F;
+                alpha[GPUMath::morton(2, i, j)] = alphaTable.alpha[literal];
+            }
+        }
+
+        mergeBlock(outBuffer, alpha);
     }
 }
 
-//  Decompresses a number of DXT5 RGBA blocks.  
+//  Decompresses a number of DXT5 RGBA blocks.
 void bmoTextureProcessor::decompressDXT5RGBA(U08 *input, U08 *output, U32 size)
 {
-    U32 i;
-    U32 numBlocks;
-
-    //  Determine the number of blocks in the input.  
-    numBlocks = size >> S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT;
+    U32 numBlocks = size >> S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT;
+    U32 palette[4];
+    U32 alphaPalette[8];
+    U32 alpha[16];
 
-    //  Decode the DXT1 RGB blocks.  
-    for(i = 0; i < numBlocks; i++)
+    for(U32 b = 0; b < numBlocks; b++)
     {
-        //  Decode next block.  
-        decodeBlockDXT5RGBA(&input[i << S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT],
-            &output[i << (S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT + DXT3_DXT5_SPACE_SHIFT)]);
+        U08 *inBuffer = &input[b << S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT];
+        U32 *outBuffer = (U32 *) &output[b << (S3TC_DXT3_DXT5_BLOCK_SIZE_SHIFT + DXT3_DXT5_SPACE_SHIFT)];
+
+        //  Patch to detect use of non initialized memory.
+        if (readBlockWord(inBuffer) == 0xDEADCAFE)
+        {
+            for(U32 t = 0; t < 16; t++)
+                outBuffer[t] = 0xFFFFFFFF;
+            continue;
+        }
+
+        paletteS3TCRGB(&inBuffer[8], S3TC_PALETTE_RGB_NO_ALPHA, palette);
+        expandBlockCodes2(readBlockWord(&inBuffer[12]), palette, outBuffer);
+
+        paletteS3TCAlpha(F32(inBuffer[0]) * (1.0f / 255.0f), F32(inBuffer[1]) * (1.0f / 255.0f),
+                         GPU_RGBA8888, false, alphaPalette);
+        expandBlockCodes3(readBlockCodes48(&inBuffer[2]), alphaPalette, alpha);
+
+        mergeBlock(outBuffer, alpha);
     }
 }
 
 //  Decompresses a number of LATC1 blocks.
 void bmoTextureProcessor::decompressLATC1(U08 *input, U08 *output, U32 size)
 {
-    U32 i;
-    U32 numBlocks;
-
-    //  Determine the number of blocks in the input.
-    numBlocks = size >> LATC1_BLOCK_SIZE_SHIFT;
+    U32 numBlocks = size >> LATC1_BLOCK_SIZE_SHIFT;
+    U32 palette[8];
+    U32 texels[16];
 
-    //  Decode the LATC1 blocks.
-    for(i = 0; i < numBlocks; i++)
+    for(U32 b = 0; b < numBlocks; b++)
     {
-        //  Decode next block.
-        decodeBlockLATC1(&input[i << LATC1_BLOCK_SIZE_SHIFT], &output[i << (LATC1_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)]);
+        U08 *inBuffer = &input[b << LATC1_BLOCK_SIZE_SHIFT];
+        U08 *outBuffer = &output[b << (LATC1_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)];
+
+        paletteS3TCAlpha(F32(inBuffer[0]) * (1.0f / 255.0f), F32(inBuffer[1]) * (1.0f / 255.0f),
+                         GPU_LUMINANCE8, true, palette);
+        expandBlockCodes3(readBlockCodes48(&inBuffer[2]), palette, texels);
+
+        //  Store in 8-bit LUMINANCE format.
+        for(U32 t = 0; t < 16; t++)
+            outBuffer[t] = U08(texels[t] & 0x00FF);
     }
 }
 
 //  Decompresses a number of LATC1_SIGNED blocks.
 void bmoTextureProcessor::decompressLATC1Signed(U08 *input, U08 *output, U32 size)
 {
-    U32 i;
-    U32 numBlocks;
-
-    //  Determine the number of blocks in the input.
-    numBlocks = size >> LATC1_BLOCK_SIZE_SHIFT;
+    U32 numBlocks = size >> LATC1_BLOCK_SIZE_SHIFT;
+    U32 palette[8];
+    U32 texels[16];
 
-    //  Decode the LATC1_SIGNED blocks.
-    for(i = 0; i < numBlocks; i++)
+    for(U32 b = 0; b < numBlocks; b++)
     {
-        //  Decode next block.
-        decodeBlockLATC1Signed(&input[i << LATC1_BLOCK_SIZE_SHIFT], &output[i << (LATC1_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)]);
+        U08 *inBuffer = &input[b << LATC1_BLOCK_SIZE_SHIFT];
+        U08 *outBuffer = &output[b << (LATC1_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)];
+
+        paletteS3TCAlpha(F32(S08(inBuffer[0])) * (1.0f / 127.0f), F32(S08(inBuffer[1])) * (1.0f / 127.0f),
+                         GPU_LUMINANCE8_SIGNED, true, palette);
+        expandBlockCodes3(readBlockCodes48(&inBuffer[2]), palette, texels);
+
+        //  Store in 8-bit LUMINANCE SIGNED format.
+        for(U32 t = 0; t < 16; t++)
+            outBuffer[t] = U08(texels[t] & 0x00FF);
     }
 }
 
 //  Decompresses a number of LATC2 blocks.
 void bmoTextureProcessor::decompressLATC2(U08 *input, U08 *output, U32 size)
 {
-    U32 i;
-    U32 numBlocks;
+    U32 numBlocks = size >> LATC2_BLOCK_SIZE_SHIFT;
+    U32 palette[8];
+    U32 texels[16];
+    U32 alpha[16];
 
-    //  Determine the number of blocks in the input.
-    numBlocks = size >> LATC2_BLOCK_SIZE_SHIFT;
-
-    //  Decode the LATC2 blocks.
-    for(i = 0; i < numBlocks; i++)
+    for(U32 b = 0; b < numBlocks; b++)
     {
-        //  Decode next block.
-        decodeBlockLATC2(&input[i << LATC2_BLOCK_SIZE_SHIFT], &output[i << (LATC2_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)]);
+        U08 *inBuffer = &input[b << LATC2_BLOCK_SIZE_SHIFT];
+        U16 *outBuffer = (U16 *) &output[b << (LATC2_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)];
+
+        paletteS3TCAlpha(F32(inBuffer[0]) * (1.0f / 255.0f), F32(inBuffer[1]) * (1.0f / 255.0f),
+                         GPU_LUMINANCE8_ALPHA8, true, palette);
+        expandBlockCodes3(readBlockCodes48(&inBuffer[2]), palette, texels);
+
+        paletteS3TCAlpha(F32(inBuffer[8]) * (1.0f / 255.0f), F32(inBuffer[9]) * (1.0f / 255.0f),
+                         GPU_LUMINANCE8_ALPHA8, false, palette);
+        expandBlockCodes3(readBlockCodes48(&inBuffer[10]), palette, alpha);
+
+        mergeBlock(texels, alpha);
+
+        //  Store in 16-bit LUMINANCE_ALPHA format.
+        for(U32 t = 0; t < 16; t++)
+            outBuffer[t] = U16(texels[t] & 0x0000FFFF);
     }
 }
 
 //  Decompresses a number of LATC2_SIGNED blocks.
 void bmoTextureProcessor::decompressLATC2Signed(U08 *input, U08 *output, U32 size)
 {
-    U32 i;
-    U32 numBlocks;
+    U32 numBlocks = size >> LATC2_BLOCK_SIZE_SHIFT;
+    U32 palette[8];
+    U32 texels[16];
+    U32 alpha[16];
 
-    //  Determine the number of blocks in the input.
-    numBlocks = size >> LATC2_BLOCK_SIZE_SHIFT;
-
-    //  Decode the LATC2_SIGNED blocks.
-    for(i = 0; i < numBlocks; i++)
+    for(U32 b = 0; b < numBlocks; b++)
     {
-        //  Decode next block.
-        decodeBlockLATC2Signed(&input[i << LATC2_BLOCK_SIZE_SHIFT], &output[i << (LATC2_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)]);
+        U08 *inBuffer = &input[b << LATC2_BLOCK_SIZE_SHIFT];
+        U16 *outBuffer = (U16 *) &output[b << (LATC2_BLOCK_SIZE_SHIFT + LATC1_LATC2_SPACE_SHIFT)];
+
+        //  NOTE: Same reference value conversion as decodeBlockLATC2Signed.
+        paletteS3TCAlpha(F32(S32(inBuffer[0])) * (1.0f / 127.0f), F32(S32(inBuffer[1])) * (1.0f / 127.0f),
+                         GPU_LUMINANCE8_ALPHA8_SIGNED, true, palette);
+        expandBlockCodes3(readBlockCodes48(&inBuffer[2]), palette, texels);
+
+        paletteS3TCAlpha(F32(S32(inBuffer[8])) * (1.0f / 127.0f), F32(S32(inBuffer[9])) * (1.0f / 127.0f),
+                         GPU_LUMINANCE8_ALPHA8_SIGNED, false, palette);
+        expandBlockCodes3(readBlockCodes48(&inBuffer[10]), palette, alpha);
+
+        //  The luminance palette only sets the lower byte, the alpha palette the upper bytes.
+        mergeBlock(texels, alpha);
+
+        //  Store in 16-bit LUMINANCE_ALPHA_SIGNED format.
+        for(U32 t = 0; t < 16; t++)
+            outBuffer[t] = U16(texels[t] & 0x0000FFFF);
     }
 }
 
-
 //  Reset the Texture Behavior Model internal state.  
 void bmoTextureProcessor::reset()
 {
@@ -811,6 +811,21 @@ private:
 
     Vec4FP32 bilinearFilter(TextureAccess &textAccess, U32 trilinearAccess, U32 level, U32 frag);
 
+    /**
+     *
+     *  Performs bilinear filtering at a mipmap level for all the fragments in a stamp texture access.
+     *  The results are bit-exact with bilinearFilter.
+     *
+     *  @param textAccess The stamp texture access for which the bilinear samples must be calculated.
+     *  @param trilinearAccess The trilinear access for which the bilinear samples must be calculated.
+     *  @param level Which mipmap level (for trilinear) is being sampled.
+     *  @param fragMask Fragments in the stamp for which a bilinear sample must be calculated.
+     *  @param samples Pointer to an array where to store the filtered value for each fragment.
+     *
+     */
+
+    void bilinearFilterStamp(TextureAccess &textAccess, U32 trilinearAccess, U32 level, const bool *fragMask, Vec4FP32 *samples);
+
     /**
      *
      *  Adjust a texel address to the size and type of the texture format.
@@ -1002,6 +1017,48 @@ private:
 
     static void transparentS3TCRGB(U32 code, Vec4FP32 RGBA0, Vec4FP32 RGBA1, Vec4FP32 &output);
 
+    /**
+     *
+     *  Defines how the color palette of a S3TC block is computed.
+     *
+     */
+
+    enum S3TCPaletteMode
+    {
+        S3TC_PALETTE_RGB,           //  DXT1 RGB.  Alpha is always 1.
+        S3TC_PALETTE_RGBA,          //  DXT1 RGBA.  Alpha is 0 for the transparent color.
+        S3TC_PALETTE_RGB_NO_ALPHA   //  DXT3 and DXT5.  Non-transparent encoding, alpha is decoded separately and set to 0.
+    };
+
+    /**
+     *
+     *  Computes the four colors encoded by the 2-bit color codes of a S3TC block.
+     *  The palette colors are bit-exact with the colors generated by the decodeBlock functions.
+     *
+     *  @param inBuffer Pointer to the color part of the S3TC block (reference colors).
+     *  @param mode Palette mode for the S3TC format.
+     *  @param palette Pointer to an array where to store the 4 palette colors in GPU_RGBA8888 format.
+     *
+     */
+
+    static void paletteS3TCRGB(U08 *inBuffer, S3TCPaletteMode mode, U32 *palette);
+
+    /**
+     *
+     *  Computes the eight values encoded by the 3-bit S3TC alpha (or LATC) codes.
+     *  The components not encoded by the code are set to 0 so palettes for the luminance and
+     *  alpha components can be merged.
+     *
+     *  @param alpha0 First reference value.
+     *  @param alpha1 Second reference value.
+     *  @param texFormat Format of the decompressed texels.
+     *  @param luminance If the codes encode the luminance (RGB) or the alpha component.
+     *  @param palette Pointer to an array where to store the 8 palette values in the decompressed format.
+     *
+     */
+
+    static void paletteS3TCAlpha(F32 alpha0, F32 alpha1, TextureFormat texFormat, bool luminance, U32 *palette);
+
 
 public:
 
@@ -20,6 +20,8 @@ BhavModel::BhavModel(cgsArchConfig ArchConf, cgoTraceDriverBase *TraceDriver) :
     GpuBMdl(ArchConf, TraceDriver),
     ArchConf(ArchConf), 
     TraceDriver(TraceDriver),
+    gpuMemSnapshot("bm.gpumem", U64(ArchConf.mem.memSize) * 1024 * 1024, 0xDEADCAFE),
+    sysMemSnapshot("bm.sysmem", U64(ArchConf.mem.mappedMemSize) * 1024 * 1024, 0xDEADCAFE),
     AbortSim(false)
 {
     // Note: ArchParams singleton is already initialized in computrender.cpp main().
@@ -52,6 +54,8 @@ void BhavModel::simulationLoop(cgeModelAbstractLevel MAL)
         }
     }
     CG_INFO_COND(AbortSim, "Simulation aborted");
+    GpuBMdl.GetGpuMem().printFootprint("GPU memory");
+    GpuBMdl.GetSysMem().printFootprint("System memory");
     TRACING_EXIT_REGION()
 }
 
@@ -73,23 +77,11 @@ void BhavModel::saveSnapshot()
     //out.write((char *) &state, sizeof(state));
     out.write((char *) GpuBMdl.GetGpuState(), GpuBMdl.GetGpuStateSize());
     out.close();
-    
-    out.open("bm.gpumem.snapshot", ios::binary);
-    
-    if (!out.is_open())
-        CG_ASSERT("Error creating gpu memory snapshot file.");
-    
-    out.write((char *) GpuBMdl.GetGpuMemBaseAddr(), ArchParams::get<uint32_t>("MEMORYCONTROLLER_MEMORY_SIZE") * 1024 * 1024);
-    out.close();
-    
-    out.open("bm.sysmem.snapshot", ios::binary);
-   
-    if (!out.is_open())
-        CG_ASSERT("Error creating system memory snapshot file.");
-        
-    out.write((char *) GpuBMdl.GetSysMemBaseAddr(), ArchParams::get<uint32_t>("MEMORYCONTROLLER_MAPPED_MEMORY_SIZE") * 1024 * 1024);
-    
-    out.close();
+
+    //  Only the memory pages written since the previous snapshot are stored.  The
+    //  pages are compressed and written in the background.
+    gpuMemSnapshot.save(GpuBMdl.GetGpuMem());
+    sysMemSnapshot.save(GpuBMdl.GetSysMem());
 }
 
 //  Load an behaviorModel state snapshot.
@@ -106,22 +98,35 @@ void BhavModel::loadSnapshot()
     input.read((char *) GpuBMdl.GetGpuState(), GpuBMdl.GetGpuStateSize());
     input.close();
     
-    input.open("bm.gpumem.snapshot", ios::binary);
+    //  Restore the paged snapshot chain.  Fall back to the full memory images of older snapshots.
+    //  Pages equal to the restored content are not written so they are not allocated.
+    cgoMappedMemory &gpuMem = GpuBMdl.GetGpuMem();
+    cgoMappedMemory &sysMem = GpuBMdl.GetSysMem();
+
+    if (!gpuMemSnapshot.load(gpuMem))
+    {
+        input.open("bm.gpumem.snapshot", ios::binary);
     
-    if (!input.is_open())
-        CG_ASSERT("Error opening gpu memory snapshot file.");
+        if (!input.is_open())
+            CG_ASSERT("Error opening gpu memory snapshot file.");
     
-    input.read((char *) GpuBMdl.GetGpuMemBaseAddr(), ArchParams::get<uint32_t>("MEMORYCONTROLLER_MEMORY_SIZE") * 1024 * 1024);
-    input.close();
+        gpuMem.setDirty();      //  Remove the write protection, the kernel writes the image.
+        input.read((char *) GpuBMdl.GetGpuMemBaseAddr(), ArchParams::get<uint32_t>("MEMORYCONTROLLER_MEMORY_SIZE") * 1024 * 1024);
+        input.close();
+    }
     
-    input.open("bm.sysmem.snapshot", ios::binary);
+    if (!sysMemSnapshot.load(sysMem))
+    {
+        input.open("bm.sysmem.snapshot", ios::binary);
    
-    if (!input.is_open())
-        CG_ASSERT("Error opening system memory snapshot file.");
+        if (!input.is_open())
+            CG_ASSERT("Error opening system memory snapshot file.");
         
-    input.read((char *) GpuBMdl.GetSysMemBaseAddr(), ArchParams::get<uint32_t>("MEMORYCONTROLLER_MAPPED_MEMORY_SIZE") * 1024 * 1024);
+        sysMem.setDirty();
+        input.read((char *) GpuBMdl.GetSysMemBaseAddr(), ArchParams::get<uint32_t>("MEMORYCONTROLLER_MAPPED_MEMORY_SIZE") * 1024 * 1024);
     
-    input.close();
+        input.close();
+    }
 }
 
 //  Set skip draw call mode.
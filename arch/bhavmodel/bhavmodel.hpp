@@ -17,6 +17,7 @@
 //  Behavior Model classes.
 #include "bmGpuTop.h"
 #include "modelbase.h"
+#include "PagedSnapshot.h"
 
 #include <vector>
 #include <map>
@@ -31,6 +32,8 @@ class BhavModel : public ModelBase
 private:
     cgsArchConfig ArchConf;             //  Stores the behaviorModel configuration parameters.  
     cgoTraceDriverBase *TraceDriver;   //  Pointer to the objects used to obtain MetaStreams that drive the emulation.  
+    cgoPagedSnapshot gpuMemSnapshot;   //  Tracks the GPU memory pages changed since the previous snapshot.  
+    cgoPagedSnapshot sysMemSnapshot;   //  Tracks the system memory pages changed since the previous snapshot.  
     
 public:
     bool traceEnd;        //  Flag that stores if the trace to be emulated has been completely processed.  
@@ -88,19 +88,12 @@ bmoGpuTop::bmoGpuTop(cgsArchConfig ArchConf, cgoTraceDriverBase *TraceDriver) :
         );
     CG_ASSERT_COND( (bmFragOp != NULL), "Error creating fragment operations behaviorModel object.");
 
-    //  Allocate memory.
-    gpuMemory = new U08[ArchConf.mem.memSize * 1024 * 1024];
-    sysMemory = new U08[ArchConf.mem.mappedMemSize * 1024 * 1024];
-    //  Check allocation.
-    CG_ASSERT_COND((gpuMemory != NULL), "Error allocating gpu memory.");
-    CG_ASSERT_COND((sysMemory != NULL), "Error allocating system memory.");
-
-    //  Reset content of the gpu memory.
-    for(U32 dw = 0; dw < ((ArchConf.mem.memSize * 1024 * 1024) >> 2); dw++)
-        ((U32 *) gpuMemory)[dw] = 0xDEADCAFE;
-    //  Reset content of the system mapped memory.
-    for(U32 dw = 0; dw < ((ArchConf.mem.mappedMemSize * 1024 * 1024) >> 2); dw++)
-        ((U32 *) sysMemory)[dw] = 0xDEADCAFE;
+    //  Create the gpu and system mapped memories.  The content is initialized to 0xDEADCAFE and
+    //  the physical pages are allocated on the first write.
+    gpuMemoryImage = new cgoMappedMemory(U64(ArchConf.mem.memSize) * 1024 * 1024, 0xDEADCAFE);
+    sysMemoryImage = new cgoMappedMemory(U64(ArchConf.mem.mappedMemSize) * 1024 * 1024, 0xDEADCAFE);
+    gpuMemory = gpuMemoryImage->getData();
+    sysMemory = sysMemoryImage->getData();
     //  Set frame counter as start frame.
     frameCounter = ArchConf.sim.startFrame;
     //  Reset the counter of draw calls processed.
@@ -196,12 +189,23 @@ bmoGpuTop::CompressedTextureCache::CompressedTextureCache(bmoGpuTop &bm, U32 blo
     //  Clear compressed texture cache data.
     cachedBlocks = 0;
     blockCache.clear();
+    lastBlock = NULL;
+    lastBlockAddress = 0;
 }
 
 void bmoGpuTop::CompressedTextureCache::readData(U64 address, U08 *data, U32 size)
 {
-    //  Search block in the block cache.
     U64 blockAddress = address & ~(decompressedBlockMask);
+
+    //  Consecutive reads (texels for the same fragment and for the fragments in a stamp) usually
+    //  access the same block so check the last accessed block before searching the block cache.
+    if ((lastBlock != NULL) && (lastBlockAddress == blockAddress))
+    {
+        memcpy(data, &lastBlock[address & decompressedBlockMask], size);
+        return;
+    }
+
+    //  Search block in the block cache.
     map<U64, U08 *>::iterator it;
     it = blockCache.find(blockAddress);
 
@@ -209,8 +213,10 @@ void bmoGpuTop::CompressedTextureCache::readData(U64 address, U08 *data, U32 siz
     if (it != blockCache.end())
     {
         //  Copy decompressed data.
-        for(U32 b = 0; b < size; b++)
-            data[b] = (it->second)[(address & decompressedBlockMask) + b];
+        memcpy(data, &(it->second)[address & decompressedBlockMask], size);
+
+        lastBlockAddress = blockAddress;
+        lastBlock = it->second;
     }
     else
     {
@@ -233,11 +239,14 @@ void bmoGpuTop::CompressedTextureCache::readData(U64 address, U08 *data, U32 siz
             decompressedBlockSize >> compressionRatioShift);
 
         //  Copy decompressed data.
-        for(U32 b = 0; b < size; b++)
-            data[b] = decompressedData[cachedBlocks * decompressedBlockSize + (address & decompressedBlockMask) + b];
+        memcpy(data, &decompressedData[cachedBlocks * decompressedBlockSize + (address & decompressedBlockMask)], size);
 
         //  Add to the block cache.
         blockCache.insert(make_pair(blockAddress, &decompressedData[cachedBlocks * decompressedBlockSize]));
+
+        lastBlockAddress = blockAddress;
+        lastBlock = &decompressedData[cachedBlocks * decompressedBlockSize];
+
         cachedBlocks++;
     }
 }
@@ -247,6 +256,7 @@ void bmoGpuTop::CompressedTextureCache::clear()
     //  Clear the cache.
     cachedBlocks = 0;
     blockCache.clear();
+    lastBlock = NULL;
 }
 //  Emulates the Command Processor.
 void bmoGpuTop::emulateCommandProcessor(cgoMetaStream *CurMetaStream)
@@ -1338,6 +1348,17 @@ void bmoGpuTop::processRegisterWrite(GPURegister gpuReg, U32 gpuSubReg, GPURegDa
 
             break;
 
+        case GPU_STREAM_BASE_VERTEX:
+
+            GPU_DEBUG(
+                CG_INFO("Write GPU_STREAM_BASE_VERTEX = %d.", gpuData.intVal);
+            )
+
+            //  Set GPU stream base vertex register.
+            state.streamBaseVertex = gpuData.intVal;
+
+            break;
+
         case GPU_INDEX_MODE:
 
             GPU_DEBUG(
@@ -5287,6 +5308,7 @@ void bmoGpuTop::resetState()
     state.streamStart = 0;
     state.streamCount = 0;
     state.streamInstances = 1;
+    state.streamBaseVertex = 0;
     state.indexedMode = true;
     state.indexStream = 0;
     state.attributeLoadBypass = false;
@@ -5600,6 +5622,9 @@ vector<U32> shadedIndices;*/
                         break;
                 }
             ) // GPU_DEBUG(
+
+            //  Add the base vertex to the index read from the index buffer.
+            currentIndex = currentIndex + U32(state.streamBaseVertex);
         }
         else
         {
@@ -6972,8 +6997,7 @@ void bmoGpuTop::readTextureData(U64 texelAddress, U32 size, U08 *data)
     if (texelAddress == BLACK_TEXEL_ADDRESS)
     {
         //  Return zeros.
-        for(U32 b = 0; b < size; b++)
-            data[b] = 0;
+        memset(data, 0, size);
 
         return;
     }
@@ -6990,8 +7014,7 @@ void bmoGpuTop::readTextureData(U64 texelAddress, U32 size, U08 *data)
                 U08 *memory = selectMemorySpace(U32(texelAddress & 0xffffffff));
                 U32 address = U32(texelAddress & 0xfffffffc) & SPACE_ADDRESS_MASK;
 
-                for(U32 b = 0; b < size; b++)
-                    data[b] = memory[address + b];
+                memcpy(data, &memory[address], size);
             }
 
             break;
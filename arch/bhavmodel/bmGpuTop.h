@@ -27,6 +27,7 @@
 #include "bmFragmentOperator.h"
 #include "PixelMapper.h"
 #include "ValidationInfo.h"
+#include "SparseMemory.h"
 
 //#include "ModelBase.h"
 
@@ -138,6 +139,8 @@ private:
         U08 *decompressedData;            //  Pointer to data array storing decompressed data.  
         map<U64, U08 *> blockCache;    //  Maps addresses to data blocks in the decompressed data array.  
         U32 cachedBlocks;                //  Stores the number of texture data blocks currently cached.  
+        U64 lastBlockAddress;            //  Address of the last accessed decompressed block.  
+        U08 *lastBlock;                  //  Pointer to the data of the last accessed decompressed block (NULL if none).  
 
     public:
 
@@ -190,6 +193,8 @@ private:
     bmoFragmentOperator *bmFragOp;    //  Pointer to the fragment operation (z, stencil, color, blend) behaviorModel object.  
 
     //  Memory arrays.
+    cgoMappedMemory *gpuMemoryImage;    //  Emulated GPU memory.  
+    cgoMappedMemory *sysMemoryImage;    //  Emulated system memory.  
     U08 *gpuMemory;               //  Pointer to the array storing the emulated GPU memory.  
     U08 *sysMemory;               //  Pointer to the array storing the emulated system memory.  
 
@@ -252,6 +257,8 @@ private:
 public:
     U08* GetSysMemBaseAddr() { return sysMemory; };
     U08* GetGpuMemBaseAddr() { return gpuMemory; };
+    cgoMappedMemory& GetSysMem() { return *sysMemoryImage; }
+    cgoMappedMemory& GetGpuMem() { return *gpuMemoryImage; }
     cgsGpuRegister* GetGpuState() { return &state; }
     U32  GetGpuStateSize() { return sizeof(state); }
     /**
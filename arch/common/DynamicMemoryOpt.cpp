@@ -15,6 +15,7 @@
 #include <sstream>
 #include <list>
 #include <typeinfo>
+#include <thread>
 
 using namespace std;
 using namespace arch;
@@ -34,6 +35,132 @@ DynamicMemoryOpt::Bucket DynamicMemoryOpt::bucket[NUM_BUCKETS]; //  Allocate the
 bool DynamicMemoryOpt::wasCalled = false;             // one initialize call allowed only
 U32 DynamicMemoryOpt::freqSize[24];
 U64 DynamicMemoryOpt::timeStamp = 0;
+std::atomic<U32> DynamicMemoryOpt::concurrentUsers(0);
+std::atomic_flag DynamicMemoryOpt::allocationLock = ATOMIC_FLAG_INIT;
+
+/**
+ *  Takes the allocation lock for the scope when objects are created or destroyed from more
+ *  than one thread.  Without concurrent users the lock is not taken.
+ */
+class DynamicMemoryOpt::AllocationGuard
+{
+private:
+
+    bool locked;
+
+public:
+
+    AllocationGuard() : locked(concurrentUsers.load(std::memory_order_relaxed) != 0)
+    {
+        if (locked)
+        {
+            while (allocationLock.test_and_set(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
+    }
+
+    ~AllocationGuard()
+    {
+        if (locked)
+            allocationLock.clear(std::memory_order_release);
+    }
+};
+
+/**
+ *  Free chunks owned by a thread while there are concurrent users.  The chunks are taken from
+ *  and returned to the shared free lists of the buckets in batches with the allocation lock
+ *  taken.  The cache is returned to the free lists when the thread finishes.
+ */
+class DynamicMemoryOpt::ChunkCache
+{
+private:
+
+    static const U32 CAPACITY = 64;     //  Maximum number of free chunks cached per bucket.
+    static const U32 BATCH = 32;        //  Number of chunks moved from or to a shared free list.
+
+    U32 chunks[NUM_BUCKETS][CAPACITY];  //  Indices of the free chunks cached for each bucket.
+    U32 count[NUM_BUCKETS];             //  Number of free chunks cached for each bucket.
+
+public:
+
+    ChunkCache()
+    {
+        for(U32 b = 0; b < NUM_BUCKETS; b++)
+            count[b] = 0;
+    }
+
+    ~ChunkCache()
+    {
+        flush();
+    }
+
+    //  Takes a free chunk from the cache, refills the cache from the free list when empty.
+    U32 take(U32 b)
+    {
+        if (count[b] == 0)
+        {
+            AllocationGuard guard;
+
+            Bucket &bu = bucket[b];
+            U32 available = bu.MaxObjects() - bu.nextFree;
+            U32 n = (available < BATCH) ? available : BATCH;
+
+            if (n == 0)
+            {
+                cout << "Bucket = " << b << " nextFree = " << bu.nextFree << " MaxObjects() = " << bu.MaxObjects() << "\n";
+                CG_ASSERT("Error allocating object.");
+            }
+
+            for(U32 i = 0; i < n; i++)
+                chunks[b][count[b]++] = bu.map[bu.nextFree++];
+        }
+
+        return chunks[b][--count[b]];
+    }
+
+    //  Adds a free chunk to the cache, returns a batch to the free list when full.
+    void give(U32 b, U32 idx)
+    {
+        if (count[b] == CAPACITY)
+        {
+            AllocationGuard guard;
+
+            Bucket &bu = bucket[b];
+
+            for(U32 i = 0; i < BATCH; i++)
+                bu.map[--bu.nextFree] = chunks[b][--count[b]];
+        }
+
+        chunks[b][count[b]++] = idx;
+    }
+
+    //  Returns all the cached chunks to the free lists.
+    void flush()
+    {
+        AllocationGuard guard;
+
+        for(U32 b = 0; b < NUM_BUCKETS; b++)
+        {
+            while (count[b] != 0)
+                bucket[b].map[--bucket[b].nextFree] = chunks[b][--count[b]];
+        }
+    }
+};
+
+thread_local DynamicMemoryOpt::ChunkCache DynamicMemoryOpt::chunkCache;
+
+void DynamicMemoryOpt::beginConcurrentAccess()
+{
+    concurrentUsers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DynamicMemoryOpt::endConcurrentAccess()
+{
+    //  The other threads returned their chunks when they finished.
+    chunkCache.flush();
+
+    concurrentUsers.fetch_sub(1, std::memory_order_relaxed);
+}
 
 using namespace std;
 using namespace arch;
@@ -104,16 +231,19 @@ void DynamicMemoryOpt::initialize( U32 maxObjectSize1, U32 capacity1,
 
 void* DynamicMemoryOpt::operator new( size_t objectSize ) throw()
 {
-
 #ifdef FAST_NEW_DELETE
 
     U32 b;
+    U32 idx;
     U32 *p;
 
     //  Check the requested object size against the chunk ranges.  
     b = ((objectSize + 16) <= bucket[0].ChunkSize())?0:((objectSize + 16) <= bucket[1].ChunkSize())?1:2;
 
-    if ((b == 2) || (bucket[b].nextFree == bucket[b].MaxObjects()))
+    //  With concurrent users the chunk is taken from the thread cache.
+    bool concurrent = (concurrentUsers.load(std::memory_order_relaxed) != 0);
+
+    if ((b == 2) || (!concurrent && (bucket[b].nextFree == bucket[b].MaxObjects())))
     {
         if ( b == 2 ) 
             cout << "(b == 2)\n";
@@ -125,19 +255,25 @@ void* DynamicMemoryOpt::operator new( size_t objectSize ) throw()
         CG_ASSERT("Error allocating object.");
     }
 
-    p = (U32 *) &bucket[b].mem[bucket[b].map[bucket[b].nextFree] << bucket[b].ChunkSzLg2()];
+    if (concurrent)
+        idx = chunkCache.take(b);
+    else
+        idx = bucket[b].map[bucket[b].nextFree++];
+
+    p = (U32 *) &bucket[b].mem[idx << bucket[b].ChunkSzLg2()];
 
     p[0] = b;
-    p[1] = bucket[b].map[bucket[b].nextFree];
+    p[1] = idx;
     //p[2] = 0xCCCCDDDD;
 
-    //printf("p %p b %d pos %d\n", p, b, bucket[b].map[bucket[b].nextFree]);
+    //printf("p %p b %d pos %d\n", p, b, idx);
 
-    bucket[b].nextFree++;
     return &p[4];
 
 #else // !FAST_NEW_DELETE
     
+    AllocationGuard guard;
+
     U32 b;
     U32 currentSize;
     U32 i;
@@ -191,6 +327,7 @@ void DynamicMemoryOpt::operator delete ( void* obj )
 {
     if ( !obj ) // Standard behaviour
         return ;
+
 #ifdef FAST_NEW_DELETE
 
     U32 b;
@@ -203,11 +340,19 @@ void DynamicMemoryOpt::operator delete ( void* obj )
     b = *(((U32*) obj) - 4);
     idx = *(((U32*) obj) - 3);
 
-    Bucket& bu = bucket[b]; // alias to avoid multiple computations of bucket[b]
-    bu.map[--bu.nextFree] = idx; // release map, new available chunk
+    //  With concurrent users the chunk is returned to the thread cache.
+    if (concurrentUsers.load(std::memory_order_relaxed) != 0)
+        chunkCache.give(b, idx);
+    else
+    {
+        Bucket& bu = bucket[b]; // alias to avoid multiple computations of bucket[b]
+        bu.map[--bu.nextFree] = idx; // release map, new available chunk
+    }
 
 #else // !FAST_NEW_DELETE
 
+    AllocationGuard guard;
+
     U32 b;
 
     //  Check DynamicMemoryOpt initialization. 
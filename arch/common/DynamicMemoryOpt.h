@@ -5,6 +5,7 @@
 #include <cstddef> // size_t definition
 #include <new> // bad_alloc definition
 #include <string>
+#include <atomic>
 
 namespace arch
 {
@@ -75,6 +76,13 @@ private:
     static bool wasCalled;              // controls that only one call to initialize is performed in the life of the class
     static U64 timeStamp;               // Timestamp counter.  
     static U32 freqSize[];              // Stores how frequent are different object sizes (power of 2).  
+    static std::atomic<U32> concurrentUsers;    // Number of users that create or destroy objects from another thread.
+    static std::atomic_flag allocationLock;     // Serializes the allocations while there are concurrent users.
+
+    class AllocationGuard;              // Takes the allocation lock while there are concurrent users.
+    class ChunkCache;                   // Free chunks owned by a thread while there are concurrent users.
+
+    static thread_local ChunkCache chunkCache;  // Free chunk cache of the thread.
 
     /**
      * Check if a chunk is already ocupied ( used for print memory status )
@@ -151,6 +159,21 @@ public:
 
     static void usage(); // *  Dumps usage information about the two dynamic memory buckets.
 
+    /**
+     * Registers a user that creates or destroys objects from a thread other than the simulator thread
+     *
+     * While there are concurrent users the new and delete operators of each thread use a cache of
+     * free chunks that is refilled from and returned to the shared free lists in batches, so the
+     * allocation lock is only taken once per batch.  Must be called before the thread starts.
+     */
+    static void beginConcurrentAccess();
+
+    /**
+     * Unregisters a concurrent user.  Must be called after the thread has finished.  The free
+     * chunks cached by the calling thread are returned to the shared free lists.
+     */
+    static void endConcurrentAccess();
+
     // static void printNotDeletedObjects();
 }; // class DynamicMemoryOpt
 
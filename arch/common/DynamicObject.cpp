@@ -10,7 +10,7 @@
 
 using namespace arch;
 
-U32 DynamicObject::nextCookie[MAX_COOKIES]; // static implies zero initialization automatically
+thread_local U32 DynamicObject::nextCookie[MAX_COOKIES]; // static implies zero initialization automatically
 
 DynamicObject::DynamicObject() : lastCookie( 0 ), color(0)
 {
@@ -118,6 +118,20 @@ const U08* DynamicObject::getInfo() const
     return info;
 }
 
+U32 DynamicObject::getNextCookie()
+{
+    return nextCookie[0];
+}
+
+U32 DynamicObject::reserveCookies( U32 count )
+{
+    U32 first = nextCookie[0];
+
+    nextCookie[0] += count;
+
+    return first;
+}
+
 std::string DynamicObject::toString() const
 {
     return DynamicMemoryOpt::toString() + "   INFO: \"" + std::string((const char*)getInfo()) + "\"";
@@ -27,7 +27,7 @@ private:
     U32 color;                   // color object
     U08 info[MAX_INFO_SIZE];     // additional info ( i.e text )
 
-    static U32 nextCookie[];     // last cookie generated ( in a level )
+    static thread_local U32 nextCookie[];    // last cookie generated ( in a level ) by the thread
 
 public:
 
@@ -130,6 +130,20 @@ public:
 
     virtual  std::string toString() const;
 
+    /**
+     * Returns the next first level cookie of the cookie generator of the calling thread
+     */
+    static U32 getNextCookie();
+
+    /**
+     * Reserves consecutive first level cookies from the cookie generator of the calling thread
+     *
+     * @param count number of cookies reserved
+     *
+     * @return the first cookie reserved
+     */
+    static U32 reserveCookies( U32 count );
+
 };
 
 } // namespace arch
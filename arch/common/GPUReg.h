@@ -496,6 +496,7 @@ struct cgsGpuRegister
     U32 streamStart;                             //  Start position (entry) from where to start streaming data.  
     U32 streamCount;                             //  Count number of elements to stream to the Vertex Shader.  
     U32 streamInstances;                         //  Count number of instances (loops) for the current stream.  
+    S32 streamBaseVertex;                        //  Value added to the indices read from the index stream (indexed mode).  
     bool indexedMode;                               //  Indexed primitive mode.  
     U32 indexStream;                             //  Index stream buffer.  
     bool d3d9ColorStream[MAX_STREAM_BUFFERS];       //  Read components of the color attributes in the order defined by D3D9.  
@@ -887,6 +888,9 @@ enum GPURegister
     GPU_COMPUTE_PARAM_BUFFER_ADDR,
     GPU_COMPUTE_PARAM_BUFFER_SIZE,
 
+    //  Vertex stream base vertex register.  Appended to preserve legacy register IDs.
+    GPU_STREAM_BASE_VERTEX,
+
     //  Last GPU register name mark.  
     GPU_LAST_REGISTER
 };
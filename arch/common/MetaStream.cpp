@@ -5,6 +5,7 @@
 #include "MetaStream.h"
 #include <iostream>
 #include <cstring>
+#include <new>
 
 using namespace std;
 using namespace arch;
@@ -16,19 +17,68 @@ using namespace arch;
         break;
 
 
+//  Payload constructor.
+MetaStreamPayload::MetaStreamPayload(U08 *dataBuffer, U32 dataSize, ReleaseCallback releaseCallback, void *dataOwner) :
+
+references(1), data(dataBuffer), size(dataSize), callback(releaseCallback), owner(dataOwner)
+
+{
+}
+
+//  Create a payload owning an uninitialized buffer.
+MetaStreamPayload *MetaStreamPayload::create(U32 dataSize)
+{
+    //  The buffer is allocated after the payload object in the same allocation.
+    U08 *block = static_cast<U08 *>(::operator new(sizeof(MetaStreamPayload) + dataSize));
+
+    return new(block) MetaStreamPayload(block + sizeof(MetaStreamPayload), dataSize, NULL, NULL);
+}
+
+//  Create a payload owning a copy of the data.
+MetaStreamPayload *MetaStreamPayload::create(const U08 *dataBuffer, U32 dataSize)
+{
+    MetaStreamPayload *payload = create(dataSize);
+
+    memcpy(payload->data, dataBuffer, dataSize);
+
+    return payload;
+}
+
+//  Create a payload referencing memory owned by the caller.
+MetaStreamPayload *MetaStreamPayload::wrap(const U08 *dataBuffer, U32 dataSize, ReleaseCallback releaseCallback, void *dataOwner)
+{
+    //  The data pointer is stored as non const for the memory transactions but it is never written.
+    void *block = ::operator new(sizeof(MetaStreamPayload));
+
+    return new(block) MetaStreamPayload(const_cast<U08 *>(dataBuffer), dataSize, releaseCallback, dataOwner);
+}
+
+//  Release a reference to the payload.
+void MetaStreamPayload::release()
+{
+    //  The MetaStreams sharing the payload may be deleted by different threads (validation mode).
+    if (references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    if (callback != NULL)
+        callback(owner, data);
+
+    this->~MetaStreamPayload();
+    ::operator delete(static_cast<void *>(this));
+}
+
 //  MetaStream constructor.  For memory operations.  
 cgoMetaStream::cgoMetaStream(U32 addr, U32 dataSize, U08 *dataBuffer, U32 _md, bool isWrite, bool isLocked):
 
 //  Set object attributes.  
-address(addr), size(dataSize), data(dataBuffer), md(_md), locked(isLocked)
+address(addr), size(dataSize), payload(NULL), locked(isLocked), md(_md)
 
 {
     if ( dataSize == 0 )
         CG_ASSERT("Trying to create an cgoMetaStream (memory op) with size 0");
 
-    // create a copy of data 
-    data = new U08[dataSize]; // "slow new"
-    memcpy(data, dataBuffer,dataSize);
+    //  Copy the data, the driver may change its buffer once the MetaStream is created.
+    payload = MetaStreamPayload::create(dataBuffer, dataSize);
 
     //  Set as a write (system to local) memory operation.  
     if (isWrite)
@@ -50,15 +100,14 @@ address(addr), size(dataSize), data(dataBuffer), md(_md), locked(isLocked)
 cgoMetaStream::cgoMetaStream(U32 addr, U32 dataSize, U08 *dataBuffer, U32 _md):
 
 //  Set object attributes.  
-address(addr), size(dataSize), data(dataBuffer), md(_md), locked(true)
+address(addr), size(dataSize), payload(NULL), locked(true), md(_md)
 
 {
     if ( dataSize == 0 )
         CG_ASSERT("Trying to create an cgoMetaStream (memory preload) with size 0");
 
-    // create a copy of data 
-    data = new U08[dataSize]; // "slow new"
-    memcpy(data, dataBuffer,dataSize);
+    //  Copy the data, the driver may change its buffer once the MetaStream is created.
+    payload = MetaStreamPayload::create(dataBuffer, dataSize);
 
     //  Set as a preload (system or local) memory operation.  
     metaStreamType = META_STREAM_PRELOAD;
@@ -75,12 +124,34 @@ address(addr), size(dataSize), data(dataBuffer), md(_md), locked(true)
     //dump();
 }
 
+//  MetaStream constructor.  For memory write and preload operations sharing a payload.
+cgoMetaStream::cgoMetaStream(MetaStreamType type, U32 addr, MetaStreamPayload *dataPayload, U32 _md, bool isLocked):
+
+//  Set object attributes.
+metaStreamType(type), address(addr), size(dataPayload->getSize()), payload(dataPayload), locked(isLocked), md(_md)
+
+{
+    CG_ASSERT_COND(((type == META_STREAM_WRITE) || (type == META_STREAM_PRELOAD)),
+                   "Only META_STREAM_WRITE and META_STREAM_PRELOAD transactions can be created from a payload.");
+
+    if ( size == 0 )
+        CG_ASSERT("Trying to create an cgoMetaStream (memory op) with size 0");
+
+    //  Calculate number of packets for this transaction.
+    numPackets = (type == META_STREAM_WRITE) ? (1 + (size >> META_STREAM_PACKET_SHIFT)) : 1;
+
+    //  Set object color for tracing.
+    setColor(metaStreamType);
+
+    setTag("MetaStreamTr");
+}
+
 //  MetaStream constructor.  For register write operations.  
 cgoMetaStream::cgoMetaStream(GPURegister gpuR, U32 subR, GPURegData rData, U32 _md):
 
 //  Set object attributes.  
-metaStreamType(META_STREAM_REG_WRITE), gpuReg(gpuR), subReg(subR), regData(rData), md(_md),
-numPackets(1), locked(false)
+metaStreamType(META_STREAM_REG_WRITE), payload(NULL), gpuReg(gpuR), regData(rData), subReg(subR),
+numPackets(1), locked(false), md(_md)
 {
     //  Set object color for tracing.  
     setColor(META_STREAM_REG_WRITE);
@@ -94,7 +165,7 @@ numPackets(1), locked(false)
 cgoMetaStream::cgoMetaStream(GPURegister gpuR, U32 subR):
 
 //  Set object attributes.  
-metaStreamType(META_STREAM_REG_READ),gpuReg(gpuR), subReg(subR), md(0), numPackets(1), locked(false)
+metaStreamType(META_STREAM_REG_READ), payload(NULL), gpuReg(gpuR), subReg(subR), numPackets(1), locked(false), md(0)
 {
     //  Set object color for tracing.  
     setColor(META_STREAM_REG_READ);
@@ -107,7 +178,7 @@ metaStreamType(META_STREAM_REG_READ),gpuReg(gpuR), subReg(subR), md(0), numPacke
 cgoMetaStream::cgoMetaStream(GPUCommand gpuComm):
 
 //  Set object attributes.  
-metaStreamType(META_STREAM_COMMAND), gpuCommand(gpuComm), md(0), numPackets(1), locked(false)
+metaStreamType(META_STREAM_COMMAND), payload(NULL), gpuCommand(gpuComm), numPackets(1), locked(false), md(0)
 {
     //  Set object color for tracing.  
     setColor(META_STREAM_COMMAND);
@@ -117,7 +188,7 @@ metaStreamType(META_STREAM_COMMAND), gpuCommand(gpuComm), md(0), numPackets(1),
 
 // MetaStream constructor.  Creates an META_STREAM_INIT_END transaction.
 cgoMetaStream::cgoMetaStream() :
-    metaStreamType(META_STREAM_INIT_END), md(0), numPackets(1), locked(false)
+    metaStreamType(META_STREAM_INIT_END), payload(NULL), numPackets(1), locked(false), md(0)
 {
     setTag("MetaStreamTr");
 }
@@ -126,7 +197,7 @@ cgoMetaStream::cgoMetaStream() :
 cgoMetaStream::cgoMetaStream(GPUEvent gpuEvent, string msg) :
 
 //  Set object attributes.
-metaStreamType(META_STREAM_EVENT), gpuEvent(gpuEvent), eventMsg(msg)
+metaStreamType(META_STREAM_EVENT), payload(NULL), gpuEvent(gpuEvent), eventMsg(msg)
 
 {
     //  Set object color for tracing.
@@ -135,8 +206,11 @@ metaStreamType(META_STREAM_EVENT), gpuEvent(gpuEvent), eventMsg(msg)
     setTag("MetaStreamTr");
 }
 
-//  MetaStream constructor.  Load from MetaStream trace file.
-cgoMetaStream::cgoMetaStream(cgoMetaStream *sourceMetaStreamTrans)
+//  MetaStream constructor.  Clone a MetaStream.
+cgoMetaStream::cgoMetaStream(cgoMetaStream *sourceMetaStreamTrans) :
+
+payload(NULL)
+
 {
     //  Clone the transaction type.
     metaStreamType = sourceMetaStreamTrans->metaStreamType;
@@ -152,14 +226,9 @@ cgoMetaStream::cgoMetaStream(cgoMetaStream *sourceMetaStreamTrans)
             locked = sourceMetaStreamTrans->locked;
             size = sourceMetaStreamTrans->size;
             
-            //  Allocate space for the transaction data
-            data = new U08[size];
-            
-            //  Check allocation
-            if (data == NULL)
-                CG_ASSERT("Error allocating memory for META_STREAM_WRITE/META_STREAM_PRELOAD transaction data buffer.");
-
-            memcpy(data, sourceMetaStreamTrans->data, size);            
+            //  Share the transaction data.
+            payload = sourceMetaStreamTrans->payload;
+            payload->acquire();
         
             break;
             
@@ -211,7 +280,10 @@ cgoMetaStream::cgoMetaStream(cgoMetaStream *sourceMetaStreamTrans)
 }
 
 //  MetaStream constructor.  Load from MetaStream trace file.
-cgoMetaStream::cgoMetaStream(gzifstream *ProfilingFile)
+cgoMetaStream::cgoMetaStream(gzifstream *ProfilingFile) :
+
+payload(NULL)
+
 {
     U32 stringLength;
     U08 *stringData;
@@ -235,14 +307,10 @@ cgoMetaStream::cgoMetaStream(gzifstream *ProfilingFile)
             if (ProfilingFile->eof())
                 return;
                 
-            //  Allocate space for the transaction data
-            data = new U08[size];
+            //  Read the transaction data directly into the payload.
+            payload = MetaStreamPayload::create(size);
             
-            //  Check allocation
-            if (data == NULL)
-                CG_ASSERT("Error allocating memory for META_STREAM_WRITE/META_STREAM_PRELOAD transaction data buffer.");
-            
-            ProfilingFile->read((char *) data, size);
+            ProfilingFile->read((char *) payload->getData(), size);
         
             break;
             
@@ -348,7 +416,13 @@ U32 cgoMetaStream::getSize()
 //  Gets the MetaStream pointer to data for memory transactions.  
 U08 *cgoMetaStream::getData()
 {
-    return data;
+    return (payload != NULL) ? payload->getData() : NULL;
+}
+
+//  Gets the MetaStream shared data payload for memory transactions.
+MetaStreamPayload *cgoMetaStream::getPayload()
+{
+    return payload;
 }
 
 //  Gets the MetaStream GPU register identifier for register transactions.  
@@ -427,7 +501,7 @@ void cgoMetaStream::save(gzofstream *outFile)
             outFile->write((char *) &md, sizeof(md));
             outFile->write((char *) &locked, sizeof(locked));
             outFile->write((char *) &size, sizeof(size));
-            outFile->write((char *) data, size);
+            outFile->write((char *) payload->getData(), size);
         
             break;
             
@@ -482,6 +556,164 @@ void cgoMetaStream::save(gzofstream *outFile)
     
 }
 
+//  Write the complete MetaStream state into a stream.
+void cgoMetaStream::serialize(std::ostream &out) const
+{
+    CG_ASSERT_COND(!((metaStreamType == META_STREAM_READ) || (metaStreamType == META_STREAM_REG_READ)),
+                   "META_STREAM_READ and META_STREAM_REG_READ transactions can't be serialized.");
+
+    out.write((const char *) &metaStreamType, sizeof(metaStreamType));
+    out.write((const char *) &address, sizeof(address));
+    out.write((const char *) &size, sizeof(size));
+    out.write((const char *) &gpuReg, sizeof(gpuReg));
+    out.write((const char *) &subReg, sizeof(subReg));
+    out.write((const char *) &regData, sizeof(regData));
+    out.write((const char *) &gpuCommand, sizeof(gpuCommand));
+    out.write((const char *) &numPackets, sizeof(numPackets));
+    out.write((const char *) &locked, sizeof(locked));
+    out.write((const char *) &md, sizeof(md));
+    out.write((const char *) &gpuEvent, sizeof(gpuEvent));
+
+    //  Write the transaction data for memory writes.
+    if ((metaStreamType == META_STREAM_WRITE) || (metaStreamType == META_STREAM_PRELOAD))
+        out.write((const char *) payload->getData(), size);
+
+    //  Write the event message and the debug info strings.
+    U32 stringLength = U32(eventMsg.length());
+    out.write((const char *) &stringLength, sizeof(stringLength));
+    out.write(eventMsg.data(), stringLength);
+
+    stringLength = U32(debugInfo.length());
+    out.write((const char *) &stringLength, sizeof(stringLength));
+    out.write(debugInfo.data(), stringLength);
+}
+
+//  Create a MetaStream from the state written by serialize().
+cgoMetaStream *cgoMetaStream::deserialize(std::istream &in)
+{
+    MetaStreamType type;
+
+    in.read((char *) &type, sizeof(type));
+
+    if (!in.good())
+        return NULL;
+
+    //  Start from an META_STREAM_INIT_END transaction (no data buffer) and set the type once the data buffer is allocated.
+    cgoMetaStream *metaStream = new cgoMetaStream();
+
+    in.read((char *) &metaStream->address, sizeof(metaStream->address));
+    in.read((char *) &metaStream->size, sizeof(metaStream->size));
+    in.read((char *) &metaStream->gpuReg, sizeof(metaStream->gpuReg));
+    in.read((char *) &metaStream->subReg, sizeof(metaStream->subReg));
+    in.read((char *) &metaStream->regData, sizeof(metaStream->regData));
+    in.read((char *) &metaStream->gpuCommand, sizeof(metaStream->gpuCommand));
+    in.read((char *) &metaStream->numPackets, sizeof(metaStream->numPackets));
+    in.read((char *) &metaStream->locked, sizeof(metaStream->locked));
+    in.read((char *) &metaStream->md, sizeof(metaStream->md));
+    in.read((char *) &metaStream->gpuEvent, sizeof(metaStream->gpuEvent));
+
+    CG_ASSERT_COND(in.good(), "Truncated MetaStream in the input stream.");
+
+    //  Read the transaction data for memory writes.
+    if ((type == META_STREAM_WRITE) || (type == META_STREAM_PRELOAD))
+    {
+        metaStream->payload = MetaStreamPayload::create(metaStream->size);
+        in.read((char *) metaStream->payload->getData(), metaStream->size);
+    }
+
+    metaStream->metaStreamType = type;
+
+    //  Read the event message and the debug info strings.
+    U32 stringLength;
+    in.read((char *) &stringLength, sizeof(stringLength));
+    metaStream->eventMsg.resize(stringLength);
+    if (stringLength > 0)
+        in.read(&metaStream->eventMsg[0], stringLength);
+
+    in.read((char *) &stringLength, sizeof(stringLength));
+    metaStream->debugInfo.resize(stringLength);
+    if (stringLength > 0)
+        in.read(&metaStream->debugInfo[0], stringLength);
+
+    CG_ASSERT_COND(in.good(), "Truncated MetaStream in the input stream.");
+
+    //  Set dynamic object color for signal tracing.
+    metaStream->setColor(type);
+
+    return metaStream;
+}
+
+//  Read a field of a serialized MetaStream from a memory buffer.
+static void readField(const U08 *buffer, U32 bufferSize, U32 &offset, void *field, U32 fieldSize)
+{
+    CG_ASSERT_COND(((bufferSize - offset) >= fieldSize), "Truncated MetaStream in the input buffer.");
+
+    memcpy(field, &buffer[offset], fieldSize);
+    offset += fieldSize;
+}
+
+//  Release the reference to the buffer held by a payload created by deserialize().
+static void releaseBuffer(void *owner, const U08 *data)
+{
+    static_cast<MetaStreamPayload *>(owner)->release();
+}
+
+//  Create a MetaStream from the state written by serialize() into a memory buffer.
+cgoMetaStream *cgoMetaStream::deserialize(MetaStreamPayload *buffer, U32 &offset)
+{
+    const U08 *data = buffer->getData();
+    U32 bufferSize = buffer->getSize();
+
+    if (offset >= bufferSize)
+        return NULL;
+
+    MetaStreamType type;
+    readField(data, bufferSize, offset, &type, sizeof(type));
+
+    //  Start from an META_STREAM_INIT_END transaction (no data payload) and set the type once the payload is created.
+    cgoMetaStream *metaStream = new cgoMetaStream();
+
+    readField(data, bufferSize, offset, &metaStream->address, sizeof(metaStream->address));
+    readField(data, bufferSize, offset, &metaStream->size, sizeof(metaStream->size));
+    readField(data, bufferSize, offset, &metaStream->gpuReg, sizeof(metaStream->gpuReg));
+    readField(data, bufferSize, offset, &metaStream->subReg, sizeof(metaStream->subReg));
+    readField(data, bufferSize, offset, &metaStream->regData, sizeof(metaStream->regData));
+    readField(data, bufferSize, offset, &metaStream->gpuCommand, sizeof(metaStream->gpuCommand));
+    readField(data, bufferSize, offset, &metaStream->numPackets, sizeof(metaStream->numPackets));
+    readField(data, bufferSize, offset, &metaStream->locked, sizeof(metaStream->locked));
+    readField(data, bufferSize, offset, &metaStream->md, sizeof(metaStream->md));
+    readField(data, bufferSize, offset, &metaStream->gpuEvent, sizeof(metaStream->gpuEvent));
+
+    //  The transaction data of memory writes is shared with the buffer.
+    if ((type == META_STREAM_WRITE) || (type == META_STREAM_PRELOAD))
+    {
+        CG_ASSERT_COND(((bufferSize - offset) >= metaStream->size), "Truncated MetaStream in the input buffer.");
+
+        buffer->acquire();
+        metaStream->payload = MetaStreamPayload::wrap(&data[offset], metaStream->size, releaseBuffer, buffer);
+        offset += metaStream->size;
+    }
+
+    metaStream->metaStreamType = type;
+
+    //  Read the event message and the debug info strings.
+    U32 stringLength;
+    readField(data, bufferSize, offset, &stringLength, sizeof(stringLength));
+    metaStream->eventMsg.resize(stringLength);
+    if (stringLength > 0)
+        readField(data, bufferSize, offset, &metaStream->eventMsg[0], stringLength);
+
+    readField(data, bufferSize, offset, &stringLength, sizeof(stringLength));
+    metaStream->debugInfo.resize(stringLength);
+    if (stringLength > 0)
+        readField(data, bufferSize, offset, &metaStream->debugInfo[0], stringLength);
+
+    //  Set dynamic object color for signal tracing.
+    metaStream->setColor(type);
+
+    return metaStream;
+}
+
 void cgoMetaStream::dump(std::ostream& os) const
 {
     os << "( MetaStreamt: ";
@@ -506,7 +738,8 @@ void cgoMetaStream::dump(std::ostream& os) const
         os << ", Address: " << hex << address << dec << ", Size: " << size <<
             ", Data HC: ";
         U32 sum = 0;
-        for ( U32 i = 0; i < size; i++ )
+        const U08 *data = (payload != NULL) ? payload->getData() : NULL;
+        for ( U32 i = 0; (data != NULL) && (i < size); i++ )
         {
             sum += (((U32)data[i]) * i) % 255;
         }
@@ -699,6 +932,7 @@ void cgoMetaStream::dump(std::ostream& os) const
             CASE_PRINT( GPU_COMPUTE_SHARED_MEM_SIZE )
             CASE_PRINT( GPU_COMPUTE_PARAM_BUFFER_ADDR )
             CASE_PRINT( GPU_COMPUTE_PARAM_BUFFER_SIZE )
+            CASE_PRINT( GPU_STREAM_BASE_VERTEX )
             
             //  Last GPU register name mark.
             CASE_PRINT( GPU_LAST_REGISTER )
@@ -760,8 +994,7 @@ void cgoMetaStream::dump(std::ostream& os) const
 
 cgoMetaStream::~cgoMetaStream()
 {
-    if ( metaStreamType == META_STREAM_READ || metaStreamType == META_STREAM_WRITE || metaStreamType == META_STREAM_PRELOAD)
-    {
-        delete[] data;
-    }
+    //  Release the reference to the shared data.
+    if (payload != NULL)
+        payload->release();
 }
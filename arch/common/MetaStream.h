@@ -8,6 +8,7 @@
 #include <string>
 #include <ostream>
 #include <iostream>
+#include <atomic>
 #include "zfstream.h"
 
 namespace arch
@@ -32,6 +33,103 @@ enum MetaStreamType
     META_STREAM_EVENT       //  Signal an event to the GPU Command processor.  
 };
 
+/**
+ *
+ *  Immutable reference counted data buffer of the memory MetaStreams.
+ *
+ *  The MetaStreams that carry the same data (clones, copies queued for the
+ *  behaviorModel) share the payload instead of copying the data.  A payload
+ *  either owns its buffer (allocated with the payload) or points to memory
+ *  owned by the driver or the trace reader that is handed back to the owner
+ *  with the release callback when the last reference is released.  The data
+ *  must not be modified while the payload is referenced.
+ *
+ */
+
+class MetaStreamPayload
+{
+public:
+
+    /**
+     *  Callback that releases the memory referenced by a payload created with wrap().
+     *
+     *  @param owner The owner pointer passed to wrap().
+     *  @param data The data pointer passed to wrap().
+     */
+    typedef void (*ReleaseCallback)(void *owner, const U08 *data);
+
+    /**
+     *  Creates a payload that owns an uninitialized buffer.  The caller fills the
+     *  buffer before sharing the payload.
+     *
+     *  @param size Size in bytes of the buffer.
+     *
+     *  @return A payload with one reference.
+     */
+    static MetaStreamPayload *create(U32 size);
+
+    /**
+     *  Creates a payload that owns a copy of the data.
+     *
+     *  @param data Pointer to the data to copy.
+     *  @param size Size in bytes of the data.
+     *
+     *  @return A payload with one reference.
+     */
+    static MetaStreamPayload *create(const U08 *data, U32 size);
+
+    /**
+     *  Creates a payload that references memory owned by the caller without copying it.
+     *
+     *  @param data Pointer to the data.
+     *  @param size Size in bytes of the data.
+     *  @param callback Function called when the last reference is released, NULL if the
+     *  memory outlives the payload.
+     *  @param owner Pointer passed to the callback.
+     *
+     *  @return A payload with one reference.
+     */
+    static MetaStreamPayload *wrap(const U08 *data, U32 size, ReleaseCallback callback, void *owner);
+
+    /**
+     *  Adds a reference to the payload.
+     */
+    void acquire() { references.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     *  Releases a reference to the payload.  The payload is destroyed with the last reference.
+     */
+    void release();
+
+    /**
+     *  Returns a pointer to the payload data.
+     */
+    U08 *getData() const { return data; }
+
+    /**
+     *  Returns the size in bytes of the payload data.
+     */
+    U32 getSize() const { return size; }
+
+    /**
+     *  Returns the number of references to the payload.  When it returns one the owner
+     *  can modify the data, the releases of the other references happen before.
+     */
+    U32 getReferences() const { return references.load(std::memory_order_acquire); }
+
+private:
+
+    std::atomic<U32> references;    //  Number of references to the payload.
+    U08 *data;                      //  Pointer to the data.
+    U32 size;                       //  Size in bytes of the data.
+    ReleaseCallback callback;       //  Releases the memory of a wrapped payload.
+    void *owner;                    //  Owner of the memory of a wrapped payload.
+
+    MetaStreamPayload(U08 *data, U32 size, ReleaseCallback callback, void *owner);
+    MetaStreamPayload(const MetaStreamPayload &);
+    MetaStreamPayload &operator=(const MetaStreamPayload &);
+};
+
 
 /**
  *
@@ -53,7 +151,7 @@ private:
     MetaStreamType     metaStreamType;          //  Type of this MetaStream.  
     U32         address;         //  MetaStream destination address.  
     U32         size;            //  Size in bytes of the transmited data.  
-    U08        *data;            //  Pointer to the transmited data.  
+    MetaStreamPayload *payload;  //  Shared buffer with the transmited data.  
     GPURegister gpuReg;          //  GPU register from which read or write.  
     GPURegData  regData;         //  Data to read/write from the GPU register.  
     U32         subReg;          //  GPU register subregister address.  
@@ -97,6 +195,20 @@ public:
      */
     cgoMetaStream(U32 address, U32 size, U08 *data, U32 md);
 
+    /**
+     *  MetaStream constructor function.
+     *  MetaStream Write or Preload data from a shared payload without copying it.
+     *
+     *  @param type META_STREAM_WRITE or META_STREAM_PRELOAD.
+     *  @param address GPU or system memory address into which to write the data.
+     *  @param payload The payload with the data.  The MetaStream takes ownership of one reference.
+     *  @param md Identifier of the memory descriptor (GPU driver) associated with this MetaStream.
+     *  @param isLocked TRUE if the write operation must wait until the end of the batch.
+     *
+     *  @return  An initialized MetaStream object.
+     */
+    cgoMetaStream(MetaStreamType type, U32 address, MetaStreamPayload *payload, U32 md, bool isLocked = true);
+
     /**
      *
      *  MetaStream constructor function.
@@ -172,7 +284,8 @@ public:
     /**
      *
      *  MetaStream constructor.
-     *  Clones the MetaStream passed as a parameter.
+     *  Clones the MetaStream passed as a parameter.  The clone shares the data
+     *  payload of memory MetaStreams.
      *
      *  @param sourceMetaStreamTrans Pointer to the cgoMetaStream to clone.
      *
@@ -218,7 +331,8 @@ public:
     /**
      *
      *  Returns the pointer to the buffer for the data to read/write
-     *  in the MetaStream.
+     *  in the MetaStream.  The buffer is shared with the clones of the
+     *  MetaStream and must not be modified.
      *
      *  @return MetaStream data buffer pointer.
      *
@@ -226,6 +340,18 @@ public:
 
     U08 *getData();
 
+    /**
+     *
+     *  Returns the shared payload with the data of a memory MetaStream.  The
+     *  caller must acquire a reference to keep the payload after the MetaStream
+     *  is deleted.
+     *
+     *  @return The MetaStream data payload, NULL if the MetaStream has no data.
+     *
+     */
+
+    MetaStreamPayload *getPayload();
+
     /**
      *
      *  Returns the amount of bytes that are being transmited
@@ -328,6 +454,46 @@ public:
     
     void save(gzofstream *outFile);
 
+    /**
+     *
+     *  Writes the complete MetaStream state into a stream.  Unlike save() all the attributes
+     *  (locked flag, number of packets) and the META_STREAM_INIT_END transactions are written so
+     *  the MetaStream created by deserialize() is identical to the original MetaStream.
+     *
+     *  @param out Reference to the stream where the MetaStream is written.
+     *
+     */
+
+    void serialize(std::ostream &out) const;
+
+    /**
+     *
+     *  Creates a MetaStream from the state written into a stream by serialize().
+     *
+     *  @param in Reference to the stream from where the MetaStream is read.
+     *
+     *  @return A pointer to the new MetaStream, NULL if the end of the stream was reached.
+     *
+     */
+
+    static cgoMetaStream *deserialize(std::istream &in);
+
+    /**
+     *
+     *  Creates a MetaStream from the state written by serialize() into a memory buffer.  The
+     *  data of memory MetaStreams is not copied, the MetaStream payload points into the
+     *  buffer and keeps a reference to the buffer payload.
+     *
+     *  @param buffer Payload with the serialized MetaStreams.
+     *  @param offset Offset inside the buffer of the MetaStream to read.  Updated with the
+     *  offset of the next MetaStream.
+     *
+     *  @return A pointer to the new MetaStream, NULL if the end of the buffer was reached.
+     *
+     */
+
+    static cgoMetaStream *deserialize(MetaStreamPayload *buffer, U32 &offset);
+
     /**
      *
      *  Changes an MetaStream from META_STREAM_WRITE to META_STREAM_PRELOAD.
@@ -0,0 +1,412 @@
+/**************************************************************************
+ *
+ * MetaStream block file implementation file.
+ *
+ */
+
+#include "MetaStreamBlockFile.h"
+#include "support.h"
+
+#include <zlib.h>
+#include <cstring>
+#include <sstream>
+
+using namespace std;
+
+namespace arch
+{
+
+cgoMetaStreamBlockWriter::cgoMetaStreamBlockWriter() :
+    blockSize(META_STREAM_BLOCK_SIZE), codec(META_STREAM_BLOCK_DEFLATE), failed(false), offset(0),
+    metaStreams(0), frames(0), batches(0)
+{
+    memset(&current, 0, sizeof(current));
+}
+
+cgoMetaStreamBlockWriter::~cgoMetaStreamBlockWriter()
+{
+    if (file.is_open())
+        close();
+}
+
+bool cgoMetaStreamBlockWriter::open(const char *fileName, const void *traceHeader, U32 traceHeaderSize,
+                                    U32 blockSize_, MetaStreamBlockCodec codec_)
+{
+    file.open(fileName, ios::out | ios::binary | ios::trunc);
+
+    if (!file.is_open())
+        return false;
+
+    blockSize = blockSize_;
+    codec = codec_;
+    failed = false;
+    block.clear();
+    index.clear();
+    metaStreams = 0;
+    frames = 0;
+    batches = 0;
+
+    cgsMetaStreamBlockHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, META_STREAM_BLOCK_MAGIC, sizeof(header.magic));
+    header.version = META_STREAM_BLOCK_VERSION;
+    header.codec = codec;
+    header.traceHeaderSize = traceHeaderSize;
+
+    file.write((const char *) &header, sizeof(header));
+    file.write((const char *) traceHeader, traceHeaderSize);
+
+    offset = sizeof(header) + traceHeaderSize;
+
+    return file.good();
+}
+
+void cgoMetaStreamBlockWriter::write(cgoMetaStream *metaStream)
+{
+    //  The markers of a block are the counters before its first MetaStream.
+    if (block.empty())
+    {
+        memset(&current, 0, sizeof(current));
+        current.firstMetaStream = metaStreams;
+        current.firstFrame = frames;
+        current.firstBatch = batches;
+    }
+
+    ostringstream out;
+    metaStream->serialize(out);
+    block += out.str();
+
+    current.metaStreams++;
+    metaStreams++;
+
+    if (metaStream->GetMetaStreamType() == META_STREAM_COMMAND)
+    {
+        if (metaStream->getGPUCommand() == GPU_SWAPBUFFERS)
+            frames++;
+        else if (metaStream->getGPUCommand() == GPU_DRAW)
+            batches++;
+    }
+
+    if (block.size() >= blockSize)
+        writeBlock();
+}
+
+void cgoMetaStreamBlockWriter::writeBlock()
+{
+    if (block.empty())
+        return;
+
+    current.offset = offset;
+    current.bytes = U32(block.size());
+    current.storedBytes = current.bytes;
+
+    const U08 *stored = (const U08 *) block.data();
+    vector<U08> compressed;
+
+    //  Keep the block uncompressed if deflate does not reduce it.
+    if (codec == META_STREAM_BLOCK_DEFLATE)
+    {
+        uLongf comprBytes = compressBound(current.bytes);
+        compressed.resize(comprBytes);
+
+        if ((compress2(&compressed[0], &comprBytes, stored, current.bytes, Z_DEFAULT_COMPRESSION) == Z_OK) &&
+            (comprBytes < current.bytes))
+        {
+            stored = &compressed[0];
+            current.storedBytes = U32(comprBytes);
+        }
+    }
+
+    file.write((const char *) stored, current.storedBytes);
+    failed = failed || !file.good();
+
+    offset += current.storedBytes;
+    index.push_back(current);
+    block.clear();
+}
+
+bool cgoMetaStreamBlockWriter::close()
+{
+    writeBlock();
+
+    cgsMetaStreamBlockFooter footer;
+    memset(&footer, 0, sizeof(footer));
+    footer.indexOffset = offset;
+    footer.blockCount = U32(index.size());
+    memcpy(footer.magic, META_STREAM_BLOCK_MAGIC, sizeof(footer.magic));
+
+    if (!index.empty())
+        file.write((const char *) &index[0], index.size() * sizeof(cgsMetaStreamBlockEntry));
+    file.write((const char *) &footer, sizeof(footer));
+
+    failed = failed || !file.good();
+    file.close();
+
+    return !failed;
+}
+
+bool cgoMetaStreamBlockReader::isBlockFile(const char *fileName)
+{
+    ifstream in(fileName, ios::in | ios::binary);
+    char magic[sizeof(META_STREAM_BLOCK_MAGIC)];
+
+    in.read(magic, sizeof(magic));
+
+    return in.good() && (memcmp(magic, META_STREAM_BLOCK_MAGIC, sizeof(magic)) == 0);
+}
+
+cgoMetaStreamBlockReader::cgoMetaStreamBlockReader(U32 readers_, U32 lookahead_) :
+    codec(META_STREAM_BLOCK_STORED), readers(readers_), lookahead(lookahead_), nextBlock(0), readBlock(0),
+    endBlock(0), started(false), stopWorkers(false), errorBlock(0xffffffff), current(NULL), currentOffset(0)
+{
+    CG_ASSERT_COND((readers != 0), "MetaStream block reader requires at least one reader thread.");
+    CG_ASSERT_COND((lookahead >= readers), "MetaStream block reader lookahead must be at least the number of reader threads.");
+}
+
+cgoMetaStreamBlockReader::~cgoMetaStreamBlockReader()
+{
+    stop();
+}
+
+bool cgoMetaStreamBlockReader::open(const char *fileName_)
+{
+    CG_ASSERT_COND(!started, "MetaStream block file opened while being read.");
+
+    fileName = fileName_;
+
+    ifstream in(fileName.c_str(), ios::in | ios::binary);
+
+    if (!in.is_open())
+        return false;
+
+    cgsMetaStreamBlockHeader header;
+    in.read((char *) &header, sizeof(header));
+
+    if (!in.good() || (memcmp(header.magic, META_STREAM_BLOCK_MAGIC, sizeof(header.magic)) != 0) ||
+        (header.version != META_STREAM_BLOCK_VERSION) || (header.codec > META_STREAM_BLOCK_DEFLATE))
+        return false;
+
+    codec = MetaStreamBlockCodec(header.codec);
+
+    traceHeader.resize(header.traceHeaderSize);
+    if (header.traceHeaderSize > 0)
+        in.read((char *) &traceHeader[0], header.traceHeaderSize);
+
+    cgsMetaStreamBlockFooter footer;
+    in.seekg(-streamoff(sizeof(footer)), ios::end);
+    in.read((char *) &footer, sizeof(footer));
+
+    if (!in.good() || (memcmp(footer.magic, META_STREAM_BLOCK_MAGIC, sizeof(footer.magic)) != 0))
+        return false;
+
+    index.resize(footer.blockCount);
+    in.seekg(streamoff(footer.indexOffset), ios::beg);
+    if (footer.blockCount > 0)
+        in.read((char *) &index[0], footer.blockCount * sizeof(cgsMetaStreamBlockEntry));
+
+    return in.good();
+}
+
+U32 cgoMetaStreamBlockReader::findFrameBlock(U32 frame) const
+{
+    //  Last block that starts before the GPU_SWAPBUFFERS command ending the previous frame.
+    U32 block = 0;
+
+    for(U32 b = 1; (b < index.size()) && (index[b].firstFrame < frame); b++)
+        block = b;
+
+    return block;
+}
+
+U32 cgoMetaStreamBlockReader::findMetaStreamBlock(U32 metaStream) const
+{
+    //  Last block that starts before or at the MetaStream.
+    U32 block = 0;
+
+    for(U32 b = 1; (b < index.size()) && (index[b].firstMetaStream <= metaStream); b++)
+        block = b;
+
+    return block;
+}
+
+void cgoMetaStreamBlockReader::start(U32 firstBlock, U32 endBlock_)
+{
+    CG_ASSERT_COND(!started, "MetaStream block reader already started.");
+    CG_ASSERT_COND((firstBlock <= index.size()), "MetaStream block %d out of range.", firstBlock);
+
+    started = true;
+    stopWorkers = false;
+    nextBlock = firstBlock;
+    readBlock = firstBlock;
+    endBlock = (endBlock_ < index.size()) ? endBlock_ : U32(index.size());
+
+    slots.resize(lookahead);
+    for(U32 s = 0; s < lookahead; s++)
+    {
+        slots[s].block = 0;
+        slots[s].data = NULL;
+    }
+
+    for(U32 r = 0; r < readers; r++)
+        workers.push_back(thread(&cgoMetaStreamBlockReader::workerLoop, this));
+}
+
+void cgoMetaStreamBlockReader::stop()
+{
+    {
+        lock_guard<mutex> lock(readerMutex);
+        stopWorkers = true;
+    }
+
+    slotFree.notify_all();
+
+    for(size_t w = 0; w < workers.size(); w++)
+        workers[w].join();
+    workers.clear();
+
+    //  Release the blocks not read.
+    for(size_t s = 0; s < slots.size(); s++)
+    {
+        if (slots[s].data != NULL)
+            slots[s].data->release();
+        slots[s].data = NULL;
+    }
+
+    if (current != NULL)
+        current->release();
+    current = NULL;
+
+    started = false;
+}
+
+void cgoMetaStreamBlockReader::workerLoop()
+{
+    ifstream in(fileName.c_str(), ios::in | ios::binary);
+    vector<U08> stored;
+
+    unique_lock<mutex> lock(readerMutex);
+
+    while(!stopWorkers)
+    {
+        //  Wait until the next block is inside the lookahead window.
+        if ((nextBlock >= endBlock) || (nextBlock >= (readBlock + lookahead)))
+        {
+            slotFree.wait(lock);
+            continue;
+        }
+
+        U32 block = nextBlock++;
+
+        lock.unlock();
+
+        string errorMsg;
+        MetaStreamPayload *data = loadBlock(in, block, stored, errorMsg);
+
+        lock.lock();
+
+        if (data != NULL)
+        {
+            //  The previous block in the slot was already taken by the reader.
+            Slot &slot = slots[block % lookahead];
+            slot.block = block;
+            slot.data = data;
+        }
+        else if (block < errorBlock)
+        {
+            errorBlock = block;
+            error = errorMsg;
+        }
+
+        blockReady.notify_all();
+    }
+}
+
+MetaStreamPayload *cgoMetaStreamBlockReader::loadBlock(ifstream &in, U32 block, vector<U08> &stored, string &errorMsg)
+{
+    const cgsMetaStreamBlockEntry &entry = index[block];
+
+    if (!in.is_open())
+    {
+        errorMsg = "Error opening MetaStream block file " + fileName + ".";
+        return NULL;
+    }
+
+    MetaStreamPayload *data = MetaStreamPayload::create(entry.bytes);
+
+    in.clear();
+    in.seekg(streamoff(entry.offset), ios::beg);
+
+    //  Blocks that deflate did not reduce are stored uncompressed.
+    if (entry.storedBytes == entry.bytes)
+    {
+        in.read((char *) data->getData(), entry.bytes);
+
+        if (in.good())
+            return data;
+    }
+    else
+    {
+        stored.resize(entry.storedBytes);
+        in.read((char *) &stored[0], entry.storedBytes);
+
+        uLongf bytes = entry.bytes;
+
+        if (in.good() && (uncompress(data->getData(), &bytes, &stored[0], entry.storedBytes) == Z_OK) &&
+            (bytes == entry.bytes))
+            return data;
+    }
+
+    data->release();
+
+    ostringstream msg;
+    msg << "Error reading block " << block << " from MetaStream block file " << fileName << ".";
+    errorMsg = msg.str();
+
+    return NULL;
+}
+
+cgoMetaStream *cgoMetaStreamBlockReader::next()
+{
+    if (!started)
+        start(0);
+
+    while(true)
+    {
+        if (current != NULL)
+        {
+            cgoMetaStream *metaStream = cgoMetaStream::deserialize(current, currentOffset);
+
+            if (metaStream != NULL)
+                return metaStream;
+
+            //  The MetaStreams of the block keep their own references to the block.
+            current->release();
+            current = NULL;
+
+            {
+                lock_guard<mutex> lock(readerMutex);
+                readBlock++;
+            }
+
+            slotFree.notify_all();
+        }
+
+        if (readBlock >= endBlock)
+            return NULL;
+
+        unique_lock<mutex> lock(readerMutex);
+
+        Slot &slot = slots[readBlock % lookahead];
+
+        while(((slot.data == NULL) || (slot.block != readBlock)) && (errorBlock != readBlock))
+            blockReady.wait(lock);
+
+        CG_ASSERT_COND((errorBlock != readBlock), "%s", error.c_str());
+
+        current = slot.data;
+        currentOffset = 0;
+        slot.data = NULL;
+    }
+}
+
+} // namespace arch
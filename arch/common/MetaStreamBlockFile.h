@@ -0,0 +1,281 @@
+/**************************************************************************
+ *
+ * MetaStream block file definition file.
+ *  This file defines the classes used to write and read MetaStream traces
+ *  stored in independently compressed blocks.
+ *
+ *  A block stores a sequence of MetaStreams written with cgoMetaStream::serialize().
+ *  The block index at the end of the file stores the position of each block and
+ *  the number of MetaStreams, frames (GPU_SWAPBUFFERS) and batches (GPU_DRAW) before
+ *  the block, so a block can be located and decompressed without reading the
+ *  previous blocks.  The reader decompresses the next blocks in worker threads
+ *  ahead of the simulator.
+ *
+ */
+
+#ifndef __METASTREAMBLOCKFILE_H__
+#define __METASTREAMBLOCKFILE_H__
+
+#include "GPUType.h"
+#include "MetaStream.h"
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace arch
+{
+
+//  MetaStream block file definitions.
+static const char META_STREAM_BLOCK_MAGIC[8] = {'C', 'G', 'M', 'S', 'B', 'L', 'K', '1'};
+static const U32 META_STREAM_BLOCK_VERSION = 1;
+static const U32 META_STREAM_BLOCK_SIZE = 1024 * 1024;     //  Default uncompressed bytes per block.
+static const U32 META_STREAM_BLOCK_READERS = 2;            //  Default number of reader threads.
+static const U32 META_STREAM_BLOCK_LOOKAHEAD = 8;          //  Default number of blocks decompressed ahead.
+static const char META_STREAM_BLOCK_EXTENSION[] = ".msblk";
+
+/**
+ *  Compression of the blocks.
+ */
+enum MetaStreamBlockCodec
+{
+    META_STREAM_BLOCK_STORED = 0,       //  Blocks stored uncompressed.
+    META_STREAM_BLOCK_DEFLATE = 1       //  Blocks compressed with deflate (zlib).
+};
+
+/**
+ *  MetaStream block file header.
+ *  The header is followed by the trace header (traceHeaderSize bytes, the MetaStreamHeader of
+ *  the original trace) and the blocks.
+ */
+struct cgsMetaStreamBlockHeader
+{
+    char magic[8];          //  META_STREAM_BLOCK_MAGIC.
+    U32 version;            //  META_STREAM_BLOCK_VERSION.
+    U32 codec;              //  MetaStreamBlockCodec used for the blocks.
+    U32 traceHeaderSize;    //  Size of the trace header in bytes.
+    U32 reserved;
+};
+
+/**
+ *  MetaStream block index entry.
+ */
+struct cgsMetaStreamBlockEntry
+{
+    U64 offset;             //  Position of the block in the file.
+    U32 storedBytes;        //  Bytes stored for the block.  Equal to bytes if stored uncompressed.
+    U32 bytes;              //  Uncompressed bytes of the block.
+    U32 firstMetaStream;    //  MetaStreams before the block.
+    U32 metaStreams;        //  MetaStreams in the block.
+    U32 firstFrame;         //  Frames (GPU_SWAPBUFFERS commands) before the block.
+    U32 firstBatch;         //  Batches (GPU_DRAW commands) before the block.
+};
+
+/**
+ *  MetaStream block file footer.  Written at the end of the file after the block index.
+ */
+struct cgsMetaStreamBlockFooter
+{
+    U64 indexOffset;        //  Position of the block index in the file.
+    U32 blockCount;         //  Number of entries in the block index.
+    U32 reserved;
+    char magic[8];          //  META_STREAM_BLOCK_MAGIC.
+};
+
+/**
+ *  Writes a MetaStream block file.
+ */
+class cgoMetaStreamBlockWriter
+{
+public:
+
+    cgoMetaStreamBlockWriter();
+    ~cgoMetaStreamBlockWriter();
+
+    /**
+     *  Creates the block file.
+     *
+     *  @param fileName Name of the file.
+     *  @param traceHeader Pointer to the trace header stored with the MetaStreams.
+     *  @param traceHeaderSize Size of the trace header in bytes.
+     *  @param blockSize Uncompressed bytes after which a block is closed.
+     *  @param codec Compression of the blocks.
+     *
+     *  @return If the file was created.
+     */
+    bool open(const char *fileName, const void *traceHeader, U32 traceHeaderSize,
+              U32 blockSize = META_STREAM_BLOCK_SIZE, MetaStreamBlockCodec codec = META_STREAM_BLOCK_DEFLATE);
+
+    /**
+     *  Adds a MetaStream to the current block.
+     *
+     *  @param metaStream Pointer to the MetaStream.  The caller keeps the MetaStream.
+     */
+    void write(cgoMetaStream *metaStream);
+
+    /**
+     *  Writes the last block and the block index and closes the file.
+     *
+     *  @return If the file was written without errors.
+     */
+    bool close();
+
+    /**
+     *  Returns the number of blocks written.
+     */
+    U32 getBlockCount() const { return U32(index.size()); }
+
+private:
+
+    std::ofstream file;
+    U32 blockSize;
+    MetaStreamBlockCodec codec;
+    bool failed;
+
+    std::string block;                          //  MetaStreams of the current block.
+    cgsMetaStreamBlockEntry current;            //  Index entry of the current block.
+    std::vector<cgsMetaStreamBlockEntry> index;
+    U64 offset;                                 //  Position of the next block in the file.
+    U32 metaStreams;                            //  MetaStreams written.
+    U32 frames;                                 //  GPU_SWAPBUFFERS commands written.
+    U32 batches;                                //  GPU_DRAW commands written.
+
+    void writeBlock();
+};
+
+/**
+ *  Reads a MetaStream block file.
+ *
+ *  The worker threads decompress the blocks that follow the block being read, up to a
+ *  maximum number of blocks ahead.  The MetaStreams are created by next() in the caller
+ *  thread, the data of the memory MetaStreams points into the decompressed block (see
+ *  cgoMetaStream::deserialize) so the block is released when its last MetaStream is deleted.
+ */
+class cgoMetaStreamBlockReader
+{
+public:
+
+    /**
+     *  Returns if a file is a MetaStream block file.
+     *
+     *  @param fileName Name of the file.
+     */
+    static bool isBlockFile(const char *fileName);
+
+    /**
+     *  Block reader constructor.
+     *
+     *  @param readers Number of worker threads.
+     *  @param lookahead Maximum number of blocks decompressed ahead.
+     */
+    cgoMetaStreamBlockReader(U32 readers = META_STREAM_BLOCK_READERS, U32 lookahead = META_STREAM_BLOCK_LOOKAHEAD);
+
+    /**
+     *  Stops the worker threads and releases the blocks not read.
+     */
+    ~cgoMetaStreamBlockReader();
+
+    /**
+     *  Opens a block file and reads the trace header and the block index.
+     *
+     *  @param fileName Name of the file.
+     *
+     *  @return If the file is a valid MetaStream block file.
+     */
+    bool open(const char *fileName);
+
+    /**
+     *  Returns the trace header stored in the file.
+     */
+    const std::vector<U08> &getTraceHeader() const { return traceHeader; }
+
+    /**
+     *  Returns the block index.
+     */
+    const std::vector<cgsMetaStreamBlockEntry> &getIndex() const { return index; }
+
+    /**
+     *  Returns the compression of the blocks.
+     */
+    MetaStreamBlockCodec getCodec() const { return codec; }
+
+    /**
+     *  Returns the name of the opened file.
+     */
+    const std::string &getFileName() const { return fileName; }
+
+    /**
+     *  Returns the first block to read to reach the start of a frame.  The block
+     *  contains the GPU_SWAPBUFFERS command that ends the previous frame (block 0
+     *  for the first frame).
+     *
+     *  @param frame Frame number (number of GPU_SWAPBUFFERS commands before the frame).
+     */
+    U32 findFrameBlock(U32 frame) const;
+
+    /**
+     *  Returns the block that contains a MetaStream.
+     *
+     *  @param metaStream MetaStream number (number of MetaStreams before the MetaStream).
+     */
+    U32 findMetaStreamBlock(U32 metaStream) const;
+
+    /**
+     *  Starts the worker threads.  The MetaStreams are read from the start of a block up
+     *  to the end of the file or the start of a later block.
+     *
+     *  @param firstBlock First block to read.
+     *  @param endBlock Block after the last block to read, the end of the file if larger
+     *  than the number of blocks.
+     */
+    void start(U32 firstBlock = 0, U32 endBlock = 0xffffffff);
+
+    /**
+     *  Returns the next MetaStream, NULL after the last MetaStream.  Starts the worker
+     *  threads from the first block if start() was not called.
+     */
+    cgoMetaStream *next();
+
+private:
+
+    //  Decompressed block slot.
+    struct Slot
+    {
+        U32 block;                      //  Block stored in the slot.
+        MetaStreamPayload *data;        //  Decompressed block, NULL if not decompressed yet.
+    };
+
+    std::string fileName;
+    MetaStreamBlockCodec codec;
+    std::vector<U08> traceHeader;
+    std::vector<cgsMetaStreamBlockEntry> index;
+
+    U32 readers;
+    U32 lookahead;
+    std::vector<std::thread> workers;
+    std::mutex readerMutex;
+    std::condition_variable blockReady;     //  Signaled when a block is decompressed.
+    std::condition_variable slotFree;       //  Signaled when the reader moves to the next block.
+    std::vector<Slot> slots;                //  Block b is stored in slot b % lookahead.
+    U32 nextBlock;                          //  Next block to decompress.
+    U32 readBlock;                          //  Block being read by next().
+    U32 endBlock;                           //  Block after the last block to read.
+    bool started;
+    bool stopWorkers;
+    U32 errorBlock;                         //  Block that a worker thread failed to read.
+    std::string error;                      //  Error found reading the block.
+
+    MetaStreamPayload *current;             //  Block being read by next().
+    U32 currentOffset;                      //  Offset of the next MetaStream in the block.
+
+    void workerLoop();
+    MetaStreamPayload *loadBlock(std::ifstream &in, U32 block, std::vector<U08> &stored, std::string &errorMsg);
+    void stop();
+};
+
+} // namespace arch
+
+#endif
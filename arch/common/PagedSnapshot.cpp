@@ -0,0 +1,438 @@
+/**************************************************************************
+ *
+ * Paged snapshot implementation file.
+ *  This file implements the classes used to save and restore incremental,
+ *  compressed snapshots of the simulated GPU and system memories.
+ *
+ */
+
+#include "PagedSnapshot.h"
+#include "support.h"
+
+#include <zlib.h>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace arch
+{
+
+//  Returns the global snapshot writer.
+cgoSnapshotWriter &cgoSnapshotWriter::getInstance()
+{
+    static cgoSnapshotWriter writer;
+
+    return writer;
+}
+
+cgoSnapshotWriter::cgoSnapshotWriter() : busy(false), stop(false)
+{
+    worker = thread(&cgoSnapshotWriter::workerLoop, this);
+}
+
+cgoSnapshotWriter::~cgoSnapshotWriter()
+{
+    {
+        unique_lock<mutex> lock(queueMutex);
+        stop = true;
+    }
+    queueCond.notify_all();
+
+    //  The worker drains the pending jobs before exiting.
+    if (worker.joinable())
+        worker.join();
+}
+
+void cgoSnapshotWriter::enqueue(Job *job)
+{
+    {
+        unique_lock<mutex> lock(queueMutex);
+        jobs.push_back(job);
+    }
+    queueCond.notify_all();
+}
+
+void cgoSnapshotWriter::flush()
+{
+    unique_lock<mutex> lock(queueMutex);
+    queueCond.wait(lock, [this] { return jobs.empty() && !busy; });
+}
+
+void cgoSnapshotWriter::workerLoop()
+{
+    unique_lock<mutex> lock(queueMutex);
+
+    while (true)
+    {
+        queueCond.wait(lock, [this] { return stop || !jobs.empty(); });
+
+        if (jobs.empty())
+            break;
+
+        Job *job = jobs.front();
+        jobs.pop_front();
+        busy = true;
+
+        lock.unlock();
+        writeJob(job);
+        delete job;
+        lock.lock();
+
+        busy = false;
+        queueCond.notify_all();
+    }
+}
+
+//  Compresses the pages of a job and writes the snapshot file.
+void cgoSnapshotWriter::writeJob(Job *job)
+{
+    const U32 pageSize = job->header.pageSize;
+    const U32 pageCount = U32(job->pages.size());
+
+    vector<cgsPagedSnapshotEntry> index(pageCount);
+    vector<vector<U08> > blobs(pageCount);
+
+    for(U32 p = 0; p < pageCount; p++)
+    {
+        const U08 *page = &job->data[size_t(p) * pageSize];
+        uLongf comprBytes = compressBound(pageSize);
+
+        blobs[p].resize(comprBytes);
+
+        //  Keep the page uncompressed if deflate does not reduce it.
+        if ((compress2(&blobs[p][0], &comprBytes, page, pageSize, Z_BEST_SPEED) == Z_OK) && (comprBytes < pageSize))
+            blobs[p].resize(comprBytes);
+        else
+            blobs[p].assign(page, page + pageSize);
+
+        index[p].page = job->pages[p];
+        index[p].storedBytes = U32(blobs[p].size());
+    }
+
+    ofstream out(job->fileName.c_str(), ios::binary);
+
+    if (!out.is_open())
+    {
+        cerr << "cgoSnapshotWriter => Error creating snapshot file " << job->fileName << endl;
+        return;
+    }
+
+    out.write((const char *) &job->header, sizeof(cgsPagedSnapshotHeader));
+    out.write(job->parentName.c_str(), job->parentName.size());
+    if (pageCount > 0)
+        out.write((const char *) &index[0], sizeof(cgsPagedSnapshotEntry) * pageCount);
+    for(U32 p = 0; p < pageCount; p++)
+        out.write((const char *) &blobs[p][0], blobs[p].size());
+
+    out.close();
+}
+
+cgoPagedSnapshot::cgoPagedSnapshot(const string &name, U64 memorySize, U32 fillPattern, U32 pageSize) :
+    name(name), memorySize(memorySize), pageSize(pageSize), fillPattern(fillPattern),
+    chainDepth(0), lastSavedPages(0)
+{
+    CG_ASSERT_COND(((pageSize != 0) && ((pageSize & 0x07) == 0)), "Snapshot page size must be a multiple of 8 bytes.");
+
+    numPages = U32((memorySize + pageSize - 1) / pageSize);
+
+    fillPage.resize(pageSize);
+    for(U32 dw = 0; dw < (pageSize >> 2); dw++)
+        ((U32 *) &fillPage[0])[dw] = fillPattern;
+}
+
+string cgoPagedSnapshot::currentPath(const string &fileName)
+{
+    char directory[1024];
+
+    if (getCurrentDirectory(directory, 1024) != 0)
+        CG_ASSERT("Error obtaining current working directory.");
+
+    return string(directory) + "/" + fileName;
+}
+
+string cgoPagedSnapshot::getFileName() const
+{
+    return name + PAGED_SNAPSHOT_EXTENSION;
+}
+
+U32 cgoPagedSnapshot::getLastSavedPages() const
+{
+    return lastSavedPages;
+}
+
+void cgoPagedSnapshot::save(const PageReader &reader)
+{
+    savePages(reader, nullptr);
+}
+
+void cgoPagedSnapshot::save(const PageReader &reader, const PageFilter &unchanged)
+{
+    savePages(reader, unchanged);
+}
+
+void cgoPagedSnapshot::savePages(const PageReader &reader, const PageFilter &unchanged)
+{
+    //  Start a new base image when there is no parent, the chain is too long or the
+    //  pages written are not tracked.
+    bool baseImage = !unchanged || parentName.empty() || (chainDepth + 1 > PAGED_SNAPSHOT_MAX_CHAIN);
+
+    cgoSnapshotWriter::Job *job = new cgoSnapshotWriter::Job;
+
+    job->fileName = currentPath(getFileName());
+    job->parentName = baseImage ? string() : parentName;
+
+    vector<U08> page(pageSize, 0);
+
+    for(U32 p = 0; p < numPages; p++)
+    {
+        if (unchanged && unchanged(p, baseImage))
+            continue;
+
+        U64 offset = U64(p) * pageSize;
+        U32 bytes = U32(((memorySize - offset) < pageSize) ? (memorySize - offset) : pageSize);
+
+        reader(offset, &page[0], bytes);
+
+        //  Pages not stored in a base image are restored with the fill pattern.
+        if (baseImage && (memcmp(&page[0], &fillPage[0], bytes) == 0))
+            continue;
+
+        //  Copy the changed page to the job so the memory image can keep changing.
+        job->pages.push_back(p);
+        job->data.insert(job->data.end(), page.begin(), page.end());
+    }
+
+    memcpy(job->header.magic, PAGED_SNAPSHOT_MAGIC, sizeof(PAGED_SNAPSHOT_MAGIC));
+    job->header.version = PAGED_SNAPSHOT_VERSION;
+    job->header.pageSize = pageSize;
+    job->header.memorySize = memorySize;
+    job->header.pageCount = U32(job->pages.size());
+    job->header.chainDepth = baseImage ? 0 : (chainDepth + 1);
+    job->header.fillPattern = fillPattern;
+    job->header.parentLength = U32(job->parentName.size());
+
+    parentName = job->fileName;
+    chainDepth = job->header.chainDepth;
+    lastSavedPages = job->header.pageCount;
+
+    cgoSnapshotWriter::getInstance().enqueue(job);
+}
+
+void cgoPagedSnapshot::save(cgoSparseMemory &memory)
+{
+    CG_ASSERT_COND(((memory.getSize() == memorySize) && (memory.getPageSize() == pageSize)),
+                   "Sparse memory does not match the paged snapshot %s.", name.c_str());
+
+    //  Pages not allocated store the fill pattern.  A delta only stores the pages
+    //  written since the previous snapshot.
+    savePages([&memory](U64 offset, U08 *buffer, U32 bytes)
+    {
+        memcpy(buffer, memory.readPage(U32(offset / memory.getPageSize())), bytes);
+    },
+    [&memory](U32 p, bool baseImage)
+    {
+        return baseImage ? !memory.isTouched(p) : !memory.isDirty(p);
+    });
+
+    memory.clearDirty();
+}
+
+void cgoPagedSnapshot::save(cgoMappedMemory &memory)
+{
+    CG_ASSERT_COND((memory.getSize() == memorySize), "Mapped memory does not match the paged snapshot %s.", name.c_str());
+
+    const U08 *image = memory.getData();
+
+    //  A delta only reads the pages written since the previous snapshot.  The first save
+    //  (no write tracking yet) stores a base image.
+    PageFilter unchanged;
+
+    if (memory.tracksWrites())
+        unchanged = [this, &memory](U32 p, bool baseImage) { return !baseImage && !memory.isDirty(U64(p) * pageSize, pageSize); };
+
+    savePages([image](U64 offset, U08 *buffer, U32 bytes) { memcpy(buffer, image + offset, bytes); }, unchanged);
+
+    memory.clearDirty();
+}
+
+bool cgoPagedSnapshot::load(const PageWriter &writer)
+{
+    string fileName = currentPath(getFileName());
+    cgsPagedSnapshotHeader header;
+    string parent;
+
+    //  Snapshots from this run may still be in the writer queue.
+    cgoSnapshotWriter::getInstance().flush();
+
+    if (!readHeader(fileName, header, parent))
+        return false;
+
+    CG_ASSERT_COND(((header.memorySize == memorySize) && (header.pageSize == pageSize)),
+                   "Paged snapshot %s does not match the memory configuration.", fileName.c_str());
+
+    bool restored = restore(fileName, writer);
+
+    if (restored)
+    {
+        parentName = fileName;
+        chainDepth = header.chainDepth;
+    }
+
+    return restored;
+}
+
+bool cgoPagedSnapshot::load(cgoSparseMemory &memory)
+{
+    CG_ASSERT_COND(((memory.getSize() == memorySize) && (memory.getPageSize() == pageSize)),
+                   "Sparse memory does not match the paged snapshot %s.", name.c_str());
+
+    //  Pages restored to the fill pattern are not allocated.  The restored pages are stored
+    //  in the snapshot chain, clear the dirty bits set by the restore.
+    bool restored = load([&memory](U64 offset, const U08 *buffer, U32 bytes) { memory.write(offset, buffer, bytes); });
+
+    if (restored)
+        memory.clearDirty();
+
+    return restored;
+}
+
+bool cgoPagedSnapshot::load(cgoMappedMemory &memory)
+{
+    CG_ASSERT_COND((memory.getSize() == memorySize), "Mapped memory does not match the paged snapshot %s.", name.c_str());
+
+    //  The restored pages are stored in the snapshot chain, clear the dirty bits set by the restore.
+    bool restored = load([&memory](U64 offset, const U08 *buffer, U32 bytes) { memory.update(offset, buffer, bytes); });
+
+    if (restored)
+        memory.clearDirty();
+
+    return restored;
+}
+
+bool cgoPagedSnapshot::readHeader(const string &fileName, cgsPagedSnapshotHeader &header, string &parentName)
+{
+    ifstream in(fileName.c_str(), ios::binary);
+
+    if (!in.is_open())
+        return false;
+
+    in.read((char *) &header, sizeof(cgsPagedSnapshotHeader));
+
+    if (!in.good() || (memcmp(header.magic, PAGED_SNAPSHOT_MAGIC, sizeof(PAGED_SNAPSHOT_MAGIC)) != 0) ||
+        (header.version != PAGED_SNAPSHOT_VERSION))
+        return false;
+
+    parentName.resize(header.parentLength);
+    if (header.parentLength > 0)
+        in.read(&parentName[0], header.parentLength);
+
+    return in.good();
+}
+
+//  Finds the parent file of a snapshot.  Falls back to the sibling snapshot directory
+//  with the same name if the snapshot directories were moved since they were saved.
+static string resolveParent(const string &fileName, const string &parentName)
+{
+    ifstream test(parentName.c_str(), ios::binary);
+
+    if (test.is_open())
+        return parentName;
+
+    size_t parentFileSep = parentName.find_last_of("/\\");
+    size_t parentDirSep = (parentFileSep == string::npos) ? string::npos : parentName.find_last_of("/\\", parentFileSep - 1);
+    size_t fileSep = fileName.find_last_of("/\\");
+    size_t dirSep = (fileSep == string::npos) ? string::npos : fileName.find_last_of("/\\", fileSep - 1);
+
+    if ((parentDirSep == string::npos) || (dirSep == string::npos))
+        return parentName;
+
+    return fileName.substr(0, dirSep) + parentName.substr(parentDirSep);
+}
+
+bool cgoPagedSnapshot::restore(const string &fileName, const PageWriter &writer,
+                               const function<void(U32 page, U32 chainDepth)> &pageVisitor)
+{
+    cgsPagedSnapshotHeader header;
+    string parent;
+
+    if (!readHeader(fileName, header, parent))
+    {
+        cerr << "cgoPagedSnapshot => Error reading snapshot file " << fileName << endl;
+        return false;
+    }
+
+    const U32 pageSize = header.pageSize;
+    const U32 numPages = U32((header.memorySize + pageSize - 1) / pageSize);
+
+    if (header.chainDepth > 0)
+    {
+        //  Restore the parent chain first.
+        if (!restore(resolveParent(fileName, parent), writer, pageVisitor))
+            return false;
+    }
+    else
+    {
+        //  Base image.  Pages not stored in the file hold the fill pattern.
+        vector<U08> fillPage(pageSize);
+
+        for(U32 dw = 0; dw < (pageSize >> 2); dw++)
+            ((U32 *) &fillPage[0])[dw] = header.fillPattern;
+
+        for(U32 p = 0; p < numPages; p++)
+        {
+            U64 offset = U64(p) * pageSize;
+            writer(offset, &fillPage[0], U32(((header.memorySize - offset) < pageSize) ? (header.memorySize - offset) : pageSize));
+        }
+    }
+
+    ifstream in(fileName.c_str(), ios::binary);
+    in.seekg(sizeof(cgsPagedSnapshotHeader) + header.parentLength);
+
+    vector<cgsPagedSnapshotEntry> index(header.pageCount);
+    if (header.pageCount > 0)
+        in.read((char *) &index[0], sizeof(cgsPagedSnapshotEntry) * header.pageCount);
+
+    vector<U08> stored(compressBound(pageSize));
+    vector<U08> page(pageSize);
+
+    for(U32 e = 0; e < header.pageCount; e++)
+    {
+        if ((index[e].page >= numPages) || (index[e].storedBytes > stored.size()))
+        {
+            cerr << "cgoPagedSnapshot => Corrupted page index in snapshot file " << fileName << endl;
+            return false;
+        }
+
+        in.read((char *) &stored[0], index[e].storedBytes);
+
+        if (index[e].storedBytes == pageSize)
+            memcpy(&page[0], &stored[0], pageSize);
+        else
+        {
+            uLongf pageBytes = pageSize;
+            if ((uncompress(&page[0], &pageBytes, &stored[0], index[e].storedBytes) != Z_OK) || (pageBytes != pageSize))
+            {
+                cerr << "cgoPagedSnapshot => Error decompressing page " << index[e].page << " from snapshot file " << fileName << endl;
+                return false;
+            }
+        }
+
+        U64 offset = U64(index[e].page) * pageSize;
+        writer(offset, &page[0], U32(((header.memorySize - offset) < pageSize) ? (header.memorySize - offset) : pageSize));
+
+        if (pageVisitor)
+            pageVisitor(index[e].page, header.chainDepth);
+    }
+
+    if (!in.good())
+    {
+        cerr << "cgoPagedSnapshot => Truncated snapshot file " << fileName << endl;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace arch
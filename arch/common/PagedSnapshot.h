@@ -0,0 +1,241 @@
+/**************************************************************************
+ *
+ * Paged snapshot definition file.
+ *  This file defines the classes used to save and restore incremental,
+ *  compressed snapshots of the simulated GPU and system memories.
+ *
+ *  A memory image is split in fixed size pages.  Each snapshot only stores the
+ *  pages that changed since the previous snapshot of the same memory (a delta)
+ *  and references the previous snapshot file as its parent.  Restoring a delta
+ *  first restores the parent chain down to the base image.  Pages are deflated
+ *  and written to disk by a background thread from a private copy of the dirty
+ *  pages, so the simulation only stalls while the dirty pages are copied.
+ *
+ */
+
+#ifndef __PAGEDSNAPSHOT_H__
+#define __PAGEDSNAPSHOT_H__
+
+#include "GPUType.h"
+#include "SparseMemory.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace arch
+{
+
+//  Paged snapshot file definitions.
+static const char PAGED_SNAPSHOT_MAGIC[8] = {'C', 'G', 'P', 'S', 'N', 'A', 'P', '1'};
+static const U32 PAGED_SNAPSHOT_VERSION = 1;
+static const U32 PAGED_SNAPSHOT_PAGE_SIZE = 4096;       //  Default page size in bytes.
+static const U32 PAGED_SNAPSHOT_MAX_CHAIN = 16;         //  Deltas allowed before a new base image is forced.
+static const char PAGED_SNAPSHOT_EXTENSION[] = ".psnap";
+
+/**
+ *  Paged snapshot file header.
+ *  The header is followed by the parent file path (parentLength bytes, not null terminated),
+ *  the page index (pageCount cgsPagedSnapshotEntry records) and the page data blobs in index order.
+ */
+struct cgsPagedSnapshotHeader
+{
+    char magic[8];          //  PAGED_SNAPSHOT_MAGIC.
+    U32 version;            //  PAGED_SNAPSHOT_VERSION.
+    U32 pageSize;           //  Size of a page in bytes.
+    U64 memorySize;         //  Size of the whole memory image in bytes.
+    U32 pageCount;          //  Number of page records stored in the file.
+    U32 chainDepth;         //  Number of parent files (0 for a base image).
+    U32 fillPattern;        //  32-bit pattern of the pages not stored in the base image.
+    U32 parentLength;       //  Length of the parent file path.
+};
+
+/**
+ *  Paged snapshot page index entry.
+ */
+struct cgsPagedSnapshotEntry
+{
+    U32 page;               //  Page number inside the memory image.
+    U32 storedBytes;        //  Bytes stored for the page.  Equal to the page size if stored uncompressed.
+};
+
+/**
+ *  Background snapshot writer.
+ *  Owns a worker thread that compresses and writes the queued snapshot files.
+ */
+class cgoSnapshotWriter
+{
+public:
+
+    /**
+     *  Snapshot job.  Stores the private copy of the dirty pages to write.
+     */
+    struct Job
+    {
+        std::string fileName;               //  Absolute path of the snapshot file to create.
+        std::string parentName;             //  Absolute path of the parent snapshot file (empty for a base image).
+        cgsPagedSnapshotHeader header;      //  File header.
+        std::vector<U32> pages;             //  Page numbers stored in the job.
+        std::vector<U08> data;              //  Copy of the page contents, in page order.
+    };
+
+    /**
+     *  Returns the global snapshot writer.
+     */
+    static cgoSnapshotWriter &getInstance();
+
+    /**
+     *  Queues a snapshot job.  The writer takes ownership of the job.
+     */
+    void enqueue(Job *job);
+
+    /**
+     *  Blocks until all the queued snapshot jobs have been written.
+     */
+    void flush();
+
+    ~cgoSnapshotWriter();
+
+private:
+
+    std::thread worker;                 //  Compression and output thread.
+    std::mutex queueMutex;              //  Protects the job queue and the writer state.
+    std::condition_variable queueCond;  //  Signals new jobs and job completion.
+    std::deque<Job *> jobs;             //  Pending jobs.
+    bool busy;                          //  A job is being written.
+    bool stop;                          //  Stop the worker thread.
+
+    cgoSnapshotWriter();
+    cgoSnapshotWriter(const cgoSnapshotWriter &);
+    cgoSnapshotWriter &operator=(const cgoSnapshotWriter &);
+
+    void workerLoop();
+    static void writeJob(Job *job);
+};
+
+/**
+ *  Paged snapshot of a memory image.
+ *  Tracks the pages of a memory image modified since the previous snapshot and saves
+ *  and restores incremental snapshot files.
+ *
+ *  The changed pages are given by the dirty bits of the memory (cgoSparseMemory,
+ *  cgoMappedMemory, or a page filter), no copy of the memory contents is kept.  A memory
+ *  without write tracking stores a base image on every save.  Base images skip the pages
+ *  equal to the fill pattern.
+ */
+class cgoPagedSnapshot
+{
+public:
+
+    //  Reads bytes from the memory image at offset into buffer.
+    typedef std::function<void(U64 offset, U08 *buffer, U32 bytes)> PageReader;
+
+    //  Writes bytes from buffer into the memory image at offset.
+    typedef std::function<void(U64 offset, const U08 *buffer, U32 bytes)> PageWriter;
+
+    //  Returns if a page is known to be unchanged since it was last saved or restored.
+    typedef std::function<bool(U32 page, bool baseImage)> PageFilter;
+
+    /**
+     *  Creates a paged snapshot tracker for a memory image.
+     *  @param name Name of the snapshot files for the memory (i.e. "bm.gpumem").
+     *  @param memorySize Size of the memory image in bytes.
+     *  @param fillPattern 32-bit pattern the memory image is initialized with.
+     *  @param pageSize Size of a page in bytes (multiple of 8).
+     */
+    cgoPagedSnapshot(const std::string &name, U64 memorySize, U32 fillPattern, U32 pageSize = PAGED_SNAPSHOT_PAGE_SIZE);
+
+    /**
+     *  Saves a snapshot of a memory image without write tracking accessed through a page
+     *  reader.  Stores a base image.
+     */
+    void save(const PageReader &reader);
+
+    /**
+     *  Saves a snapshot of a memory image with write tracking accessed through a page reader.
+     *  Only the pages reported as changed by the page filter are read and stored.  The caller
+     *  clears its write tracking state after the save.
+     */
+    void save(const PageReader &reader, const PageFilter &unchanged);
+
+    /**
+     *  Saves a snapshot of a sparse memory.  Pages not allocated or not written since the
+     *  previous snapshot (dirty bit clear) are not read.  Clears the dirty bits of the memory.
+     *  The page size of the memory must match the snapshot page size.
+     */
+    void save(cgoSparseMemory &memory);
+
+    /**
+     *  Saves a snapshot of a mapped memory image.  Only the pages written since the previous
+     *  snapshot are read and stored.  Clears the dirty bits of the memory, which starts the
+     *  write tracking after the first save (a base image).
+     */
+    void save(cgoMappedMemory &memory);
+
+    /**
+     *  Loads the snapshot stored in the current working directory through a page writer.
+     *  @return If a paged snapshot file was found and loaded.
+     */
+    bool load(const PageWriter &writer);
+
+    /**
+     *  Loads the snapshot stored in the current working directory into a sparse memory.
+     *  @return If a paged snapshot file was found and loaded.
+     */
+    bool load(cgoSparseMemory &memory);
+
+    /**
+     *  Loads the snapshot stored in the current working directory into a mapped memory image.
+     *  Pages equal to the restored contents are not written.
+     *  @return If a paged snapshot file was found and loaded.
+     */
+    bool load(cgoMappedMemory &memory);
+
+    /**
+     *  Returns the name of the paged snapshot file for the memory.
+     */
+    std::string getFileName() const;
+
+    /**
+     *  Returns the number of pages stored by the last saved snapshot.
+     */
+    U32 getLastSavedPages() const;
+
+    /**
+     *  Reads a paged snapshot file header and parent path.
+     *  @return If the file exists and is a valid paged snapshot file.
+     */
+    static bool readHeader(const std::string &fileName, cgsPagedSnapshotHeader &header, std::string &parentName);
+
+    /**
+     *  Restores a paged snapshot file and its parent chain through a page writer.
+     *  Pages not stored in the chain are set to the fill pattern.
+     *  @param pageVisitor Optional callback called for every page restored from the file chain.
+     *  @return If the file chain was restored.
+     */
+    static bool restore(const std::string &fileName, const PageWriter &writer,
+                        const std::function<void(U32 page, U32 chainDepth)> &pageVisitor = nullptr);
+
+private:
+
+    std::string name;               //  Name of the memory snapshot files.
+    U64 memorySize;                 //  Size of the memory image.
+    U32 pageSize;                   //  Size of a page.
+    U32 numPages;                   //  Number of pages in the memory image.
+    U32 fillPattern;                //  Initialization pattern of the memory image.
+    std::vector<U08> fillPage;      //  Page initialized with the fill pattern.
+    std::string parentName;         //  Absolute path of the last saved or restored snapshot file.
+    U32 chainDepth;                 //  Chain depth of the last saved or restored snapshot file.
+    U32 lastSavedPages;             //  Pages stored by the last saved snapshot.
+
+    void savePages(const PageReader &reader, const PageFilter &unchanged);
+    static std::string currentPath(const std::string &fileName);
+};
+
+} // namespace arch
+
+#endif // __PAGEDSNAPSHOT_H__
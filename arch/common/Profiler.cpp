@@ -26,6 +26,9 @@
 namespace arch
 {
 
+mutex Tracer::registryLock;
+vector<Tracer *> Tracer::registry;
+
 Tracer::Tracer()
 {
     traceRegions.clear();
@@ -33,6 +36,11 @@ Tracer::Tracer()
     regionStackSize = 0;
     allTicks = 0;
     allTicksTotal = 0;
+    lastTickSample = 0;
+
+    //  Add the tracer to the tracers merged by the report.
+    lock_guard<mutex> lock(registryLock);
+    registry.push_back(this);
 
 #ifdef WIN32
 
@@ -50,6 +58,11 @@ Tracer::Tracer()
 
 Tracer::~Tracer()
 {
+    {
+        lock_guard<mutex> lock(registryLock);
+        registry.erase(std::find(registry.begin(), registry.end(), this));
+    }
+
     map<string, TraceRegion*>::iterator it;
     it = traceRegions.begin();
     while (it != traceRegions.end())
@@ -85,6 +98,8 @@ U64 Tracer::sampleTickCounter()
 
 void Tracer::enterRegion(char *regionName, char *className, char *functionName)
 {
+    lock_guard<mutex> lock(accessLock);
+
     //  Update the tick count for the current region.
     U64 ticks = sampleTickCounter() - lastTickSample;
 
@@ -143,6 +158,8 @@ void Tracer::enterRegion(char *regionName, char *className, char *functionName)
 
 void Tracer::exitRegion()
 {
+    lock_guard<mutex> lock(accessLock);
+
     //  Update the tick count for the region.
     U64 ticks = sampleTickCounter() - lastTickSample;
 
@@ -175,6 +192,8 @@ void Tracer::exitRegion()
 
 void Tracer::reset()
 {
+    lock_guard<mutex> lock(accessLock);
+
     map<string, TraceRegion*>::iterator it;
     it = traceRegions.begin();
     while (it != traceRegions.end())
@@ -203,17 +222,47 @@ void Tracer::generateReport(char *filename)
     maxLength[1] = 10;
     maxLength[2] = 15;
     
+    //  Merge the regions of the tracers of all the threads.
+    map<string, TraceRegion> mergedRegions;
+    U64 allTicks = 0;
+
+    {
+        lock_guard<mutex> registryGuard(registryLock);
+
+        for(U32 t = 0; t < registry.size(); t++)
+        {
+            lock_guard<mutex> tracerGuard(registry[t]->accessLock);
+
+            map<string, TraceRegion*>::iterator it;
+            it = registry[t]->traceRegions.begin();
+            while (it != registry[t]->traceRegions.end())
+            {
+                map<string, TraceRegion>::iterator merged = mergedRegions.find(it->first);
+                if (merged == mergedRegions.end())
+                    mergedRegions[it->first] = *it->second;
+                else
+                {
+                    merged->second.ticks += it->second->ticks;
+                    merged->second.visits += it->second->visits;
+                }
+                it++;
+            }
+
+            allTicks += registry[t]->allTicks;
+        }
+    }
+
     //  Order by the number of ticks spend in the region.
     multimap<U64, TraceRegion *> orderedRegions;
     
-    map<string, TraceRegion*>::iterator it;
-    it = traceRegions.begin();
-    while (it != traceRegions.end())
+    map<string, TraceRegion>::iterator it;
+    it = mergedRegions.begin();
+    while (it != mergedRegions.end())
     {
-        orderedRegions.insert(pair<U64, TraceRegion*>(it->second->ticks, it->second));
-        maxLength[0] = (maxLength[0] < it->second->regionName.size()) ? (U32) it->second->regionName.size() : maxLength[0];
-        maxLength[1] = (maxLength[1] < it->second->className.size()) ? (U32) it->second->className.size() : maxLength[1];
-        maxLength[2] = (maxLength[2] < it->second->functionName.size()) ? (U32) it->second->functionName.size() : maxLength[2];
+        orderedRegions.insert(pair<U64, TraceRegion*>(it->second.ticks, &it->second));
+        maxLength[0] = (maxLength[0] < it->second.regionName.size()) ? (U32) it->second.regionName.size() : maxLength[0];
+        maxLength[1] = (maxLength[1] < it->second.className.size()) ? (U32) it->second.className.size() : maxLength[1];
+        maxLength[2] = (maxLength[2] < it->second.functionName.size()) ? (U32) it->second.functionName.size() : maxLength[2];
         it++;
     }
     
@@ -285,14 +334,15 @@ void Tracer::generateReport(char *filename)
 namespace arch
 {
 
-static Tracer *globalTracer = NULL;
-
 Tracer& getTracer()
 {
-    if (globalTracer == NULL)
-        globalTracer = new Tracer();
+    //  The tracers are not deleted when the threads finish so the report includes their regions.
+    static thread_local Tracer *threadTracer = NULL;
+
+    if (threadTracer == NULL)
+        threadTracer = new Tracer();
     
-    return *globalTracer;
+    return *threadTracer;
 }
 
 }   // namespace arch
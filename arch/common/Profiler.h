@@ -5,6 +5,7 @@
  */
 
 #include "GPUType.h"
+#include "Timeline.h"
 
 #include <map>
 #include <vector>
@@ -15,6 +16,7 @@
 #include <fstream>
 #include <filesystem>
 #include <cassert>
+#include <mutex>
 
 #ifndef _PROFILER_
 #define _PROFILER_
@@ -27,6 +29,10 @@ using namespace std;
 namespace arch
 {
 
+/**
+ *  Records the ticks spent in the code regions of a thread.  Each thread uses its own tracer
+ *  (see getTracer()) and the report merges the regions of the tracers of all the threads.
+ */
 class Tracer
 {
 
@@ -54,6 +60,10 @@ private:
     U32 lastProcessor;
     bool differentProcessors;
     U32 processorChanges;
+    mutex accessLock;                   //  Serializes the updates of the thread with the report.
+
+    static mutex registryLock;          //  Protects the list of tracers.
+    static vector<Tracer *> registry;   //  Tracers of all the threads.
     
 public:
     Tracer();
@@ -335,18 +345,19 @@ private:
 #undef TRACING_EXIT_REGION
 #undef TRACING_GENERATE_REPORT
 
+//  The regions are also recorded in the timeline if ENABLE_TIMELINE is defined (see Timeline.h).
 //#define ENABLE_TRACING
 #ifdef ENABLE_TRACING
-    #define TRACING_ENTER_REGION(a, b, c) arch::getTracer().enterRegion((a), (b), (c));
-    #define TRACING_EXIT_REGION()         arch::getTracer().exitRegion();
+    #define TRACING_ENTER_REGION(a, b, c) arch::getTracer().enterRegion((a), (b), (c)); TIMELINE_BEGIN(a)
+    #define TRACING_EXIT_REGION()         arch::getTracer().exitRegion(); TIMELINE_END()
     #define TRACING_GENERATE_REPORT(a)    arch::getTracer().generateReport((a));
 #else
-    #define TRACING_ENTER_REGION(a, b, c)
-    #define TRACING_EXIT_REGION()
+    #define TRACING_ENTER_REGION(a, b, c) TIMELINE_BEGIN(a)
+    #define TRACING_EXIT_REGION()         TIMELINE_END()
     #define TRACING_GENERATE_REPORT(a)
 #endif
 
-//  Get the global profiler instance
+//  Get the profiler instance of the calling thread
 Tracer& getTracer();
 
 }   // namespace arch
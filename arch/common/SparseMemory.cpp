@@ -0,0 +1,463 @@
+/**************************************************************************
+ *
+ * Sparse memory implementation file.
+ *  This file implements the classes used to store the simulated GPU and system
+ *  memories without allocating and initializing the whole memory image at
+ *  startup.
+ *
+ */
+
+#include "SparseMemory.h"
+#include "support.h"
+
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <cstdio>
+
+#ifndef WIN32
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <mutex>
+#endif
+
+using namespace std;
+
+namespace arch
+{
+
+cgoSparseMemory::cgoSparseMemory(U64 size, U32 fillPattern, U32 pageSize) :
+    size(size), pageSize(pageSize), fillPattern(fillPattern), touchedPages(0), dirtyPages(0)
+{
+    CG_ASSERT_COND(((pageSize != 0) && ((pageSize & 0x03) == 0)), "Sparse memory page size must be a multiple of 4 bytes.");
+
+    numPages = U32((size + pageSize - 1) / pageSize);
+    pages.resize(numPages, NULL);
+    dirty.resize(numPages, false);
+
+    fillPage = new U08[pageSize];
+    for(U32 dw = 0; dw < (pageSize >> 2); dw++)
+        ((U32 *) fillPage)[dw] = fillPattern;
+}
+
+cgoSparseMemory::~cgoSparseMemory()
+{
+    for(U32 p = 0; p < numPages; p++)
+        delete[] pages[p];
+
+    delete[] fillPage;
+}
+
+void cgoSparseMemory::allocatePage(U32 page)
+{
+    pages[page] = new U08[pageSize];
+    memcpy(pages[page], fillPage, pageSize);
+    touchedPages++;
+}
+
+void cgoSparseMemory::read(U64 address, U08 *data, U32 bytes) const
+{
+    CG_ASSERT_COND(((address + bytes) <= size), "Sparse memory read out of range.");
+
+    while (bytes > 0)
+    {
+        U32 page = U32(address / pageSize);
+        U32 offset = U32(address - U64(page) * pageSize);
+        U32 chunk = min(bytes, pageSize - offset);
+
+        memcpy(data, readPage(page) + offset, chunk);
+
+        address += chunk;
+        data += chunk;
+        bytes -= chunk;
+    }
+}
+
+void cgoSparseMemory::write(U64 address, const U08 *data, U32 bytes)
+{
+    CG_ASSERT_COND(((address + bytes) <= size), "Sparse memory write out of range.");
+
+    while (bytes > 0)
+    {
+        U32 page = U32(address / pageSize);
+        U32 offset = U32(address - U64(page) * pageSize);
+        U32 chunk = min(bytes, pageSize - offset);
+
+        //  Writing the fill pattern to a page not allocated doesn't change its content.
+        if ((pages[page] != NULL) || (memcmp(data, fillPage + offset, chunk) != 0))
+            memcpy(writePage(page) + offset, data, chunk);
+
+        address += chunk;
+        data += chunk;
+        bytes -= chunk;
+    }
+}
+
+void cgoSparseMemory::writeMasked(U64 address, const U08 *data, const U32 *mask, U32 bytes)
+{
+    CG_ASSERT_COND(((address + bytes) <= size), "Sparse memory write out of range.");
+    CG_ASSERT_COND((((address & 0x03) == 0) && ((bytes & 0x03) == 0)), "Masked writes must be 4 byte aligned.");
+
+    while (bytes > 0)
+    {
+        U32 page = U32(address / pageSize);
+        U32 offset = U32(address - U64(page) * pageSize);
+        U32 chunk = min(bytes, pageSize - offset);
+        U08 *target = writePage(page) + offset;
+
+        //  Write only the bytes enabled by the mask.
+        for(U32 i = 0; i < chunk; i += 4)
+        {
+            U32 source;
+            U32 dest;
+
+            memcpy(&source, &target[i], 4);
+            memcpy(&dest, &data[i], 4);
+            source = (source & ~mask[i >> 2]) | (dest & mask[i >> 2]);
+            memcpy(&target[i], &source, 4);
+        }
+
+        address += chunk;
+        data += chunk;
+        mask += (chunk >> 2);
+        bytes -= chunk;
+    }
+}
+
+void cgoSparseMemory::loadImage(istream &in)
+{
+    vector<U08> page(pageSize);
+
+    for(U64 address = 0; address < size; address += pageSize)
+    {
+        U32 bytes = U32(min(U64(pageSize), size - address));
+
+        in.read((char *) &page[0], bytes);
+        write(address, &page[0], bytes);
+    }
+}
+
+void cgoSparseMemory::clearDirty()
+{
+    if (dirtyPages == 0)
+        return;
+
+    fill(dirty.begin(), dirty.end(), false);
+    dirtyPages = 0;
+}
+
+void cgoSparseMemory::printFootprint(const char *name) const
+{
+    printf(" %s : %llu KB written (%u of %u pages), %u pages dirty.\n", name,
+           (unsigned long long) (getTouchedBytes() >> 10), touchedPages, numPages, dirtyPages);
+}
+
+std::atomic<cgoMappedMemory *> cgoMappedMemory::trackedMemories[MAPPED_MEMORY_MAX_TRACKED];
+
+#ifndef WIN32
+//  SIGSEGV action replaced by the write fault handler.
+static struct sigaction previousFaultAction;
+#endif
+
+cgoMappedMemory::cgoMappedMemory(U64 size, U32 fillPattern) :
+    data(NULL), size(size), pageSize(SPARSE_MEMORY_PAGE_SIZE), mapped(false), tracking(false)
+{
+    CG_ASSERT_COND(((size & 0x03) == 0), "Memory size must be a multiple of 4 bytes.");
+
+    if (!createMapping(fillPattern))
+    {
+        //  Allocate and initialize the whole memory image.
+        data = new U08[size];
+
+        for(U64 dw = 0; dw < (size >> 2); dw++)
+            ((U32 *) data)[dw] = fillPattern;
+    }
+}
+
+cgoMappedMemory::~cgoMappedMemory()
+{
+    for(U32 m = 0; tracking && (m < MAPPED_MEMORY_MAX_TRACKED); m++)
+    {
+        cgoMappedMemory *expected = this;
+        trackedMemories[m].compare_exchange_strong(expected, NULL);
+    }
+
+#ifndef WIN32
+    if (mapped)
+    {
+        munmap(data, size);
+        return;
+    }
+#endif
+
+    delete[] data;
+}
+
+bool cgoMappedMemory::createMapping(U32 fillPattern)
+{
+#ifndef WIN32
+    pageSize = U32(sysconf(_SC_PAGESIZE));
+
+    //  Reserve the address range with an anonymous demand-zero mapping.
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (base == MAP_FAILED)
+        return false;
+
+    if (fillPattern != 0)
+    {
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+        //  Create a chunk initialized with the fill pattern and map private copies of the
+        //  chunk over the whole address range.  Pages are copied on the first write.
+        U64 chunkSize = min(U64(MAPPED_MEMORY_CHUNK_SIZE), ((size + pageSize - 1) / pageSize) * pageSize);
+        int fd = memfd_create("cgmemory", MFD_CLOEXEC);
+        bool ok = (fd >= 0) && (ftruncate(fd, off_t(chunkSize)) == 0);
+
+        if (ok)
+        {
+            void *chunk = mmap(NULL, chunkSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ok = (chunk != MAP_FAILED);
+
+            if (ok)
+            {
+                for(U64 dw = 0; dw < (chunkSize >> 2); dw++)
+                    ((U32 *) chunk)[dw] = fillPattern;
+                munmap(chunk, chunkSize);
+            }
+        }
+
+        for(U64 offset = 0; ok && (offset < size); offset += chunkSize)
+        {
+            U64 bytes = min(chunkSize, size - offset);
+            ok = (mmap((U08 *) base + offset, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED);
+        }
+
+        if (fd >= 0)
+            close(fd);
+
+        if (!ok)
+        {
+            munmap(base, size);
+            return false;
+        }
+#else
+        munmap(base, size);
+        return false;
+#endif
+    }
+
+    data = (U08 *) base;
+    mapped = true;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void cgoMappedMemory::update(U64 address, const U08 *source, U32 bytes)
+{
+    CG_ASSERT_COND(((address + bytes) <= size), "Memory update out of range.");
+
+    while (bytes > 0)
+    {
+        U32 chunk = U32(min(U64(bytes), pageSize - (address % pageSize)));
+
+        if (memcmp(&data[address], source, chunk) != 0)
+            memcpy(&data[address], source, chunk);
+
+        address += chunk;
+        source += chunk;
+        bytes -= chunk;
+    }
+}
+
+void cgoMappedMemory::clearDirty()
+{
+    if (!tracking && !startTracking())
+        return;
+
+#ifndef WIN32
+    //  Protect before clearing, a page written in between stays dirty.
+    mprotect(data, size, PROT_READ);
+#endif
+
+    fill(dirty.begin(), dirty.end(), U08(0));
+}
+
+void cgoMappedMemory::setDirty()
+{
+    if (!tracking)
+        return;
+
+#ifndef WIN32
+    mprotect(data, size, PROT_READ | PROT_WRITE);
+#endif
+
+    fill(dirty.begin(), dirty.end(), U08(1));
+}
+
+bool cgoMappedMemory::isDirty(U64 address, U32 bytes) const
+{
+    if (!tracking)
+        return true;
+
+    U64 last = min(address + bytes, size);
+
+    for(U64 page = address / pageSize; (page * pageSize) < last; page++)
+    {
+        if (dirty[page] != 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool cgoMappedMemory::startTracking()
+{
+#ifndef WIN32
+    //  Write protection works on the pages of a mapping.
+    if (!mapped)
+        return false;
+
+    installFaultHandler();
+
+    dirty.assign(getNumPages(), U08(1));
+
+    for(U32 m = 0; m < MAPPED_MEMORY_MAX_TRACKED; m++)
+    {
+        cgoMappedMemory *expected = NULL;
+
+        if (trackedMemories[m].compare_exchange_strong(expected, this))
+        {
+            tracking = true;
+            return true;
+        }
+    }
+#endif
+
+    return false;
+}
+
+bool cgoMappedMemory::markWritten(U08 *address)
+{
+    if ((address < data) || (address >= (data + size)))
+        return false;
+
+#ifndef WIN32
+    U64 page = U64(address - data) / pageSize;
+
+    dirty[page] = 1;
+    mprotect(data + page * pageSize, size_t(min(U64(pageSize), size - page * pageSize)), PROT_READ | PROT_WRITE);
+#endif
+
+    return true;
+}
+
+bool cgoMappedMemory::handleWriteFault(U08 *address)
+{
+    for(U32 m = 0; m < MAPPED_MEMORY_MAX_TRACKED; m++)
+    {
+        cgoMappedMemory *memory = trackedMemories[m].load(memory_order_acquire);
+
+        if ((memory != NULL) && memory->markWritten(address))
+            return true;
+    }
+
+    return false;
+}
+
+void cgoMappedMemory::installFaultHandler()
+{
+#ifndef WIN32
+    static once_flag installed;
+
+    call_once(installed, []()
+    {
+        struct sigaction action;
+
+        memset(&action, 0, sizeof(action));
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_SIGINFO;
+        action.sa_sigaction = [](int signal, siginfo_t *info, void *context)
+        {
+            //  The faulting write is executed again once the page is writable.
+            if (handleWriteFault((U08 *) info->si_addr))
+                return;
+
+            if (previousFaultAction.sa_flags & SA_SIGINFO)
+                previousFaultAction.sa_sigaction(signal, info, context);
+            else if ((previousFaultAction.sa_handler != SIG_DFL) && (previousFaultAction.sa_handler != SIG_IGN))
+                previousFaultAction.sa_handler(signal);
+            else
+            {
+                //  Restore the default action, the fault is raised again on return.
+                sigaction(signal, &previousFaultAction, NULL);
+            }
+        };
+
+        sigaction(SIGSEGV, &action, &previousFaultAction);
+    });
+#endif
+}
+
+U64 cgoMappedMemory::getTouchedPages() const
+{
+#ifdef __linux__
+    if (mapped)
+    {
+        //  Pages written are private anonymous pages mapped only by this process.  Pages only
+        //  read map the shared fill pattern chunk or the zero page.
+        int fd = open("/proc/self/pagemap", O_RDONLY);
+
+        if (fd >= 0)
+        {
+            static const U32 ENTRIES = 4096;
+            U64 entries[ENTRIES];
+            U64 firstPage = U64((size_t) data) / pageSize;
+            U64 numPages = getNumPages();
+            U64 touched = 0;
+            bool ok = true;
+
+            for(U64 p = 0; ok && (p < numPages); p += ENTRIES)
+            {
+                U32 count = U32(min(U64(ENTRIES), numPages - p));
+                ssize_t bytes = count * sizeof(U64);
+
+                ok = (pread(fd, entries, bytes, off_t((firstPage + p) * sizeof(U64))) == bytes);
+
+                for(U32 e = 0; ok && (e < count); e++)
+                {
+                    bool present = ((entries[e] >> 63) & 1) != 0;
+                    bool swapped = ((entries[e] >> 62) & 1) != 0;
+                    bool file = ((entries[e] >> 61) & 1) != 0;
+                    bool exclusive = ((entries[e] >> 56) & 1) != 0;
+
+                    if (swapped || (present && exclusive && !file))
+                        touched++;
+                }
+            }
+
+            close(fd);
+
+            if (ok)
+                return touched;
+        }
+    }
+#endif
+
+    return getNumPages();
+}
+
+void cgoMappedMemory::printFootprint(const char *name) const
+{
+    U64 touched = getTouchedPages();
+
+    printf(" %s : %llu KB written (%llu of %llu pages)%s.\n", name,
+           (unsigned long long) ((touched * pageSize) >> 10), (unsigned long long) touched,
+           (unsigned long long) getNumPages(), mapped ? "" : ", allocated at startup");
+}
+
+} // namespace arch
@@ -0,0 +1,253 @@
+/**************************************************************************
+ *
+ * Sparse memory definition file.
+ *  This file defines the classes used to store the simulated GPU and system
+ *  memories without allocating and initializing the whole memory image at
+ *  startup.
+ *
+ *  cgoSparseMemory is an explicit page table:  pages are allocated and set to the
+ *  fill pattern on the first write, reads from pages never written return the fill
+ *  pattern.  It tracks the pages written (touched) and the pages modified since the
+ *  dirty bits were last cleared.
+ *
+ *  cgoMappedMemory provides a linear memory image for the code that accesses the
+ *  memory through a raw pointer.  The image is a private mapping that only gets
+ *  physical pages on the first write.  The pages written through the pointer are
+ *  tracked by write protecting the image (see cgoMappedMemory::clearDirty).
+ *
+ */
+
+#ifndef __SPARSEMEMORY_H__
+#define __SPARSEMEMORY_H__
+
+#include "GPUType.h"
+
+#include <vector>
+#include <iosfwd>
+#include <atomic>
+
+namespace arch
+{
+
+static const U32 SPARSE_MEMORY_PAGE_SIZE = 4096;                //  Default page size in bytes.
+static const U32 MAPPED_MEMORY_CHUNK_SIZE = 2 * 1024 * 1024;    //  Size of the fill pattern mapping in bytes.
+static const U32 MAPPED_MEMORY_MAX_TRACKED = 16;                //  Memory images with write tracking at the same time.
+
+/**
+ *  Page table based sparse memory.
+ */
+class cgoSparseMemory
+{
+public:
+
+    /**
+     *  Creates a sparse memory.  No page is allocated.
+     *  @param size Size of the memory in bytes.
+     *  @param fillPattern 32-bit pattern the pages are initialized with.
+     *  @param pageSize Size of a page in bytes (multiple of 4).
+     */
+    cgoSparseMemory(U64 size, U32 fillPattern, U32 pageSize = SPARSE_MEMORY_PAGE_SIZE);
+
+    ~cgoSparseMemory();
+
+    /**
+     *  Reads bytes from the memory.  Does not allocate pages.
+     */
+    void read(U64 address, U08 *data, U32 bytes) const;
+
+    /**
+     *  Writes bytes to the memory.  Writes of the fill pattern to pages not yet
+     *  allocated are ignored.
+     */
+    void write(U64 address, const U08 *data, U32 bytes);
+
+    /**
+     *  Writes the bytes enabled by a write mask (one 32-bit mask per 4 bytes) to the memory.
+     *  @param address Memory address (4 byte aligned).
+     */
+    void writeMasked(U64 address, const U08 *data, const U32 *mask, U32 bytes);
+
+    /**
+     *  Loads a full memory image from a stream.
+     */
+    void loadImage(std::istream &in);
+
+    /**
+     *  Returns a pointer to the data of a page for reading.  Pages not allocated
+     *  return a shared page with the fill pattern.
+     */
+    const U08 *readPage(U32 page) const
+    {
+        return (pages[page] != NULL) ? pages[page] : fillPage;
+    }
+
+    /**
+     *  Returns a pointer to the data of a page for writing.  Allocates the page
+     *  and marks it as dirty.
+     */
+    U08 *writePage(U32 page)
+    {
+        if (pages[page] == NULL)
+            allocatePage(page);
+
+        if (!dirty[page])
+        {
+            dirty[page] = true;
+            dirtyPages++;
+        }
+
+        return pages[page];
+    }
+
+    /**
+     *  Returns if a page has been allocated (written with data different from the fill pattern).
+     */
+    bool isTouched(U32 page) const { return pages[page] != NULL; }
+
+    /**
+     *  Returns if a page has been written since the dirty bits were last cleared.
+     */
+    bool isDirty(U32 page) const { return dirty[page]; }
+
+    /**
+     *  Clears the dirty bit of all the pages.
+     */
+    void clearDirty();
+
+    /**
+     *  Prints the pages written and dirty to the standard output.
+     */
+    void printFootprint(const char *name) const;
+
+    U32 getTouchedPages() const { return touchedPages; }
+    U32 getDirtyPages() const { return dirtyPages; }
+    U64 getTouchedBytes() const { return U64(touchedPages) * pageSize; }
+    U64 getSize() const { return size; }
+    U32 getPageSize() const { return pageSize; }
+    U32 getNumPages() const { return numPages; }
+    U32 getFillPattern() const { return fillPattern; }
+
+private:
+
+    U64 size;                   //  Size of the memory.
+    U32 pageSize;               //  Size of a page.
+    U32 numPages;               //  Number of pages.
+    U32 fillPattern;            //  Initialization pattern of the pages.
+    std::vector<U08 *> pages;   //  Page table.  NULL for the pages not allocated.
+    std::vector<bool> dirty;    //  Dirty bit of every page.
+    U08 *fillPage;              //  Page initialized with the fill pattern.
+    U32 touchedPages;           //  Number of pages allocated.
+    U32 dirtyPages;             //  Number of dirty pages.
+
+    void allocatePage(U32 page);
+
+    cgoSparseMemory(const cgoSparseMemory &);
+    cgoSparseMemory &operator=(const cgoSparseMemory &);
+};
+
+/**
+ *  Linear memory image with physical pages allocated on the first write.
+ *
+ *  The image is a private mapping of a chunk initialized with the fill pattern (or an
+ *  anonymous demand-zero mapping if the fill pattern is 0), so reads from pages never
+ *  written share the same physical pages.  Falls back to an allocated and initialized
+ *  array if the mapping can not be created.
+ *
+ *  clearDirty() write protects the mapping.  The first write to a page after that faults,
+ *  the SIGSEGV handler sets the dirty bit of the page and removes the protection of the
+ *  page, so each page costs one fault per clearDirty() call.  Faults outside the tracked
+ *  images are passed to the handler installed before the first clearDirty() call.  Writes
+ *  from the kernel (read() into the image) fail on protected pages, see setDirty().
+ */
+class cgoMappedMemory
+{
+public:
+
+    /**
+     *  Creates a memory image.
+     *  @param size Size of the memory in bytes.
+     *  @param fillPattern 32-bit pattern the memory is initialized with.
+     */
+    cgoMappedMemory(U64 size, U32 fillPattern);
+
+    ~cgoMappedMemory();
+
+    /**
+     *  Returns a pointer to the memory image.
+     */
+    U08 *getData() const { return data; }
+
+    /**
+     *  Writes bytes to the memory image.  Bytes equal to the current content are not
+     *  written so restoring a memory image does not allocate unchanged pages.
+     */
+    void update(U64 address, const U08 *source, U32 bytes);
+
+    /**
+     *  Returns if the physical pages are allocated on demand.
+     */
+    bool isSparse() const { return mapped; }
+
+    /**
+     *  Returns the number of pages written (privately allocated).  Returns all the pages
+     *  if the number of pages written can not be obtained.
+     */
+    U64 getTouchedPages() const;
+
+    /**
+     *  Prints the pages written to the standard output.
+     */
+    void printFootprint(const char *name) const;
+
+    /**
+     *  Clears the dirty bit of all the pages and starts tracking the pages written.  Must
+     *  not be called while the memory is written from other threads.
+     */
+    void clearDirty();
+
+    /**
+     *  Sets the dirty bit of all the pages and removes the write protection.  Called before
+     *  the memory image is written by the kernel.
+     */
+    void setDirty();
+
+    /**
+     *  Returns if the pages written since the last clearDirty() call are tracked.  Only
+     *  supported for mapped images.
+     */
+    bool tracksWrites() const { return tracking; }
+
+    /**
+     *  Returns if any page in a range was written since the last clearDirty() call.  Always
+     *  true if the pages written are not tracked.
+     */
+    bool isDirty(U64 address, U32 bytes) const;
+
+    U64 getSize() const { return size; }
+    U32 getPageSize() const { return pageSize; }
+    U64 getNumPages() const { return (size + pageSize - 1) / pageSize; }
+
+private:
+
+    U08 *data;          //  Memory image.
+    U64 size;           //  Size of the memory image.
+    U32 pageSize;       //  Size of a physical page.
+    bool mapped;        //  The memory image is a mapping (false if allocated with new).
+    bool tracking;      //  The image is registered for write tracking.
+    std::vector<U08> dirty;     //  Dirty byte of every page, set by the write fault handler.
+
+    static std::atomic<cgoMappedMemory *> trackedMemories[MAPPED_MEMORY_MAX_TRACKED];
+
+    bool createMapping(U32 fillPattern);
+    bool startTracking();
+    bool markWritten(U08 *address);
+    static bool handleWriteFault(U08 *address);
+    static void installFaultHandler();
+
+    cgoMappedMemory(const cgoMappedMemory &);
+    cgoMappedMemory &operator=(const cgoMappedMemory &);
+};
+
+} // namespace arch
+
+#endif // __SPARSEMEMORY_H__
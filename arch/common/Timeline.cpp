@@ -0,0 +1,274 @@
+/**************************************************************************
+ *
+ * Timeline recorder implementation file.
+ *  This file implements the TimelineRecorder class that records the tracing
+ *  regions and simulation events of each thread and writes them as a Chrome trace
+ *  event file.
+ *
+ */
+
+#include "Timeline.h"
+#include "support.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace arch
+{
+
+//  Recorded event.
+struct TimelineEvent
+{
+    U64 time;               //  Nanoseconds since the recording started.
+    U64 index;              //  Batch or frame number (instant events).
+    U64 cycle;              //  Simulation cycle (instant events).
+    const char *name;       //  Interned name (NULL for EVENT_END).
+    U32 type;               //  Event type (TimelineRecorder::EventType).
+};
+
+//  Chunk of the event buffer of a thread.
+struct TimelineChunk
+{
+    TimelineEvent events[TimelineRecorder::CHUNK_EVENTS];
+    atomic<U32> count;                      //  Events written (published after the event).
+    atomic<TimelineChunk *> next;           //  Next chunk (published when allocated).
+
+    TimelineChunk() : count(0), next(NULL) {}
+};
+
+//  Name cache entry.  Maps the address of a name to the interned copy.
+struct TimelineName
+{
+    const char *key;
+    const char *interned;
+};
+
+static const U32 NAME_CACHE_SIZE = 256;
+
+//  Event buffer of a thread.  Only written by the owner thread.
+struct ThreadTimeline
+{
+    U32 id;                                 //  Thread number in the timeline.
+    string name;                            //  Thread name (guarded by the registry mutex).
+    TimelineChunk *first;
+    TimelineChunk *current;
+    atomic<U64> events;                     //  Events recorded (only incremented by the owner thread).
+    atomic<U64> dropped;                    //  Events dropped after the maximum was reached.
+    U32 droppedDepth;                       //  Regions open when their begin event was dropped.
+    TimelineName names[NAME_CACHE_SIZE];
+
+    ThreadTimeline(U32 id) : id(id), first(new TimelineChunk), events(0), dropped(0), droppedDepth(0)
+    {
+        current = first;
+        memset(names, 0, sizeof(names));
+    }
+};
+
+atomic<bool> TimelineRecorder::enabled(false);
+
+static mutex registryMutex;
+static vector<ThreadTimeline *> threads;
+static unordered_map<string, const char *> internedNames;
+static deque<string> nameStorage;
+static string outputFile;
+static U64 maxThreadEvents = TimelineRecorder::DEFAULT_MAX_EVENTS;
+static chrono::steady_clock::time_point startTime;
+
+static thread_local ThreadTimeline *threadTimeline = NULL;
+
+static ThreadTimeline *getThreadTimeline()
+{
+    if (threadTimeline == NULL)
+    {
+        lock_guard<mutex> lock(registryMutex);
+        threadTimeline = new ThreadTimeline(U32(threads.size()));
+        threads.push_back(threadTimeline);
+    }
+
+    return threadTimeline;
+}
+
+static const char *internName(ThreadTimeline *thread, const char *name)
+{
+    TimelineName &entry = thread->names[(size_t(name) >> 3) & (NAME_CACHE_SIZE - 1)];
+
+    //  The same address may be reused for a different name (names built in a local string).
+    if ((entry.key == name) && (strcmp(entry.interned, name) == 0))
+        return entry.interned;
+
+    lock_guard<mutex> lock(registryMutex);
+
+    string key(name);
+    unordered_map<string, const char *>::iterator it = internedNames.find(key);
+
+    if (it == internedNames.end())
+    {
+        nameStorage.push_back(key);
+        it = internedNames.insert(make_pair(key, nameStorage.back().c_str())).first;
+    }
+
+    entry.key = name;
+    entry.interned = it->second;
+
+    return entry.interned;
+}
+
+void TimelineRecorder::start(const char *fileName, U64 maxEvents)
+{
+    outputFile = fileName;
+    maxThreadEvents = maxEvents;
+    startTime = chrono::steady_clock::now();
+    enabled.store(true);
+}
+
+void TimelineRecorder::setThreadName(const char *name)
+{
+    ThreadTimeline *thread = getThreadTimeline();
+
+    lock_guard<mutex> lock(registryMutex);
+    thread->name = name;
+}
+
+void TimelineRecorder::record(EventType type, const char *name, U64 index, U64 cycle)
+{
+    ThreadTimeline *thread = getThreadTimeline();
+
+    //  Keep the regions balanced when events are dropped.
+    U64 events = thread->events.load(memory_order_relaxed);
+
+    if (events >= maxThreadEvents)
+    {
+        if ((type != EVENT_END) || (thread->droppedDepth > 0))
+        {
+            thread->droppedDepth += (type == EVENT_BEGIN) ? 1 : 0;
+            thread->droppedDepth -= (type == EVENT_END) ? 1 : 0;
+            thread->dropped.store(thread->dropped.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    TimelineChunk *chunk = thread->current;
+    U32 n = chunk->count.load(memory_order_relaxed);
+
+    if (n == CHUNK_EVENTS)
+    {
+        TimelineChunk *next = new TimelineChunk;
+        chunk->next.store(next, memory_order_release);
+        thread->current = chunk = next;
+        n = 0;
+    }
+
+    TimelineEvent &event = chunk->events[n];
+    event.time = U64(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count());
+    event.index = index;
+    event.cycle = cycle;
+    event.name = (name != NULL) ? internName(thread, name) : NULL;
+    event.type = type;
+
+    chunk->count.store(n + 1, memory_order_release);
+    thread->events.store(events + 1, memory_order_relaxed);
+}
+
+//  Writes a string as a JSON string.
+static void writeString(FILE *f, const char *s)
+{
+    fputc('"', f);
+
+    for(; *s != 0; s++)
+    {
+        if ((*s == '"') || (*s == '\\'))
+            fprintf(f, "\\%c", *s);
+        else if ((unsigned char) *s < 0x20)
+            fprintf(f, "\\u%04x", (unsigned char) *s);
+        else
+            fputc(*s, f);
+    }
+
+    fputc('"', f);
+}
+
+void TimelineRecorder::write()
+{
+    if (!enabled.exchange(false))
+        return;
+
+    //  Threads that saw the recorder enabled may still be recording an event, only the
+    //  published events are written.
+    lock_guard<mutex> lock(registryMutex);
+
+    FILE *f = fopen(outputFile.c_str(), "w");
+
+    if (f == NULL)
+    {
+        CG_WARN("Error creating timeline file %s.", outputFile.c_str());
+        return;
+    }
+
+    U64 events = 0;
+    U64 dropped = 0;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"computrender\"}}");
+
+    for(size_t t = 0; t < threads.size(); t++)
+    {
+        ThreadTimeline *thread = threads[t];
+
+        fprintf(f, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", thread->id);
+        if (thread->name.empty())
+            fprintf(f, "\"thread %u\"", thread->id);
+        else
+            writeString(f, thread->name.c_str());
+        fprintf(f, "}}");
+
+        for(TimelineChunk *chunk = thread->first; chunk != NULL; chunk = chunk->next.load(memory_order_acquire))
+        {
+            U32 count = chunk->count.load(memory_order_acquire);
+
+            for(U32 e = 0; e < count; e++)
+            {
+                const TimelineEvent &event = chunk->events[e];
+                F64 ts = F64(event.time) / 1000.0;
+
+                switch(event.type)
+                {
+                    case EVENT_BEGIN:
+                        fprintf(f, ",\n{\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"name\":", thread->id, ts);
+                        writeString(f, event.name);
+                        fprintf(f, "}");
+                        break;
+
+                    case EVENT_END:
+                        fprintf(f, ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", thread->id, ts);
+                        break;
+
+                    case EVENT_INSTANT:
+                        fprintf(f, ",\n{\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"name\":", thread->id, ts);
+                        writeString(f, event.name);
+                        fprintf(f, ",\"args\":{\"index\":%llu,\"cycle\":%llu}}",
+                                (unsigned long long) event.index, (unsigned long long) event.cycle);
+                        break;
+                }
+            }
+        }
+
+        events += thread->events.load(memory_order_relaxed);
+        dropped += thread->dropped.load(memory_order_relaxed);
+    }
+
+    fprintf(f, "\n]}\n");
+    fclose(f);
+
+    CG_INFO("Timeline : %llu events from %u threads written to %s (%llu dropped).", (unsigned long long) events,
+            U32(threads.size()), outputFile.c_str(), (unsigned long long) dropped);
+}
+
+} // namespace arch
@@ -0,0 +1,128 @@
+/**************************************************************************
+ *
+ * Timeline recorder definition file.
+ *  This file defines the TimelineRecorder class that records when the tracing
+ *  regions (TRACING_ENTER_REGION, TRACING_EXIT_REGION) are entered and exited and
+ *  the simulation events (batch and frame boundaries) and writes them as a Chrome
+ *  trace event file (chrome://tracing, https://ui.perfetto.dev).
+ *
+ *  The recorder is compiled only if ENABLE_TIMELINE is defined (CMake option
+ *  TIMELINE_TRACING).  Otherwise the TIMELINE macros are empty.
+ *
+ */
+
+#ifndef _TIMELINE_
+#define _TIMELINE_
+
+#include "GPUType.h"
+
+#include <atomic>
+
+namespace arch
+{
+
+/**
+ *  Records timestamped events in a buffer per thread.
+ *
+ *  Each thread appends the events to its own chain of fixed size chunks without
+ *  locks, the event count of a chunk is published after the event is written.  The
+ *  region names are interned (a table shared by all the threads, only accessed when
+ *  a thread sees a name for the first time).  Events are dropped once a thread has
+ *  recorded the maximum number of events.
+ */
+class TimelineRecorder
+{
+public:
+
+    enum EventType
+    {
+        EVENT_BEGIN,        //  Region entered.
+        EVENT_END,          //  Region exited.
+        EVENT_INSTANT       //  Simulation event.
+    };
+
+    static const U32 CHUNK_EVENTS = 16384;                      //  Events per buffer chunk.
+    static const U64 DEFAULT_MAX_EVENTS = 8 * 1024 * 1024;      //  Default maximum events per thread.
+
+    /**
+     *  Starts recording.
+     *  @param fileName Chrome trace event file written by write().
+     *  @param maxEvents Maximum events recorded per thread.
+     */
+    static void start(const char *fileName, U64 maxEvents = DEFAULT_MAX_EVENTS);
+
+    /**
+     *  Returns if the events are being recorded.
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     *  Records that the current thread entered a region.
+     *  @param name Region name (copied the first time it is seen).
+     */
+    static void begin(const char *name)
+    {
+        if (isEnabled())
+            record(EVENT_BEGIN, name, 0, 0);
+    }
+
+    /**
+     *  Records that the current thread exited the last region entered.
+     */
+    static void end()
+    {
+        if (isEnabled())
+            record(EVENT_END, NULL, 0, 0);
+    }
+
+    /**
+     *  Records a simulation event.
+     *  @param name Event name.
+     *  @param index Event index (batch or frame number).
+     *  @param cycle Simulation cycle.
+     */
+    static void instant(const char *name, U64 index, U64 cycle)
+    {
+        if (isEnabled())
+            record(EVENT_INSTANT, name, index, cycle);
+    }
+
+    /**
+     *  Sets the name of the current thread in the timeline.
+     */
+    static void setThreadName(const char *name);
+
+    /**
+     *  Stops recording and writes the events to the file set by start().  Events
+     *  being recorded by other threads when recording stops may be missing.
+     */
+    static void write();
+
+private:
+
+    static std::atomic<bool> enabled;
+
+    static void record(EventType type, const char *name, U64 index, U64 cycle);
+
+    TimelineRecorder();
+};
+
+} // namespace arch
+
+#ifdef ENABLE_TIMELINE
+    #define TIMELINE_START(file)                arch::TimelineRecorder::start((file));
+    #define TIMELINE_BEGIN(name)                arch::TimelineRecorder::begin((name));
+    #define TIMELINE_END()                      arch::TimelineRecorder::end();
+    #define TIMELINE_INSTANT(name, index, cycle) arch::TimelineRecorder::instant((name), (index), (cycle));
+    #define TIMELINE_THREAD_NAME(name)          arch::TimelineRecorder::setThreadName((name));
+    #define TIMELINE_WRITE()                    arch::TimelineRecorder::write();
+#else
+    #define TIMELINE_START(file)
+    #define TIMELINE_BEGIN(name)
+    #define TIMELINE_END()
+    #define TIMELINE_INSTANT(name, index, cycle)
+    #define TIMELINE_THREAD_NAME(name)
+    #define TIMELINE_WRITE()
+#endif
+
+#endif    // _TIMELINE_
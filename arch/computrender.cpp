@@ -9,6 +9,7 @@
 #include "computrender.hpp"
 
 #include "perfmodel.h"
+#include "SweepRunner.h"
 
 
 #include "param_loader.hpp"
@@ -22,6 +23,8 @@
 #ifdef BUILD_D3D
 #include "TraceDriverApitraceD3D.h"
 #endif
+#include "TraceDriverPipelined.h"
+#include "BlockCorpus.h"
 
 #include <ctime>
 #include <new>
@@ -95,6 +98,7 @@ using namespace arch;
 
 //  Trace reader+driver.
 cgoTraceDriverBase *TraceDriver;
+TraceDriverPipelined *PipelinedDriver = nullptr;    //  Driver thread front-end (NULL if not used).
 
 cgsArchConfig ArchConf;     //  Simulator parameters.
 
@@ -310,6 +314,13 @@ int main(int argc, char *argv[])
     char **argList = new char*[argc];
     const char *paramFile = nullptr;             // path to archParams.csv (optional)
     const char *archName = "1.0";                // ARCH_VERSION column to use
+    const char *sweepFile = nullptr;             // configurations for sweep mode (optional)
+    const char *sweepDir = "sweep";              // sweep mode output directory
+    U32 sweepQueueSize = SWEEP_DEFAULT_QUEUE_SIZE;   // sweep mode MetaStream queue size in MBytes
+    U32 driverQueueSize = TraceDriverPipelined::DEFAULT_QUEUE_SIZE;  // driver thread MetaStream queue size (0 disables the thread)
+    const char *captureBlocks = nullptr;         // prefix of the compressed block corpus files (optional)
+    const char *timelineFile = nullptr;          // Chrome trace event file for the timeline (optional)
+    U32 hostProfilePeriod = 0;                   // sampling period of the mdu clock host profiler (0 disables it)
 
     // First pass: extract --arch (ARCH_VERSION column) and --param (CSV path) options.
     while (argIndex < argc) {
@@ -377,7 +388,21 @@ int main(int argc, char *argv[])
         else if (strcmp(argList[argIndex], "--trace") == 0 && ++argIndex < argCount) {
             ArchConf.sim.inputFile = new char[strlen(argList[argIndex]) + 1];
             strcpy(ArchConf.sim.inputFile, argList[argIndex]);
-        } else { // traditional arguments style
+        } else if (strcmp(argList[argIndex], "--sweep") == 0 && ++argIndex < argCount)
+            sweepFile = argList[argIndex];
+        else if (strcmp(argList[argIndex], "--sweep-dir") == 0 && ++argIndex < argCount)
+            sweepDir = argList[argIndex];
+        else if (strcmp(argList[argIndex], "--sweep-queue") == 0 && ++argIndex < argCount)
+            sweepQueueSize = atoi(argList[argIndex]);
+        else if (strcmp(argList[argIndex], "--driver-queue") == 0 && ++argIndex < argCount)
+            driverQueueSize = atoi(argList[argIndex]);
+        else if (strcmp(argList[argIndex], "--capture-blocks") == 0 && ++argIndex < argCount)
+            captureBlocks = argList[argIndex];
+        else if (strcmp(argList[argIndex], "--timeline") == 0 && ++argIndex < argCount)
+            timelineFile = argList[argIndex];
+        else if (strcmp(argList[argIndex], "--host-profile") == 0 && ++argIndex < argCount)
+            hostProfilePeriod = atoi(argList[argIndex]);
+        else { // traditional arguments style
             CG_ASSERT("[FATAL] ILLEGAL ARGUMENT DETECTED");
             //switch (argPos) {
             //    case 0: // trace file
@@ -405,6 +430,24 @@ int main(int argc, char *argv[])
         argIndex++;
     }
 
+    //  Capture the blocks compressed by the color and z caches.
+    if (captureBlocks != nullptr)
+    {
+        bmoBlockCorpus::enable(captureBlocks);
+        CG_INFO("Capturing compressed blocks to %s.<cache>.bin.", captureBlocks);
+    }
+
+    //  Record the tracing regions and the batch and frame events.
+    if (timelineFile != nullptr)
+    {
+#ifdef ENABLE_TIMELINE
+        TIMELINE_START(timelineFile)
+        TIMELINE_THREAD_NAME("simulation")
+#else
+        CG_WARN("Timeline not recorded, requires building with TIMELINE_TRACING.");
+#endif
+    }
+
     //  Check if the vector alu configuration is scalar (Scalar).
     string aluConf(ArchConf.ush.vectorALUConfig);    
     bool vectorScalarALU = ArchConf.ush.useVectorShader && (aluConf.compare("scalar") == 0);
@@ -561,6 +604,19 @@ int main(int argc, char *argv[])
             exit(1);
         }
     }
+    else if (cgoMetaStreamBlockReader::isBlockFile(ArchConf.sim.inputFile))    //  MetaStream block file (.msblk).
+    {
+        cgoMetaStreamBlockReader *blockReader = new cgoMetaStreamBlockReader();
+        CG_ASSERT_COND((blockReader->open(ArchConf.sim.inputFile)), "Error opening MetaStream block file %s.", ArchConf.sim.inputFile);
+        MetaStreamHeader metaTraceHeader;
+        CG_ASSERT_COND((blockReader->getTraceHeader().size() == sizeof(metaTraceHeader)), "MetaStream block file trace header size mismatch.");
+        memcpy(&metaTraceHeader, &blockReader->getTraceHeader()[0], sizeof(metaTraceHeader));
+        CG_ASSERT_COND((MetaTraceSignChecker(&metaTraceHeader)),"MetaStream Trace Signature check failed");
+        cout << "Using MetaStream Block File as simulation input (" << blockReader->getIndex().size() << " blocks)." << endl;
+        CG_WARN_COND((!MetaTraceParamChecker(&metaTraceHeader)), "Current parameters and the parameters of the trace file differ!");
+        TraceDriver = new TraceDriverMeta(blockReader, ArchConf.sim.startFrame, metaTraceHeader.parameters.startFrame, ArchConf.sim.simFrames); //  The trace driver deletes the reader.
+        ArchConf.sim.startFrame += metaTraceHeader.parameters.startFrame;
+    }
     else // MetaStream trace file extension: (.metaStream.txt.gz)
     {
         ProfilingFile.open(ArchConf.sim.inputFile, ios::in | ios::binary); //  Check if the input trace file is an MetaStream trace file.
@@ -574,6 +630,26 @@ int main(int argc, char *argv[])
         ArchConf.sim.startFrame += metaTraceHeader.parameters.startFrame; //  The start frame an offset to the first frame in the MetaStream trace.
         ProfilingFile.close(); //  Close ProfilingFile.
     }
+
+    //  Sweep mode: the driver output is shared by a simulator instance per configuration.
+    if (sweepFile != nullptr)
+    {
+        cgoSweepRunner sweep(sweepFile, paramFile, archName, sweepDir, sweepQueueSize);
+        CG_INFO("Sweep mode : %d configurations.", sweep.getNumConfigs());
+        U32 failed = sweep.run(TraceDriver, ArchConf, MAL);
+        delete TraceDriver;
+        return (failed == 0) ? 0 : -1;
+    }
+
+    //  Run the driver stack in its own thread.  Not used for MetaStream traces (the snapshot
+    //  code accesses the MetaStream trace driver) and in debug/validation mode (the HAL is
+    //  inspected from the simulation thread).
+    if ((driverQueueSize != 0) && !debugMode && !validMode && (TraceDriver->getTraceTyp() != TraceTypCgp))
+    {
+        PipelinedDriver = new TraceDriverPipelined(TraceDriver, driverQueueSize);
+        TraceDriver = PipelinedDriver;
+        CG_INFO("Driver thread enabled (%d MetaStreams queued).", driverQueueSize);
+    }
    
     switch(MAL)
     {
@@ -582,10 +658,14 @@ int main(int argc, char *argv[])
             CG_INFO("ComputGeneral MAL5 bhavmodel Enabled for Simulation");
             break;
         case CG_PERF_MODEL: 
-            GpuModel = new PerfModel(ArchConf, TraceDriver); 
+        {
+            PerfModel *perfModel = new PerfModel(ArchConf, TraceDriver);
+            perfModel->setClockProfiling(hostProfilePeriod);    //  Sample the host time of the mdu clock calls.
+            GpuModel = perfModel;
             panicCallback = &panicSnapshotWrapper;    //  Define the call back for the panic function to save a snapshot on simulator errors.
             CG_INFO("ComputGeneral MAL3 perfmodel Enabled for Simulation");
             break;
+        }
         default: CG_ASSERT("UNDEFINED/UNIMPLEMENTED MAL Detected!");
     }
   } catch (bool b) {
@@ -648,9 +728,28 @@ int main(int argc, char *argv[])
 
         if (ProfilingFile.is_open())        //  Close input file
             ProfilingFile.close();
+
+        if (PipelinedDriver != nullptr)     //  Stop the driver thread before the model is destroyed
+        {
+            PipelinedDriver->stop();
+            CG_INFO("Driver thread : simulator waited %llu times, driver waited %llu times.",
+                    PipelinedDriver->getConsumerStalls(), PipelinedDriver->getProducerStalls());
+        }
+
         delete GpuModel;
+
+        if (PipelinedDriver != nullptr)     //  Delete the driver front-end and the wrapped driver
+        {
+            delete PipelinedDriver;
+            PipelinedDriver = nullptr;
+            TraceDriver = nullptr;
+        }
+
+        if (bmoBlockCorpus::isEnabled())    //  Close the block corpus files
+            bmoBlockCorpus::close();
     }
     
+    TIMELINE_WRITE()
     TRACING_EXIT_REGION()
     TRACING_GENERATE_REPORT("profile.txt")
 
@@ -11,6 +11,11 @@
  * Defines the Cache class.  This class defines a generic and configurable
  * memory cache model.  Version for 64 bit addresses.
  *
+ * The tags of the ways in a set are stored contiguously and the valid bits
+ * of a set are packed in a 64-bit mask, so a lookup compares the tags of all
+ * the ways in the set with SIMD instructions.  The replacement policy is a
+ * template parameter (see CacheReplacement.h).
+ *
  */
 
 
@@ -22,6 +27,19 @@
 #include <cstdio>
 #include <cstring>
 
+//  Select the SIMD instruction set used to compare the tags of all the ways in a set.
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define CACHE_TAG_MATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define CACHE_TAG_MATCH_SSE2
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
 #ifndef __BM_CACHEBASE_H__
 #define __BM_CACHEBASE_H__
 
@@ -29,24 +47,115 @@
 namespace arch
 {
 
+/**
+ *  Number of tags compared per iteration by the tag match functions.  The tag
+ *  array of a set is padded to a multiple of this value.
+ */
+static const U32 CACHE_TAG_MATCH_WIDTH = 8;
+
+/**
+ *
+ *  Compares a tag against the tags of a set.
+ *
+ *  @param tags Pointer to the tags of the set.
+ *  @param numTags Number of tags in the set (multiple of CACHE_TAG_MATCH_WIDTH).
+ *  @param tag The tag to search.
+ *
+ *  @return A bit mask with the tags in the set that are equal to the searched tag.
+ *
+ */
+
+inline U64 cacheMatchTags(const U32 *tags, U32 numTags, U32 tag)
+{
+    U64 match = 0;
+
+#if defined(CACHE_TAG_MATCH_AVX2)
+    __m256i searched = _mm256_set1_epi32(S32(tag));
+    for(U32 w = 0; w < numTags; w += 8)
+    {
+        __m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *) &tags[w]), searched);
+        match |= U64(U32(_mm256_movemask_ps(_mm256_castsi256_ps(equal)))) << w;
+    }
+#elif defined(CACHE_TAG_MATCH_SSE2)
+    __m128i searched = _mm_set1_epi32(S32(tag));
+    for(U32 w = 0; w < numTags; w += 4)
+    {
+        __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) &tags[w]), searched);
+        match |= U64(U32(_mm_movemask_ps(_mm_castsi128_ps(equal)))) << w;
+    }
+#else
+    for(U32 w = 0; w < numTags; w++)
+        match |= U64(tags[w] == tag ? 1 : 0) << w;
+#endif
+
+    return match;
+}
+
+inline U64 cacheMatchTags(const U64 *tags, U32 numTags, U64 tag)
+{
+    U64 match = 0;
+
+#if defined(CACHE_TAG_MATCH_AVX2)
+    __m256i searched = _mm256_set1_epi64x(S64(tag));
+    for(U32 w = 0; w < numTags; w += 4)
+    {
+        __m256i equal = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *) &tags[w]), searched);
+        match |= U64(U32(_mm256_movemask_pd(_mm256_castsi256_pd(equal)))) << w;
+    }
+#elif defined(CACHE_TAG_MATCH_SSE2)
+    //  SSE2 has no 64-bit compare.  Both 32-bit halves must be equal.
+    __m128i searched = _mm_set1_epi64x(S64(tag));
+    for(U32 w = 0; w < numTags; w += 2)
+    {
+        __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) &tags[w]), searched);
+        equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+        match |= U64(U32(_mm_movemask_pd(_mm_castsi128_pd(equal)))) << w;
+    }
+#else
+    for(U32 w = 0; w < numTags; w++)
+        match |= U64(tags[w] == tag ? 1 : 0) << w;
+#endif
+
+    return match;
+}
+
+/**
+ *
+ *  Returns the index of the lowest bit set in a non zero mask.
+ *
+ */
 
+inline U32 cacheFirstWay(U64 mask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return U32(index);
+#elif defined(__GNUC__)
+    return U32(__builtin_ctzll(mask));
+#else
+    U32 index = 0;
+    while (((mask >> index) & 0x01) == 0)
+        index++;
+    return index;
+#endif
+}
 
 /**
  *  The Cache class defines and implements a generic and
  *  configurable cache model.  
  *  for 64 bit addr width, pass ADDRTYP with U64
  *  for 32 bit addr width, pass ADDRTYP with U32 
+ *  REPLACEPOLICY is the replacement policy class used by selectVictim (see
+ *  CacheReplacement.h), NoReplacementPolicy for caches that implement their own.
  *
  */
-template< typename ADDRTYP>
+template<typename ADDRTYP, typename REPLACEPOLICY = NoReplacementPolicy>
 class bmoCacheTemplate
 {
 
 private:
 
-    //  Cache parameters.  
-    CacheReplacePolicy replacePolicy;   //  Replacement policy for the cache.  
-
     //  Cache masks and shifts.  
     U32 byteMask;        //  Address line byte mask.  
     U32 lineMask;        //  Address line mask.  
@@ -54,7 +163,37 @@ private:
     U32 tagShift;        //  Address tag shift.  
 
     //  Cache replacement mechanism.  
-    CacheReplacementPolicy *policy;      //  Cache replacement policy.  
+    REPLACEPOLICY policy;       //  Cache replacement policy.
+
+    //  Tag file and valid bits.
+    U32 setTags;                //  Number of tags stored per line index (number of ways padded to CACHE_TAG_MATCH_WIDTH).
+    U64 allWays;                //  Mask with a bit set for each way.
+    ADDRTYP *tagFile;           //  Tags for all the ways of a line index stored contiguously.
+    U64 *validWays;             //  Valid bits for all the ways of a line index.
+
+    bmoCacheTemplate(const bmoCacheTemplate &);
+    bmoCacheTemplate &operator=(const bmoCacheTemplate &);
+
+    /**
+     *
+     *  Calculates the line index for an address.
+     *
+     */
+
+    U32 lineIndex(ADDRTYP address)
+    {
+        //  Check for fully associative cache.
+        if (numLines == 1)
+        {
+            //  Fully associative cache, no line index used.
+            return 0;
+        }
+        else
+        {
+            //  Get the line index from the address.
+            return (static_cast<U32>(address) >> lineShift) & lineMask;
+        }
+    }
 
 protected:
 
@@ -65,9 +204,53 @@ protected:
 
     //  Cache structures.  
     U08 ***cache;         //  Cache memory.  
-    bool **valid;           //  Valid line bit.  
-    ADDRTYP **tags;          //  Cache tag file.  
 
+    /**
+     *
+     *  Returns the tag stored for a cache line.
+     *
+     */
+
+    ADDRTYP getTag(U32 way, U32 line) const
+    {
+        return tagFile[line * setTags + way];
+    }
+
+    /**
+     *
+     *  Sets the tag for a cache line.
+     *
+     */
+
+    void setTag(U32 way, U32 line, ADDRTYP lineTag)
+    {
+        tagFile[line * setTags + way] = lineTag;
+    }
+
+    /**
+     *
+     *  Returns the valid bit of a cache line.
+     *
+     */
+
+    bool isValid(U32 way, U32 line) const
+    {
+        return ((validWays[line] >> way) & 0x01) != 0;
+    }
+
+    /**
+     *
+     *  Sets the valid bit of a cache line.
+     *
+     */
+
+    void setValid(U32 way, U32 line, bool lineValid)
+    {
+        if (lineValid)
+            validWays[line] |= (U64(1) << way);
+        else
+            validWays[line] &= ~(U64(1) << way);
+    }
 
     /**
      *
@@ -84,30 +267,16 @@ protected:
      */
     bool search(ADDRTYP address, U32 &line, U32 &way)
     {
-        U32 wayAux;
-        bool found;
-    
-        //  Check for fully associative cache.  
-        if (numLines == 1)
-        {
-            //  Fully associative cache, no line index used.  
-            line = 0;
-        }
-        else
-        {
-            //  Get the line index from the address.  
-            line = (static_cast<U32>(address) >> lineShift) & lineMask;
-        }
+        line = lineIndex(address);
     
-        //  Search the line in the different ways for the line index.  
-        for(wayAux = 0, found = FALSE; (wayAux < numWays) && !found; wayAux++)
-            found = ((tags[wayAux][line] == (address >> tagShift)) && valid[wayAux][line]);
+        //  Compare the tags of all the ways for the line index.
+        U64 hits = cacheMatchTags(&tagFile[line * setTags], setTags, ADDRTYP(address >> tagShift)) & validWays[line];
     
-        //  Adjust way.  
-        way = wayAux - 1;
+        //  Return the first way with the address.  On a miss the last way is returned.
+        way = (hits != 0) ? cacheFirstWay(hits) : (numWays - 1);
     
         //  Check hit.  
-        return found;
+        return (hits != 0);
     }
 
 
@@ -141,7 +310,7 @@ protected:
 
     ADDRTYP line2address(U32 way, U32 line)
     {
-        return (((tags[way][line] << (tagShift - lineShift)) + line) << lineShift);
+        return (((getTag(way, line) << (tagShift - lineShift)) + line) << lineShift);
     }
 
     /**
@@ -167,19 +336,17 @@ public:
      *
      *  Creates and initializes a Cache object.
      *
-     *  @param numWays Number of ways in the cache.
+     *  @param numWays Number of ways in the cache (up to 64).
      *  @param numLines Number of lines in the cache.
      *  @param bytesLine Line size in bytes.
-     *  @param replacePolicy Replacement policy for the cache.
      *
      *  @return A new initialized cache object.
      *
      */
 
-    bmoCacheTemplate(U32 ways, U32 lines, U32 bytesLine,
-        CacheReplacePolicy repPolicy) :
-        numWays(ways), numLines(lines), lineSize(bytesLine),
-        replacePolicy(repPolicy)
+    bmoCacheTemplate(U32 ways, U32 lines, U32 bytesLine) :
+        policy(ways, lines),
+        numWays(ways), numLines(lines), lineSize(bytesLine)
     {
         U32 i, j;
     
@@ -187,6 +354,8 @@ public:
         CG_ASSERT_COND(!(numLines == 0), "At least a line per way is required.");    
         //  Check number of ways.  
         CG_ASSERT_COND(!(numWays == 0), "At least a way is required.");    
+        //  Check number of ways.
+        CG_ASSERT_COND(!(numWays > 64), "Up to 64 ways are supported.");
         //  Check line size.  
         CG_ASSERT_COND(!(lineSize == 0), "At least a byte per line is required.");    
         //  Allocate cache ways.  
@@ -194,16 +363,7 @@ public:
     
         //  Check allocation.  
         CG_ASSERT_COND(!(cache == NULL), "Error allocating pointer to the ways.");    
-        //  Allocate tag file for the ways.  
-        tags = new ADDRTYP*[numWays];
-    
-        //  Check allocation.  
-        CG_ASSERT_COND(!(tags == NULL), "Error allocating pointers for the ways tag files.");    
-        //  Allocate the valid bit for ways.  
-        valid = new bool*[numWays];
-    
-        CG_ASSERT_COND(!(valid == NULL), "Error allocating the pointers for the ways valid bits.");    
-        //  Allocate cache memory, tags and valid bits.  
+        //  Allocate cache memory.
         for (i = 0; i < numWays; i++)
         {
             //  Allocate the way cache lines.  
@@ -211,15 +371,6 @@ public:
     
             //  Cehck allocation.  
             CG_ASSERT_COND(!(cache[i] == NULL), "Error allocating line pointers for the way.");    
-            //  Allocate tag file for the way lines.  
-            tags[i] = new ADDRTYP[numLines];
-    
-            //  Check allocation.  
-            CG_ASSERT_COND(!(tags[i] == NULL), "Error allocating tag file for the lines in a way.");    
-            //  Allocate the valid bits  for the way lines.  
-            valid[i] = new bool[numLines];
-    
-            CG_ASSERT_COND(!(valid[i] == NULL), "Error allocating the valid bits for the lines in a way.");    
             //  Allocate cache lines.  
             for (j = 0; j < numLines; j++)
             {
@@ -228,10 +379,19 @@ public:
     
                 //  Check memory allocation.  
                 CG_ASSERT_COND(!(cache[i][j] == NULL), "Error allocating cache line.");    
-                //  Reset valid bit for the line.  
-                valid[i][j] = FALSE;
             }
         }
+
+        //  Allocate the tag file.  The padding tags are never valid.
+        setTags = ((numWays + CACHE_TAG_MATCH_WIDTH - 1) / CACHE_TAG_MATCH_WIDTH) * CACHE_TAG_MATCH_WIDTH;
+        tagFile = new ADDRTYP[numLines * setTags];
+        memset(tagFile, 0, sizeof(ADDRTYP) * numLines * setTags);
+
+        //  Allocate and reset the valid bits.
+        allWays = (numWays == 64) ? ~U64(0) : ((U64(1) << numWays) - 1);
+        validWays = new U64[numLines];
+        for (j = 0; j < numLines; j++)
+            validWays[j] = 0;
     
         //  Calculate masks and shifts.  
         byteMask = GPUMath::buildMask(lineSize);
@@ -243,43 +403,20 @@ public:
             tagShift = lineShift;
         else
             tagShift = GPUMath::calculateShift(numLines) + lineShift;
+    }
     
-        //  Create replacemente policy object.  
-        switch(repPolicy)
+    ~bmoCacheTemplate()
         {
-            case CACHE_DIRECT:
-                CG_ASSERT("Not Implemented.");
-                break;
-    
-            case CACHE_LRU:
-    
-                //  LRU replacemente policy.  
-                policy = new LRUPolicy(numWays, numLines);
-                break;
-    
-            case CACHE_PSEUDOLRU:
-    
-                //  Pseudo LRU replacement policy.  
-                policy = new PseudoLRUPolicy(numWays, numLines);
-                break;
-    
-            case CACHE_FIFO:
-    
-                //  FIFO replacement policy.  
-                policy = new FIFOPolicy(numWays, numLines);
-                break;
-    
-            case CACHE_NONE:
-    
-                //  No replacement policy defined.  
-                policy = NULL;
-    
-                break;
-    
-            default:
-                CG_ASSERT("Unsupported cache replacemente policy.");
-                break;
+        for (U32 i = 0; i < numWays; i++)
+        {
+            for (U32 j = 0; j < numLines; j++)
+                delete[] cache[i][j];
+            delete[] cache[i];
         }
+    
+        delete[] cache;
+        delete[] tagFile;
+        delete[] validWays;
     }
 
     /**
@@ -308,12 +445,8 @@ public:
             //  Read the data.  
             data = *((U32 *) &cache[way][line][address & byteMask]);
     
-            //  Check if replacement policy is defined.  
-            if (policy != NULL)
-            {
-                //  Update replacemente algorithm.  
-                policy->access(way, line);
-            }
+            //  Update replacement algorithm.
+            policy.access(way, line);
     
             //  Return a hit.  
             return TRUE;
@@ -350,12 +483,8 @@ public:
             //  Write the data.  
             *((U32 *) &cache[way][line][address & byteMask]) = data;
     
-            //  Check if replacement policy defined.  
-            if (policy != NULL)
-            {
-                //  Update replacemente algorithm.  
-                policy->access(way, line);
-            }
+            //  Update replacement algorithm.
+            policy.access(way, line);
     
             //  Return a hit.  
             return TRUE;
@@ -384,41 +513,17 @@ public:
 
     U32 selectVictim(ADDRTYP address)
     {
-        U32 line;
-        U32 way;
-    
-        //  Check for fully associative cache.  
-        if (numLines == 1)
-        {
-            //  Fully associative cache, no line index used.  
-            line = 0;
-        }
-        else
-        {
-            //  Get the line index from the address.  
-            line = (static_cast<U32>(address) >> lineShift) & lineMask;
-        }
+        U32 line = lineIndex(address);
     
         //  First search the ways in the line index for an invalid line.  
-        for(way = 0;(way < numWays) && valid[way][line]; way++);
+        U64 invalid = ~validWays[line] & allWays;
     
         //  Check if an invalid line was found for the line index.  
-        if (way == numWays)
-        {
-            //  Check if replacement policy is defined.  
-            if (policy != NULL)
-            {
-                //  Ask the replacement protocol for a line.  
-                return policy->victim(line);
-            }
-            else
-            {
-                CG_ASSERT("No replacement policy defined.");
-            }
-        }
-        // else  // Use the invalid line.
-        return way;
+        if (invalid != 0)
+            return cacheFirstWay(invalid);
     
+        //  Ask the replacement policy for a line.
+        return policy.victim(line);
     }
 
     /**
@@ -435,36 +540,22 @@ public:
 
     void replace(ADDRTYP address, U32 way, U08 *data)
     {
-        U32 line;
-    
         CG_ASSERT_COND(!(way >= numWays), "Out of range cache way number.");    
-        //  Check for fully associative cache.  
-        if (numLines == 0)
-        {
-            //  There is only a cache line per way.  
-            line = 0;
-        }
-        else
-        {
+    
             //  Get the line in the way from the address.  
-            line = (static_cast<U32>(address) >> lineShift) & lineMask;
-        }
+        U32 line = lineIndex(address);
     
         //  Copy the data.  
         memcpy(cache[way][line], data, lineSize);
     
         //  Set the tag for the line.  
-        tags[way][line] = (address >> tagShift);
+        setTag(way, line, (address >> tagShift));
     
         //  Set the valid bit for the line.  
-        valid[way][line] = TRUE;
+        setValid(way, line, TRUE);
     
-        //  Check if replacement policy is defined.  
-        if (policy != NULL)
-        {
             //  Update replacement algorithm.  
-            policy->access(way, line);
-        }
+        policy.access(way, line);
     }
 
     /**
@@ -484,33 +575,19 @@ public:
 
     void replace(ADDRTYP address, U32 way)
     {
-        U32 line;
-    
         CG_ASSERT_COND(!(way >= numWays), "Out of range cache way number.");    
-        //  Check for fully associative cache.  
-        if (numLines == 0)
-        {
-            //  There is only a cache line per way.  
-            line = 0;
-        }
-        else
-        {
+    
             //  Get the line in the way from the address.  
-            line = (static_cast<U32>(address) >> lineShift) & lineMask;
-        }
+        U32 line = lineIndex(address);
     
         //  Set the tag for the line.  
-        tags[way][line] = (address >> tagShift);
+        setTag(way, line, (address >> tagShift));
     
         //  Set the valid bit for the line.  
-        valid[way][line] = TRUE;
+        setValid(way, line, TRUE);
     
-        //  Check if replacement policy is defined.  
-        if (policy != NULL)
-        {
             //  Update replacement algorithm.  
-            policy->access(way, line);
-        }
+        policy.access(way, line);
     }
 
     /**
@@ -562,7 +639,7 @@ public:
         if (search(address, line, way))
        {
             //  Invalidate line.  
-            valid[way][line] = FALSE;
+            setValid(way, line, FALSE);
         }
     }
 
@@ -572,14 +649,8 @@ public:
      */
     void reset()
     {
-        U32 i, j;
-        for(i = 0; i < numWays; i++)
-        {
-            for(j = 0; j < numLines; j++)
-            {
-                valid[i][j] = FALSE;
-            }
-        }
+        for(U32 j = 0; j < numLines; j++)
+            validWays[j] = 0;
     }
 
 };
@@ -35,8 +35,8 @@ using namespace arch;
 FetchCache::FetchCache(U32 ways, U32 lines, U32 lineBytes, U32 reqQSize,
     char *fetchCacheName) :
 
-    requestQueueSize(reqQSize), debugMode(false),
-    bmoCacheTemplate<U32>(ways, lines, lineBytes, CACHE_NONE)
+    bmoCacheTemplate<U32>(ways, lines, lineBytes),
+    requestQueueSize(reqQSize), debugMode(false)
 {
     U32 i;
     U32 j;
@@ -263,11 +263,11 @@ bool FetchCache::fetch(U32 address, U32 &way, U32 &line, DynamicObject *source,
                 oldAddress = line2address(way, line);
 
                 //  Set the new tag for the fetch cache line.  
-                tags[way][line] = tag(address);
+                setTag(way, line, tag(address));
 //printf("FetchCache (%s) => Setting tag %x for way = %d line = %d\n", name, tag(address), way, line);
 
                 //  Check if the current data in the line is valid.  
-                if (valid[way][line] && dirty[way][line])
+                if (isValid(way, line) && dirty[way][line])
                 {
 //printf("FetchCache (%s) => Evicting line at way = %d line = %d | outAddress = %x | inAddress = %x\n", name, way, line, oldAddress, line2address(way, line));
                     /*  Add a write request to write back the fetch cache
@@ -352,7 +352,7 @@ bool FetchCache::fetch(U32 address, U32 &way, U32 &line, DynamicObject *source,
                 replaceLine[way][line] = TRUE;
 
                 //  Mark line as valid.  
-                valid[way][line] = TRUE;
+                setValid(way, line, TRUE);
 
                 //  Mark as not masked line (normal mode).  
                 masked[way][line] = FALSE;
@@ -489,10 +489,10 @@ bool FetchCache::fetch(U32 address, U32 &way, U32 &line, bool &miss, DynamicObje
                 oldAddress = line2address(way, line);
 
                 //  Set the new tag for the fetch cache line.  
-                tags[way][line] = tag(address);
+                setTag(way, line, tag(address));
 
                 //  Check if the current data in the line is valid.  
-                if (valid[way][line] && dirty[way][line])
+                if (isValid(way, line) && dirty[way][line])
                 {
                     /*  Add a write request to write back the fetch cache
                         line to memory.  */
@@ -566,7 +566,7 @@ bool FetchCache::fetch(U32 address, U32 &way, U32 &line, bool &miss, DynamicObje
                 replaceLine[way][line] = TRUE;
 
                 //  Mark line as valid.  
-                valid[way][line] = TRUE;
+                setValid(way, line, TRUE);
 
                 //  Mark as not masked line (normal mode).  
                 masked[way][line] = FALSE;
@@ -632,7 +632,7 @@ bool FetchCache::allocate(U32 address, U32 &way, U32 &line, DynamicObject *sourc
             printf("FetchCache (%s) => Allocate hit address %x at way %d line %d.\n", name, address, way, line);
         )
 
-//printf("Allocating (ok) %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], tags[way][line]);
+//printf("Allocating (ok) %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], getTag(way, line));
 
         //  Hit.  Just update the reserve counter for the line.  
         reserve[way][line] += reserves;
@@ -666,7 +666,7 @@ bool FetchCache::allocate(U32 address, U32 &way, U32 &line, DynamicObject *sourc
         if (reserve[way][line] == 0)
         {
             //  Check if the current data in the line is valid.  
-            if (valid[way][line] && dirty[way][line])
+            if (isValid(way, line) && dirty[way][line])
             {
                 GPU_DEBUG(
                     printf("FetchCache => Valid line.\n");
@@ -682,7 +682,7 @@ bool FetchCache::allocate(U32 address, U32 &way, U32 &line, DynamicObject *sourc
                     oldAddress = line2address(way, line);
 
                     //  Set the new tag for the fetch cache line.  
-                    tags[way][line] = tag(address);
+                    setTag(way, line, tag(address));
 
                     GPU_DEBUG(
                         printf("FetchCache (%s) => Flush line at address %x and allocate line at address %x\n",
@@ -730,13 +730,13 @@ bool FetchCache::allocate(U32 address, U32 &way, U32 &line, DynamicObject *sourc
                     //  Set line as marked for replacing.  
                     replaceLine[way][line] = TRUE;
 
-//printf("Allocating (fail valid) %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], tags[way][line]);
+//printf("Allocating (fail valid) %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], getTag(way, line));
 
                     //  Set line as reserved.  
                     reserve[way][line] += reserves;
 
                     //  Mark line as valid.  
-                    valid[way][line] = TRUE;
+                    setValid(way, line, TRUE);
 
                     //  Mark as a masked line (write buffer mode!!).  
                     masked[way][line] = TRUE;
@@ -769,7 +769,7 @@ bool FetchCache::allocate(U32 address, U32 &way, U32 &line, DynamicObject *sourc
                     for next cycle before allowing the write.  */
 
                 //  Set the new tag for the fetch cache line.  
-                tags[way][line] = tag(address);
+                setTag(way, line, tag(address));
 
                 GPU_DEBUG(
                     printf("FetchCache(%s) => Invalid line found. Just clear write mask.\n", name);
@@ -779,13 +779,13 @@ bool FetchCache::allocate(U32 address, U32 &way, U32 &line, DynamicObject *sourc
                 for(i = 0; i < lineSize; i++)
                     writeMask[way][line][i] = false;
 
-//printf("Allocating (fail invalid) %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], tags[way][line]);
+//printf("Allocating (fail invalid) %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], getTag(way, line));
 
                 //  Set line as reserved.  
                 reserve[way][line] += reserves;
 
                 //  Mark line as valid.  
-                valid[way][line] = TRUE;
+                setValid(way, line, TRUE);
 
                 //  Mark as a masked line (write buffer mode!!!).  
                 masked[way][line] = TRUE;
@@ -832,7 +832,7 @@ bool FetchCache::read(U32 address, U32 way, U32 line, U32 size, U08 *data)
     //  Check the amount of data to read does not overflows the line.  
     CG_ASSERT_COND(!(((offset(address) & 0xfffffffc) + size) > lineSize), "Trying to read beyond the cache line.");
     //  Check if the address was previously fetched.  
-    CG_ASSERT_COND(!(tags[way][line] != tag(address)), "Trying to read an unfetched address.");    
+    CG_ASSERT_COND(!(getTag(way, line) != tag(address)), "Trying to read an unfetched address.");    
     //  Check if the line is available.  
     if (!replaceLine[way][line])
     {
@@ -894,7 +894,7 @@ bool FetchCache::write(U32 address, U32 way, U32 line, U32 size,
     //  Check size is a multiple of 4 bytes.  
     CG_ASSERT_COND(!((size & 0x03) != 0), "Size of the data to write must be a multiple of 4.");
     //  Check if the address was previously fetched.  
-    CG_ASSERT_COND(!(tags[way][line] != tag(address)), "Trying to write an unfetched address.");
+    CG_ASSERT_COND(!(getTag(way, line) != tag(address)), "Trying to write an unfetched address.");
     //  Check if the line data is available.  
     if (!replaceLine[way][line])
     {
@@ -966,14 +966,14 @@ bool FetchCache::write(U32 address, U32 way, U32 line, U32 size,
     CG_ASSERT_COND(!(((offset(address) & 0xfffffffc) + size) > lineSize), "Trying to write beyond the cache line.");
      //  Check if the address was previously fetched.  
     GPU_ASSERT(
-        if (tags[way][line] != tag(address))
+        if (getTag(way, line) != tag(address))
         {
-            printf(" >> Way %d Line %d address %x tag %x tag %x\n", way, line, address, tags[way][line], tag(address));
+            printf(" >> Way %d Line %d address %x tag %x tag %x\n", way, line, address, getTag(way, line), tag(address));
             CG_ASSERT("Trying to write an unfetched address.");
         }
     )
 
-//printf("Writing %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], tags[way][line]);
+//printf("Writing %s at addr %x way %d line %d reserves %d tag %x\n", name, address, way, line, reserve[way][line], getTag(way, line));
 
     //  There are no writes, yet.  
     anyWrite = FALSE;
@@ -1142,13 +1142,13 @@ void FetchCache::reset()
         for (j = 0; j < numLines; j++)
         {
             //  Reset tags.  
-            tags[i][j] = 0;
+            setTag(i, j, 0);
 
             //  Reset reserve counter.  
             reserve[i][j] = 0;
 
             //  Reset valid bits.  
-            valid[i][j] = FALSE;
+            setValid(i, j, FALSE);
 
             //  Reset replace bit.  
             replaceLine[i][j] = FALSE;
@@ -1207,7 +1207,7 @@ bool FetchCache::flush()
         for(way = 0; (way < numWays) && (freeRequests > 0); way++)
         {
             //  Check there are free request entry
-            if (valid[way][line])
+            if (isValid(way, line))
             {
                 /*  Add a write request to write back the fetch cache
                     line to memory.  */
@@ -1241,7 +1241,7 @@ bool FetchCache::flush()
                 activeRequests++;
 
                 //  Mark line as valid.  
-                valid[way][line] = FALSE;
+                setValid(way, line, FALSE);
             }
         }
     }
@@ -35,8 +35,8 @@ using namespace arch;
 FetchCache64::FetchCache64(U32 ways, U32 lines, U32 lineBytes, U32 reqQSize,
     char *fetchCacheName) :
 
-    requestQueueSize(reqQSize), debugMode(false),
-    bmoCacheTemplate<U64>(ways, lines, lineBytes, CACHE_NONE)
+    bmoCacheTemplate<U64>(ways, lines, lineBytes),
+    requestQueueSize(reqQSize), debugMode(false)
 {
     U32 i;
     U32 j;
@@ -246,10 +246,10 @@ bool FetchCache64::fetch(U64 address, U32 &way, U32 &line, DynamicObject *source
                 oldAddress = line2address(way, line);
 
                 //  Set the new tag for the fetch cache line.  
-                tags[way][line] = tag(address);
+                setTag(way, line, tag(address));
 
                 //  Check if the current data in the line is valid.  
-                if (valid[way][line] && dirty[way][line])
+                if (isValid(way, line) && dirty[way][line])
                 {
                     /*  Add a write request to write back the fetch cache
                         line to memory.  */
@@ -302,7 +302,7 @@ bool FetchCache64::fetch(U64 address, U32 &way, U32 &line, DynamicObject *source
                 replaceLine[way][line] = TRUE;
 
                 //  Mark line as valid.  
-                valid[way][line] = TRUE;
+                setValid(way, line, TRUE);
 
                 //  Mark as not masked line (normal mode).  
                 masked[way][line] = FALSE;
@@ -447,10 +447,10 @@ bool FetchCache64::fetch(U64 address, U32 &way, U32 &line, bool &miss, DynamicOb
                 oldAddress = line2address(way, line);
 
                 //  Set the new tag for the fetch cache line.  
-                tags[way][line] = tag(address);
+                setTag(way, line, tag(address));
 
                 //  Check if the current data in the line is valid.  
-                if (valid[way][line] && dirty[way][line])
+                if (isValid(way, line) && dirty[way][line])
                 {
                     /*  Add a write request to write back the fetch cache
                         line to memory.  */
@@ -502,7 +502,7 @@ bool FetchCache64::fetch(U64 address, U32 &way, U32 &line, bool &miss, DynamicOb
                 replaceLine[way][line] = TRUE;
 
                 //  Mark line as valid.  
-                valid[way][line] = TRUE;
+                setValid(way, line, TRUE);
 
                 //  Mark as not masked line (normal mode).  
                 masked[way][line] = FALSE;
@@ -540,7 +540,7 @@ bool FetchCache64::fetch(U64 address, U32 &way, U32 &line, bool &miss, DynamicOb
                 printf("%s => All cache lines are reserved.\n", name);
                 for(U32 w = 0; w < numWays; w++)
                 {
-                    printf(" Set %d Way %d -> reserved? %s | tag = %016llx\n", line, w, reserve[w][line]? "Yes" : "No", tags[w][line]);
+                    printf(" Set %d Way %d -> reserved? %s | tag = %016llx\n", line, w, reserve[w][line]? "Yes" : "No", getTag(w, line));
                 }
             )
 
@@ -601,7 +601,7 @@ bool FetchCache64::allocate(U64 address, U32 &way, U32 &line, DynamicObject *sou
         if (reserve[way][line] == 0)
         {
             //  Check if the current data in the line is valid.  
-            if (valid[way][line] && dirty[way][line])
+            if (isValid(way, line) && dirty[way][line])
             {
                 GPU_DEBUG(
                     printf("%s => Valid line.\n", name);
@@ -617,7 +617,7 @@ bool FetchCache64::allocate(U64 address, U32 &way, U32 &line, DynamicObject *sou
                     oldAddress = line2address(way, line);
 
                     //  Set the new tag for the fetch cache line.  
-                    tags[way][line] = tag(address);
+                    setTag(way, line, tag(address));
 
                     GPU_DEBUG(
                         printf("%s => Flush line at address %016llx and allocate line at address %016llx\n",
@@ -661,7 +661,7 @@ bool FetchCache64::allocate(U64 address, U32 &way, U32 &line, DynamicObject *sou
                     reserve[way][line]++;
 
                     //  Mark line as valid.  
-                    valid[way][line] = TRUE;
+                    setValid(way, line, TRUE);
 
                     //  Mark as a masked line (write buffer mode!!).  
                     masked[way][line] = TRUE;
@@ -694,7 +694,7 @@ bool FetchCache64::allocate(U64 address, U32 &way, U32 &line, DynamicObject *sou
                     for next cycle before allowing the write.  */
 
                 //  Set the new tag for the fetch cache line.  
-                tags[way][line] = tag(address);
+                setTag(way, line, tag(address));
 
                 GPU_DEBUG(
                     printf("%s => Invalid line found. Just clear write mask.\n", name);
@@ -708,7 +708,7 @@ bool FetchCache64::allocate(U64 address, U32 &way, U32 &line, DynamicObject *sou
                 reserve[way][line]++;
 
                 //  Mark line as valid.  
-                valid[way][line] = TRUE;
+                setValid(way, line, TRUE);
 
                 //  Mark as a masked line (write buffer mode!!!).  
                 masked[way][line] = TRUE;
@@ -756,7 +756,7 @@ bool FetchCache64::read(U64 address, U32 way, U32 line, U32 size, U08 *data)
     //  Check the amount of data to read does not overflows the line.  
     CG_ASSERT_COND(!(((offset(address) & 0xfffffffffffffffcULL) + size) > lineSize), "Trying to read beyond the cache line.");
     //  Check if the address was previously fetched.  
-    CG_ASSERT_COND(!(tags[way][line] != tag(address)), "Trying to read an unfetched address.");
+    CG_ASSERT_COND(!(getTag(way, line) != tag(address)), "Trying to read an unfetched address.");
     //  Check if the line is available.  
     if (!replaceLine[way][line])
     {
@@ -808,7 +808,7 @@ bool FetchCache64::write(U64 address, U32 way, U32 line, U32 size,
     //  Check size is a multiple of 4 bytes.  
     CG_ASSERT_COND(!((size & 0x03) != 0), "Size of the data to write must be a multiple of 4.");
     //  Check if the address was previously fetched.  
-    CG_ASSERT_COND(!(tags[way][line] != tag(address)), "Trying to write an unfetched address.");
+    CG_ASSERT_COND(!(getTag(way, line) != tag(address)), "Trying to write an unfetched address.");
     //  Check if the line data is available.  
     if (!replaceLine[way][line])
     {
@@ -879,7 +879,7 @@ bool FetchCache64::write(U64 address, U32 way, U32 line, U32 size,
     //  Check the amount of data to write does not overflows the line.  
     CG_ASSERT_COND(!(((offset(address) & 0xfffffffffffffffcULL) + size) > lineSize), "Trying to write beyond the cache line.");
      //  Check if the address was previously fetched.  
-    CG_ASSERT_COND(!(tags[way][line] != tag(address)), "Trying to write an unfetched address.");
+    CG_ASSERT_COND(!(getTag(way, line) != tag(address)), "Trying to write an unfetched address.");
     //  There are no writes, yet.  
     anyWrite = FALSE;
 
@@ -1045,10 +1045,10 @@ void FetchCache64::reset()
             reserve[i][j] = 0;
 
             //  Reset tags.  
-            tags[i][j] = 0;
+            setTag(i, j, 0);
 
             //  Reset valid bits.  
-            valid[i][j] = FALSE;
+            setValid(i, j, FALSE);
 
             //  Reset replace bit.  
             replaceLine[i][j] = FALSE;
@@ -1107,7 +1107,7 @@ bool FetchCache64::flush()
         for(line = 0; (line < numLines) && (freeRequests > 0); line++)
         {
             //  Check there are free request entry
-            if (valid[way][line])
+            if (isValid(way, line))
             {
                 /*  Add a write request to write back the fetch cache
                     line to memory.  */
@@ -1140,7 +1140,7 @@ bool FetchCache64::flush()
                 activeRequests++;
 
                 //  Mark line as valid.  
-                valid[way][line] = FALSE;
+                setValid(way, line, FALSE);
             }
         }
     }
@@ -15,6 +15,7 @@
 
 #include "GPUMath.h"
 #include "ROPCache.h"
+#include "BlockCorpus.h"
 using arch::tools::Queue;
 
 #include <fstream>
@@ -1507,6 +1508,10 @@ printf("%s%02d => Block marked as CLEAR and masked.\n", ropCacheName, cacheID);
             //  Copy uncompressed output to the compression buffer.
             memcpy(comprBuffer, outputBuffer[nextWrite], lineSize);
 
+            //  Capture the block for the compressor benchmarks.
+            if (bmoBlockCorpus::isEnabled())
+                bmoBlockCorpus::record(ropCacheName, (U32 *) comprBuffer, lineSize >> 2);
+
             //  Compress block/line.
             comprInfo = getCompressor().compress(
                     comprBuffer, 
@@ -35,8 +35,6 @@ cmoClipper::cmoClipper(U32 trCycle, U32 clipUnits, U32 startLat, U32 execLat, U3
     startLatency(startLat), execLatency(execLat), clipBufferSize(bufferSize),
     rasterizerStartLat(rastLat), rasterizerOutputLat(outputLat), cmoMduBase(name, parent)
 {
-    DynamicObject *defaultState[1];
-
     //  Check parameters. 
     GPU_ASSERT(
         if (trianglesCycle != clipperUnits)
@@ -53,11 +51,8 @@ cmoClipper::cmoClipper(U32 trCycle, U32 clipUnits, U32 startLat, U32 execLat, U3
     //  Create state signal to the CommandProcessor.  
     clipperCommState = newOutputSignal("ClipperCommandState", 1, 1, NULL);
 
-    //  Set default signal value.  
-    defaultState[0] = new ClipperStateInfo(CLP_RESET);
-
-    //  Set default primitive assembly state signal to the Command Processor.  
-    clipperCommState->setData(defaultState);
+    //  Set default clipper state signal to the Command Processor.
+    clipperCommState.setInitial(CLP_RESET);
 
     //  Create triangle input signal from Primitive Assembly.  
     clipperInput = newInputSignal("ClipperInput", trianglesCycle, 1, NULL);
@@ -377,7 +372,7 @@ void cmoClipper::clock(U64 cycle)
     }
 
     //  Send state to Command Processor.  
-    clipperCommState->write(cycle, new ClipperStateInfo(state));
+    clipperCommState.write(cycle, state);
 }
 
 
@@ -15,6 +15,7 @@
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "TriangleSetupInput.h"
 #include "ClipperCommand.h"
@@ -23,6 +24,9 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class ClipperStateInfo;
+
 
 
 
@@ -77,7 +81,7 @@ private:
 
     //  cmoClipper signals.  
     Signal *clipperCommand;          //  cmoClipper command signal from the Command Processor.  
-    Signal *clipperCommState;        //  cmoClipper state signal to the Command Processor.  
+    StateWire<ClipperStateInfo> clipperCommState;   //  cmoClipper state signal to the Command Processor.  
     Signal *clipperInput;            //  cmoClipper triangle input from the Primitive Assembly unit.  
     Signal *clipperRequest;          //  cmoClipper request signal to the Primitive Assembly unit.  
     Signal *rasterizerNewTriangle;   //  New triangle signal to the Rasterizer unit.  
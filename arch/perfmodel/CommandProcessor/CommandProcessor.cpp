@@ -22,6 +22,7 @@
 #include "ClipperStateInfo.h"
 #include "GPUMath.h"
 #include "MemoryControllerCommand.h"
+#include "ValidationChecker.h"
 #include <iostream>
 
 using std::cout;
@@ -135,14 +136,8 @@ forcedCommand(false)
     vshProgID = 0;
     fshProgID = 0;
 
-    //  Clear the agp transaction log.
-    nextReadLog = 3;
-    nextWriteLog = 0;
-    agpTransactionLog[0].clear();
-    agpTransactionLog[1].clear();
-    
     // Set validation mode to disabled.
-    enableValidation = false;
+    validationChecker = NULL;
     
     //  Initial GPU state.  
     state.statusRegister = GPU_ST_RESET;
@@ -194,9 +189,9 @@ void cmoCommandProcessor::PortBinding()
 
     //  Create the fragment shader command signal arrays.  
     zStencilCommSignal = new Signal*[numStampUnits];
-    zStencilStateSignal = new Signal*[numStampUnits];
+    zStencilStateSignal = new StateWire<RasterizerStateInfo>[numStampUnits];
     colorWriteCommSignal = new Signal*[numStampUnits];
-    colorWriteStateSignal = new Signal*[numStampUnits];
+    colorWriteStateSignal = new StateWire<RasterizerStateInfo>[numStampUnits];
     for(U32 i = 0; i < numStampUnits; i++)
     {
         char suPrefix[6];
@@ -224,16 +219,9 @@ void cmoCommandProcessor::clock(U64 cycle)
     ClipperCommand *clipperCommand;
     RasterizerCommand *rastComm;
     RasterizerState rasterizerState;
-    RasterizerStateInfo *rastStateInfo;
-    RasterizerStateInfo *zStencilStateInfo;
-    RasterizerStateInfo *colorWriteStateInfo;
     RasterizerState dacState;
-    RasterizerStateInfo *dacStateInfo;
-    StreamerStateInfo *streamStateInfo;
     cgoMetaStream *auxMetaStreamTrans;
-    PrimitiveAssemblyStateInfo *paStateInfo;
     AssemblyState paState;
-    ClipperStateInfo *clipStateInfo;
     ClipperState clipState;
     U32 size;
     bool endAllZST;
@@ -289,58 +277,25 @@ void cmoCommandProcessor::clock(U64 cycle)
 
 
     //  Get cmoStreamController State.  
-    if (streamStateSignal->read(cycle, (DynamicObject *&) streamStateInfo))
-    {
-        //  Store StreamController state.  
-        streamState = streamStateInfo->getState();
-
-        //  Delete the StreamController state info.  
-        delete streamStateInfo;
-
-    }
-    else
+    if (!streamStateSignal.read(cycle, streamState))
     {
         CG_ASSERT("Missing state signal from the cmoStreamController.");
     }
 
     //  Get Primitive Assembly State.  
-    if (paStateSignal->read(cycle, (DynamicObject *&) paStateInfo))
-    {
-        //  Store primitive assembly state.  
-        paState = paStateInfo->getState();
-
-        //  Delete primitive assembly state info object.  
-        delete paStateInfo;
-    }
-    else
+    if (!paStateSignal.read(cycle, paState))
     {
         CG_ASSERT("Missing state signal from Primitive Assembly.");
     }
 
     //  Get Clipper state.  
-    if (clipStateSignal->read(cycle, (DynamicObject *&) clipStateInfo))
-    {
-        //  Store clip state.  
-        clipState = clipStateInfo->getState();
-
-        //  Delete state info object.  
-        delete clipStateInfo;
-    }
-    else
+    if (!clipStateSignal.read(cycle, clipState))
     {
         CG_ASSERT("Missing state signal from the Clipper.");
     }
 
     //  Get Rasterizer State.  
-    if(rastStateSignal->read(cycle, (DynamicObject *&) rastStateInfo))
-    {
-        //  Store rasterizer state.  
-        rasterizerState = rastStateInfo->getState();
-
-        //  Delete the rasterizer state info received.  
-        delete rastStateInfo;
-    }
-    else
+    if (!rastStateSignal.read(cycle, rasterizerState))
     {
         CG_ASSERT("Missing state signal from the Rasterizer.");
     }
@@ -349,16 +304,10 @@ void cmoCommandProcessor::clock(U64 cycle)
     //  Get Z Stencil state.  
     for(i = 0, endAllZST = TRUE; i < numStampUnits; i++)
     {
-        if (zStencilStateSignal[i]->read(cycle, (DynamicObject *&) zStencilStateInfo))
+        if (zStencilStateSignal[i].read(cycle, zStencilState[i]))
         {
-            //  Store rasterizer state.  
-            zStencilState[i] = zStencilStateInfo->getState();
-
             //  Update the flag storing if all the Z Stencil Test units are in END state.  
             endAllZST = endAllZST && (zStencilState[i] == RAST_END);
-
-            //  Delete info object.  
-            delete zStencilStateInfo;
         }
         else
         {
@@ -369,16 +318,10 @@ void cmoCommandProcessor::clock(U64 cycle)
     //  Get color write state.  
     for(i = 0, endAllCW = TRUE; i < numStampUnits; i++)
     {
-        if (colorWriteStateSignal[i]->read(cycle, (DynamicObject *&) colorWriteStateInfo))
+        if (colorWriteStateSignal[i].read(cycle, colorWriteState[i]))
         {
-            //  Store rasterizer state.  
-            colorWriteState[i] = colorWriteStateInfo->getState();
-
             //  Update the flag storing if all the color write units are in END state.  
             endAllCW = endAllCW && (colorWriteState[i] == RAST_END);
-
-            //  Delete info object.  
-            delete colorWriteStateInfo;
         }
         else
         {
@@ -387,15 +330,7 @@ void cmoCommandProcessor::clock(U64 cycle)
     }
 
     //  Get DisplayController state.  
-    if (dacStateSignal->read(cycle, (DynamicObject *&) dacStateInfo))
-    {
-        //  Store rasterizer state.  
-        dacState = dacStateInfo->getState();
-
-        //  Delete info object.  
-        delete dacStateInfo;
-    }
-    else
+    if (!dacStateSignal.read(cycle, dacState))
     {
         CG_ASSERT("Missing state signal from the DisplayController unit.");
     }
@@ -491,13 +426,10 @@ void cmoCommandProcessor::clock(U64 cycle)
                         lastMetaStreamTrans = auxMetaStreamTrans;
 
                         //  Check if validation mode is enabled.
-                        if (enableValidation)
+                        if (validationChecker != NULL)
                         {
-                            //  Clone the MetaStream.
-                            cgoMetaStream *clonedMetaStreamTrans = new cgoMetaStream(auxMetaStreamTrans);
-
-                            //  Add the MetaStream to the log.
-                            agpTransactionLog[nextWriteLog].push_back(clonedMetaStreamTrans);
+                            //  Queue a copy of the MetaStream for the behaviorModel.
+                            validationChecker->submit(new cgoMetaStream(auxMetaStreamTrans));
                         }
                     }
                     else
@@ -553,13 +485,10 @@ void cmoCommandProcessor::clock(U64 cycle)
                     lastMetaStreamTrans = auxMetaStreamTrans;
 
                     //  Check if validation mode is enabled.
-                    if (enableValidation)
+                    if (validationChecker != NULL)
                     {
-                        //  Clone the MetaStream.
-                        cgoMetaStream *clonedMetaStreamTrans = new cgoMetaStream(auxMetaStreamTrans);
-
-                        //  Add the MetaStream to the log.
-                        agpTransactionLog[nextWriteLog].push_back(clonedMetaStreamTrans);
+                        //  Queue a copy of the MetaStream for the behaviorModel.
+                        validationChecker->submit(new cgoMetaStream(auxMetaStreamTrans));
                     }
                 }
                 else
@@ -680,13 +609,10 @@ void cmoCommandProcessor::clock(U64 cycle)
                         lastMetaStreamTrans = auxMetaStreamTrans;
 
                         //  Check if validation mode is enabled.
-                        if (enableValidation)
+                        if (validationChecker != NULL)
                         {
-                            //  Clone the MetaStream.
-                            cgoMetaStream *clonedMetaStreamTrans = new cgoMetaStream(auxMetaStreamTrans);
-
-                            //  Add the MetaStream to the log.
-                            agpTransactionLog[nextWriteLog].push_back(clonedMetaStreamTrans);
+                            //  Queue a copy of the MetaStream for the behaviorModel.
+                            validationChecker->submit(new cgoMetaStream(auxMetaStreamTrans));
                         }
                     }
                     else
@@ -3952,6 +3878,27 @@ void cmoCommandProcessor::processGPURegisterWrite(U64 cycle, GPURegister gpuReg,
 
             break;
 
+        case GPU_STREAM_BASE_VERTEX:
+
+            GPU_DEBUG_BOX(
+                printf("cmoCommandProcessor => Write GPU_STREAM_BASE_VERTEX.\n");
+            )
+
+            //  Set GPU stream base vertex register.
+            state.streamBaseVertex = gpuData.intVal;
+
+            //  Create StreamController command.
+            streamComm = new StreamerCommand(gpuReg, gpuSubReg, gpuData);
+
+            //  Copy cookies from original MetaStream and a new cookie.
+            streamComm->copyParentCookies(*lastMetaStreamTrans);
+            streamComm->addCookie();
+
+            //  Send state change to the StreamController unit.
+            streamCtrlSignal->write(cycle, streamComm);
+
+            break;
+
         case GPU_INDEX_MODE:
 
             GPU_DEBUG_BOX(
@@ -7432,8 +7379,9 @@ void cmoCommandProcessor::processGPUCommand(U64 cycle, GPUCommand gpuComm)
                     processNewTransaction = false;
                 }
                 
-                //  Change to the next agp transaction log.
-                nextWriteLog = (nextWriteLog + 1) & 0x03;
+                //  Mark the end of the batch for the behaviorModel.
+                if (validationChecker != NULL)
+                    validationChecker->endBatch();
             }
 
             break;
@@ -9144,14 +9092,7 @@ void cmoCommandProcessor::saveRegisters()
     out.close();
 }
 
-vector<cgoMetaStream*> &cmoCommandProcessor::getcgoMetaStreamLog()
-{
-    nextReadLog = (nextReadLog + 1) & 0x03;
-    
-    return agpTransactionLog[nextReadLog];
-}
-
-void cmoCommandProcessor::setValidationMode(bool enable)
+void cmoCommandProcessor::setValidationMode(ValidationChecker *checker)
 {
-    enableValidation = enable;
+    validationChecker = checker;
 }
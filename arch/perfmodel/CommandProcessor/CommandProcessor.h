@@ -13,6 +13,7 @@
 #include "GPUType.h"
 #include "support.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "ShaderFetch.h"
 #include "Streamer.h"
@@ -23,6 +24,13 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class StreamerStateInfo;
+class PrimitiveAssemblyStateInfo;
+class ClipperStateInfo;
+class RasterizerStateInfo;
+class ValidationChecker;
+
 
 /**
  *  Command Processor class.
@@ -70,22 +78,22 @@ private:
     Signal** vshFCommSignal;    //  Array of the Shader Command signals to the Vertex Shader (Fetch) Units.  
     Signal** vshDCommSignal;    //  Array of the Shader Command signals to the Vertex Shader (Decode) Units.  
     Signal*  streamCtrlSignal;   //  Control signal to the cmoStreamController.  
-    Signal*  streamStateSignal;  //  State signal from the cmoStreamController.  
+    StateWire<StreamerStateInfo> streamStateSignal;       //  State signal from the cmoStreamController.  
     Signal*  paCommSignal;       //  Command signal to Primitive Assembly.  
-    Signal*  paStateSignal;      //  State signal from Primitive Assembly.  
+    StateWire<PrimitiveAssemblyStateInfo> paStateSignal;  //  State signal from Primitive Assembly.  
     Signal*  clipCommSignal;     //  Command signal to the Clipper.  
-    Signal*  clipStateSignal;    //  State signal from the Clipper.  
+    StateWire<ClipperStateInfo> clipStateSignal;          //  State signal from the Clipper.  
     Signal*  rastCommSignal;     //  Command Processor Signal to the Rasterizer.  
-    Signal*  rastStateSignal;    //  Rasterizer state signal to the Command Processor.  
+    StateWire<RasterizerStateInfo> rastStateSignal;       //  Rasterizer state signal to the Command Processor.  
     Signal** fshFCommandSignal; //  Array of command signals to the Fragment Shader Units (Fetch).  
     Signal** fshDCommandSignal; //  Array of command signals to the Fragment Shader Units (Decode).  
     Signal** tuCommandSignal;   //  Array of command signals to the Texture Units.  
     Signal** zStencilCommSignal;    //  Array of command signals to the Z Stencil Test unit.  
-    Signal** zStencilStateSignal;   //  Array of state signals from the Color Write unit.  
+    StateWire<RasterizerStateInfo> *zStencilStateSignal;  //  Array of state signals from the Color Write unit.  
     Signal** colorWriteCommSignal;  //  Array of command signals to the Color Write unit.  
-    Signal** colorWriteStateSignal; //  Array of state signals from the Color Write unit.  
+    StateWire<RasterizerStateInfo> *colorWriteStateSignal;//  Array of state signals from the Color Write unit.  
     Signal*  dacCommSignal;      //  Command signal to the DisplayController unit.  
-    Signal*  dacStateSignal;     //  State signal from the DisplayController unit.  
+    StateWire<RasterizerStateInfo> dacStateSignal;        //  State signal from the DisplayController unit.  
     Signal*  readMemorySignal;   //  Read signal from the GPU local memoryController.  
     Signal*  writeMemorySignal;  //  Write Signal to the GPU local memoryController.  
     Signal*  mcCommSignal; //* Command signal to the memoryController 
@@ -165,10 +173,7 @@ private:
     gpuStatistics::Statistic &memPreLoadCycles; //  Cycles in memory preload state.  
 
     //  Debug/Validation.
-    bool enableValidation;                          //  Enables the validation mode.  
-    U32 nextReadLog;                             //  Pointer to the next log where to read from.  
-    U32 nextWriteLog;                            //  Pointer to the next log where to write from.  
-    vector<cgoMetaStream*> agpTransactionLog[4];   //  Logs the MetaStreams received.  
+    ValidationChecker *validationChecker;           //  Receives a copy of the MetaStreams received (NULL if validation mode is disabled).  
     
     
     //  Private functions.  
@@ -424,20 +429,12 @@ public:
      
     void saveRegisters();
     
-    /**
-     *
-     *  Get the MetaStream log.
-     *
-     *  @return A reference to the MetaStream log.
-     *
-     */
-     
-    vector<cgoMetaStream*> &getcgoMetaStreamLog();
-
     /** Enable/disable the validation mode in the Command Processor.
-     *  @param enable Boolean value that defines if the validation mode in the Command Processor is set to enabled or disabled.
+     *  In validation mode a copy of every MetaStream received and the end of every batch are queued
+     *  in the validation checker.
+     *  @param checker Pointer to the validation checker.  NULL disables the validation mode.
      */
-    void setValidationMode(bool enable);
+    void setValidationMode(ValidationChecker *checker);
         
 };
 
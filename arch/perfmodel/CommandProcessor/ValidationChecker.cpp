@@ -0,0 +1,651 @@
+/**************************************************************************
+ *
+ * Validation Checker implementation file.
+ *
+ */
+
+#include "ValidationChecker.h"
+#include "bmGpuTop.h"
+#include "MetaStream.h"
+#include "support.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+namespace arch
+{
+
+static const U64 HASH_SEED = 0xCBF29CE484222325ULL;
+static const U64 HASH_PRIME = 0x100000001B3ULL;
+
+//  Multiply-xor hash over 32-bit words.
+static U64 hashWord(U64 h, U32 word)
+{
+    h = (h ^ word) * HASH_PRIME;
+    return h ^ (h >> 29);
+}
+
+static U64 hashBytes(U64 h, const U08 *data, U32 bytes)
+{
+    for(U32 w = 0; w < (bytes >> 2); w++)
+    {
+        U32 word;
+        memcpy(&word, data + (w << 2), 4);
+        h = hashWord(h, word);
+    }
+
+    return h;
+}
+
+//  Returns the bits of a float point value hashed for validation.  All the NaNs and both zeros are
+//  hashed as the same value (the simulator and the behaviorModel compared the attributes as floats).
+static U32 canonicalFloat(F32 f)
+{
+    U32 bits;
+    memcpy(&bits, &f, 4);
+
+    if (((bits & 0x7F800000) == 0x7F800000) && ((bits & 0x007FFFFF) != 0))
+        return 0x7FC00000;
+
+    if (bits == 0x80000000)
+        return 0;
+
+    return bits;
+}
+
+static U64 hashAttributes(Vec4FP32 *attributes)
+{
+    U64 h = HASH_SEED;
+
+    for(U32 a = 0; a < MAX_VERTEX_ATTRIBUTES; a++)
+        for(U32 c = 0; c < 4; c++)
+            h = hashWord(h, canonicalFloat(attributes[a][c]));
+
+    return h;
+}
+
+//  Bytes per pixel stored in the color buffer update log for a render target format.
+static U32 colorBytesPerPixel(TextureFormat format)
+{
+    switch(format)
+    {
+        case GPU_RGBA16:
+        case GPU_RGBA16F:
+            return 8;
+        default:
+            return 4;
+    }
+}
+
+static bool entryLess(const ValidationDigest::VertexEntry &a, const ValidationDigest::VertexEntry &b)
+{
+    return a.vertexID < b.vertexID;
+}
+
+static bool entryLess(const ValidationDigest::QuadEntry &a, const ValidationDigest::QuadEntry &b)
+{
+    return a.fragID < b.fragID;
+}
+
+static U64 hashEntry(U64 h, const ValidationDigest::VertexEntry &e)
+{
+    h = hashWord(h, e.vertexID.instance);
+    h = hashWord(h, e.vertexID.index);
+    h = hashWord(h, U32(e.hash));
+    return hashWord(h, U32(e.hash >> 32));
+}
+
+static U64 hashEntry(U64 h, const ValidationDigest::QuadEntry &e)
+{
+    h = hashWord(h, e.fragID.triangleID);
+    h = hashWord(h, e.fragID.x);
+    h = hashWord(h, e.fragID.y);
+    h = hashWord(h, e.fragID.sample);
+    h = hashWord(h, U32(e.readHash));
+    h = hashWord(h, U32(e.readHash >> 32));
+    h = hashWord(h, U32(e.writeHash));
+    return hashWord(h, U32(e.writeHash >> 32));
+}
+
+//  Sorts the entries of a log keeping the first entry added for an identifier and returns the log hash.
+template <class Entry>
+static U64 closeLog(vector<Entry> &log)
+{
+    auto less = [](const Entry &a, const Entry &b) { return entryLess(a, b); };
+
+    if (!is_sorted(log.begin(), log.end(), less))
+        stable_sort(log.begin(), log.end(), less);
+
+    //  Entries are equal for unique() if they have the same identifier.
+    log.erase(unique(log.begin(), log.end(), [](const Entry &a, const Entry &b) { return !entryLess(a, b) && !entryLess(b, a); }), log.end());
+
+    U64 h = hashWord(HASH_SEED, U32(log.size()));
+
+    for(U32 e = 0; e < log.size(); e++)
+        h = hashEntry(h, log[e]);
+
+    return h;
+}
+
+ValidationDigest::ValidationDigest() :
+    vertexInputHash(0), shadedVertexHash(0), zStencilUpdateHash(0)
+{
+    for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+    {
+        colorBytesPixel[rt] = 4;
+        colorUpdateHash[rt] = 0;
+    }
+}
+
+void ValidationDigest::addVertexInputs(VertexInputMap &log)
+{
+    for(VertexInputMap::iterator it = log.begin(); it != log.end(); it++)
+    {
+        VertexEntry entry;
+        entry.vertexID = it->first;
+        entry.hash = hashAttributes(it->second.attributes);
+        vertexInput.push_back(entry);
+    }
+}
+
+void ValidationDigest::addShadedVertices(ShadedVertexMap &log)
+{
+    for(ShadedVertexMap::iterator it = log.begin(); it != log.end(); it++)
+    {
+        VertexEntry entry;
+        entry.vertexID = it->first;
+        entry.hash = hashAttributes(it->second.attributes);
+        shadedVertex.push_back(entry);
+    }
+}
+
+void ValidationDigest::addZStencilUpdates(FragmentQuadMemoryUpdateMap &log)
+{
+    //  Z stencil buffer uses 32-bit pixels.
+    U32 bytes = 4 * STAMP_FRAGMENTS;
+
+    for(FragmentQuadMemoryUpdateMap::iterator it = log.begin(); it != log.end(); it++)
+    {
+        QuadEntry entry;
+        entry.fragID = it->first;
+        entry.readHash = hashBytes(HASH_SEED, it->second.readData, bytes);
+        entry.writeHash = hashBytes(HASH_SEED, it->second.writeData, bytes);
+        zStencilUpdate.push_back(entry);
+    }
+}
+
+void ValidationDigest::addColorUpdates(U32 rt, FragmentQuadMemoryUpdateMap &log, U32 bytesPixel)
+{
+    U32 bytes = bytesPixel * STAMP_FRAGMENTS;
+
+    colorBytesPixel[rt] = bytesPixel;
+
+    for(FragmentQuadMemoryUpdateMap::iterator it = log.begin(); it != log.end(); it++)
+    {
+        QuadEntry entry;
+        entry.fragID = it->first;
+        entry.readHash = hashBytes(HASH_SEED, it->second.readData, bytes);
+        entry.writeHash = hashBytes(HASH_SEED, it->second.writeData, bytes);
+        colorUpdate[rt].push_back(entry);
+    }
+}
+
+void ValidationDigest::close()
+{
+    vertexInputHash = closeLog(vertexInput);
+    shadedVertexHash = closeLog(shadedVertex);
+    zStencilUpdateHash = closeLog(zStencilUpdate);
+
+    for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+        colorUpdateHash[rt] = closeLog(colorUpdate[rt]);
+}
+
+//  Waits after a failed queue operation.  Yields for a few retries and then sleeps.
+static void backoff(U32 &retries)
+{
+    if (retries < 64)
+        this_thread::yield();
+    else
+        this_thread::sleep_for(chrono::microseconds(50));
+
+    retries++;
+}
+
+ValidationChecker::ValidationChecker(bmoGpuTop &bmGpu) :
+    bmGpu(bmGpu), streams(STREAM_QUEUE_SIZE), digests(DIGEST_QUEUE_SIZE),
+    submitted(0), processed(0), stopWorker(false), workerFailed(false)
+{
+    //  The validation thread creates and destroys dynamic objects.
+    DynamicMemoryOpt::beginConcurrentAccess();
+
+    worker = thread(&ValidationChecker::workerLoop, this);
+}
+
+ValidationChecker::~ValidationChecker()
+{
+    stopWorker.store(true, memory_order_release);
+
+    if (worker.joinable())
+        worker.join();
+
+    DynamicMemoryOpt::endConcurrentAccess();
+
+    //  Discard the MetaStreams and digests not consumed.
+    cgoMetaStream *stream;
+    while(streams.pop(stream))
+        delete stream;
+
+    ValidationDigest *digest;
+    while(digests.pop(digest))
+        delete digest;
+}
+
+void ValidationChecker::workerLoop()
+{
+    U32 retries = 0;
+
+    try
+    {
+        while(!stopWorker.load(memory_order_acquire))
+        {
+            cgoMetaStream *stream;
+
+            if (!streams.pop(stream))
+            {
+                backoff(retries);
+                continue;
+            }
+
+            retries = 0;
+
+            if (stream != NULL)
+            {
+                //  The behaviorModel takes ownership of the MetaStream.
+                bmGpu.emulateCommandProcessor(stream);
+            }
+            else
+            {
+                //  End of batch.  Reduce the behaviorModel logs to a digest.
+                ValidationDigest *digest = new ValidationDigest;
+                buildReference(*digest);
+
+                while(!digests.push(digest) && !stopWorker.load(memory_order_acquire))
+                    backoff(retries);
+
+                retries = 0;
+            }
+
+            processed.fetch_add(1, memory_order_release);
+        }
+    }
+    catch(...)
+    {
+        //  The error was reported by the behaviorModel.
+        workerFailed.store(true, memory_order_release);
+    }
+}
+
+void ValidationChecker::buildReference(ValidationDigest &digest)
+{
+    //  The logs are moved to the digest for the field by field comparison, leaving them empty.
+    digest.addVertexInputs(bmGpu.getVertexInputLog());
+    digest.vertexInputLog.swap(bmGpu.getVertexInputLog());
+
+    digest.addShadedVertices(bmGpu.getShadedVertexLog());
+    digest.shadedVertexLog.swap(bmGpu.getShadedVertexLog());
+
+    digest.addZStencilUpdates(bmGpu.getZStencilUpdateMap());
+    digest.zStencilUpdateLog.swap(bmGpu.getZStencilUpdateMap());
+
+    for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+    {
+        digest.addColorUpdates(rt, bmGpu.getColorUpdateMap(rt), colorBytesPerPixel(bmGpu.getRenderTargetFormat(rt)));
+        digest.colorUpdateLog[rt].swap(bmGpu.getColorUpdateMap(rt));
+    }
+
+    digest.close();
+}
+
+void ValidationChecker::queueEntry(cgoMetaStream *stream)
+{
+    U32 retries = 0;
+
+    while(!streams.push(stream))
+    {
+        CG_ASSERT_COND(!workerFailed.load(memory_order_acquire), "Behavior model emulation failed in the validation thread.");
+        backoff(retries);
+    }
+
+    submitted++;
+}
+
+void ValidationChecker::submit(cgoMetaStream *stream)
+{
+    queueEntry(stream);
+}
+
+void ValidationChecker::endBatch()
+{
+    queueEntry(NULL);
+}
+
+ValidationDigest *ValidationChecker::getReference()
+{
+    U32 retries = 0;
+    ValidationDigest *digest;
+
+    while(!digests.pop(digest))
+    {
+        CG_ASSERT_COND(!workerFailed.load(memory_order_acquire), "Behavior model emulation failed in the validation thread.");
+
+        //  All the queued entries were processed and no digest is available: no batch end was queued.
+        if (processed.load(memory_order_acquire) == submitted)
+            return digests.pop(digest) ? digest : NULL;
+
+        backoff(retries);
+    }
+
+    return digest;
+}
+
+void ValidationChecker::synchronize()
+{
+    U32 retries = 0;
+
+    while(processed.load(memory_order_acquire) != submitted)
+    {
+        CG_ASSERT_COND(!workerFailed.load(memory_order_acquire), "Behavior model emulation failed in the validation thread.");
+        backoff(retries);
+    }
+}
+
+static bool sameData(const ValidationDigest::VertexEntry &emu, const ValidationDigest::VertexEntry &sim, const char *&difference)
+{
+    difference = "attributes are different";
+    return (emu.hash == sim.hash);
+}
+
+static bool sameData(const ValidationDigest::QuadEntry &emu, const ValidationDigest::QuadEntry &sim, const char *&difference)
+{
+    bool sameRead = (emu.readHash == sim.readHash);
+    bool sameWrite = (emu.writeHash == sim.writeHash);
+
+    if (!sameRead && !sameWrite)
+        difference = "read and write data are different";
+    else if (!sameRead)
+        difference = "read data is different";
+    else
+        difference = "write data is different";
+
+    return sameRead && sameWrite;
+}
+
+static void printEntry(U32 batch, const char *logName, const ValidationDigest::VertexEntry &entry, const char *difference)
+{
+    printf("Validation => Batch %d first difference in the %s log at vertex instance %d index %d: %s.\n",
+        batch, logName, entry.vertexID.instance, entry.vertexID.index, difference);
+}
+
+static void printEntry(U32 batch, const char *logName, const ValidationDigest::QuadEntry &entry, const char *difference)
+{
+    printf("Validation => Batch %d first difference in the %s log at quad (%d, %d) triangle %d: %s.\n",
+        batch, logName, entry.fragID.x, entry.fragID.y, entry.fragID.triangleID, difference);
+}
+
+//  Walks the two sorted logs and reports the first difference and the number of differences.
+template <class Entry>
+static bool compareLog(U32 batch, const char *logName, const vector<Entry> &emu, U64 emuHash, const vector<Entry> &sim, U64 simHash)
+{
+    if ((emuHash == simHash) && (emu.size() == sim.size()))
+        return true;
+
+    U32 differences = 0;
+    U32 e = 0;
+    U32 s = 0;
+
+    while((e < emu.size()) || (s < sim.size()))
+    {
+        const char *difference;
+
+        if ((s == sim.size()) || ((e < emu.size()) && entryLess(emu[e], sim[s])))
+        {
+            if (differences == 0)
+                printEntry(batch, logName, emu[e], "not found in the simulator log");
+
+            differences++;
+            e++;
+        }
+        else if ((e == emu.size()) || entryLess(sim[s], emu[e]))
+        {
+            if (differences == 0)
+                printEntry(batch, logName, sim[s], "not found in the behaviorModel log");
+
+            differences++;
+            s++;
+        }
+        else
+        {
+            if (!sameData(emu[e], sim[s], difference))
+            {
+                if (differences == 0)
+                    printEntry(batch, logName, emu[e], difference);
+
+                differences++;
+            }
+
+            e++;
+            s++;
+        }
+    }
+
+    printf("Validation => Batch %d %s log differs: behaviorModel %d entries, simulator %d entries, %d different.\n",
+        batch, logName, U32(emu.size()), U32(sim.size()), differences);
+
+    return false;
+}
+
+bool ValidationChecker::compare(U32 batch, const ValidationDigest &emu, const ValidationDigest &sim)
+{
+    bool equal = true;
+
+    equal = compareLog(batch, "read vertex", emu.vertexInput, emu.vertexInputHash, sim.vertexInput, sim.vertexInputHash) && equal;
+    equal = compareLog(batch, "shaded vertex", emu.shadedVertex, emu.shadedVertexHash, sim.shadedVertex, sim.shadedVertexHash) && equal;
+    equal = compareLog(batch, "z stencil update", emu.zStencilUpdate, emu.zStencilUpdateHash, sim.zStencilUpdate, sim.zStencilUpdateHash) && equal;
+
+    for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+    {
+        char logName[64];
+        sprintf(logName, "render target %d color update", rt);
+
+        equal = compareLog(batch, logName, emu.colorUpdate[rt], emu.colorUpdateHash[rt], sim.colorUpdate[rt], sim.colorUpdateHash[rt]) && equal;
+    }
+
+    return equal;
+}
+
+//  Maximum number of differences reported per log by the field by field comparison.
+static const U32 MAX_REPORTED_DIFFERENCES = 30;
+
+static void printAttribute(const char *source, U32 a, Vec4FP32 attrib)
+{
+    U32 bits[4];
+
+    for(U32 c = 0; c < 4; c++)
+        memcpy(&bits[c], &attrib[c], 4);
+
+    printf("   %sAttrib[%d] = {%f, %f, %f, %f} | (%08x, %08x, %08x, %08x)\n", source, a,
+        attrib[0], attrib[1], attrib[2], attrib[3], bits[0], bits[1], bits[2], bits[3]);
+}
+
+//  Compares the attributes of the vertices in a read or shaded vertex log.
+template <class Log>
+static void compareVertexFields(U32 batch, const char *logName, const Log &emu, const Log &sim)
+{
+    U32 differences = 0;
+
+    for(typename Log::const_iterator itEmu = emu.begin(); (itEmu != emu.end()) && (differences < MAX_REPORTED_DIFFERENCES); itEmu++)
+    {
+        typename Log::const_iterator itSim = sim.find(itEmu->first);
+
+        if (itSim == sim.end())
+        {
+            printf("Validation => Batch %d instance %d index %d was not found in the simulator %s log.\n",
+                batch, itEmu->first.instance, itEmu->first.index, logName);
+
+            differences++;
+            continue;
+        }
+
+        for(U32 a = 0; a < MAX_VERTEX_ATTRIBUTES; a++)
+        {
+            Vec4FP32 emuAttrib = itEmu->second.attributes[a];
+            Vec4FP32 simAttrib = itSim->second.attributes[a];
+
+            bool attributeIsEqual = true;
+
+            for(U32 c = 0; c < 4; c++)
+                attributeIsEqual = attributeIsEqual && (canonicalFloat(emuAttrib[c]) == canonicalFloat(simAttrib[c]));
+
+            if (!attributeIsEqual)
+            {
+                printf("Validation => Batch %d for %s at instance %d index %d attribute %d is different:\n",
+                    batch, logName, itEmu->first.instance, itEmu->first.index, a);
+                printAttribute("emu", a, emuAttrib);
+                printAttribute("sim", a, simAttrib);
+
+                differences++;
+            }
+        }
+    }
+
+    for(typename Log::const_iterator itSim = sim.begin(); (itSim != sim.end()) && (differences < MAX_REPORTED_DIFFERENCES); itSim++)
+    {
+        if (emu.find(itSim->first) == emu.end())
+        {
+            printf("Validation => Batch %d instance %d index %d was not found in the behaviorModel %s log.\n",
+                batch, itSim->first.instance, itSim->first.index, logName);
+
+            differences++;
+        }
+    }
+}
+
+static void printQuadData(const char *name, const U08 *data, U32 bytes)
+{
+    printf("    %s : ", name);
+
+    for(U32 dw = 0; dw < (bytes >> 2); dw++)
+    {
+        U32 word;
+        memcpy(&word, data + (dw << 2), 4);
+        printf("  %08x", word);
+    }
+
+    printf("\n");
+}
+
+static void printQuadUpdate(const char *source, const FragmentQuadMemoryUpdateInfo &update, U32 bytesPixel)
+{
+    U32 bytes = bytesPixel * STAMP_FRAGMENTS;
+
+    printf("  %s Update : \n", source);
+    printQuadData("Read Data", update.readData, bytes);
+    printQuadData("Input Data", update.inData, bytes);
+    printQuadData("Write Data", update.writeData, bytes);
+
+    printf("    Write Mask : ");
+    for(U32 b = 0; b < bytes; b++)
+        printf(" %c", update.writeMask[b] ? 'W' : '_');
+    printf("\n");
+
+    printf("    Cull Mask : ");
+    for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+        printf(" %c", update.cullMask[f] ? 'T' : 'F');
+    printf("\n");
+}
+
+//  Compares the data read and written by the quads in a z stencil or color update log.
+static void compareQuadFields(U32 batch, const char *logName, const FragmentQuadMemoryUpdateMap &emu,
+                              const FragmentQuadMemoryUpdateMap &sim, U32 bytesPixel)
+{
+    U32 bytes = bytesPixel * STAMP_FRAGMENTS;
+    U32 differences = 0;
+
+    FragmentQuadMemoryUpdateMap::const_iterator itEmu;
+
+    for(itEmu = emu.begin(); (itEmu != emu.end()) && (differences < MAX_REPORTED_DIFFERENCES); itEmu++)
+    {
+        FragmentQuadMemoryUpdateMap::const_iterator itSim = sim.find(itEmu->first);
+
+        if (itSim == sim.end())
+        {
+            printf("Validation => Batch %d %s on quad at (%d, %d) triangle %d not found in the simulator log.\n",
+                batch, logName, itEmu->first.x, itEmu->first.y, itEmu->first.triangleID);
+
+            differences++;
+            continue;
+        }
+
+        bool diffInReadData = (memcmp(itEmu->second.readData, itSim->second.readData, bytes) != 0);
+        bool diffInWriteData = (memcmp(itEmu->second.writeData, itSim->second.writeData, bytes) != 0);
+
+        if (diffInReadData)
+            printf("Validation => Batch %d difference found in %s read data on quad at (%d, %d) triangle %d\n",
+                batch, logName, itEmu->first.x, itEmu->first.y, itEmu->first.triangleID);
+
+        if (diffInWriteData)
+            printf("Validation => Batch %d difference found in %s write data on quad at (%d, %d) triangle %d\n",
+                batch, logName, itEmu->first.x, itEmu->first.y, itEmu->first.triangleID);
+
+        if (diffInReadData || diffInWriteData)
+        {
+            printQuadUpdate("Behavior Model", itEmu->second, bytesPixel);
+            printQuadUpdate("Simulator", itSim->second, bytesPixel);
+
+            differences++;
+        }
+    }
+
+    FragmentQuadMemoryUpdateMap::const_iterator itSim;
+
+    for(itSim = sim.begin(); (itSim != sim.end()) && (differences < MAX_REPORTED_DIFFERENCES); itSim++)
+    {
+        if (emu.find(itSim->first) == emu.end())
+        {
+            printf("Validation => Batch %d %s on quad at (%d, %d) triangle %d not found in the behaviorModel log.\n",
+                batch, logName, itSim->first.x, itSim->first.y, itSim->first.triangleID);
+
+            differences++;
+        }
+    }
+}
+
+void ValidationChecker::compareFields(U32 batch, const ValidationDigest &emu, const ValidationDigest &sim)
+{
+    //  The log hashes include the number of entries.
+    if (emu.vertexInputHash != sim.vertexInputHash)
+        compareVertexFields(batch, "read vertex", emu.vertexInputLog, sim.vertexInputLog);
+
+    if (emu.shadedVertexHash != sim.shadedVertexHash)
+        compareVertexFields(batch, "shaded vertex", emu.shadedVertexLog, sim.shadedVertexLog);
+
+    if (emu.zStencilUpdateHash != sim.zStencilUpdateHash)
+        compareQuadFields(batch, "z stencil update", emu.zStencilUpdateLog, sim.zStencilUpdateLog, 4);
+
+    for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+    {
+        if (emu.colorUpdateHash[rt] != sim.colorUpdateHash[rt])
+        {
+            char logName[64];
+            sprintf(logName, "render target %d color update", rt);
+
+            compareQuadFields(batch, logName, emu.colorUpdateLog[rt], sim.colorUpdateLog[rt], emu.colorBytesPixel[rt]);
+        }
+    }
+}
+
+} // namespace arch
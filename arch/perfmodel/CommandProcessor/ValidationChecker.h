@@ -0,0 +1,245 @@
+/**************************************************************************
+ *
+ * Validation Checker definition file.
+ *  This file defines the classes used to validate the simulator against the
+ *  behaviorModel running concurrently in a separate thread.
+ *
+ *  The Command Processor queues a copy of every MetaStream it receives and a
+ *  batch end mark for every draw call.  A worker thread emulates the MetaStreams
+ *  in the behaviorModel and, at every batch end mark, reduces the behaviorModel
+ *  validation logs of the batch to a digest (a 64-bit hash per read vertex,
+ *  shaded vertex and quad memory update) and clears the logs.  When the simulator
+ *  finishes the batch its own logs are reduced to a digest and both digests are
+ *  compared.  The behaviorModel logs of a batch are moved to its digest, when
+ *  the digests differ the logs are compared field by field to report the
+ *  attributes and pixel data that differ.
+ *
+ */
+
+#ifndef __VALIDATIONCHECKER_H__
+#define __VALIDATIONCHECKER_H__
+
+#include "GPUType.h"
+#include "GPUReg.h"
+#include "ValidationInfo.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+
+namespace arch
+{
+
+class cgoMetaStream;
+class bmoGpuTop;
+
+/**
+ *  Bounded single producer single consumer queue.
+ *  Lock free ring used to pass objects between the simulator thread and the validation thread.
+ *  Only one thread can push and only one thread can pop.
+ */
+template <class T>
+class ValidationQueue
+{
+private:
+
+    std::vector<T> ring;            //  Queue storage.
+    U64 capacity;                   //  Number of entries in the ring.
+    std::atomic<U64> head;          //  Number of entries popped (written by the consumer).
+    std::atomic<U64> tail;          //  Number of entries pushed (written by the producer).
+
+public:
+
+    ValidationQueue(U32 capacity) : ring(capacity), capacity(capacity), head(0), tail(0)
+    {
+    }
+
+    /**
+     *  Adds an entry at the tail of the queue.
+     *  @return false if the queue is full.
+     */
+    bool push(const T &entry)
+    {
+        U64 t = tail.load(std::memory_order_relaxed);
+
+        if ((t - head.load(std::memory_order_acquire)) == capacity)
+            return false;
+
+        ring[t % capacity] = entry;
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     *  Removes the entry at the head of the queue.
+     *  @return false if the queue is empty.
+     */
+    bool pop(T &entry)
+    {
+        U64 h = head.load(std::memory_order_relaxed);
+
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+
+        entry = ring[h % capacity];
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    }
+};
+
+/**
+ *  Digest of the validation logs of a batch.
+ *  Stores a hash of every logged vertex and quad memory update, sorted by vertex or fragment
+ *  identifier, and a hash of every log.  Logs from multiple units can be added before closing
+ *  the digest, the first entry added for an identifier is kept.  The full logs are only stored
+ *  for the field by field comparison of the batches with a different digest.
+ */
+class ValidationDigest
+{
+public:
+
+    //  Hash of the attributes of a read or shaded vertex.
+    struct VertexEntry
+    {
+        VertexID vertexID;
+        U64 hash;
+    };
+
+    //  Hashes of the data read and written by a quad memory update.
+    struct QuadEntry
+    {
+        FragmentID fragID;
+        U64 readHash;
+        U64 writeHash;
+    };
+
+    std::vector<VertexEntry> vertexInput;                   //  Read vertices.
+    std::vector<VertexEntry> shadedVertex;                  //  Shaded vertices.
+    std::vector<QuadEntry> zStencilUpdate;                  //  Z stencil buffer updates.
+    std::vector<QuadEntry> colorUpdate[MAX_RENDER_TARGETS]; //  Color buffer updates per render target.
+    U32 colorBytesPixel[MAX_RENDER_TARGETS];                //  Bytes per pixel hashed for the render target updates.
+
+    U64 vertexInputHash;                        //  Hash of the read vertex log.
+    U64 shadedVertexHash;                       //  Hash of the shaded vertex log.
+    U64 zStencilUpdateHash;                     //  Hash of the z stencil buffer update log.
+    U64 colorUpdateHash[MAX_RENDER_TARGETS];    //  Hash of the color buffer update logs.
+
+    VertexInputMap vertexInputLog;                                  //  Read vertex log.
+    ShadedVertexMap shadedVertexLog;                                //  Shaded vertex log.
+    FragmentQuadMemoryUpdateMap zStencilUpdateLog;                  //  Z stencil buffer update log.
+    FragmentQuadMemoryUpdateMap colorUpdateLog[MAX_RENDER_TARGETS]; //  Color buffer update logs per render target.
+
+    ValidationDigest();
+
+    /**
+     *  Adds the entries of a read vertex log.
+     */
+    void addVertexInputs(VertexInputMap &log);
+
+    /**
+     *  Adds the entries of a shaded vertex log.
+     */
+    void addShadedVertices(ShadedVertexMap &log);
+
+    /**
+     *  Adds the entries of a z stencil buffer update log.
+     */
+    void addZStencilUpdates(FragmentQuadMemoryUpdateMap &log);
+
+    /**
+     *  Adds the entries of a color buffer update log.
+     *  @param rt Render target.
+     *  @param bytesPixel Bytes per pixel of the render target format.
+     */
+    void addColorUpdates(U32 rt, FragmentQuadMemoryUpdateMap &log, U32 bytesPixel);
+
+    /**
+     *  Sorts the entries, removes duplicated identifiers and computes the log hashes.
+     */
+    void close();
+};
+
+/**
+ *  Concurrent validation checker.
+ *  Owns the thread that emulates the MetaStreams received by the simulator in the behaviorModel.
+ *
+ *  submit() and endBatch() are called by the Command Processor, getReference() and synchronize()
+ *  by the simulator loop.  The behaviorModel must not be accessed from the simulator thread
+ *  without calling synchronize() first.
+ */
+class ValidationChecker
+{
+private:
+
+    static const U32 STREAM_QUEUE_SIZE = 16384;     //  MetaStreams and batch end marks queued for the validation thread.
+    static const U32 DIGEST_QUEUE_SIZE = 256;       //  Batch digests waiting for the simulator.
+
+    bmoGpuTop &bmGpu;                               //  Behavior model driven by the validation thread.
+    ValidationQueue<cgoMetaStream *> streams;       //  MetaStreams to emulate.  NULL marks the end of a batch.
+    ValidationQueue<ValidationDigest *> digests;    //  Behavior model digests of the emulated batches.
+    U64 submitted;                                  //  Entries queued by the simulator thread.
+    std::atomic<U64> processed;                     //  Entries processed by the validation thread.
+    std::atomic<bool> stopWorker;                   //  Stop the validation thread.
+    std::atomic<bool> workerFailed;                 //  The behaviorModel failed in the validation thread.
+    std::thread worker;                             //  Validation thread.
+
+    ValidationChecker(const ValidationChecker &);
+    ValidationChecker &operator=(const ValidationChecker &);
+
+    void workerLoop();
+    void buildReference(ValidationDigest &digest);
+    void queueEntry(cgoMetaStream *stream);
+
+public:
+
+    /**
+     *  Creates the validation checker and starts the validation thread.
+     *  @param bmGpu Behavior model used as reference.  Owned by the thread until the checker is destroyed.
+     */
+    ValidationChecker(bmoGpuTop &bmGpu);
+
+    /**
+     *  Stops the validation thread.  MetaStreams not yet emulated are discarded.
+     */
+    ~ValidationChecker();
+
+    /**
+     *  Queues a MetaStream for emulation.  The behaviorModel takes ownership of the MetaStream.
+     */
+    void submit(cgoMetaStream *stream);
+
+    /**
+     *  Queues the end of the current batch.
+     */
+    void endBatch();
+
+    /**
+     *  Waits for the behaviorModel digest of the next batch.
+     *  @return The digest (owned by the caller) or NULL if no batch end was queued.
+     */
+    ValidationDigest *getReference();
+
+    /**
+     *  Waits until all the queued MetaStreams have been emulated.
+     */
+    void synchronize();
+
+    /**
+     *  Compares the behaviorModel and simulator digests of a batch.
+     *  Reports the first difference found in each log.
+     *  @return true if the digests are equal.
+     */
+    static bool compare(U32 batch, const ValidationDigest &emu, const ValidationDigest &sim);
+
+    /**
+     *  Compares the full logs stored in the digests field by field.  Called when the digests
+     *  of a batch differ to report the attributes and the pixel data that are different.
+     */
+    static void compareFields(U32 batch, const ValidationDigest &emu, const ValidationDigest &sim);
+};
+
+} // namespace arch
+
+#endif
@@ -52,7 +52,6 @@ cmoDisplayController::cmoDisplayController(U32 overWidth, U32 overHeight, U32 sc
     bltTransImpl(*this), cmoMduBase(name, parent)
 
 {
-    DynamicObject *defaultState[1];
     U32 i;
 
     //  Check parameters.  
@@ -105,11 +104,8 @@ cmoDisplayController::cmoDisplayController(U32 overWidth, U32 overHeight, U32 sc
     //  Create state signal to Command Processor.  
     dacState = newOutputSignal("DACState", 1, 1, NULL);
 
-    //  Create default signal value.  
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default signal value.  
-    dacState->setData(defaultState);
+    dacState.setInitial(RAST_RESET);
 
     //  Create signals with Memory Controller mdu.  
 
@@ -707,7 +703,7 @@ void cmoDisplayController::clock(U64 cycle)
     }
 
     //  Send current state to the Command Processor.  
-    dacState->write(cycle, new RasterizerStateInfo(state));
+    dacState.write(cycle, state);
 
     //  Do not go to END state in unsynched mode, just send the state to Command Processor.  
     if (!synchedRefresh && (state == RAST_END))
@@ -9,6 +9,7 @@
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "RasterizerState.h"
 #include "RasterizerCommand.h"
@@ -26,6 +27,9 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class RasterizerStateInfo;
+
 
 /**
  *
@@ -63,7 +67,7 @@ private:
 
     //  cmoDisplayController signals.  
     Signal *dacCommand;         //  Command signal from the Command Processor.  
-    Signal *dacState;           //  State signal to the Command Processor.  
+    StateWire<RasterizerStateInfo> dacState;    //  State signal to the Command Processor.  
     Signal *memoryRequest;      //  Request signal to the Memory Controller.  
     Signal *memoryData;         //  Data signal from the Memory Controller.  
     Signal **blockStateCW;      //  Array of signal from the Color Write units with the information about the color buffer block states (compressed, cleared, ...).  
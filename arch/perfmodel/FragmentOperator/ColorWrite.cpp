@@ -1830,8 +1830,8 @@ void ColorWrite::processStamp()
             blendQueue[freeBlend].mask[i * bytesPixel + 2] = writeB;
             blendQueue[freeBlend].mask[i * bytesPixel + 3] = writeA;
 
-            //  Delete fragment attributes.  
-            delete[] attrib;
+            //  Release fragment attributes.  
+            FragmentInput::releaseAttributes(attrib);
 
             //  Delete the fragment in the behaviorModel.  
             delete fr;
@@ -1871,8 +1871,8 @@ void ColorWrite::processStamp()
             //  Check if there is a fragment before deleting it.  
             if (fr != NULL)
             {
-                //  Delete fragment attributes.  
-                delete[] attrib;
+                //  Release fragment attributes.  
+                FragmentInput::releaseAttributes(attrib);
 
                 //  Delete the fragment in the behaviorModel.  
                 delete fr;
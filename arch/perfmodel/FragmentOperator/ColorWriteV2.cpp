@@ -50,7 +50,6 @@ cmoColorWriter::cmoColorWriter(U32 numStamps, U32 overWidth, U32 overHeight,
         "ColorWrite", "CW", name, prefix, parent)
 
 {
-    DynamicObject *defaultState[1];
     U32 i;
     char fullName[64];
     char postfix[32];
@@ -94,11 +93,8 @@ cmoColorWriter::cmoColorWriter(U32 numStamps, U32 overWidth, U32 overHeight,
     //  Create state signal to the main Rasterizer mdu.
     rastState = newOutputSignal("ColorWriteRasterizerState", 1, 1, prefix);
 
-    //  Create default signal value.
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default signal value.
-    rastState->setData(defaultState);
+    rastState.setInitial(RAST_RESET);
 
 
     //  Create signals with fragment producer stage.
@@ -109,11 +105,8 @@ cmoColorWriter::cmoColorWriter(U32 numStamps, U32 overWidth, U32 overHeight,
     //  Create state signal to the producer stage (Fragment FIFO mdu).
     ropStateSignal = newOutputSignal("ColorWriteFFIFOState", 1, 1, prefix);
 
-    //  Create default signal value.  
-    defaultState[0] = new ROPStatusInfo(ROP_READY);
-
-    //  Set default signal value.  
-    ropStateSignal->setData(defaultState);
+    //  Set default signal value.
+    ropStateSignal.setInitial(ROP_READY);
 
     //  Color Write has no output to a consumer stage.  Set output fragment signal
     //  and consumer state signals to NULL;
@@ -307,19 +300,26 @@ void cmoColorWriter::reset()
     rtAddress[0] = backBuffer;
     activeBuffer[0] = true;
     numActiveBuffers = 1;
+
+    //  Select the stamp kernels for the reset state.
+    setupStampKernels();
 }
 
 void cmoColorWriter::operateStamp(U64 cycle, ROPQueue *stamp)
 {
     Fragment *fr;
     Vec4FP32 *attrib;
-    Vec4FP32 destColorQF[STAMP_FRAGMENTS * MAX_MSAA_SAMPLES * MAX_RENDER_TARGETS];
-    Vec4FP32 inputColorQF[STAMP_FRAGMENTS * MAX_MSAA_SAMPLES * MAX_RENDER_TARGETS];
+    ROPColorStamp destColor[MAX_RENDER_TARGETS];
+    ROPColorStamp inputColor[MAX_RENDER_TARGETS];
+    bool covered[MAX_STAMP_PIXELS];
 
     bool traceFragmentMatch = false;
 
-    //  Get input color from fragments
-    //  Get the input depth data from the fragments.
+    //  Compute the number of pixels (fragments or samples) per render target in the stamp.
+    U32 stampSamples = multisampling ? msaaSamples : 1;
+    U32 pixels = STAMP_FRAGMENTS * stampSamples;
+
+    //  Get input color and coverage from fragments.
     for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
     {
         //  Get fragment attributes.
@@ -348,242 +348,85 @@ void cmoColorWriter::operateStamp(U64 cycle, ROPQueue *stamp)
         GPU_DEBUG_BOX(
             printf("%s (%lld) => Pixel (%d, %d)\n", getName(), cycle, fr->getX(), fr->getY());
         )
-        
-        //  Check if multisampling is enabled.
+
+        //  Get the coverage for the fragment samples.
         if (!multisampling)
+            covered[f] = !stamp->culled[f];
+        else
         {
-            //  For all render targets.
-            for(U32 rt = 0, activeRT = 0; activeRT < numActiveBuffers; rt++, activeRT++)
-            {
-                //  Search for the next active render target.
-                for(; (!activeBuffer[rt]) && (rt < MAX_RENDER_TARGETS); rt++);
-                
-                CG_ASSERT_COND(!(rt == MAX_RENDER_TARGETS), "Expected an active render target.");                
-                if (traceFragmentMatch)
-                {
-                    printf("%s => Pixel (%d, %d) triangle ID %d color before clamping {%f, %f, %f, %f}\n", getName(),
-                        stamp->stamp[f]->getFragment()->getX(), stamp->stamp[f]->getFragment()->getY(), stamp->stamp[f]->getTriangleID(),
-                        attrib[COLOR_ATTRIBUTE + rt][0], attrib[COLOR_ATTRIBUTE + rt][1],
-                        attrib[COLOR_ATTRIBUTE + rt][2], attrib[COLOR_ATTRIBUTE + rt][3]);
-                }
+            //  Get sample coverage mask for the fragment.
+            bool *sampleCoverage = fr->getMSAACoverage();
 
-                //  Get fragment input color from color attribute.
-                if (rtFormat[rt] == GPU_RGBA8888)
-                {
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][0] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][0], 0.0f, 1.0f);
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][1] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][1], 0.0f, 1.0f);
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][2] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][2], 0.0f, 1.0f);
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][3] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][3], 0.0f, 1.0f);
-                }
-                else
-                {
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][0] = attrib[COLOR_ATTRIBUTE + rt][0];
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][1] = attrib[COLOR_ATTRIBUTE + rt][1];
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][2] = attrib[COLOR_ATTRIBUTE + rt][2];
-                    inputColorQF[rt * STAMP_FRAGMENTS + f][3] = attrib[COLOR_ATTRIBUTE + rt][3];
-                }
+            for(U32 s = 0; s < msaaSamples; s++)
+                covered[f * msaaSamples + s] = sampleCoverage[s];
+        }
 
-                if (traceFragmentMatch)
-                {
-                    printf("%s => Pixel (%d, %d) triangle ID %d color after clamping {%f, %f, %f, %f}\n", getName(),
-                        stamp->stamp[f]->getFragment()->getX(), stamp->stamp[f]->getFragment()->getY(), stamp->stamp[f]->getTriangleID(),
-                        inputColorQF[rt * STAMP_FRAGMENTS + f][0], inputColorQF[rt * STAMP_FRAGMENTS + f][1],
-                        inputColorQF[rt * STAMP_FRAGMENTS + f][2], inputColorQF[rt * STAMP_FRAGMENTS + f][3]);
-                }
+        //  For all render targets.
+        for(U32 rt = 0, activeRT = 0; activeRT < numActiveBuffers; rt++, activeRT++)
+        {
+            //  Search for the next active render target.
+            for(; (!activeBuffer[rt]) && (rt < MAX_RENDER_TARGETS); rt++);
+            
+            CG_ASSERT_COND(!(rt == MAX_RENDER_TARGETS), "Expected an active render target.");                
+            if (traceFragmentMatch)
+            {
+                printf("%s => Pixel (%d, %d) triangle ID %d color before clamping {%f, %f, %f, %f}\n", getName(),
+                    stamp->stamp[f]->getFragment()->getX(), stamp->stamp[f]->getFragment()->getY(), stamp->stamp[f]->getTriangleID(),
+                    attrib[COLOR_ATTRIBUTE + rt][0], attrib[COLOR_ATTRIBUTE + rt][1],
+                    attrib[COLOR_ATTRIBUTE + rt][2], attrib[COLOR_ATTRIBUTE + rt][3]);
+            }
 
-                GPU_DEBUG_BOX(
-                    printf("%s => Color {%f, %f, %f, %f}\n", getName(), inputColorQF[rt * STAMP_FRAGMENTS + f][0], 
-                        inputColorQF[rt * STAMP_FRAGMENTS + f][1], inputColorQF[rt * STAMP_FRAGMENTS + f][2],
-                        inputColorQF[rt * STAMP_FRAGMENTS + f][3]);
-                )
-                
-                //  Build write mask for the stamp.
-                switch(rtFormat[rt])
-                {
-                    case GPU_RGBA8888:
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 0] = writeR[rt] && !stamp->culled[f];
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 1] = writeG[rt] && !stamp->culled[f];
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 2] = writeB[rt] && !stamp->culled[f];
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 3] = writeA[rt] && !stamp->culled[f];
-                        
-                        GPU_DEBUG_BOX(
-                            printf("%s => Stamp write mask : (%d, %d, %d, %d)\n",  getName(),
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 1],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 2],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 3]);
-                        )
-                        
-                        break;
-                        
-                    case GPU_RG16F:
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 0] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 1] = writeR[rt] && !stamp->culled[f];
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 2] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 3] = writeG[rt] && !stamp->culled[f];
-
-                        GPU_DEBUG_BOX(
-                            printf("%s => Stamp write mask : (%d, %d, %d, %d)\n",  getName(),
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 1],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 2],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 3]);
-                        )
-                        
-                        
-                        break;
+            //  Copy shaded fragment color to all samples for the fragment.
+            for(U32 s = 0; s < stampSamples; s++)
+            {
+                inputColor[rt].component[0][f * stampSamples + s] = attrib[COLOR_ATTRIBUTE + rt][0];
+                inputColor[rt].component[1][f * stampSamples + s] = attrib[COLOR_ATTRIBUTE + rt][1];
+                inputColor[rt].component[2][f * stampSamples + s] = attrib[COLOR_ATTRIBUTE + rt][2];
+                inputColor[rt].component[3][f * stampSamples + s] = attrib[COLOR_ATTRIBUTE + rt][3];
+            }
+        }
+    }
 
-                    case GPU_R32F:
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 0] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 1] = 
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 2] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 3] = writeR[rt] && !stamp->culled[f];
-
-                        GPU_DEBUG_BOX(
-                            printf("%s => Stamp write mask : (%d, %d, %d, %d)\n",  getName(),
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 1],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 2],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 4 + 3]);
-                        )
-                                                
-                        break;                  
-                        
-                    case GPU_RGBA16:                    
-                    case GPU_RGBA16F:                    
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 0] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 1] = writeR[rt] && !stamp->culled[f];
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 2] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 3] = writeG[rt] && !stamp->culled[f];
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 4] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 5] = writeB[rt] && !stamp->culled[f];
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 6] =
-                        stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 7] = writeA[rt] && !stamp->culled[f];
-
-                        GPU_DEBUG_BOX(
-                            printf("%s => Stamp write mask : (%d, %d, %d, %d, %d, %d, %d, %d)\n", getName(),
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 0], stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 1],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 2], stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 3],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 4], stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 5],
-                                stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 6], stamp->mask[(rt * STAMP_FRAGMENTS + f) * 8 + 7]);
-                        )
-                        
-                        break;
+    //  For all render targets.
+    for(U32 rt = 0, activeRT = 0; activeRT < numActiveBuffers; rt++, activeRT++)
+    {
+        //  Search for the next active render target.
+        for(; (!activeBuffer[rt]) && (rt < MAX_RENDER_TARGETS); rt++);
+        
+        CG_ASSERT_COND(!(rt == MAX_RENDER_TARGETS), "Expected an active render target.");        
+        CG_ASSERT_COND(!(rtKernels[rt].encode == NULL), "Unexpected render target format.");
 
-                    default:
-                        CG_ASSERT("Unexpected render target format.");
-                        break;                        
-                }
-            }                
-        }
-        else
+        //  Clamp the fragment input color for normalized render target formats.
+        if (rtKernels[rt].clampInput)
+            ROPStampKernels::clamp(inputColor[rt], pixels);
+
+        if (traceFragmentMatch)
         {
-            //  Get sample coverage mask for the fragment.
-            bool *sampleCoverage = stamp->stamp[f]->getFragment()->getMSAACoverage();
-            
-            //  For all render targets.
-            for(U32 rt = 0, activeRT = 0; activeRT < numActiveBuffers; rt++, activeRT++)
+            for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
             {
-                //  Search for the next active render target.
-                for(; (!activeBuffer[rt]) && (rt < MAX_RENDER_TARGETS); rt++);
-                
-                CG_ASSERT_COND(!(rt == MAX_RENDER_TARGETS), "Expected an active render target.");                
-                //  Copy shaded fragment color to all samples for the fragment.
-                for(U32 s = 0; s < msaaSamples; s++)
-                {
-                    // Compute the offset inside the buffers for the current sample.
-                    U32 sampleOffset = rt * msaaSamples * STAMP_FRAGMENTS + f * msaaSamples + s;
-                    
-                    //  Get fragment input color from color attribute.
-                    if (rtFormat[rt] == GPU_RGBA8888)
-                    {
-                        inputColorQF[sampleOffset][0] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][0], 0.0f, 1.0f);
-                        inputColorQF[sampleOffset][1] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][1], 0.0f, 1.0f);
-                        inputColorQF[sampleOffset][2] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][2], 0.0f, 1.0f);
-                        inputColorQF[sampleOffset][3] = GPU_CLAMP(attrib[COLOR_ATTRIBUTE + rt][3], 0.0f, 1.0f);
-                    }
-                    else
-                    {
-                        inputColorQF[sampleOffset][0] = attrib[COLOR_ATTRIBUTE + rt][0];
-                        inputColorQF[sampleOffset][1] = attrib[COLOR_ATTRIBUTE + rt][1];
-                        inputColorQF[sampleOffset][2] = attrib[COLOR_ATTRIBUTE + rt][2];
-                        inputColorQF[sampleOffset][3] = attrib[COLOR_ATTRIBUTE + rt][3];
-                    }
+                printf("%s => Pixel (%d, %d) triangle ID %d color after clamping {%f, %f, %f, %f}\n", getName(),
+                    stamp->stamp[f]->getFragment()->getX(), stamp->stamp[f]->getFragment()->getY(), stamp->stamp[f]->getTriangleID(),
+                    inputColor[rt].component[0][f * stampSamples], inputColor[rt].component[1][f * stampSamples],
+                    inputColor[rt].component[2][f * stampSamples], inputColor[rt].component[3][f * stampSamples]);
+            }
+        }
 
-                    GPU_DEBUG_BOX(
-                        printf("ColorWrite => Color {%f, %f, %f, %f}\n", inputColorQF[sampleOffset][0],
-                            inputColorQF[sampleOffset][1], inputColorQF[sampleOffset][2],
-                            inputColorQF[sampleOffset][3]);
-                    )
-                    
-                    //  Build write mask for the fragment samples.
-                    switch(rtFormat[rt])
-                    {
-                        case GPU_RGBA8888:
-                            stamp->mask[sampleOffset * 4 + 0] = writeR[rt] && sampleCoverage[s];
-                            stamp->mask[sampleOffset * 4 + 1] = writeG[rt] && sampleCoverage[s];
-                            stamp->mask[sampleOffset * 4 + 2] = writeB[rt] && sampleCoverage[s];
-                            stamp->mask[sampleOffset * 4 + 3] = writeA[rt] && sampleCoverage[s];
-                    
-                            GPU_DEBUG_BOX(
-                                printf("%s => Stamp write mask for fragment %d sample %d : (%d, %d, %d, %d)\n",
-                                    getName(), f, s,
-                                    stamp->mask[sampleOffset * 4 + 0], stamp->mask[sampleOffset * 4 + 1],
-                                    stamp->mask[sampleOffset * 4 + 2], stamp->mask[sampleOffset * 4 + 3]);
-                            )
-                            
-                            break;
-                            
-                        case GPU_RG16F:
-                            stamp->mask[sampleOffset * 4 + 0] = stamp->mask[sampleOffset * 4 + 1] = writeR[rt] && sampleCoverage[s];
-                            stamp->mask[sampleOffset * 4 + 2] = stamp->mask[sampleOffset * 4 + 3] = writeG[rt] && sampleCoverage[s];
-                    
-                            GPU_DEBUG_BOX(
-                                printf("%s => Stamp write mask for fragment %d sample %d : (%d, %d, %d, %d)\n",
-                                    getName(), f, s,
-                                    stamp->mask[sampleOffset * 4 + 0], stamp->mask[sampleOffset * 4 + 1],
-                                    stamp->mask[sampleOffset * 4 + 2], stamp->mask[sampleOffset * 4 + 3]);
-                            )
-                            
-                            break;
-
-                        case GPU_R32F:
-                            stamp->mask[sampleOffset * 4 + 0] = stamp->mask[sampleOffset * 4 + 1] = 
-                            stamp->mask[sampleOffset * 4 + 2] = stamp->mask[sampleOffset * 4 + 3] = writeR[rt] && sampleCoverage[s];
-                    
-                            GPU_DEBUG_BOX(
-                                printf("%s => Stamp write mask for fragment %d sample %d : (%d, %d, %d, %d)\n",
-                                    getName(), f, s,
-                                    stamp->mask[sampleOffset * 4 + 0], stamp->mask[sampleOffset * 4 + 1],
-                                    stamp->mask[sampleOffset * 4 + 2], stamp->mask[sampleOffset * 4 + 3]);
-                            )
-                            
-                            break;
-
-                        case GPU_RGBA16:
-                        case GPU_RGBA16F:
-                            stamp->mask[sampleOffset * 8 + 0] = stamp->mask[sampleOffset * 8 + 1] = writeR[rt] && sampleCoverage[s];
-                            stamp->mask[sampleOffset * 8 + 2] = stamp->mask[sampleOffset * 8 + 3] = writeG[rt] && sampleCoverage[s];
-                            stamp->mask[sampleOffset * 8 + 4] = stamp->mask[sampleOffset * 8 + 5] = writeB[rt] && sampleCoverage[s];
-                            stamp->mask[sampleOffset * 8 + 6] = stamp->mask[sampleOffset * 8 + 7] = writeA[rt] && sampleCoverage[s];
-                    
-                            GPU_DEBUG_BOX(
-                                printf("ColorWrite => Stamp write mask for fragment %d sample %d : (%d, %d, %d, %d, %d, %d, %d, %d)\n", f, s,
-                                    stamp->mask[sampleOffset * 8 + 0], stamp->mask[sampleOffset * 8 + 1],
-                                    stamp->mask[sampleOffset * 8 + 2], stamp->mask[sampleOffset * 8 + 3],
-                                    stamp->mask[sampleOffset * 8 + 4], stamp->mask[sampleOffset * 8 + 5],
-                                    stamp->mask[sampleOffset * 8 + 6], stamp->mask[sampleOffset * 8 + 7]);
-                            )
-                            
-                            break;
-                            
-                        default:
-                            CG_ASSERT("Unexpected render target format.");
-                            break;                        
-                    }
-                }
+        //  Build write mask for all the samples in the stamp.
+        ROPStampKernels::writeMask(&stamp->mask[rt * pixels * rtKernels[rt].bytesPixel], rtWriteMask[rt],
+                                   rtKernels[rt].bytesPixel, covered, pixels);
+
+        GPU_DEBUG_BOX(
+            for(U32 p = 0; p < pixels; p++)
+            {
+                printf("%s => Color {%f, %f, %f, %f}\n", getName(), inputColor[rt].component[0][p],
+                    inputColor[rt].component[1][p], inputColor[rt].component[2][p], inputColor[rt].component[3][p]);
+
+                printf("%s => Stamp write mask for pixel %d :", getName(), p);
+                for(U32 b = 0; b < rtKernels[rt].bytesPixel; b++)
+                    printf(" %d", stamp->mask[(rt * pixels + p) * rtKernels[rt].bytesPixel + b]);
+                printf("\n");
             }
-        }        
+        )
     }
 
     //  Check if the current fragment matches the fragment to trace.
@@ -600,111 +443,21 @@ void cmoColorWriter::operateStamp(U64 cycle, ROPQueue *stamp)
         for(; (!activeBuffer[rt]) && (rt < MAX_RENDER_TARGETS); rt++);
         
         CG_ASSERT_COND(!(rt == MAX_RENDER_TARGETS), "Expected an active render target.");        
-        //  Check if multisampling is enabled.
-        if (!multisampling)
-        {
-            //  Compute offset inside the buffers for the current samples.
-            U32 dataInOffset = rt * STAMP_FRAGMENTS * bytesPixel[rt];
-            U32 dataOutOffset = rt * STAMP_FRAGMENTS;
-            
-            //  Convert color buffer data to internal representation (RGBA32F).
-            switch(rtFormat[rt])
-            {
-                case GPU_RGBA8888:
-                
-                    colorRGBA8ToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                    break;
-                    
-                case GPU_RG16F:
-                
-                    colorRG16FToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                    break;
 
-                case GPU_R32F:
-                
-                    colorR32FToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                    break;
-
-                case GPU_RGBA16:
-                    colorRGBA16ToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                    break;                
-
-                case GPU_RGBA16F:
-                
-                    colorRGBA16FToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                    break;
-
-                default:
-                    CG_ASSERT("Unexpected render target format.");
-                    break;                        
-            }
-
-            //  Convert from sRGB to linear space if required.
-            if (colorSRGBWrite)
-                colorSRGBToLinear(&destColorQF[dataOutOffset]);
-
-            //  Check if the current fragment matches the fragment to trace.
-            if (traceFragmentMatch)
-            {
-                printf("%s => Read data (no MSAA) for pixel (%d, %d) triangle ID %d.\n", getName(), watchFragmentX,
-                    watchFragmentY, stamp->stamp[0]->getTriangleID());
-            }
-        }
-        else
+        //  The color buffer data is only used for blending.
+        if (blend[rt])
         {
-            //  Convert fixed point color data to float point data for all the samples in the stamp
-            for(U32 s = 0; s < msaaSamples; s++)
-            {
-                //  Compute offset inside the buffers for the current samples.
-                U32 dataInOffset = rt * STAMP_FRAGMENTS * msaaSamples * bytesPixel[rt] +
-                                      s * STAMP_FRAGMENTS * bytesPixel[rt];
-                U32 dataOutOffset = rt * STAMP_FRAGMENTS * msaaSamples + s * STAMP_FRAGMENTS;
-            
-                //  Convert color buffer data to internal representation (RGBA32F).
-                switch(rtFormat[rt])
-                {
-                    case GPU_RGBA8888:
-                    
-                        colorRGBA8ToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                        break;
-                        
-                    case GPU_RG16F:
-                    
-                        colorRG16FToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                        break;
-                        
-                    case GPU_R32F:
-                    
-                        colorR32FToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                        break;
-                        
-                    case GPU_RGBA16:
-                    
-                        colorRGBA16ToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                        break;
-
-                    case GPU_RGBA16F:
-                    
-                        colorRGBA16FToRGBA32F(&stamp->data[dataInOffset], &destColorQF[dataOutOffset]);
-                        break;
+            //  Convert color buffer data to internal representation (RGBA32F) for all the samples in the
+            //  stamp.  Converts from sRGB to linear space if required.
+            rtKernels[rt].decode(&stamp->data[rt * pixels * bytesPixel[rt]], destColor[rt], pixels);
+        }
 
-                    default:
-                        CG_ASSERT("Unexpected render target format.");
-                        break;                        
-                }
-            
-                //  Convert from sRGB to linear space if required.
-                if (colorSRGBWrite)
-                    colorSRGBToLinear(&destColorQF[dataOutOffset]);
-            }
-            
-            //  Check if the current fragment matches the fragment to trace.
-            if (traceFragmentMatch)
-            {
-                printf("%s => Read data (MSAA) for pixel (%d, %d) triangle ID %d.\n", getName(), watchFragmentX,
-                    watchFragmentY, stamp->stamp[0]->getTriangleID());
-            }
-        }       
+        //  Check if the current fragment matches the fragment to trace.
+        if (traceFragmentMatch)
+        {
+            printf("%s => Read data (%s) for pixel (%d, %d) triangle ID %d.\n", getName(), multisampling ? "MSAA" : "no MSAA",
+                watchFragmentX, watchFragmentY, stamp->stamp[0]->getTriangleID());
+        }
     }
     
     //  Check if the current fragment matches the fragment to trace.
@@ -723,101 +476,83 @@ void cmoColorWriter::operateStamp(U64 cycle, ROPQueue *stamp)
         CG_ASSERT_COND(!(rt == MAX_RENDER_TARGETS), "Expected an active render target.");        
         FragmentQuadMemoryUpdateInfo quadMemUpdate;
 
-        //  Determine if blend mode is active.
-        if (blend[rt])
+        //  Compute offset inside the buffers for the current render target.
+        U32 dataOffset = rt * pixels * bytesPixel[rt];
+
+        //  Check if validation mode is enabled.
+        if (validationMode && !(blend[rt] && multisampling))
         {
-            GPU_DEBUG_BOX(
-                printf("ColorWrite => Blending stamp.\n");
-            
-                for(U32 i = 0; i < STAMP_FRAGMENTS; i++)
-                    printf(">>  Input Color = { %f, %f, %f %f }\n", inputColorQF[i][0], inputColorQF[i][1],
-                        inputColorQF[i][2], inputColorQF[i][3]);
-                for(U32 i = 0; i < STAMP_FRAGMENTS; i++)
-                    printf(">>  Dest Color = { %f, %f, %f %f }\n", destColorQF[i][0], destColorQF[i][1],
-                        destColorQF[i][2], destColorQF[i][3]);
-            )
+            //  Check if there are unculled fragments in the quad.
+            bool anyNotAlreadyCulled = false;            
+            for(U32 f = 0; (f < STAMP_FRAGMENTS) && !anyNotAlreadyCulled; f++)
+                anyNotAlreadyCulled = anyNotAlreadyCulled || !stamp->culled[f];
 
-            //  Check if multisampling is enabled.
-            if (!multisampling)
-            {                
-                //  Compute offset inside the buffers for the current samples.
-                U32 dataOffset = rt * STAMP_FRAGMENTS;
-                U32 dataInOffset = rt * STAMP_FRAGMENTS * bytesPixel[rt];
+            //  Store the information for the quad if there is a valid fragment.
+            if (anyNotAlreadyCulled)
+            {
+                //  Set the quad identifier to the top left fragment of the quad.
+                quadMemUpdate.fragID.x = stamp->stamp[0]->getFragment()->getX();
+                quadMemUpdate.fragID.y = stamp->stamp[0]->getFragment()->getY();
+                quadMemUpdate.fragID.triangleID = stamp->stamp[0]->getTriangleID();
                 
-                //  Check if validation mode is enabled.
-                if (validationMode)
-                {
-                    //  Check if there are unculled fragments in the quad.
-                    bool anyNotAlreadyCulled = false;            
-                    for(U32 f = 0; (f < STAMP_FRAGMENTS) && !anyNotAlreadyCulled; f++)
-                        anyNotAlreadyCulled = anyNotAlreadyCulled || !stamp->culled[f];
+                quadMemUpdate.fragID.sample = 0;
 
-                    //  Store the information for the quad if there is a valid fragment.
-                    if (anyNotAlreadyCulled)
-                    {
-                        //  Set the quad identifier to the top left fragment of the quad.
-                        quadMemUpdate.fragID.x = stamp->stamp[0]->getFragment()->getX();
-                        quadMemUpdate.fragID.y = stamp->stamp[0]->getFragment()->getY();
-                        quadMemUpdate.fragID.triangleID = stamp->stamp[0]->getTriangleID();
-                        
-                        quadMemUpdate.fragID.sample = 0;
-
-                        //  Copy the input (color computed per fragment) and read data (color from the render target) for
-                        //  the quad.
-                        for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                        {
-                            ((F32 *) quadMemUpdate.inData)[f * 4 + 0] = inputColorQF[dataOffset + f][0];
-                            ((F32 *) quadMemUpdate.inData)[f * 4 + 1] = inputColorQF[dataOffset + f][1];
-                            ((F32 *) quadMemUpdate.inData)[f * 4 + 2] = inputColorQF[dataOffset + f][2];
-                            ((F32 *) quadMemUpdate.inData)[f * 4 + 3] = inputColorQF[dataOffset + f][3];
-                        }
-                        for(U32 qw = 0; qw < ((bytesPixel[rt] * 4) >> 3); qw++)
-                            ((U64 *) quadMemUpdate.readData)[qw] = ((U64 *) &stamp->data[dataInOffset])[qw];
-
-                        if (traceFragmentMatch)
-                        {
-                            printf("%s => Read Data from @(%08x, %d, %d) : %08x %08x %08x %08x\n", getName(),
-                                stamp->address[rt], stamp->way[rt], stamp->line[rt],
-                                ((U32 *) quadMemUpdate.readData)[0], ((U32 *) quadMemUpdate.readData)[1],
-                                ((U32 *) quadMemUpdate.readData)[2], ((U32 *) quadMemUpdate.readData)[3]);
-                        }
-                    }
+                //  Copy the input (color computed per fragment) and read data (color from the render target) for
+                //  the quad.
+                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+                {
+                    ((F32 *) quadMemUpdate.inData)[f * 4 + 0] = inputColor[rt].component[0][f * stampSamples];
+                    ((F32 *) quadMemUpdate.inData)[f * 4 + 1] = inputColor[rt].component[1][f * stampSamples];
+                    ((F32 *) quadMemUpdate.inData)[f * 4 + 2] = inputColor[rt].component[2][f * stampSamples];
+                    ((F32 *) quadMemUpdate.inData)[f * 4 + 3] = inputColor[rt].component[3][f * stampSamples];
                 }
 
-                //  Perform blend operation.  
-                frEmu.blend(rt, &inputColorQF[dataOffset], &inputColorQF[dataOffset], &destColorQF[dataOffset]);
+                //  Without blending the render target data is not read.
+                for(U32 qw = 0; qw < ((bytesPixel[rt] * 4) >> 3); qw++)
+                    ((U64 *) quadMemUpdate.readData)[qw] = blend[rt] ? ((U64 *) &stamp->data[dataOffset])[qw] : 0xDEFADA7ADEFADA7AULL;
 
-                //  Check if the current fragment matches the fragment to trace.
                 if (traceFragmentMatch)
                 {
-                    printf("%s => Blend (no MSAA) for pixel (%d, %d) triangle ID %d.\n", getName(), watchFragmentX,
-                        watchFragmentY, stamp->stamp[0]->getTriangleID());
+                    printf("%s => Read Data from @(%08x, %d, %d) : %08x %08x %08x %08x\n", getName(),
+                        stamp->address[rt], stamp->way[rt], stamp->line[rt],
+                        ((U32 *) quadMemUpdate.readData)[0], ((U32 *) quadMemUpdate.readData)[1],
+                        ((U32 *) quadMemUpdate.readData)[2], ((U32 *) quadMemUpdate.readData)[3]);
                 }
             }
-            else
-            {
-                //  Perform blending for all the samples in the stamp.
-                for(U32 s = 0; s < msaaSamples; s++)
-                {
-                    //  Compute offset inside the buffers for the current samples.
-                    U32 dataOffset = rt * msaaSamples * STAMP_FRAGMENTS + STAMP_FRAGMENTS * s;
-                    
-                    //  Perform blending for a group of samples.
-                    frEmu.blend(rt, &inputColorQF[dataOffset], &inputColorQF[dataOffset], &destColorQF[dataOffset]);
-                }
+        }
 
-                //  Check if the current fragment matches the fragment to trace.
-                if (traceFragmentMatch)
-                {
-                    printf("%s => Blend (MSAA) data for pixel (%d, %d) triangle ID %d.\n", getName(), watchFragmentX,
-                        watchFragmentY, stamp->stamp[0]->getTriangleID());
-                }
+        //  Determine if blend mode is active.
+        if (blend[rt])
+        {
+            GPU_DEBUG_BOX(
+                printf("ColorWrite => Blending stamp.\n");
+            
+                for(U32 p = 0; p < pixels; p++)
+                    printf(">>  Input Color = { %f, %f, %f %f }\n", inputColor[rt].component[0][p], inputColor[rt].component[1][p],
+                        inputColor[rt].component[2][p], inputColor[rt].component[3][p]);
+                for(U32 p = 0; p < pixels; p++)
+                    printf(">>  Dest Color = { %f, %f, %f %f }\n", destColor[rt].component[0][p], destColor[rt].component[1][p],
+                        destColor[rt].component[2][p], destColor[rt].component[3][p]);
+            )
+
+            //  Perform blend operation for all the samples in the stamp.
+#ifdef ROP_BLEND_KERNELS
+            ROPStampKernels::blend(blendState[rt], inputColor[rt], destColor[rt], pixels);
+#else
+            ROPStampKernels::blendEmulated(frEmu, rt, inputColor[rt], destColor[rt], pixels);
+#endif
+
+            //  Check if the current fragment matches the fragment to trace.
+            if (traceFragmentMatch)
+            {
+                printf("%s => Blend (%s) for pixel (%d, %d) triangle ID %d.\n", getName(), multisampling ? "MSAA" : "no MSAA",
+                    watchFragmentX, watchFragmentY, stamp->stamp[0]->getTriangleID());
             }
             
             GPU_DEBUG_BOX(        
-                for(U32 i = 0; i < STAMP_FRAGMENTS; i++)
-                    printf("<<  Input Color = { %f, %f, %f %f }\n", inputColorQF[i][0], inputColorQF[i][1],
-                        inputColorQF[i][2], inputColorQF[i][3]);
+                for(U32 p = 0; p < pixels; p++)
+                    printf("<<  Input Color = { %f, %f, %f %f }\n", inputColor[rt].component[0][p], inputColor[rt].component[1][p],
+                        inputColor[rt].component[2][p], inputColor[rt].component[3][p]);
             )
 
             //  Update statistics.
@@ -825,51 +560,6 @@ void cmoColorWriter::operateStamp(U64 cycle, ROPQueue *stamp)
         }
         else
         {
-            //  Compute offset inside the buffers for the current samples.
-            U32 dataOffset = rt * STAMP_FRAGMENTS;
-            U32 dataInOffset = rt * STAMP_FRAGMENTS * bytesPixel[rt];
-            
-            //  Check if validation mode is enabled.
-            if (validationMode)
-            {
-                //  Check if there are unculled fragments in the quad.
-                bool anyNotAlreadyCulled = false;            
-                for(U32 f = 0; (f < STAMP_FRAGMENTS) && !anyNotAlreadyCulled; f++)
-                    anyNotAlreadyCulled = anyNotAlreadyCulled || !stamp->culled[f];
-
-                //  Store the information for the quad if there is a valid fragment.
-                if (anyNotAlreadyCulled)
-                {
-                    //  Set the quad identifier to the top left fragment of the quad.
-                    quadMemUpdate.fragID.x = stamp->stamp[0]->getFragment()->getX();
-                    quadMemUpdate.fragID.y = stamp->stamp[0]->getFragment()->getY();
-                    quadMemUpdate.fragID.triangleID = stamp->stamp[0]->getTriangleID();
-                    
-                    quadMemUpdate.fragID.sample = 0;
-
-                    //  Copy the input (color computed per fragment) and read data (color from the render target) for
-                    //  the quad.
-                    for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                    {
-                        ((F32 *) quadMemUpdate.inData)[f * 4 + 0] = inputColorQF[dataOffset + f][0];
-                        ((F32 *) quadMemUpdate.inData)[f * 4 + 1] = inputColorQF[dataOffset + f][1];
-                        ((F32 *) quadMemUpdate.inData)[f * 4 + 2] = inputColorQF[dataOffset + f][2];
-                        ((F32 *) quadMemUpdate.inData)[f * 4 + 3] = inputColorQF[dataOffset + f][3];
-                    }
-                    
-                    for(U32 qw = 0; qw < ((bytesPixel[rt] * 4) >> 3); qw++)
-                        ((U64 *) quadMemUpdate.readData)[qw] = 0xDEFADA7ADEFADA7AULL;
-
-                    if (traceFragmentMatch)
-                    {
-                        printf("%s => Read Data from @(%08x, %d, %d) : %08x %08x %08x %08x\n", getName(),
-                            stamp->address[rt], stamp->way[rt], stamp->line[rt],
-                            ((U32 *) quadMemUpdate.readData)[0], ((U32 *) quadMemUpdate.readData)[1],
-                            ((U32 *) quadMemUpdate.readData)[2], ((U32 *) quadMemUpdate.readData)[3]);
-                    }
-                }
-            }
-            
             //  Check if the current fragment matches the fragment to trace.
             if (traceFragmentMatch)
             {
@@ -886,35 +576,14 @@ void cmoColorWriter::operateStamp(U64 cycle, ROPQueue *stamp)
             )
 
             CG_ASSERT_COND(!(colorBufferFormat != GPU_RGBA8888), "Logic operation only supported with RGBA8 color buffer format.");            
-            //  Check if multisampling is enabled
-            if (!multisampling)
-            {
-                //  Convert from linear to sRGB color space on color write if required.
-                if (colorSRGBWrite)
-                    colorLinearToSRGB(inputColorQF);
-                    
-                //  Convert the stamp color data to integer format.
-                colorRGBA32FToRGBA8(inputColorQF, outColor);
 
-                //  Perform logical operation.
-                frEmu.logicOp(outColor, outColor, stamp->data);
-            }
-            else
-            {
-                //  Convert to integer format and perform logical op for all the samples in the stamp.
-                for(U32 j = 0; j < msaaSamples; j++)
-                {
-                    //  Convert from linear to sRGB color space on color write if required.
-                    if (colorSRGBWrite)
-                        colorLinearToSRGB(&inputColorQF[STAMP_FRAGMENTS * j]);
-                        
-                    //  Convert the sample color data to integer format.
-                    colorRGBA32FToRGBA8(&inputColorQF[STAMP_FRAGMENTS * j], &outColor[STAMP_FRAGMENTS * j * 4]);
+            //  Convert the stamp color data to integer format for all the samples in the stamp.  Converts from
+            //  linear to sRGB space if required.
+            rtKernels[rt].encode(inputColor[rt], outColor, pixels);
 
-                    //  Perform logical operation for a group of samples.
-                    frEmu.logicOp(&outColor[STAMP_FRAGMENTS * j * 4], &outColor[STAMP_FRAGMENTS * j * 4], &stamp->data[STAMP_FRAGMENTS * j * 4]);
-                }
-            }
+            //  Perform logical operation for all the groups of samples in the stamp.
+            for(U32 s = 0; s < stampSamples; s++)
+                frEmu.logicOp(&outColor[STAMP_FRAGMENTS * s * 4], &outColor[STAMP_FRAGMENTS * s * 4], &stamp->data[STAMP_FRAGMENTS * s * 4]);
             
             //  Update statistics.
             logoped->inc(STAMP_FRAGMENTS);
@@ -928,240 +597,98 @@ void cmoColorWriter::operateStamp(U64 cycle, ROPQueue *stamp)
         }
         else
         {
-            //  Check if multisampling is enabled.
-            if (!multisampling)
-            {
-                //  Compute offset inside the buffers for the current samples.
-                U32 dataInOffset = rt * STAMP_FRAGMENTS;
-                U32 dataOutOffset = rt * STAMP_FRAGMENTS * bytesPixel[rt];
-                
-                //  Convert from linear to sRGB color space on color write if required.
-                if (colorSRGBWrite)
-                    colorLinearToSRGB(&inputColorQF[dataInOffset]);
-
-                //  Convert the stamp color data in internal format to the color buffer format.
-                switch(rtFormat[rt])
-                {
-                    case GPU_RGBA8888:
-                    
-                        colorRGBA32FToRGBA8(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-                        
-                        GPU_DEBUG_BOX(
-                            U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                            printf("%s => Output data for rt %d : %08x %08x %08x %08x\n", getName(), rt, 
-                                data[0], data[1], data[2], data[3]);
-                        )
-                        
-                        break;
-                        
-                    case GPU_RG16F:
-                    
-                        colorRGBA32FToRG16F(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-
-                        GPU_DEBUG_BOX(
-                            U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                            printf("%s => Output data for rt %d : %08x %08x %08x %08x\n", getName(), rt, 
-                                data[0], data[1], data[2], data[3]);
-                        )
-                        break;
-                        
-                    case GPU_R32F:
-                    
-                        colorRGBA32FToR32F(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-
-                        GPU_DEBUG_BOX(
-                            U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                            printf("%s => Output data for rt %d : %08x %08x %08x %08x\n", getName(), rt, 
-                                data[0], data[1], data[2], data[3]);
-                        )
-                        break;
-                        
-                    case GPU_RGBA16:
-                    
-                        colorRGBA32FToRGBA16(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-
-                        GPU_DEBUG_BOX(
-                            U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                            printf("%s => Output data for rt %d : %08x %08x %08x %08x %08x %08x %08x %08x\n", getName(), rt, 
-                                data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
-                        )
-                        break;
+            //  Convert the stamp color data in internal format to the color buffer format for all the samples
+            //  in the stamp.  Converts from linear to sRGB space if required.
+            rtKernels[rt].encode(inputColor[rt], &stamp->data[dataOffset], pixels);
 
-                    case GPU_RGBA16F:
-                    
-                        colorRGBA32FToRGBA16F(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-                        
-                        GPU_DEBUG_BOX(
-                            U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                            printf("%s => Output data for rt %d : %08x %08x %08x %08x %08x %08x %08x %08x\n", getName(), rt, 
-                                data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
-                        )
-                        break;
+            GPU_DEBUG_BOX(
+                U32 *data = (U32 *) &stamp->data[dataOffset];
+                printf("%s => Output data for rt %d :", getName(), rt);
+                for(U32 w = 0; w < ((pixels * bytesPixel[rt]) >> 2); w++)
+                    printf(" %08x", data[w]);
+                printf("\n");
+            )
 
-                    default:
-                        CG_ASSERT("Unexpected render target format.");
-                        break;                        
-                }
+            //  Check if the current fragment matches the fragment to trace.
+            if (traceFragmentMatch)
+            {
+                printf("%s => Data update (%s) or pixel (%d, %d) triangle ID %d. validationMode = %s\n", getName(),
+                    multisampling ? "MSAA" : "no MSAA", watchFragmentX, watchFragmentY, stamp->stamp[0]->getTriangleID(),
+                    validationMode ? "T" : "F");
+            }
 
+            if (validationMode && !multisampling)
+            {
+                //  Check if a write is performed (fragment not culled).
+                bool anyNotCulled = false;                       
+                for(U32 f = 0; (f < STAMP_FRAGMENTS) && !anyNotCulled; f++)
+                    anyNotCulled = anyNotCulled || !stamp->culled[f];
+                                    
                 //  Check if the current fragment matches the fragment to trace.
                 if (traceFragmentMatch)
                 {
-                    printf("%s => Data update (no MSAA) or pixel (%d, %d) triangle ID %d. validationMode = %s\n", getName(), watchFragmentX,
-                        watchFragmentY, stamp->stamp[0]->getTriangleID(), validationMode ? "T" : "F");
+                    printf("%s => Checking if pixel (%d, %d) triangle ID %d has to be added to the Memory Update Map.\n", getName(), watchFragmentX,
+                        watchFragmentY, stamp->stamp[0]->getTriangleID());
+                    printf("%s => anyNotCulled = %s | culled = (%s %s %s %s)\n", getName(),
+                        anyNotCulled ? "T" : "F",
+                        stamp->culled[0] ? "T" : "F",
+                        stamp->culled[1] ? "T" : "F",
+                        stamp->culled[2] ? "T" : "F",
+                        stamp->culled[3] ? "T" : "F");
                 }
-
-                if (validationMode)
+                
+                //  Store information for the quad and add to the z/stencil memory update map.
+                if (anyNotCulled)
                 {
-                    //  Check if a write is performed (fragment not culled).
-                    bool anyNotCulled = false;                       
-                    for(U32 f = 0; (f < STAMP_FRAGMENTS) && !anyNotCulled; f++)
-                        anyNotCulled = anyNotCulled || !stamp->culled[f];
-                                        
+                    //  Store the result z and stencil results for the quad.
+                    for(U32 qw = 0; qw < ((bytesPixel[rt] * STAMP_FRAGMENTS) >> 3) ; qw++)
+                        ((U64 *) quadMemUpdate.writeData)[qw] = ((U64 *) &stamp->data[dataOffset])[qw];
+                        
+                    //  Store the write mask for the quad.
+                    for(U32 b = 0; b < (STAMP_FRAGMENTS * bytesPixel[rt]); b++)
+                        quadMemUpdate.writeMask[b] = stamp->mask[dataOffset + b];
+                        
+                    //  Store the cull mask for the quad.
+                    for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+                        quadMemUpdate.cullMask[f] = stamp->culled[f];
+                        
+                    //  Store the information for the quad in the z stencil memory update map.
+                    colorMemoryUpdateMap[rt].insert(make_pair(quadMemUpdate.fragID, quadMemUpdate));
+
                     //  Check if the current fragment matches the fragment to trace.
                     if (traceFragmentMatch)
                     {
-                        printf("%s => Checking if pixel (%d, %d) triangle ID %d has to be added to the Memory Update Map.\n", getName(), watchFragmentX,
-                            watchFragmentY, stamp->stamp[0]->getTriangleID());
-                        printf("%s => anyNotCulled = %s | culled = (%s %s %s %s)\n", getName(),
-                            anyNotCulled ? "T" : "F",
-                            stamp->culled[0] ? "T" : "F",
-                            stamp->culled[1] ? "T" : "F",
-                            stamp->culled[2] ? "T" : "F",
-                            stamp->culled[3] ? "T" : "F");
-                    }
-                    
-                    //  Store information for the quad and add to the z/stencil memory update map.
-                    if (anyNotCulled)
-                    {
-                        //  Store the result z and stencil results for the quad.
-                        for(U32 qw = 0; qw < ((bytesPixel[rt] * STAMP_FRAGMENTS) >> 3) ; qw++)
-                            ((U64 *) quadMemUpdate.writeData)[qw] = ((U64 *) &stamp->data[dataOutOffset])[qw];
-                            
-                        //  Store the write mask for the quad.
+                        printf("%s => Adding pixel (%d, %d) triangle ID %d to Memory Update Map | rt = %d | FragID = (%d, %d, %d)\n",
+                            getName(), watchFragmentX, watchFragmentY, stamp->stamp[0]->getTriangleID(),
+                            rt, quadMemUpdate.fragID.x, quadMemUpdate.fragID.y, quadMemUpdate.fragID.triangleID);
+                        printf("%s => Out Data : %08x %08x %08x %08x\n", getName(),
+                            ((U32 *) quadMemUpdate.writeData)[0], ((U32 *) quadMemUpdate.writeData)[1],
+                            ((U32 *) quadMemUpdate.writeData)[2], ((U32 *) quadMemUpdate.writeData)[3]);
+                        printf("%s => Mask : ", getName());
                         for(U32 b = 0; b < (STAMP_FRAGMENTS * bytesPixel[rt]); b++)
-                            quadMemUpdate.writeMask[b] = stamp->mask[dataOutOffset + b];
-                            
-                        //  Store the cull mask for the quad.
-                        for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                            quadMemUpdate.cullMask[f] = stamp->culled[f];
-                            
-                        //  Store the information for the quad in the z stencil memory update map.
-                        colorMemoryUpdateMap[rt].insert(make_pair(quadMemUpdate.fragID, quadMemUpdate));
-
-                        //  Check if the current fragment matches the fragment to trace.
-                        if (traceFragmentMatch)
-                        {
-                            printf("%s => Adding pixel (%d, %d) triangle ID %d to Memory Update Map | rt = %d | FragID = (%d, %d, %d)\n",
-                                getName(), watchFragmentX, watchFragmentY, stamp->stamp[0]->getTriangleID(),
-                                rt, quadMemUpdate.fragID.x, quadMemUpdate.fragID.y, quadMemUpdate.fragID.triangleID);
-                            printf("%s => Out Data : %08x %08x %08x %08x\n", getName(),
-                                ((U32 *) quadMemUpdate.writeData)[0], ((U32 *) quadMemUpdate.writeData)[1],
-                                ((U32 *) quadMemUpdate.writeData)[2], ((U32 *) quadMemUpdate.writeData)[3]);
-                            printf("%s => Mask : ", getName());
-                            for(U32 b = 0; b < (STAMP_FRAGMENTS * bytesPixel[rt]); b++)
-                                printf("%s ", stamp->mask[dataOutOffset + b] ? "T": "F");
-                            printf("\n");
-                        }
+                            printf("%s ", stamp->mask[dataOffset + b] ? "T": "F");
+                        printf("\n");
                     }
                 }
             }
-            else
-            {
-                //  Convert the sample color data for all the stamp.
-                for(U32 s = 0; s < msaaSamples; s++)
-                {
-                    //  Compute offset inside the buffers for the current samples.
-                    U32 dataInOffset = rt * msaaSamples * STAMP_FRAGMENTS + s * STAMP_FRAGMENTS;
-                    U32 dataOutOffset = rt * msaaSamples * STAMP_FRAGMENTS * bytesPixel[rt] +
-                                           s * STAMP_FRAGMENTS * bytesPixel[rt];
-
-                    //  Convert from linear to sRGB color space on color write if required.
-                    if (colorSRGBWrite)
-                        colorLinearToSRGB(&inputColorQF[dataInOffset]);
-                        
-                    //  Convert the stamp color data in internal format to the color buffer format.
-                    switch(rtFormat[rt])
-                    {
-                        case GPU_RGBA8888:
-                        
-                            colorRGBA32FToRGBA8(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-
-                            GPU_DEBUG_BOX(
-                                U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                                printf("%s => Output data for sample %d for rt %d : %08x %08x %08x %08x\n",
-                                    getName(), s, rt, 
-                                    data[0], data[1], data[2], data[3]);
-                            )
-
-                            break;
-                            
-                        case GPU_RG16F:
-                        
-                            colorRGBA32FToRG16F(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-
-                            GPU_DEBUG_BOX(
-                                U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                                printf("%s => Output data for sample %d for rt %d : %08x %08x %08x %08x\n",
-                                    getName(), s, rt, 
-                                    data[0], data[1], data[2], data[3]);
-                            )
-
-                            break;
-                            
-                        case GPU_R32F:
-                        
-                            colorRGBA32FToR32F(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-
-                            GPU_DEBUG_BOX(
-                                U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                                printf("%s => Output data for sample %d for rt %d : %08x %08x %08x %08x\n",
-                                    getName(), s, rt, 
-                                    data[0], data[1], data[2], data[3]);
-                            )
-
-                            break;
-
-                        case GPU_RGBA16:
-                        
-                            colorRGBA32FToRGBA16(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-
-                            GPU_DEBUG_BOX(
-                                U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                                printf("%s => Output data for sample %d for rt %d : %08x %08x %08x %08x %08x %08x %08x %08x\n",
-                                    getName(), s, rt, 
-                                    data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
-                            )
-
-                            break;
+        }
+    }
+}
 
-                        case GPU_RGBA16F:
-                        
-                            colorRGBA32FToRGBA16F(&inputColorQF[dataInOffset], &stamp->data[dataOutOffset]);
-                            
-                            GPU_DEBUG_BOX(
-                                U32 *data = (U32 *) &stamp->data[dataOutOffset];
-                                printf("%s => Output data for sample %d for rt %d : %08x %08x %08x %08x %08x %08x %08x %08x\n",
-                                    getName(), s, rt, 
-                                    data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
-                            )
-                            
-                            break;
+//  Selects the stamp kernels for the current render target state.
+void cmoColorWriter::setupStampKernels()
+{
+    for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+    {
+        //  Select the color conversion kernels for the render target format.
+        ROPStampKernels::selectColorKernels(rtFormat[rt], colorSRGBWrite, rtKernels[rt]);
 
-                    default:
-                        CG_ASSERT("Unexpected render target format.");
-                        break;                        
-                    }
-                }
+        //  Build the byte write mask for a pixel of the render target.
+        ROPStampKernels::colorWriteMask(rtFormat[rt], writeR[rt], writeG[rt], writeB[rt], writeA[rt], rtWriteMask[rt]);
 
-                //  Check if the current fragment matches the fragment to trace.
-                if (traceFragmentMatch)
-                {
-                    printf("%s => Data update (MSAA) or pixel (%d, %d) triangle ID %d.\n", getName(), watchFragmentX,
-                        watchFragmentY, stamp->stamp[0]->getTriangleID());
-                }
-
-            }
-        }
+        //  Set the blend state.
+        ROPStampKernels::setupBlend(blendState[rt], equation[rt], srcRGB[rt], srcAlpha[rt], dstRGB[rt], dstAlpha[rt],
+                                    constantColor[rt]);
     }
 }
 
@@ -1248,8 +775,8 @@ void cmoColorWriter::postWriteProcess(U64 cycle, ROPQueue *stamp)
             }
         }
 
-        //  Delete fragment attributes.
-        delete[] attrib;
+        //  Release fragment attributes.
+        FragmentInput::releaseAttributes(attrib);
 
         //  Delete the fragment in the behaviorModel.
         delete fr;
@@ -1490,6 +1017,9 @@ void cmoColorWriter::processCommand(RasterizerCommand *command, U64 cycle)
                 if (rtEnable[rt])
                     numActiveBuffers++;
             }
+
+            //  Select the stamp kernels for the render target state of the batch.
+            setupStampKernels();
                         
             //  Reset triangle counter.
             triangleCounter = 0;
@@ -2682,196 +2212,6 @@ void cmoColorWriter::processRegisterWrite(GPURegister reg, U32 subreg,
 
 }
 
-//  Converts color data from RGBA8 format to RGBA32F format.
-void cmoColorWriter::colorRGBA8ToRGBA32F(U08 *in, Vec4FP32 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 8 bit normalized color components to 32 bit float point color components.
-        out[i][0] = F32(in[i * 4]) * (1.0f / 255.0f);
-        out[i][1] = F32(in[i * 4 + 1]) * (1.0f / 255.0f);
-        out[i][2] = F32(in[i * 4 + 2]) * (1.0f / 255.0f);
-        out[i][3] = F32(in[i * 4 + 3]) * (1.0f / 255.0f);
-    }
-
-}
-
-//  Converts color data in RGB32F format to RGBA8 format.
-void cmoColorWriter::colorRGBA32FToRGBA8(Vec4FP32 *in, U08 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 32bit float point color components to 8 bit normalized color components.
-        out[i * 4 + 0] = U32(255.0f * GPU_CLAMP(in[i][0], 0.0f, 1.0f));
-        out[i * 4 + 1] = U32(255.0f * GPU_CLAMP(in[i][1], 0.0f, 1.0f));
-        out[i * 4 + 2] = U32(255.0f * GPU_CLAMP(in[i][2], 0.0f, 1.0f));
-        out[i * 4 + 3] = U32(255.0f * GPU_CLAMP(in[i][3], 0.0f, 1.0f));
-    }
-}
-
-//  Converts color data from RGBA16F format to RGBA32F format.
-void cmoColorWriter::colorRGBA16FToRGBA32F(U08 *in, Vec4FP32 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 16 bit float point color components to 32 bit float point color components.
-        out[i][0] = GPUMath::convertFP16ToFP32(((U16 *) in)[i * 4]);
-        out[i][1] = GPUMath::convertFP16ToFP32(((U16 *) in)[i * 4 + 1]);
-        out[i][2] = GPUMath::convertFP16ToFP32(((U16 *) in)[i * 4 + 2]);
-        out[i][3] = GPUMath::convertFP16ToFP32(((U16 *) in)[i * 4 + 3]);
-    }
-
-}
-
-//  Converts color data in RGB32F format to RGBA8 format.
-void cmoColorWriter::colorRGBA32FToRGBA16F(Vec4FP32 *in, U08 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 32 bit float point color components to 16 bit float point color components.
-        ((U16 *) out)[i * 4 + 0] = GPUMath::convertFP32ToFP16(in[i][0]);
-        ((U16 *) out)[i * 4 + 1] = GPUMath::convertFP32ToFP16(in[i][1]);
-        ((U16 *) out)[i * 4 + 2] = GPUMath::convertFP32ToFP16(in[i][2]);
-        ((U16 *) out)[i * 4 + 3] = GPUMath::convertFP32ToFP16(in[i][3]);
-    }
-}
-
-//  Converts color data from RGBA16 format to RGBA32F format.
-void cmoColorWriter::colorRGBA16ToRGBA32F(U08 *in, Vec4FP32 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 16 bit normalized color components to 32 bit float point color components.
-        out[i][0] = F32(((U16 *) in)[i * 4 + 0]) * (1.0f / 65535.0f);
-        out[i][1] = F32(((U16 *) in)[i * 4 + 1]) * (1.0f / 65535.0f);
-        out[i][2] = F32(((U16 *) in)[i * 4 + 2]) * (1.0f / 65535.0f);
-        out[i][3] = F32(((U16 *) in)[i * 4 + 3]) * (1.0f / 65535.0f);
-    }
-}
-
-//  Converts color data in RGB32F format to RGBA16 format.
-void cmoColorWriter::colorRGBA32FToRGBA16(Vec4FP32 *in, U08 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 32bit float point color components to 16 bit normalized color components.
-        ((U16 *) out)[i * 4 + 0] = U16(65535.0f * GPU_CLAMP(in[i][0], 0.0f, 1.0f));
-        ((U16 *) out)[i * 4 + 1] = U16(65535.0f * GPU_CLAMP(in[i][1], 0.0f, 1.0f));
-        ((U16 *) out)[i * 4 + 2] = U16(65535.0f * GPU_CLAMP(in[i][2], 0.0f, 1.0f));
-        ((U16 *) out)[i * 4 + 3] = U16(65535.0f * GPU_CLAMP(in[i][3], 0.0f, 1.0f));
-    }
-}
-
-
-//  Converts color data from RG16F format to RGBA32F format.
-void cmoColorWriter::colorRG16FToRGBA32F(U08 *in, Vec4FP32 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 16 bit float point color components to 32 bit float point color components.
-        out[i][0] = GPUMath::convertFP16ToFP32(((U16 *) in)[i * 2]);
-        out[i][1] = GPUMath::convertFP16ToFP32(((U16 *) in)[i * 2 + 1]);
-        out[i][2] = 0.0f;
-        out[i][3] = 1.0f;
-    }
-}
-
-//  Converts color data in RGB32F format to RG16F format.
-void cmoColorWriter::colorRGBA32FToRG16F(Vec4FP32 *in, U08 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 32 bit float point color components to 16 bit float point color components.
-        ((U16 *) out)[i * 2]     = GPUMath::convertFP32ToFP16(in[i][0]);
-        ((U16 *) out)[i * 2 + 1] = GPUMath::convertFP32ToFP16(in[i][1]);
-    }
-}
-
-//  Converts color data from R32F format to RGBA32F format.
-void cmoColorWriter::colorR32FToRGBA32F(U08 *in, Vec4FP32 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 16 bit float point color components to 32 bit float point color components.
-        out[i][0] = ((F32 *) in)[i];
-        out[i][1] = 0.0f;
-        out[i][2] = 0.0f;
-        out[i][3] = 1.0f;
-    }
-}
-
-//  Converts color data in RGB32F format to R32F format.  */
-void cmoColorWriter::colorRGBA32FToR32F(Vec4FP32 *in, U08 *out)
-{
-    U32 i;
-
-    //  Convert all pixels in the stamp.
-    for(i = 0; i < STAMP_FRAGMENTS; i++)
-    {
-        //  Convert 32 bit float point color components to 16 bit float point color components.
-        ((F32 *) out)[i] = in[i][0];
-    }
-}
-
-
-#define GAMMA(x) F32(GPU_POWER(F64(x), F64(1.0f / 2.2f)))
-#define LINEAR(x) F32(GPU_POWER(F64(x), F64(2.2f)))
-
-//  Converts color data from linear space to sRGB space.
-void cmoColorWriter::colorLinearToSRGB(Vec4FP32 *in)
-{
-    //  NOTE: Alpha shouldn't be affected by the color space conversion.
-
-    for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-    {
-        //  Convert from linear space to sRGB space.
-        in[f][0] = GAMMA(in[f][0]);
-        in[f][1] = GAMMA(in[f][1]);
-        in[f][2] = GAMMA(in[f][2]);
-    }
-}
-
-//  Converts color data from sRGB space to linear space.
-void cmoColorWriter::colorSRGBToLinear(Vec4FP32 *in)
-{
-    for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-    {
-        //  NOTE: Alpha shouldn't be affected by the color space conversion.
-
-        //  Convert from sRGB space to linear space.
-        in[f][0] = LINEAR(in[f][0]);
-        in[f][1] = LINEAR(in[f][1]);
-        in[f][2] = LINEAR(in[f][2]);
-    }
-}
-
 //  Returns the unit fragment latency map.  
 U32 *cmoColorWriter::getLatencyMap(U32 &mapWidth, U32 &mapHeight)
 {
@@ -31,6 +31,7 @@
 #include "bmFragmentOperator.h"
 #include "GenericROP.h"
 #include "ValidationInfo.h"
+#include "ROPStampKernels.h"
 
 namespace arch
 {
@@ -117,6 +118,11 @@ private:
     //  Color cache blend output color data array.  
     U08 *outColor;            //  Stores blended color data before logic op & write.  
 
+    //  Stamp kernels selected for the current render target state.
+    ROPColorKernels rtKernels[MAX_RENDER_TARGETS];              //  Color conversion kernels for each render target.
+    ROPBlendState blendState[MAX_RENDER_TARGETS];               //  Blend state for each render target.
+    bool rtWriteMask[MAX_RENDER_TARGETS][MAX_BYTES_PER_COLOR];  //  Byte write mask for a pixel of each render target.
+
     //  Color Clear state.  
     U32 copyStateCycles;     //  Number of cycles remaining for the copy of the block state memory.  
 
@@ -259,133 +265,13 @@ private:
 
     /**
      *
-     *  Converts an array of color values in RGBA8 format to RGBA32F format.
-     *
-     *  @param in The input color array in RGBA8 format.
-     *  @param out The output color array in RGBA32F format.
-     *
-     */
-
-    void colorRGBA8ToRGBA32F(U08 *in, Vec4FP32 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RGBA32F format to RGBA8 format.
-     *
-     *  @param in The input color array in RGBA32F format.
-     *  @param out The output color array in RGBA8 format.
-     *
-     */
-
-    void colorRGBA32FToRGBA8(Vec4FP32 *in, U08 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RGBA16F format to RGBA32F format.
-     *
-     *  @param in The input color array in RGBA16F format.
-     *  @param out The output color array in RGBA32F format.
-     *
-     */
-
-    void colorRGBA16FToRGBA32F(U08 *in, Vec4FP32 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RGBA32F format to RGBA16F format.
-     *
-     *  @param in The input color array in RGBA32F format.
-     *  @param out The output color array in RGBA16F format.
-     *
-     */
-
-    void colorRGBA32FToRGBA16F(Vec4FP32 *in, U08 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RGBA16 format to RGBA32F format.
-     *
-     *  @param in The input color array in RGBA16 format.
-     *  @param out The output color array in RGBA32F format.
-     *
-     */
-
-    void colorRGBA16ToRGBA32F(U08 *in, Vec4FP32 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RGBA32F format to RGBA16 format.
-     *
-     *  @param in The input color array in RGBA32F format.
-     *  @param out The output color array in RGBA16 format.
+     *  Selects the stamp kernels (color conversion, blending and write mask) for the
+     *  current state of the render targets.  Called when the render target state is
+     *  latched at the start of a batch and on reset.
      *
      */
 
-    void colorRGBA32FToRGBA16(Vec4FP32 *in, U08 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RG16F format to RGBA32F format.
-     *
-     *  @param in The input color array in RG16F format.
-     *  @param out The output color array in RGBA32F format.
-     *
-     */
-
-    void colorRG16FToRGBA32F(U08 *in, Vec4FP32 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RGBA32F format to RG16F format.
-     *
-     *  @param in The input color array in RGBA32F format.
-     *  @param out The output color array in RG16F format.
-     *
-     */
-
-    void colorRGBA32FToRG16F(Vec4FP32 *in, U08 *out);
-
-    /**
-     *
-     *  Converts an array of color values in R32F format to RGBA32F format.
-     *
-     *  @param in The input color array in R32F format.
-     *  @param out The output color array in RGBA32F format.
-     *
-     */
-
-    void colorR32FToRGBA32F(U08 *in, Vec4FP32 *out);
-
-    /**
-     *
-     *  Converts an array of color values in RGBA32F format to R32F format.
-     *
-     *  @param in The input color array in RGBA32F format.
-     *  @param out The output color array in R32F format.
-     *
-     */
-
-    void colorRGBA32FToR32F(Vec4FP32 *in, U08 *out);
-
-    /**
-     *
-     *  Converts an array of 32-bit float point color values from linear to sRGB space.
-     *
-     *  @param in A pointer to the array of color values.
-     *
-     */
-     
-    void colorLinearToSRGB(Vec4FP32 *in);
-
-    /**
-     *
-     *  Converts an array of 32-bit float point color values from sRGB to linear space.
-     *
-     *  @param in A pointer to the array of color values.
-     *
-     */
-     
-    void colorSRGBToLinear(Vec4FP32 *in);
+    void setupStampKernels();
 
 public:
 
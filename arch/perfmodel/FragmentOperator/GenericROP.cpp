@@ -237,7 +237,6 @@ void GenericROP::clock(U64 cycle)
 {
     MemoryTransaction *memTrans;
     RasterizerCommand *rastComm;
-    ROPStatusInfo *consumerStateInfo;
 
     GPU_DEBUG_BOX(
         printf("%s => Clock %lld\n", getName(), cycle);
@@ -280,18 +279,10 @@ void GenericROP::clock(U64 cycle)
 
     //  Check if there is a consumer stage attached to the Generic ROP pipeline
     //  that receives processed fragments from the Generic ROP.
-    if (consumerStateSignal != NULL)
+    if (consumerStateSignal.isBound())
     {
         //  Receive state from the consumer stage.
-        if (consumerStateSignal->read(cycle, (DynamicObject *&) consumerStateInfo))
-        {
-            //  Get consumer state.
-            consumerState = consumerStateInfo->getState();
-
-            //  Delete state container object.
-            delete consumerStateInfo;
-        }
-        else
+        if (!consumerStateSignal.read(cycle, consumerState))
         {
             CG_ASSERT("Missing state signal from consumer stage.");
         }
@@ -541,7 +532,7 @@ void GenericROP::clock(U64 cycle)
         )
 
         //  Send a ready signal.
-        ropStateSignal->write(cycle, new ROPStatusInfo(ROP_READY));
+        ropStateSignal.write(cycle, ROP_READY);
     }
     else
     {
@@ -550,11 +541,11 @@ void GenericROP::clock(U64 cycle)
         )
 
         //  Send a busy signal.
-        ropStateSignal->write(cycle, new ROPStatusInfo(ROP_BUSY));
+        ropStateSignal.write(cycle, ROP_BUSY);
     }
 
     //  Send current rasterizer state.
-    rastState->write(cycle, new RasterizerStateInfo(state));
+    rastState.write(cycle, state);
 }
 
 
@@ -709,8 +700,8 @@ void GenericROP::processStamp()
                 //  Delete fragment.
                 delete fr;
 
-                //  Delete attributes.
-                delete[] attrib;
+                //  Release attributes.
+                FragmentInput::releaseAttributes(attrib);
 
                 //  Delete fragment input.
                 delete stamp[i];
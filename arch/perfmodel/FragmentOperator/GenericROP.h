@@ -23,6 +23,7 @@
 #include "GPUType.h"
 #include "support.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "ROPCache.h"
 #include "GPUReg.h"
 #include "RasterizerState.h"
@@ -37,6 +38,10 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class RasterizerStateInfo;
+class ROPStatusInfo;
+
 
 /**
  *
@@ -275,11 +280,11 @@ protected:
 
     //  Generic ROP signals.  
     Signal *rastCommand;        //  Command signal from the Rasterizer main mdu.  
-    Signal *rastState;          //  State signal to the Rasterizer main mdu.  
+    StateWire<RasterizerStateInfo> rastState;           //  State signal to the Rasterizer main mdu.  
     Signal *inFragmentSignal;   //  Fragment input signal from GPU stage/unit producing fragments for the ROP stage.  
-    Signal *ropStateSignal;     //  State signal to the GPU stage/unit producing fragments for the ROP stage.  
+    StateWire<ROPStatusInfo> ropStateSignal;            //  State signal to the GPU stage/unit producing fragments for the ROP stage.  
     Signal *outFragmentSignal;  //  Fragment output signal to the GPU stage/unit consuming fragments from the ROP stage.  
-    Signal *consumerStateSignal;//  State signal from the GPU stage/unit consuming fragments from the ROP stage.  
+    StateWire<ROPStatusInfo> consumerStateSignal;       //  State signal from the GPU stage/unit consuming fragments from the ROP stage.  
     Signal *memRequest;         //  Memory request signal to the Memory Controller.  
     Signal *memData;            //  Memory data signal from the Memory Controller.  
     Signal *operationStart;     //  Start signal for the simulation of the ROP operation latency.  
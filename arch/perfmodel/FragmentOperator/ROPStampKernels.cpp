@@ -0,0 +1,827 @@
+/**************************************************************************
+ *
+ * ROP Stamp Kernels implementation file.
+ *
+ */
+
+/**
+ *
+ *  @file ROPStampKernels.cpp
+ *
+ *  This file implements the kernels used by the ROP stages to convert, blend
+ *  and mask the color data of a whole stamp.
+ *
+ */
+
+#include "ROPStampKernels.h"
+#include "GPUMath.h"
+#include "support.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define ROP_STAMP_SSE2
+#endif
+
+#if defined(ROP_STAMP_SSE2) && defined(ROP_BLEND_KERNELS)
+    #define ROP_BLEND_SSE2
+#endif
+
+namespace arch
+{
+
+//  Same conversions than the color write helpers.
+#define GAMMA(x) F32(GPU_POWER(F64(x), F64(1.0f / 2.2f)))
+#define LINEAR(x) F32(GPU_POWER(F64(x), F64(2.2f)))
+
+static const F32 UNORM8_SCALE = 1.0f / 255.0f;
+static const F32 UNORM16_SCALE = 1.0f / 65535.0f;
+
+//  Color component values in linear space for the 8-bit normalized values in sRGB space.
+static F32 linearUnorm8[256];
+
+static bool buildLinearUnorm8()
+{
+    for(U32 i = 0; i < 256; i++)
+        linearUnorm8[i] = LINEAR(F32(i) * UNORM8_SCALE);
+
+    return true;
+}
+
+static bool linearUnorm8Built = buildLinearUnorm8();
+
+/**
+ *
+ *  Scalar implementation of the operations used by the clamp and blend kernels.
+ *
+ */
+
+struct ScalarLanes
+{
+    typedef F32 V;
+    static const U32 width = 1;
+
+    static V load(const F32 *p) { return *p; }
+    static void store(F32 *p, V v) { *p = v; }
+    static V set(F32 f) { return f; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V neg(V a) { return -a; }
+    static V min(V a, V b) { return GPU_MIN(a, b); }
+    static V max(V a, V b) { return GPU_MAX(a, b); }
+    static V clamp(V v) { return GPU_CLAMP(v, 0.0f, 1.0f); }
+};
+
+#ifdef ROP_STAMP_SSE2
+
+/**
+ *
+ *  SSE2 implementation of the operations used by the clamp and blend kernels.
+ *
+ *  _mm_min_ps and _mm_max_ps return the second operand when the comparison fails, as GPU_MIN
+ *  and GPU_MAX.  The clamp keeps the comparisons of GPU_CLAMP so -0 and NaN produce the same
+ *  results.
+ *
+ */
+
+struct SSE2Lanes
+{
+    typedef __m128 V;
+    static const U32 width = 4;
+
+    static V load(const F32 *p) { return _mm_loadu_ps(p); }
+    static void store(F32 *p, V v) { _mm_storeu_ps(p, v); }
+    static V set(F32 f) { return _mm_set1_ps(f); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V neg(V a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+
+    static V clamp(V v)
+    {
+        V zero = _mm_setzero_ps();
+        V one = _mm_set1_ps(1.0f);
+        V inRange = _mm_and_ps(_mm_cmple_ps(zero, v), _mm_cmple_ps(v, one));
+        V below = _mm_cmplt_ps(v, zero);
+        V outRange = _mm_or_ps(_mm_and_ps(below, zero), _mm_andnot_ps(below, one));
+        return _mm_or_ps(_mm_and_ps(inRange, v), _mm_andnot_ps(inRange, outRange));
+    }
+};
+
+//  Stores the color of four pixels (a vector per pixel) in SoA layout.
+static inline void storePixels(ROPColorStamp &out, U32 p, __m128 p0, __m128 p1, __m128 p2, __m128 p3)
+{
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+    _mm_storeu_ps(&out.component[0][p], p0);
+    _mm_storeu_ps(&out.component[1][p], p1);
+    _mm_storeu_ps(&out.component[2][p], p2);
+    _mm_storeu_ps(&out.component[3][p], p3);
+}
+
+//  Loads the color of four pixels (a vector per pixel) from SoA layout.
+static inline void loadPixels(const ROPColorStamp &in, U32 p, __m128 &p0, __m128 &p1, __m128 &p2, __m128 &p3)
+{
+    p0 = _mm_loadu_ps(&in.component[0][p]);
+    p1 = _mm_loadu_ps(&in.component[1][p]);
+    p2 = _mm_loadu_ps(&in.component[2][p]);
+    p3 = _mm_loadu_ps(&in.component[3][p]);
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+}
+
+//  Selects a when the mask is set and b otherwise.
+static inline __m128i selectBits(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+//  Converts four float16 values (stored in the low 16 bits of each lane) to float32.
+//  Same results as GPUMath::convertFP16ToFP32.
+static inline __m128 halfToFloat(__m128i h)
+{
+    __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+    __m128i exponent = _mm_and_si128(_mm_srli_epi32(h, 10), _mm_set1_epi32(0x1f));
+    __m128i mantissa = _mm_and_si128(h, _mm_set1_epi32(0x03ff));
+
+    //  Normal values:  exponent from excess 15 to excess 127.
+    __m128i normal = _mm_or_si128(_mm_slli_epi32(_mm_add_epi32(exponent, _mm_set1_epi32(127 - 15)), 23),
+                                  _mm_slli_epi32(mantissa, 13));
+
+    //  Infinite and NaN keep the mantissa bits unshifted.
+    __m128i infNaN = _mm_or_si128(_mm_set1_epi32(0x7f800000), mantissa);
+
+    //  Zeros and denormals are exactly mantissa * 2^-24 (a normal float32).
+    __m128i denorm = _mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(mantissa), _mm_set1_ps(1.0f / 16777216.0f)));
+
+    __m128i zeroExp = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+    __m128i maxExp = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x1f));
+
+    __m128i bits = selectBits(zeroExp, denorm, selectBits(maxExp, infNaN, normal));
+
+    return _mm_castsi128_ps(_mm_or_si128(bits, sign));
+}
+
+//  Converts four float32 values to float16 (in the low 16 bits of each lane).  Same results as
+//  GPUMath::convertFP32ToFP16, the values that become float16 denormals use GPUMath.
+static inline __m128i floatToHalf(__m128 f)
+{
+    __m128i bits = _mm_castps_si128(f);
+    __m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x8000));
+    __m128i exponent = _mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff));
+    __m128i mantissa = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(0x03ff));
+
+    //  Normal values:  exponent from excess 127 to excess 15.
+    __m128i normal = _mm_or_si128(_mm_slli_epi32(_mm_sub_epi32(exponent, _mm_set1_epi32(127 - 15)), 10), mantissa);
+
+    //  Float32 zeros and denormals are flushed to zero.  Exponents not representable in float16
+    //  (including infinite and NaN) are flushed to infinite.
+    __m128i zeroExp = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+    __m128i overflow = _mm_cmpgt_epi32(exponent, _mm_set1_epi32(127 + 15));
+
+    __m128i half = selectBits(zeroExp, _mm_setzero_si128(), selectBits(overflow, _mm_set1_epi32(0x7c00), normal));
+    half = _mm_or_si128(half, sign);
+
+    //  Values that become float16 denormals.
+    __m128i denorm = _mm_andnot_si128(zeroExp, _mm_cmplt_epi32(exponent, _mm_set1_epi32(127 - 15 + 1)));
+    S32 denormLanes = _mm_movemask_ps(_mm_castsi128_ps(denorm));
+
+    if (denormLanes != 0)
+    {
+        alignas(16) F32 value[4];
+        alignas(16) U32 result[4];
+
+        _mm_store_ps(value, f);
+        _mm_store_si128((__m128i *) result, half);
+
+        for(U32 l = 0; l < 4; l++)
+        {
+            if ((denormLanes & (1 << l)) != 0)
+                result[l] = GPUMath::convertFP32ToFP16(value[l]);
+        }
+
+        half = _mm_load_si128((const __m128i *) result);
+    }
+
+    return half;
+}
+
+//  Packs eight 32-bit lanes with values in [0, 65535] to 16-bit.
+static inline __m128i packU16(__m128i a, __m128i b)
+{
+    __m128i bias = _mm_set1_epi32(0x8000);
+    __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias), _mm_sub_epi32(b, bias));
+    return _mm_xor_si128(packed, _mm_set1_epi16(S16(0x8000)));
+}
+
+#endif  // ROP_STAMP_SSE2
+
+//  Clamps the color components of the pixels [first, pixels) in groups of the lane width.
+template<class L>
+static U32 clampPixels(ROPColorStamp &color, U32 first, U32 pixels)
+{
+    U32 p = first;
+
+    for(; (p + L::width) <= pixels; p += L::width)
+        for(U32 c = 0; c < 4; c++)
+            L::store(&color.component[c][p], L::clamp(L::load(&color.component[c][p])));
+
+    return p;
+}
+
+//  Computes the blend factor for a RGB component (see bmoFragmentOperator::factorRGB).
+template<class L>
+static inline typename L::V factorRGB(BlendFunction bf, U32 c, const typename L::V *s, const typename L::V *d,
+                                      const F32 *constant)
+{
+    switch(bf)
+    {
+        case BLEND_ZERO:                        return L::set(0.0f);
+        case BLEND_ONE:                         return L::set(1.0f);
+        case BLEND_SRC_COLOR:                   return s[c];
+        case BLEND_ONE_MINUS_SRC_COLOR:         return L::sub(L::set(1.0f), s[c]);
+        case BLEND_DST_COLOR:                   return d[c];
+        case BLEND_ONE_MINUS_DST_COLOR:         return L::sub(L::set(1.0f), d[c]);
+        case BLEND_SRC_ALPHA:                   return s[3];
+        case BLEND_ONE_MINUS_SRC_ALPHA:         return L::sub(L::set(1.0f), s[3]);
+        case BLEND_DST_ALPHA:                   return d[3];
+        case BLEND_ONE_MINUS_DST_ALPHA:         return L::sub(L::set(1.0f), d[3]);
+        case BLEND_CONSTANT_COLOR:              return L::set(constant[c]);
+        case BLEND_ONE_MINUS_CONSTANT_COLOR:    return L::set(1.0f - constant[c]);
+        case BLEND_CONSTANT_ALPHA:              return L::set(constant[3]);
+        case BLEND_ONE_MINUS_CONSTANT_ALPHA:    return L::set(1.0f - constant[3]);
+        case BLEND_SRC_ALPHA_SATURATE:          return L::min(s[3], L::sub(L::set(1.0f), d[3]));
+
+        default:
+            CG_ASSERT("Unsupported blend factor function.");
+            break;
+    }
+
+    return L::set(0.0f);
+}
+
+//  Computes the blend factor for the alpha component (see bmoFragmentOperator::factorAlpha).
+template<class L>
+static inline typename L::V factorAlpha(BlendFunction bf, const typename L::V *s, const typename L::V *d,
+                                        const F32 *constant)
+{
+    switch(bf)
+    {
+        case BLEND_ZERO:
+            return L::set(0.0f);
+
+        case BLEND_ONE:
+        case BLEND_SRC_ALPHA_SATURATE:
+            return L::set(1.0f);
+
+        case BLEND_SRC_COLOR:
+        case BLEND_SRC_ALPHA:
+            return s[3];
+
+        case BLEND_ONE_MINUS_SRC_COLOR:
+        case BLEND_ONE_MINUS_SRC_ALPHA:
+            return L::sub(L::set(1.0f), s[3]);
+
+        case BLEND_DST_COLOR:
+        case BLEND_DST_ALPHA:
+            return d[3];
+
+        case BLEND_ONE_MINUS_DST_COLOR:
+        case BLEND_ONE_MINUS_DST_ALPHA:
+            return L::sub(L::set(1.0f), d[3]);
+
+        case BLEND_CONSTANT_COLOR:
+        case BLEND_CONSTANT_ALPHA:
+            return L::set(constant[3]);
+
+        case BLEND_ONE_MINUS_CONSTANT_COLOR:
+        case BLEND_ONE_MINUS_CONSTANT_ALPHA:
+            return L::set(1.0f - constant[3]);
+
+        default:
+            CG_ASSERT("Unsupported blend factor function.");
+            break;
+    }
+
+    return L::set(0.0f);
+}
+
+//  Blends the pixels [first, pixels) in groups of the lane width.
+template<class L, BlendEquation EQUATION>
+static U32 blendPixels(const ROPBlendState &state, ROPColorStamp &color, const ROPColorStamp &dest, U32 first, U32 pixels)
+{
+    typedef typename L::V V;
+
+    U32 p = first;
+
+    for(; (p + L::width) <= pixels; p += L::width)
+    {
+        V s[4];
+        V d[4];
+        V result[4];
+
+        for(U32 c = 0; c < 4; c++)
+        {
+            s[c] = L::load(&color.component[c][p]);
+            d[c] = L::load(&dest.component[c][p]);
+        }
+
+        for(U32 c = 0; c < 4; c++)
+        {
+            if (EQUATION == BLEND_MIN)
+                result[c] = L::min(s[c], d[c]);
+            else if (EQUATION == BLEND_MAX)
+                result[c] = L::max(s[c], d[c]);
+            else
+            {
+                V sFactor = (c < 3) ? factorRGB<L>(state.srcRGB, c, s, d, state.constantColor) :
+                                      factorAlpha<L>(state.srcAlpha, s, d, state.constantColor);
+                V dFactor = (c < 3) ? factorRGB<L>(state.dstRGB, c, s, d, state.constantColor) :
+                                      factorAlpha<L>(state.dstAlpha, s, d, state.constantColor);
+
+                if (EQUATION == BLEND_FUNC_ADD)
+                    result[c] = L::add(L::mul(s[c], sFactor), L::mul(d[c], dFactor));
+                else if (EQUATION == BLEND_FUNC_SUBTRACT)
+                    result[c] = L::sub(L::mul(s[c], sFactor), L::mul(d[c], dFactor));
+                else
+                    result[c] = L::add(L::mul(L::neg(s[c]), sFactor), L::mul(d[c], dFactor));
+            }
+        }
+
+        for(U32 c = 0; c < 4; c++)
+            L::store(&color.component[c][p], result[c]);
+    }
+
+    return p;
+}
+
+template<BlendEquation EQUATION>
+static void blendKernel(const ROPBlendState &state, ROPColorStamp &color, const ROPColorStamp &dest, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_BLEND_SSE2
+    p = blendPixels<SSE2Lanes, EQUATION>(state, color, dest, p, pixels);
+#endif
+
+    blendPixels<ScalarLanes, EQUATION>(state, color, dest, p, pixels);
+}
+
+//  Converts color data from RGBA8 format to RGBA32F format.
+static void decodeRGBA8(const U08 *in, ROPColorStamp &out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128 scale = _mm_set1_ps(UNORM8_SCALE);
+
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128i data = _mm_loadu_si128((const __m128i *) &in[p * 4]);
+        __m128i lo = _mm_unpacklo_epi8(data, zero);
+        __m128i hi = _mm_unpackhi_epi8(data, zero);
+
+        storePixels(out, p, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale),
+                            _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale),
+                            _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale),
+                            _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+    }
+#endif
+
+    for(; p < pixels; p++)
+        for(U32 c = 0; c < 4; c++)
+            out.component[c][p] = F32(in[p * 4 + c]) * UNORM8_SCALE;
+}
+
+//  Converts color data from RGBA8 format in sRGB space to RGBA32F format in linear space.
+static void decodeRGBA8SRGB(const U08 *in, ROPColorStamp &out, U32 pixels)
+{
+    for(U32 p = 0; p < pixels; p++)
+    {
+        out.component[0][p] = linearUnorm8[in[p * 4 + 0]];
+        out.component[1][p] = linearUnorm8[in[p * 4 + 1]];
+        out.component[2][p] = linearUnorm8[in[p * 4 + 2]];
+        out.component[3][p] = F32(in[p * 4 + 3]) * UNORM8_SCALE;
+    }
+}
+
+//  Converts color data in RGBA32F format to RGBA8 format.
+static void encodeRGBA8(ROPColorStamp &in, U08 *out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    __m128 scale = _mm_set1_ps(255.0f);
+
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128 p0, p1, p2, p3;
+        loadPixels(in, p, p0, p1, p2, p3);
+
+        __m128i i0 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p0)));
+        __m128i i1 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p1)));
+        __m128i i2 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p2)));
+        __m128i i3 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p3)));
+
+        _mm_storeu_si128((__m128i *) &out[p * 4], _mm_packus_epi16(_mm_packs_epi32(i0, i1), _mm_packs_epi32(i2, i3)));
+    }
+#endif
+
+    for(; p < pixels; p++)
+        for(U32 c = 0; c < 4; c++)
+            out[p * 4 + c] = U32(255.0f * GPU_CLAMP(in.component[c][p], 0.0f, 1.0f));
+}
+
+//  Converts color data from RGBA16 format to RGBA32F format.
+static void decodeRGBA16(const U08 *in, ROPColorStamp &out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128 scale = _mm_set1_ps(UNORM16_SCALE);
+
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128i d01 = _mm_loadu_si128((const __m128i *) &in[p * 8]);
+        __m128i d23 = _mm_loadu_si128((const __m128i *) &in[p * 8 + 16]);
+
+        storePixels(out, p, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d01, zero)), scale),
+                            _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d01, zero)), scale),
+                            _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d23, zero)), scale),
+                            _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d23, zero)), scale));
+    }
+#endif
+
+    for(; p < pixels; p++)
+        for(U32 c = 0; c < 4; c++)
+            out.component[c][p] = F32(((const U16 *) in)[p * 4 + c]) * UNORM16_SCALE;
+}
+
+//  Converts color data in RGBA32F format to RGBA16 format.
+static void encodeRGBA16(ROPColorStamp &in, U08 *out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    __m128 scale = _mm_set1_ps(65535.0f);
+
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128 p0, p1, p2, p3;
+        loadPixels(in, p, p0, p1, p2, p3);
+
+        __m128i i0 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p0)));
+        __m128i i1 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p1)));
+        __m128i i2 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p2)));
+        __m128i i3 = _mm_cvttps_epi32(_mm_mul_ps(scale, SSE2Lanes::clamp(p3)));
+
+        _mm_storeu_si128((__m128i *) &out[p * 8], packU16(i0, i1));
+        _mm_storeu_si128((__m128i *) &out[p * 8 + 16], packU16(i2, i3));
+    }
+#endif
+
+    for(; p < pixels; p++)
+        for(U32 c = 0; c < 4; c++)
+            ((U16 *) out)[p * 4 + c] = U16(65535.0f * GPU_CLAMP(in.component[c][p], 0.0f, 1.0f));
+}
+
+//  Converts color data from RGBA16F format to RGBA32F format.
+static void decodeRGBA16F(const U08 *in, ROPColorStamp &out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    __m128i zero = _mm_setzero_si128();
+
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128i d01 = _mm_loadu_si128((const __m128i *) &in[p * 8]);
+        __m128i d23 = _mm_loadu_si128((const __m128i *) &in[p * 8 + 16]);
+
+        storePixels(out, p, halfToFloat(_mm_unpacklo_epi16(d01, zero)), halfToFloat(_mm_unpackhi_epi16(d01, zero)),
+                            halfToFloat(_mm_unpacklo_epi16(d23, zero)), halfToFloat(_mm_unpackhi_epi16(d23, zero)));
+    }
+#endif
+
+    for(; p < pixels; p++)
+        for(U32 c = 0; c < 4; c++)
+            out.component[c][p] = GPUMath::convertFP16ToFP32(((const U16 *) in)[p * 4 + c]);
+}
+
+//  Converts color data in RGBA32F format to RGBA16F format.
+static void encodeRGBA16F(ROPColorStamp &in, U08 *out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128 p0, p1, p2, p3;
+        loadPixels(in, p, p0, p1, p2, p3);
+
+        _mm_storeu_si128((__m128i *) &out[p * 8], packU16(floatToHalf(p0), floatToHalf(p1)));
+        _mm_storeu_si128((__m128i *) &out[p * 8 + 16], packU16(floatToHalf(p2), floatToHalf(p3)));
+    }
+#endif
+
+    for(; p < pixels; p++)
+        for(U32 c = 0; c < 4; c++)
+            ((U16 *) out)[p * 4 + c] = GPUMath::convertFP32ToFP16(in.component[c][p]);
+}
+
+//  Converts color data from RG16F format to RGBA32F format.
+static void decodeRG16F(const U08 *in, ROPColorStamp &out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    __m128i zero = _mm_setzero_si128();
+
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128i data = _mm_loadu_si128((const __m128i *) &in[p * 4]);
+        __m128 rg01 = halfToFloat(_mm_unpacklo_epi16(data, zero));
+        __m128 rg23 = halfToFloat(_mm_unpackhi_epi16(data, zero));
+
+        _mm_storeu_ps(&out.component[0][p], _mm_shuffle_ps(rg01, rg23, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(&out.component[1][p], _mm_shuffle_ps(rg01, rg23, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm_storeu_ps(&out.component[2][p], _mm_setzero_ps());
+        _mm_storeu_ps(&out.component[3][p], _mm_set1_ps(1.0f));
+    }
+#endif
+
+    for(; p < pixels; p++)
+    {
+        out.component[0][p] = GPUMath::convertFP16ToFP32(((const U16 *) in)[p * 2]);
+        out.component[1][p] = GPUMath::convertFP16ToFP32(((const U16 *) in)[p * 2 + 1]);
+        out.component[2][p] = 0.0f;
+        out.component[3][p] = 1.0f;
+    }
+}
+
+//  Converts color data in RGBA32F format to RG16F format.
+static void encodeRG16F(ROPColorStamp &in, U08 *out, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    for(; (p + 4) <= pixels; p += 4)
+    {
+        __m128 r = _mm_loadu_ps(&in.component[0][p]);
+        __m128 g = _mm_loadu_ps(&in.component[1][p]);
+
+        _mm_storeu_si128((__m128i *) &out[p * 4], packU16(floatToHalf(_mm_unpacklo_ps(r, g)),
+                                                          floatToHalf(_mm_unpackhi_ps(r, g))));
+    }
+#endif
+
+    for(; p < pixels; p++)
+    {
+        ((U16 *) out)[p * 2]     = GPUMath::convertFP32ToFP16(in.component[0][p]);
+        ((U16 *) out)[p * 2 + 1] = GPUMath::convertFP32ToFP16(in.component[1][p]);
+    }
+}
+
+//  Converts color data from R32F format to RGBA32F format.
+static void decodeR32F(const U08 *in, ROPColorStamp &out, U32 pixels)
+{
+    memcpy(out.component[0], in, pixels * sizeof(F32));
+
+    for(U32 p = 0; p < pixels; p++)
+    {
+        out.component[1][p] = 0.0f;
+        out.component[2][p] = 0.0f;
+        out.component[3][p] = 1.0f;
+    }
+}
+
+//  Converts color data in RGBA32F format to R32F format.
+static void encodeR32F(ROPColorStamp &in, U08 *out, U32 pixels)
+{
+    memcpy(out, in.component[0], pixels * sizeof(F32));
+}
+
+//  Converts the RGB components from sRGB space to linear space.  Alpha isn't affected by the
+//  color space conversion.
+static void colorSRGBToLinear(ROPColorStamp &color, U32 pixels)
+{
+    for(U32 c = 0; c < 3; c++)
+        for(U32 p = 0; p < pixels; p++)
+            color.component[c][p] = LINEAR(color.component[c][p]);
+}
+
+//  Converts the RGB components from linear space to sRGB space.  Alpha isn't affected by the
+//  color space conversion.
+static void colorLinearToSRGB(ROPColorStamp &color, U32 pixels)
+{
+    for(U32 c = 0; c < 3; c++)
+        for(U32 p = 0; p < pixels; p++)
+            color.component[c][p] = GAMMA(color.component[c][p]);
+}
+
+template<ROPColorDecoder DECODE>
+static void decodeSRGB(const U08 *in, ROPColorStamp &out, U32 pixels)
+{
+    DECODE(in, out, pixels);
+    colorSRGBToLinear(out, pixels);
+}
+
+template<ROPColorEncoder ENCODE>
+static void encodeSRGB(ROPColorStamp &in, U08 *out, U32 pixels)
+{
+    colorLinearToSRGB(in, pixels);
+    ENCODE(in, out, pixels);
+}
+
+void ROPStampKernels::selectColorKernels(TextureFormat format, bool sRGB, ROPColorKernels &kernels)
+{
+    kernels.clampInput = false;
+
+    switch(format)
+    {
+        case GPU_RGBA8888:
+            kernels.decode = sRGB ? decodeRGBA8SRGB : decodeRGBA8;
+            kernels.encode = sRGB ? encodeSRGB<encodeRGBA8> : encodeRGBA8;
+            kernels.clampInput = true;
+            kernels.bytesPixel = 4;
+            break;
+
+        case GPU_RG16F:
+            kernels.decode = sRGB ? decodeSRGB<decodeRG16F> : decodeRG16F;
+            kernels.encode = sRGB ? encodeSRGB<encodeRG16F> : encodeRG16F;
+            kernels.bytesPixel = 4;
+            break;
+
+        case GPU_R32F:
+            kernels.decode = sRGB ? decodeSRGB<decodeR32F> : decodeR32F;
+            kernels.encode = sRGB ? encodeSRGB<encodeR32F> : encodeR32F;
+            kernels.bytesPixel = 4;
+            break;
+
+        case GPU_RGBA16:
+            kernels.decode = sRGB ? decodeSRGB<decodeRGBA16> : decodeRGBA16;
+            kernels.encode = sRGB ? encodeSRGB<encodeRGBA16> : encodeRGBA16;
+            kernels.bytesPixel = 8;
+            break;
+
+        case GPU_RGBA16F:
+            kernels.decode = sRGB ? decodeSRGB<decodeRGBA16F> : decodeRGBA16F;
+            kernels.encode = sRGB ? encodeSRGB<encodeRGBA16F> : encodeRGBA16F;
+            kernels.bytesPixel = 8;
+            break;
+
+        default:
+
+            //  Not a render target format.  Checked when a stamp is processed.
+            kernels.decode = NULL;
+            kernels.encode = NULL;
+            kernels.bytesPixel = 4;
+            break;
+    }
+}
+
+U32 ROPStampKernels::colorWriteMask(TextureFormat format, bool writeR, bool writeG, bool writeB, bool writeA, bool *mask)
+{
+    switch(format)
+    {
+        case GPU_RGBA8888:
+            mask[0] = writeR;
+            mask[1] = writeG;
+            mask[2] = writeB;
+            mask[3] = writeA;
+            return 4;
+
+        case GPU_RG16F:
+            mask[0] = mask[1] = writeR;
+            mask[2] = mask[3] = writeG;
+            return 4;
+
+        case GPU_R32F:
+            mask[0] = mask[1] = mask[2] = mask[3] = writeR;
+            return 4;
+
+        case GPU_RGBA16:
+        case GPU_RGBA16F:
+            mask[0] = mask[1] = writeR;
+            mask[2] = mask[3] = writeG;
+            mask[4] = mask[5] = writeB;
+            mask[6] = mask[7] = writeA;
+            return 8;
+
+        default:
+            mask[0] = mask[1] = mask[2] = mask[3] = false;
+            return 4;
+    }
+}
+
+void ROPStampKernels::writeMask(bool *mask, const bool *pixelMask, U32 bytesPixel, const bool *covered, U32 pixels)
+{
+    bool notCovered[MAX_BYTES_PER_COLOR];
+
+    memset(notCovered, 0, sizeof(notCovered));
+
+    for(U32 p = 0; p < pixels; p++)
+    {
+        const bool *source = ((covered == NULL) || covered[p]) ? pixelMask : notCovered;
+
+        switch(bytesPixel)
+        {
+            case 4:
+                memcpy(&mask[p * 4], source, 4);
+                break;
+
+            case 8:
+                memcpy(&mask[p * 8], source, 8);
+                break;
+
+            default:
+                memcpy(&mask[p * bytesPixel], source, bytesPixel);
+                break;
+        }
+    }
+}
+
+void ROPStampKernels::clamp(ROPColorStamp &color, U32 pixels)
+{
+    U32 p = 0;
+
+#ifdef ROP_STAMP_SSE2
+    p = clampPixels<SSE2Lanes>(color, p, pixels);
+#endif
+
+    clampPixels<ScalarLanes>(color, p, pixels);
+}
+
+void ROPStampKernels::setupBlend(ROPBlendState &state, BlendEquation eq, BlendFunction sRGB, BlendFunction sA,
+                                 BlendFunction dRGB, BlendFunction dA, Vec4FP32 color)
+{
+    state.equation = eq;
+    state.srcRGB = sRGB;
+    state.srcAlpha = sA;
+    state.dstRGB = dRGB;
+    state.dstAlpha = dA;
+
+    for(U32 c = 0; c < 4; c++)
+        state.constantColor[c] = color[c];
+
+    switch(eq)
+    {
+        case BLEND_FUNC_ADD:                state.kernel = blendKernel<BLEND_FUNC_ADD>;                 break;
+        case BLEND_FUNC_SUBTRACT:           state.kernel = blendKernel<BLEND_FUNC_SUBTRACT>;            break;
+        case BLEND_FUNC_REVERSE_SUBTRACT:   state.kernel = blendKernel<BLEND_FUNC_REVERSE_SUBTRACT>;    break;
+        case BLEND_MIN:                     state.kernel = blendKernel<BLEND_MIN>;                      break;
+        case BLEND_MAX:                     state.kernel = blendKernel<BLEND_MAX>;                      break;
+
+        default:
+
+            //  Checked when a stamp is blended.
+            state.kernel = NULL;
+            break;
+    }
+}
+
+void ROPStampKernels::blend(const ROPBlendState &state, ROPColorStamp &color, const ROPColorStamp &dest, U32 pixels)
+{
+    CG_ASSERT_COND((state.kernel != NULL), "Unsupported blend equation mode.");
+
+    state.kernel(state, color, dest, pixels);
+}
+
+void ROPStampKernels::blendEmulated(bmoFragmentOperator &frEmu, U32 rt, ROPColorStamp &color, const ROPColorStamp &dest,
+                                    U32 pixels)
+{
+    Vec4FP32 source[STAMP_FRAGMENTS];
+    Vec4FP32 destination[STAMP_FRAGMENTS];
+
+    for(U32 first = 0; first < pixels; first += STAMP_FRAGMENTS)
+    {
+        for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+        {
+            for(U32 c = 0; c < 4; c++)
+            {
+                source[f][c] = color.component[c][first + f];
+                destination[f][c] = dest.component[c][first + f];
+            }
+        }
+
+        frEmu.blend(rt, source, source, destination);
+
+        for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+            for(U32 c = 0; c < 4; c++)
+                color.component[c][first + f] = source[f][c];
+    }
+}
+
+const char *ROPStampKernels::getImplementation()
+{
+#ifdef ROP_STAMP_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace arch
@@ -0,0 +1,243 @@
+/**************************************************************************
+ *
+ * ROP Stamp Kernels definition file.
+ *
+ */
+
+/**
+ *
+ *  @file ROPStampKernels.h
+ *
+ *  This file defines the kernels used by the ROP stages to convert, blend
+ *  and mask the color data of a whole stamp (all the fragments and all the
+ *  MSAA samples) with a single call.
+ *
+ */
+
+#ifndef _ROPSTAMPKERNELS_
+
+#define _ROPSTAMPKERNELS_
+
+#include "GPUType.h"
+#include "GPUReg.h"
+#include "Vec4FP32.h"
+#include "bmFragmentOperator.h"
+
+//  The blend kernels keep the operation order of bmoFragmentOperator::blend.  When the compiler is
+//  allowed to fuse multiply-adds the results could differ so the blend emulation must be used
+//  (see ROPStampKernels::blendEmulated).
+#if !defined(__FMA__)
+    #define ROP_BLEND_KERNELS
+#endif
+
+namespace arch
+{
+
+//  Maximum number of pixels (fragments or samples) in a stamp for a render target.
+static const U32 MAX_STAMP_PIXELS = STAMP_FRAGMENTS * MAX_MSAA_SAMPLES;
+
+/**
+ *
+ *  Stores the color of the pixels (fragments or samples) of a stamp for a render
+ *  target in SoA layout:  an array per color component.
+ *
+ *  Pixel p of the stamp is stored in component[0..3][p] (red, green, blue and alpha).
+ *
+ */
+
+struct ROPColorStamp
+{
+    alignas(16) F32 component[4][MAX_STAMP_PIXELS];
+};
+
+/**
+ *
+ *  Converts the data for a number of pixels from a render target format to RGBA32F
+ *  (and to linear space for sRGB render targets).
+ *
+ */
+
+typedef void (*ROPColorDecoder)(const U08 *in, ROPColorStamp &out, U32 pixels);
+
+/**
+ *
+ *  Converts the color for a number of pixels from RGBA32F (and from linear space for
+ *  sRGB render targets) to a render target format.  The input color may be modified.
+ *
+ */
+
+typedef void (*ROPColorEncoder)(ROPColorStamp &in, U08 *out, U32 pixels);
+
+/**
+ *
+ *  Kernels selected for the format of a render target.
+ *
+ */
+
+struct ROPColorKernels
+{
+    ROPColorDecoder decode;     //  Converts render target data to the internal color format.
+    ROPColorEncoder encode;     //  Converts the internal color format to render target data.
+    bool clampInput;            //  The fragment color must be clamped to [0, 1] (normalized formats).
+    U32 bytesPixel;             //  Bytes per pixel for the render target format.
+};
+
+struct ROPBlendState;
+
+/**
+ *
+ *  Blends the source color with the destination color for a number of pixels.  The
+ *  result is stored over the source color.
+ *
+ */
+
+typedef void (*ROPBlendKernel)(const ROPBlendState &state, ROPColorStamp &color, const ROPColorStamp &dest, U32 pixels);
+
+/**
+ *
+ *  Blend state for a render target.
+ *
+ */
+
+struct ROPBlendState
+{
+    ROPBlendKernel kernel;      //  Kernel implementing the blend equation.
+    BlendEquation equation;     //  Blend equation.
+    BlendFunction srcRGB;       //  Source RGB weight function.
+    BlendFunction srcAlpha;     //  Source alpha weight function.
+    BlendFunction dstRGB;       //  Destination RGB weight function.
+    BlendFunction dstAlpha;     //  Destination alpha weight function.
+    F32 constantColor[4];       //  Blend constant color.
+};
+
+/**
+ *
+ *  This class implements the stamp wide color kernels of the ROP stages.
+ *
+ *  The kernels are selected once for a render target state (see selectColorKernels and
+ *  setupBlend) and then process all the pixels of a stamp and render target with one call.
+ *  When SSE2 is available the kernels process four pixels per instruction, otherwise the
+ *  scalar implementation is used.  The results are bit identical to the per pixel
+ *  conversions and to bmoFragmentOperator::blend.
+ *
+ */
+
+class ROPStampKernels
+{
+public:
+
+    /**
+     *
+     *  Selects the conversion kernels for a render target format.
+     *
+     *  @param format The render target format.
+     *  @param sRGB Convert from linear to sRGB space on write (and from sRGB to linear
+     *  space on read).
+     *  @param kernels Reference to the structure where to store the selected kernels.
+     *
+     */
+
+    static void selectColorKernels(TextureFormat format, bool sRGB, ROPColorKernels &kernels);
+
+    /**
+     *
+     *  Builds the byte write mask for a pixel of a render target from the per component
+     *  write masks.
+     *
+     *  @param format The render target format.
+     *  @param writeR Write mask for the red component.
+     *  @param writeG Write mask for the green component.
+     *  @param writeB Write mask for the blue component.
+     *  @param writeA Write mask for the alpha component.
+     *  @param mask Pointer to an array of MAX_BYTES_PER_COLOR entries where to store the
+     *  write mask for a pixel.
+     *
+     *  @return The bytes per pixel for the format.
+     *
+     */
+
+    static U32 colorWriteMask(TextureFormat format, bool writeR, bool writeG, bool writeB, bool writeA, bool *mask);
+
+    /**
+     *
+     *  Builds the byte write mask for a number of pixels.
+     *
+     *  @param mask Pointer to the stamp write mask array.
+     *  @param pixelMask Write mask for the bytes of a pixel.
+     *  @param bytesPixel Bytes per pixel.
+     *  @param covered Pointer to an array with the coverage for each pixel.  If NULL all
+     *  the pixels are written.
+     *  @param pixels Number of pixels.
+     *
+     */
+
+    static void writeMask(bool *mask, const bool *pixelMask, U32 bytesPixel, const bool *covered, U32 pixels);
+
+    /**
+     *
+     *  Clamps the color components of a number of pixels to [0, 1].  NaN is clamped to 1.
+     *
+     *  @param color Reference to the stamp color.
+     *  @param pixels Number of pixels.
+     *
+     */
+
+    static void clamp(ROPColorStamp &color, U32 pixels);
+
+    /**
+     *
+     *  Sets the blend state and selects the blend kernel for a render target.
+     *
+     *  @param state Reference to the blend state to set.
+     *  @param eq The blend equation.
+     *  @param sRGB Source RGB weight function.
+     *  @param sA Source alpha weight function.
+     *  @param dRGB Destination RGB weight function.
+     *  @param dA Destination alpha weight function.
+     *  @param color Blend constant color.
+     *
+     */
+
+    static void setupBlend(ROPBlendState &state, BlendEquation eq, BlendFunction sRGB, BlendFunction sA,
+                           BlendFunction dRGB, BlendFunction dA, Vec4FP32 color);
+
+    /**
+     *
+     *  Blends the source color with the destination color using the render target blend state.
+     *
+     *  @param state The render target blend state.
+     *  @param color Reference to the source color, stores the blended color.
+     *  @param dest Reference to the destination color.
+     *  @param pixels Number of pixels.
+     *
+     */
+
+    static void blend(const ROPBlendState &state, ROPColorStamp &color, const ROPColorStamp &dest, U32 pixels);
+
+    /**
+     *
+     *  Blends the source color with the destination color using the blend emulation, a
+     *  stamp (STAMP_FRAGMENTS pixels) at a time.
+     *
+     *  @param frEmu Reference to the fragment operation emulator configured for the render target.
+     *  @param rt The render target.
+     *  @param color Reference to the source color, stores the blended color.
+     *  @param dest Reference to the destination color.
+     *  @param pixels Number of pixels.
+     *
+     */
+
+    static void blendEmulated(bmoFragmentOperator &frEmu, U32 rt, ROPColorStamp &color, const ROPColorStamp &dest, U32 pixels);
+
+    /**
+     *
+     *  Returns the name of the implementation used by the kernels ("SSE2" or "scalar").
+     *
+     */
+
+    static const char *getImplementation();
+};
+
+} // namespace arch
+
+#endif
@@ -1647,8 +1647,8 @@ void ZStencilTest::processStamp()
                 //  Delete fragment.  
                 delete fr;
 
-                //  Delete attributes.  
-                delete[] attrib;
+                //  Release attributes.  
+                FragmentInput::releaseAttributes(attrib);
 
                 //  Delete fragment input.  
                 delete stamp[i];
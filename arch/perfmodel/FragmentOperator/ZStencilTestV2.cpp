@@ -48,7 +48,6 @@ cmoDepthStencilTester::cmoDepthStencilTester(U32 numStamps, U32 overWidth, U32 o
         "ZStencilTest", "ZST", name, prefix, parent)
 
 {
-    DynamicObject *defaultState[1];
     U32 freeQueueSize;
     char fullName[64];
     char postfix[32];
@@ -93,11 +92,8 @@ cmoDepthStencilTester::cmoDepthStencilTester(U32 numStamps, U32 overWidth, U32 o
     //  Create state signal to the main Rasterizer mdu.
     rastState = newOutputSignal("ZStencilTestRasterizerState", 1, 1, prefix);
 
-    //  Create default signal value.
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default signal value.
-    rastState->setData(defaultState);
+    rastState.setInitial(RAST_RESET);
 
 
     //  Create fragment and state signals with consumer stage (Fragment FIFO mdu).
@@ -117,11 +113,8 @@ cmoDepthStencilTester::cmoDepthStencilTester(U32 numStamps, U32 overWidth, U32 o
     //  Create state signal to Fragment FIFO.
     ropStateSignal = newOutputSignal("ZStencilState", 1, 1, prefix);
 
-    //  Create default signal value.
-    defaultState[0] = new ROPStatusInfo(ROP_READY);
-
     //  Set default signal value.
-    ropStateSignal->setData(defaultState);
+    ropStateSignal.setInitial(ROP_READY);
 
 
     //  Create signals with Memory Controller mdu.
@@ -297,6 +290,19 @@ void cmoDepthStencilTester::reset()
     //  Set bypass and enable read flags.
     bypassROP[0] = !(zTest || stencilTest);
     readDataROP[0] = true;
+
+    //  Set the write mask for a pixel.
+    setupWriteMask();
+}
+
+//  Sets the byte write mask for a pixel from the depth and stencil update masks.
+void cmoDepthStencilTester::setupWriteMask()
+{
+    for(U32 b = 0; b < MAX_BYTES_PER_COLOR; b++)
+        zStencilWriteMask[b] = false;
+
+    zStencilWriteMask[0] = zStencilWriteMask[1] = zStencilWriteMask[2] = depthMask;
+    zStencilWriteMask[3] = (stencilUpdateMask == 0)?false:true;
 }
 
 //  This function is called when a stamp exits from the operation latency signal.
@@ -384,30 +390,12 @@ void cmoDepthStencilTester::operateStamp(U64 cycle, ROPQueue *stamp)
                 }
             }
         }
-
-        //  Check if multisampling is enabled.
-        if (!multisampling)
-        {
-            //  Build write mask for the stamp.
-            stamp->mask[i * bytesPixel[0] + 3] = (stencilUpdateMask == 0)?false:true;
-            stamp->mask[i * bytesPixel[0] + 2] =
-            stamp->mask[i * bytesPixel[0] + 1] =
-            stamp->mask[i * bytesPixel[0] + 0] = depthMask;
-        }
-        else
-        {
-            //  Create write mask for all the samples in the stamp.
-            for(U32 j = 0; j < msaaSamples; j++)
-            {
-                //  Build write mask for the stamp.
-                stamp->mask[(i * msaaSamples + j) * bytesPixel[0] + 3] = (stencilUpdateMask == 0)?false:true;
-                stamp->mask[(i * msaaSamples + j) * bytesPixel[0] + 2] =
-                stamp->mask[(i * msaaSamples + j) * bytesPixel[0] + 1] =
-                stamp->mask[(i * msaaSamples + j) * bytesPixel[0] + 0] = depthMask;
-            }
-        }
     }
 
+    //  Build write mask for all the samples in the stamp.
+    ROPStampKernels::writeMask(stamp->mask, zStencilWriteMask, bytesPixel[0], NULL,
+                               STAMP_FRAGMENTS * (multisampling ? msaaSamples : 1));
+
     GPU_DEBUG_BOX(
     //if ((stamp->stamp[0]->getFragment()->getX() == 0) && (stamp->stamp[0]->getFragment()->getY() == 144))
     //{
@@ -779,6 +767,9 @@ void cmoDepthStencilTester::processCommand(RasterizerCommand *command, U64 cycle
                 depthFail, depthPass);
             frEmu.setStencilTest(stencilTest);
 
+            //  Set the write mask for a pixel.
+            setupWriteMask();
+
             //  Set display parameters in the Pixel Mapper.
             samples = multisampling ? msaaSamples : 1;
             pixelMapper[0].setupDisplay(hRes, vRes, STAMP_WIDTH, STAMP_WIDTH, genW, genH, scanW, scanH, overW, overH,
@@ -31,6 +31,7 @@
 #include "bmRasterizer.h"
 #include "GenericROP.h"
 #include "ValidationInfo.h"
+#include "ROPStampKernels.h"
 
 namespace arch
 {
@@ -71,6 +72,7 @@ private:
     StencilUpdateFunction depthFail;    //  Update function when depth test fails.  
     StencilUpdateFunction depthPass;    //  Update function when depth test passes.  
     U32 zBuffer;                     //  Address in the GPU memory of the current Z buffer.  
+    bool zStencilWriteMask[MAX_BYTES_PER_COLOR];    //  Byte write mask for a pixel (depth and stencil).
 
     //  Z Stencil parameters.
     U32 zCacheWays;          //  Z cache set associativity.  
@@ -176,6 +178,14 @@ private:
 
     void reset();
 
+    /**
+     *
+     *  Sets the byte write mask for a pixel from the current depth and stencil update masks.
+     *
+     */
+
+    void setupWriteMask();
+
     /**
      *
      *  This function is called when the ROP stage is in the flush state.
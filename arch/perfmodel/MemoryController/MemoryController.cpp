@@ -113,21 +113,14 @@ MemoryController::MemoryController(U32 memSize, U32 clockMult, U32 memFreq, U32
             CG_ASSERT("Number of cmoStreamController Loader units excedes GPU unit buses limit.");
     )
 
-    //  Initialize the GPU memory buffer.  
-    gpuMemory = new U08[memSize];
+    //  Create the GPU memory.  The pages are allocated and marked as empty on the first write.  
+    gpuMemory = new cgoSparseMemory(gpuMemorySize, 0xDEADCAFE);
 
-    CG_ASSERT_COND(!(gpuMemory == NULL), "Error allocation GPU memory.");
-    //  Mark memory as empty.  
-    for(i = 0; i < gpuMemorySize; i = i + 4)
-        *((U32 *) &gpuMemory[i]) = 0xDEADCAFE;
+    //  Create the mapped system memory.  
+    mappedMemory = new cgoSparseMemory(mappedMemorySize, 0xDEADCAFE);
 
-    //  Initialize the mapped system memory buffer.  
-    mappedMemory = new U08[mappedMemorySize];
-
-    CG_ASSERT_COND(!(mappedMemory == NULL), "Error allocation mapped system memory.");
-    //  Mark memory as empty.  
-    for(i = 0; i < mappedMemorySize; i = i + 4)
-        *((U32 *) &mappedMemory[i]) = 0xDEADCAFE;
+    gpuMemSnapshot = new cgoPagedSnapshot("gpumem", gpuMemorySize, 0xDEADCAFE);
+    mappedMemSnapshot = new cgoPagedSnapshot("sysmem", mappedMemorySize, 0xDEADCAFE);
 
     // Command signal (to receive commands from command processor) 
     mcCommSignal = newInputSignal("MemoryControllerCommand", 1, 1, 0);
@@ -1343,7 +1336,7 @@ void MemoryController::receiveTransaction(MemoryTransaction *memTrans)
                                    (((address & SPACE_ADDRESS_MASK) + size) > gpuMemorySize)),
                                   "GPU memory operation out of range.");
                     //  Copy data to GPU memory.  
-                    memcpy(&gpuMemory[address & SPACE_ADDRESS_MASK], data, size);
+                    gpuMemory->write(address & SPACE_ADDRESS_MASK, data, size);
                     break;
                 case SYSTEM_ADDRESS_SPACE:
                     //  Check memory operation correctness.  
@@ -1351,7 +1344,7 @@ void MemoryController::receiveTransaction(MemoryTransaction *memTrans)
                                    (((address & SPACE_ADDRESS_MASK) + size) > mappedMemorySize)),
                                   "System Memory operation out of range.");
                     //  Copy data to mapped system memory.  
-                    memcpy(&mappedMemory[address & SPACE_ADDRESS_MASK], data, size);
+                    mappedMemory->write(address & SPACE_ADDRESS_MASK, data, size);
                     break;
                 default:
                     CG_ASSERT("Unsupported address space.");
@@ -1774,11 +1767,8 @@ void MemoryController::issueTransaction(U64 cycle, U32 bus)
     U32 address;
     U32 size;
     U08 *data;
-    U32 i;
     MemoryTransaction *memTrans;
     MemoryTransaction *auxMemTrans;
-    U32 source, dest;
-    U32 *mask;
     U32 bank;
     bool pageHit;   
 
@@ -1881,7 +1871,7 @@ printf("MC %lld > address %x size %d usOffset %x unit %s id %d\n",
                 //)
 
                 //  Read the data into the data buffer.  
-                memcpy(data, &gpuMemory[address & SPACE_ADDRESS_MASK], size);
+                gpuMemory->read(address & SPACE_ADDRESS_MASK, data, size);
 
                 //  Create a new memory transaction with the read data.  
                 auxMemTrans = new MemoryTransaction(memTrans);
@@ -2003,32 +1993,13 @@ printf("MC %lld > address %x size %d usOffset %x unit %s id %d\n",
                         printf("MemoryController => Masked write.\n");
                     )
 
-                    //  Get write mask.  
-                    mask = memTrans->getMask();
-
                     //  Write only unmasked bytes.  
-                    for(i = 0; i < size; i = i + 4)
-                    {
-                        //  Get source data.  
-                        source = *((U32 *) &gpuMemory[(address & SPACE_ADDRESS_MASK) + i]);
-
-                        //  Delete unmasked bytes.  
-                        source = source & ~mask[i >> 2];
-
-                        //  Get destination data.  
-                        dest = *((U32 *) &data[i]);
-
-                        //  Delete masked bytes.  
-                        dest = dest & mask[i >> 2];
-
-                        //  Write to memory.  
-                        *((U32 *) &gpuMemory[(address & SPACE_ADDRESS_MASK) + i]) = source | dest;
-                    }
+                    gpuMemory->writeMasked(address & SPACE_ADDRESS_MASK, data, memTrans->getMask(), size);
                 }
                 else
                 {
                     //  Copy data to memory.  
-                    memcpy(&gpuMemory[address & SPACE_ADDRESS_MASK], data, size);
+                    gpuMemory->write(address & SPACE_ADDRESS_MASK, data, size);
                 }
 
 
@@ -2102,11 +2073,8 @@ void MemoryController::issueSystemTransaction(U64 cycle)
     U32 address;
     U32 size;
     U08 *data;
-    U32 i;
     MemoryTransaction *memTrans;
     MemoryTransaction *auxMemTrans;
-    U32 source, dest;
-    U32 *mask;
 
     /*  NOTE:  Two unidirectional buses, one for writes and one for reads.
         In current implementation bus 0 is used for reads and bus 1 for writes.  */
@@ -2169,7 +2137,7 @@ void MemoryController::issueSystemTransaction(U64 cycle)
             //)
 
             //  Read the data into the data buffer.  
-            memcpy(data, &mappedMemory[address & SPACE_ADDRESS_MASK], size);
+            mappedMemory->read(address & SPACE_ADDRESS_MASK, data, size);
 
             //  Create a new memory transaction with the read data.  
             auxMemTrans = new MemoryTransaction(memTrans);
@@ -2247,32 +2215,13 @@ void MemoryController::issueSystemTransaction(U64 cycle)
                     printf("MemoryController => Masked write.\n");
                 )
 
-                //  Get write mask.  
-                mask = memTrans->getMask();
-
                 //  Write only unmasked bytes.  
-                for(i = 0; i < size; i = i + 4)
-                {
-                    //  Get source data.  
-                    source = *((U32 *) &mappedMemory[(address & SPACE_ADDRESS_MASK) + i]);
-
-                    //  Delete unmasked bytes.  
-                    source = source & ~mask[i >> 2];
-
-                    //  Get destination data.  
-                    dest = *((U32 *) &data[i]);
-
-                    //  Delete masked bytes.  
-                    dest = dest & mask[i >> 2];
-
-                    //  Write to memory.  
-                    *((U32 *) &mappedMemory[(address & SPACE_ADDRESS_MASK) + i]) = source | dest;
-                }
+                mappedMemory->writeMasked(address & SPACE_ADDRESS_MASK, data, memTrans->getMask(), size);
             }
             else
             {
                 //  Copy data to memory.  
-                memcpy(&mappedMemory[address & SPACE_ADDRESS_MASK], data, size);
+                mappedMemory->write(address & SPACE_ADDRESS_MASK, data, size);
             }
 
             //  Simulate system memory access latency.  
@@ -2920,6 +2869,7 @@ void MemoryController::getCommandList(std::string &commandList)
     commandList.append("loadmemory  - Loads GPU and system memmory from snapshot files.\n");
     commandList.append("_savememory - Saves GPU and system memory to snapshot files (silent).\n");
     commandList.append("_loadmemory - Loads GPU and system memmory from snapshot files (silent).\n");
+    commandList.append("footprint   - Prints the GPU and system memory written by the simulation.\n");
 }
 
 //  Execute a debug command
@@ -2964,43 +2914,20 @@ void MemoryController::execCommand(stringstream &commandStream)
     {
         loadMemory();
     }
+    else if (!command.compare("footprint"))
+    {
+        gpuMemory->printFootprint("GPU memory");
+        mappedMemory->printFootprint("System memory");
+    }
 }
 
 //  Save GPU and system memory into a file.
 void MemoryController::saveMemory()
 {
-    ofstream out;
-
-    //  Open/create snapshot file for the gpu memory.
-    out.open("gpumem.snapshot", ios::binary);
-    
-    //  Check if file was open/created correctly.
-    if (!out.is_open())
-    {
-        CG_ASSERT("Error creating gpu memory snapshot file.");
-    }
-    
-    //  Dump the gpu memory content into the file.
-    out.write((char *) gpuMemory, gpuMemorySize);
-
-    //  Close the file.
-    out.close();
-
-
-    //  Open/create snapshot file for the system memory.
-    out.open("sysmem.snapshot", ios::binary);
-    
-    //  Check if file was open/created correctly.
-    if (!out.is_open())
-    {
-        CG_ASSERT("Error creating system memory snapshot file.");
-    }
-    
-    //  Dump the system content into the file.
-    out.write((char *) mappedMemory, mappedMemorySize);
-
-    //  Close the file.
-    out.close();
+    //  Only the pages changed since the previous snapshot are stored.  The pages
+    //  are compressed and written in the background.
+    gpuMemSnapshot->save(*gpuMemory);
+    mappedMemSnapshot->save(*mappedMemory);
 }
 
 //  Load GPU and system memory from a file.
@@ -3008,36 +2935,42 @@ void MemoryController::loadMemory()
 {
     ifstream in;
 
-    //  Open snapshot file for the gpu memory.
-    in.open("gpumem.snapshot", ios::binary);
-    
-    //  Check if file was open/created correctly.
-    if (!in.is_open())
+    //  Restore the paged snapshot chain.  Fall back to the full memory images of older snapshots.
+    if (!gpuMemSnapshot->load(*gpuMemory))
     {
-        CG_ASSERT("Error opening gpu memory snapshot file.");
-    }
-    
-    //  Load the gpu memory content from the file.
-    in.read((char *) gpuMemory, gpuMemorySize);
-
-    //  Close the file.
-    in.close();
+        //  Open snapshot file for the gpu memory.
+        in.open("gpumem.snapshot", ios::binary);
+        
+        //  Check if file was open/created correctly.
+        if (!in.is_open())
+        {
+            CG_ASSERT("Error opening gpu memory snapshot file.");
+        }
+        
+        //  Load the gpu memory content from the file.
+        gpuMemory->loadImage(in);
 
+        //  Close the file.
+        in.close();
+    }
 
-    //  Open snapshot file for the system memory.
-    in.open("sysmem.snapshot", ios::binary);
-    
-    //  Check if file was open correctly.
-    if (!in.is_open())
+    if (!mappedMemSnapshot->load(*mappedMemory))
     {
-        CG_ASSERT("Error opening system memory snapshot file.");
-    }
-    
-    //  Load the system content from the file.
-    in.read((char *) mappedMemory, mappedMemorySize);
+        //  Open snapshot file for the system memory.
+        in.open("sysmem.snapshot", ios::binary);
+        
+        //  Check if file was open correctly.
+        if (!in.is_open())
+        {
+            CG_ASSERT("Error opening system memory snapshot file.");
+        }
+        
+        //  Load the system content from the file.
+        mappedMemory->loadImage(in);
 
-    //  Close the file.
-    in.close();
+        //  Close the file.
+        in.close();
+    }
 }
 
 
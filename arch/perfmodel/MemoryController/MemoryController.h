@@ -22,6 +22,7 @@
 #include "MduBase.h"
 #include "MemorySpace.h"
 #include "MemoryControllerDefs.h"
+#include "PagedSnapshot.h"
 
 namespace arch
 {
@@ -153,8 +154,10 @@ private:
     U32 pageBankMask;        //  Mask for require to get the memory page bank identifier.  
 
     //  Memory buffers.  
-    U08 *gpuMemory;       //  Pointer to the buffer where the GPU local memory is stored.  
-    U08 *mappedMemory;    //  Pointer to the buffer where the mapped system memory is stored.  
+    cgoSparseMemory *gpuMemory;       //  Sparse memory storing the GPU local memory.  
+    cgoSparseMemory *mappedMemory;    //  Sparse memory storing the mapped system memory.  
+    cgoPagedSnapshot *gpuMemSnapshot;     //  Tracks the GPU memory pages changed since the previous snapshot.  
+    cgoPagedSnapshot *mappedMemSnapshot;  //  Tracks the mapped system memory pages changed since the previous snapshot.  
 
     /**
      * Command signal from the Command Processor.
@@ -12,22 +12,35 @@ using namespace arch::memorycontroller;
 
 ///////// Methods for TQueue /////////////
 
-TQueue::TQueue() : qSize(0), qName(string("NO_NAME"))
+TQueue::TQueue() : head(0), qSize(0), ringMask(0), qName(string("NO_NAME"))
 {}
 
+void TQueue::setCapacity(U32 entries)
+{
+    if ( qSize != 0 )
+        CG_ASSERT("Queue capacity can only be changed when the queue is empty");
+
+    U32 capacity = 1;
+    while ( capacity < entries )
+        capacity <<= 1;
+
+    ring.assign(capacity, static_cast<ChannelTransaction*>(0));
+    ringMask = capacity - 1;
+    head = 0;
+}
+
 U32 TQueue::getConsecutiveAccesses(bool writes) const
 {
-    if ( q.empty() )
+    if ( qSize == 0 )
         return 0;
 
     U32 ccount = 0;
-    Queue::const_iterator it = q.begin();
     
-    U32 row = it->ct->getRow();
-    bool isWrite = !it->ct->isRead();
+    U32 row = ring[head]->getRow();
+    bool isWrite = !ring[head]->isRead();
 
-    for ( ; it != q.end(); ++it ) {
-        if ( row == it->ct->getRow() && isWrite == writes )
+    for ( U32 i = 0; i < qSize; ++i ) {
+        if ( row == ring[(head + i) & ringMask]->getRow() && isWrite == writes )
             ++ccount;
     }
     return ccount;
@@ -35,7 +48,7 @@ U32 TQueue::getConsecutiveAccesses(bool writes) const
 
 bool TQueue::empty() const
 {
-    return q.empty();
+    return qSize == 0;
 }
 
 U32 TQueue::size() const
@@ -45,19 +58,20 @@ U32 TQueue::size() const
 
 U64 TQueue::getTimestamp() const
 {
-    if ( q.empty() )
-    {
-        stringstream ss;
-        ss << "Queue with name '" << qName << "' is empty";
-        CG_ASSERT(ss.str().c_str());
-    }
-    return q.front().timestamp;
+    return front()->getArrivalTimestamp();
 }
 
 void TQueue::enqueue(ChannelTransaction* ct, U64 timestamp)
 {
+    if ( qSize == ring.size() )
+    {
+        stringstream ss;
+        ss << "Queue with name '" << qName << "' is full";
+        CG_ASSERT(ss.str().c_str());
+    }
+    ct->setArrivalTimestamp(timestamp);
+    ring[(head + qSize) & ringMask] = ct;
     ++qSize;
-    q.push_back(QueueEntry(ct, timestamp));
 }
 
 ChannelTransaction* TQueue::front() const
@@ -69,7 +83,7 @@ ChannelTransaction* TQueue::front() const
         CG_ASSERT(ss.str().c_str());
     }
 
-    return q.front().ct;
+    return ring[head];
 }
 
 void TQueue::pop()
@@ -80,8 +94,9 @@ void TQueue::pop()
         ss << "Queue with name '" << qName << "' is empty";
         CG_ASSERT(ss.str().c_str());
     }
+    ring[head] = 0;
+    head = (head + 1) & ringMask;
     --qSize;
-    q.pop_front();
 }
 
 void TQueue::setName(const string& name)
@@ -134,6 +149,7 @@ closePageActivationsCount(getSM().getNumericStatistic("ClosePageActivationCount"
     som = SwitchOperationModeSelector::create(config);
 
     for ( U32 i = 0; i < config.moduleBanks; ++i ) {
+        bankQ[i].setCapacity(bankQueueSz);
         queueBankInfos[i].bankID = i;
         queueBankInfos[i].age = 0;
         queueBankInfos[i].consecHits = 0;
@@ -370,7 +386,7 @@ void BankQueueScheduler::handler_ddrCommandNotSent(const DDRCommand* notSentComm
                 if ( notSentCommand )
                     preCommand->setProtocolConstraint(notSentCommand->getProtocolConstraint()); // Copy protocol constraint
                 if ( !sendDDRCommand(cycle, preCommand, 0) ) 
-                    delete preCommand; // cannot be issued
+                    recycleCommand(preCommand); // cannot be issued
                 else {
                     closePageActivationsCount.inc();
                     return ; // no more commands can be issued this cycle
@@ -416,12 +432,12 @@ bool BankQueueScheduler::_tryAdvancedPrecharge(const DDRCommand* notSentCommand,
             continue; // no precharge chance
 
         if ( info.getActiveRow(i) != bankQ[i].front()->getRow() ) {
-            cmd = DDRCommand::createPrecharge(i);
+            cmd = createPrecharge(i);
             cmd->setProtocolConstraint(notSentCommand->getProtocolConstraint());
             if ( sendDDRCommand(cycle, cmd, bankQ[i].front()) )
                 return true;
             else
-                delete cmd; // destroy this command and try another
+                recycleCommand(cmd); // destroy this command and try another
         }
     }
 
@@ -498,14 +514,14 @@ bool BankQueueScheduler::_tryAdvancedActive(const DDRCommand* notSentCommand, U6
     for ( U32 bank = 0; bank < bankOrder.size(); ++bank ) {
         const U32 i = bankOrder[bank];
         if ( info.getActiveRow(i) == DDRModuleState::NoActiveRow && !bankQ[i].empty() && bankQ[i].front()->isRead() == tryRead ) {
-            DDRCommand* cmd = DDRCommand::createActive(i, bankQ[i].front()->getRow());
+            DDRCommand* cmd = createActive(i, bankQ[i].front()->getRow());
             if ( notSentCommand )
                 cmd->setProtocolConstraint(notSentCommand->getProtocolConstraint());
             cmd->setAsAdvancedCommmand();
             if ( sendDDRCommand(cycle, cmd, bankQ[i].front()) )
                 return true;
             else
-                delete cmd;
+                recycleCommand(cmd);
         }
     }
     return false; 
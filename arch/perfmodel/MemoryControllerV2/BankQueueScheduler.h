@@ -20,12 +20,18 @@ namespace memorycontroller
 class GPUMemorySpecs;
 
 // Helper class implementing a queue with some "special" added features
+//
+// Fixed capacity ring of channel transactions.  The arrival timestamp is kept in
+// the channel transaction itself so enqueue/front/pop do not allocate.
 class TQueue
 {
 public:
 
     TQueue();
 
+    // Sets the capacity of the queue (rounded up to a power of 2), the queue must be empty
+    void setCapacity(U32 entries);
+
     U32 getConsecutiveAccesses(bool writes) const;
 
     bool empty() const;
@@ -46,19 +52,10 @@ public:
 
 private:
 
-    struct QueueEntry
-    {
-        ChannelTransaction* ct;
-        U64 timestamp;
-        QueueEntry(ChannelTransaction* ct, U64 timestamp) : ct(ct), timestamp(timestamp)
-        {}
-        QueueEntry() : ct(0), timestamp(0) {}
-    };
-
-    typedef std::list<QueueEntry> Queue;
-
-    Queue q;
-    U32 qSize; // to increase efficiency in implementations with STL list.size() O(n)
+    std::vector<ChannelTransaction*> ring;
+    U32 head; // position of the oldest transaction
+    U32 qSize;
+    U32 ringMask;
     std::string qName;
 
 };
@@ -48,6 +48,7 @@ SchedulerState::~SchedulerState()
 ChannelScheduler::ChannelScheduler(const char* name,  const char* prefix, cmoMduBase* parent, const CommonConfig& config) :
 cmoMduBase(name, parent),
 
+        pools(0),
         _debugString(config.debugString),
         pagePolicy(config.pagePolicy),
         //currentState(SchedulerState::AcceptNone), 
@@ -177,7 +178,7 @@ void ChannelScheduler::clock(U64 cycle)
                  << "\n";
         )
         // update channel transaction timestamp
-        // request->setArrivalTimestamp(cycle);
+        request->setArrivalTimestamp(cycle);
         // inform to the dereived scheduler class that a request has arrived
         receiveRequest(cycle, request);
     }
@@ -365,16 +366,48 @@ bool ChannelScheduler::sendDDRCommand(U64 cycle, DDRCommand* ddrCmd, const Chann
 
     return issueCmd;
 }
+void ChannelScheduler::setObjectPools(ChannelObjectPools* channelPools)
+{
+    pools = channelPools;
+}
+
 DDRCommand* ChannelScheduler::createActive(U32 bank, U32 row)
 {
+    if ( pools )
+        return DDRCommand::createActive(pools->commands, bank, row);
     return DDRCommand::createActive(bank, row);
 }
 
 DDRCommand* ChannelScheduler::createPrecharge(U32 bank)
 {
+    if ( pools )
+        return DDRCommand::createPrecharge(pools->commands, bank);
     return DDRCommand::createPrecharge(bank);
 }
 
+DDRCommand* ChannelScheduler::createDummy(DDRCommand::ProtocolConstraint pc)
+{
+    if ( pools )
+        return DDRCommand::createDummy(pools->commands, pc);
+    return DDRCommand::createDummy(pc);
+}
+
+void ChannelScheduler::recycleCommand(DDRCommand* ddrCmd)
+{
+    if ( pools )
+        pools->commands.release(ddrCmd);
+    else
+        delete ddrCmd;
+}
+
+void ChannelScheduler::recycleBurst(DDRBurst* burst)
+{
+    if ( pools )
+        pools->bursts.release(burst);
+    else
+        delete burst;
+}
+
 list<DDRCommand*> ChannelScheduler::transactionToCommands(const ChannelTransaction* channelTrans)
 {
     list<DDRCommand*> translation;
@@ -394,7 +427,10 @@ list<DDRCommand*> ChannelScheduler::transactionToCommands(const ChannelTransacti
     {
         for ( U32 i = 0; i < nBurst; i++ )
         {
-            translation.push_back( DDRCommand::createRead(bank, col, false) );
+            if ( pools )
+                translation.push_back( DDRCommand::createRead(pools->commands, bank, col, false) );
+            else
+                translation.push_back( DDRCommand::createRead(bank, col, false) );
             col +=  BurstLength;
         }
     }
@@ -404,7 +440,7 @@ list<DDRCommand*> ChannelScheduler::transactionToCommands(const ChannelTransacti
         for ( U32 i = 0; i < nBurst; i++ )
         {
             data = channelTrans->getData(i * BurstBytes);
-            DDRBurst* writeBurst = new DDRBurst(BurstLength);
+            DDRBurst* writeBurst = pools ? DDRBurst::create(pools->bursts, BurstLength) : new DDRBurst(BurstLength);
 
             if ( i == nBurst - 1 && lastMasked ) // The last one is a partial write
             {
@@ -419,7 +455,10 @@ list<DDRCommand*> ChannelScheduler::transactionToCommands(const ChannelTransacti
                 if ( channelTrans->isMasked() )
                     writeBurst->setMask(channelTrans->getMask(i*BurstLength));
             }
-            translation.push_back( DDRCommand::createWrite(bank, col, writeBurst, false) );
+            if ( pools )
+                translation.push_back( DDRCommand::createWrite(pools->commands, bank, col, writeBurst, false) );
+            else
+                translation.push_back( DDRCommand::createWrite(bank, col, writeBurst, false) );
             col += BurstLength;
         }
     }
@@ -11,6 +11,7 @@
 #include "DDRModuleState.h"
 #include "DDRBurst.h"
 #include "DDRCommand.h"
+#include "MCObjectPool.h"
 #include <list>
 
 // included to be able to identify clients
@@ -220,9 +221,18 @@ public:
      */
     void clock(U64 cycle);
 
+    /**
+     * Sets the object pools of the channel used to create and recycle DDR commands and bursts
+     *
+     * @note If not set commands and bursts are created with new and destroyed with delete
+     */
+    void setObjectPools(ChannelObjectPools* channelPools);
+
 
 private:
 
+    ChannelObjectPools* pools; ///< Object pools of the channel (owned by the memory controller)
+
     
     ChannelScheduler(const ChannelScheduler&);
     ChannelScheduler& operator=(const ChannelScheduler&);
@@ -470,6 +480,21 @@ protected:
      * @return A new precharge DRAM command based on the selected bank
      */ 
     DDRCommand* createPrecharge(U32 bank); ///< To create a precharge command
+
+    /**
+     * @brief Helper method provided to subclasses to create a dummy DRAM command carrying a protocol constraint
+     */
+    DDRCommand* createDummy(DDRCommand::ProtocolConstraint pc);
+
+    /**
+     * @brief Helper method provided to subclasses to destroy a DRAM command that has not been sent
+     */
+    void recycleCommand(DDRCommand* ddrCmd);
+
+    /**
+     * @brief Helper method provided to subclasses to destroy a read burst once consumed
+     */
+    void recycleBurst(DDRBurst* burst);
     
     /**
      * @brief Method provided to subclasses to update the state that will be sent at the end of the current simulation cycle 
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <new>
 
 using namespace arch::memorycontroller;
 using arch::MemReqState;
@@ -41,21 +42,20 @@ bool ChannelTransaction::ready() const
 }
 
 
-ChannelTransaction* ChannelTransaction::createRead(MemoryRequest* memReq, 
-                            U32 channel, U32 bank, U32 row, U32 col, 
-                            U32 bytes, U08* dataBuffer)
+ChannelTransaction* ChannelTransaction::init(ChannelTransaction* ct, bool read, MemoryRequest* memReq,
+                                             U32 channel, U32 bank, U32 row, U32 col,
+                                             U32 bytes, U08* dataBuffer)
 {
     GPU_ASSERT
     (
         if ( memReq == 0 )
             CG_ASSERT("Memory Request is NULL");
         if ( dataBuffer == 0 )
-            CG_ASSERT("Output data buffer is NULL");
+            CG_ASSERT(read ? "Output data buffer is NULL" : "Input data buffer is NULL");
     )
 
-    ChannelTransaction* ct = new ChannelTransaction;
-    ct->readBit = true; // it is a read
-    ct->req = memReq; // memReq must be a read request
+    ct->readBit = read;
+    ct->req = memReq; // memReq must be a read request for reads
     ct->channel = channel;
     ct->bank = bank;
     ct->row = row;
@@ -63,38 +63,39 @@ ChannelTransaction* ChannelTransaction::createRead(MemoryRequest* memReq,
     ct->size = bytes;
     ct->dataBuffer = dataBuffer;
     ct->mask = 0;
-    
-    ct->setColor(0); // Use a 0 to identify reads
-    
+    ct->arrivalTimestamp = 0;
+
+    ct->setColor(read ? 0 : 1); // Use a 0 to identify reads and a 1 to identify writes
+
     return ct;
 }
 
+ChannelTransaction* ChannelTransaction::createRead(MemoryRequest* memReq, 
+                            U32 channel, U32 bank, U32 row, U32 col, 
+                            U32 bytes, U08* dataBuffer)
+{
+    return init(new ChannelTransaction, true, memReq, channel, bank, row, col, bytes, dataBuffer);
+}
+
 ChannelTransaction* ChannelTransaction::createWrite(MemoryRequest* memReq,
                     U32 channel, U32 bank, U32 row, U32 col, 
                     U32  bytes, U08* dataBuffer)
 {
-    GPU_ASSERT
-    (
-        if ( memReq == 0 )
-            CG_ASSERT("Memory Request is NULL");
-        if ( dataBuffer == 0 )
-            CG_ASSERT("Input data buffer is NULL");
-    )
-
-    ChannelTransaction* ct = new ChannelTransaction;
-    ct->readBit = false; // it is a write
-    ct->req = memReq;
-    ct->channel = channel;
-    ct->bank = bank;
-    ct->row = row;
-    ct->col = col;
-    ct->size = bytes;
-    ct->dataBuffer = dataBuffer;
-    ct->mask = 0;
+    return init(new ChannelTransaction, false, memReq, channel, bank, row, col, bytes, dataBuffer);
+}
 
-    ct->setColor(1); // Use a 1 to identify writes
+ChannelTransaction* ChannelTransaction::createRead(ObjectPool<ChannelTransaction>& pool, MemoryRequest* memReq,
+                            U32 channel, U32 bank, U32 row, U32 col,
+                            U32 bytes, U08* dataBuffer)
+{
+    return init(::new (pool.allocate()) ChannelTransaction, true, memReq, channel, bank, row, col, bytes, dataBuffer);
+}
 
-    return ct;
+ChannelTransaction* ChannelTransaction::createWrite(ObjectPool<ChannelTransaction>& pool, MemoryRequest* memReq,
+                    U32 channel, U32 bank, U32 row, U32 col,
+                    U32  bytes, U08* dataBuffer)
+{
+    return init(::new (pool.allocate()) ChannelTransaction, false, memReq, channel, bank, row, col, bytes, dataBuffer);
 }
 
 
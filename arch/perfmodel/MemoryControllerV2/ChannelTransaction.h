@@ -8,6 +8,7 @@
 #include <string>
 #include "DynamicObject.h"
 #include "MemoryControllerDefs.h"
+#include "MCObjectPool.h"
 
 
 namespace arch
@@ -52,6 +53,25 @@ public:
                             U32 channel, U32 bank, U32 row, 
                             U32 col, U32  bytes, U08* dataBuffer);
 
+    /**
+     * Pooled versions of createRead and createWrite
+     *
+     * @note The channel transaction has to be returned to a pool (ObjectPool::release) when completed
+     */
+    static ChannelTransaction* createRead(ObjectPool<ChannelTransaction>& pool, MemoryRequest* memReq,
+                        U32 channel, U32 bank, U32 row,
+                        U32 col, U32 bytes, U08* dataBuffer);
+
+    static ChannelTransaction* createWrite(ObjectPool<ChannelTransaction>& pool, MemoryRequest* memReq,
+                            U32 channel, U32 bank, U32 row,
+                            U32 col, U32  bytes, U08* dataBuffer);
+
+    /**
+     * Cycle in which the channel transaction was queued in the channel scheduler
+     */
+    void setArrivalTimestamp(U64 cycle) const { arrivalTimestamp = cycle; }
+    U64 getArrivalTimestamp() const { return arrivalTimestamp; }
+
     MemReqState getState() const;
 
     // equivalent to "getState() == MRS_READY"
@@ -182,6 +202,9 @@ private:
     ChannelTransaction(const ChannelTransaction&);
     ChannelTransaction& operator=(const ChannelTransaction&);
 
+    static ChannelTransaction* init(ChannelTransaction* ct, bool read, MemoryRequest* memReq,
+                                    U32 channel, U32 bank, U32 row, U32 col, U32 bytes, U08* dataBuffer);
+
     enum { CHANNEL_TRANSACTION_MAX_BYTES = 128 };
 
     //U08 data[CHANNEL_TRANSACTION_MAX_BYTES];
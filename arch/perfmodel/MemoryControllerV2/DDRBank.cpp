@@ -5,6 +5,8 @@
 #include "DDRBank.h"
 #include <iostream>
 #include <iomanip>
+#include <cstring>
+#include <vector>
 
 using namespace std;
 using arch::memorycontroller::DDRBurst;
@@ -53,13 +55,8 @@ DDRBank::DDRBank(U32 rows, U32 cols) :
     nRows(rows), nColumns(cols), activeRow(NoActiveRow)
 {
     //cout << "ctor -> bank with " << rows << " rows and " << cols << " columns\n";
-    data = new U32*[rows];
-    for ( U32 i = 0; i < rows; i++ )
-    {
-        data[i] = new U32[cols];
-        for ( U32 j = 0; j < cols; j++ )
-            data[i][j] = 0xDEADCAFE; // Initialize memory
-    }
+    // Rows are allocated and initialized on the first write
+    data = new cgoSparseMemory(U64(rows) * cols * 4, 0xDEADCAFE, cols * 4);
 }
 
 DDRBank::DDRBank(const DDRBank& aBank)
@@ -69,15 +66,19 @@ DDRBank::DDRBank(const DDRBank& aBank)
     nColumns = aBank.nColumns;
     activeRow = aBank.activeRow;
 
-    data = new U32*[nRows];
+    data = new cgoSparseMemory(U64(nRows) * nColumns * 4, 0xDEADCAFE, nColumns * 4);
     for ( U32 i = 0; i < nRows; i++ )
     {
-        data[i] = new U32[nColumns];
-        for ( U32 j = 0; j < nColumns; j++ )
-            data[i][j] = aBank.data[i][j]; // Copy memory contents
+        if ( aBank.data->isTouched(i) )
+            memcpy(data->writePage(i), aBank.data->readPage(i), nColumns * 4); // Copy memory contents
     }
 }
 
+DDRBank::~DDRBank()
+{
+    delete data;
+}
+
 
 DDRBank& DDRBank::operator=(const DDRBank& aBank)
 {
@@ -85,18 +86,17 @@ DDRBank& DDRBank::operator=(const DDRBank& aBank)
     if ( this == &aBank )
         return *this; // protect self-copying
 
-    delete[] data; // delete previous memory array
+    delete data; // delete previous memory array
 
     nRows = aBank.nRows;
     nColumns = aBank.nColumns;
     activeRow = aBank.activeRow;
 
-    data = new U32*[nRows];
+    data = new cgoSparseMemory(U64(nRows) * nColumns * 4, 0xDEADCAFE, nColumns * 4);
     for ( U32 i = 0; i < nRows; i++ )
     {
-        data[i] = new U32[nColumns];
-        for ( U32 j = 0; j < nColumns; j++ )
-            data[i][j] = aBank.data[i][j]; // Copy memory contents
+        if ( aBank.data->isTouched(i) )
+            memcpy(data->writePage(i), aBank.data->readPage(i), nColumns * 4); // Copy memory contents
     }
     
     return *this;
@@ -123,26 +123,29 @@ void DDRBank::deactivate()
 }
 
 DDRBurst* DDRBank::read(U32 column, U32 burstSize) const
+{
+    DDRBurst* burst = new DDRBurst(burstSize);
+    read(column, burst);
+    return burst;
+}
+
+void DDRBank::read(U32 column, DDRBurst* burst) const
 {
     /*
-    cout << "DDRBank::read(" << column << "," << burstSize << ")" << endl;
+    cout << "DDRBank::read(" << column << "," << burst->getSize() << ")" << endl;
     cout << "Bank row contents: ";
-    dumpRow(getActive(), column, burstSize*4);
+    dumpRow(getActive(), column, burst->getSize()*4);
     cout << endl;
     */
 
+    const U32 burstSize = burst->getSize();
+
     GPU_ASSERT
     (
         if ( column >= nColumns )
             CG_ASSERT("Starting column out of bounds");
         if ( activeRow == NoActiveRow )
             CG_ASSERT("A row must be active");
-    )
-
-    DDRBurst* burst = new DDRBurst(burstSize);
-
-    GPU_ASSERT
-    (
         /*
         if ( column % burstSize != 0 )
         {
@@ -157,16 +160,15 @@ cout << "DDRBank::read => column = " << column << " burstSize = " << burstSize <
         }
     )
     
+    const U32* row = (const U32*)data->readPage(activeRow);
     for ( U32 i = 0; i < burstSize; i++ )
-        burst->setData(i, data[activeRow][i+column]);
+        burst->setData(i, row[i+column]);
 
     /*
     cout << "Burst contents: ";
     burst->dump();
     cout << endl;
     */
-
-    return burst;
 }
 
 void DDRBank::write(U32 column, const DDRBurst* burst)
@@ -200,8 +202,9 @@ cout << "DDRBank::write => column = " << column << " burstSize = " << burstSize
         }
     )
     
+    U32* row = (U32*)data->writePage(activeRow);
     for ( U32 i = 0; i < burstSize; i++ )
-        burst->write(i, data[activeRow][i+column]); // applies mask if required
+        burst->write(i, row[i+column]); // applies mask if required
 }
 
 U32 DDRBank::rows() const
@@ -223,9 +226,10 @@ void DDRBank::dump(BankDumpFormat format) const
     for ( U32 i = 0; i < nRows; i++ )
     {
         cout << i << ": ";
+        const U32* row = (const U32*)data->readPage(i);
         for ( U32 j = 0; j < nColumns; j++ )
         {
-            const U08* ptr = (const U08*)&data[i][j];
+            const U08* ptr = (const U08*)&row[j];
             if ( format == DDRBank::hex )
             {
                 cout << setfill('0') << setw(2) << U32(ptr[0]) 
@@ -253,16 +257,7 @@ void DDRBank::dump(BankDumpFormat format) const
 void DDRBank::setBytes(U08 byte)
 {
     for ( U32 i = 0; i < nRows; i++ )
-    {
-        for ( U32 j = 0; j < nColumns; j++ )
-        {
-            U08* p = (U08 *)&data[i][j];
-            *p = byte;
-            *(p+1) = byte;
-            *(p+2) = byte;
-            *(p+3) = byte;
-        }
-    }
+        memset(data->writePage(i), byte, nColumns * 4);
 }
 
 void DDRBank::dumpRow(U32 row, U32 startCol, U32 bytes) const
@@ -279,7 +274,7 @@ void DDRBank::dumpRow(U32 row, U32 startCol, U32 bytes) const
 
     //cout << "row=" << row << " startCol=" << startCol << " bytes=" << bytes << " Data: ";
 
-    const U08* r = (const U08*)data[row];
+    const U08* r = data->readPage(row);
     r += (startCol*4);
 
     for ( U32 i = 0; i < bytes; i++ )
@@ -302,7 +297,7 @@ void DDRBank::readData(U32 row, U32 startCol, U32 bytes, ostream& outStream) con
     )
 
     // write data from the bank into the output stream
-    outStream.write((const char*)&data[row][startCol], bytes);
+    outStream.write((const char*)data->readPage(row) + startCol*4, bytes);
 }
 
 void DDRBank::writeData(U32 row, U32 startCol, U32 bytes, std::istream& inStream)
@@ -319,6 +314,36 @@ void DDRBank::writeData(U32 row, U32 startCol, U32 bytes, std::istream& inStream
     )
 
     // read data from stream and write it into the bank
-    inStream.read((char*)&data[row][startCol], bytes);
+    vector<U08> buffer(bytes);
+    inStream.read((char*)&buffer[0], bytes);
+    data->write(U64(row) * nColumns * 4 + startCol*4, &buffer[0], bytes);
+}
+
+void DDRBank::readData(U32 row, U32 startCol, U32 bytes, U08* buffer) const
+{
+    GPU_ASSERT(
+        if ( bytes % 4 != 0 )
+            CG_ASSERT("Number of bytes to be read has to be multiple of 4 (column size)");
+        if ( row > nRows )
+            CG_ASSERT("Row specified too high");
+        if ( startCol + bytes/4 > nColumns )
+            CG_ASSERT("accessing out of row bounds");
+    )
+
+    data->read(U64(row) * nColumns * 4 + startCol*4, buffer, bytes);
+}
+
+void DDRBank::writeData(U32 row, U32 startCol, U32 bytes, const U08* buffer)
+{
+    GPU_ASSERT(
+        if ( bytes % 4 != 0 )
+            CG_ASSERT("Number of bytes to be written has to be multiple of 4 (column size)");
+        if ( row > nRows )
+            CG_ASSERT("Row specified too high");
+        if ( startCol + bytes/4 > nColumns )
+            CG_ASSERT("accessing out of row bounds");
+    )
+
+    data->write(U64(row) * nColumns * 4 + startCol*4, buffer, bytes);
 }
 
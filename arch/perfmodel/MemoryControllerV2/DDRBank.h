@@ -7,6 +7,7 @@
 
 #include "GPUType.h"
 #include "DDRBurst.h"
+#include "SparseMemory.h"
 
 namespace arch
 {
@@ -23,6 +24,9 @@ namespace memorycontroller
  * Each value of the array has 32-bit but the data is written/read using DDRBurst so
  * ordinary read/write operations imply read/write more than 1 single 32-bit values. Single
  * bytes can be written using DDRBurst masks
+ *
+ * The array is stored as a sparse memory with a page per row, a row is only allocated
+ * when it is first written
  */
 class DDRBank
 {
@@ -39,7 +43,7 @@ public:
 
 private:
 
-    U32** data; ///< Array data
+    cgoSparseMemory* data; ///< Array data (a page per row)
     U32 activeRow; ///< Current active row
     U32 nRows; ///< Number of rows in the DDR chip bank
     U32 nColumns; ///< Number of columns in each DDR chip bank row
@@ -87,6 +91,7 @@ public:
     DDRBank(U32 rows, U32 cols);
     DDRBank(const DDRBank&);
     DDRBank& operator=(const DDRBank&);
+    ~DDRBank();
 
     /**
      * Sets all bank bytes with a given value
@@ -124,6 +129,14 @@ public:
      * @warning The starting column must aligned to burst size
      */
     DDRBurst* read(U32 column, U32 burstSize) const;
+
+    /**
+     * Reads a burst of data from the current active row into an already created burst
+     *
+     * @param column Starting column from where to retrieve the burst
+     * @param burst Burst receiving the data (the burst size selects the number of columns read)
+     */
+    void read(U32 column, DDRBurst* burst) const;
     
     /**
      * Writes a burst of data to the current active row
@@ -147,6 +160,18 @@ public:
      */
     U32 columns() const;
 
+    /**
+     * Returns the sparse memory storing the bank rows
+     *
+     * @return the bank contents (a page per row)
+     */
+    const cgoSparseMemory& contents() const { return *data; }
+
+    /**
+     * Clears the dirty bits of the bank rows
+     */
+    void clearDirty() { data->clearDirty(); }
+
     /**
      * Prints a readable information of the bank contents
      *
@@ -173,6 +198,16 @@ public:
      */
     void writeData(U32 row, U32 startCol, U32 bytes, std::istream& inputStream);
 
+    /**
+     * Reads data from the bank into a buffer
+     */
+    void readData(U32 row, U32 startCol, U32 bytes, U08* buffer) const;
+
+    /**
+     * Write data into the bank from a buffer
+     */
+    void writeData(U32 row, U32 startCol, U32 bytes, const U08* buffer);
+
     
 };
 
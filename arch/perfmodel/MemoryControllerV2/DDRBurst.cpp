@@ -5,10 +5,12 @@
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <new>
 #include "DDRBurst.h"
 
 using namespace std;
 using arch::memorycontroller::DDRBurst;
+using arch::memorycontroller::ObjectPool;
 
 U32 DDRBurst::instances = 0;
 
@@ -35,6 +37,11 @@ DDRBurst::~DDRBurst()
     --instances;
 }
 
+DDRBurst* DDRBurst::create(ObjectPool<DDRBurst>& pool, U32 size)
+{
+    return ::new (pool.allocate()) DDRBurst(size);
+}
+
 U32 DDRBurst::countInstances()
 {
     return instances;
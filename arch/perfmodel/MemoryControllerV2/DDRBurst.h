@@ -7,6 +7,7 @@
 
 #include <vector>
 #include "DynamicObject.h"
+#include "MCObjectPool.h"
 
 
 namespace arch
@@ -79,6 +80,13 @@ public:
      */
     DDRBurst(U32 size);
 
+    /**
+     * Creates a burst of a given size over storage taken from a pool
+     *
+     * @note The burst has to be returned to a pool (ObjectPool::release) when it is consumed
+     */
+    static DDRBurst* create(ObjectPool<DDRBurst>& pool, U32 size);
+
     ~DDRBurst();
 
     static U32 countInstances();
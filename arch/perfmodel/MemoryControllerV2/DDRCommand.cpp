@@ -6,10 +6,12 @@
 #include <iostream>
 #include <stdio.h>
 #include <sstream>
+#include <new>
 
 using namespace std;
 using arch::memorycontroller::DDRCommand;
 using arch::memorycontroller::DDRBurst;
+using arch::memorycontroller::ObjectPool;
 
 U32 DDRCommand::instances = 0;
 
@@ -184,6 +186,35 @@ DDRCommand* DDRCommand::createPrecharge(U32 bank, ProtocolConstraint pc)
     return new DDRCommand(DDRCommand::Precharge, bank, 0, 0, false, 0, pc);
 }
 
+DDRCommand* DDRCommand::createDummy(ObjectPool<DDRCommand>& pool, ProtocolConstraint pc)
+{
+    DDRCommand* dummy = ::new (pool.allocate()) DDRCommand(DDRCommand::Dummy, 0, 0, 0, false, 0, pc);
+    sprintf((char*)dummy->getInfo(), DDRCommand::protocolConstraintToString(pc).c_str());
+    return dummy;
+}
+
+DDRCommand* DDRCommand::createActive(ObjectPool<DDRCommand>& pool, U32 bank, U32 row, ProtocolConstraint pc)
+{
+    return ::new (pool.allocate()) DDRCommand(DDRCommand::Active, bank, row, 0, false, 0, pc);
+}
+
+DDRCommand* DDRCommand::createRead(ObjectPool<DDRCommand>& pool, U32 bank, U32 column,
+                                   bool autoprecharge, ProtocolConstraint pc)
+{
+    return ::new (pool.allocate()) DDRCommand(DDRCommand::Read, bank, 0, column, autoprecharge, 0, pc);
+}
+
+DDRCommand* DDRCommand::createWrite(ObjectPool<DDRCommand>& pool, U32 bank, U32 column, DDRBurst* data,
+                                    bool autoprecharge, ProtocolConstraint pc)
+{
+    return ::new (pool.allocate()) DDRCommand(DDRCommand::Write, bank, 0, column, autoprecharge, data, pc);
+}
+
+DDRCommand* DDRCommand::createPrecharge(ObjectPool<DDRCommand>& pool, U32 bank, ProtocolConstraint pc)
+{
+    return ::new (pool.allocate()) DDRCommand(DDRCommand::Precharge, bank, 0, 0, false, 0, pc);
+}
+
 
 
 string DDRCommand::toString() const
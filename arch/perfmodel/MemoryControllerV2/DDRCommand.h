@@ -7,6 +7,7 @@
 
 #include "DynamicObject.h"
 #include "DDRBurst.h"
+#include "MCObjectPool.h"
 #include <string>
 
 namespace arch
@@ -125,6 +126,18 @@ public:
      */
     static DDRCommand* createPrecharge(U32 bank, ProtocolConstraint pc = PC_none);
 
+    /**
+     * Pooled versions of the command factories
+     *
+     * The command is constructed over storage taken from the pool and has to be
+     * returned to a pool (ObjectPool::release) when it is retired
+     */
+    static DDRCommand* createDummy(ObjectPool<DDRCommand>& pool, ProtocolConstraint pc);
+    static DDRCommand* createActive(ObjectPool<DDRCommand>& pool, U32 bank, U32 row, ProtocolConstraint pc = PC_none);
+    static DDRCommand* createRead(ObjectPool<DDRCommand>& pool, U32 bank, U32 column, bool autoprecharge = false, ProtocolConstraint pc = PC_none);
+    static DDRCommand* createWrite(ObjectPool<DDRCommand>& pool, U32 bank, U32 column, DDRBurst* data, bool autoprecharge = false, ProtocolConstraint pc = PC_none);
+    static DDRCommand* createPrecharge(ObjectPool<DDRCommand>& pool, U32 bank, ProtocolConstraint pc = PC_none);
+
     /**
      * Returns the enumeration value of this command
      *
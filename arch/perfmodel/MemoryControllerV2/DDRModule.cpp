@@ -85,7 +85,8 @@ writeTransmissionBytesStat(getSM().getNumericStatistic("WriteDataBytes", U32(0),
 casCyclesStat(getSM().getNumericStatistic("WastedCycles_CASLatency", U32(0), "DDRModule", prefix)),
 wlCyclesStat(getSM().getNumericStatistic("WastedCycles_WriteLatency", U32(0), "DDRModule", prefix)),
 allBanksPrechargedCyclesStat(getSM().getNumericStatistic("AllBanksPrechargedCycles", U32(0), "DDRModule", prefix)),
-actCommandsReceived(getSM().getNumericStatistic("ACTCommandsReceived", U32(0), "DDRModule", prefix))
+actCommandsReceived(getSM().getNumericStatistic("ACTCommandsReceived", U32(0), "DDRModule", prefix)),
+pools(0)
 {
 
     for ( U32 i = DDRCommand::PC_none + 1; i < DDRCommand::PC_count; ++i ) {
@@ -371,7 +372,7 @@ void DDRModule::clock(U64 cycle)
                     cout << getName() << " => Writing " << (4 * b->getSize()) << " bytes.\n";
                 }
             )
-            delete readin.front().second; // Get rid of DDRBurst
+            recycleBurst(readin.front().second); // Get rid of DDRBurst
             readin.pop_front();
         }
         // else (nothing to be done)
@@ -572,7 +573,7 @@ void DDRModule::processCommand(U64 cycle, DDRCommand* cmd)
     if ( cmd->which() != DDRCommand::Dummy ) {
         // Dummy commands are ignored
         if ( listOfLastestProcessedCommands.size() >= LIST_OF_LATESTS_COMMANDS_MAX_SIZE ) {
-            delete listOfLastestProcessedCommands.front().second; // Delete command
+            recycleCommand(listOfLastestProcessedCommands.front().second); // Delete command
             listOfLastestProcessedCommands.pop_front(); // Remove from the list
         }
         listOfLastestProcessedCommands.push_back(make_pair(cycle, cmd));
@@ -670,7 +671,7 @@ void DDRModule::processDummyCommand(U64 cycle, DDRCommand* dummyCommand)
             dataPinsItem.push_back(make_pair(cycle + offset, dynObj));
         }
     }    
-    delete dummyCommand; // This is the only command that can be delete right here
+    recycleCommand(dummyCommand); // This is the only command that can be delete right here
 }
 
 // { P: activeCommand->which() == DDRCOmmand::Active }
@@ -786,7 +787,8 @@ void DDRModule::processReadCommand(U64 cycle, DDRCommand* readCommand)
 
     // Perform emulation access
     lastColumnAccessed = readCommand->getColumn();
-    DDRBurst* burst = banks[bankId].read(readCommand->getColumn(), burstLength);
+    DDRBurst* burst = pools ? DDRBurst::create(pools->bursts, burstLength) : new DDRBurst(burstLength);
+    banks[bankId].read(readCommand->getColumn(), burst);
     
     // Copy the cookies from the read command generating the read burst
     burst->copyParentCookies(*readCommand);
@@ -995,6 +997,27 @@ void DDRModule::printOperatingParameters() const
     cout << "-----------------------------------------------------\n";
 }
 
+void DDRModule::setObjectPools(ChannelObjectPools* channelPools)
+{
+    pools = channelPools;
+}
+
+void DDRModule::recycleCommand(DDRCommand* cmd)
+{
+    if ( pools )
+        pools->commands.release(cmd);
+    else
+        delete cmd;
+}
+
+void DDRModule::recycleBurst(const DDRBurst* burst)
+{
+    if ( pools )
+        pools->bursts.release(const_cast<DDRBurst*>(burst));
+    else
+        delete burst;
+}
+
 DDRBank& DDRModule::getBank(U32 bankId)
 {
     GPU_ASSERT
@@ -1103,3 +1126,15 @@ void DDRModule::writeData(U32 bankId, U32 row, U32 startCol, U32 bytes, std::ist
     CG_ASSERT_COND(!( bankId >= banks.size() ), "Trying to access a bank with identifier too high");    DDRBank& bank = banks[bankId];
     bank.writeData(row, startCol, bytes, inStream);
 }
+
+void DDRModule::readData(U32 bankId, U32 row, U32 startCol, U32 bytes, U08* buffer) const
+{
+    CG_ASSERT_COND(!( bankId >= banks.size() ), "Trying to access a bank with identifier too high");
+    banks[bankId].readData(row, startCol, bytes, buffer);
+}
+
+void DDRModule::writeData(U32 bankId, U32 row, U32 startCol, U32 bytes, const U08* buffer)
+{
+    CG_ASSERT_COND(!( bankId >= banks.size() ), "Trying to access a bank with identifier too high");
+    banks[bankId].writeData(row, startCol, bytes, buffer);
+}
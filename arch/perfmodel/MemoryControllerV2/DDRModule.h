@@ -8,6 +8,7 @@
 #include "MduBase.h"
 #include "DDRBank.h"
 #include "DDRCommand.h"
+#include "MCObjectPool.h"
 #include <queue>
 #include <vector>
 #include <utility>
@@ -260,6 +261,11 @@ private:
 
     bool isAnyBank(BankStateID state) const;
 
+    ChannelObjectPools* pools; ///< Object pools of the channel (owned by the memory controller)
+
+    void recycleCommand(DDRCommand* cmd);
+    void recycleBurst(const DDRBurst* burst);
+
     bool processDataPins(U64 cycle);
     bool processDataPinsConstraints(U64 cycle);
 
@@ -298,6 +304,14 @@ public:
 
     void setModuleParameters( const GPUMemorySpecs& memSpecs, U32 burstLength );
 
+    /**
+     * Sets the object pools of the channel
+     *
+     * Read bursts are created from the pool and retired commands and written bursts are
+     * returned to it.  If not set new and delete are used
+     */
+    void setObjectPools(ChannelObjectPools* channelPools);
+
     /**
      * Simulates 1 cycle of simulation time of this memory module
      *
@@ -348,6 +362,20 @@ public:
      * @note this method access data directly without changing chip state at all (any simulation is performed)
      */
     void writeData(U32 bank, U32 row, U32 startCol, U32 bytes, std::istream& inStream);
+
+    /**
+     * Direct access to read data from a bank into a buffer
+     *
+     * @note this method access data directly without changing chip state at all (any simulation is performed)
+     */
+    void readData(U32 bank, U32 row, U32 startCol, U32 bytes, U08* buffer) const;
+
+    /**
+     * Direct access to write data into a bank from a buffer
+     *
+     * @note this method access data directly without changing chip state at all (any simulation is performed)
+     */
+    void writeData(U32 bank, U32 row, U32 startCol, U32 bytes, const U08* buffer);
     
 };
 
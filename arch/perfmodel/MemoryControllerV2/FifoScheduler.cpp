@@ -101,7 +101,7 @@ void FifoScheduler::handler_ddrCommandNotSent(const DDRCommand* notSentCommand,
                 if ( notSentCommand )
                     preCommand->setProtocolConstraint(notSentCommand->getProtocolConstraint());
                 if ( !sendDDRCommand(cycle, preCommand, 0) ) 
-                    delete preCommand; // cannot be issued
+                    recycleCommand(preCommand); // cannot be issued
                 else {
                     closePageActivationsCount.inc();
                     break;
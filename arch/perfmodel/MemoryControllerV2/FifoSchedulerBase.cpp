@@ -273,7 +273,7 @@ void FifoSchedulerBase::receiveData(U64 cycle, DDRBurst* data)
         handler_transactionCompleted(trans, cycle);
     }
 
-    delete data; // bye bye burst
+    recycleBurst(data); // bye bye burst
 }
 
 
@@ -437,9 +437,9 @@ void FifoSchedulerBase::processNextDDRCommand(U64 cycle)
         cmd->setProtocolConstraint(DDRCommand::PC_none); // reset constraint
 
         if ( pc != DDRCommand::PC_none ) {
-            DDRCommand* dummy = DDRCommand::createDummy(pc);
+            DDRCommand* dummy = createDummy(pc);
             if ( !sendDDRCommand(cycle, dummy, currentTrans) )
-                delete dummy;
+                recycleCommand(dummy);
         }
         
     }
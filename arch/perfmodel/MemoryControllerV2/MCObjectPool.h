@@ -0,0 +1,135 @@
+/**************************************************************************
+ *
+ */
+
+#ifndef MCOBJECTPOOL_H
+    #define MCOBJECTPOOL_H
+
+#include "GPUType.h"
+#include <vector>
+
+namespace arch
+{
+
+namespace memorycontroller
+{
+
+/**
+ * Free list of storage for the short lived objects of the memory controller
+ *
+ * Objects are constructed with placement new over the storage returned by allocate() and
+ * given back with release(), which runs the destructor and keeps the storage for the next
+ * allocation.  Constructors and destructors run as with new/delete, so object state
+ * (cookies, colors, instance counters) is the same for pooled and non pooled objects.
+ *
+ * The storage is obtained with T::operator new, so an object created from a pool
+ * can still be deleted with delete and an object created with new can be released
+ * into a pool.
+ *
+ * @code
+ *    ObjectPool<DDRBurst> pool;
+ *    DDRBurst* burst = ::new (pool.allocate()) DDRBurst(8);
+ *    ...
+ *    pool.release(burst);
+ * @endcode
+ */
+template<class T>
+class ObjectPool
+{
+public:
+
+    ObjectPool() : created(0), reused(0), outstanding(0)
+    {}
+
+    ~ObjectPool()
+    {
+        for ( U32 i = 0; i < freeList.size(); i++ )
+            T::operator delete(freeList[i]);
+    }
+
+    /**
+     * Returns storage for a new object (recycled if available)
+     */
+    void* allocate()
+    {
+        ++outstanding;
+
+        if ( freeList.empty() ) {
+            ++created;
+            return T::operator new(sizeof(T));
+        }
+
+        ++reused;
+        void* storage = freeList.back();
+        freeList.pop_back();
+        return storage;
+    }
+
+    /**
+     * Destroys the object and keeps its storage in the free list
+     */
+    void release(T* obj)
+    {
+        if ( obj == 0 )
+            return;
+
+        obj->~T();
+        freeList.push_back(obj);
+
+        if ( outstanding != 0 )
+            --outstanding;
+    }
+
+    /**
+     * Number of objects that required new storage
+     */
+    U64 getCreated() const { return created; }
+
+    /**
+     * Number of objects created over recycled storage
+     */
+    U64 getReused() const { return reused; }
+
+    /**
+     * Number of objects allocated from the pool and not released yet
+     */
+    U32 getOutstanding() const { return outstanding; }
+
+    /**
+     * Number of storage slots in the free list
+     */
+    U32 getFree() const { return static_cast<U32>(freeList.size()); }
+
+private:
+
+    ObjectPool(const ObjectPool&);
+    ObjectPool& operator=(const ObjectPool&);
+
+    std::vector<void*> freeList;
+    U64 created;
+    U64 reused;
+    U32 outstanding;
+};
+
+class DDRCommand;
+class DDRBurst;
+class ChannelTransaction;
+
+/**
+ * Object pools of a memory channel
+ *
+ * Shared by the channel scheduler, the DDR module and the splitters creating
+ * channel transactions for the channel.  Owned by the memory controller.
+ */
+struct ChannelObjectPools
+{
+    ObjectPool<DDRCommand> commands;
+    ObjectPool<DDRBurst> bursts;
+    ObjectPool<ChannelTransaction> transactions;
+};
+
+} // namespace memorycontroller
+
+} // namespace arch
+
+#endif // MCOBJECTPOOL_H
@@ -8,6 +8,10 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
 #include "MemorySpace.h"
 #include "GPUMath.h"
 #include "MemoryRequest.h"
@@ -257,11 +261,11 @@ MemoryController::MemoryController(
     // start creation of system memory structures //
     ////////////////////////////////////////////////
 
-    systemMemory = new U08[systemMemorySize];
+    // system memory pages are allocated and initialized on the first write
+    systemMemory = new cgoSparseMemory(systemMemorySize, 0XDEADCAFE);
 
-    // initialize system memory
-    for ( U32 i = 0; i < systemMemorySize; i += 4 )
-        *(reinterpret_cast<U32*>(&systemMemory[i])) = 0XDEADCAFE;
+    gpuMemSnapshot = new cgoPagedSnapshot("mcv2.gpumem", gpuMemorySize, 0xDEADCAFE);
+    sysMemSnapshot = new cgoPagedSnapshot("mcv2.sysmem", systemMemorySize, 0xDEADCAFE);
 
     // Create system memory buses
     for ( U32 i = 0; i < systemMemoryBuses; i++ )
@@ -302,6 +306,11 @@ MemoryController::MemoryController(
     channelScheds = new ChannelScheduler*[gpuMemoryChannels];
     ddrModules = new DDRModule*[gpuMemoryChannels];
 
+    // Channel transactions, DDR commands and DDR bursts are recycled per channel
+    channelPools = new ChannelObjectPools[gpuMemoryChannels];
+    for ( U32 i = 0; i < splitterArray.size(); i++ )
+        splitterArray[i]->setObjectPools(channelPools);
+
     // Create command signal from the command processor
     mcCommSignal = newInputSignal("MemoryControllerCommand", 1, 1, 0);
 
@@ -358,6 +367,9 @@ MemoryController::MemoryController(
                                       // params.perfectMemory,
                                       this);
 
+        channelScheds[i]->setObjectPools(&channelPools[i]);
+        ddrModules[i]->setObjectPools(&channelPools[i]);
+
         // Create connections from memory controller to channel schedulers
         channelRequest[i]= newOutputSignal("ChannelRequest", 1, 1, prefix.c_str());
         channelReply[i] = newInputSignal("ChannelReply", 1, 1, prefix.c_str());
@@ -397,11 +409,21 @@ MemoryController::MemoryController(
 
     U32 bankQueuesCount = useIndependentQueuesPerBank ? params.banksPerMemoryChannel : 1;
     if ( bankQueuesCount > 1 ) {
-        nextBankRR = new U32[bankQueuesCount];
-        memset(nextBankRR, 0, sizeof(U32) * bankQueuesCount);
+        if ( bankQueuesCount > 64 )
+            CG_ASSERT("Independent queues per bank support up to 64 banks per channel");
+        // One Round Robin indicator per channel
+        nextBankRR = new U32[gpuMemoryChannels];
+        memset(nextBankRR, 0, sizeof(U32) * gpuMemoryChannels);
+        bankQueueHeads = new BankQueueHeads[gpuMemoryChannels];
+        for ( U32 channel = 0; channel < gpuMemoryChannels; ++channel ) {
+            bankQueueHeads[channel].pendingMask = 0;
+            bankQueueHeads[channel].oldestFirst.reserve(bankQueuesCount);
+        }
     }
-    else
+    else {
         nextBankRR = 0; // For security/debugging reasons we set the pointer to 0 if it won't be used
+        bankQueueHeads = 0;
+    }
 
     for ( U32 channel = 0; channel < gpuMemoryChannels; ++channel )
         channelQueue[channel] = new Queue<std::pair<ChannelTransaction*,U64> >[bankQueuesCount];
@@ -810,7 +832,7 @@ void MemoryController::preloadGPUMemory(MemoryTransaction* mt)
                                      ct.getData(), ct.bytes(),
                                     (ct.isMasked() ? ct.getMask() : 0));
 
-        delete *it; // consume the channel transaction (delete it)
+        channelPools[channel].transactions.release(*it); // consume the channel transaction
     }
 }
 
@@ -901,7 +923,7 @@ void MemoryController::processMemoryTransaction(U64 cycle, MemoryTransaction* me
                                     (((address & SPACE_ADDRESS_MASK) + size) > systemMemorySize)), 
                                   "System Memory operation out of range.");
                 // preload system memory
-                memcpy(&systemMemory[address & SPACE_ADDRESS_MASK], data, size);
+                systemMemory->write(address & SPACE_ADDRESS_MASK, data, size);
             }
             else // gpu memory
             {
@@ -1103,6 +1125,8 @@ U32 MemoryController::addRequest(MemoryTransaction* memTrans, U64 cycle)
 
         // drive the channel transaction to the corresponding channel
         channelQueue[channel][bank].add(make_pair(ctrans, cycle));
+        if ( useIndependentQueuesPerBank && channelQueue[channel][bank].items() == 1 )
+            updateBankQueueHead(channel, bank);
     }
 
     return requestID;
@@ -1187,7 +1211,7 @@ void MemoryController::issueSystemTransaction(U64 cycle)
                 MemoryTransaction* readData =
                     MemoryTransaction::createReadData(memTrans);
 
-                memcpy(data, &systemMemory[address & SPACE_ADDRESS_MASK], size);
+                systemMemory->read(address & SPACE_ADDRESS_MASK, data, size);
 
                 // store arrival time of the current read in the bus
                 // Consumed in updateSystemBuses()
@@ -1250,25 +1274,13 @@ void MemoryController::issueSystemTransaction(U64 cycle)
                         printf("MemoryController => Masked write.\n");
                     )
 
-                    U32* mask = memTrans->getMask(); // Get write mask
-
-                    U32 source, dest;
                     // Write only unmasked bytes
-                    for(U32 i = 0; i < size; i = i + 4)
-                    {
-                        // Get source data
-                        source = *((U32 *) &systemMemory[(address & SPACE_ADDRESS_MASK) + i]);
-                        source = source & ~mask[i >> 2]; // Delete unmasked bytes
-                        dest = *((U32 *) &data[i]); // Get destination data
-                        dest = dest & mask[i >> 2]; // Delete masked bytes
-                        // Write to memory
-                        *((U32 *) &systemMemory[(address & SPACE_ADDRESS_MASK) + i]) = source | dest;
-                    }
+                    systemMemory->writeMasked(address & SPACE_ADDRESS_MASK, data, memTrans->getMask(), size);
                 }
                 else
                 {
                     // Copy data to memory
-                    memcpy(&systemMemory[address & SPACE_ADDRESS_MASK], data, size);
+                    systemMemory->write(address & SPACE_ADDRESS_MASK, data, size);
                 }
                 // Simulate system memory access latency
                 systemMemoryRequestSignal[1]->write(cycle, memTrans, systemMemoryWriteLatency);
@@ -1460,6 +1472,23 @@ void MemoryController::reserveGPUBus(U64 cycle )
     }
 }
 
+//  Returns the index of the lowest bit set in a non zero bank mask.
+static inline U32 lowestBankBit(U64 mask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return U32(index);
+#elif defined(__GNUC__)
+    return U32(__builtin_ctzll(mask));
+#else
+    U32 index = 0;
+    while (((mask >> index) & 0x01) == 0)
+        index++;
+    return index;
+#endif
+}
+
 void MemoryController::stage_sendToSchedulers(U64 cycle)
 {
     for ( U32 i = 0; i < gpuMemoryChannels; i++ )
@@ -1514,78 +1543,83 @@ void MemoryController::stage_sendToSchedulers(U64 cycle)
             }
         }
         else {
-            // generate vector of indirections
-            vector<U32> ind;
-
-            if ( perBankChannelQueuesSelection == 0 ) {
-                // Generate an indirection vector based on Round&Robin
-                for ( U32 j = 0; j < banksPerMemoryChannel; ++j ) {
-                    U32 bank = (nextBankRR[i] + j) % banksPerMemoryChannel;
-                    if ( !channelQueue[i][bank].empty() && channelQueue[i][bank].head().first->ready() )
-                        ind.push_back( bank );
-                }
-            }
-            else {
-                // Generate an indirection vector based on Oldest first
-                vector<pair<U64, U32> > banksTS;
-                for ( U32 j = 0; j < banksPerMemoryChannel; ++j ) {
-                    if ( !channelQueue[i][j].empty() && channelQueue[i][j].head().first->ready() )
-                        banksTS.push_back(make_pair(channelQueue[i][j].head().second, j));
-                }
-                std::sort(banksTS.begin(), banksTS.end());
-                // Copy bank ids
-                vector<pair<U64,U32> >::const_iterator it = banksTS.begin();
-                for ( ; it != banksTS.end(); ++it )
-                    ind.push_back( it->second );
+            // Banks are considered in Round&Robin order starting at the bank after the last
+            // one served or in oldest first order (head timestamp, bank id).  Only banks with
+            // a ready transaction at the head of their queue are considered.
+            const BankQueueHeads& heads = bankQueueHeads[i];
+            const bool oldestFirst = ( perBankChannelQueuesSelection != 0 );
+            const U32 rrStart = nextBankRR[i];
+            U64 rrPending = 0;
+            U32 orderPos = 0;
+            if ( !oldestFirst && heads.pendingMask != 0 ) {
+                // Rotate the pending mask so bit 0 is the first bank in Round&Robin order
+                const U64 allBanks = ( banksPerMemoryChannel == 64 ? ~U64(0) : (U64(1) << banksPerMemoryChannel) - 1 );
+                rrPending = rrStart == 0 ? heads.pendingMask :
+                    ((heads.pendingMask >> rrStart) | (heads.pendingMask << (banksPerMemoryChannel - rrStart))) & allBanks;
             }
 
             ChannelTransaction* firstBankConsideredFound = 0;
+            bool issued = false;
 
-            vector<U32>::const_iterator it = ind.begin();
-            for ( ; it != ind.end(); ++it ) {
-            // for ( ; bankPos < banksPerMemoryChannel; ++bankPos ) {
-
-                U32 bank = *it; // Get the next bank to be considered
+            while ( true ) {
 
-                // if ( !channelQueue[i][bank].empty() && channelQueue[i][bank].head().first->ready() ) {
+                U32 bank; // Get the next bank to be considered
+                if ( oldestFirst ) {
+                    if ( orderPos == heads.oldestFirst.size() )
+                        break;
+                    bank = heads.oldestFirst[orderPos++];
+                }
+                else {
+                    if ( rrPending == 0 )
+                        break;
+                    U32 offset = lowestBankBit(rrPending);
+                    rrPending &= rrPending - 1;
+                    bank = rrStart + offset;
+                    if ( bank >= banksPerMemoryChannel )
+                        bank -= banksPerMemoryChannel;
+                }
 
-                    ChannelTransaction* ct = channelQueue[i][bank].head().first;
+                ChannelTransaction* ct = channelQueue[i][bank].head().first;
 
-                    SchedulerState::State state = schedState->state(bank);
+                if ( !ct->ready() )
+                    continue;
 
-                    if ( !firstBankConsideredFound )
-                        firstBankConsideredFound = ct;
+                SchedulerState::State state = schedState->state(bank);
 
-                    if ( state == SchedulerState::AcceptBoth ||
-                       ( state == SchedulerState::AcceptRead  &&  ct->isRead() ) ||
-                       ( state == SchedulerState::AcceptWrite && !ct->isRead() ) ) {
-                        GPU_DEBUG
-                        (
-                            cout << "MemoryController => Sending ChannelTransaction ("
-                                << (ct->isRead()?"READ,":"WRITE,") << ct->bytes()
-                                << ") reqID = " << ct->getRequest()->getID()
-                                << " to ChannelScheduler " << i << "\n";
-                        )
-                        channelRequest[i]->write(cycle, ct); // send next channel transaction
-                        channelQueue[i][bank].pop();
-                        nextBankRR[i] = (bank + 1) % banksPerMemoryChannel;
+                if ( !firstBankConsideredFound )
+                    firstBankConsideredFound = ct;
 
-                        MemoryRequest* mreq = ct->getRequest();
-                        if ( mreq->getState() == MRS_READY ) {
-                            mreq->setState(MRS_MEMORY);
-                            if ( ct->isRead() )
-                                --freeReadBuffers; // reserve buffer for this request
-                        }
-                        else if ( mreq->getState() != MRS_MEMORY )
-                            CG_ASSERT("Unexpected memory request state");
-                        // else state == MRS_MEMORY (another channel transaction owned by this mem request is accessing memory)
+                if ( state == SchedulerState::AcceptBoth ||
+                   ( state == SchedulerState::AcceptRead  &&  ct->isRead() ) ||
+                   ( state == SchedulerState::AcceptWrite && !ct->isRead() ) ) {
+                    GPU_DEBUG
+                    (
+                        cout << "MemoryController => Sending ChannelTransaction ("
+                            << (ct->isRead()?"READ,":"WRITE,") << ct->bytes()
+                            << ") reqID = " << ct->getRequest()->getID()
+                            << " to ChannelScheduler " << i << "\n";
+                    )
+                    channelRequest[i]->write(cycle, ct); // send next channel transaction
+                    channelQueue[i][bank].pop();
+                    updateBankQueueHead(i, bank);
+                    nextBankRR[i] = (bank + 1) % banksPerMemoryChannel;
 
-                        break;
+                    MemoryRequest* mreq = ct->getRequest();
+                    if ( mreq->getState() == MRS_READY ) {
+                        mreq->setState(MRS_MEMORY);
+                        if ( ct->isRead() )
+                            --freeReadBuffers; // reserve buffer for this request
                     }
-                // }
+                    else if ( mreq->getState() != MRS_MEMORY )
+                        CG_ASSERT("Unexpected memory request state");
+                    // else state == MRS_MEMORY (another channel transaction owned by this mem request is accessing memory)
+
+                    issued = true;
+                    break;
+                }
             }
 
-            if ( it == ind.end() && firstBankConsideredFound ) { // no transaction issued
+            if ( !issued && firstBankConsideredFound ) { // no transaction issued
                 // Compute statistics of stall
                 if ( firstBankConsideredFound->isRead() )
                     channelReq_ReadStallCyclesStat->inc();
@@ -1600,6 +1634,38 @@ void MemoryController::stage_sendToSchedulers(U64 cycle)
     } // end for
 }
 
+void MemoryController::updateBankQueueHead(U32 channel, U32 bank)
+{
+    BankQueueHeads& heads = bankQueueHeads[channel];
+    const U64 bankBit = U64(1) << bank;
+
+    if ( perBankChannelQueuesSelection != 0 && (heads.pendingMask & bankBit) != 0 ) {
+        vector<U32>::iterator it = std::find(heads.oldestFirst.begin(), heads.oldestFirst.end(), bank);
+        heads.oldestFirst.erase(it);
+    }
+
+    if ( channelQueue[channel][bank].empty() ) {
+        heads.pendingMask &= ~bankBit;
+        return;
+    }
+
+    heads.pendingMask |= bankBit;
+
+    if ( perBankChannelQueuesSelection != 0 ) {
+        // Insert keeping (head timestamp, bank) order
+        const U64 timestamp = channelQueue[channel][bank].head().second;
+        U32 pos = static_cast<U32>(heads.oldestFirst.size());
+        while ( pos > 0 ) {
+            U32 other = heads.oldestFirst[pos - 1];
+            U64 otherTimestamp = channelQueue[channel][other].head().second;
+            if ( otherTimestamp < timestamp || (otherTimestamp == timestamp && other < bank) )
+                break;
+            --pos;
+        }
+        heads.oldestFirst.insert(heads.oldestFirst.begin() + pos, bank);
+    }
+}
+
 void MemoryController::stage_receiveFromSchedulers(U64 cycle)
 {
     for ( U32 i = 0; i < gpuMemoryChannels; i++ )
@@ -1661,8 +1727,8 @@ void MemoryController::stage_receiveFromSchedulers(U64 cycle)
                 unitChannelStats[unit][unitID][i].writeBytes->inc(ct->bytes());
             }
 
-            // Channel transaction completed, delete it.
-            delete ct;
+            // Channel transaction completed, recycle it.
+            channelPools[ct->getChannel()].transactions.release(ct);
         }
     }
 }
@@ -2160,86 +2226,107 @@ void MemoryController::updateMemoryDomain(U64 cycle)
 }
 
 
-void MemoryController::saveMemory() const
+void MemoryController::clearBankDirty()
 {
-    ofstream out;
-
-    //  Create snapshot file for the gpu memory.
-    out.open("mcv2.gpumem.snapshot", ios::binary);
-
-    //  Check if file was open/created correctly.
-    if ( !out.is_open() )
-        CG_ASSERT("Error creating gpu memory snapshot file.");
-
-    const U32 BurstBytes = gpuBurstLength * 4;
-
-    for ( U32 addr = 0; addr < gpuMemorySize; addr += BurstBytes ) {
-        // Get the proper splitter
-        const MemoryRequestSplitter& splitter = selectSplitter(addr, BurstBytes);
-        // Convert a linear address into a (channel,bank,row,col) tuple
-        const MemoryRequestSplitter::AddressInfo addrInfo = splitter.extractAddressInfo(addr);
-        // Read the next burst data and write it into the output stream
-        ddrModules[addrInfo.channel]->readData(addrInfo.bank, addrInfo.row, addrInfo.startCol, BurstBytes, out);
+    for ( U32 i = 0; i < gpuMemoryChannels; i++ ) {
+        for ( U32 j = 0; j < ddrModules[i]->countBanks(); j++ )
+            ddrModules[i]->getBank(j).clearDirty();
     }
+}
 
-    out.close();
-
-    out.open("mcv2.sysmem.snapshot", ios::binary);
+void MemoryController::saveMemory()
+{
+    const U32 BurstBytes = gpuBurstLength * 4;
 
-    //  Check if file was open/created correctly.
-    if (!out.is_open())
-        CG_ASSERT("Error creating system memory snapshot file.");
+    //  Only the pages changed since the previous snapshot are stored.  The pages are
+    //  gathered burst by burst from the DDR banks, compressed and written in the background.
+    gpuMemSnapshot->save([this, BurstBytes](U64 offset, U08* buffer, U32 bytes) {
+        for ( U32 addr = U32(offset); addr < U32(offset) + bytes; addr += BurstBytes ) {
+            // Get the proper splitter
+            const MemoryRequestSplitter& splitter = selectSplitter(addr, BurstBytes);
+            // Convert a linear address into a (channel,bank,row,col) tuple
+            const MemoryRequestSplitter::AddressInfo addrInfo = splitter.extractAddressInfo(addr);
+            // Read the next burst data into the page buffer
+            ddrModules[addrInfo.channel]->readData(addrInfo.bank, addrInfo.row, addrInfo.startCol, BurstBytes, &buffer[addr - U32(offset)]);
+        }
+    },
+    [this, BurstBytes](U32 page, bool baseImage) {
+        // A page is unchanged if none of the bank rows storing its bursts was written
+        // (since the previous snapshot for a delta, at all for a base image)
+        for ( U32 addr = page * PAGED_SNAPSHOT_PAGE_SIZE; addr < (page + 1) * PAGED_SNAPSHOT_PAGE_SIZE && addr < gpuMemorySize; addr += BurstBytes ) {
+            const MemoryRequestSplitter& splitter = selectSplitter(addr, BurstBytes);
+            const MemoryRequestSplitter::AddressInfo addrInfo = splitter.extractAddressInfo(addr);
+            const cgoSparseMemory& rows = ddrModules[addrInfo.channel]->getBank(addrInfo.bank).contents();
+            if ( baseImage ? rows.isTouched(addrInfo.row) : rows.isDirty(addrInfo.row) )
+                return false;
+        }
+        return true;
+    });
 
-    //  Dump the system content into the file.
-    out.write((char *) systemMemory, systemMemorySize);
+    clearBankDirty();
 
-    //  Close the file.
-    out.close();
+    sysMemSnapshot->save(*systemMemory);
 }
 
 void MemoryController::loadMemory()
 {
-    ifstream in;
-
-    //  Open snapshot file for the gpu memory.
-    in.open("mcv2.gpumem.snapshot", ios::binary);
-
-
-    if (in.is_open() ) {
-        const U32 BurstBytes = gpuBurstLength * 4;
+    const U32 BurstBytes = gpuBurstLength * 4;
 
-        for ( U32 addr = 0; addr < gpuMemorySize; addr += BurstBytes ) {
-            // Get the proper splitter
+    //  Restore the paged snapshot chain.  Fall back to the full memory images of older snapshots.
+    bool gpuMemLoaded = gpuMemSnapshot->load([this, BurstBytes](U64 offset, const U08* buffer, U32 bytes) {
+        for ( U32 addr = U32(offset); addr < U32(offset) + bytes; addr += BurstBytes ) {
             const MemoryRequestSplitter& splitter = selectSplitter(addr, BurstBytes);
-            // Convert a linear address into a (channel,bank,row,col) tuple
             const MemoryRequestSplitter::AddressInfo addrInfo = splitter.extractAddressInfo(addr);
-            // Read the next burst data and write it into the output stream
-            ddrModules[addrInfo.channel]->writeData(addrInfo.bank, addrInfo.row, addrInfo.startCol, BurstBytes, in);
+            ddrModules[addrInfo.channel]->writeData(addrInfo.bank, addrInfo.row, addrInfo.startCol, BurstBytes, &buffer[addr - U32(offset)]);
         }
+    });
 
-        //  Close the file.
-        in.close();
-    }
-    else {
-        //  Check if file was opened correctly.
-        //CG_ASSERT("Error opening gpu memory snapshot file.");
-        std::cerr << "Error loading GPU memory. File ' " << "mcv2.gpumem.snapshot not found (loading GPU memory ignored)" << endl;
-    }
+    // The restored rows are stored in the snapshot chain
+    if ( gpuMemLoaded )
+        clearBankDirty();
 
-    //  Open snapshot file for the system memory.
-    in.open("mcv2.sysmem.snapshot", ios::binary);
+    ifstream in;
 
-    if ( in.is_open() ) {
-        //  Load the system content from the file.
-        in.read((char *) systemMemory, systemMemorySize);
+    if ( !gpuMemLoaded ) {
+        //  Open snapshot file for the gpu memory.
+        in.open("mcv2.gpumem.snapshot", ios::binary);
+
+        if (in.is_open() ) {
+            for ( U32 addr = 0; addr < gpuMemorySize; addr += BurstBytes ) {
+                // Get the proper splitter
+                const MemoryRequestSplitter& splitter = selectSplitter(addr, BurstBytes);
+                // Convert a linear address into a (channel,bank,row,col) tuple
+                const MemoryRequestSplitter::AddressInfo addrInfo = splitter.extractAddressInfo(addr);
+                // Read the next burst data and write it into the output stream
+                ddrModules[addrInfo.channel]->writeData(addrInfo.bank, addrInfo.row, addrInfo.startCol, BurstBytes, in);
+            }
 
-        //  Close the file.
-        in.close();
+            //  Close the file.
+            in.close();
+        }
+        else {
+            //  Check if file was opened correctly.
+            //CG_ASSERT("Error opening gpu memory snapshot file.");
+            std::cerr << "Error loading GPU memory. File ' " << "mcv2.gpumem.snapshot not found (loading GPU memory ignored)" << endl;
+        }
     }
-    else {
-        //  Check if file was opened correctly.
-        // CG_ASSERT("Error opening system memory snapshot file.");
-        std::cerr << "Error loading System memory. File ' " << "mcv2.sysmem.snapshot not found (loading system memory ignored)" << endl;
+
+    if ( !sysMemSnapshot->load(*systemMemory) ) {
+        //  Open snapshot file for the system memory.
+        in.open("mcv2.sysmem.snapshot", ios::binary);
+
+        if ( in.is_open() ) {
+            //  Load the system content from the file.
+            systemMemory->loadImage(in);
+
+            //  Close the file.
+            in.close();
+        }
+        else {
+            //  Check if file was opened correctly.
+            // CG_ASSERT("Error opening system memory snapshot file.");
+            std::cerr << "Error loading System memory. File ' " << "mcv2.sysmem.snapshot not found (loading system memory ignored)" << endl;
+        }
     }
 }
 
@@ -2399,6 +2486,7 @@ void MemoryController::getCommandList(std::string &commandList)
     commandList.append("loadmemory  - Loads GPU and system memmory from snapshot files.\n");
     commandList.append("_savememory - Saves GPU and system memory to snapshot files (silent).\n");
     commandList.append("_loadmemory - Loads GPU and system memmory from snapshot files (silent).\n");
+    commandList.append("footprint   - Prints the GPU and system memory written by the simulation.\n");
 }
 
 //  Execute a debug command
@@ -2443,4 +2531,24 @@ void MemoryController::execCommand(stringstream &commandStream)
     {
         loadMemory();
     }
+    else if (!command.compare("footprint"))
+    {
+        // GPU memory rows are allocated per DDR bank
+        U64 touchedRows = 0;
+        U64 totalRows = 0;
+        U64 touchedBytes = 0;
+        for ( U32 c = 0; c < gpuMemoryChannels; c++ )
+        {
+            for ( U32 b = 0; b < ddrModules[c]->countBanks(); b++ )
+            {
+                const cgoSparseMemory& rows = ddrModules[c]->getBank(b).contents();
+                touchedRows += rows.getTouchedPages();
+                totalRows += rows.getNumPages();
+                touchedBytes += rows.getTouchedBytes();
+            }
+        }
+        cout << " GPU memory : " << (touchedBytes >> 10) << " KB written (" << touchedRows << " of "
+             << totalRows << " DDR rows).\n";
+        systemMemory->printFootprint("System memory");
+    }
 }
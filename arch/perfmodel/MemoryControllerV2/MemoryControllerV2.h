@@ -11,6 +11,7 @@
 #include "ChannelScheduler.h"
 #include "DDRModule.h"
 #include "MemoryRequest.h"
+#include "PagedSnapshot.h"
 
 //  std includes
 #include <string>
@@ -251,6 +252,7 @@ private:
 
     ChannelScheduler** channelScheds;
     DDRModule** ddrModules;
+    ChannelObjectPools* channelPools; // Per channel pools shared by splitters, schedulers and DDR modules
     
     Signal** channelRequest; // Output signal matching "ChannelRequest" from ChannelScheduler
     Signal** channelReply;   // Input signal matching "ChannelReply" from ChannelScheduler
@@ -307,6 +309,17 @@ private:
     // One Round Robin indicator per channel group of queues
     U32* nextBankRR;
     U32 banksPerMemoryChannel;
+
+    // Per channel bank queues holding a transaction (updated when a queue head changes)
+    struct BankQueueHeads
+    {
+        U64 pendingMask;              ///< Bit per bank with a non empty queue
+        std::vector<U32> oldestFirst; ///< Banks with a non empty queue sorted by (head timestamp, bank)
+    };
+    BankQueueHeads* bankQueueHeads;
+
+    // Updates the pending mask and the oldest first order after the head of a bank queue changes
+    void updateBankQueueHead(U32 channel, U32 bank);
     
     ///////////////////////////////
     /// System memory variables ///
@@ -355,9 +368,12 @@ private:
 
     tools::Queue<MemoryRequest> serviceQueue; ///< Stores the memory read requests to be served to the GPU units
 
-    U08* systemMemory; ///< Pointer to the buffer where the mapped system memory is stored
+    cgoSparseMemory* systemMemory; ///< Sparse memory storing the mapped system memory
     U32 systemMemorySize; ///< Amount of system memory (bytes)
 
+    cgoPagedSnapshot* gpuMemSnapshot; ///< Tracks the GPU memory pages changed since the previous snapshot
+    cgoPagedSnapshot* sysMemSnapshot; ///< Tracks the system memory pages changed since the previous snapshot
+
     U32 gpuMemorySize;
     U32 gpuBurstLength;
     //U32 gpuMemPageSize;
@@ -433,6 +449,9 @@ private:
     // memory modules directly (without timing overhead)
     void preloadGPUMemory(MemoryTransaction* mt);
 
+    // Clears the dirty bits of the rows of all the DDR banks (GPU memory write tracking)
+    void clearBankDirty();
+
     // System memory methods
     // Tries to issue a transaction to system memory
     void issueSystemTransaction(U64 cycle);
@@ -488,7 +507,7 @@ public:
 
     void execCommand(stringstream &commandStream);
 
-    void saveMemory() const;
+    void saveMemory();
 
     void loadMemory();
 
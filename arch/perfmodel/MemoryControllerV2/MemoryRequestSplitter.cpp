@@ -23,9 +23,15 @@ MemoryRequestSplitter::MemoryRequestSplitter(U32 burstLength, U32 channels,
     CHANNELS(channels),
     CHANNEL_BANKS(channelBanks),
     BANK_ROWS(bankRows),
-    BANK_COLS(bankCols)
+    BANK_COLS(bankCols),
+    pools(0)
 {}
 
+void MemoryRequestSplitter::setObjectPools(ChannelObjectPools* channelPools)
+{
+    pools = channelPools;
+}
+
 vector<ChannelTransaction*> MemoryRequestSplitter::split(MemoryRequest* mr)
 {
     MemoryTransaction* memTrans = mr->getTransaction();
@@ -98,7 +104,12 @@ vector<ChannelTransaction*> MemoryRequestSplitter::split(MemoryRequest* mr)
         for ( U32 i = 0; i < cts.size(); i++ )
         {
             AddressInfo info = extractAddressInfo(cts[i].first);
-            vtrans.push_back( ChannelTransaction::createRead(
+            if ( pools != 0 )
+                vtrans.push_back( ChannelTransaction::createRead(pools[info.channel].transactions,
+                                        mr, info.channel, info.bank, info.row, info.startCol,
+                                        cts[i].second, data + offset) );
+            else
+                vtrans.push_back( ChannelTransaction::createRead(
                                     mr, // The parent memory request
                                     info.channel, // The channel identifier
                                     info.bank, // The bank indentifier
@@ -118,7 +129,12 @@ vector<ChannelTransaction*> MemoryRequestSplitter::split(MemoryRequest* mr)
         for ( U32 i = 0; i < cts.size(); i++ )
         {
             AddressInfo info = extractAddressInfo(cts[i].first);
-            vtrans.push_back( ChannelTransaction::createWrite(
+            if ( pools != 0 )
+                vtrans.push_back( ChannelTransaction::createWrite(pools[info.channel].transactions,
+                                        mr, info.channel, info.bank, info.row, info.startCol,
+                                        cts[i].second, data + offset) );
+            else
+                vtrans.push_back( ChannelTransaction::createWrite(
                                     mr, // The parent memory request
                                     info.channel, // The channel identifier
                                     info.bank, // The bank indentifier
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include "GPUType.h" // to include U32 type
+#include "MCObjectPool.h"
 
 namespace arch 
 {
@@ -34,6 +35,9 @@ public:
     // Called to split a mr in several channel transactions
     CTV split(MemoryRequest* mr);
 
+    // Channel transactions are taken from the pools of their channel (array indexed by channel)
+    void setObjectPools(ChannelObjectPools* channelPools);
+
     // Prints a representation of the address in the standard output
     virtual void printAddress(U32 address) const;
     
@@ -72,6 +76,8 @@ private:
 
     void assertTransaction(const ChannelTransaction* ct) const;
 
+    ChannelObjectPools* pools;
+
 };
 
 } // namespace memorycontroller
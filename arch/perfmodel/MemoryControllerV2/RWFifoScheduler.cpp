@@ -237,7 +237,7 @@ void RWFifoScheduler::handler_ddrCommandNotSent(const DDRCommand* notSentCommand
                     preCommand->setProtocolConstraint(notSentCommand->getProtocolConstraint());
                 //string icstr = DDRModuleState::getIssueConstraintStr(moduleState().getIssueConstraint(i, DDRModuleState::C_Precharge));
                 if ( !sendDDRCommand(cycle, preCommand, 0) )
-                    delete preCommand; // cannot be issued
+                    recycleCommand(preCommand); // cannot be issued
                 else {
                     closePageActivationsCount.inc();
                     return ; // no more commands can be issued this cycle
@@ -35,7 +35,6 @@ cmoPrimitiveAssembler::cmoPrimitiveAssembler(U32 vertCycle, U32 trCycle, U32 att
     paQueueSize(paQueueSz), clipperStartLat(clipStartLat), cmoMduBase(name, parent)
 
 {
-    DynamicObject *defaultState[1];
     U32 i;
 
     //  Check parameters.  
@@ -46,12 +45,9 @@ cmoPrimitiveAssembler::cmoPrimitiveAssembler(U32 vertCycle, U32 trCycle, U32 att
     //  Create state signal to the Command Processor.  
     commandProcessorState = newOutputSignal("PrimitiveAssemblyCommandState", 1, 1, NULL);
 
-    //  Set default signal value.  
-    defaultState[0] = new PrimitiveAssemblyStateInfo(PA_READY);
-
     /*  Set default primitive assembly state signal to the Command
         Processor.  */
-    commandProcessorState->setData(defaultState);
+    commandProcessorState.setInitial(PA_READY);
 
     //  Create new vertex signal from the cmoStreamController Commit.  
     streamerNewOutput = newInputSignal("PrimitiveAssemblyInput", verticesCycle,
@@ -350,17 +346,17 @@ void cmoPrimitiveAssembler::clock(U64 cycle)
     if (state == PAST_READY)
     {
         //  Send current state to the Command Processor.  
-        commandProcessorState->write(cycle, new PrimitiveAssemblyStateInfo(PA_READY));
+        commandProcessorState.write(cycle, PA_READY);
     }
     else if (state == PAST_DRAW_END)
     {
         //  Send current state to the Command Processor.  
-        commandProcessorState->write(cycle, new PrimitiveAssemblyStateInfo(PA_END));
+        commandProcessorState.write(cycle, PA_END);
     }
     else    //  It shouldn't matter what we send.  
     {
         //  Send current state to the Command Processor.  
-        commandProcessorState->write(cycle, new PrimitiveAssemblyStateInfo(PA_READY));
+        commandProcessorState.write(cycle, PA_READY);
     }
 }
 
@@ -7,12 +7,16 @@
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "PrimitiveAssemblyCommand.h"
 
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class PrimitiveAssemblyStateInfo;
+
 
 //*  Number of shaded vertices in the assembly vertex queue.  
 //#define NUM_ASSEMBLY_VERTEX 4
@@ -68,7 +72,7 @@ private:
 
     //  Primitive Assembly signals.  
     Signal *assemblyCommand;        //  Command signal from the Command Processor.  
-    Signal *commandProcessorState;  //  State signal to the Command Processor.  
+    StateWire<PrimitiveAssemblyStateInfo> commandProcessorState;    //  State signal to the Command Processor.  
     Signal *streamerNewOutput;      //  New vertex output signal from the StreamController Commit.  
     Signal *assemblyRequest;        //  Request signal from the Primitive Assembly unit to the cmoStreamController Commit unit.  
     Signal *clipperInput;           //  Triangle input signal to the Clipper unit.  
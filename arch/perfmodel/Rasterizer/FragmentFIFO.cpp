@@ -50,7 +50,6 @@ FragmentFIFO::FragmentFIFO(U32 hzStampsC, U32 stampCycle, bool unified, bool shS
 {
     U32 i;
     U32 j;
-    DynamicObject *defaultState[1];
 
     //  Check parameters.  
     GPU_ASSERT(
@@ -141,11 +140,8 @@ GPU_TEX_TRACE(
     //  Create state signal to the Hierarchical/Early Z mdu.  
     ffStateHZ = newOutputSignal("FFIFOStateHZ", 1, 1, NULL);
 
-    //  Create default state signal value.  
-    defaultState[0] = new FFIFOStateInfo(FFIFO_READY);
-
-    //  Set default signal value.  
-    ffStateHZ->setData(defaultState);
+    //  Set default signal value.
+    ffStateHZ.setInitial(FFIFO_READY);
 
     //  Create signals with Interpolator mdu.  
 
@@ -172,10 +168,10 @@ GPU_TEX_TRACE(
     //  Allocate arrays of signals with the Z Stencil Test and Color Write units.  
     zStencilInput = new Signal*[numStampUnits];
     zStencilOutput = new Signal*[numStampUnits];
-    zStencilState = new Signal*[numStampUnits];
-    fFIFOZSTState = new Signal*[numStampUnits];
+    zStencilState = new StateWire<ROPStatusInfo>[numStampUnits];
+    fFIFOZSTState = new StateWire<ROPStatusInfo>[numStampUnits];
     cWriteInput = new Signal*[numStampUnits];
-    cWriteState = new Signal*[numStampUnits];
+    cWriteState = new StateWire<ROPStatusInfo>[numStampUnits];
 
     //  Check allocation.  
     GPU_ASSERT(
@@ -217,11 +213,8 @@ GPU_TEX_TRACE(
         //  Create state signal to Z Stencil Test.  
         fFIFOZSTState[i] = newOutputSignal("FFIFOZStencilState", 1, 1, suPrefixes[i]);
 
-        //  Create default state signal value.  
-        defaultState[0] = new ROPStatusInfo(ROP_READY);
-
-        //  Set default signal value.  
-        fFIFOZSTState[i]->setData(defaultState);
+        //  Set default signal value.
+        fFIFOZSTState[i].setInitial(ROP_READY);
 
         //  Create input stamp signal to Color Write.  
         cWriteInput[i] = newOutputSignal("ColorWriteInput", stampsPerUnit * STAMP_FRAGMENTS, 1, suPrefixes[i]);
@@ -251,8 +244,8 @@ GPU_TEX_TRACE(
         //  Allocate array of signals for the virtual vertex shaders.  
         vertexInput = new Signal*[numVShaders];
         vertexOutput = new Signal*[numVShaders];
-        vertexState = new Signal*[numVShaders];
-        vertexConsumer = new Signal*[numVShaders];
+        vertexState = new StateWire<ShaderStateInfo>[numVShaders];
+        vertexConsumer = new StateWire<ConsumerStateInfo>[numVShaders];
 
         //  Check allocation.  
         GPU_ASSERT(
@@ -278,11 +271,8 @@ GPU_TEX_TRACE(
             //  Create state signal to cmoStreamController Loader.  
             vertexState[i] = newOutputSignal("ShaderState", 1, 1, vshPrefix[i]);
 
-            //  Create default state signal value.  
-            defaultState[0] = new ShaderStateInfo(SH_READY);
-
-            //  Set default signal value.  
-            vertexState[i]->setData(defaultState);
+            //  Set default signal value.
+            vertexState[i].setInitial(SH_READY);
 
             //  Create state signal from cmoStreamController Commit.  
             vertexConsumer[i] = newInputSignal("ConsumerState", 1, 1, vshPrefix[i]);
@@ -300,11 +290,8 @@ GPU_TEX_TRACE(
             //  Create triangle shader state signal to Triangle Setup.  
             triangleState = newOutputSignal("TriangleShaderState", 1, 1, NULL);
 
-            //  Create default state signal value.  
-            defaultState[0] = new ShaderStateInfo(SH_READY);
-
-            //  Set default signal value.  
-            triangleState->setData(defaultState);
+            //  Set default signal value.
+            triangleState.setInitial(SH_READY);
         }
     }
 
@@ -326,8 +313,8 @@ GPU_TEX_TRACE(
     //  Allocate array of signals to the shaders.  
     shaderInput = new Signal*[numFShaders];
     shaderOutput = new Signal*[numFShaders];
-    shaderState = new Signal*[numFShaders];
-    ffStateShader = new Signal*[numFShaders];
+    shaderState = new StateWire<ShaderStateInfo>[numFShaders];
+    ffStateShader = new StateWire<ConsumerStateInfo>[numFShaders];
 
     //  Check allocation.  
     GPU_ASSERT(
@@ -356,11 +343,8 @@ GPU_TEX_TRACE(
        //  Create state signal to the Shader.  
         ffStateShader[i] = newOutputSignal("ConsumerState", 1, 1, fshPrefix[i]);
 
-        //  Create default state signal value.  
-        defaultState[0] = new ConsumerStateInfo(CONS_READY);
-
-        //  Set default signal value.  
-        ffStateShader[i]->setData(defaultState);
+        //  Set default signal value.
+        ffStateShader[i].setInitial(CONS_READY);
     }
 
     //  Create signals with the main rasterizer mdu.  
@@ -371,11 +355,8 @@ GPU_TEX_TRACE(
     //  Create state signal to the main rasterizer mdu.  
     fFIFOState = newOutputSignal("FFIFOState", 1, 1, NULL);
 
-    //  Create default signal value.  
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
-    //  Set default signal value.  
-    fFIFOState->setData(defaultState);
+    //  Set default signal value.
+    fFIFOState.setInitial(RAST_RESET);
 
 
     //  Allocate space for the vertex consumer states.  
@@ -696,10 +677,6 @@ GPU_TEX_TRACE(
 void FragmentFIFO::clock(U64 cycle)
 {
     RasterizerCommand *rastCommand;
-    ROPStatusInfo *zstStateInfo;
-    ROPStatusInfo *cwStateInfo;
-    ShaderStateInfo *shStateInfo;
-    ConsumerStateInfo *consumerStateInfo;
     U32 i;
     U32 minFreeRast;
     char buffer[64];
@@ -715,11 +692,8 @@ void FragmentFIFO::clock(U64 cycle)
         for(i = 0; i < numVShaders; i++)
         {
             //  Read state from cmoStreamController Commit.  
-            if (vertexConsumer[i]->read(cycle, (DynamicObject *&) consumerStateInfo))
+            if (vertexConsumer[i].read(cycle, consumerState[i]))
             {
-                //  Get state.  
-                consumerState[i] = consumerStateInfo->getState();
-
                 //  Process last vertex sent to primitive assembly from cmoStreamController Commit.  
                 if (consumerState[i] == CONS_LAST_VERTEX_COMMIT)
                 {
@@ -739,10 +713,6 @@ void FragmentFIFO::clock(U64 cycle)
                      //  Last vertex state implicitly means ready state.  
                      consumerState[i] = CONS_READY;
                 }
-
-
-                //  Delete carrier object.  
-                delete consumerStateInfo;
             }
             else
             {
@@ -756,15 +726,7 @@ void FragmentFIFO::clock(U64 cycle)
     for(i = 0; i < numFShaders; i++)
     {
         //  Read state from Fragment Shader.  
-        if (shaderState[i]->read(cycle, (DynamicObject *&) shStateInfo))
-        {
-            //  Get state.  
-            shState[i] = shStateInfo->getState();
-
-            //  Delete carrier object.  
-            delete shStateInfo;
-        }
-        else
+        if (!shaderState[i].read(cycle, shState[i]))
         {
             sprintf(buffer, "State signal from Fragment Shader %d lost data.", i);
             CG_ASSERT(buffer);
@@ -774,15 +736,7 @@ void FragmentFIFO::clock(U64 cycle)
     //  Receive state from the Z Stencil Test units.  
     for (i = 0; i < numStampUnits; i++)
     {
-        if (zStencilState[i]->read(cycle, (DynamicObject *&) zstStateInfo))
-        {
-            //  Get Z Stencil State.  
-            zstState[i] = zstStateInfo->getState();
-
-            //  Delete carrier object.  
-            delete zstStateInfo;
-        }
-        else
+        if (!zStencilState[i].read(cycle, zstState[i]))
         {
             CG_ASSERT("Missing state signal from Z Stencil Test.");
         }
@@ -791,15 +745,7 @@ void FragmentFIFO::clock(U64 cycle)
     //  Receive state from the Color Write units.  
     for (i = 0; i < numStampUnits; i++)
     {
-        if (cWriteState[i]->read(cycle, (DynamicObject *&) cwStateInfo))
-        {
-            //  Get Color Write State.  
-            cwState[i] = cwStateInfo->getState();
-
-            //  Delete carrier object.  
-            delete cwStateInfo;
-        }
-        else
+        if (!cWriteState[i].read(cycle, cwState[i]))
         {
             CG_ASSERT("Missing state signal from Color Write.");
         }
@@ -1160,7 +1106,7 @@ switch(state)
     }
 
     //  Send state to the main rasterizer mdu.  
-    fFIFOState->write(cycle, new RasterizerStateInfo(state));
+    fFIFOState.write(cycle, state);
 
     //  Calculate the minimum number of free entries in the rasterized stamp queues.  
     for(i = 1, minFreeRast = freeRast[0]; i < numStampUnits; i++)
@@ -1169,13 +1115,13 @@ switch(state)
     //  Send state to Hierarchical unit.  
     if (minFreeRast >= (2 * hzStampsCycle))
     {
-        //  Create state carrier and send to signal.  
-        ffStateHZ->write(cycle, new FFIFOStateInfo(FFIFO_READY));
+        //  Send state to signal.
+        ffStateHZ.write(cycle, FFIFO_READY);
     }
     else
     {
-        //  Create state carrier and send to signal.  
-        ffStateHZ->write(cycle, new FFIFOStateInfo(FFIFO_BUSY));
+        //  Send state to signal.
+        ffStateHZ.write(cycle, FFIFO_BUSY);
     }
 
     //  Check shader model.  
@@ -1184,19 +1130,16 @@ switch(state)
         //  Send state to cmoStreamController Loader.  
         for(i = 0; i < numVShaders; i++)
         {
-            vertexState[i]->write(cycle,
-                new ShaderStateInfo((freeInputs == vInputQueueSz)?SH_EMPTY:
-                    ((freeInputs >= (2 * numVShaders))?SH_READY:SH_BUSY))
-                );
+            vertexState[i].write(cycle, (freeInputs == vInputQueueSz)?SH_EMPTY:
+                ((freeInputs >= (2 * numVShaders))?SH_READY:SH_BUSY));
         }
 
         //  Check if triangle setup in shaders is enabled.  
         if (shadedSetup)
         {
             //  Send state to Triangle Setup.  
-            triangleState->write(cycle, new ShaderStateInfo(
-                (freeInputTriangles >= ((1 + triangleLat) * trianglesCycle))?SH_READY:SH_BUSY)
-                );
+            triangleState.write(cycle,
+                (freeInputTriangles >= ((1 + triangleLat) * trianglesCycle))?SH_READY:SH_BUSY);
         }
     }
 
@@ -1205,7 +1148,7 @@ switch(state)
     {
         //  NOTE:  MUST BE IMPLEMENTED YET!!!!  TYPES OF STATE CARRIER ARE DIFFERENT!!   
         //  Send current state to the Fragment Shader.  
-        ffStateShader[i]->write(cycle, new ConsumerStateInfo(CONS_READY));
+        ffStateShader[i].write(cycle, CONS_READY);
     }
 
     //  Send state to the Z Stencil Test units.  
@@ -1215,12 +1158,12 @@ switch(state)
         if (freeTest[i] > (2 * stampsPerUnit))
         {
             //  Send current state to a Z Stencil Test unit.  
-            fFIFOZSTState[i]->write(cycle, new ROPStatusInfo(ROP_READY));
+            fFIFOZSTState[i].write(cycle, ROP_READY);
         }
         else
         {
             //  Send current state to a Z Stencil Test unit.  
-            fFIFOZSTState[i]->write(cycle, new ROPStatusInfo(ROP_BUSY));
+            fFIFOZSTState[i].write(cycle, ROP_BUSY);
         }
     }
 
@@ -2123,9 +2066,8 @@ void FragmentFIFO::endEarlyZ(U64 cycle)
                                 //  Get the pointer to the fragment attribute array.  
                                 attributes = testQueue[unit][nextFreeTest[unit]][j]->getAttributes();
 
-                                //  If attributes were allocated for the fragment delete them.  
-                                if (attributes != NULL)
-                                    delete[] attributes;
+                                //  If attributes were allocated for the fragment release them.  
+                                FragmentInput::releaseAttributes(attributes);
                             }
 
                             delete testQueue[unit][nextFreeTest[unit]][j]->getFragment();
@@ -2238,7 +2180,7 @@ void FragmentFIFO::shadeStamps(U64 cycle)
                     )
 
                     //  Create attributes for fake fragment.  
-                    paddingAttributes = new Vec4FP32[MAX_FRAGMENT_ATTRIBUTES];
+                    paddingAttributes = FragmentInput::allocateAttributes();
 
                     if (lastStampAttribs[k] != NULL)
                     {
@@ -2624,8 +2566,8 @@ void FragmentFIFO::distributeShaderOutput(U64 cycle)
                                         i, nextShaderOutput[i]);
                                 )
 
-                                //  Delete fake fragment attributes.  
-                                delete[] shOutput->getAttributes();
+                                //  Release fake fragment attributes.  
+                                FragmentInput::releaseAttributes(shOutput->getAttributes());
                             }
                             else
                             {
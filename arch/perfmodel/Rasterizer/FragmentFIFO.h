@@ -24,6 +24,7 @@
 
 
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUType.h"
 #include "support.h"
 #include "GPUReg.h"
@@ -44,6 +45,13 @@ using namespace std;
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class FFIFOStateInfo;
+class ShaderStateInfo;
+class ConsumerStateInfo;
+class ROPStatusInfo;
+class RasterizerStateInfo;
+
 
 /**
  *
@@ -78,28 +86,28 @@ private:
 
     //  Fragment FIFO Signals.  
     Signal *hzInput;            //  Stamp signal from Hierarchical/Early Z mdu.  
-    Signal *ffStateHZ;          //  Fragment FIFO tate signal to the Hierarchical/Early Z mdu.  
+    StateWire<FFIFOStateInfo> ffStateHZ;        //  Fragment FIFO tate signal to the Hierarchical/Early Z mdu.  
     Signal *interpolatorInput;  //  Input stamp signal to the Interpolator unit.  
     Signal *interpolatorOutput; //  Output stamp signal from the Interpolator unit.  
     Signal **shaderInput;       //  Array of stamp input signal to the Shader unit.  
     Signal **shaderOutput;      //  Array of stamp output signal from the Shader unit.  
-    Signal **shaderState;       //  Array of state signal from the Shader unit.  
-    Signal **ffStateShader;     //  Array of Fragment FIFO state signals to the Shader unit.  
+    StateWire<ShaderStateInfo> *shaderState;    //  Array of state signal from the Shader unit.  
+    StateWire<ConsumerStateInfo> *ffStateShader;   //  Array of Fragment FIFO state signals to the Shader unit.  
     Signal **vertexInput;       //  Array of vertex input signals from cmoStreamController Loader.  
     Signal **vertexOutput;      //  Array of vertex output signals to cmoStreamController Commit.  
-    Signal **vertexState;       //  Array of vertex state signals to cmoStreamController Loader.  
-    Signal **vertexConsumer;    //  Array of vertex consumer state signals from cmoStreamController Commit.  
+    StateWire<ShaderStateInfo> *vertexState;    //  Array of vertex state signals to cmoStreamController Loader.  
+    StateWire<ConsumerStateInfo> *vertexConsumer;  //  Array of vertex consumer state signals from cmoStreamController Commit.  
     Signal *triangleInput;      //  Triangle shader input signal from Triangle Setup.  
     Signal *triangleOutput;     //  Triangle shader output signal to Triangle Setup.  
-    Signal *triangleState;      //  Triangle shader state signal to Triangle Setup.  
+    StateWire<ShaderStateInfo> triangleState;   //  Triangle shader state signal to Triangle Setup.  
     Signal **zStencilInput;     //  Array of input stamp signal to the Z Stencil Test unit.  
     Signal **zStencilOutput;    //  Array of stamp signal from the Z Stencil Test unit.  
-    Signal **zStencilState;     //  Array of state signal from the Z Stencil Test unit.  
-    Signal **fFIFOZSTState;     //  Array of state signal to the Z Stencil Test unit.  
+    StateWire<ROPStatusInfo> *zStencilState;    //  Array of state signal from the Z Stencil Test unit.  
+    StateWire<ROPStatusInfo> *fFIFOZSTState;    //  Array of state signal to the Z Stencil Test unit.  
     Signal **cWriteInput;       //  Array of input stamp signal to the Color Write unit.  
-    Signal **cWriteState;       //  Array of state signal from the Color Write unit.  
+    StateWire<ROPStatusInfo> *cWriteState;      //  Array of state signal from the Color Write unit.  
     Signal *fFIFOCommand;       //  Command signal from the main rasterizer mdu.  
-    Signal *fFIFOState;         //  Command signal to the main rasterizer mdu.  
+    StateWire<RasterizerStateInfo> fFIFOState;  //  Command signal to the main rasterizer mdu.  
 
     //  Fragment FIFO parameters.  
     U32 hzStampsCycle;       //  Number of stamps received from Hierarchical Z per cycle.  
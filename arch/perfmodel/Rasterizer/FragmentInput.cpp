@@ -17,9 +17,25 @@
 
 #include "FragmentInput.h"
 #include "stdio.h"
+#include <vector>
 
 using namespace arch;
 
+//  Pool of released fragment attribute arrays.  
+struct FragmentAttributePool
+{
+    std::vector<Vec4FP32 *> freeArrays;
+
+    ~FragmentAttributePool()
+    {
+        for(size_t i = 0; i < freeArrays.size(); i++)
+            delete[] freeArrays[i];
+    }
+};
+
+//  One pool per simulator thread.  
+static thread_local FragmentAttributePool attributePool;
+
 //  Creates a new FragmentInput.  
 FragmentInput::FragmentInput(U32 ID, U32 setupID, Fragment *fragment, TileIdentifier id, U32 stampUnitID):
 
@@ -71,6 +87,24 @@ void FragmentInput::setAttributes(Vec4FP32 *attrib)
     attributes = attrib;
 }
 
+//  Gets a fragment attribute array from the pool.  
+Vec4FP32 *FragmentInput::allocateAttributes()
+{
+    if (attributePool.freeArrays.empty())
+        return new Vec4FP32[MAX_FRAGMENT_ATTRIBUTES];
+
+    Vec4FP32 *attrib = attributePool.freeArrays.back();
+    attributePool.freeArrays.pop_back();
+    return attrib;
+}
+
+//  Releases a fragment attribute array to the pool.  
+void FragmentInput::releaseAttributes(Vec4FP32 *attrib)
+{
+    if (attrib != NULL)
+        attributePool.freeArrays.push_back(attrib);
+}
+
 //  Gets the fragment input Fragment object.  
 Fragment *FragmentInput::getFragment() const
 {
@@ -128,6 +128,31 @@ public:
 
     void setAttributes(Vec4FP32 *attr);
 
+    /**
+     *
+     *  Gets an array for the interpolated attributes of a fragment
+     *  (MAX_FRAGMENT_ATTRIBUTES entries).  The arrays released by
+     *  the shader and ROP stages are recycled.
+     *
+     *  @return A pointer to the fragment attribute array.
+     *
+     */
+
+    static Vec4FP32 *allocateAttributes();
+
+    /**
+     *
+     *  Releases a fragment attribute array for reuse.  The arrays
+     *  are allocated with new[] so a pooled array can be deleted with
+     *  delete[] and any new[] array of MAX_FRAGMENT_ATTRIBUTES entries
+     *  can be released.
+     *
+     *  @param attr The fragment attribute array (can be NULL).
+     *
+     */
+
+    static void releaseAttributes(Vec4FP32 *attr);
+
     /**
      *
      *  Sets the fragment cull flag.
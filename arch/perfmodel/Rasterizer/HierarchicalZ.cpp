@@ -46,7 +46,6 @@ HierarchicalZ::HierarchicalZ(U32 stampCycle, U32 overWidth, U32 overHeight,
     cmoMduBase(name, parent)
 
 {
-    DynamicObject *defaultState[1];
     U32 i;
     string queueName;
 
@@ -76,11 +75,8 @@ HierarchicalZ::HierarchicalZ(U32 stampCycle, U32 overWidth, U32 overHeight,
     //  Create state signal to the Fragment Generation mdu.  
     hzTestState = newOutputSignal("HZTestState", 1, 1, NULL);
 
-    //  Create default state signal value.  
-    defaultState[0] = new HZStateInfo(HZST_READY);
-
     //  Set default signal value.  
-    hzTestState->setData(defaultState);
+    hzTestState.setInitial(HZST_READY);
 
     //  Create signals with Fragment FIFO mdu.  
 
@@ -99,11 +95,8 @@ HierarchicalZ::HierarchicalZ(U32 stampCycle, U32 overWidth, U32 overHeight,
     //  Create state signal to the main rasterizer mdu.  
     hzState = newOutputSignal("HZState", 1, 1, NULL);
 
-    //  Create default signal value.  
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default signal value.  
-    hzState->setData(defaultState);
+    hzState.setInitial(RAST_RESET);
 
 
     //  Create signals with the Z Test mdu.  
@@ -200,7 +193,6 @@ HierarchicalZ::HierarchicalZ(U32 stampCycle, U32 overWidth, U32 overHeight,
 void HierarchicalZ::clock(U64 cycle)
 {
     RasterizerCommand *rastCommand;
-    FFIFOStateInfo *ffStateInfo;
     FFIFOState ffState;
     HZUpdate *blockUpdate;
     HZAccess *hzOperation;
@@ -213,15 +205,7 @@ void HierarchicalZ::clock(U64 cycle)
     )
 
     //  Receive state from the Interpolator mdu.  
-    if (fFIFOState->read(cycle, (DynamicObject *&) ffStateInfo))
-    {
-        //  Get Interpolator state.  
-        ffState = ffStateInfo->getState();
-
-        //  Delete Interpolator state info object.  
-        delete ffStateInfo;
-    }
-    else
+    if (!fFIFOState.read(cycle, ffState))
     {
         CG_ASSERT("Missing state signal from the Interpolator mdu.");
     }
@@ -678,7 +662,7 @@ void HierarchicalZ::clock(U64 cycle)
             printf("HierarchicalZ => Sending READY.\n");
         )
 
-        hzTestState->write(cycle, new HZStateInfo(HZST_READY));
+        hzTestState.write(cycle, HZST_READY);
     }
     else
     {
@@ -686,11 +670,11 @@ void HierarchicalZ::clock(U64 cycle)
             printf("HierarchicalZ => Sending BUSY.\n");
         )
 
-        hzTestState->write(cycle, new HZStateInfo(HZST_BUSY));
+        hzTestState.write(cycle, HZST_BUSY);
     }
 
     //  Send state to the main rasterizer mdu.  
-    hzState->write(cycle, new RasterizerStateInfo(state));
+    hzState.write(cycle, state);
 }
 
 
@@ -20,6 +20,7 @@
 #define _HIERARCHICALZ_
 
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUType.h"
 #include "support.h"
 #include "GPUReg.h"
@@ -32,6 +33,11 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class FFIFOStateInfo;
+class HZStateInfo;
+class RasterizerStateInfo;
+
 
 /**
  *
@@ -111,10 +117,10 @@ private:
     //  Hierarchical Z Signals.  
     Signal *inputStamps;        //  Input stamp signal from Triangle Traversal.  
     Signal *outputStamps;       //  Output stamp signal to Interpolator.  
-    Signal *fFIFOState;         //  State signal from the Fragment FIFO mdu.  
-    Signal *hzTestState;        //  State signal to the Triangle Traversal mdu.  
+    StateWire<FFIFOStateInfo> fFIFOState;       //  State signal from the Fragment FIFO mdu.  
+    StateWire<HZStateInfo> hzTestState;         //  State signal to the Triangle Traversal mdu.  
     Signal *hzCommand;          //  Command signal from the main rasterizer mdu.  
-    Signal *hzState;            //  Command signal to the main rasterizer mdu.  
+    StateWire<RasterizerStateInfo> hzState;     //  Command signal to the main rasterizer mdu.  
     Signal **hzUpdate;          //  Array of update signals from the Z Test mdu.  
     Signal *hzBufferWrite;      //  Write signal for the HZ Buffer Level 0.  
     Signal *hzBufferRead;       //  Read signal for the HZ Buffer Level 0.  
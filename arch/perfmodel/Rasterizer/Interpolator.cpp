@@ -31,7 +31,6 @@ Interpolator::Interpolator(bmoRasterizer &bmRaster, U32 interp,
     cmoMduBase(name, parent)
 
 {
-    DynamicObject *defaultState[1];
 
     //  Create the signals.  
 
@@ -41,11 +40,8 @@ Interpolator::Interpolator(bmoRasterizer &bmRaster, U32 interp,
     //  Create state signal to the main rasterizer mdu.  
     interpolatorRastState = newOutputSignal("InterpolatorRasterizerState", 1, 1, NULL);
 
-    //  Create default signal value.  
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default signal value.  
-    interpolatorRastState->setData(defaultState);
+    interpolatorRastState.setInitial(RAST_RESET);
 
     //  Create input fragment signal from Fragment FIFO.  
     newFragment = newInputSignal("InterpolatorInput", stampsCycle * STAMP_FRAGMENTS, 1, NULL);
@@ -74,7 +70,8 @@ Interpolator::Interpolator(bmoRasterizer &bmRaster, U32 interp,
 void Interpolator::clock(U64 cycle)
 {
     FragmentInput *frInput;
-    Vec4FP32 *attributes;
+    FragmentInput *stamp[STAMP_FRAGMENTS];
+    U32 numFragments;
     RasterizerCommand *rastCommand;
     bool fragmentReceived;
     bool lastFragment;
@@ -202,140 +199,74 @@ void Interpolator::clock(U64 cycle)
             //  No last fragment processed.  
             lastFragment = FALSE;
 
-            //  Interpolate fragments.  
-            while(interpolationEnd->read(cycle, (DynamicObject *&) frInput))
+            //  Interpolate fragments, a stamp at a time.  
+            do
             {
+                //  Receive the fragments of a stamp.  
+                for(numFragments = 0; (numFragments < STAMP_FRAGMENTS) &&
+                    interpolationEnd->read(cycle, (DynamicObject *&) stamp[numFragments]); numFragments++);
 
-                /*  NOTE: !!! THIS WAY OF COUNTING THE TRIANGLES RECEIVED
-                    ONLY WORKS IF NO FRAGMENTS FROM DIFFERENT TRIANGLES
-                    ARE ISSUED AT THE SAME TIME!!!
-                    THE CORRECT IMPLEMENTATION WOULD USE A MESSAGE FROM
-                    PRIMITIVE ASSEMBLY.
-
-                    NOT USED ANY MORE FOR SYNCHRONIZATION.  CAN BE DELETED
-                    OR BE USED TO COUNT THE NUMBER OF TRIANGLES PASSING
-                    THROUGH THE INTERPOLATOR.
+                //  Interpolate the attributes of the stamp fragments.  
+                if (numFragments > 0)
+                    interpolateStamp(stamp, numFragments);
 
-                  */
-
-                //  Check if it is a fragment from a new triangle.  
-                if(frInput->getTriangleID() != currentTriangle)
+                for(j = 0; j < numFragments; j++)
                 {
+                    frInput = stamp[j];
 
-                    //  Change current triangle identifier.  
-                    currentTriangle = frInput->getTriangleID();
+                    /*  NOTE: !!! THIS WAY OF COUNTING THE TRIANGLES RECEIVED
+                        ONLY WORKS IF NO FRAGMENTS FROM DIFFERENT TRIANGLES
+                        ARE ISSUED AT THE SAME TIME!!!
+                        THE CORRECT IMPLEMENTATION WOULD USE A MESSAGE FROM
+                        PRIMITIVE ASSEMBLY.
 
-                    //  Set if it is the last triangle.  
-                    lastTriangle = (frInput->getFragment() == NULL);
+                        NOT USED ANY MORE FOR SYNCHRONIZATION.  CAN BE DELETED
+                        OR BE USED TO COUNT THE NUMBER OF TRIANGLES PASSING
+                        THROUGH THE INTERPOLATOR.
 
-                    //  Change first triangle received flag.  
-                    firstTriangle = TRUE;
+                      */
 
-                    //  Change current setup triangle identifier.  
-                    currentSetupTriangle = frInput->getSetupTriangle();
+                    //  Check if it is a fragment from a new triangle.  
+                    if(frInput->getTriangleID() != currentTriangle)
+                    {
 
-                    //  Update processed triangle counter.  
-                    triangleCounter++;
-                }
+                        //  Change current triangle identifier.  
+                        currentTriangle = frInput->getTriangleID();
 
-                //  Check if a culled fragment was received.  
-                if (frInput->getFragment() != NULL)
-                {
-                    //  Allocate an array for the fragment attributes.  
-                    attributes = new Vec4FP32[MAX_FRAGMENT_ATTRIBUTES];
+                        //  Set if it is the last triangle.  
+                        lastTriangle = (frInput->getFragment() == NULL);
 
-                    //  Interpolate fragment attributes.  
-                    for(i = 0; i < MAX_FRAGMENT_ATTRIBUTES; i++)
-                    {
-                        //  Check if the attribute is active.  
-                        if (fragmentAttributes[i])
-                        {
-                            //  Check if interpolation is enabled.  
-                            if (interpolation[i])
-                            {
-                                GPU_DEBUG_BOX(
-                                    printf("Interpolator => Interpolating fragment.\n");
-                                )
-
-                                //  Interpolate the fragment attributes.  
-                                //bmRaster.interpolate(frInput->getFragment(), attributes);
-                                attributes[i] = bmRaster.interpolate(frInput->getFragment(), i);
-                            }
-                            else
-                            {
-                                GPU_DEBUG_BOX(
-                                    printf("Interpolator => Copying from vertex attributes.\n");
-                                )
-
-                                //  Copy fragment attribute from the last (third) triangle vertex.  
-                                //bmRaster.copy(frInput->getFragment(), attributes, 0);
-                                attributes[i] = bmRaster.copy(frInput->getFragment(), i, 2);
-                            }
-                        }
-                        else
-                        {
-                            //  Write default attribute value for non active attribute.  
-                            DEFAULT_FRAGMENT_ATTRIBUTE(attributes[i]);
-                        }
-                    }
-
-                    //  Position attribute is a special case.  
-                    attributes[POSITION_ATTRIBUTE][0] = (F32) frInput->getFragment()->getX();
-                    attributes[POSITION_ATTRIBUTE][1] = (F32) frInput->getFragment()->getY();
+                        //  Change first triangle received flag.  
+                        firstTriangle = TRUE;
 
-                    /*  NOTE: !!! POSITION Z AND 1/W MUST BE CALCULATED IN
-                        A DIFFERENT WAY !!!
-                        NOT IMPLEMENTED YET.
-                    */
+                        //  Change current setup triangle identifier.  
+                        currentSetupTriangle = frInput->getSetupTriangle();
 
-                    //  Fragment depth must be scaled between 0 and 1.  
-                    attributes[POSITION_ATTRIBUTE][2] = ((F32) frInput->getFragment()->getZ()) /
-                        ((F32) ((1 << depthBitPrecission) - 1));
+                        //  Update processed triangle counter.  
+                        triangleCounter++;
+                    }
 
-                    attributes[POSITION_ATTRIBUTE][3] = 1.0;
-                    
-                    //  Triangle face/area attribute is another special case.
-                    attributes[FACE_ATTRIBUTE][3] = frInput->getFragment()->getTriangle()->getArea();
+                    //  Send fragment back to Fragment FIFO unit.  
+                    interpolatorOutput->write(cycle, frInput);
 
                     GPU_DEBUG_BOX(
-                        printf("Interpolator => Interpolated fragment attributes:\n");
-                        for(i = 0; i < MAX_FRAGMENT_ATTRIBUTES; i++)
-                            if (fragmentAttributes[i])
-                                printf("i[%d] = { %f, %f, %f, %f }\n", i, attributes[i][0], attributes[i][1],
-                                    attributes[i][2], attributes[i][3]);
+                        printf("Interpolator => Sending interpolated fragment to Fragment FIFO.\n");
                     )
 
-                    //  Set fragment attributes.  
-                    frInput->setAttributes(attributes);
-                }
-                else
-                {
-                    //  Empty fragment (last fragment).  No attributes.  
-                    frInput->setAttributes(NULL);
-                }
-
-
-                //  Send fragment back to Fragment FIFO unit.  
-                interpolatorOutput->write(cycle, frInput);
-
-                GPU_DEBUG_BOX(
-                    printf("Interpolator => Sending interpolated fragment to Fragment FIFO.\n");
-                )
+                    //  Check if it was the last fragment in the triangle.  
+                    if (frInput->getFragment() == NULL)
+                    {
+                        //  Updatet the number of last fragments received.  
+                        lastFragments++;
 
-                //  Check if it was the last fragment in the triangle.  
-                if (frInput->getFragment() == NULL)
-                {
-                    //  Updatet the number of last fragments received.  
-                    lastFragments++;
+                        //  Set if all the last fragments received.  
+                        lastFragment = (lastFragments == (numStampUnits * STAMP_FRAGMENTS));
+                    }
 
-                    //  Set if all the last fragments received.  
-                    lastFragment = (lastFragments == (numStampUnits * STAMP_FRAGMENTS));
+                    //  Update processed fragments counter.  
+                    fragmentCounter++;
                 }
-
-                //  Update processed fragments counter.  
-                fragmentCounter++;
-
-            }
+            } while (numFragments == STAMP_FRAGMENTS);
 
             //  Check end of the batch.  
             if (lastFragment)
@@ -368,7 +299,98 @@ void Interpolator::clock(U64 cycle)
     }
 
     //  Send state to the main rasterizer mdu.  
-    interpolatorRastState->write(cycle, new RasterizerStateInfo(state));
+    interpolatorRastState.write(cycle, state);
+}
+
+//  Interpolates the attributes of the fragments of a stamp.  
+void Interpolator::interpolateStamp(FragmentInput **stamp, U32 numFragments)
+{
+    Fragment *fragments[STAMP_FRAGMENTS];
+    Vec4FP32 *attributes[STAMP_FRAGMENTS];
+    bool interpolated[MAX_FRAGMENT_ATTRIBUTES];
+    Fragment *fr;
+    U32 fragment;
+    U32 numInterpolated;
+    U32 i;
+
+    //  Get attribute arrays for the fragments (culled fragments have no attributes).  
+    for(fragment = 0, numInterpolated = 0; fragment < numFragments; fragment++)
+    {
+        if (stamp[fragment]->getFragment() != NULL)
+        {
+            fragments[numInterpolated] = stamp[fragment]->getFragment();
+            attributes[numInterpolated] = FragmentInput::allocateAttributes();
+
+            //  Set fragment attributes.  
+            stamp[fragment]->setAttributes(attributes[numInterpolated]);
+
+            numInterpolated++;
+        }
+        else
+        {
+            //  Empty fragment (last fragment).  No attributes.  
+            stamp[fragment]->setAttributes(NULL);
+        }
+    }
+
+    if (numInterpolated == 0)
+        return;
+
+    GPU_DEBUG_BOX(
+        printf("Interpolator => Interpolating %d fragments.\n", numInterpolated);
+    )
+
+    //  Interpolate the active attributes with interpolation enabled for all the fragments.  
+    for(i = 0; i < MAX_FRAGMENT_ATTRIBUTES; i++)
+        interpolated[i] = fragmentAttributes[i] && interpolation[i];
+
+    bmRaster.interpolate(fragments, attributes, numInterpolated, interpolated);
+
+    for(fragment = 0; fragment < numInterpolated; fragment++)
+    {
+        fr = fragments[fragment];
+
+        for(i = 0; i < MAX_FRAGMENT_ATTRIBUTES; i++)
+        {
+            //  Check if the attribute is active.  
+            if (!fragmentAttributes[i])
+            {
+                //  Write default attribute value for non active attribute.  
+                DEFAULT_FRAGMENT_ATTRIBUTE(attributes[fragment][i]);
+            }
+            else if (!interpolation[i])
+            {
+                //  Copy fragment attribute from the last (third) triangle vertex.  
+                attributes[fragment][i] = bmRaster.copy(fr, i, 2);
+            }
+        }
+
+        //  Position attribute is a special case.  
+        attributes[fragment][POSITION_ATTRIBUTE][0] = (F32) fr->getX();
+        attributes[fragment][POSITION_ATTRIBUTE][1] = (F32) fr->getY();
+
+        /*  NOTE: !!! POSITION Z AND 1/W MUST BE CALCULATED IN
+            A DIFFERENT WAY !!!
+            NOT IMPLEMENTED YET.
+        */
+
+        //  Fragment depth must be scaled between 0 and 1.  
+        attributes[fragment][POSITION_ATTRIBUTE][2] = ((F32) fr->getZ()) /
+            ((F32) ((1 << depthBitPrecission) - 1));
+
+        attributes[fragment][POSITION_ATTRIBUTE][3] = 1.0;
+
+        //  Triangle face/area attribute is another special case.
+        attributes[fragment][FACE_ATTRIBUTE][3] = fr->getTriangle()->getArea();
+
+        GPU_DEBUG_BOX(
+            printf("Interpolator => Interpolated fragment attributes:\n");
+            for(i = 0; i < MAX_FRAGMENT_ATTRIBUTES; i++)
+                if (fragmentAttributes[i])
+                    printf("i[%d] = { %f, %f, %f, %f }\n", i, attributes[fragment][i][0], attributes[fragment][i][1],
+                        attributes[fragment][i][2], attributes[fragment][i][3]);
+        )
+    }
 }
 
 //  Processes a rasterizer command.  
@@ -22,6 +22,7 @@
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "RasterizerCommand.h"
 #include "bmRasterizer.h"
@@ -30,6 +31,10 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class RasterizerStateInfo;
+class FragmentInput;
+
 //** Maximum interpolation latency.  
 static const U32 MAX_INTERPOLATION_LATENCY = 8;
 
@@ -57,7 +62,7 @@ private:
 
     //  Interpolator signals.  
     Signal *interpolatorCommand;    //  Command signal from the main rasterizer mdu.  
-    Signal *interpolatorRastState;  //  State signal to the main rasterizer mdu.  
+    StateWire<RasterizerStateInfo> interpolatorRastState;   //  State signal to the main rasterizer mdu.  
     Signal *newFragment;            //  New fragment signal from Triangle Traversal.  
     Signal *interpolationStart;     //  Interpolation start signal.  
     Signal *interpolationEnd;       //  Interpolation end signal.  
@@ -112,6 +117,18 @@ private:
 
     void processRegisterWrite(GPURegister reg, U32 subreg, GPURegData data);
 
+    /**
+     *
+     *  Interpolates the attributes of the fragments of a stamp.  The
+     *  attribute arrays are obtained from the fragment attribute pool.
+     *
+     *  @param stamp The fragments of the stamp.
+     *  @param numFragments Number of fragments (STAMP_FRAGMENTS at most).
+     *
+     */
+
+    void interpolateStamp(FragmentInput **stamp, U32 numFragments);
+
 public:
 
     /**
@@ -45,7 +45,6 @@ cmoRasterizer::cmoRasterizer(bmoRasterizer &rsEmu, U32 trCycle, U32 tsFIFOSize,
 
 {
     U32 genStamps;
-    DynamicObject *defSignal[1];
 
     //  Check parameters.  
     GPU_ASSERT(
@@ -61,11 +60,8 @@ cmoRasterizer::cmoRasterizer(bmoRasterizer &rsEmu, U32 trCycle, U32 tsFIFOSize,
     //  Create state signal to the Command Processor.  
     rastStateSignal = newOutputSignal("RasterizerState", 1, 1, NULL);
 
-    //  Build initial signal state.  
-    defSignal[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default state signal value.  
-    rastStateSignal->setData(defSignal);
+    rastStateSignal.setInitial(RAST_RESET);
 
     //  Create command signal to Triangle Setup.  
     triangleSetupComm = newOutputSignal("TriangleSetupCommand", 1, 1, NULL);
@@ -227,7 +223,6 @@ cmoRasterizer::~cmoRasterizer()
 void cmoRasterizer::clock(U64 cycle)
 {
     RasterizerCommand *rastComm;
-    RasterizerStateInfo *rastStateInfo;
     RasterizerState tsState;
     RasterizerState ttState;
     RasterizerState hierZState;
@@ -257,71 +252,31 @@ void cmoRasterizer::clock(U64 cycle)
     //  Read state from all rasterizer boxes.  
 
     //  Get the Triangle Setup state.  
-    if (triangleSetupState->read(cycle, (DynamicObject *&) rastStateInfo))
-    {
-        //  Get triangle setup state.  
-        tsState = rastStateInfo->getState();
-
-        //  Delete rasterizer state info object.  
-        delete rastStateInfo;
-    }
-    else
+    if (!triangleSetupState.read(cycle, tsState))
     {
         CG_ASSERT("Missing signal from Triangle Setup.");
     }
 
     //  Get the Triangle Traversal state.  
-    if (triangleTraversalState->read(cycle, (DynamicObject *&) rastStateInfo))
-    {
-        //  Get Triangle Traversal state.  
-        ttState = rastStateInfo->getState();
-
-        //  Delete rasterizer state info object.  
-        delete rastStateInfo;
-    }
-    else
+    if (!triangleTraversalState.read(cycle, ttState))
     {
         CG_ASSERT("Missing signal from Triangle Traversal.");
     }
 
     //  Get the Hierarchical Z state.  
-    if (hzState->read(cycle, (DynamicObject *&) rastStateInfo))
-    {
-        //  Get Hierarchical Z state.  
-        hierZState = rastStateInfo->getState();
-
-        //  Delete rasterizer state info object.  
-        delete rastStateInfo;
-    }
-    else
+    if (!hzState.read(cycle, hierZState))
     {
         CG_ASSERT("Missing signal from Hierarchical Z.");
     }
 
     //  Read state from Interpolator.  
-    if (interpolatorState->read(cycle, (DynamicObject *&) rastStateInfo))
-    {
-        //  Get interpolator state.  
-        intState = rastStateInfo->getState();
-
-        //  Delete rasterizer state info object.  
-        delete rastStateInfo;
-    }
-    else
+    if (!interpolatorState.read(cycle, intState))
     {
         CG_ASSERT("Missing signal from Interpolator.");
     }
 
     //  Read state from Fragment FIFO.  
-    if (fFIFOState->read(cycle, (DynamicObject *&) rastStateInfo))
-    {
-        //  Get Fragment FIFO state.  
-        ffState = rastStateInfo->getState();
-
-        //  Delete rasterizer state info object.  
-        delete rastStateInfo;
-    }
-    else
+    if (!fFIFOState.read(cycle, ffState))
     {
         CG_ASSERT("Missing signal from Fragment FIFO.");
     }
@@ -474,7 +429,7 @@ void cmoRasterizer::clock(U64 cycle)
     }
 
     //  Write state signal to the Command Processor.  
-    rastStateSignal->write(cycle, new RasterizerStateInfo(state));
+    rastStateSignal.write(cycle, state);
 }
 
 //  Process the rasterizer command.  
@@ -24,6 +24,7 @@
 #include "GPUType.h"
 #include "support.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "RasterizerCommand.h"
 #include "GPUReg.h"
 #include "RasterizerState.h"
@@ -36,6 +37,9 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class RasterizerStateInfo;
+
 
 /**
  *
@@ -53,17 +57,17 @@ private:
 
     //  cmoRasterizer signals.  
     Signal *rastCommSignal;     //  Command signal from the Command Processor.  
-    Signal *rastStateSignal;    //  cmoRasterizer state signal to the Command Processor.  
+    StateWire<RasterizerStateInfo> rastStateSignal;     //  cmoRasterizer state signal to the Command Processor.  
     Signal *triangleSetupComm;  //  Command signal to Triangle Setup.  
-    Signal *triangleSetupState; //  State signal from Triangle Setup.  
+    StateWire<RasterizerStateInfo> triangleSetupState;  //  State signal from Triangle Setup.  
     Signal *triangleTraversalComm;  //  Command signal to Triangle Traversal.  
-    Signal *triangleTraversalState; //  State signal from Triangle Traversal.  
+    StateWire<RasterizerStateInfo> triangleTraversalState; //  State signal from Triangle Traversal.  
     Signal *hzCommand;          //  Command signal to Hierarchical Z.  
-    Signal *hzState;            //  State signal from Hierarchical Z.  
+    StateWire<RasterizerStateInfo> hzState;             //  State signal from Hierarchical Z.  
     Signal *interpolatorComm;   //  Command signal to Interpolator mdu.  
-    Signal *interpolatorState;  //  State signal from Interpolator mdu.  
+    StateWire<RasterizerStateInfo> interpolatorState;   //  State signal from Interpolator mdu.  
     Signal *fFIFOCommand;       //  Command signal to the Fragment FIFO mdu.  
-    Signal *fFIFOState;         //  State signal from the Fragment FIFO mdu.  
+    StateWire<RasterizerStateInfo> fFIFOState;          //  State signal from the Fragment FIFO mdu.  
 
     //  cmoRasterizer boxes.  
     TriangleSetup *triangleSetup;   //  Triangle Setup mdu.  
@@ -39,7 +39,6 @@ TriangleSetup::TriangleSetup(bmoRasterizer &rasEmu, U32 cycleTriangles, U32 tsFI
     triangleShaderQSz(triShQSz), bmRaster(rasEmu), cmoMduBase(name, parent)
 
 {
-    DynamicObject *defaultState[1];
 
     //  Check parameters. 
     GPU_ASSERT(
@@ -76,11 +75,8 @@ TriangleSetup::TriangleSetup(bmoRasterizer &rasEmu, U32 cycleTriangles, U32 tsFI
     //  Create state signal to the main Rasterizer state.  
     rastSetupState = newOutputSignal("TriangleSetupRasterizerState", 1, 1, NULL);
 
-    //  Create default signal value.  
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default signal value.  
-    rastSetupState->setData(defaultState);
+    rastSetupState.setInitial(RAST_RESET);
 
     if (!preTriangleBound)
     {
@@ -157,7 +153,6 @@ void TriangleSetup::clock(U64 cycle)
     TriangleSetupRequest *tsRequest;
     TriangleSetupInput *tsInput;
     ShaderInput *shInput;
-    ShaderStateInfo *shStateInfo;
     ShaderState shState;
     Vec4FP32 *shAttributes;
     Vec4FP32 *vertAttr1;
@@ -191,14 +186,7 @@ void TriangleSetup::clock(U64 cycle)
     if (shaderSetup)
     {
         //  Receive state from the shaders (FragmentFIFO).  
-        if (setupShaderState->read(cycle, (DynamicObject *&) shStateInfo))
-        {
-            //  Get current shaders state (FragmentFIFO).  
-            shState = shStateInfo->getState();
-
-            //  Delete shader state info object.  
-            delete shStateInfo;
-        }
+        setupShaderState.read(cycle, shState);
     }
 
     //  Process current state.  
@@ -625,7 +613,7 @@ void TriangleSetup::clock(U64 cycle)
     }
 
     //  Send current state to the rasterizer main mdu.  
-    rastSetupState->write(cycle, new RasterizerStateInfo(state));
+    rastSetupState.write(cycle, state);
 }
 
 //  Processes a rasterizer command.  
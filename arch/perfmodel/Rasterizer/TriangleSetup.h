@@ -16,6 +16,7 @@
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "Rasterizer.h"
 #include "RasterizerCommand.h"
@@ -31,6 +32,10 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class RasterizerStateInfo;
+class ShaderStateInfo;
+
 
 //*  Defines the different Triangle Setup states.  
 enum TriangleSetupState
@@ -72,7 +77,7 @@ private:
 
     //  Triangle Setup signals.  
     Signal *setupCommand;       //  Command signal from the Rasterizer main mdu.  
-    Signal *rastSetupState;     //  State signal to the Rasterizer main mdu.  
+    StateWire<RasterizerStateInfo> rastSetupState;  //  State signal to the Rasterizer main mdu.  
     Signal *inputTriangle;      //  New triangle signal from Primitive Assembly.  
     Signal *triangleRequest;    //  Request signal to the Clipper/Triangle Bound unit.  
     Signal *setupOutput;        //  Setup output signal to the Triangle Traversal/Fragment Generator.  
@@ -81,7 +86,7 @@ private:
     Signal *setupEnd;           //  Setup Triangle end signal.  End of the setup of a triangle.  
     Signal *setupShaderInput;   //  Triangle input signal to the unified shaders (FragmentFIFO).  
     Signal *setupShaderOutput;  //  Triangle output signal from the unified shaders (FragmentFIFO).  
-    Signal *setupShaderState;   //  Unified shader (FragmentFIFO) state signal.  
+    StateWire<ShaderStateInfo> setupShaderState;    //  Unified shader (FragmentFIFO) state signal.  
 
     //  Triangle Setup registers.  
     U32 hRes;                //  Display horizontal resolution.  
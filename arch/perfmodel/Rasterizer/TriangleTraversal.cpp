@@ -41,7 +41,6 @@ TriangleTraversal::TriangleTraversal(bmoRasterizer &rasEmu, U32 cycleTriangles,
     cmoMduBase(name, parent)
 
 {
-    DynamicObject *defaultState[1];
 
     //  Create statistics.  
     inputs = &getSM().getNumericStatistic("InputTriangles", U32(0), "TriangleTraversal", "TT");
@@ -71,11 +70,8 @@ TriangleTraversal::TriangleTraversal(bmoRasterizer &rasEmu, U32 cycleTriangles,
     //  Create state signal to the main rasterizer mdu.  
     traversalState = newOutputSignal("TriangleTraversalState", 1, 1, NULL);
 
-    //  Create default signal value.  
-    defaultState[0] = new RasterizerStateInfo(RAST_RESET);
-
     //  Set default signal value.  
-    traversalState->setData(defaultState);
+    traversalState.setInitial(RAST_RESET);
 
     //  Create setup triangle input from the Triangle Setup mdu.  
     setupTriangle = newInputSignal("TriangleSetupOutput", trianglesCycle, setupLatency, NULL);
@@ -117,7 +113,6 @@ TriangleTraversal::TriangleTraversal(bmoRasterizer &rasEmu, U32 cycleTriangles,
 void TriangleTraversal::clock(U64 cycle)
 {
     RasterizerCommand *rastCommand;
-    HZStateInfo *hzStateInfo;
     HZState hzCurrentState;
     TriangleSetupOutput *tsOutput;
     TriangleSetupRequest *tsRequest;
@@ -136,15 +131,7 @@ void TriangleTraversal::clock(U64 cycle)
     )
 
     //  Receive state from the Hierarchical Z unit.  
-    if (hzState->read(cycle, (DynamicObject *&) hzStateInfo))
-    {
-        //  Get HZ state.  
-        hzCurrentState = hzStateInfo->getState();
-
-        //  Delete HZ state info object.  
-        delete hzStateInfo;
-    }
-    else
+    if (!hzState.read(cycle, hzCurrentState))
     {
         CG_ASSERT("Missing state signal from the Hierarchical Z mdu.");
     }
@@ -606,7 +593,7 @@ printf("B");
     }
 
     //  Send current state to the main Rasterizer mdu.  
-    traversalState->write(cycle, new RasterizerStateInfo(state));
+    traversalState.write(cycle, state);
 }
 
 
@@ -18,6 +18,7 @@
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "RasterizerCommand.h"
 #include "bmRasterizer.h"
@@ -32,6 +33,10 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class RasterizerStateInfo;
+class HZStateInfo;
+
 
 //*  Defines the different Triangle Traversal  states.  
 enum TriangleTraversaState
@@ -59,11 +64,11 @@ private:
 
     //  Triangle Traversal signals.  
     Signal *traversalCommand;   //  Command signal from the main Rasterizer cmoMduBase.  
-    Signal *traversalState;     //  State signal to the main Rasterizer cmoMduBase.  
+    StateWire<RasterizerStateInfo> traversalState;  //  State signal to the main Rasterizer cmoMduBase.  
     Signal *setupTriangle;      //  Setup triangle signal from the Setup mdu.  
     Signal *setupRequest;       //  Triangle Traversal request to the Triangle Setup mdu.  
     Signal *newFragment;        //  New fragment signal to the Hierarchical Z mdu.  
-    Signal *hzState;            //  State signal from the Hierarchical Z mdu.  
+    StateWire<HZStateInfo> hzState;                 //  State signal from the Hierarchical Z mdu.  
 
     //  Triangle Traversal registers.
     U32 hRes;                //  Display horizontal resolution.  
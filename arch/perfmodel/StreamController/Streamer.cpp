@@ -53,8 +53,6 @@ cmoStreamController::cmoStreamController(U32 idxCycle, U32 idxBufferSz, U32 outF
     U32 numShadersPerSL;
     char **sLoaderName;
 
-    DynamicObject *defaultStreamerState[1];
-    //DynamicObject *defaultConsumerState[1];
 
     //  Check shaders and shader signals prefixes.  
     GPU_ASSERT(
@@ -86,11 +84,8 @@ cmoStreamController::cmoStreamController(U32 idxCycle, U32 idxBufferSz, U32 outF
     //  Create state signal to the Command Processor.  
     streamStateSignal = newOutputSignal("StreamerState", 1, 1, NULL);
 
-    //  Build initial signal data.  
-    defaultStreamerState[0] = new StreamerStateInfo(ST_READY);
-
-    //  Set initial signal value.  
-    streamStateSignal->setData(defaultStreamerState);
+    //  Set initial signal value.
+    streamStateSignal.setInitial(ST_READY);
 
     //  Create command signal to the cmoStreamController Fetch.  
     streamerFetchCom = newOutputSignal("StreamerFetchCommand", 1, 1);
@@ -196,7 +191,6 @@ void cmoStreamController::clock(U64 cycle)
 {
     //MemoryTransaction *memTrans;
     StreamerCommand *streamCom;
-    StreamerStateInfo *streamState;
     StreamerState streamCommit;
     StreamerState streamFetch;
 
@@ -222,30 +216,14 @@ void cmoStreamController::clock(U64 cycle)
     streamerCommit->clock(cycle);
 
     //  Get state from the cmoStreamController Fetch.  
-    if(streamerFetchState->read(cycle, (DynamicObject *&) streamState))
-    {
-        //  Keep state info.  
-        streamFetch = streamState->getState();
-
-        //  Delete StreamController state info object.  
-        delete streamState;
-    }
-    else
+    if(!streamerFetchState.read(cycle, streamFetch))
     {
         //  Missing state signal.  
         CG_ASSERT("No state signal from the cmoStreamController Fetch.");
     }
 
     //  Get state from the cmoStreamController Commit.  
-    if (streamerCommitState->read(cycle, (DynamicObject *&) streamState))
-    {
-        //  Keep state info.  
-        streamCommit = streamState->getState();
-
-        //  Delete StreamController state info object.  
-        delete streamState;
-    }
-    else
+    if (!streamerCommitState.read(cycle, streamCommit))
     {
         //  Missing signal.  
         CG_ASSERT("No state signal from the cmoStreamController Commit.");
@@ -376,7 +354,7 @@ void cmoStreamController::clock(U64 cycle)
     }
 
     //  Send cmoStreamController state to the Command Processor.  
-    streamStateSignal->write(cycle, new StreamerStateInfo(state));
+    streamStateSignal.write(cycle, state);
 }
 
 //  Processes a stream command.  
@@ -997,6 +975,27 @@ void cmoStreamController::processGPURegisterWrite(GPURegister gpuReg, U32 gpuSub
 
             break;
 
+        case GPU_STREAM_BASE_VERTEX:
+
+            //  Value added to the indices read from the index stream.
+
+            GPU_DEBUG(
+                printf("cmoStreamController => GPU_STREAM_BASE_VERTEX = %d.\n", gpuData.intVal);
+            )
+
+            //  Send register write to the cmoStreamController Fetch.
+
+            //  Create StreamController register write.
+            streamCom = new StreamerCommand(gpuReg, gpuSubReg, gpuData);
+
+            //  Copy cookies from original StreamController command.
+            streamCom->copyParentCookies(*lastStreamCom);
+
+            //  Write command to the cmoStreamController Fetch.
+            streamerFetchCom->write(cycle, streamCom);
+
+            break;
+
         case GPU_INDEX_MODE:
             //  Indexed streaming mode enabled/disabled.  
 
@@ -11,6 +11,7 @@
 #include "support.h"
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "StreamerCommand.h"
 #include "ShaderInput.h"
@@ -22,6 +23,9 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class StreamerStateInfo;
+
 
 //**  Unassigned output cache tag identifier.  
 static const U32 UNASSIGNED_OUTPUT_TAG = 0xffffffff;
@@ -69,13 +73,13 @@ private:
 
     //  cmoStreamController main mdu signals.  
     Signal *streamCtrlSignal;       //  Control signal from the Command Processor.  
-    Signal *streamStateSignal;      //  State signal to the Command Processor.  
+    StateWire<StreamerStateInfo> streamStateSignal;     //  State signal to the Command Processor.  
     Signal *streamerFetchCom;       //  Command Signal to the StreamController Fetch.  
     Signal *streamerOCCom;          //  Command Signal to the StreamController Output Cache.  
     Signal **streamerLoaderCom;     //  Command Signal to the StreamController Loader Units.  
     Signal *streamerCommitCom;      //  Command Signal to the StreamController Commit.  
-    Signal *streamerFetchState;     //  State signal from the StreamController Fetch.  
-    Signal *streamerCommitState;    //  State signal from the StreamController Commit.  
+    StateWire<StreamerStateInfo> streamerFetchState;    //  State signal from the StreamController Fetch.  
+    StateWire<StreamerStateInfo> streamerCommitState;   //  State signal from the StreamController Commit.  
 
     //  cmoStreamController sub boxes.  
     StreamerFetch *streamerFetch;               //  The StreamController Fetch subunit.  
@@ -35,8 +35,6 @@ StreamerCommit::StreamerCommit(U32 idxCycle, U32 oFIFOSize, U32 omSize, U32 nSha
 
 {
     U32 i;
-    DynamicObject *defaultStreamerState[1];
-    DynamicObject *defaultConsumerState[1];
 
    //  Check shaders and shader signals prefixes.  
     GPU_ASSERT(
@@ -57,7 +55,7 @@ StreamerCommit::StreamerCommit(U32 idxCycle, U32 oFIFOSize, U32 omSize, U32 nSha
     )
 
     //  Allocate signal arrays for the shader signals.  
-    shConsumerSignal = new Signal*[numShaders];
+    shConsumerSignal = new StateWire<ConsumerStateInfo>[numShaders];
     shOutputSignal = new Signal*[numShaders];
 
     //  Create signals from/to the shaders.  
@@ -66,11 +64,8 @@ StreamerCommit::StreamerCommit(U32 idxCycle, U32 oFIFOSize, U32 omSize, U32 nSha
         //  cmoStreamController state signals to the shaders.  
         shConsumerSignal[i] = newOutputSignal("ConsumerState", 1, 1, shPrefixArray[i]);
 
-        //  Build initial signal data.  
-        defaultConsumerState[0] = new ConsumerStateInfo(CONS_READY);
-
-        //  Set default StreamController state signal to the shaders.  
-        shConsumerSignal[i]->setData(defaultConsumerState);
+        //  Set default StreamController state signal to the shaders.
+        shConsumerSignal[i].setInitial(CONS_READY);
 
         //  Output signal from the shaders.  
         shOutputSignal[i] = newInputSignal("ShaderOutput", 1, shMaxOutLat, shPrefixArray[i]);
@@ -82,11 +77,8 @@ StreamerCommit::StreamerCommit(U32 idxCycle, U32 oFIFOSize, U32 omSize, U32 nSha
     //  Create state signal to the cmoStreamController main mdu.  
     streamerCommitState = newOutputSignal("StreamerCommitState", 1, 1, NULL);
 
-    //  Build initial signal state.  
-    defaultStreamerState[0] = new StreamerStateInfo(ST_RESET);
-
-    //  Set initial signal value.  
-    streamerCommitState->setData(defaultStreamerState);
+    //  Set initial signal value.
+    streamerCommitState.setInitial(ST_RESET);
 
     //  Create the output signal to the Primitive Assembly unit.  
     assemblyOutputSignal = newOutputSignal("PrimitiveAssemblyInput", verticesCycle,
@@ -718,7 +710,7 @@ outputFIFO[nextOutput].stCCom);
     }
 
     //  Send current state to the cmoStreamController main mdu.  
-    streamerCommitState->write(cycle, new StreamerStateInfo(state));
+    streamerCommitState.write(cycle, state);
 
     //  Send consumer state to the Shader.  
     for(i = 0; i < numShaders; i++)
@@ -730,7 +722,7 @@ outputFIFO[nextOutput].stCCom);
         if (lastOutputSent)
         {
             //  Send last output sent signal to Fragment FIFO.  
-            shConsumerSignal[i]->write(cycle, new ConsumerStateInfo(CONS_LAST_VERTEX_COMMIT));
+            shConsumerSignal[i].write(cycle, CONS_LAST_VERTEX_COMMIT);
 
             //  Reset last output sent state.  
             lastOutputSent = false;
@@ -738,7 +730,7 @@ outputFIFO[nextOutput].stCCom);
         else if (firstOutput)
         {
             //  Send first output sent signal to Fragment FIFO.  
-            shConsumerSignal[i]->write(cycle, new ConsumerStateInfo(CONS_FIRST_VERTEX_IN));
+            shConsumerSignal[i].write(cycle, CONS_FIRST_VERTEX_IN);
 
             //  Reset last output sent state.  
             firstOutput = false;
@@ -746,7 +738,7 @@ outputFIFO[nextOutput].stCCom);
         else
         {
             //  Send ready state to shaders.  
-            shConsumerSignal[i]->write(cycle, new ConsumerStateInfo(CONS_READY)); 
+            shConsumerSignal[i].write(cycle, CONS_READY);
         }
     }
 
@@ -20,6 +20,10 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class ConsumerStateInfo;
+class StreamerStateInfo;
+
     class StreamerCommit;
 
 } // namespace arch
@@ -27,6 +31,7 @@ namespace arch
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "Streamer.h"
 #include "StreamerCommand.h"
 #include "StreamerControlCommand.h"
@@ -79,9 +84,9 @@ private:
 
     //  cmoStreamController Commit signals.  
     Signal **shOutputSignal;            //  Pointer to an array of shader output signals.  
-    Signal **shConsumerSignal;          //  Pointer to an array of consumer state (StreamController) signals to the Shaders.  
+    StateWire<ConsumerStateInfo> *shConsumerSignal; //  Pointer to an array of consumer state (StreamController) signals to the Shaders.  
     Signal *streamerCommitCommand;      //  Command signal from the cmoStreamController main mdu.  
-    Signal *streamerCommitState;        //  State signal to the cmoStreamController main mdu.  
+    StateWire<StreamerStateInfo> streamerCommitState;   //  State signal to the cmoStreamController main mdu.  
     Signal *streamerCommitNewIndex;     //  New index signal from the cmoStreamController Output cache.  
     Signal *streamerCommitDeAlloc;      //  Deallocation signal to the cmoStreamController Fetch.  
     Signal *streamerCommitDeAllocOC;    //  Deallocation signal to the cmoStreamController Output cache.  
@@ -29,7 +29,6 @@ StreamerFetch::StreamerFetch(U32 idxCycle, U32 idxBufferSize, U32 oFIFOSize,
     streamerLoaderUnits(streamLoadUnits), slIndicesCycle(slIdxCycle), cmoMduBase(name, parent)
 
 {
-    DynamicObject *defaultState[1];
     unsigned int i;
 
     //  Check structure sizes.  
@@ -92,6 +91,7 @@ StreamerFetch::StreamerFetch(U32 idxCycle, U32 idxBufferSize, U32 oFIFOSize,
     streamStart = 0;
     streamCount = 0;
     streamInstances = 1;
+    streamBaseVertex = 0;
 
     //  Create the cmoStreamController Fetch signals.  
 
@@ -107,11 +107,8 @@ StreamerFetch::StreamerFetch(U32 idxCycle, U32 idxBufferSize, U32 oFIFOSize,
     //  State signal to the cmoStreamController main mdu.  
     streamerFetchState = newOutputSignal("StreamerFetchState", 1, 1);
 
-    //  Create default state for the StreamController fetch state signal.  
-    defaultState[0] = new StreamerStateInfo(ST_RESET);
-
-    //  Set default state for the StreamController fetch state signal.  
-    streamerFetchState->setData(defaultState);
+    //  Set default state for the StreamController fetch state signal.
+    streamerFetchState.setInitial(ST_RESET);
 
     //  Signal to the StreamController output cache.  
     streamerOutputCache = newOutputSignal("StreamerOutputCache", indicesCycle, 1);
@@ -528,8 +525,8 @@ cycle, indexedMode?"T":"F", fetchedIndexes, (indexBufferSize - indexData), freeO
                             skipPaddingBytes = false;
                         }
 
-                        //  Fetch next index from the index buffer.  
-                        newIndex = indexDataConvert(indexStreamData, &indexBuffer[nextIndex]);
+                        //  Fetch next index from the index buffer and add the base vertex.  
+                        newIndex = indexDataConvert(indexStreamData, &indexBuffer[nextIndex]) + U32(streamBaseVertex);
 
                         GPU_DEBUG_BOX(
                             printf("StreamerFetch (%lld) => Getting new index %d from the index buffer position %08x for instance %d\n", cycle, newIndex, nextIndex, fetchInstance);
@@ -720,7 +717,7 @@ cycle, indexedMode?"T":"F", fetchedIndexes, (indexBufferSize - indexData), freeO
     }
 
     //  Send cmoStreamController Fetch state to the cmoStreamController main mdu.  
-    streamerFetchState->write(cycle, new StreamerStateInfo(state));
+    streamerFetchState.write(cycle, state);
 }
 
 //  Process a StreamController command.  
@@ -941,6 +938,17 @@ void StreamerFetch::processGPURegisterWrite(GPURegister gpuReg, U32 gpuSubReg,
 
             break;
 
+        case GPU_STREAM_BASE_VERTEX:
+
+            //  Value added to the indices read from the index stream.
+            streamBaseVertex = gpuData.intVal;
+
+            GPU_DEBUG_BOX(
+                printf("StreamerFetch => GPU_STREAM_BASE_VERTEX = %d.\n", gpuData.intVal);
+            )
+
+            break;
+
         case GPU_INDEX_MODE:
             //  Indexed streaming mode enabled/disabled.  
 
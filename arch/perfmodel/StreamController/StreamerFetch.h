@@ -20,6 +20,9 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class StreamerStateInfo;
+
 
     class StreamerFetch;
 
@@ -29,6 +32,7 @@ namespace arch
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "Streamer.h"
 #include "StreamerControlCommand.h"
 #include "StreamerCommand.h"
@@ -70,12 +74,13 @@ private:
     U32 streamStart;             //  Start index position (non indexed mode).  
     U32 streamCount;             //  Stream count (number of indexes/inputs) to fetch.  
     U32 streamInstances;         //  Number of instances of the current stream to process.  
+    S32 streamBaseVertex;        //  Value added to the indices read from the index stream.  
 
     //  cmoStreamController Fetch Signals.  
     Signal *streamerFetchMemReq;    //  Request signal to the Memory Controller.  
     Signal *streamerFetchMemData;   //  Data signal from the Memory Controller.  
     Signal *streamerFetchCommand;   //  cmoStreamController Command signal from the cmoStreamController mdu.  
-    Signal *streamerFetchState;     //  State signal to the cmoStreamController.  
+    StateWire<StreamerStateInfo> streamerFetchState;    //  State signal to the cmoStreamController.  
     Signal *streamerOutputCache;    //  Signal to the StreamController output cache.  
     Signal **streamerLoaderDeAlloc; //  Deallocation signal from the StreamController loader units.  
     Signal *streamerCommitDeAlloc;  //  Deallocation signal from the StreamController commit.  
@@ -57,7 +57,7 @@ StreamerLoader::StreamerLoader(U32 unitId, U32 idxCycle, U32 irqSize, U32 attrCy
 
     //  Allocate signal arrays for the shader signals.  
     shCommSignal = new Signal*[numShaders];
-    shStateSignal = new Signal*[numShaders];
+    shStateSignal = new StateWire<ShaderStateInfo>[numShaders];
 
     //  Create signals from/to the shaders.  
     for(i = 0; i < numShaders; i++)
@@ -143,7 +143,6 @@ void StreamerLoader::clock(U64 cycle)
     MemoryTransaction *memTrans;
     StreamerCommand *streamCom;
     StreamerControlCommand *streamCCom, *streamCComAux;
-    ShaderStateInfo *shStateInfo;
     ShaderInput *input;
     Vec4FP32 *iaux;
     U32 nextAttribute;
@@ -159,17 +158,11 @@ void StreamerLoader::clock(U64 cycle)
     for (i = 0; i < numShaders; i++)
     {
         //  Get the state signal from a Shader.  
-        if (!shStateSignal[i]->read(cycle, (DynamicObject *&) shStateInfo))
+        if (!shStateSignal[i].read(cycle, shaderState[i]))
         {
-            //  Something got lost.  
+            //  Something got lost.
             CG_ASSERT("Missing state signal from a Shader.");
         }
-
-        //  Store shader state.  
-        shaderState[i] = shStateInfo->getState();
-
-        //  Delete state signal.  
-        delete shStateInfo;
     }
 
     //  Get memory transactions and state from Memory Controller.  
@@ -17,6 +17,9 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class ShaderStateInfo;
+
     class StreamerLoader;
 
 } // namespace arch
@@ -27,6 +30,7 @@ namespace arch
 
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "Streamer.h"
 #include "StreamerCommand.h"
 //#include "MemoryController.h"
@@ -86,7 +90,7 @@ private:
     Signal *memoryData;             //  Data signal from the Memory Controller.  
     Signal *streamerCommand;        //  Command signal from the main cmoStreamController mdu.  
     Signal **shCommSignal;          //  Pointer to an array of command signals to the Shaders.  
-    Signal **shStateSignal;         //  Pointer to an array of shader state signals.  
+    StateWire<ShaderStateInfo> *shStateSignal;  //  Pointer to an array of shader state signals.  
 
     //  cmoStreamController Loader registers.  
     U32 streamAddress[MAX_STREAM_BUFFERS];   //  Stream buffer address in GPU local memory.  
@@ -34,8 +34,7 @@ cmoShaderDecExe::cmoShaderDecExe(bmoUnifiedShader &bmShader, U32 threads,
 
 {
 
-    DynamicObject* defValue[1];
-    U32 i;
+U32 i;
     char fullName[64];
     char postfix[32];
     char tuPrefix[64];
@@ -105,11 +104,8 @@ cmoShaderDecExe::cmoShaderDecExe(bmoUnifiedShader &bmShader, U32 threads,
     executionStartSignal = newOutputSignal("ShaderExecution", threadsCycle * instrCycle * MAX_EXEC_BW, MAX_EXEC_LAT, shPrefix);
     executionEndSignal = newInputSignal("ShaderExecution", threadsCycle * instrCycle * MAX_EXEC_BW, MAX_EXEC_LAT, shPrefix);
 
-    //  Build initial signal state array.  
-    defValue[0] = new ShaderDecodeStateInfo(SHDEC_READY);
-
-    //  Set ShaderDecodeState signal initial value. 
-    decodeStateSignal->setData(defValue);
+//  Set ShaderDecodeState signal initial value. 
+    decodeStateSignal.setInitial(SHDEC_READY);
 
     //  Allocate the array of signals with the texture units.  
     if (textureUnits > 0)
@@ -713,7 +709,7 @@ void cmoShaderDecExe::clock(U64 cycle)
 
     decodeState = (freeInstr >= 2)?SHDEC_READY:SHDEC_BUSY;
 
-    decodeStateSignal->write(cycle, new ShaderDecodeStateInfo(decodeState));
+    decodeStateSignal.write(cycle, decodeState);
 
 }
 
@@ -14,6 +14,7 @@
 #define _SHADERDECODEXECUTE_
 
 #include "MduBase.h"
+#include "StateWire.h"
 #include "ShaderCommon.h"
 #include "ShaderState.h"
 #include "ShaderInstr.h"
@@ -93,7 +94,7 @@ private:
     Signal *controlSignal;          //  Output signal to the ShaderFetch mdu.  Carries control flow changes.  
     Signal *executionStartSignal;   //  Output signal to the cmoShaderDecExe mdu.  Starts an instruction execution.  
     Signal *executionEndSignal;     //  Input Signal from the ShadeDecodeExecute mdu.  End of an instruction execution.  
-    Signal *decodeStateSignal;      //  Decoder state signal to the ShaderFetch mdu.  
+    StateWire<ShaderDecodeStateInfo> decodeStateSignal;  //  Decoder state signal to the ShaderFetch mdu.  
     Signal **textRequestSignal;     //  Texture access request signal to the Texture Unit.  
     Signal **textResultSignal;      //  Texture result signal from the Texture Unit.  
     Signal **textUnitStateSignal;   //  State signal from the Texture Unit.  
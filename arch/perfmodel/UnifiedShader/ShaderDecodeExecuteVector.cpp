@@ -44,8 +44,7 @@ cmoShaderDecExeVector::cmoShaderDecExeVector(bmoUnifiedShader &bmShader, U32 thr
 
 {
 
-    DynamicObject* defValue[1];
-    char fullName[64];
+char fullName[64];
     char postfix[32];
     char tuPrefix[64];
 
@@ -133,11 +132,8 @@ cmoShaderDecExeVector::cmoShaderDecExeVector(bmoUnifiedShader &bmShader, U32 thr
     executionStartSignal = newOutputSignal("ShaderExecution", vectorALUWidth * instrCycle * MAX_EXEC_BW, MAX_EXEC_LAT, shPrefix);
     executionEndSignal = newInputSignal("ShaderExecution", vectorALUWidth * instrCycle * MAX_EXEC_BW, MAX_EXEC_LAT, shPrefix);
 
-    //  Build initial signal state array.
-    defValue[0] = new ShaderDecodeStateInfo(SHDEC_READY);
-
-    //  Set ShaderDecodeState signal initial value.
-    decodeStateSignal->setData(defValue);
+//  Set ShaderDecodeState signal initial value.
+    decodeStateSignal.setInitial(SHDEC_READY);
 
     //  Allocate the array of signals with the texture units.
     if (textureUnits > 0)
@@ -403,7 +399,7 @@ void cmoShaderDecExeVector::sendDecodeState(U64 cycle)
             (decodeState == SHDEC_READY) ? "SHDEC_READY" : "SHDEC_BUSY");
     )
     
-    decodeStateSignal->write(cycle, new ShaderDecodeStateInfo(decodeState));
+    decodeStateSignal.write(cycle, decodeState);
 }
 
 //  Update the execute stage state and execute instructions.
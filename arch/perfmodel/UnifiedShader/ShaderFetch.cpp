@@ -50,7 +50,6 @@ cmoShaderFetch::cmoShaderFetch(bmoUnifiedShader &bmShader, U32 nThreads,
 {
     U32 i;
     U32 j;
-    DynamicObject *defValue[1];
     char fullName[64];
     char postfix[32];
 
@@ -150,11 +149,8 @@ cmoShaderFetch::cmoShaderFetch(bmoUnifiedShader &bmShader, U32 nThreads,
     //  Signal to the cmoStreamController.  Shader state.  
     readySignal = newOutputSignal("ShaderState", 1, 1, shPrefix);
 
-    //  Build initial signal state.  
-    defValue[0] = new ShaderStateInfo(SH_READY);
-
     //  Set default state of ShaderReady signal.  
-    readySignal->setData(defValue);
+    readySignal.setInitial(SH_READY);
 
     //  Signal to the Decoder/Execute cmoMduBase.  
     instructionSignal = newOutputSignal("cgoShaderInstr", threadsCycle * instrCycle, 1, shPrefix);
@@ -410,8 +406,6 @@ void cmoShaderFetch::clock(U64 cycle)
     ShaderDecodeState decoderState;
     ConsumerState consumerState;
     ShaderInput *shInput;
-    ShaderDecodeStateInfo *shDecStateInfo;
-    ConsumerStateInfo *consumerStateInfo;
     U32 visited;
     U32 i;
     U32 j;
@@ -466,15 +460,7 @@ numFetchedGroups, numGroups);
         processDecodeCommand(decodeCommand);
 
     //  Receive state from the decode stage.  
-    if (decodeStateSignal->read(cycle, (DynamicObject *&) shDecStateInfo))
-    {
-        //  Store shader decode state.  
-        decoderState = shDecStateInfo->getState();
-
-        //  Delete received decoder state.  
-        delete shDecStateInfo;
-    }
-    else
+    if (!decodeStateSignal.read(cycle, decoderState))
     {
         //  No decoder state?  Where did those electrons went?  
         CG_ASSERT("No decoder state signal.");
@@ -928,19 +914,11 @@ numFetchedGroups, numGroups);
     //  Output Management.  
 
     //  Read consumer state.  This is a permament signal.  
-    if (!consumerSignal->read(cycle, (DynamicObject *&) consumerStateInfo))
+    if (!consumerSignal.read(cycle, consumerState))
     {
         //  No signal?  Electrons on strike!!!  So we go to strike too :).  
         CG_ASSERT("No signal received from Shader consumer.");
     }
-    else
-    {
-        //  Store consumer state.  
-        consumerState = consumerStateInfo->getState();
-
-        //  Delete received consumer state.  
-        delete consumerStateInfo;
-    }
 
 
     //  Check if there is a transmission in progress.  
@@ -1064,7 +1042,7 @@ numFetchedGroups, numGroups);
         shState = SH_READY;
     }
 
-    readySignal->write(cycle, new ShaderStateInfo(shState));
+    readySignal.write(cycle, shState);
 
     //  Update statistics.  
     nThReadyAvg->incavg(numReadyThreads);
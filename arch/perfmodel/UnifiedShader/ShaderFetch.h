@@ -12,6 +12,7 @@
 #include "support.h"
 #include "GPUType.h"
 #include "MduBase.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "ShaderCommon.h"
 #include "bmUnifiedShader.h"
@@ -24,6 +25,11 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class ShaderStateInfo;
+class ShaderDecodeStateInfo;
+class ConsumerStateInfo;
+
 
 /***
  *
@@ -69,12 +75,12 @@ private:
     //  Shader signals.  
     Signal *commProcSignal[2];  //  Command signal from the Command Processor.  
     Signal *commandSignal;      //  Command signal from cmoStreamController.  
-    Signal *readySignal;        //  Ready signal to the cmoStreamController.  
+    StateWire<ShaderStateInfo> readySignal;             //  Ready signal to the cmoStreamController.  
     Signal *instructionSignal;  //  Instruction signal to Decode/Execute  
     Signal *newPCSignal;        //  New PC signal from Decode/Execute.  
-    Signal *decodeStateSignal;  //  Decoder state signal from Decode/Execute.  
+    StateWire<ShaderDecodeStateInfo> decodeStateSignal; //  Decoder state signal from Decode/Execute.  
     Signal *outputSignal;       //  Shader output signal to a consumer.  
-    Signal *consumerSignal;     //  Consumer readyness state to receive Shader output.  
+    StateWire<ConsumerStateInfo> consumerSignal;        //  Consumer readyness state to receive Shader output.  
     Signal *shaderZExport;      //  Z export signal to the ShaderWorkDistributor (MicroPolygon Rasterizer).  
 
     //  Shader State.  
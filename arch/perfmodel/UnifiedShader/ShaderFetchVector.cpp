@@ -45,8 +45,7 @@ cmoShaderFetchVector::cmoShaderFetchVector(bmoUnifiedShader &bmShader, U32 nThre
 {
     U32 i;
     U32 j;
-    DynamicObject *defValue[1];
-    char fullName[64];
+char fullName[64];
     char postfix[32];
 
     CG_INFO("Using Vector Shader (Fetch)");
@@ -152,11 +151,8 @@ cmoShaderFetchVector::cmoShaderFetchVector(bmoUnifiedShader &bmShader, U32 nThre
     //  Signal to the cmoStreamController.  Shader state.
     readySignal = newOutputSignal("ShaderState", 1, 1, shPrefix);
 
-    //  Build initial signal state.
-    defValue[0] = new ShaderStateInfo(SH_READY);
-
     //  Set default state of ShaderReady signal.
-    readySignal->setData(defValue);
+    readySignal.setInitial(SH_READY);
 
     //  Signal to the Decoder/Execute cmoMduBase.
     instructionSignal = newOutputSignal("cgoShaderInstr", instrCycle, 1, shPrefix);
@@ -440,23 +436,14 @@ void cmoShaderFetchVector::updatesFromCommandProcessor(U64 cycle)
 void cmoShaderFetchVector::updatesFromDecodeStage(U64 cycle)
 {
     ShaderDecodeCommand *decodeCommand;
-    ShaderDecodeStateInfo *shDecStateInfo;
 
     //  Receive feedback from decode stage.
     while (newPCSignal->read(cycle, (DynamicObject *&) decodeCommand))
         processDecodeCommand(decodeCommand);
 
     //  Receive state from the decode stage.
-    if (decodeStateSignal->read(cycle, (DynamicObject *&) shDecStateInfo))
-    {
-        //  Store shader decode state.
-        decoderState = shDecStateInfo->getState();
-
-        //  Delete received decoder state.
-        delete shDecStateInfo;
-    }
-    else
-    {
+    if (!decodeStateSignal.read(cycle, decoderState))
+{
         //  No decoder state?  Where did those electrons went?
         CG_ASSERT("No decoder state signal.");
     }
@@ -520,7 +507,7 @@ void cmoShaderFetchVector::sendBackPreassure(U64 cycle)
         shState = SH_READY;
     }
 
-    readySignal->write(cycle, new ShaderStateInfo(shState));
+    readySignal.write(cycle, shState);
 }
 
 //  Fetch stage.  Update fetch stage state and fetch new instructions.
@@ -1512,23 +1499,14 @@ void cmoShaderFetchVector::sendOutput(U64 cycle, U32 threadID, U32 elementID)
 void cmoShaderFetchVector::processOutputs(U64 cycle)
 {
     ConsumerState consumerState;
-    ConsumerStateInfo *consumerStateInfo;
-    ShaderInput *shOutput;
+ShaderInput *shOutput;
 
     //  Read consumer state.  This is a permament signal.
-    if (!consumerSignal->read(cycle, (DynamicObject *&) consumerStateInfo))
+    if (!consumerSignal.read(cycle, consumerState))
     {
         //  No signal?  Electrons on strike!!!  So we go to strike too :).
         CG_ASSERT("No signal received from Shader consumer.");
     }
-    else
-    {
-        //  Store consumer state.
-        consumerState = consumerStateInfo->getState();
-
-        //  Delete received consumer state.
-        delete consumerStateInfo;
-    }
 
     //  Check if there is a transmission in progress.
     if (transInProgress)
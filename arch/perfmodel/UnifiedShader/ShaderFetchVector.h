@@ -13,6 +13,7 @@
 #include "support.h"
 #include "GPUType.h"
 #include "MultiClockMdu.h"
+#include "StateWire.h"
 #include "GPUReg.h"
 #include "toolsQueue.h"
 #include "ShaderCommon.h"
@@ -26,6 +27,11 @@
 namespace arch
 {
 
+//  State objects carried by the state wires.
+class ShaderStateInfo;
+class ShaderDecodeStateInfo;
+class ConsumerStateInfo;
+
 
 /***
  *
@@ -76,12 +82,12 @@ private:
     //  Shader signals.  
     Signal *commProcSignal[2];  //  Command signal from the Command Processor.  
     Signal *commandSignal;      //  Command signal from cmoStreamController.  
-    Signal *readySignal;        //  Ready signal to the cmoStreamController.  
+    StateWire<ShaderStateInfo> readySignal;             //  Ready signal to the cmoStreamController.
     Signal *instructionSignal;  //  Instruction signal to Decode/Execute  
     Signal *newPCSignal;        //  New PC signal from Decode/Execute.  
-    Signal *decodeStateSignal;  //  Decoder state signal from Decode/Execute.  
+    StateWire<ShaderDecodeStateInfo> decodeStateSignal; //  Decoder state signal from Decode/Execute.
     Signal *outputSignal;       //  Shader output signal to a consumer.  
-    Signal *consumerSignal;     //  Consumer readyness state to receive Shader output.  
+    StateWire<ConsumerStateInfo> consumerSignal;        //  Consumer readyness state to receive Shader output.
 
     //  Shader State.
     bool transInProgress;       //  Shader Output transmission in progress.  
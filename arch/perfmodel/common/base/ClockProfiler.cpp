@@ -0,0 +1,187 @@
+/**************************************************************************
+ * Clock Profiler class implementation file.
+ */
+
+#include "ClockProfiler.h"
+#include "support.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <typeinfo>
+
+#ifdef __GNUC__
+    #include <cxxabi.h>
+#endif
+
+using namespace std;
+
+namespace arch
+{
+
+//  Returns the name of the class of a mdu without the namespace.
+static string mduClassName(cmoMduBase *mdu)
+{
+    string name = typeid(*mdu).name();
+
+#ifdef __GNUC__
+    int status;
+    char *demangled = abi::__cxa_demangle(name.c_str(), NULL, NULL, &status);
+    if (demangled != NULL)
+    {
+        name = demangled;
+        free(demangled);
+    }
+#endif
+
+    size_t pos = name.rfind("::");
+    if (pos != string::npos)
+        name = name.substr(pos + 2);
+    else if (name.compare(0, 6, "class ") == 0)
+        name = name.substr(6);
+
+    return name;
+}
+
+static const char *domainName(U32 domain)
+{
+    switch(domain)
+    {
+        case GPU_CLOCK_DOMAIN: return "gpu";
+        case SHADER_CLOCK_DOMAIN: return "shader";
+        case MEMORY_CLOCK_DOMAIN: return "memory";
+        default: return "unknown";
+    }
+}
+
+cmoClockProfiler::cmoClockProfiler(U32 period) : period(period), randomState(0x9e3779b9)
+{
+    CG_ASSERT_COND((period != 0), "Clock profiler sampling period must be at least 1 cycle.");
+
+    for(U32 d = 0; d < MAX_DOMAINS; d++)
+    {
+        domainCycles[d] = 0;
+        countdown[d] = nextInterval();
+    }
+
+    startTicks = readTicks();
+    startTime = chrono::steady_clock::now();
+}
+
+U32 cmoClockProfiler::addMdu(cmoMduBase *mdu, U32 domain)
+{
+    CG_ASSERT_COND((domain < MAX_DOMAINS), "Undefined clock domain %d.", domain);
+
+    MduSamples s;
+    s.mdu = mdu;
+    s.className = mduClassName(mdu);
+    s.domain = domain;
+    s.samples = 0;
+    s.ticks = 0;
+    s.idle = 0;
+    mdus.push_back(s);
+
+    return U32(mdus.size() - 1);
+}
+
+//  Random interval between sampled cycles, uniform in [1, 2 * period - 1].
+U32 cmoClockProfiler::nextInterval()
+{
+    if (period == 1)
+        return 1;
+
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return 1 + randomState % (2 * period - 1);
+}
+
+void cmoClockProfiler::writeReport(const char *fileName)
+{
+    //  Calibrate the cycle counter with the host time since the profiler was created.
+    F64 hostNs = F64(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count());
+    U64 ticks = readTicks() - startTicks;
+    F64 nsPerTick = (ticks != 0) ? hostNs / F64(ticks) : 1.0;
+
+    //  Simulated cycles are reported in the GPU clock domain.
+    F64 cycles = F64(std::max<U64>(domainCycles[GPU_CLOCK_DOMAIN], 1));
+
+    //  Host ns per simulated cycle estimated for each mdu clock call from its samples.
+    vector<F64> mduNs(mdus.size(), 0.0);
+    F64 totalNs = 0.0;
+
+    struct ClassSamples
+    {
+        F64 ns;
+        U64 samples;
+        U64 idle;
+        U32 instances;
+    };
+
+    map<string, ClassSamples> classes;
+
+    for(size_t m = 0; m < mdus.size(); m++)
+    {
+        const MduSamples &s = mdus[m];
+
+        if (s.samples != 0)
+            mduNs[m] = F64(s.ticks) * nsPerTick / F64(s.samples) * F64(domainCycles[s.domain]) / cycles;
+
+        totalNs += mduNs[m];
+
+        ClassSamples &c = classes[s.className];
+        c.ns += mduNs[m];
+        c.samples += s.samples;
+        c.idle += s.idle;
+        c.instances++;
+    }
+
+    vector<pair<F64, string> > classOrder;
+    for(map<string, ClassSamples>::iterator it = classes.begin(); it != classes.end(); it++)
+        classOrder.push_back(make_pair(it->second.ns, it->first));
+    sort(classOrder.rbegin(), classOrder.rend());
+
+    vector<pair<F64, size_t> > mduOrder;
+    for(size_t m = 0; m < mdus.size(); m++)
+        mduOrder.push_back(make_pair(mduNs[m], m));
+    sort(mduOrder.rbegin(), mduOrder.rend());
+
+    FILE *f = fopen(fileName, "w");
+    CG_ASSERT_COND((f != NULL), "Error opening host profile file %s.", fileName);
+
+    fprintf(f, "Level,Name,Class,Domain,Instances,Samples,HostNsPerCycle,Share,IdleFraction\n");
+
+    for(size_t i = 0; i < classOrder.size(); i++)
+    {
+        const ClassSamples &c = classes[classOrder[i].second];
+        fprintf(f, "class,%s,%s,,%u,%llu,%.3f,%.4f,%.4f\n", classOrder[i].second.c_str(), classOrder[i].second.c_str(),
+                c.instances, (unsigned long long) c.samples, c.ns, (totalNs > 0.0) ? c.ns / totalNs : 0.0,
+                (c.samples != 0) ? F64(c.idle) / F64(c.samples) : 0.0);
+    }
+
+    for(size_t i = 0; i < mduOrder.size(); i++)
+    {
+        const MduSamples &s = mdus[mduOrder[i].second];
+        fprintf(f, "mdu,%s,%s,%s,1,%llu,%.3f,%.4f,%.4f\n", s.mdu->getName(), s.className.c_str(), domainName(s.domain),
+                (unsigned long long) s.samples, mduOrder[i].first, (totalNs > 0.0) ? mduOrder[i].first / totalNs : 0.0,
+                (s.samples != 0) ? F64(s.idle) / F64(s.samples) : 0.0);
+    }
+
+    fclose(f);
+
+    //  Summary.
+    printf("Host profile : %.1f ns per cycle in mdu clocks (%.1f%% of the host time), written to %s\n",
+           totalNs, (hostNs > 0.0) ? 100.0 * totalNs * cycles / hostNs : 0.0, fileName);
+
+    for(size_t i = 0; (i < classOrder.size()) && (i < 5); i++)
+    {
+        const ClassSamples &c = classes[classOrder[i].second];
+        printf("  %-24s %10.1f ns/cycle %5.1f%%  idle %5.1f%%\n", classOrder[i].second.c_str(), c.ns,
+               (totalNs > 0.0) ? 100.0 * c.ns / totalNs : 0.0,
+               (c.samples != 0) ? 100.0 * F64(c.idle) / F64(c.samples) : 0.0);
+    }
+}
+
+} // namespace arch
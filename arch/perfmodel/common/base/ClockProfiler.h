@@ -0,0 +1,156 @@
+/**************************************************************************
+ *
+ * Clock Profiler class definition file.
+ *
+ */
+
+#ifndef __CLOCKPROFILER__
+#define __CLOCKPROFILER__
+
+#include "GPUType.h"
+#include "GPUReg.h"
+#include "MduBase.h"
+#include "MultiClockMdu.h"
+#include "GPUSignal.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+namespace arch
+{
+
+/**
+ *  Samples the host time spent in the clock calls of the simulated mdus.
+ *
+ *  The simulation loop asks sample() once per cycle of each clock domain.  In the
+ *  sampled cycles (one every period cycles on average, with a random interval to
+ *  avoid aliasing with periodic mdu behaviour) the clock call of each mdu of the
+ *  domain is timed with the CPU cycle counter.  The samples are aggregated per mdu
+ *  instance and clock domain and per mdu class and written as a CSV file with the
+ *  host ns per simulated cycle, the share of the sampled time and the fraction of
+ *  sampled clock calls that did not read or write any signal (idle clocks).
+ */
+class cmoClockProfiler
+{
+public:
+
+    static const U32 DEFAULT_PERIOD = 64;       //  Default sampling period in cycles.
+    static const U32 MAX_DOMAINS = 8;           //  Clock domain identifiers (see cmoClockScheduler).
+
+    /**
+     *  Clock profiler constructor.
+     *  @param period Average number of cycles between sampled cycles.
+     */
+    cmoClockProfiler(U32 period = DEFAULT_PERIOD);
+
+    /**
+     *  Registers a mdu clock call.
+     *  @param mdu Pointer to the mdu.
+     *  @param domain Clock domain of the clock call.
+     *  @return The identifier of the clock call passed to clock().
+     */
+    U32 addMdu(cmoMduBase *mdu, U32 domain);
+
+    /**
+     *  Called once per cycle of a clock domain.  Returns if the clock calls of the cycle
+     *  must be timed.
+     */
+    bool sample(U32 domain)
+    {
+        domainCycles[domain]++;
+
+        if (--countdown[domain] != 0)
+            return false;
+
+        countdown[domain] = nextInterval();
+        return true;
+    }
+
+    /**
+     *  Clocks a mdu and records the sample.
+     *  @param id Identifier returned by addMdu().
+     *  @param mdu Pointer to the mdu.
+     *  @param cycle Cycle passed to the clock call.
+     */
+    void clock(U32 id, cmoMduBase *mdu, U64 cycle)
+    {
+        U64 startTransfers = Signal::transfers;
+        U64 startTicks = readTicks();
+        mdu->clock(cycle);
+        record(id, readTicks() - startTicks, startTransfers);
+    }
+
+    /**
+     *  Clocks one domain of a multi clock mdu and records the sample.
+     *  @param id Identifier returned by addMdu().
+     *  @param mdu Pointer to the mdu.
+     *  @param domain Clock domain to update.
+     *  @param cycle Cycle passed to the clock call.
+     */
+    void clock(U32 id, cmoMduMultiClk *mdu, U32 domain, U64 cycle)
+    {
+        U64 startTransfers = Signal::transfers;
+        U64 startTicks = readTicks();
+        mdu->clock(domain, cycle);
+        record(id, readTicks() - startTicks, startTransfers);
+    }
+
+    /**
+     *  Writes the report.
+     *  @param fileName Name of the CSV file.
+     */
+    void writeReport(const char *fileName);
+
+private:
+
+    //  Samples of a mdu clock call.
+    struct MduSamples
+    {
+        cmoMduBase *mdu;
+        std::string className;
+        U32 domain;
+        U64 samples;        //  Sampled clock calls.
+        U64 ticks;          //  Cycle counter ticks spent in the sampled clock calls.
+        U64 idle;           //  Sampled clock calls that did not read or write a signal.
+    };
+
+    std::vector<MduSamples> mdus;
+    U32 period;
+    U32 countdown[MAX_DOMAINS];         //  Cycles to the next sampled cycle per domain.
+    U64 domainCycles[MAX_DOMAINS];      //  Cycles simulated per domain.
+    U32 randomState;
+
+    U64 startTicks;                                     //  Cycle counter at construction.
+    std::chrono::steady_clock::time_point startTime;    //  Host time at construction.
+
+    static U64 readTicks()
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return U64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    void record(U32 id, U64 ticks, U64 startTransfers)
+    {
+        MduSamples &s = mdus[id];
+        s.samples++;
+        s.ticks += ticks;
+        s.idle += (Signal::transfers == startTransfers) ? 1 : 0;
+    }
+
+    U32 nextInterval();
+};
+
+} // namespace arch
+
+#endif
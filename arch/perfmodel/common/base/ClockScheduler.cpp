@@ -0,0 +1,269 @@
+/**************************************************************************
+ * Clock Scheduler class implementation file.
+ */
+
+#include "ClockScheduler.h"
+#include "ClockProfiler.h"
+#include "GPUSignal.h"
+#include "support.h"
+
+using namespace std;
+
+namespace arch
+{
+
+cmoClockScheduler::cmoClockScheduler() :
+    profiler(NULL), bucketWidth(1), currentBucket(0), bucketTop(1)
+{
+}
+
+U32 cmoClockScheduler::addDomain(const char *name, U32 clockDomain, U32 period)
+{
+    CG_ASSERT_COND((domains.size() < MAX_DOMAINS), "Too many clock domains.");
+    CG_ASSERT_COND((clockDomain < MAX_DOMAINS), "Undefined clock domain %d.", clockDomain);
+    CG_ASSERT_COND((period != 0), "Clock domain %s period must be at least 1 ps.", name);
+    CG_ASSERT_COND((findDomain(clockDomain) == domains.size()), "Clock domain %d already defined.", clockDomain);
+
+    Domain d;
+    d.name = name;
+    d.clockDomain = clockDomain;
+    d.period = period;
+    d.cycle = 0;
+    domains.push_back(d);
+
+    return U32(domains.size() - 1);
+}
+
+void cmoClockScheduler::addMdu(U32 domain, cmoMduBase *mdu)
+{
+    CG_ASSERT_COND((domain < domains.size()), "Undefined clock domain %d.", domain);
+
+    ClockCall call;
+    call.mdu = mdu;
+    call.multiClockMdu = NULL;
+    call.profileId = 0;
+    domains[domain].calls.push_back(call);
+
+    StallMdu s;
+    s.mdu = mdu;
+    s.domain = domain;
+    stallMdus.push_back(s);
+}
+
+void cmoClockScheduler::addMdu(U32 domain, cmoMduMultiClk *mdu)
+{
+    CG_ASSERT_COND((domain < domains.size()), "Undefined clock domain %d.", domain);
+
+    ClockCall call;
+    call.mdu = mdu;
+    call.multiClockMdu = mdu;
+    call.profileId = 0;
+    domains[domain].calls.push_back(call);
+
+    //  The mdu is checked for stalls in the last domain it was added to.
+    for(size_t s = 0; s < stallMdus.size(); s++)
+    {
+        if (stallMdus[s].mdu == mdu)
+        {
+            stallMdus[s].domain = domain;
+            return;
+        }
+    }
+
+    StallMdu s;
+    s.mdu = mdu;
+    s.domain = domain;
+    stallMdus.push_back(s);
+}
+
+void cmoClockScheduler::setProfiler(cmoClockProfiler *profiler_)
+{
+    profiler = profiler_;
+
+    if (profiler == NULL)
+        return;
+
+    for(size_t d = 0; d < domains.size(); d++)
+        for(size_t c = 0; c < domains[d].calls.size(); c++)
+            domains[d].calls[c].profileId = profiler->addMdu(domains[d].calls[c].mdu, domains[d].clockDomain);
+}
+
+U32 cmoClockScheduler::findDomain(U32 clockDomain) const
+{
+    for(U32 d = 0; d < domains.size(); d++)
+        if (domains[d].clockDomain == clockDomain)
+            return d;
+
+    return U32(domains.size());
+}
+
+void cmoClockScheduler::reset()
+{
+    CG_ASSERT_COND(!domains.empty(), "No clock domains defined.");
+
+    //  Buckets as wide as the mean interval between ticks, one bucket per domain at least.
+    F64 rate = 0.0;
+    for(size_t d = 0; d < domains.size(); d++)
+        rate += 1.0 / F64(domains[d].period);
+
+    bucketWidth = U64(1.0 / rate);
+    if (bucketWidth == 0)
+        bucketWidth = 1;
+
+    U32 numBuckets = 2;
+    while(numBuckets < domains.size())
+        numBuckets *= 2;
+
+    buckets.assign(numBuckets, vector<Tick>());
+    currentBucket = 0;
+    bucketTop = bucketWidth;
+
+    for(U32 d = 0; d < domains.size(); d++)
+    {
+        domains[d].cycle = 0;
+
+        Tick tick;
+        tick.time = domains[d].period;
+        tick.domain = d;
+        insert(tick);
+    }
+}
+
+void cmoClockScheduler::insert(const Tick &tick)
+{
+    vector<Tick> &bucket = buckets[(tick.time / bucketWidth) & (buckets.size() - 1)];
+
+    //  The earliest tick is at the back of the bucket.
+    vector<Tick>::iterator it = bucket.begin();
+    while((it != bucket.end()) && before(tick, *it))
+        it++;
+
+    bucket.insert(it, tick);
+}
+
+U32 cmoClockScheduler::next()
+{
+    CG_ASSERT_COND(!buckets.empty(), "Clock scheduler not initialized.");
+
+    while(true)
+    {
+        //  Search the buckets of the current year starting from the current bucket.
+        for(U32 n = 0; n < buckets.size(); n++)
+        {
+            vector<Tick> &bucket = buckets[currentBucket];
+
+            if (!bucket.empty() && (bucket.back().time < bucketTop))
+            {
+                Tick tick = bucket.back();
+                bucket.pop_back();
+
+                //  Schedule the following tick of the domain.
+                Tick following;
+                following.time = tick.time + domains[tick.domain].period;
+                following.domain = tick.domain;
+                insert(following);
+
+                return tick.domain;
+            }
+
+            currentBucket = (currentBucket + 1) & U32(buckets.size() - 1);
+            bucketTop += bucketWidth;
+        }
+
+        //  No tick in a year, jump to the year of the earliest tick.
+        const Tick *earliest = NULL;
+        for(size_t b = 0; b < buckets.size(); b++)
+            if (!buckets[b].empty() && ((earliest == NULL) || before(buckets[b].back(), *earliest)))
+                earliest = &buckets[b].back();
+
+        currentBucket = U32((earliest->time / bucketWidth) & (buckets.size() - 1));
+        bucketTop = (earliest->time / bucketWidth + 1) * bucketWidth;
+    }
+}
+
+U64 cmoClockScheduler::peekTime() const
+{
+    CG_ASSERT_COND(!buckets.empty(), "Clock scheduler not initialized.");
+
+    //  Every domain has a pending tick.
+    U64 time = 0;
+    bool found = false;
+    for(size_t b = 0; b < buckets.size(); b++)
+    {
+        if (!buckets[b].empty() && (!found || (buckets[b].back().time < time)))
+        {
+            time = buckets[b].back().time;
+            found = true;
+        }
+    }
+
+    return time;
+}
+
+void cmoClockScheduler::clock(U32 domain)
+{
+    Domain &d = domains[domain];
+
+    //  The signals written by the clock calls belong to the domain (signal trace).
+    Signal::writeDomain = d.clockDomain;
+
+    if ((profiler != NULL) && profiler->sample(d.clockDomain))
+    {
+        for(size_t c = 0; c < d.calls.size(); c++)
+        {
+            if (d.calls[c].multiClockMdu != NULL)
+                profiler->clock(d.calls[c].profileId, d.calls[c].multiClockMdu, d.clockDomain, d.cycle);
+            else
+                profiler->clock(d.calls[c].profileId, d.calls[c].mdu, d.cycle);
+        }
+    }
+    else
+    {
+        for(size_t c = 0; c < d.calls.size(); c++)
+        {
+            if (d.calls[c].multiClockMdu != NULL)
+                d.calls[c].multiClockMdu->clock(d.clockDomain, d.cycle);
+            else
+                d.calls[c].mdu->clock(d.cycle);
+        }
+    }
+
+    d.cycle++;
+}
+
+bool cmoClockScheduler::detectStall()
+{
+    for(size_t s = 0; s < stallMdus.size(); s++)
+    {
+        bool stallDetectionEnabled;
+        bool mduStalled;
+
+        stallMdus[s].mdu->detectStall(lastCycle(stallMdus[s].domain), stallDetectionEnabled, mduStalled);
+
+        if (stallDetectionEnabled && mduStalled)
+        {
+            CG_INFO("Stall detected on mdu %s at cycle %lld (%s clock domain)", stallMdus[s].mdu->getName(),
+                    lastCycle(stallMdus[s].domain), domains[stallMdus[s].domain].name.c_str());
+            return true;
+        }
+    }
+
+    return false;
+}
+
+string cmoClockScheduler::stallReport()
+{
+    string report;
+
+    for(size_t s = 0; s < stallMdus.size(); s++)
+    {
+        string mduReport;
+        stallMdus[s].mdu->stallReport(lastCycle(stallMdus[s].domain), mduReport);
+        report += mduReport;
+        report += "\n";
+    }
+
+    return report;
+}
+
+} // namespace arch
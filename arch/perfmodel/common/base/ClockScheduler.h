@@ -0,0 +1,179 @@
+/**************************************************************************
+ *
+ * Clock Scheduler class definition file.
+ *
+ */
+
+#ifndef __CLOCKSCHEDULER__
+#define __CLOCKSCHEDULER__
+
+#include "GPUType.h"
+#include "MduBase.h"
+#include "MultiClockMdu.h"
+
+#include <string>
+#include <vector>
+
+namespace arch
+{
+
+class cmoClockProfiler;
+
+/**
+ *  Orders the clock ticks of the simulated clock domains.
+ *
+ *  Each clock domain has a period in picoseconds and a list of clock calls: single clock
+ *  mdus are clocked with clock(cycle) and multi clock mdus with clock(domain, cycle) using
+ *  the clock domain identifier of the domain.  The tick k (k >= 1) of a domain happens at
+ *  time k * period and the ticks at the same time are issued in the order in which the
+ *  domains were added.  The pending tick of each domain is stored in a calendar queue
+ *  with buckets as wide as the mean interval between ticks.
+ *
+ *  A single clock architecture is a single domain with a period of 1.
+ */
+class cmoClockScheduler
+{
+public:
+
+    static const U32 MAX_DOMAINS = 8;
+
+    cmoClockScheduler();
+
+    /**
+     *  Adds a clock domain.
+     *  @param name Name of the clock domain.
+     *  @param clockDomain Clock domain identifier passed to the multi clock mdus.
+     *  @param period Clock period in picoseconds.
+     *  @return The index of the domain.  The first domain added is the main domain.
+     */
+    U32 addDomain(const char *name, U32 clockDomain, U32 period);
+
+    /**
+     *  Adds a single clock mdu to a domain.
+     *  @param domain Index of the domain.
+     *  @param mdu Pointer to the mdu.
+     */
+    void addMdu(U32 domain, cmoMduBase *mdu);
+
+    /**
+     *  Adds a multi clock mdu to a domain.  A multi clock mdu is added to all the domains
+     *  it implements and is checked for stalls in the last domain it was added to.
+     *  @param domain Index of the domain.
+     *  @param mdu Pointer to the mdu.
+     */
+    void addMdu(U32 domain, cmoMduMultiClk *mdu);
+
+    /**
+     *  Registers the clock calls with a host profiler.
+     *  @param profiler Pointer to the profiler, NULL to disable profiling.
+     */
+    void setProfiler(cmoClockProfiler *profiler);
+
+    /**
+     *  Sets the cycle of all the domains to 0 and the time to 0.
+     */
+    void reset();
+
+    /**
+     *  Returns the domain of the next clock tick and schedules the following tick
+     *  of the domain.
+     */
+    U32 next();
+
+    /**
+     *  Returns the time of the next clock tick in picoseconds.
+     */
+    U64 peekTime() const;
+
+    /**
+     *  Issues the clock calls of a domain and updates the cycle of the domain.
+     *  @param domain Index of the domain.
+     */
+    void clock(U32 domain);
+
+    /**
+     *  Checks all the mdus for stalls.
+     *  @return If a stall was detected.
+     */
+    bool detectStall();
+
+    /**
+     *  Returns the stall report of all the mdus.
+     */
+    std::string stallReport();
+
+    U32 getNumDomains() const { return U32(domains.size()); }
+    const char *getName(U32 domain) const { return domains[domain].name.c_str(); }
+    U32 getClockDomain(U32 domain) const { return domains[domain].clockDomain; }
+    U32 getPeriod(U32 domain) const { return domains[domain].period; }
+
+    /**
+     *  Returns the number of cycles simulated in a domain.
+     */
+    U64 getCycle(U32 domain) const { return domains[domain].cycle; }
+
+    /**
+     *  Returns the time of the last clock tick of a domain in picoseconds.
+     */
+    U64 getTime(U32 domain) const { return domains[domain].cycle * domains[domain].period; }
+
+    /**
+     *  Returns the index of the domain with a clock domain identifier, getNumDomains()
+     *  if not found.
+     */
+    U32 findDomain(U32 clockDomain) const;
+
+private:
+
+    //  Clock call of a mdu.
+    struct ClockCall
+    {
+        cmoMduBase *mdu;
+        cmoMduMultiClk *multiClockMdu;      //  NULL for single clock mdus.
+        U32 profileId;                      //  Identifier in the host profiler.
+    };
+
+    struct Domain
+    {
+        std::string name;
+        U32 clockDomain;
+        U32 period;                         //  Picoseconds.
+        U64 cycle;                          //  Cycles simulated.
+        std::vector<ClockCall> calls;
+    };
+
+    //  Pending clock tick.
+    struct Tick
+    {
+        U64 time;                           //  Picoseconds.
+        U32 domain;
+    };
+
+    //  Mdu checked for stalls.
+    struct StallMdu
+    {
+        cmoMduBase *mdu;
+        U32 domain;
+    };
+
+    std::vector<Domain> domains;
+    std::vector<StallMdu> stallMdus;
+    cmoClockProfiler *profiler;
+
+    std::vector<std::vector<Tick> > buckets;    //  Calendar queue.  Ticks in a bucket sorted by decreasing time and domain.
+    U64 bucketWidth;                            //  Picoseconds.
+    U32 currentBucket;
+    U64 bucketTop;                              //  End time of the current bucket in the current year.
+
+    static bool before(const Tick &a, const Tick &b)
+    {
+        return (a.time < b.time) || ((a.time == b.time) && (a.domain < b.domain));
+    }
+
+    void insert(const Tick &tick);
+    U64 lastCycle(U32 domain) const { return (domains[domain].cycle > 0) ? domains[domain].cycle - 1 : 0; }
+};
+
+} // namespace arch
+
+#endif
@@ -16,7 +16,9 @@ using namespace std;
 Signal::Signal( const char* signalName, U32 bandwidth, U32 latency ) :
 maxLatency(latency), bandwidth(bandwidth), //capacity(maxLatency+1),
 nWrites(0), readsDone(0), lastRead(0), lastWrite(0), lastCycle(0), in(0),
-nextRead(0), nextWrite(maxLatency), pendentReads(0)
+nextRead(0), nextWrite(maxLatency), pendentReads(0),
+stateWire(false), stateValues(0), stateCycles(0), stateFirst(0), stateCount(0),
+clockDomain(0)
 {
     // Data structure creation and initialization
     name = new char[strlen(signalName)+1];
@@ -40,6 +42,13 @@ bool Signal::setData( DynamicObject* initialData[], U64 firstCycleForReadOrWrite
     if ( bandwidth <= 0 || maxLatency <= 0 )
         CG_ASSERT("Error. Signal is not well defined yet. It Cannot be initializated");
 
+    //  A state wire only keeps the first object as the initial state.
+    if ( stateWire )
+    {
+        setInitialState(initialData[0], firstCycleForReadOrWrite);
+        return true;
+    }
+
     U32 i = 0; // for indexing initialData array
     // note: Using global in
     in = static_cast<U32>(GPU_MOD( firstCycleForReadOrWrite, capacity )); // mapping of 'i' in signal contents
@@ -507,31 +516,168 @@ bool Signal::checkReadsMissed( U64 cycle, U32 oldIn, U32 newIn )
 }
 
 
+U64 Signal::transfers = 0;
+U32 Signal::writeDomain = 0;
+
 bool Signal::write( U64 cycle, DynamicObject* dataW )
 {
+    transfers++;
+    clockDomain = writeDomain;
+
+    if ( stateWire )
+        return writeState( cycle, dataW, maxLatency );
+
     return writeGenFast( cycle, dataW );
 }
 
 bool Signal::write( U64 cycle, DynamicObject* dataW, U32 lat )
 {
+    transfers++;
+    clockDomain = writeDomain;
+
+    if ( stateWire )
+        return writeState( cycle, dataW, lat );
+
     return writeGenFast( cycle, dataW, lat );
 }
 
 bool Signal::read( U64 cycle, DynamicObject *&dataR )
 {
-    return readGenFast( cycle, dataR );
+    //  Reading the state of a state wire is not a transfer.
+    if ( stateWire )
+        return readState( cycle, dataR );
+
+    bool done = readGenFast( cycle, dataR );
+
+    transfers += done ? 1 : 0;
+
+    return done;
+}
+
+void Signal::setStateWire()
+{
+    if ( !stateWire && pendentReads != 0 )
+    {
+        char buffer[200];
+        sprintf(buffer, "Error.  Signal \"%s\" can not become a state wire after being written.", name);
+        CG_ASSERT(buffer);
+    }
+
+    stateWire = true;
+}
+
+bool Signal::isStateWire() const
+{
+    return stateWire;
+}
+
+void Signal::setInitialState( DynamicObject* initialState, U64 firstCycleForRead )
+{
+    if ( !isSignalDefined() )
+        CG_ASSERT("Error. Signal is not well defined yet. It Cannot be initializated");
+
+    if ( stateCount != 0 )
+    {
+        char buffer[200];
+        sprintf(buffer, "Error.  Initial state set after the first write in state wire \"%s\".", name);
+        CG_ASSERT(buffer);
+    }
+
+    if ( stateValues == 0 )
+    {
+        stateValues = new DynamicObject*[capacity];
+        stateCycles = new U64[capacity];
+    }
+
+    stateFirst = 0;
+    stateCount = 1;
+    stateValues[0] = initialState;
+    stateCycles[0] = firstCycleForRead;
+}
+
+U32 Signal::findState( U64 cycle ) const
+{
+    //  Search the newest state change already visible.
+    for ( U32 i = stateCount; i > 0; i-- )
+    {
+        U32 pos = (stateFirst + i - 1) & capacityMask;
+        if ( stateCycles[pos] <= cycle )
+            return pos;
+    }
+
+    return capacity;
+}
+
+bool Signal::writeState( U64 cycle, DynamicObject* dataW, U32 latency )
+{
+    char buffer[200];
+
+    if ( latency > maxLatency || latency == 0 )
+    {
+        sprintf(buffer, "Error.  Inconsistent latency value. Signal %s, latency %d.", name, latency);
+        CG_ASSERT(buffer);
+    }
+
+    if ( stateValues == 0 )
+    {
+        stateValues = new DynamicObject*[capacity];
+        stateCycles = new U64[capacity];
+    }
+
+    /*  Delete the state changes superseded by a newer change already visible.  Reads
+        are never done in a cycle older than the current write cycle.  */
+    while ( stateCount > 1 && stateCycles[(stateFirst + 1) & capacityMask] <= cycle )
+    {
+        delete stateValues[stateFirst];
+        stateFirst = (stateFirst + 1) & capacityMask;
+        stateCount--;
+    }
+
+    U64 visibleCycle = cycle + latency;
+
+    if ( stateCount != 0 && stateCycles[(stateFirst + stateCount - 1) & capacityMask] >= visibleCycle )
+    {
+        sprintf(buffer, "Error.  State wire \"%s\" written twice for cycle %lld.", name, visibleCycle);
+        CG_ASSERT(buffer);
+    }
+
+    //  At most one visible change and one change per cycle of latency are stored.
+    CG_ASSERT_COND(stateCount < capacity, "State wire storage overflow.");
+
+    U32 pos = (stateFirst + stateCount) & capacityMask;
+    stateValues[pos] = dataW;
+    stateCycles[pos] = visibleCycle;
+    stateCount++;
+
+    return true;
+}
+
+bool Signal::readState( U64 cycle, DynamicObject *&dataR )
+{
+    U32 pos = findState(cycle);
+
+    if ( pos == capacity )
+        return false;
+
+    dataR = stateValues[pos];
+
+    return true;
 }
 
 //  Dumps the signal trace for this cycle and signal.  
 void Signal::traceSignal(ostream *ProfilingFile, U64 cycle)
 {
     U32 sigPos;
-    DynamicObject *dynObj;
-    U32 numCookies;
-    U32 *cookies;
-    U08 *info;
-    U32 i, j;
-    char buffer[256];
+    U32 i;
+
+    //  A state wire shows the state visible in the cycle.
+    if (stateWire)
+    {
+        sigPos = findState(cycle);
+        if (sigPos != capacity)
+            traceObject(ProfilingFile, stateValues[sigPos]);
+        return;
+    }
 
     /*  Calculate position in the signal storage array for
         the cycle to dump.  */
@@ -542,58 +688,67 @@ void Signal::traceSignal(ostream *ProfilingFile, U64 cycle)
     //  Read all dynamic objects stored in the signal for the cycle.  
     for(i = 0; i < nReads[sigPos]; i++)
     {
-        //  Get a dynamic object stored in the signal storage.  
-        dynObj = (DynamicObject *) data[sigPos][i];
+        //  Dump a dynamic object stored in the signal storage.  
+        traceObject(ProfilingFile, (DynamicObject *) data[sigPos][i]);
+    }
+}
 
-        //  Write a tab, just for readibility.  
-        //fprintf(ProfilingFile, "\t");
-        (*ProfilingFile) << "\t";
+void Signal::traceObject(ostream *ProfilingFile, DynamicObject *dynObj)
+{
+    U32 numCookies;
+    U32 *cookies;
+    U08 *info;
+    U32 j;
+    char buffer[256];
 
-        //  Get the dynamic object cookie list.  
-        cookies = dynObj->getCookies(numCookies);
+    //  Write a tab, just for readibility.  
+    //fprintf(ProfilingFile, "\t");
+    (*ProfilingFile) << "\t";
 
-        //  Dump cookie list.  
-        for (j = 0; j < (numCookies - 1); j++)
-        {
-            //fprintf(ProfilingFile, "%d:", cookies[j]);
-            sprintf(buffer, "%d:", cookies[j]);
-            (*ProfilingFile) << buffer;
-        }
+    //  Get the dynamic object cookie list.  
+    cookies = dynObj->getCookies(numCookies);
 
-        //  Dump the last cookie without the ':' separator.  
-        //fprintf(ProfilingFile, "%d", cookies[j]);
-        sprintf(buffer, "%d", cookies[j]);
+    //  Dump cookie list.  
+    for (j = 0; j < (numCookies - 1); j++)
+    {
+        //fprintf(ProfilingFile, "%d:", cookies[j]);
+        sprintf(buffer, "%d:", cookies[j]);
         (*ProfilingFile) << buffer;
+    }
+
+    //  Dump the last cookie without the ':' separator.  
+    //fprintf(ProfilingFile, "%d", cookies[j]);
+    sprintf(buffer, "%d", cookies[j]);
+    (*ProfilingFile) << buffer;
 
+    //  Write field separator.  
+    //fprintf(ProfilingFile, ";");
+    (*ProfilingFile) << ";";
+
+    //  Dump the dynamic object color.  
+    //fprintf(ProfilingFile, "%d", (U32) dynObj->getColor());
+    sprintf(buffer, "%d", (U32) dynObj->getColor());
+    (*ProfilingFile) << buffer;
+
+    //  Get object info field.  
+    info = dynObj->getInfo();
+
+    //  Check if the info field is empty (zero string).  
+    if (info[0] != 0)
+    {
         //  Write field separator.  
         //fprintf(ProfilingFile, ";");
         (*ProfilingFile) << ";";
 
-        //  Dump the dynamic object color.  
-        //fprintf(ProfilingFile, "%d", (U32) dynObj->getColor());
-        sprintf(buffer, "%d", (U32) dynObj->getColor());
-        (*ProfilingFile) << buffer;
-    
-        //  Get object info field.  
-        info = dynObj->getInfo();
-
-        //  Check if the info field is empty (zero string).  
-        if (info[0] != 0)
-        {
-            //  Write field separator.  
-            //fprintf(ProfilingFile, ";");
-            (*ProfilingFile) << ";";
-
-            /*  Dump the info field.
-                !!!WE HOPE IT IS JUST A NORMAL CHARACTER STRING!!!! */
-            //fprintf(ProfilingFile, "\"%s\"", info);
-            (*ProfilingFile) << "\"" << info << "\"";
-        }
-
-        //  Use a newline for the next object in the signal.  
-        //fprintf(ProfilingFile, "\n");
-        (*ProfilingFile) << endl;
+        /*  Dump the info field.
+            !!!WE HOPE IT IS JUST A NORMAL CHARACTER STRING!!!! */
+        //fprintf(ProfilingFile, "\"%s\"", info);
+        (*ProfilingFile) << "\"" << info << "\"";
     }
+
+    //  Use a newline for the next object in the signal.  
+    //fprintf(ProfilingFile, "\n");
+    (*ProfilingFile) << endl;
 }
 
 // inline
@@ -689,8 +844,6 @@ void Signal::destroy()
 {
     U32 i;
 
-    delete[] name;
-
     /*for ( i = 0; i < maxLatency; i++ )
         delete[] data[i];
 
@@ -702,6 +855,16 @@ void Signal::destroy()
     }
     delete[] data;
     delete[] nReads;
+
+    //  Delete the state changes stored in a state wire.
+    for ( i = 0; i < stateCount; i++ )
+        delete stateValues[(stateFirst + i) & capacityMask];
+    delete[] stateValues;
+    delete[] stateCycles;
+    stateValues = 0;
+    stateCycles = 0;
+    stateFirst = 0;
+    stateCount = 0;
 }
 
 
@@ -71,6 +71,14 @@ private:
     U32     nextWrite;
     U32     pendentReads;
 
+    bool    stateWire;      // The signal holds the last state written ( see setStateWire )
+    DynamicObject** stateValues;  // State changes not yet superseded ( circular, capacity entries )
+    U64*    stateCycles;    // First cycle in which each state change can be read
+    U32     stateFirst;     // Oldest state change stored
+    U32     stateCount;     // Number of state changes stored
+
+    U32     clockDomain;    // Clock domain of the last write ( signal trace )
+
     /**
      * Position in the matrix where we are going to write or read.
      *
@@ -101,6 +109,22 @@ private:
      */
     void create();
 
+    /**
+     * Returns the position of the state change visible in a cycle, capacity if there is none
+     */
+    U32 findState( U64 cycle ) const;
+
+    /**
+     * State wire versions of write and read
+     */
+    bool writeState( U64 cycle, DynamicObject* dataW, U32 latency );
+    bool readState( U64 cycle, DynamicObject* &dataR );
+
+    /**
+     * Dumps a dynamic object to the signal trace file
+     */
+    void traceObject( std::ostream *ProfilingFile, DynamicObject *dynObj );
+
     /**
      * Called by destructor and setParameters for release dynamic memory
      *
@@ -175,6 +199,19 @@ private:
 
 public:
 
+    /**
+     * Number of writes and successful reads (except state wire reads) done in all the
+     * signals.  Used to detect the clock calls of a mdu that did not read or write any
+     * signal (cmoClockProfiler).
+     */
+    static U64 transfers;
+
+    /**
+     * Clock domain being clocked.  Set by the clock scheduler before the clock calls of a
+     * domain, the writes store it in the signal so the signal trace of a domain only dumps
+     * the signals written in that domain (cmoSignalBinder::dumpSignalTrace).
+     */
+    static U32 writeDomain;
 
     /**
      * Creates a new Signal
@@ -233,6 +270,36 @@ public:
      */
     bool setData( DynamicObject* initialData[], U64 firstCycleForReadOrWrite = 0 );
 
+    /**
+     * Turns the signal into a state wire
+     *
+     * A state wire keeps the last object written and returns it in every read from the cycle
+     * it becomes visible ( write cycle + latency ) until a newer object becomes visible.  Reads
+     * do not consume the object and there is no data loss check, so the writer only has to
+     * write when the state changes and the reader can read in any cycle.  The signal owns the
+     * objects written and deletes them when superseded ( readers must NOT delete them ).
+     *
+     * The trace of a state wire shows the visible object in every cycle.
+     *
+     * @note Both ends of the signal can call this method ( must be called before any read or write )
+     *
+     * @see StateWire
+     */
+    void setStateWire();
+
+    /**
+     * Tests if the signal is a state wire
+     */
+    bool isStateWire() const;
+
+    /**
+     * Sets the state visible in a state wire before the first write becomes visible
+     *
+     * @param initialState object carrying the initial state ( owned by the signal )
+     * @param firstCycleForRead first cycle in which the initial state can be read
+     */
+    void setInitialState( DynamicObject* initialState, U64 firstCycleForRead = 0 );
+
 
     /**
      * Write interface for void pointers ( using max latency allowed )
@@ -272,6 +339,13 @@ public:
      */
     const char* getName() const;
 
+    /**
+     * Obtains the clock domain of the last write to the signal
+     *
+     * @return clock domain ( 0 if the signal was not written )
+     */
+    U32 getClockDomain() const { return clockDomain; }
+
     /**
      * Obtains max signal's bandwidth ( writes per cycle allowed )
      *
@@ -271,7 +271,7 @@ void cmoSignalBinder::dumpSignalTrace(U64 cycle)
 
     //  Dump the current cycle.  
     //fprintf(ProfilingFile,"C %ld\n", cycle);
-    sprintf(bufferLine, "C %ld\n", cycle);
+    sprintf(bufferLine, "C %llu\n", (unsigned long long) cycle);
     (*ProfilingFile) << bufferLine;
 
     /*  Dump all what is stored in all the signals for the
@@ -284,6 +284,29 @@ void cmoSignalBinder::dumpSignalTrace(U64 cycle)
         (*ProfilingFile) << bufferLine;
         
         //  Dump the objects in the signal for that cycle.  
+        signals[i]->traceSignal(ProfilingFile, cycle);
+    }
+}
+
+//  Dump the signal trace of a clock domain for a given cycle of the domain.
+void cmoSignalBinder::dumpSignalTrace(U32 domain, U64 cycle)
+{
+    U32 i;
+    char bufferLine[1024];
+
+    //  Dump the clock domain and the cycle.
+    sprintf(bufferLine, "D %d C %llu\n", domain, (unsigned long long) cycle);
+    (*ProfilingFile) << bufferLine;
+
+    //  Dump the signals written in the clock domain.
+    for (i = 0; i < elements; i++)
+    {
+        if (signals[i]->getClockDomain() != domain)
+            continue;
+
+        sprintf(bufferLine, "S %d:\n", i);
+        (*ProfilingFile) << bufferLine;
+
         signals[i]->traceSignal(ProfilingFile, cycle);
     }
 }
\ No newline at end of file
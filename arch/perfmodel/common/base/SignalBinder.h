@@ -109,6 +109,15 @@ public:
      *  signal trace.
      */
     void dumpSignalTrace(U64 cycle);
+
+    /**
+     *  Dumps the signal trace of a clock domain for a simulation cycle of the domain.
+     *  Only the signals written in the clock domain are dumped (see Signal::writeDomain).
+     *  @param domain The clock domain.
+     *  @param cycle The simulation cycle of the clock domain for which to dump the
+     *  signal trace.
+     */
+    void dumpSignalTrace(U32 domain, U64 cycle);
     // Debug purpose only
     void dump(bool showOnlyNotBoundSignals = false) const;
 };
@@ -0,0 +1,141 @@
+/**************************************************************************
+ *
+ * State Wire class definition file.
+ *
+ */
+
+#ifndef __STATE_WIRE__
+#define __STATE_WIRE__
+
+#include "GPUType.h"
+#include "GPUSignal.h"
+
+namespace arch
+{
+
+/**
+ * @b StateWire class implements a typed state signal between two boxes
+ *
+ * @b Files:  StateWire.h
+ *
+ * - Carries the state of a box ( ready, busy, ... ) to the boxes that depend on it.
+ * - The underlying Signal is turned into a state wire ( see Signal::setStateWire ):
+ *   the last state written is returned by every read once the signal latency has
+ *   passed.
+ * - A StateInfo object is only created when the state written changes, a box that
+ *   keeps the same state costs a comparison to the writer and nothing to the reader.
+ * - The signal trace shows the state visible in every cycle, as when the writer
+ *   wrote a StateInfo object every cycle.
+ *
+ * The StateInfo class must have a constructor from the state ( an enumeration ) and a
+ * getState() method.  It can be an incomplete type where the StateWire is declared.
+ *
+ * @code
+ *    //  Writer box.
+ *    StateWire<ShaderStateInfo> readySignal;
+ *    readySignal = newOutputSignal("ShaderState", 1, 1, prefix);
+ *    readySignal.setInitial(SH_READY);
+ *    ...
+ *    readySignal.write(cycle, shState);
+ *
+ *    //  Reader box.
+ *    StateWire<ShaderStateInfo> shaderState;
+ *    shaderState = newInputSignal("ShaderState", 1, 1, prefix);
+ *    ...
+ *    ShaderState state;
+ *    if (!shaderState.read(cycle, state))
+ *        CG_ASSERT("Missing shader state.");
+ * @endcode
+ */
+template <class StateInfoT>
+class StateWire
+{
+private:
+
+    Signal *signal;     //  Underlying signal.
+    U32 lastState;      //  Last state written (or initial state).
+    bool written;       //  A state was written (or set as initial state).
+
+public:
+
+    StateWire() : signal(0), lastState(0), written(false)
+    {
+    }
+
+    /**
+     * Binds the state wire to a signal and turns the signal into a state wire
+     *
+     * A NULL signal leaves the state wire unbound ( see isBound ).
+     */
+    StateWire &operator=(Signal *sig)
+    {
+        signal = sig;
+        if (signal != NULL)
+            signal->setStateWire();
+        written = false;
+        return *this;
+    }
+
+    /**
+     * Sets the state read until the first state written becomes visible
+     */
+    template <class State>
+    void setInitial(State state)
+    {
+        signal->setInitialState(new StateInfoT(state));
+        lastState = U32(state);
+        written = true;
+    }
+
+    /**
+     * Writes the state for the cycle ( visible after the signal latency )
+     */
+    template <class State>
+    void write(U64 cycle, State state)
+    {
+        if (!written || (U32(state) != lastState))
+        {
+            signal->write(cycle, new StateInfoT(state));
+            lastState = U32(state);
+            written = true;
+        }
+    }
+
+    /**
+     * Reads the state visible in the cycle
+     *
+     * @return false if no state is visible yet
+     */
+    template <class State>
+    bool read(U64 cycle, State &state)
+    {
+        DynamicObject *stateInfo;
+
+        if (!signal->read(cycle, stateInfo))
+            return false;
+
+        state = static_cast<StateInfoT *>(stateInfo)->getState();
+
+        return true;
+    }
+
+    /**
+     * Returns if the state wire is bound to a signal
+     */
+    bool isBound() const
+    {
+        return (signal != NULL);
+    }
+
+    /**
+     * Returns the underlying signal
+     */
+    Signal *getSignal() const
+    {
+        return signal;
+    }
+};
+
+} // namespace arch
+
+#endif
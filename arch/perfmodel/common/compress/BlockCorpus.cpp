@@ -0,0 +1,90 @@
+/**************************************************************************
+ *
+ * Block Corpus implementation file.
+ *
+ */
+
+#include "BlockCorpus.h"
+#include "support.h"
+
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+namespace arch
+{
+
+bool bmoBlockCorpus::enabled = false;
+
+static string corpusPrefix;
+static map<string, FILE *> corpusFiles;
+static mutex corpusMutex;
+
+void bmoBlockCorpus::enable(const char *prefix)
+{
+    corpusPrefix = prefix;
+    enabled = true;
+}
+
+void bmoBlockCorpus::record(const char *cache, const U32 *block, U32 size)
+{
+    lock_guard<mutex> lock(corpusMutex);
+
+    FILE *&f = corpusFiles[cache];
+
+    if (f == NULL)
+    {
+        string fileName = corpusPrefix + "." + cache + ".bin";
+        f = fopen(fileName.c_str(), "wb");
+        CG_ASSERT_COND((f != NULL), "Error creating block corpus file %s.", fileName.c_str());
+    }
+
+    fwrite(&size, sizeof(U32), 1, f);
+    fwrite(block, sizeof(U32), size, f);
+}
+
+void bmoBlockCorpus::close()
+{
+    lock_guard<mutex> lock(corpusMutex);
+
+    for(map<string, FILE *>::iterator it = corpusFiles.begin(); it != corpusFiles.end(); it++)
+        fclose(it->second);
+
+    corpusFiles.clear();
+    enabled = false;
+}
+
+S32 bmoBlockCorpus::load(const char *fileName, U32 blockSize, vector<U32> &blocks)
+{
+    FILE *f = fopen(fileName, "rb");
+
+    if (f == NULL)
+        return -1;
+
+    S32 loaded = 0;
+    U32 size;
+    vector<U32> block;
+
+    while (fread(&size, sizeof(U32), 1, f) == 1)
+    {
+        block.resize(size);
+
+        if (fread(block.data(), sizeof(U32), size, f) != size)
+            break;
+
+        if (size == blockSize)
+        {
+            blocks.insert(blocks.end(), block.begin(), block.end());
+            loaded++;
+        }
+    }
+
+    fclose(f);
+
+    return loaded;
+}
+
+} // namespace arch
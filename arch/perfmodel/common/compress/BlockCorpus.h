@@ -0,0 +1,96 @@
+/**************************************************************************
+ *
+ * Block Corpus definition file.
+ *
+ */
+
+/**
+ *
+ *  @file BlockCorpus.h
+ *
+ *  This file defines the class used to capture the blocks compressed by the
+ *  color and z caches and to load the captured blocks for the compressor tests
+ *  and benchmarks.
+ *
+ *  A corpus file is a sequence of records:  the number of 32-bit elements in the
+ *  block followed by the elements, in host byte order.
+ *
+ */
+
+#ifndef _BLOCKCORPUS_
+
+#define _BLOCKCORPUS_
+
+#include "GPUType.h"
+
+#include <vector>
+
+namespace arch
+{
+
+class bmoBlockCorpus
+{
+public:
+
+    /**
+     *
+     *  Enables the capture of the compressed blocks.  The blocks from each cache type are
+     *  written to <prefix>.<cache>.bin.
+     *
+     */
+
+    static void enable(const char *prefix);
+
+    /**
+     *
+     *  Returns if the blocks are being captured.
+     *
+     */
+
+    static bool isEnabled() { return enabled; }
+
+    /**
+     *
+     *  Writes a block to the corpus file of a cache type.
+     *
+     *  @param cache Name of the cache type.
+     *  @param block Pointer to the block elements.
+     *  @param size Number of elements in the block.
+     *
+     */
+
+    static void record(const char *cache, const U32 *block, U32 size);
+
+    /**
+     *
+     *  Closes the corpus files.
+     *
+     */
+
+    static void close();
+
+    /**
+     *
+     *  Loads the blocks with a given number of elements from a corpus file.  Blocks with a
+     *  different size are skipped.
+     *
+     *  @param fileName Corpus file.
+     *  @param blockSize Number of elements of the blocks to load.
+     *  @param blocks Reference to the vector where to append the elements of the blocks.
+     *
+     *  @return The number of blocks loaded or -1 if the file could not be read.
+     *
+     */
+
+    static S32 load(const char *fileName, U32 blockSize, std::vector<U32> &blocks);
+
+private:
+
+    static bool enabled;
+
+    bmoBlockCorpus();
+};
+
+} // namespace arch
+
+#endif
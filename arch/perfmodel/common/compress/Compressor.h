@@ -23,15 +23,9 @@ public:
     CompressorInfo(bool success, int level, int size)
         : success(success), level(level), size(size) { }
     
-    CompressorInfo(const CompressorInfo& info)
-        : success(info.success), level(info.level), size(info.size) {}
+    CompressorInfo(const CompressorInfo& info) = default;
     
-    /*CompressorInfo& operator= (const CompressorInfo& info) {
-        success = info.success;
-        level = info.level;
-        size = info.size;
-        return *this;
-    }*/
+    CompressorInfo& operator= (const CompressorInfo& info) = default;
 };
 
 class bmoCompressor
@@ -0,0 +1,536 @@
+/**************************************************************************
+ *
+ * Compressor Kernels implementation file.
+ *
+ */
+
+/**
+ *
+ *  @file CompressorKernels.cpp
+ *
+ *  This file implements the scalar, SSE2 and SSE4.1 kernels used by the block
+ *  compressors and the selection of the kernels for the CPU.
+ *
+ */
+
+#include "CompressorKernels.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define COMPRESSOR_SSE2
+#endif
+
+//  SSE4.1 kernels are compiled for any x86 target and only used if the CPU supports them.
+#if defined(COMPRESSOR_SSE2) && (defined(__GNUC__) || defined(__clang__))
+    #include <smmintrin.h>
+    #define COMPRESSOR_SSE41
+    #define SSE41_TARGET __attribute__((target("sse4.1")))
+#elif defined(COMPRESSOR_SSE2) && defined(_MSC_VER)
+    #include <smmintrin.h>
+    #include <intrin.h>
+    #define COMPRESSOR_SSE41
+    #define SSE41_TARGET
+#endif
+
+namespace arch
+{
+
+/**
+ *
+ *  Scalar kernels.
+ *
+ */
+
+static inline U32 reorderBits(U32 data, const HiloLevelConfig &config)
+{
+    return (data & config.reHighMask1)
+            | (data & config.reHighMask2) << config.reHighShift2
+            | (data & config.reHighMask3) << config.reHighShift3
+            | (data & config.reHighMask4) << config.reHighShift4
+            | (data & config.reLowMask1) >> config.reLowShift1
+            | (data & config.reLowMask2) >> config.reLowShift2
+            | (data & config.reLowMask3) >> config.reLowShift3
+            | (data & config.reLowMask4);
+}
+
+static inline U32 unreorderBits(U32 data, const HiloLevelConfig &config)
+{
+    return (data & config.reHighMask1)
+            | (data & config.unreHighMask2) >> config.reHighShift2
+            | (data & config.unreHighMask3) >> config.reHighShift3
+            | (data & config.unreHighMask4) >> config.reHighShift4
+            | (data & config.unreLowMask1) << config.reLowShift1
+            | (data & config.unreLowMask2) << config.reLowShift2
+            | (data & config.unreLowMask3) << config.reLowShift3
+            | (data & config.reLowMask4);
+}
+
+//  Same reference priority than HiloLevelRefs::getIndexOfRef.
+static inline U32 refIndex(U32 high, const HiloLevelRefs &refs)
+{
+    return (high == refs.min) ? 0 : (high == refs.max) ? 1 : (high == refs.a) ? 2 : 3;
+}
+
+static inline U32 refByIndex(U32 index, const HiloLevelRefs &refs)
+{
+    return (index == 0) ? refs.min : (index == 1) ? refs.max : (index == 2) ? refs.a : refs.b;
+}
+
+static void hiloAnalyzeScalar(const U32 *data, U32 size, U32 dataMask, const HiloLevelConfig &config, bool reorder,
+                              U32 *values, MinMaxInfo &mmi)
+{
+    U32 min = 0xffffffff;
+    U32 max = 0x00000000;
+
+    for(U32 i = 0; i < size; i++)
+    {
+        U32 d = data[i] & dataMask;
+        d = reorder ? reorderBits(d, config) : d;
+        values[i] = d;
+        min = (d < min) ? d : min;
+        max = (d > max) ? d : max;
+    }
+
+    mmi = MinMaxInfo(min, max);
+}
+
+static S32 hiloFindMissScalar(const U32 *values, U32 size, U32 highMask, const HiloLevelRefs &refs)
+{
+    for(U32 i = 0; i < size; i++)
+    {
+        U32 h = values[i] & highMask;
+        if ((h != refs.min) && (h != refs.max) && (h != refs.a) && (h != refs.b))
+            return S32(i);
+    }
+
+    return -1;
+}
+
+static void hiloEncodeScalar(const U32 *values, U32 size, const HiloLevelConfig &config, const HiloLevelRefs &refs,
+                             U32 *fields)
+{
+    for(U32 i = 0; i < size; i++)
+        fields[i] = refIndex(values[i] & config.highMask, refs) | ((values[i] & config.lowMask) << 2);
+}
+
+static void hiloDecodeScalar(const U32 *fields, U32 size, const HiloLevelConfig &config, const HiloLevelRefs &refs,
+                             bool reorder, U32 *data)
+{
+    for(U32 i = 0; i < size; i++)
+    {
+        U32 d = refByIndex(fields[i] & 0x03, refs) | ((fields[i] >> 2) & config.lowMask);
+        data[i] = reorder ? unreorderBits(d, config) : d;
+    }
+}
+
+static U32 msaaDiffScalar(const U32 *data, U32 samples, U32 ref)
+{
+    U32 diff = 0;
+
+    for(U32 s = 0; s < samples; s++)
+        diff |= ((data[s] != ref) ? 1U : 0U) << s;
+
+    return diff;
+}
+
+static void msaaExpandScalar(U32 *data, U32 samples, U32 ref1, U32 ref2, U32 mask)
+{
+    for(U32 s = 0; s < samples; s++)
+        data[s] = (((mask >> s) & 1) != 0) ? ref2 : ref1;
+}
+
+#ifdef COMPRESSOR_SSE2
+
+/**
+ *
+ *  SSE2 kernels.  Four elements per instruction, the remaining elements use the
+ *  scalar kernels.
+ *
+ */
+
+static inline __m128i shiftLeft(__m128i v, __m128i mask, __m128i shift)
+{
+    return _mm_sll_epi32(_mm_and_si128(v, mask), shift);
+}
+
+static inline __m128i shiftRight(__m128i v, __m128i mask, __m128i shift)
+{
+    return _mm_srl_epi32(_mm_and_si128(v, mask), shift);
+}
+
+//  Masks and shifts of a hilo level configuration.
+struct HiloLanes
+{
+    __m128i reHigh1, reHigh2, reHigh3, reHigh4;
+    __m128i reLow1, reLow2, reLow3, reLow4;
+    __m128i unreHigh2, unreHigh3, unreHigh4;
+    __m128i unreLow1, unreLow2, unreLow3;
+    __m128i highShift2, highShift3, highShift4;
+    __m128i lowShift1, lowShift2, lowShift3;
+
+    HiloLanes(const HiloLevelConfig &config)
+    {
+        reHigh1 = _mm_set1_epi32(S32(config.reHighMask1));
+        reHigh2 = _mm_set1_epi32(S32(config.reHighMask2));
+        reHigh3 = _mm_set1_epi32(S32(config.reHighMask3));
+        reHigh4 = _mm_set1_epi32(S32(config.reHighMask4));
+        reLow1 = _mm_set1_epi32(S32(config.reLowMask1));
+        reLow2 = _mm_set1_epi32(S32(config.reLowMask2));
+        reLow3 = _mm_set1_epi32(S32(config.reLowMask3));
+        reLow4 = _mm_set1_epi32(S32(config.reLowMask4));
+        unreHigh2 = _mm_set1_epi32(S32(config.unreHighMask2));
+        unreHigh3 = _mm_set1_epi32(S32(config.unreHighMask3));
+        unreHigh4 = _mm_set1_epi32(S32(config.unreHighMask4));
+        unreLow1 = _mm_set1_epi32(S32(config.unreLowMask1));
+        unreLow2 = _mm_set1_epi32(S32(config.unreLowMask2));
+        unreLow3 = _mm_set1_epi32(S32(config.unreLowMask3));
+        highShift2 = _mm_cvtsi32_si128(config.reHighShift2);
+        highShift3 = _mm_cvtsi32_si128(config.reHighShift3);
+        highShift4 = _mm_cvtsi32_si128(config.reHighShift4);
+        lowShift1 = _mm_cvtsi32_si128(config.reLowShift1);
+        lowShift2 = _mm_cvtsi32_si128(config.reLowShift2);
+        lowShift3 = _mm_cvtsi32_si128(config.reLowShift3);
+    }
+
+    __m128i reorder(__m128i d) const
+    {
+        __m128i high = _mm_or_si128(_mm_or_si128(_mm_and_si128(d, reHigh1), shiftLeft(d, reHigh2, highShift2)),
+                                    _mm_or_si128(shiftLeft(d, reHigh3, highShift3), shiftLeft(d, reHigh4, highShift4)));
+        __m128i low = _mm_or_si128(_mm_or_si128(shiftRight(d, reLow1, lowShift1), shiftRight(d, reLow2, lowShift2)),
+                                   _mm_or_si128(shiftRight(d, reLow3, lowShift3), _mm_and_si128(d, reLow4)));
+        return _mm_or_si128(high, low);
+    }
+
+    __m128i unreorder(__m128i d) const
+    {
+        __m128i high = _mm_or_si128(_mm_or_si128(_mm_and_si128(d, reHigh1), shiftRight(d, unreHigh2, highShift2)),
+                                    _mm_or_si128(shiftRight(d, unreHigh3, highShift3), shiftRight(d, unreHigh4, highShift4)));
+        __m128i low = _mm_or_si128(_mm_or_si128(shiftLeft(d, unreLow1, lowShift1), shiftLeft(d, unreLow2, lowShift2)),
+                                   _mm_or_si128(shiftLeft(d, unreLow3, lowShift3), _mm_and_si128(d, reLow4)));
+        return _mm_or_si128(high, low);
+    }
+};
+
+static inline __m128i selectBits(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+//  Returns the 4-bit lane mask of a comparison result.
+static inline U32 laneMask(__m128i cmp)
+{
+    return U32(_mm_movemask_ps(_mm_castsi128_ps(cmp)));
+}
+
+static inline U32 firstLane(U32 mask)
+{
+    U32 lane = 0;
+    while (((mask >> lane) & 1) == 0)
+        lane++;
+    return lane;
+}
+
+//  The elements of the block are masked and reordered into the values array.  The minimum and
+//  maximum are computed by the caller (unsigned comparisons differ between SSE2 and SSE4.1).
+static inline U32 hiloReorderSSE2(const U32 *data, U32 size, U32 dataMask, const HiloLevelConfig &config, bool reorder,
+                                  U32 *values)
+{
+    HiloLanes lanes(config);
+    __m128i mask = _mm_set1_epi32(S32(dataMask));
+    U32 vectorSize = size & ~0x03U;
+
+    for(U32 i = 0; i < vectorSize; i += 4)
+    {
+        __m128i d = _mm_and_si128(_mm_loadu_si128((const __m128i *) &data[i]), mask);
+        _mm_storeu_si128((__m128i *) &values[i], reorder ? lanes.reorder(d) : d);
+    }
+
+    return vectorSize;
+}
+
+static void hiloAnalyzeSSE2(const U32 *data, U32 size, U32 dataMask, const HiloLevelConfig &config, bool reorder,
+                            U32 *values, MinMaxInfo &mmi)
+{
+    U32 vectorSize = hiloReorderSSE2(data, size, dataMask, config, reorder, values);
+
+    //  Unsigned comparisons as signed comparisons with the sign bit flipped.
+    __m128i sign = _mm_set1_epi32(S32(0x80000000));
+    __m128i vmin = _mm_set1_epi32(S32(0x7fffffff));
+    __m128i vmax = _mm_set1_epi32(S32(0x80000000));
+
+    for(U32 i = 0; i < vectorSize; i += 4)
+    {
+        __m128i d = _mm_xor_si128(_mm_loadu_si128((const __m128i *) &values[i]), sign);
+        vmin = selectBits(_mm_cmplt_epi32(d, vmin), d, vmin);
+        vmax = selectBits(_mm_cmpgt_epi32(d, vmax), d, vmax);
+    }
+
+    alignas(16) U32 lmin[4];
+    alignas(16) U32 lmax[4];
+    _mm_store_si128((__m128i *) lmin, _mm_xor_si128(vmin, sign));
+    _mm_store_si128((__m128i *) lmax, _mm_xor_si128(vmax, sign));
+
+    U32 min = 0xffffffff;
+    U32 max = 0x00000000;
+
+    for(U32 l = 0; l < 4; l++)
+    {
+        min = (lmin[l] < min) ? lmin[l] : min;
+        max = (lmax[l] > max) ? lmax[l] : max;
+    }
+
+    MinMaxInfo tail;
+    hiloAnalyzeScalar(&data[vectorSize], size - vectorSize, dataMask, config, reorder, &values[vectorSize], tail);
+
+    mmi = MinMaxInfo((tail.min < min) ? tail.min : min, (tail.max > max) ? tail.max : max);
+}
+
+static S32 hiloFindMissSSE2(const U32 *values, U32 size, U32 highMask, const HiloLevelRefs &refs)
+{
+    __m128i mask = _mm_set1_epi32(S32(highMask));
+    __m128i rmin = _mm_set1_epi32(S32(refs.min));
+    __m128i rmax = _mm_set1_epi32(S32(refs.max));
+    __m128i ra = _mm_set1_epi32(S32(refs.a));
+    __m128i rb = _mm_set1_epi32(S32(refs.b));
+    U32 vectorSize = size & ~0x03U;
+
+    for(U32 i = 0; i < vectorSize; i += 4)
+    {
+        __m128i h = _mm_and_si128(_mm_loadu_si128((const __m128i *) &values[i]), mask);
+        __m128i match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(h, rmin), _mm_cmpeq_epi32(h, rmax)),
+                                     _mm_or_si128(_mm_cmpeq_epi32(h, ra), _mm_cmpeq_epi32(h, rb)));
+        U32 miss = ~laneMask(match) & 0x0f;
+
+        if (miss != 0)
+            return S32(i + firstLane(miss));
+    }
+
+    S32 miss = hiloFindMissScalar(&values[vectorSize], size - vectorSize, highMask, refs);
+
+    return (miss < 0) ? miss : S32(vectorSize) + miss;
+}
+
+static void hiloEncodeSSE2(const U32 *values, U32 size, const HiloLevelConfig &config, const HiloLevelRefs &refs,
+                           U32 *fields)
+{
+    __m128i highMask = _mm_set1_epi32(S32(config.highMask));
+    __m128i lowMask = _mm_set1_epi32(S32(config.lowMask));
+    __m128i rmin = _mm_set1_epi32(S32(refs.min));
+    __m128i rmax = _mm_set1_epi32(S32(refs.max));
+    __m128i ra = _mm_set1_epi32(S32(refs.a));
+    __m128i index1 = _mm_set1_epi32(1);
+    __m128i index2 = _mm_set1_epi32(2);
+    __m128i index3 = _mm_set1_epi32(3);
+    U32 vectorSize = size & ~0x03U;
+
+    for(U32 i = 0; i < vectorSize; i += 4)
+    {
+        __m128i d = _mm_loadu_si128((const __m128i *) &values[i]);
+        __m128i h = _mm_and_si128(d, highMask);
+
+        //  Lowest index of the matching references.
+        __m128i index = selectBits(_mm_cmpeq_epi32(h, ra), index2, index3);
+        index = selectBits(_mm_cmpeq_epi32(h, rmax), index1, index);
+        index = _mm_andnot_si128(_mm_cmpeq_epi32(h, rmin), index);
+
+        __m128i field = _mm_or_si128(index, _mm_slli_epi32(_mm_and_si128(d, lowMask), 2));
+        _mm_storeu_si128((__m128i *) &fields[i], field);
+    }
+
+    hiloEncodeScalar(&values[vectorSize], size - vectorSize, config, refs, &fields[vectorSize]);
+}
+
+static void hiloDecodeSSE2(const U32 *fields, U32 size, const HiloLevelConfig &config, const HiloLevelRefs &refs,
+                           bool reorder, U32 *data)
+{
+    HiloLanes lanes(config);
+    __m128i lowMask = _mm_set1_epi32(S32(config.lowMask));
+    __m128i indexMask = _mm_set1_epi32(0x03);
+    __m128i rmin = _mm_set1_epi32(S32(refs.min));
+    __m128i rmax = _mm_set1_epi32(S32(refs.max));
+    __m128i ra = _mm_set1_epi32(S32(refs.a));
+    __m128i rb = _mm_set1_epi32(S32(refs.b));
+    __m128i index1 = _mm_set1_epi32(1);
+    __m128i index2 = _mm_set1_epi32(2);
+    __m128i index3 = _mm_set1_epi32(3);
+    U32 vectorSize = size & ~0x03U;
+
+    for(U32 i = 0; i < vectorSize; i += 4)
+    {
+        __m128i f = _mm_loadu_si128((const __m128i *) &fields[i]);
+        __m128i index = _mm_and_si128(f, indexMask);
+
+        __m128i high = selectBits(_mm_cmpeq_epi32(index, index1), rmax, rmin);
+        high = selectBits(_mm_cmpeq_epi32(index, index2), ra, high);
+        high = selectBits(_mm_cmpeq_epi32(index, index3), rb, high);
+
+        __m128i d = _mm_or_si128(high, _mm_and_si128(_mm_srli_epi32(f, 2), lowMask));
+        _mm_storeu_si128((__m128i *) &data[i], reorder ? lanes.unreorder(d) : d);
+    }
+
+    hiloDecodeScalar(&fields[vectorSize], size - vectorSize, config, refs, reorder, &data[vectorSize]);
+}
+
+static U32 msaaDiffSSE2(const U32 *data, U32 samples, U32 ref)
+{
+    __m128i r = _mm_set1_epi32(S32(ref));
+    U32 vectorSamples = samples & ~0x03U;
+    U32 equal = 0;
+
+    for(U32 s = 0; s < vectorSamples; s += 4)
+        equal |= laneMask(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *) &data[s]), r)) << s;
+
+    U32 diff = ~equal & ((vectorSamples == 32) ? 0xffffffff : ((1U << vectorSamples) - 1));
+
+    if (vectorSamples < samples)
+        diff |= msaaDiffScalar(&data[vectorSamples], samples - vectorSamples, ref) << vectorSamples;
+
+    return diff;
+}
+
+static void msaaExpandSSE2(U32 *data, U32 samples, U32 ref1, U32 ref2, U32 mask)
+{
+    __m128i r1 = _mm_set1_epi32(S32(ref1));
+    __m128i r2 = _mm_set1_epi32(S32(ref2));
+    __m128i laneBits = _mm_set_epi32(8, 4, 2, 1);
+    U32 vectorSamples = samples & ~0x03U;
+
+    for(U32 s = 0; s < vectorSamples; s += 4)
+    {
+        __m128i bits = _mm_and_si128(_mm_set1_epi32(S32((mask >> s) & 0x0f)), laneBits);
+        __m128i select = _mm_cmpeq_epi32(bits, laneBits);
+        _mm_storeu_si128((__m128i *) &data[s], selectBits(select, r2, r1));
+    }
+
+    if (vectorSamples < samples)
+        msaaExpandScalar(&data[vectorSamples], samples - vectorSamples, ref1, ref2, mask >> vectorSamples);
+}
+
+#endif  // COMPRESSOR_SSE2
+
+#ifdef COMPRESSOR_SSE41
+
+/**
+ *
+ *  SSE4.1 kernels.  Unsigned minimum and maximum instructions, the other kernels are
+ *  the SSE2 kernels.
+ *
+ */
+
+SSE41_TARGET static void hiloAnalyzeSSE41(const U32 *data, U32 size, U32 dataMask, const HiloLevelConfig &config,
+                                          bool reorder, U32 *values, MinMaxInfo &mmi)
+{
+    U32 vectorSize = hiloReorderSSE2(data, size, dataMask, config, reorder, values);
+
+    __m128i vmin = _mm_set1_epi32(S32(0xffffffff));
+    __m128i vmax = _mm_setzero_si128();
+
+    for(U32 i = 0; i < vectorSize; i += 4)
+    {
+        __m128i d = _mm_loadu_si128((const __m128i *) &values[i]);
+        vmin = _mm_min_epu32(vmin, d);
+        vmax = _mm_max_epu32(vmax, d);
+    }
+
+    vmin = _mm_min_epu32(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(1, 0, 3, 2)));
+    vmin = _mm_min_epu32(vmin, _mm_shuffle_epi32(vmin, _MM_SHUFFLE(2, 3, 0, 1)));
+    vmax = _mm_max_epu32(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(1, 0, 3, 2)));
+    vmax = _mm_max_epu32(vmax, _mm_shuffle_epi32(vmax, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    U32 min = U32(_mm_cvtsi128_si32(vmin));
+    U32 max = U32(_mm_cvtsi128_si32(vmax));
+
+    MinMaxInfo tail;
+    hiloAnalyzeScalar(&data[vectorSize], size - vectorSize, dataMask, config, reorder, &values[vectorSize], tail);
+
+    mmi = MinMaxInfo((tail.min < min) ? tail.min : min, (tail.max > max) ? tail.max : max);
+}
+
+static bool supportsSSE41()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return ((info[2] >> 19) & 1) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+#endif  // COMPRESSOR_SSE41
+
+static const bmoCompressorKernels scalarKernels =
+{
+    "scalar",
+    hiloAnalyzeScalar, hiloFindMissScalar, hiloEncodeScalar, hiloDecodeScalar,
+    msaaDiffScalar, msaaExpandScalar
+};
+
+#ifdef COMPRESSOR_SSE2
+static const bmoCompressorKernels sse2Kernels =
+{
+    "SSE2",
+    hiloAnalyzeSSE2, hiloFindMissSSE2, hiloEncodeSSE2, hiloDecodeSSE2,
+    msaaDiffSSE2, msaaExpandSSE2
+};
+#endif
+
+#ifdef COMPRESSOR_SSE41
+static const bmoCompressorKernels sse41Kernels =
+{
+    "SSE4.1",
+    hiloAnalyzeSSE41, hiloFindMissSSE2, hiloEncodeSSE2, hiloDecodeSSE2,
+    msaaDiffSSE2, msaaExpandSSE2
+};
+#endif
+
+//  Implementations supported by the CPU, from slowest to fastest.
+static const bmoCompressorKernels *availableKernels[3];
+static U32 numAvailableKernels = 0;
+
+static void detectKernels()
+{
+    availableKernels[numAvailableKernels++] = &scalarKernels;
+
+#ifdef COMPRESSOR_SSE2
+    availableKernels[numAvailableKernels++] = &sse2Kernels;
+#endif
+
+#ifdef COMPRESSOR_SSE41
+    if (supportsSSE41())
+        availableKernels[numAvailableKernels++] = &sse41Kernels;
+#endif
+}
+
+const bmoCompressorKernels *const *bmoCompressorKernels::getAvailable(U32 &count)
+{
+    static bool detected = (detectKernels(), true);
+
+    (void) detected;
+    count = numAvailableKernels;
+
+    return availableKernels;
+}
+
+const bmoCompressorKernels &bmoCompressorKernels::get()
+{
+    U32 count;
+    const bmoCompressorKernels *const *kernels = getAvailable(count);
+
+    return *kernels[count - 1];
+}
+
+const bmoCompressorKernels *bmoCompressorKernels::find(const char *name)
+{
+    U32 count;
+    const bmoCompressorKernels *const *kernels = getAvailable(count);
+
+    for(U32 k = 0; k < count; k++)
+        if (strcmp(kernels[k]->name, name) == 0)
+            return kernels[k];
+
+    return NULL;
+}
+
+} // namespace arch
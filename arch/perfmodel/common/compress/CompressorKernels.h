@@ -0,0 +1,212 @@
+/**************************************************************************
+ *
+ * Compressor Kernels definition file.
+ *
+ */
+
+/**
+ *
+ *  @file CompressorKernels.h
+ *
+ *  This file defines the kernels used by the hilo and msaa block compressors to
+ *  analyze, encode and decode a whole block with a single call, and the bit
+ *  packers used to write and read the compressed blocks.
+ *
+ */
+
+#ifndef _COMPRESSORKERNELS_
+
+#define _COMPRESSORKERNELS_
+
+#include "GPUType.h"
+#include "HiloCompressor.h"
+
+namespace arch
+{
+
+/**
+ *
+ *  Kernels implementing the per element loops of the block compressors.
+ *
+ *  The kernels are selected once at startup for the CPU running the simulator (see get).
+ *  All the implementations produce the same results than the scalar implementation.
+ *
+ */
+
+struct bmoCompressorKernels
+{
+    const char *name;   //  Name of the implementation ("scalar", "SSE2", "SSE4.1").
+
+    /**
+     *
+     *  Applies the data mask and reorders the elements of a block for a hilo level and
+     *  finds the minimum and maximum reordered values.
+     *
+     *  @param data Pointer to the block elements.
+     *  @param size Number of elements in the block.
+     *  @param dataMask Mask applied to the elements.
+     *  @param config The hilo level configuration.
+     *  @param reorder Reorder the element bits.
+     *  @param values Pointer to an array of size elements where to store the reordered values.
+     *  @param mmi Reference to where to store the minimum and maximum reordered values.
+     *
+     */
+
+    void (*hiloAnalyze)(const U32 *data, U32 size, U32 dataMask, const HiloLevelConfig &config, bool reorder,
+                        U32 *values, MinMaxInfo &mmi);
+
+    /**
+     *
+     *  Finds the first reordered value whose high part is not one of the references.
+     *
+     *  @return The index of the first value not matching the references or -1 if all
+     *  the values match.
+     *
+     */
+
+    S32 (*hiloFindMiss)(const U32 *values, U32 size, U32 highMask, const HiloLevelRefs &refs);
+
+    /**
+     *
+     *  Builds the encoded field for each reordered value:  the 2-bit reference index in
+     *  the lower bits followed by the low part of the value.
+     *
+     */
+
+    void (*hiloEncode)(const U32 *values, U32 size, const HiloLevelConfig &config, const HiloLevelRefs &refs,
+                       U32 *fields);
+
+    /**
+     *
+     *  Rebuilds the block elements from the encoded fields.
+     *
+     */
+
+    void (*hiloDecode)(const U32 *fields, U32 size, const HiloLevelConfig &config, const HiloLevelRefs &refs,
+                       bool reorder, U32 *data);
+
+    /**
+     *
+     *  Compares the samples of a msaa subblock (up to 32) with a reference.
+     *
+     *  @return A mask with bit i set if sample i is different from the reference.
+     *
+     */
+
+    U32 (*msaaDiff)(const U32 *data, U32 samples, U32 ref);
+
+    /**
+     *
+     *  Fills the samples of a msaa subblock (up to 32) from two references:  sample i is
+     *  set to ref2 if bit i of the mask is set and to ref1 otherwise.
+     *
+     */
+
+    void (*msaaExpand)(U32 *data, U32 samples, U32 ref1, U32 ref2, U32 mask);
+
+    /**
+     *
+     *  Returns the fastest implementation supported by the CPU.  Selected on the first call.
+     *
+     */
+
+    static const bmoCompressorKernels &get();
+
+    /**
+     *
+     *  Returns the implementations supported by the CPU, the scalar implementation first.
+     *
+     *  @param count Reference to where to store the number of implementations.
+     *
+     */
+
+    static const bmoCompressorKernels *const *getAvailable(U32 &count);
+
+    /**
+     *
+     *  Returns an implementation by name or NULL if not supported by the CPU.
+     *
+     */
+
+    static const bmoCompressorKernels *find(const char *name);
+};
+
+/**
+ *
+ *  Writes fields of up to 32 bits in a 32-bit word buffer, starting from the least
+ *  significant bit of each word.  Same layout than BitStreamWriter.
+ *
+ */
+
+class bmoBitPacker
+{
+private:
+
+    U32 *buffer;
+    U64 value;
+    U32 bits;
+
+public:
+
+    bmoBitPacker(U32 *buffer) : buffer(buffer), value(0), bits(0) {}
+
+    void write(U32 data, U32 width)
+    {
+        value |= (U64(data) & ((U64(1) << width) - 1)) << bits;
+        bits += width;
+
+        if (bits >= 32)
+        {
+            *(buffer++) = U32(value);
+            value >>= 32;
+            bits -= 32;
+        }
+    }
+
+    void flush()
+    {
+        if (bits > 0)
+            *(buffer++) = U32(value);
+
+        value = 0;
+        bits = 0;
+    }
+};
+
+/**
+ *
+ *  Reads fields of up to 32 bits written by bmoBitPacker or BitStreamWriter.
+ *
+ */
+
+class bmoBitUnpacker
+{
+private:
+
+    const U32 *buffer;
+    U64 value;
+    U32 bits;
+
+public:
+
+    bmoBitUnpacker(const U32 *buffer) : buffer(buffer), value(0), bits(0) {}
+
+    U32 read(U32 width)
+    {
+        if (bits < width)
+        {
+            value |= U64(*(buffer++)) << bits;
+            bits += 32;
+        }
+
+        U32 data = U32(value & ((U64(1) << width) - 1));
+        value >>= width;
+        bits -= width;
+
+        return data;
+    }
+};
+
+} // namespace arch
+
+#endif
@@ -3,15 +3,16 @@
  */
 
 #include "HiloCompressor.h"
-#include "BitStreamWriter.h"
-#include "BitStreamReader.h"
+#include "CompressorKernels.h"
+#include "support.h"
 
 namespace arch
 {
 
 
 bmoHiloCompressor::bmoHiloCompressor(int numLevels, U32 dataMask, bool reorderData)
-    : numLevels(numLevels), dataMask(dataMask), reorderData(reorderData)
+    : numLevels(numLevels), dataMask(dataMask), reorderData(reorderData),
+      kernels(&bmoCompressorKernels::get())
 {
     static const int lobits[] = {5, 13, 21};
     static const int csize[] = {64, 128, 192};
@@ -27,111 +28,72 @@ bmoHiloCompressor::~bmoHiloCompressor()
 {
 }
 
-U32 bmoHiloCompressor::reorder(
-        U32 data, const HiloLevelConfig& config)
+void bmoHiloCompressor::analyzeLevel(
+        const U32 *data, int size, int level, U32 *values, MinMaxInfo& mmi, HiloLevelRefs& refs)
 {
-    return reorderData ? 
-            (data & config.reHighMask1)
-                | (data & config.reHighMask2) << config.reHighShift2
-                | (data & config.reHighMask3) << config.reHighShift3
-                | (data & config.reHighMask4) << config.reHighShift4
-                    
-                | (data & config.reLowMask1) >> config.reLowShift1
-                | (data & config.reLowMask2) >> config.reLowShift2
-                | (data & config.reLowMask3) >> config.reLowShift3
-                | (data & config.reLowMask4)
-            : data;
-}
-
-U32 bmoHiloCompressor::unreorder(
-        U32 data, const HiloLevelConfig& config)
-{
-    return reorderData ? 
-            (data & config.reHighMask1)
-                | (data & config.unreHighMask2) >> config.reHighShift2
-                | (data & config.unreHighMask3) >> config.reHighShift3
-                | (data & config.unreHighMask4) >> config.reHighShift4
-                
-                | (data & config.unreLowMask1) << config.reLowShift1
-                | (data & config.unreLowMask2) << config.reLowShift2
-                | (data & config.unreLowMask3) << config.reLowShift3
-                | (data & config.reLowMask4)
-            : data;
-}
-
-MinMaxInfo bmoHiloCompressor::findMinMax(
-        const U32 *data, int size, const HiloLevelConfig& config)
-{
-    U32 min = 0xffffffff;
-    U32 max = 0x00000000;
-    
-    for (int i = 0; i < size; i++) {
-        U32 d = reorder(data[i] & dataMask, config);
-        min = d < min ? d : min;
-        max = d > max ? d : max;
-    }
-    
-    return MinMaxInfo(min, max);
+    kernels->hiloAnalyze(data, size, dataMask, configs[level], reorderData, values, mmi);
+    refs = HiloLevelRefs(mmi, configs[level]);
 }
 
 int bmoHiloCompressor::findCompressionLevel(
-        const U32 *data, int size, MinMaxInfo& mmi, HiloLevelRefs& refs)
+        const U32 *data, int size, U32 *values, MinMaxInfo& mmi, HiloLevelRefs& refs)
 {
     int level = 0;
 
-    const HiloLevelConfig* config = &configs[level];
-    mmi = findMinMax(data, size, *config);
-    refs = HiloLevelRefs(mmi, *config);
+    analyzeLevel(data, size, level, values, mmi, refs);
     
-    int i = 0;
-    while (i < size && level < numLevels) {
-        U32 d = reorder(data[i] & dataMask, *config);
+    while (true) {
+        S32 miss = kernels->hiloFindMiss(values, size, configs[level].highMask, refs);
         
-        while (level < numLevels && !refs.test(d & config->highMask)) {
+        if (miss < 0)
+            return level;
+        
+        // The value that failed (reordered for the failed level) is tested first against
+        // the references of the next levels and skips the levels it doesn't match.  This
+        // keeps the levels selected by the original per element search.
+        U32 d = values[miss];
+        
+        do {
             level++;
-            if (level < numLevels) {
-                config = &configs[level];
-                mmi = findMinMax(data, size, *config);
-                refs = HiloLevelRefs(mmi, *config);
-                i = -1;
-            }
-        }
-        i++;
+            if (level >= numLevels)
+                return level;
+            
+            analyzeLevel(data, size, level, values, mmi, refs);
+        } while (!refs.test(d & configs[level].highMask));
     }
-    
-    return level;
 }
 
 CompressorInfo bmoHiloCompressor::compress(
         const void *input, void *output, int size)
 {
-    U32* datain = (U32*) input;
+    const U32* datain = (const U32*) input;
     U32* dataout = (U32*) output;
     
+    CG_ASSERT_COND((size <= maxBlockSize), "Block too large for the hilo compressor.");
+    
+    U32 values[maxBlockSize];
     MinMaxInfo mmi;
     HiloLevelRefs refs;
     
-    int level = findCompressionLevel(datain, size, mmi, refs);
+    int level = findCompressionLevel(datain, size, values, mmi, refs);
     bool success = level < numLevels;
     
     if (success) {
         const HiloLevelConfig& config = configs[level];
         
-        BitStreamWriter bs(dataout);
+        U32 fields[maxBlockSize];
+        kernels->hiloEncode(values, size, config, refs, fields);
+        
+        bmoBitPacker bs(dataout);
         
-        //bs.write(level, 2);
         bs.write((mmi.min >> config.lowBits), config.highBits);
         bs.write((mmi.max >> config.lowBits), config.highBits);
         
-        for (int i = 0; i < size; i++) {
-            U32 d = reorder(datain[i] & dataMask, config);
-            U32 index = refs.getIndexOfRef(d & config.highMask);
-            bs.write(index, 2);
-            bs.write(d, config.lowBits);
-        }
+        // Reference index (2 bits) followed by the low part of each element
+        for (int i = 0; i < size; i++)
+            bs.write(fields[i], config.lowBits + 2);
         
-        //volatile int wb = (bs.getWrittenBits() + 7) / 8;
-        //cout << wb << " <--> " << (success ? comprSize[level] : (size * sizeof(U32))) << endl;
+        bs.flush();
     }
     
     int newSize = success ? comprSize[level] : (size * sizeof(U32));
@@ -142,12 +104,12 @@ CompressorInfo bmoHiloCompressor::compress(
 CompressorInfo bmoHiloCompressor::uncompress(
         const void *input, void *output, int size, int level)
 {
-    U32* datain = (U32*) input;
+    const U32* datain = (const U32*) input;
     U32* dataout = (U32*) output;
-        
-    BitStreamReader bs(datain);
     
-    //int level = bs.read(2);
+    CG_ASSERT_COND((size <= maxBlockSize), "Block too large for the hilo compressor.");
+    
+    bmoBitUnpacker bs(datain);
     
     const HiloLevelConfig& config = configs[level];
     
@@ -158,12 +120,11 @@ CompressorInfo bmoHiloCompressor::uncompress(
     
     HiloLevelRefs refs(mmi, config);
     
-    for (int i = 0; i < size; i++) {
-        U32 index = bs.read(2);
-        U32 lowPart = bs.read(config.lowBits);
-        U32 highPart = refs.getRefByIndex(index);
-        dataout[i] = unreorder(highPart | lowPart, config);
-    }
+    U32 fields[maxBlockSize];
+    for (int i = 0; i < size; i++)
+        fields[i] = bs.read(config.lowBits + 2);
+    
+    kernels->hiloDecode(fields, size, config, refs, reorderData, dataout);
     
     return CompressorInfo(true, level, size * sizeof(U32));
 }
@@ -13,6 +13,8 @@ using namespace std;
 namespace arch 
 {
 
+struct bmoCompressorKernels;
+
 
 // This class saves information about minimum and maximum values. 
 
@@ -27,10 +29,9 @@ public:
     MinMaxInfo(U32 min, U32 max)
         : min(min), max(max) {}
     
-    MinMaxInfo(const MinMaxInfo& minmax) {
-        min = minmax.min;
-        max = minmax.max;
-    }
+    MinMaxInfo(const MinMaxInfo& minmax) = default;
+    
+    MinMaxInfo& operator= (const MinMaxInfo& minmax) = default;
 };
 
 /* This class represents the configuration used to compress a block.
@@ -118,8 +119,9 @@ public:
         b = max - inc;
     }
     
-    HiloLevelRefs(const HiloLevelRefs& refs)
-        : min(refs.min), max(refs.max), a(refs.a), b(refs.b) {}
+    HiloLevelRefs(const HiloLevelRefs& refs) = default;
+    
+    HiloLevelRefs& operator= (const HiloLevelRefs& refs) = default;
     
     bool test(U32 d) {
         return d == min || d == max || d == a || d == b;
@@ -162,13 +164,16 @@ public:
         return comprSize[level];
     }
     
-private:
-    U32 reorder(U32 data, const HiloLevelConfig& config);
-    U32 unreorder(U32 data, const HiloLevelConfig& config);
+    // Selects the kernels used to analyze, encode and decode the blocks (see bmoCompressorKernels::get).
+    void setKernels(const bmoCompressorKernels& k) { kernels = &k; }
+    
+    // Maximum number of elements in a block
+    static const int maxBlockSize = 256;
     
-    MinMaxInfo findMinMax(const U32 *data, int size, const HiloLevelConfig& config);
+private:
+    void analyzeLevel(const U32 *data, int size, int level, U32 *values, MinMaxInfo& mmi, HiloLevelRefs& refs);
     
-    int findCompressionLevel(const U32 *data, int size, MinMaxInfo& mmi, HiloLevelRefs& refs);
+    int findCompressionLevel(const U32 *data, int size, U32 *values, MinMaxInfo& mmi, HiloLevelRefs& refs);
 
 private:
     // Maximum number of compression levels supported
@@ -188,6 +193,9 @@ private:
     
     // Is reordering of the data bits activated ?
     bool reorderData;
+    
+    // Kernels implementing the per element loops
+    const bmoCompressorKernels* kernels;
 };
 
 
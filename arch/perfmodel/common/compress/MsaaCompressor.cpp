@@ -3,8 +3,7 @@
  */
 
 #include "MsaaCompressor.h"
-#include "BitStreamWriter.h"
-#include "BitStreamReader.h"
+#include "CompressorKernels.h"
 
 namespace arch
 {
@@ -19,7 +18,7 @@ const MsaaLevelConfig bmoMsaaCompressor::configs[] = {
 };
 
 bmoMsaaCompressor::bmoMsaaCompressor(/*int numLevels,*/ int blockSize)
-    : /*numLevels(numLevels),*/ blockSize(blockSize)
+    : /*numLevels(numLevels),*/ blockSize(blockSize), kernels(&bmoCompressorKernels::get())
 {
 }
 
@@ -30,35 +29,31 @@ bmoMsaaCompressor::~bmoMsaaCompressor()
 bool bmoMsaaCompressor::checkSubblock(
         const U32 *data, int start, const MsaaLevelConfig* conf, MsaaRefs* refs) 
 {
-    //printf("refs = 0x%0p\n", refs);
-    
-    bool *bdiff = new bool[blockSize];
-
-    int end = start + conf->samples;
-    
-    for (int i = start; i < end; i++)
-        bdiff[i] = true;
-    
-    int diff = 0;
+    const U32 *subblock = &data[start];
 
-    refs->ref1 = data[start];
+    refs->ref1 = subblock[0];
     refs->ref2 = refs->ref1;
     refs->mask = 0;
 
-    for (int i = start; (i < end) && (diff <= conf->numRefs); i++) {
-        if (bdiff[i]) {
-            diff += 1;
-            refs->ref2 = (data[i] == refs->ref1) ? refs->ref2 : data[i];
-            for (int j = i + 1; j < end; j++)
-                bdiff[j] = bdiff[j] && (data[i] != data[j]);
-        }
-        int index = (data[i] == refs->ref1) ? 0 : 1;
-        refs->mask = (refs->mask << 1) | index;
-    }
-    
-    delete[] bdiff;
-    
-    return diff <= conf->numRefs;
+    // Samples different from the first sample
+    U32 diff = kernels->msaaDiff(subblock, conf->samples, refs->ref1);
+
+    if (diff == 0)
+        return true;
+
+    if (conf->numRefs < 2)
+        return false;
+
+    // The second reference is the first sample different from the first reference,
+    // all the other samples must be equal to one of the two references
+    int first = 0;
+    while (((diff >> first) & 1) == 0)
+        first++;
+
+    refs->ref2 = subblock[first];
+    refs->mask = diff;
+
+    return (diff & kernels->msaaDiff(subblock, conf->samples, refs->ref2)) == 0;
 }
 
 int bmoMsaaCompressor::findCompressionLevel(
@@ -111,30 +106,23 @@ CompressorInfo bmoMsaaCompressor::compress(
     bool success = level < numLevels;
 
     if (success) {
-        BitStreamWriter bs(dataout);
+        bmoBitPacker bs(dataout);
 
         const MsaaLevelConfig& conf = configs[level];
         for (int i = 0; i < refsArraySize; i++) {
             MsaaRefs& refs = refsArray[i];
-            int samples = refs.samples;
-            int pmask = 1 << (refs.samples - 1);
             
-            while (samples > 0) {
-                bs.write(refs.ref1, 32);
+            bs.write(refs.ref1, 32);
+            
+            if (conf.numRefs > 1) {
+                bs.write(refs.ref2, 32);
                 
-                if (conf.numRefs > 1) {
-                    bs.write(refs.ref2, 32);
-    
-                    for (int j = 0; j < conf.samples; j++) {
-                        int mask = (refs.mask & pmask) == 0 ? 0 : 1;
-                        bs.write(mask, 1);
-                        pmask >>= 1;
-                    }
-                }
-
-                samples -= conf.samples;
+                // One bit per sample, first sample first
+                bs.write(refs.mask, conf.samples);
             }
         }
+        
+        bs.flush();
     }
 
     int newSize = success ? configs[level].size : (size * sizeof(U32));
@@ -145,33 +133,24 @@ CompressorInfo bmoMsaaCompressor::compress(
 CompressorInfo bmoMsaaCompressor::uncompress(
         const void *input, void *output, int size, int level) 
 {
-    U32* datain = (U32*) input;
+    const U32* datain = (const U32*) input;
     U32* dataout = (U32*) output;
         
-    BitStreamReader bs(datain);
+    bmoBitUnpacker bs(datain);
 
     const MsaaLevelConfig& conf = configs[level];
 
-    int i = 0;
-    
-    if (conf.numRefs > 1) {
-        while (i < blockSize) {
-            U32 ref1 = bs.read(32);
-            U32 ref2 = bs.read(32);
-            
-            for (int j = 0; j < conf.samples; j++) {
-                U32 mask = bs.read(1);
-                dataout[i++] = (mask == 0) ? ref1 : ref2;
-            }
-        }
-    }
-    else {
-        while (i < blockSize) {
-            U32 ref1 = bs.read(32);
-            
-            for (int j = 0; j < conf.samples; j++)
-                dataout[i++] = ref1;
+    for (int i = 0; i < blockSize; i += conf.samples) {
+        U32 ref1 = bs.read(32);
+        U32 ref2 = ref1;
+        U32 mask = 0;
+        
+        if (conf.numRefs > 1) {
+            ref2 = bs.read(32);
+            mask = bs.read(conf.samples);
         }
+        
+        kernels->msaaExpand(&dataout[i], conf.samples, ref1, ref2, mask);
     }
 
     return CompressorInfo(true, level, size * sizeof(U32));
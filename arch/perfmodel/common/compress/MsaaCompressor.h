@@ -11,6 +11,8 @@
 namespace arch
 {
 
+struct bmoCompressorKernels;
+
 
 // This class represents the configuration used to compress a block. 
 
@@ -32,7 +34,7 @@ class MsaaRefs {
 public:
     U32 ref1;    // first reference 
     U32 ref2;    // second reference (if using 2 references) 
-    U32 mask;    // references index mask 
+    U32 mask;    // references index mask (bit i set if sample i uses the second reference) 
 
     int samples;    // number of samples used in the subblock 
 
@@ -62,6 +64,9 @@ public:
                             "Compressed block size requested for not supported level."); )
         return configs[level].size; }
 
+    // Selects the kernels used to analyze and decode the subblocks (see bmoCompressorKernels::get).
+    void setKernels(const bmoCompressorKernels& k) { kernels = &k; }
+
 private:
     bool checkSubblock(const U32 *data, int start, const MsaaLevelConfig* conf, MsaaRefs* refs);
     int findCompressionLevel(const U32 *data, int size, MsaaRefs* refsArray, int &refsArraySize);
@@ -78,6 +83,9 @@ private:
 
     // number of elements in a block
     int blockSize;
+
+    // Kernels implementing the per sample loops
+    const bmoCompressorKernels* kernels;
 };
 
 
@@ -11,6 +11,10 @@
 #include "DepthCompressor.h"
 #include "StatisticsManager.h"
 #include "support.h"
+#include "PagedSnapshot.h"
+#include "ValidationChecker.h"
+#include "Timeline.h"
+#include "ClockProfiler.h"
 #include <ctime>
 
 using namespace std;
@@ -30,6 +34,7 @@ bool NaN(F32 f)
 };
 
 PerfModel *PerfModel::current = NULL;
+const char *PerfModel::HOST_PROFILE_FILE = "stats.hostprofile.csv";
 
 //  Constructor.
 PerfModel::PerfModel(cgsArchConfig ArchConf, cgoTraceDriverBase *TraceDriver) :
@@ -54,6 +59,41 @@ PerfModel::PerfModel(cgsArchConfig ArchConf, cgoTraceDriverBase *TraceDriver) :
         memoryClockPeriod = (U32) (1E6 / (F32) ArchParams::get<uint32_t>("GPU_MEMORY_CLOCK"));
     }
 
+    //  Define the clock domains.  The multi clock mdus of the shader and memory domains are also
+    //  clocked in the GPU domain.
+    if (!GpuPerfModel.multiClock)
+    {
+        clockScheduler.addDomain("GPU", GPU_CLOCK_DOMAIN, 1);
+        for(U32 i = 0; i < GpuPerfModel.MduArray.size(); i++)
+            clockScheduler.addMdu(0, GpuPerfModel.MduArray[i]);
+    }
+    else
+    {
+        U32 gpuDomain = clockScheduler.addDomain("GPU", GPU_CLOCK_DOMAIN, gpuClockPeriod);
+        for(U32 i = 0; i < GpuPerfModel.GpuDomainMduArray.size(); i++)
+            clockScheduler.addMdu(gpuDomain, GpuPerfModel.GpuDomainMduArray[i]);
+        for(U32 i = 0; i < GpuPerfModel.ShaderDomainMduArray.size(); i++)
+            clockScheduler.addMdu(gpuDomain, GpuPerfModel.ShaderDomainMduArray[i]);
+        for(U32 i = 0; i < GpuPerfModel.MemoryDomainMduArray.size(); i++)
+            clockScheduler.addMdu(gpuDomain, GpuPerfModel.MemoryDomainMduArray[i]);
+
+        if (GpuPerfModel.shaderClockDomain)
+        {
+            U32 shaderDomain = clockScheduler.addDomain("Shader", SHADER_CLOCK_DOMAIN, shaderClockPeriod);
+            for(U32 i = 0; i < GpuPerfModel.ShaderDomainMduArray.size(); i++)
+                clockScheduler.addMdu(shaderDomain, GpuPerfModel.ShaderDomainMduArray[i]);
+        }
+
+        if (GpuPerfModel.memoryClockDomain)
+        {
+            U32 memoryDomain = clockScheduler.addDomain("Memory", MEMORY_CLOCK_DOMAIN, memoryClockPeriod);
+            for(U32 i = 0; i < GpuPerfModel.MemoryDomainMduArray.size(); i++)
+                clockScheduler.addMdu(memoryDomain, GpuPerfModel.MemoryDomainMduArray[i]);
+        }
+    }
+
+    clockScheduler.reset();
+
     //  Check that all the signals are well defined.
     if (!sigBinder.checkSignalBindings())
     {
@@ -64,7 +104,6 @@ PerfModel::PerfModel(cgsArchConfig ArchConf, cgoTraceDriverBase *TraceDriver) :
     //  Check if signal trace dump is enabled.
     if (ArchParams::get<bool>("SIMULATOR_DUMP_SIGNAL_TRACE"))
     {
-        CG_ASSERT_COND((!GpuPerfModel.multiClock), "Signal Trace Dump not supported with multiple clock domains."); //  Signal tracing not supported with multiple clock domains.
         sigTraceFile.open(ArchParams::get<std::string>("SIMULATOR_SIGNAL_DUMP_FILE").c_str(), ios::out | ios::binary); //  Try to open the signal trace file.
         CG_ASSERT_COND(sigTraceFile.is_open(), "Error opening signal trace file.");
         sigBinder.initSignalTrace(&sigTraceFile); //  Initialize the signal tracer.  
@@ -113,6 +152,14 @@ PerfModel::PerfModel(cgsArchConfig ArchConf, cgoTraceDriverBase *TraceDriver) :
     //  Reset batch counters.
     batchCounter = 0;
     frameBatch = 0;
+    //  Validation mode is enabled by the debug loop.
+    validationMode = false;
+    skipValidation = false;
+    GpuBehavMdl = NULL;
+    validationChecker = NULL;
+    //  Host profiler disabled by default.
+    clockProfilePeriod = 0;
+    clockProfiler = NULL;
     //  Auto snapshot variables.
     pendingSaveSnapshot = false;
     autoSnapshotEnable = false;    
@@ -121,6 +168,11 @@ PerfModel::PerfModel(cgsArchConfig ArchConf, cgoTraceDriverBase *TraceDriver) :
 
 PerfModel::~PerfModel()
 {
+    //  Stop the validation thread.
+    delete validationChecker;
+
+    delete clockProfiler;
+
     //   Close all output files.
     if (sigTraceFile.is_open())
         sigTraceFile.close();
@@ -211,6 +263,9 @@ void PerfModel::createSnapshot()
                 comstream.str("_savememory");
                 current->GpuPerfModel.MC->execCommand(comstream);
 
+                //  The simulator exits after a panic or stall snapshot, wait for the compressed memory pages.
+                cgoSnapshotWriter::getInstance().flush();
+
 
                 if (changeDirectory(workingDirectory) != 0)
                     CG_ASSERT("Error changing back to working directory.");
@@ -236,17 +291,14 @@ void PerfModel::saveSimState()
     out << "Batch = " << batchCounter << endl;
     out << "Frame Batch = " << frameBatch << endl; 
 
-    if (GpuPerfModel.multiClock)
+    if (clockScheduler.getNumDomains() > 1)
     {
         out << "MultiClock" << endl;
-        out << "GPU Cycle = " << gpuCycle << endl;
-        if (GpuPerfModel.shaderClockDomain)
-            out << "Shader Cycle = " << shaderCycle << endl;
-        if (GpuPerfModel.memoryClockDomain)
-            out << "Memory Cycle = " << memoryCycle << endl;
+        for(U32 d = 0; d < clockScheduler.getNumDomains(); d++)
+            out << clockScheduler.getName(d) << " Cycle = " << clockScheduler.getCycle(d) << endl;
     }
     else
-        out << "Cycle = " << cycle << endl;
+        out << "Cycle = " << clockScheduler.getCycle(0) << endl;
 
     if (TraceDriver->getTraceTyp() == TraceTypD3d)
     {
@@ -294,7 +346,8 @@ void PerfModel::debugLoop(bool validate)
         GpuBehavMdl = new BhavModel(ArchConf, TraceDriver); //  Create the GPU behaviorModel.
         GpuBehavMdl->GpuBMdl.resetState(); //  Reset the GPU behaviorModel.
         GpuBehavMdl->GpuBMdl.setValidationMode(true); //  Enable validation mode.
-        GpuPerfModel.CP->setValidationMode(true); //  Enable the validation mode in the simulator Command Processor.
+        validationChecker = new ValidationChecker(GpuBehavMdl->GpuBMdl); //  Start the behaviorModel validation thread.
+        GpuPerfModel.CP->setValidationMode(validationChecker); //  Enable the validation mode in the simulator Command Processor.
         GpuPerfModel.StreamController->setValidationMode(true); //  Enable the validation mode in the cmoStreamController.
         for(U32 rop = 0; rop < ArchConf.gpu.numStampUnits; rop++) //  Enable validation mode in the Z Stencil Test and Color Write units.
         {
@@ -317,19 +370,7 @@ void PerfModel::debugLoop(bool validate)
     s_panicSnapshotInstance = this;
 
     //  Initialize clock state.
-    if (GpuPerfModel.multiClock)
-    {
-        nextGPUClock = gpuClockPeriod;
-        nextShaderClock = shaderClockPeriod;
-        nextMemoryClock = memoryClockPeriod;
-        gpuCycle = 0;
-        shaderCycle = 0;
-        memoryCycle = 0;
-    }
-    else
-    {
-        cycle = 0;
-    }
+    clockScheduler.reset();
     
     while(!endDebug)
     {
@@ -423,7 +464,9 @@ void PerfModel::helpCommand(stringstream &comStream)
     cout << "state         - Displays the current simulator state" << endl;
     cout << "              - Displays information about the simulator boxes state" << endl;
     cout << "savesnapshot  - Saves a snapshot of the GPU state to disk" << endl;
+    cout << "              - Apitrace snapshots also save the trace driver state (ApiTrace.snapshot)" << endl;
     cout << "loadsnapshot  - Loads a snapshot of the GPU state from disk" << endl;
+    cout << "              - Apitrace snapshots restore the OpenGL, GAL and HAL state and seek the trace (D3D9 traces dispatch the previous API calls)" << endl;
     cout << "autosnapshot  - Sets automatic snapshot saves" << endl;
     cout << "memoryUsage   - Displays information about the memory used" << endl;
     cout << "listMDs       - Lists the memory descriptors in the GPU Driver" << endl;
@@ -479,7 +522,7 @@ void PerfModel::runCommand(stringstream &comStream)
         abortDebug = false;
 
         bool end = false;
-        U64 firstCycle = GpuPerfModel.multiClock ? gpuCycle : cycle;
+        U64 firstCycle = clockScheduler.getCycle(0);
         
         //  Simulate n cycles
         while(!end && !endOfTrace && !abortDebug)
@@ -488,8 +531,7 @@ void PerfModel::runCommand(stringstream &comStream)
             advanceTime(endOfBatch, endOfFrame, endOfTrace, gpuStalled, validationError);
             
             //  Check if all the requested cycles were simulated.
-            end = ( GpuPerfModel.multiClock && (gpuCycle == (firstCycle + simCycles))) ||
-                  (!GpuPerfModel.multiClock && (cycle == (firstCycle + simCycles)));
+            end = (clockScheduler.getCycle(0) == (firstCycle + simCycles));
             
                 
             //  End the simulation if a stall was detected.                  
@@ -854,12 +896,12 @@ void PerfModel::stateCommand(stringstream &comStream)
     {
         cout << "Usage: state <boxname> | all" << endl;
 
-        if (!GpuPerfModel.multiClock)
-            cout << "Simulated cycles = " << cycle;
+        if (clockScheduler.getNumDomains() == 1)
+            cout << "Simulated cycles = " << clockScheduler.getCycle(0);
         else
         {
-            cout << "Simulated GPU cycles = " << gpuCycle << " | Simulated Shader cycles = " << shaderCycle;
-            cout << " Simulated Memory cycles = " << memoryCycle;
+            for(U32 d = 0; d < clockScheduler.getNumDomains(); d++)
+                cout << ((d == 0) ? "" : " | ") << "Simulated " << clockScheduler.getName(d) << " cycles = " << clockScheduler.getCycle(d);
         }
         cout << " | Simulated batches = " << batchCounter;
         cout << " | Simulated frames = " << frameCounter;
@@ -870,12 +912,12 @@ void PerfModel::stateCommand(stringstream &comStream)
         //  Read the parameter as a string.
         comStream >> mduName;
 
-        if (!GpuPerfModel.multiClock)
-            cout << "Simulated cycles = " << cycle;
+        if (clockScheduler.getNumDomains() == 1)
+            cout << "Simulated cycles = " << clockScheduler.getCycle(0);
         else
         {
-            cout << "Simulated GPU cycles = " << gpuCycle << " | Simulated Shader cycles = " << shaderCycle;
-            cout << " Simulated Memory cycles = " << memoryCycle;
+            for(U32 d = 0; d < clockScheduler.getNumDomains(); d++)
+                cout << ((d == 0) ? "" : " | ") << "Simulated " << clockScheduler.getName(d) << " cycles = " << clockScheduler.getCycle(d);
         }
         cout << " | Simulated batches = " << batchCounter;
         cout << " | Simulated frames = " << frameCounter;
@@ -1114,6 +1156,9 @@ void PerfModel::emulatorTraceCommand(stringstream &comStream)
                 
                 if (!error)
                 {
+                    //  Wait until the behaviorModel thread emulates the pending MetaStreams.
+                    validationChecker->synchronize();
+
                     //  Check the behaviorModel trace mode to disable/enable.
                     if (!traceMode.compare("all"))
                     {
@@ -1607,6 +1652,23 @@ bool PerfModel::simForcedCommand()
     return !endOfTrace;
 }
 
+bool PerfModel::simTraceDriverCheckpoint()
+{
+    bool endOfBatch = false;
+    bool endOfFrame = false;
+    bool endOfTrace = false;
+    bool gpuStalled = false;
+    bool validationError = false;
+
+    //  Simulate the MetaStreams already generated by the trace driver.
+    while(!TraceDriver->prepareCheckpoint() && !endOfTrace && !gpuStalled && !validationError)
+    {
+        advanceTime(endOfBatch, endOfFrame, endOfTrace, gpuStalled, validationError);
+    }
+
+    return !endOfTrace;
+}
+
 void PerfModel::saveSnapshotCommand()
 {
     pendingSaveSnapshot = true;
@@ -1666,6 +1728,10 @@ void PerfModel::saveSnapshotCommand()
             stringstream commandStream;
             
             printf(" Saving a simulator snapshot in %s directory\n", directoryName);
+
+            //  The trace driver checkpoint is saved at the position of the last MetaStream simulated.
+            if (!simTraceDriverCheckpoint())
+                return;
              
             //  Flush color caches.
             commandStream.clear();
@@ -1708,6 +1774,25 @@ void PerfModel::saveSnapshotCommand()
                 out.close();
             }
 
+            //  Dump API Trace Driver state.
+            if ((TraceDriver->getTraceTyp() == TraceTypOgl) || (TraceDriver->getTraceTyp() == TraceTypD3d))
+            {
+                fstream out;
+
+                out.open("ApiTrace.snapshot", ios::binary | ios::out);
+
+                if (!out.is_open())
+                    CG_ASSERT("Error creating API Trace Driver snapshot file.");
+
+                bool checkpointSaved = TraceDriver->saveCheckpoint(&out);
+
+                out.close();
+
+                //  Without the trace driver state the snapshot is loaded skipping the previous frames.
+                if (!checkpointSaved)
+                    remove("ApiTrace.snapshot");
+            }
+
             GpuPerfModel.Raster->saveHZBuffer();
 
             for(U32 i = 0; i < ArchConf.gpu.numStampUnits; i++)
@@ -1721,7 +1806,10 @@ void PerfModel::saveSnapshotCommand()
             GpuPerfModel.MC->execCommand(commandStream);
         
             if (validationMode)
+            {
+                validationChecker->synchronize();
                 GpuBehavMdl->saveSnapshot();
+            }
             
             if (changeDirectory(workingDirectory) != 0)
                 CG_ASSERT("Error changing back to working directory.");
@@ -1743,7 +1831,11 @@ void PerfModel::loadSnapshotCommand(stringstream &comStream)
     U32 snapshotID;
 
     //  Check if a snapshot can be loaded.
-    if ((!GpuPerfModel.multiClock && (cycle != 0)) || (GpuPerfModel.multiClock && ((gpuCycle != 0) || (shaderCycle != 0) || (memoryCycle != 0))))
+    bool started = false;
+    for(U32 d = 0; d < clockScheduler.getNumDomains(); d++)
+        started = started || (clockScheduler.getCycle(d) != 0);
+
+    if (started)
     {
         cout << "ERROR : loadsnapshot can only be used at cycle 0." << endl;
         return;
@@ -1831,6 +1923,8 @@ void PerfModel::loadSnapshotCommand(stringstream &comStream)
 
                 }
                 
+                bool apiCheckpoint = false;
+
                 if (TraceDriver->getTraceTyp() == TraceTypOgl || TraceDriver->getTraceTyp() == TraceTypD3d)
                 {
                     //  Read the frame and batches to skip from the state snapshot file.
@@ -1851,44 +1945,76 @@ void PerfModel::loadSnapshotCommand(stringstream &comStream)
                     in.ignore(14);      //  Skip "Frame Batch = "
                     in >> savedFrameBatch;  //  Read the saved frame batch.
                     in.close(); 
-                                                            
-                    bool endOfBatch = false;
-                    bool endOfFrame = false;
-                    bool endOfTrace = false;
-                    bool gpuStalled = false;
-                    bool validationError = false;
 
-                    cout << " Skipping up to frame " << savedFrame << " batch " << savedBatch << " frame batch " << savedFrameBatch << endl;
-                    
-                    //  Skip rendering until reaching the saved frame and batch.
-                    GpuPerfModel.CP->setSkipFrames(true);
-                    
-                    if (validationMode)
-                        GpuBehavMdl->GpuBMdl.setSkipBatch(true);
-                    
-                    if (changeDirectory(workingDirectory) != 0)
-                        CG_ASSERT("Error changing back to working directory.");
+                    //  Check if the snapshot stores the API trace driver state.
+                    fstream checkpoint;
 
-                    //  Skip validation until reaching the point where the snapshot was captured.
-                    skipValidation = true;
+                    checkpoint.open("ApiTrace.snapshot", ios::binary | ios::in);
 
-                    //  Simulate until the end of the initialization phase.
-                    while(((frameCounter != savedFrame) || ((batchCounter != savedBatch)) && (frameBatch != savedFrameBatch)) && !endOfTrace)
+                    if (checkpoint.is_open())
                     {
-                        advanceTime(endOfBatch, endOfFrame, endOfTrace, gpuStalled, validationError);
+                        cout << " Restoring the trace driver state at frame " << savedFrame << " batch " << savedBatch << " frame batch " << savedFrameBatch << endl;
+
+                        //  Restore the API, GAL and HAL state and the trace position of the snapshot (D3D9
+                        //  traces dispatch the API calls up to the snapshot without simulating).
+                        if (!TraceDriver->loadCheckpoint(&checkpoint))
+                            CG_ASSERT("The trace driver does not support loading the API Trace Driver snapshot file.");
+
+                        checkpoint.close();
+
+                        frameCounter = savedFrame;
+                        batchCounter = savedBatch;
+                        frameBatch = savedFrameBatch;
+
+                        //  The GPU registers and shader programs are restored after loading the memory.
+                        apiCheckpoint = true;
                     }
-                    
-                    //  Reenable validation.
-                    skipValidation = false;
-                    
-                    //  Restart rendering.
-                    GpuPerfModel.CP->setSkipFrames(false);
+                    else
+                    {
+                        bool endOfBatch = false;
+                        bool endOfFrame = false;
+                        bool endOfTrace = false;
+                        bool gpuStalled = false;
+                        bool validationError = false;
 
-                    if (validationMode)
-                        GpuBehavMdl->GpuBMdl.setSkipBatch(false);
+                        cout << " Skipping up to frame " << savedFrame << " batch " << savedBatch << " frame batch " << savedFrameBatch << endl;
+                        
+                        //  Skip rendering until reaching the saved frame and batch.
+                        GpuPerfModel.CP->setSkipFrames(true);
+                        
+                        if (validationMode)
+                        {
+                            validationChecker->synchronize();
+                            GpuBehavMdl->GpuBMdl.setSkipBatch(true);
+                        }
+                        
+                        if (changeDirectory(workingDirectory) != 0)
+                            CG_ASSERT("Error changing back to working directory.");
 
-                    if (changeDirectory(directoryName) != 0)
-                        CG_ASSERT("Error changing to snapshot directory.");
+                        //  Skip validation until reaching the point where the snapshot was captured.
+                        skipValidation = true;
+
+                        //  Simulate until the end of the initialization phase.
+                        while(((frameCounter != savedFrame) || ((batchCounter != savedBatch) && (frameBatch != savedFrameBatch))) && !endOfTrace)
+                        {
+                            advanceTime(endOfBatch, endOfFrame, endOfTrace, gpuStalled, validationError);
+                        }
+                        
+                        //  Reenable validation.
+                        skipValidation = false;
+                        
+                        //  Restart rendering.
+                        GpuPerfModel.CP->setSkipFrames(false);
+
+                        if (validationMode)
+                        {
+                            validationChecker->synchronize();
+                            GpuBehavMdl->GpuBMdl.setSkipBatch(false);
+                        }
+
+                        if (changeDirectory(directoryName) != 0)
+                            CG_ASSERT("Error changing to snapshot directory.");
+                    }
                 }            
 
                 cout << " Loading state from snapshot" << endl;
@@ -1913,11 +2039,27 @@ void PerfModel::loadSnapshotCommand(stringstream &comStream)
                 if (validationMode)
                 {
                     //  Load behaviorModel snapshot.
+                    validationChecker->synchronize();
                     GpuBehavMdl->loadSnapshot();
                 }
                                 
                 if (changeDirectory(workingDirectory) != 0)
                     CG_ASSERT("Error changing back to working directory.");
+
+                if (apiCheckpoint)
+                {
+                    bool endOfBatch = false;
+                    bool endOfFrame = false;
+                    bool endOfTrace = false;
+                    bool gpuStalled = false;
+                    bool validationError = false;
+
+                    //  Simulate until the GPU registers and the shader programs are restored.
+                    while(!GpuPerfModel.CP->endOfInitialization() && !endOfTrace)
+                    {
+                        advanceTime(endOfBatch, endOfFrame, endOfTrace, gpuStalled, validationError);
+                    }
+                }
             }            
             else
             {
@@ -2005,111 +2147,11 @@ void PerfModel::advanceTime(bool &endOfBatch, bool &endOfFrame, bool &endOfTrace
 {
     current = this;
 
-    bool checkStalls;
-    
-    if (!GpuPerfModel.multiClock)
-    {
-        //  Increment the statistics cycle counter.
-        cyclesCounter->inc();
-        
-        //  Issue a clock for all the simulation boxes.
-        for(U32 mdu = 0; mdu < GpuPerfModel.MduArray.size(); mdu++)
-            GpuPerfModel.MduArray[mdu]->clock(cycle);
-        
-        //  Update the simulator cycle counter.
-        cycle++;
-        
-        //  Evaluate if stall detection must be performed.
-        checkStalls = ArchConf.sim.detectStalls && ((cycle % 100000) == 99999);
-    }
-    else
-    {
-        bool end = false;
-        
-        //  Run at least one cycle of the main (GPU) clock.
-        while(!end)
-        {
-            //  Determine the picoseconds to the next clock.
-            U32 nextStep = GPU_MIN(GPU_MIN(nextGPUClock, nextShaderClock), nextMemoryClock);
-            
-            //printf("Clock -> Next GPU Clock = %d | Next Shader Clock = %d | Next Memory Clock = %d| Next Step = %d | GPU Cycle = %lld | Shader Cycle = %lld | Memory Cycle = %lld\n",
-            //    nextGPUClock, nextShaderClock, nextStep, gpuCycle, shaderCycle, memoryCycle);
-                            
-            //  Update step counters for both clock domains.
-            nextGPUClock -= nextStep;
-            nextShaderClock -= nextStep;
-            nextMemoryClock -= nextStep;
-            
-            //  Check if a gpu domain tick has to be issued.
-            if (nextGPUClock == 0)
-            {
-                GPU_DEBUG(
-                    printf("GPU Domain. Cycle %lld ----------------------------\n", gpuCycle);
-                )
-                
-                // Clock all the boxes in the GPU Domain.
-                for(U32 mdu = 0; mdu < GpuPerfModel.GpuDomainMduArray.size(); mdu++)
-                    GpuPerfModel.GpuDomainMduArray[mdu]->clock(gpuCycle);
-                    
-                //  Clock boxes with multiple domains.
-                for(U32 mdu = 0; mdu < GpuPerfModel.ShaderDomainMduArray.size(); mdu++)
-                    GpuPerfModel.ShaderDomainMduArray[mdu]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
-                    
-                for(U32 mdu = 0; mdu < GpuPerfModel.MemoryDomainMduArray.size(); mdu++)
-                    GpuPerfModel.MemoryDomainMduArray[mdu]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
-
-                //  Update GPU domain clock state.
-                gpuCycle++;
-                nextGPUClock = gpuClockPeriod;
-                
-                //  One cycle of the GPU clock was simulated.
-                end = true;
-            }
-            
-            //  Check if a shader domain tick must be issued.
-            if (nextShaderClock == 0)
-            {
-                if (GpuPerfModel.shaderClockDomain)
-                {
-                    GPU_DEBUG(
-                        printf("Shader Domain. Cycle %lld ----------------------------\n", shaderCycle);
-                    )
-
-                    //  Clock boxes with multiple domains.
-                    for(U32 mdu = 0; mdu < GpuPerfModel.ShaderDomainMduArray.size(); mdu++)
-                        GpuPerfModel.ShaderDomainMduArray[mdu]->clock(SHADER_CLOCK_DOMAIN, shaderCycle);
-
-                    //  Update shader domain clock and step counter.
-                    shaderCycle++;
-                }
-                
-                nextShaderClock = shaderClockPeriod;
-            }
-
-            //  Check if a memory domain tick must be issued.
-            if (nextMemoryClock == 0)
-            {
-                if (GpuPerfModel.memoryClockDomain)
-                {
-                    GPU_DEBUG(
-                        printf("Memory Domain. Cycle %lld ----------------------------\n", memoryCycle);
-                    )
-
-                    //  Clock boxes with multiple domains.
-                    for(U32 mdu = 0; mdu < GpuPerfModel.MemoryDomainMduArray.size(); mdu++)
-                        GpuPerfModel.MemoryDomainMduArray[mdu]->clock(MEMORY_CLOCK_DOMAIN, memoryCycle);
+    //  Simulate one cycle of the main (GPU) clock domain and the ticks of the other domains at the same time.
+    clockMainCycle(true);
 
-                    //  Update memory domain clock and step counter.
-                    memoryCycle++;
-                }
-                
-                nextMemoryClock = memoryClockPeriod;
-            }
-        }
-
-        //  Evaluate if stall detection must be performed.
-        checkStalls = ArchConf.sim.detectStalls && ((gpuCycle % 100000) == 99999);
-    }
+    //  Increment the statistics cycle counter.
+    cyclesCounter->inc();
 
     //  Check if the current batch has finished
     if (GpuPerfModel.CP->endOfBatch())
@@ -2126,852 +2168,111 @@ void PerfModel::advanceTime(bool &endOfBatch, bool &endOfFrame, bool &endOfTrace
         //  Check if validation mode is enabled.
         if (validationMode)
         {
-            //  Get the log of MetaStreams processed by the Command Processor.
-            vector<cgoMetaStream *> &metaStreamLog = GpuPerfModel.CP->getcgoMetaStreamLog();
-            
-            //  Issue the MetaStreams to the behaviorModel.
-            for(U32 trans = 0; trans < metaStreamLog.size(); trans++)
+            //  Get the digest of the batch logs from the behaviorModel (emulated by the validation thread).
+            ValidationDigest *emuDigest = validationChecker->getReference();
+
+            //  Check if validation must be performed.
+            bool validateBatch = !skipValidation && (emuDigest != NULL);
+
+            ValidationDigest simDigest;
+
+            //  Get the read vertex logs from the cmoStreamController Loader units.
+            for(U32 u = 0; u < ArchConf.str.streamerLoaderUnits; u++)
             {
-                GpuBehavMdl->GpuBMdl.emulateCommandProcessor(metaStreamLog[trans]);
+                VertexInputMap &simVertexInputStLLog = GpuPerfModel.StreamController->getVertexInputInfo(u);
+
+                if (validateBatch)
+                    simDigest.addVertexInputs(simVertexInputStLLog);
             }
-            
-            //  Clear the MetaStream log.
-            metaStreamLog.clear();
-                       
-            //  Check if validation must be performed.
-            if (!skipValidation)
+
+            //  Get the shaded vertex log from the simulator.
+            ShadedVertexMap &simShadedVertexLog = GpuPerfModel.StreamController->getShadedVertexInfo();
+
+            if (validateBatch)
+                simDigest.addShadedVertices(simShadedVertexLog);
+
+            //  Get the z stencil memory update logs from the simulator Z Stencil Test units.
+            for(U32 rop = 0; rop < ArchConf.gpu.numStampUnits; rop++)
             {
-                VertexInputMap simVertexInputLog;
-                
-                //  Get the read vertex log from the simulator.            
-                for(U32 u = 0; u < ArchConf.str.streamerLoaderUnits; u++)
-                {
-                    //  Get the read vertex log from one of the cmoStreamController Loader units.
-                    VertexInputMap &simVertexInputStLLog = GpuPerfModel.StreamController->getVertexInputInfo(u);
-                    
-                    //  Rebuild as a single map.
-                    VertexInputMap::iterator itStL;
-                    for(itStL = simVertexInputStLLog.begin(); itStL != simVertexInputStLLog.end(); itStL++)
-                    {
-                        //  Search in the rebuild map.
-                        VertexInputMap::iterator itGlobal;
-                        itGlobal = simVertexInputLog.find(itStL->second.vertexID);
-                        
-                        if (itGlobal != simVertexInputLog.end())
-                        {
-                            //  Check and update.
-                            itGlobal->second.timesRead += itStL->second.timesRead;
-                            
-                            //  Compare the two versions.
-                            bool attributesAreDifferent = false;
-                            
-                            for(U32 a = 0; (a < MAX_VERTEX_ATTRIBUTES) && !attributesAreDifferent; a++)
-                            {
-                                //  Evaluate if the attribute values are different.
-                                attributesAreDifferent = (itGlobal->second.attributes[a][0] != itGlobal->second.attributes[a][0]) ||
-                                                         (itGlobal->second.attributes[a][1] != itGlobal->second.attributes[a][1]) ||
-                                                         (itGlobal->second.attributes[a][2] != itGlobal->second.attributes[a][2]) ||
-                                                         (itGlobal->second.attributes[a][3] != itGlobal->second.attributes[a][3]);
-                            }
-                            
-                            itGlobal->second.differencesBetweenReads = itGlobal->second.differencesBetweenReads || 
-                                                                       itStL->second.differencesBetweenReads ||
-                                                                       attributesAreDifferent;
-                        }
-                        else
-                        {
-                            //  Add a new read vertex to the rebuild map.
-                            simVertexInputLog.insert(make_pair(itStL->second.vertexID, itStL->second));                        
-                        }
-                    }
-                    
-                    //  Clear the map from the cmoStreamController Loader unit.
-                    simVertexInputStLLog.clear();
-                }
-                
-                //  Get the read vertex log from the behaviorModel.
-                VertexInputMap &emuVertexInputLog = GpuBehavMdl->GpuBMdl.getVertexInputLog();
+                FragmentQuadMemoryUpdateMap &simZStencilUpdateROPLog = GpuPerfModel.zStencilV2[rop]->getZStencilUpdateMap();
 
-//printf("Validation >> Simulator Read Vertices = %d | Behavior Model Read Vertices = %d\n", simVertexInputLog.size(),
-//emuVertexInputLog.size());
+                if (validateBatch)
+                    simDigest.addZStencilUpdates(simZStencilUpdateROPLog);
+            }
 
-                //  Compare the two lists.
-                if (simVertexInputLog.size() != emuVertexInputLog.size())
+            //  Get the color memory update logs from the simulator Color Write units.
+            for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+            {
+                for(U32 rop = 0; rop < ArchConf.gpu.numStampUnits; rop++)
                 {
-                    printf("Validation => Number of read vertices is different: behaviorModel = %d simulator = %d\n",
-                        emuVertexInputLog.size(), simVertexInputLog.size());
-                        
-                    validationError = true;               
-                    
-/*VertexInputMap::iterator itVertexInput;
-printf("Validation => Behavior Model read vertex list\n");
-for(itVertexInput = emuVertexInputLog.begin(); itVertexInput != emuVertexInputLog.end(); itVertexInput++)
-printf("Validation => Index %d Instance %d\n", itVertexInput->second.vertexID.index, itVertexInput->second.vertexID.instance);
-printf("Validation => Simulator read vertex list\n");
-for(itVertexInput = simVertexInputLog.begin(); itVertexInput != simVertexInputLog.end(); itVertexInput++)
-printf("Validation => Index %d Instance %d TimesRead %d Diffs Between Reads %s\n",
-itVertexInput->second.vertexID.index, itVertexInput->second.vertexID.instance,
-itVertexInput->second.timesRead, itVertexInput->second.differencesBetweenReads ? "T" : "F");*/
+                    FragmentQuadMemoryUpdateMap &simColorUpdateROPLog = GpuPerfModel.colorWriteV2[rop]->getColorUpdateMap(rt);
+
+                    //  Use the render target format of the behaviorModel at the end of the batch.
+                    if (validateBatch)
+                        simDigest.addColorUpdates(rt, simColorUpdateROPLog, emuDigest->colorBytesPixel[rt]);
                 }
-                
-                VertexInputMap::iterator itVertexInputEmu;
-                
-                for(itVertexInputEmu = emuVertexInputLog.begin(); itVertexInputEmu != emuVertexInputLog.end(); itVertexInputEmu++)
-                {
-                    //  Find index in the simulator log.
-                    VertexInputMap::iterator itVertexInputSim;
-                    
-                    itVertexInputSim = simVertexInputLog.find(itVertexInputEmu->second.vertexID);
-                    
-                    //  Check if the index was found in the simulator log.
-                    if (itVertexInputSim != simVertexInputLog.end())
-                    {
-                        //  Compare all the attributes.
-                        for(U32 a = 0; a < MAX_VERTEX_ATTRIBUTES; a++)
-                        {
-                            bool attributeIsEqual =                             
-                                ((itVertexInputEmu->second.attributes[a][0] == itVertexInputSim->second.attributes[a][0]) ||
-                                 (NaN(itVertexInputEmu->second.attributes[a][0]) && NaN(itVertexInputSim->second.attributes[a][0]))) &&
-                                ((itVertexInputEmu->second.attributes[a][1] == itVertexInputSim->second.attributes[a][1]) ||
-                                 (NaN(itVertexInputEmu->second.attributes[a][1]) && NaN(itVertexInputSim->second.attributes[a][1]))) &&
-                                ((itVertexInputEmu->second.attributes[a][2] == itVertexInputSim->second.attributes[a][2]) ||
-                                 (NaN(itVertexInputEmu->second.attributes[a][2]) && NaN(itVertexInputSim->second.attributes[a][2]))) &&
-                                ((itVertexInputEmu->second.attributes[a][3] == itVertexInputSim->second.attributes[a][3]) ||
-                                 (NaN(itVertexInputEmu->second.attributes[a][3]) && NaN(itVertexInputSim->second.attributes[a][3])));
-
-                            if (!attributeIsEqual)
-                            {
-                                F32 attrib[4];
+            }
 
-                                attrib[0] = itVertexInputEmu->second.attributes[a][0];
-                                attrib[1] = itVertexInputEmu->second.attributes[a][1];
-                                attrib[2] = itVertexInputEmu->second.attributes[a][2];
-                                attrib[3] = itVertexInputEmu->second.attributes[a][3];
-                                
-                                printf("Validation => For read vertex at instance %d with index %d attribute %d is different:\n",
-                                    itVertexInputEmu->second.vertexID.instance, itVertexInputEmu->second.vertexID.index, a);
-                                printf("   emuAttrib[%d] = {%f, %f, %f, %f} | (%08x, %08x, %08x, %08x)\n", a,
-                                    itVertexInputEmu->second.attributes[a][0], itVertexInputEmu->second.attributes[a][1],
-                                    itVertexInputEmu->second.attributes[a][2], itVertexInputEmu->second.attributes[a][3],
-                                    ((U32 *)attrib)[0], ((U32 *)attrib)[1], ((U32 *)attrib)[2], ((U32 *)attrib)[3]);
-
-                                attrib[0] = itVertexInputSim->second.attributes[a][0];
-                                attrib[1] = itVertexInputSim->second.attributes[a][1];
-                                attrib[2] = itVertexInputSim->second.attributes[a][2];
-                                attrib[3] = itVertexInputSim->second.attributes[a][3];
-
-                                printf("   simAttrib[%d] = {%f, %f, %f, %f} | (%08x, %08x, %08x, %08x)\n", a,
-                                    itVertexInputSim->second.attributes[a][0], itVertexInputSim->second.attributes[a][1],
-                                    itVertexInputSim->second.attributes[a][2], itVertexInputSim->second.attributes[a][3],
-                                    ((U32 *)attrib)[0], ((U32 *)attrib)[1], ((U32 *)attrib)[2], ((U32 *)attrib)[3]);
-                                
-                                validationError = true;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        printf("Validation => Instance %d index %d was not found in the simulator read vertex log.\n",
-                            itVertexInputEmu->second.vertexID.instance, itVertexInputEmu->second.vertexID.index);
+            bool batchDiffers = false;
 
-                        validationError = true;
-                    }
-                }
-                
-                if (simVertexInputLog.size() > emuVertexInputLog.size())
-                {
-                    VertexInputMap::iterator itVertexInputSim;
-                    
-                    for(itVertexInputSim = simVertexInputLog.begin(); itVertexInputSim != simVertexInputLog.end(); itVertexInputSim++)
-                    {
-                        //  Find index in the behaviorModel log.
-                        itVertexInputEmu = emuVertexInputLog.find(itVertexInputSim->second.vertexID);
-                        
-                        //  Check if the index was found in the behaviorModel log.
-                        if (itVertexInputEmu == emuVertexInputLog.end())
-                        {
-                            printf("Validation => Instance %d index %d was not found in the behaviorModel read vertex log.\n",
-                                itVertexInputSim->second.vertexID.instance, itVertexInputSim->second.vertexID.index);
+            if (validateBatch)
+            {
+                simDigest.close();
 
-                            validationError = true;
-                        }
-                    }
-                }
-                
-                //  Clear the log maps.
-                emuVertexInputLog.clear();
-                simVertexInputLog.clear();
+                //  Compare the simulator and behaviorModel logs for the batch.
+                batchDiffers = !ValidationChecker::compare(batchCounter, *emuDigest, simDigest);
             }
-            else
+
+            //  Clear the simulator logs.  When the batch differs the logs are first gathered in the digest
+            //  (keeping the first entry per vertex or quad, as the digest does) for the field by field comparison.
+            for(U32 u = 0; u < ArchConf.str.streamerLoaderUnits; u++)
             {
-                //  Get the read vertex log from the behaviorModel.
-                VertexInputMap &emuVertexInputLog = GpuBehavMdl->GpuBMdl.getVertexInputLog();
-                
-                //  Clear the log maps.
-                emuVertexInputLog.clear();
+                VertexInputMap &simVertexInputStLLog = GpuPerfModel.StreamController->getVertexInputInfo(u);
+
+                if (batchDiffers)
+                    simDigest.vertexInputLog.insert(simVertexInputStLLog.begin(), simVertexInputStLLog.end());
+
+                simVertexInputStLLog.clear();
             }
-            
 
-            //  Check if validation must be performed.
-            if (!skipValidation)
+            if (batchDiffers)
+                simDigest.shadedVertexLog.swap(simShadedVertexLog);
+
+            simShadedVertexLog.clear();
+
+            for(U32 rop = 0; rop < ArchConf.gpu.numStampUnits; rop++)
             {
-                //  Get the shaded vertex log from the simulator.
-                ShadedVertexMap &simShadedVertexLog = GpuPerfModel.StreamController->getShadedVertexInfo();
-                
-                //  Get the shaded vertex log from the behaviorModel.
-                ShadedVertexMap &emuShadedVertexLog = GpuBehavMdl->GpuBMdl.getShadedVertexLog();
-                
-                
-//printf("Validation >> Simulator Shaded Vertices = %d | Behavior Model Shaded Vertices = %d\n", simShadedVertexLog.size(),
-//emuShadedVertexLog.size());
+                FragmentQuadMemoryUpdateMap &simZStencilUpdateROPLog = GpuPerfModel.zStencilV2[rop]->getZStencilUpdateMap();
 
-                //  Compare the two lists.
-                if (simShadedVertexLog.size() != emuShadedVertexLog.size())
-                {
-                    printf("Validation => Number of shaded vertices is different: behaviorModel = %d simulator = %d\n",
-                        emuShadedVertexLog.size(), simShadedVertexLog.size());
-                    validationError = true;
-                }
+                if (batchDiffers)
+                    simDigest.zStencilUpdateLog.insert(simZStencilUpdateROPLog.begin(), simZStencilUpdateROPLog.end());
 
-                ShadedVertexMap::iterator itEmu;
-                
-                for(itEmu = emuShadedVertexLog.begin(); itEmu != emuShadedVertexLog.end(); itEmu++)
+                simZStencilUpdateROPLog.clear();
+            }
+
+            for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
+            {
+                for(U32 rop = 0; rop < ArchConf.gpu.numStampUnits; rop++)
                 {
-                    //  Find index in the simulator log.
-                    ShadedVertexMap::iterator itSim;
-                    
-                    itSim = simShadedVertexLog.find(itEmu->second.vertexID);
-                    
-                    //  Check if the index was found in the simulator log.
-                    if (itSim != simShadedVertexLog.end())
-                    {
-                        //  Compare all the attributes.
-                        for(U32 a = 0; a < MAX_VERTEX_ATTRIBUTES; a++)
-                        {
-                            bool attributeIsEqual =
-                                ((itEmu->second.attributes[a][0] == itSim->second.attributes[a][0]) ||
-                                 (NaN(itEmu->second.attributes[a][0]) && NaN(itSim->second.attributes[a][0]))) &&
-                                ((itEmu->second.attributes[a][1] == itSim->second.attributes[a][1]) ||
-                                 (NaN(itEmu->second.attributes[a][1]) && NaN(itSim->second.attributes[a][1]))) &&
-                                ((itEmu->second.attributes[a][2] == itSim->second.attributes[a][2]) ||
-                                 (NaN(itEmu->second.attributes[a][2]) && NaN(itSim->second.attributes[a][2]))) &&
-                                ((itEmu->second.attributes[a][3] == itSim->second.attributes[a][3]) ||
-                                 (NaN(itEmu->second.attributes[a][3]) && NaN(itSim->second.attributes[a][3])));
-
-                            if (!attributeIsEqual)
-                            {
-                                F32 attrib[4];
+                    FragmentQuadMemoryUpdateMap &simColorUpdateROPLog = GpuPerfModel.colorWriteV2[rop]->getColorUpdateMap(rt);
 
-                                attrib[0] = itEmu->second.attributes[a][0];
-                                attrib[1] = itEmu->second.attributes[a][1];
-                                attrib[2] = itEmu->second.attributes[a][2];
-                                attrib[3] = itEmu->second.attributes[a][3];
-                                
-                                printf("Validation => For shaded vertex at instance %d index %d attribute %d is different:\n",
-                                    itEmu->second.vertexID.instance, itEmu->second.vertexID.index, a);
-                                printf("   emuAttrib[%d] = {%f, %f, %f, %f} | (%08x, %08x, %08x, %08x)\n", a,
-                                    itEmu->second.attributes[a][0], itEmu->second.attributes[a][1],
-                                    itEmu->second.attributes[a][2], itEmu->second.attributes[a][3],
-                                    ((U32 *)attrib)[0], ((U32 *)attrib)[1], ((U32 *)attrib)[2], ((U32 *)attrib)[3]);
-                                printf("   simAttrib[%d] = {%f, %f, %f, %f} | (%08x, %08x, %08x, %08x)\n", a,
-                                    itSim->second.attributes[a][0], itSim->second.attributes[a][1],
-                                    itSim->second.attributes[a][2], itSim->second.attributes[a][3],
-                                    ((U32 *)attrib)[0], ((U32 *)attrib)[1], ((U32 *)attrib)[2], ((U32 *)attrib)[3]);
-
-                                validationError = true;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        printf("Validation => Instance %d Index %d was not found in the simulator shaded vertex log.\n",
-                            itEmu->second.vertexID.instance, itEmu->second.vertexID.index);
+                    if (batchDiffers)
+                        simDigest.colorUpdateLog[rt].insert(simColorUpdateROPLog.begin(), simColorUpdateROPLog.end());
 
-                        validationError = true;
-                    }
+                    simColorUpdateROPLog.clear();
                 }
-                
-                if (simShadedVertexLog.size() > emuShadedVertexLog.size())
-                {
-                    ShadedVertexMap::iterator itSim;
-                    
-                    for(itSim = simShadedVertexLog.begin(); itSim != simShadedVertexLog.end(); itSim++)
-                    {
-                        //  Find index in the behaviorModel log.
-                        itEmu = emuShadedVertexLog.find(itSim->second.vertexID);
-                        
-                        //  Check if the index was found in the behaviorModel log.
-                        if (itEmu == emuShadedVertexLog.end())
-                        {
-                            printf("Validation => Instance %d Index %d was not found in the behaviorModel shaded vertex log.\n",
-                                itSim->second.vertexID.instance, itSim->second.vertexID.index);
+            }
 
-                            validationError = true;
-                        }
-                    }
-                }
-                
-                
-                //  Clear the log maps.
-                emuShadedVertexLog.clear();
-                simShadedVertexLog.clear();
-
-                //  Get the z stencil memory update log from the behaviorModel.
-                FragmentQuadMemoryUpdateMap &emuZStencilUpdateLog = GpuBehavMdl->GpuBMdl.getZStencilUpdateMap();
-                               
-                FragmentQuadMemoryUpdateMap simZStencilUpdateLog;
-                
-                //  Get the z stencil memory update logs from the simulator Z Stencil Test units.
-                for(U32 rop = 0; rop < ArchConf.gpu.numStampUnits; rop++)
-                {
-                    //  Get the z stencil memory update log from the z stencil test unit.
-                    FragmentQuadMemoryUpdateMap &simZStencilUpdateROPLog = GpuPerfModel.zStencilV2[rop]->getZStencilUpdateMap();
-                    
-                    FragmentQuadMemoryUpdateMap::iterator it;
-
-                    //  Retrieve the updates from the z stencil unit.
-                    for(it = simZStencilUpdateROPLog.begin(); it != simZStencilUpdateROPLog.end(); it++)
-                        simZStencilUpdateLog.insert(make_pair(it->first, it->second));
-                    
-                    //  Clear the z stencil update log.
-                    simZStencilUpdateROPLog.clear();
-                }
-                
-//printf("Validation >> Simulator ZST Updates = %d | Behavior Model ZST Updates = %d\n", simZStencilUpdateLog.size(),
-//emuZStencilUpdateLog.size());
-
-                //  Check the number of updates.
-                if (simZStencilUpdateLog.size() != emuZStencilUpdateLog.size())
-                {
-                    printf("Validation => Number of updates to Z Stencil Buffer differs: behaviorModel %d simulator %d\n",
-                        emuZStencilUpdateLog.size(), simZStencilUpdateLog.size());
-                
-                    validationError = true;
-                }
-                
-                
-                FragmentQuadMemoryUpdateMap::iterator itZStencilUpdateEmu;
-                
-                U32 maxDifferences = 30;
-                
-                U32 checkedQuads = 0;
-                
-                //  Traverse the whole update log and search differences.
-                for(itZStencilUpdateEmu = emuZStencilUpdateLog.begin();
-                    itZStencilUpdateEmu != emuZStencilUpdateLog.end() && (maxDifferences > 0); itZStencilUpdateEmu++)
-                {
-                    FragmentQuadMemoryUpdateMap::iterator itZStencilUpdateSim;
-                    
-                    //  Search the update in the simulator log.
-                    itZStencilUpdateSim = simZStencilUpdateLog.find(itZStencilUpdateEmu->first);
-                    
-                    if (itZStencilUpdateSim == simZStencilUpdateLog.end())
-                    {
-                        printf("Validation => Z Stencil memory update on quad at (%d, %d) triangle %d not found in the simulator log.\n",   
-                            itZStencilUpdateEmu->first.x, itZStencilUpdateEmu->first.y, itZStencilUpdateEmu->first.triangleID);
-                        
-                        maxDifferences--;
-                    }
-                    else
-                    {
-                        //  Compare the two updates.
-                        
-                        bool diffInReadData = false;                        
-                        U32 bytesPixel = 4;
-                        
-                        //  Compare read data.
-                        for(U32 qw = 0; (qw < ((bytesPixel * STAMP_FRAGMENTS)) >> 3) && !diffInReadData; qw++)
-                            diffInReadData = (((U64 *) itZStencilUpdateEmu->second.readData)[qw] != ((U64 *) itZStencilUpdateSim->second.readData)[qw]);
-                        
-                        bool diffInWriteData = false;
-                        
-                        //  Compare write data.
-                        for(U32 qw = 0; (qw < ((bytesPixel * STAMP_FRAGMENTS)) >> 3) && !diffInWriteData; qw++)
-                            diffInWriteData = (((U64 *) itZStencilUpdateEmu->second.writeData)[qw] != ((U64 *) itZStencilUpdateSim->second.writeData)[qw]);
-                    
-                        if (diffInReadData)
-                            printf("Validation => Difference found in z stencil read data for the update on quad at (%d, %d) triangle %d\n",
-                                itZStencilUpdateEmu->first.x, itZStencilUpdateEmu->first.y, itZStencilUpdateEmu->first.triangleID);
-
-                        if (diffInWriteData)
-                            printf("Validation => Difference found in z stencil write data for the update on quad at (%d, %d) triangle %d\n",
-                                itZStencilUpdateEmu->first.x, itZStencilUpdateEmu->first.y, itZStencilUpdateEmu->first.triangleID);
-                                
-                        if (diffInReadData || diffInWriteData)
-                        {
-                            printf("  Behavior Model Update : \n");
-                            printf("    Read Data : ");
-                            for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                            {
-                                printf("  %08x", ((U32 *) itZStencilUpdateEmu->second.readData)[dw]);
-                            }
-                            printf("\n");
-                            printf("    Input Data : ");
-                            for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                            {
-                                printf("  %08x", ((U32 *) itZStencilUpdateEmu->second.inData)[dw]);
-                            }
-                            printf("\n");
-                            printf("    Write Data : ");
-                            for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                            {
-                                printf("  %08x", ((U32 *) itZStencilUpdateEmu->second.writeData)[dw]);
-                            }
-                            printf("\n");
-                            printf("    Write Mask : ");
-                            for(U32 b = 0; b < (bytesPixel * STAMP_FRAGMENTS); b++)
-                            {
-                                printf(" %c", itZStencilUpdateEmu->second.writeMask[b] ? 'W' : '_');
-                            }
-                            printf("\n");
-                            printf("    Cull Mask : ");
-                            for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                            {
-                                printf(" %c", itZStencilUpdateEmu->second.cullMask[f] ? 'T' : 'F');
-                            }
-                            printf("\n");
-                            
-                            printf("  Simulator Update : \n");
-                            printf("    Read Data : ");
-                            for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                            {
-                                printf("  %08x", ((U32 *) itZStencilUpdateSim->second.readData)[dw]);
-                            }
-                            printf("\n");
-                            printf("    Input Data : ");
-                            for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                            {
-                                printf("  %08x", ((U32 *) itZStencilUpdateSim->second.inData)[dw]);
-                            }
-                            printf("\n");
-                            printf("    Write Data : ");
-                            for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                            {
-                                printf("  %08x", ((U32 *) itZStencilUpdateSim->second.writeData)[dw]);
-                            }
-                            printf("\n");
-                            printf("    Write Mask : ");
-                            for(U32 b = 0; b < (bytesPixel * STAMP_FRAGMENTS); b++)
-                            {
-                                printf(" %c", itZStencilUpdateSim->second.writeMask[b] ? 'W' : '_');
-                            }
-                            printf("\n");
-                            printf("    Cull Mask : ");
-                            for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                            {
-                                printf(" %c", itZStencilUpdateSim->second.cullMask[f] ? 'T' : 'F');
-                            }
-                            printf("\n");
-
-                            maxDifferences--;
-                            
-                            validationError = true;
-                        }
-                    }
-                    
-                    if (maxDifferences == 0)
-                        printf("-- Reached maximum difference log limit  --\n");
-                        
-                    checkedQuads++;
-                }
-                
-                //printf("Validation => Checked %d quads at Z Stencil stage\n", checkedQuads);
-
-                //  Check the number of updates.
-                if (simZStencilUpdateLog.size() > emuZStencilUpdateLog.size())
-                {
-                    FragmentQuadMemoryUpdateMap::iterator itZStencilUpdateSim;
-                    
-                    U32 maxDifferences = 30;
-                    
-                    U32 checkedQuads = 0;
-                    
-                    //  Traverse the whole update log and search differences.
-                    for(itZStencilUpdateSim = simZStencilUpdateLog.begin();
-                        itZStencilUpdateSim != simZStencilUpdateLog.end() && (maxDifferences > 0); itZStencilUpdateSim++)
-                    {
-                        //  Search the update in the behaviorModel log.
-                        itZStencilUpdateEmu = emuZStencilUpdateLog.find(itZStencilUpdateSim->first);
-                        
-                        if (itZStencilUpdateEmu == emuZStencilUpdateLog.end())
-                        {
-                            printf("Validation => Z Stencil memory update on quad at (%d, %d) triangle %d not found in the behaviorModel log.\n",   
-                                itZStencilUpdateSim->first.x, itZStencilUpdateSim->first.y, itZStencilUpdateSim->first.triangleID);
-                            
-                            maxDifferences--;
-                        }
-                    }
-                }                
-                
-                //  Clear the z stencil memory update log.
-                emuZStencilUpdateLog.clear();
-                simZStencilUpdateLog.clear();
-                
-                for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
-                {
-                    //  Get the color memory update log from the behaviorModel.
-                    FragmentQuadMemoryUpdateMap &emuColorUpdateLog = GpuBehavMdl->GpuBMdl.getColorUpdateMap(rt);
-                    
-                    FragmentQuadMemoryUpdateMap simColorUpdateLog;
-
-                    //  Get the color memory update logs from the simulator Color Write units.
-                    for(U32 rop = 0; rop < ArchConf.gpu.numStampUnits; rop++)
-                    {
-                        //  Get the color memory update log from the color test unit.
-                        FragmentQuadMemoryUpdateMap &simColorUpdateROPLog = GpuPerfModel.colorWriteV2[rop]->getColorUpdateMap(rt);
-                        
-                        FragmentQuadMemoryUpdateMap::iterator it;
-
-                        //  Retrieve the updates from the color write unit.
-                        for(it = simColorUpdateROPLog.begin(); it != simColorUpdateROPLog.end(); it++)
-                            simColorUpdateLog.insert(make_pair(it->first, it->second));
-                        
-                        //  Clear the z stencil update log.
-                        simColorUpdateROPLog.clear();
-                    }
-                                       
-//printf("Validation >> Render Target = %d | Simulator CW Updates = %d | Behavior Model CW Updates = %d\n", rt, simColorUpdateLog.size(),
-//emuColorUpdateLog.size());
-
-                    //  Check the number of updates.
-                    if (simColorUpdateLog.size() != emuColorUpdateLog.size())
-                    {
-                        printf("Validation => Number of updates to Color Write Buffer differs: behaviorModel %d simulator %d\n",
-                            emuColorUpdateLog.size(), simColorUpdateLog.size());
-                    
-                        validationError = true;
-                    }
-                    
-                    FragmentQuadMemoryUpdateMap::iterator itColorUpdateEmu;
-                    
-                    U32 maxDifferences = 30;
-                    
-                    U32 checkedQuads = 0;
-                    
-                    TextureFormat rtFormat = GpuBehavMdl->GpuBMdl.getRenderTargetFormat(rt);
-                    
-                    //  Traverse the whole update log and search differences.
-                    for(itColorUpdateEmu = emuColorUpdateLog.begin();
-                        itColorUpdateEmu != emuColorUpdateLog.end() && (maxDifferences > 0); itColorUpdateEmu++)
-                    {
-                        FragmentQuadMemoryUpdateMap::iterator itColorUpdateSim;
-                        
-                        //  Search the update in the simulator log.
-                        itColorUpdateSim = simColorUpdateLog.find(itColorUpdateEmu->first);
-                        
-                        if (itColorUpdateSim == simColorUpdateLog.end())
-                        {
-                            printf("Validation => Color memory update on quad at (%d, %d) triangle %d not found in the simulator log.\n",   
-                                itColorUpdateEmu->first.x, itColorUpdateEmu->first.y, itColorUpdateEmu->first.triangleID);
-                        
-                            //  Compare the two updates.
-                            
-                            U32 bytesPixel;
-                            
-                            switch(rtFormat)
-                            {
-                                case GPU_RGBA8888:
-                                case GPU_RG16F:
-                                case GPU_R32F:
-                                    bytesPixel = 4;
-                                    break;
-                                case GPU_RGBA16:
-                                case GPU_RGBA16F:
-                                    bytesPixel = 8;
-                                    break;
-                                default:
-                                    CG_ASSERT("Unsupported render target format\n");
-                            }
-                            
-                            printf("  Behavior Model Update : \n");
-                            printf("    Read Data : ");
-                            for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                            {
-                                printf("  %08x", ((U32 *) itColorUpdateEmu->second.readData)[dw]);
-                            }
-                            printf("\n");
-                            printf("    Input Data : ");
-                            for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                            {
-                                printf("  (%f, %f, %f, %f) ", ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 0],
-                                                              ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 1],
-                                                              ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 2],
-                                                              ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 3]);
-                            }
-                            printf("\n");
-                            printf("    Write Data : ");
-                            if (rtFormat == GPU_RGBA8888)
-                            {
-                                for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                                {
-                                    printf("  %08x", ((U32 *) itColorUpdateEmu->second.writeData)[dw]);
-                                }
-                            }
-                            printf("\n");
-                            printf("    Write Mask : ");
-                            for(U32 b = 0; b < (bytesPixel * STAMP_FRAGMENTS); b++)
-                            {
-                                printf(" %c", itColorUpdateEmu->second.writeMask[b] ? 'W' : '_');
-                            }
-                            printf("\n");
-                            printf("    Cull Mask : ");
-                            for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                            {
-                                printf(" %c", itColorUpdateEmu->second.cullMask[f] ? 'T' : 'F');
-                            }
-                            printf("\n");
-                            
-                            maxDifferences--;
-                        }
-                        else
-                        {
-                            //  Compare the two updates.
-                            
-                            U32 bytesPixel;
-                            
-                            switch(rtFormat)
-                            {
-                                case GPU_RGBA8888:
-                                case GPU_RG16F:
-                                case GPU_R32F:
-                                    bytesPixel = 4;
-                                    break;
-                                case GPU_RGBA16:
-                                case GPU_RGBA16F:
-                                    bytesPixel = 8;
-                                    break;
-                                default:
-                                    CG_ASSERT("Unsupported render target format\n");
-                            }
-
-                            bool diffInReadData = false;
-                            
-                            //  Compare read data.
-                            for(U32 qw = 0; (qw < ((bytesPixel * STAMP_FRAGMENTS)) >> 3) && !diffInReadData; qw++)
-                                diffInReadData = (((U64 *) itColorUpdateEmu->second.readData)[qw] != ((U64 *) itColorUpdateSim->second.readData)[qw]);
-                                                        
-                            bool diffInWriteData = false;
-                            
-                            //  Compare write data.
-                            for(U32 qw = 0; (qw < ((bytesPixel * STAMP_FRAGMENTS)) >> 3) && !diffInWriteData; qw++)
-                                diffInWriteData = (((U64 *) itColorUpdateEmu->second.writeData)[qw] != ((U64 *) itColorUpdateSim->second.writeData)[qw]);
-                        
-                            if (diffInReadData)
-                                printf("Validation => Difference found in color read data for the update on quad at (%d, %d) triangle %d\n",
-                                    itColorUpdateEmu->first.x, itColorUpdateEmu->first.y, itColorUpdateEmu->first.triangleID);
-
-                            if (diffInWriteData)
-                                printf("Validation => Difference found in color write data for the update on quad at (%d, %d) triangle %d\n",
-                                    itColorUpdateEmu->first.x, itColorUpdateEmu->first.y, itColorUpdateEmu->first.triangleID);
-                                    
-                            if (diffInReadData || diffInWriteData)
-                            {
-                                printf("  Behavior Model Update : \n");
-                                printf("    Read Data : ");
-                                for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                                {
-                                    printf("  %08x", ((U32 *) itColorUpdateEmu->second.readData)[dw]);
-                                }
-                                printf("\n");
-                                printf("    Input Data : ");
-                                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                                {
-                                    printf("  (%f, %f, %f, %f) ", ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 0],
-                                                                  ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 1],
-                                                                  ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 2],
-                                                                  ((F32 *) itColorUpdateEmu->second.inData)[f * 4 + 3]);
-                                }
-                                printf("\n");
-                                printf("    Write Data : ");
-                                if (rtFormat == GPU_RGBA8888)
-                                {
-                                    for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                                    {
-                                        printf("  %08x", ((U32 *) itColorUpdateEmu->second.writeData)[dw]);
-                                    }
-                                }
-                                printf("\n");
-                                printf("    Write Mask : ");
-                                for(U32 b = 0; b < (bytesPixel * STAMP_FRAGMENTS); b++)
-                                {
-                                    printf(" %c", itColorUpdateEmu->second.writeMask[b] ? 'W' : '_');
-                                }
-                                printf("\n");
-                                printf("    Cull Mask : ");
-                                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                                {
-                                    printf(" %c", itColorUpdateEmu->second.cullMask[f] ? 'T' : 'F');
-                                }
-                                printf("\n");
-                                
-                                printf("  Simulator Update : \n");
-                                printf("    Read Data : ");
-                                if (rtFormat == GPU_RGBA8888)
-                                {
-                                    for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                                    {
-                                        printf("  %08x", ((U32 *) itColorUpdateSim->second.readData)[dw]);
-                                    }
-                                }
-                                printf("\n");
-                                printf("    Input Data : ");
-                                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                                {
-                                    printf("  (%f, %f, %f, %f) ", ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 0],
-                                                                  ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 1],
-                                                                  ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 2],
-                                                                  ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 3]);
-                                }
-                                printf("\n");
-                                printf("    Write Data : ");
-                                if (rtFormat == GPU_RGBA8888)
-                                {
-                                    for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                                    {
-                                        printf("  %08x", ((U32 *) itColorUpdateSim->second.writeData)[dw]);
-                                    }
-                                }
-                                printf("\n");
-                                printf("    Write Mask : ");
-                                for(U32 b = 0; b < (bytesPixel * STAMP_FRAGMENTS); b++)
-                                {
-                                    printf(" %c", itColorUpdateSim->second.writeMask[b] ? 'W' : '_');
-                                }
-                                printf("\n");
-                                printf("    Cull Mask : ");
-                                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                                {
-                                    printf(" %c", itColorUpdateSim->second.cullMask[f] ? 'T' : 'F');
-                                }
-                                printf("\n");
+            if (batchDiffers)
+            {
+                //  Report the differences between the logs.
+                ValidationChecker::compareFields(batchCounter, *emuDigest, simDigest);
 
-                                maxDifferences--;
-                                
-                                validationError = true;
-                            }
-                        }
-                        
-                        checkedQuads++;
-                    
-                        if (maxDifferences == 0)
-                            printf("-- Reached maximum difference log limit  --\n");
-                    }
-                    
-                    //  Check the number of updates.
-                    if (simColorUpdateLog.size() > emuColorUpdateLog.size())
-                    {
-                        FragmentQuadMemoryUpdateMap::iterator itColorUpdateSim;
-                        
-                        U32 maxDifferences = 30;
-                        
-                        U32 checkedQuads = 0;
-                        
-                        TextureFormat rtFormat = GpuBehavMdl->GpuBMdl.getRenderTargetFormat(rt);
-                        
-                        //  Traverse the whole update log and search differences.
-                        for(itColorUpdateSim = simColorUpdateLog.begin();
-                            itColorUpdateSim != simColorUpdateLog.end() && (maxDifferences > 0); itColorUpdateSim++)
-                        {
-                            //  Search the update in the behaviorModel log.
-                            itColorUpdateEmu = emuColorUpdateLog.find(itColorUpdateSim->first);
-                            
-                            if (itColorUpdateEmu == emuColorUpdateLog.end())
-                            {
-                                printf("Validation => Color memory update on quad at (%d, %d) triangle %d not found in the behaviorModel log.\n",   
-                                    itColorUpdateSim->first.x, itColorUpdateSim->first.y, itColorUpdateSim->first.triangleID);
-                            
-                                //  Compare the two updates.
-                                
-                                U32 bytesPixel;
-                                
-                                switch(rtFormat)
-                                {
-                                    case GPU_RGBA8888:
-                                    case GPU_RG16F:
-                                    case GPU_R32F:
-                                        bytesPixel = 4;
-                                        break;
-                                    case GPU_RGBA16:
-                                    case GPU_RGBA16F:
-                                        bytesPixel = 8;
-                                        break;
-                                    default:
-                                        CG_ASSERT("Unsupported render target format\n");
-                                }
-                                
-                                printf("  Simulator Update : \n");
-                                printf("    Read Data : ");
-                                for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                                {
-                                    printf("  %08x", ((U32 *) itColorUpdateSim->second.readData)[dw]);
-                                }
-                                printf("\n");
-                                printf("    Input Data : ");
-                                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                                {
-                                    printf("  (%f, %f, %f, %f) ", ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 0],
-                                                                  ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 1],
-                                                                  ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 2],
-                                                                  ((F32 *) itColorUpdateSim->second.inData)[f * 4 + 3]);
-                                }
-                                printf("\n");
-                                printf("    Write Data : ");
-                                if (rtFormat == GPU_RGBA8888)
-                                {
-                                    for(U32 dw = 0; dw < ((bytesPixel * STAMP_FRAGMENTS) >> 2); dw++)
-                                    {
-                                        printf("  %08x", ((U32 *) itColorUpdateSim->second.writeData)[dw]);
-                                    }
-                                }
-                                printf("\n");
-                                printf("    Write Mask : ");
-                                for(U32 b = 0; b < (bytesPixel * STAMP_FRAGMENTS); b++)
-                                {
-                                    printf(" %c", itColorUpdateSim->second.writeMask[b] ? 'W' : '_');
-                                }
-                                printf("\n");
-                                printf("    Cull Mask : ");
-                                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
-                                {
-                                    printf(" %c", itColorUpdateSim->second.cullMask[f] ? 'T' : 'F');
-                                }
-                                printf("\n");
-                                
-                                maxDifferences--;
-                            }
-                        }
-                    }
-                    
-                    //printf("Validation => Checked %d quads at Color Write stage\n", checkedQuads);
-                    
-                    //  Clear the color memory update log.
-                    emuColorUpdateLog.clear();
-                    simColorUpdateLog.clear();
-                }
+                printf("Validation => Batch %d (frame %d batch %d) differs from the behaviorModel.\n", batchCounter, frameCounter, frameBatch);
+                validationError = true;
             }
-            else
-            {
-                //  Get the shaded vertex log from the behaviorModel.
-                ShadedVertexMap &emuShadedVertexLog = GpuBehavMdl->GpuBMdl.getShadedVertexLog();
-                
-                //  Clear the log maps.
-                emuShadedVertexLog.clear();
 
-                //  Get the z stencil memory update log from the behaviorModel.
-                FragmentQuadMemoryUpdateMap &emuZStencilUpdateLog = GpuBehavMdl->GpuBMdl.getZStencilUpdateMap();
-                
-                //  Clear the z stencil memory update log.
-                emuZStencilUpdateLog.clear();
-                
-                for(U32 rt = 0; rt < MAX_RENDER_TARGETS; rt++)
-                {
-                    //  Get the color memory update log from the behaviorModel.
-                    FragmentQuadMemoryUpdateMap &emuColorUpdateLog = GpuBehavMdl->GpuBMdl.getColorUpdateMap(rt);
-                    
-                    //  Clear the color memory ypdate log.
-                    emuColorUpdateLog.clear();
-                }
-            }                          
+            delete emuDigest;
         }
         
         //  Check if auto snapshot is enabled and there is no pending snapshot.
@@ -3007,22 +2308,6 @@ itVertexInput->second.timesRead, itVertexInput->second.differencesBetweenReads ?
         
         //  Set the end of frame flag.
         endOfFrame = true;
-
-        //  In validation mode process all the transactions up to the swap.
-        if (validationMode)
-        {
-            //  Get the log of MetaStreams processed by the Command Processor.
-            vector<cgoMetaStream *> &metaStreamLog = GpuPerfModel.CP->getcgoMetaStreamLog();
-            
-            //  Issue the MetaStreams to the behaviorModel.
-            for(U32 trans = 0; trans < metaStreamLog.size(); trans++)
-            {
-                GpuBehavMdl->GpuBMdl.emulateCommandProcessor(metaStreamLog[trans]);
-            }
-            
-            //  Clear the MetaStream log.
-            metaStreamLog.clear();
-        }
     }
     
     //  Check if trace has finished
@@ -3032,121 +2317,19 @@ itVertexInput->second.timesRead, itVertexInput->second.differencesBetweenReads ?
         endOfTrace = true;
         cout << "--- end of simulation trace ---" << endl;
 
-        //  In validation mode process all the transactions up to the end of the trace.
+        //  In validation mode wait until the behaviorModel emulates all the transactions up to the end of the trace.
         if (validationMode)
         {
-            //  Get the log of MetaStreams processed by the Command Processor.
-            vector<cgoMetaStream *> &metaStreamLog = GpuPerfModel.CP->getcgoMetaStreamLog();
-            
-            //  Issue the MetaStreams to the behaviorModel.
-            for(U32 trans = 0; trans < metaStreamLog.size(); trans++)
-            {
-                GpuBehavMdl->GpuBMdl.emulateCommandProcessor(metaStreamLog[trans]);
-            }
-            
-            //  Clear the MetaStream log.
-            metaStreamLog.clear();
+            validationChecker->synchronize();
             
             cout << "--- end of emulation trace ---" << endl;
         }
     }
 
     
-    //  Check stalls every 100K cycles.
-    if (checkStalls)
-    {
-        gpuStalled = false;
-        
-        if (!GpuPerfModel.multiClock)
-        {
-            for(U32 b = 0; b < GpuPerfModel.MduArray.size() && !gpuStalled; b++)
-            {
-                bool stallDetectionEnabled;
-                bool boxStalled;
-
-                GpuPerfModel.MduArray[b]->detectStall(cycle, stallDetectionEnabled, boxStalled);
-                
-                gpuStalled = gpuStalled || (stallDetectionEnabled && boxStalled);
-                
-                if (gpuStalled)
-                {
-                    printf("Stall detected on mdu %s at cycle %lld\n", GpuPerfModel.MduArray[b]->getName(), cycle);
-                }
-            }
-        }
-        else
-        {
-                for(U32 mdu = 0; mdu < GpuPerfModel.GpuDomainMduArray.size() && !gpuStalled; mdu++)
-                {
-                    bool stallDetectionEnabled;
-                    bool boxStalled;
-                       
-                    GpuPerfModel.GpuDomainMduArray[mdu]->detectStall(gpuCycle, stallDetectionEnabled, boxStalled);
-                    
-                    gpuStalled = gpuStalled || (stallDetectionEnabled && boxStalled);
-                    
-                    if (gpuStalled)
-                    {
-                        printf("Stall detected on mdu %s at cycle %lld\n", GpuPerfModel.GpuDomainMduArray[mdu]->getName(), gpuCycle);
-                    }
-                }
-                   
-                //for(U32 mdu = 0; mdu < GpuPerfModel.ShaderDomainMduArray.size(); mdu++)
-                //    GpuPerfModel.ShaderDomainMduArray[mdu]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
-                   
-                //for(U32 mdu = 0; mdu < GpuPerfModel.MemoryDomainMduArray.size(); mdu++)
-                //    GpuPerfModel.MemoryDomainMduArray[mdu]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
-        }
-                
-        if (gpuStalled)
-        {
-            ofstream reportFile;
-            
-            reportFile.open("StallReport.txt");                               
-            
-            if (!reportFile.is_open())
-                cout << "ERROR: Couldn't create report file." << endl;
-            
-            cout << "Reporting stall for all boxes : " << endl;
-            
-            if (reportFile.is_open())
-                reportFile <<  "Reporting stall for all boxes : " << endl;
-            
-            if (!GpuPerfModel.multiClock)
-            {
-                //  Dump stall reports for all boxes.
-                for(U32 b = 0; b < GpuPerfModel.MduArray.size(); b++)
-                {
-                    string report;
-                    GpuPerfModel.MduArray[b]->stallReport(cycle, report);
-                                        
-                    cout << report << endl;
-                    
-                    if (reportFile.is_open())
-                        reportFile << report << endl;
-                }
-            }
-            else
-            {
-                for(U32 mdu = 0; mdu < GpuPerfModel.GpuDomainMduArray.size() && !gpuStalled; mdu++)
-                {
-                    string report;
-                    GpuPerfModel.GpuDomainMduArray[mdu]->stallReport(gpuCycle, report);
-                                        
-                    cout << report << endl;
-                    
-                    if (reportFile.is_open())
-                        reportFile << report << endl;
-                }
-            }
-                    
-            cout << "Stall report written into StallReport.txt file." << endl;    
-            
-            reportFile.close();
-            
-            createSnapshot();
-        }
-    }
+    //  Check stalls every 100K cycles.  The cycle counter was already updated.
+    if (ArchConf.sim.detectStalls && ((clockScheduler.getCycle(0) % 100000) == 99999))
+        gpuStalled = checkStalls();
 
     //  Update progress counter.  
     dotCount++;
@@ -3161,6 +2344,82 @@ itVertexInput->second.timesRead, itVertexInput->second.differencesBetweenReads ?
 }
 
 
+//  Issues the clock ticks of all the clock domains up to the next tick of the main clock domain.
+U64 PerfModel::clockMainCycle(bool sameTime)
+{
+    U64 mainCycle = clockScheduler.getCycle(0);
+    U32 domain;
+
+    do
+    {
+        domain = clockScheduler.next();
+        clockTick(domain, mainCycle);
+    }
+    while(domain != 0);
+
+    if (sameTime)
+        clockSameTime();
+
+    return mainCycle;
+}
+
+//  Issues the ticks of the other clock domains at the time of the last main clock domain tick.
+//  The ticks at the same time are issued after the main clock domain tick.
+void PerfModel::clockSameTime()
+{
+    U64 mainTime = clockScheduler.getTime(0);
+
+    while(clockScheduler.peekTime() == mainTime)
+        clockTick(clockScheduler.next(), clockScheduler.getCycle(0) - 1);
+}
+
+void PerfModel::clockTick(U32 domain, U64 mainCycle)
+{
+    U64 domainCycle = clockScheduler.getCycle(domain);
+
+    GPU_DEBUG(
+        printf("%s Domain. Cycle %lld ----------------------------\n", clockScheduler.getName(domain), domainCycle);
+    )
+
+    //  Dump the signals.  The signal trace window is defined in cycles of the main clock domain.
+    if (ArchConf.sim.dumpSignalTrace && (mainCycle >= ArchConf.sim.startDump) && (mainCycle <= (ArchConf.sim.startDump + ArchConf.sim.dumpCycles)))
+    {
+        if (clockScheduler.getNumDomains() == 1)
+            sigBinder.dumpSignalTrace(domainCycle);
+        else
+            sigBinder.dumpSignalTrace(clockScheduler.getClockDomain(domain), domainCycle);
+    }
+
+    clockScheduler.clock(domain);
+}
+
+//  Checks the mdus of all the clock domains for stalls.
+bool PerfModel::checkStalls()
+{
+    if (!clockScheduler.detectStall())
+        return false;
+
+    ofstream reportFile;
+    reportFile.open("StallReport.txt");                               
+    if (!reportFile.is_open())
+        cout << "ERROR: Couldn't create report file." << endl;
+    cout << "Reporting stall for all boxes : " << endl;
+
+    if (reportFile.is_open())
+        reportFile <<  "Reporting stall for all boxes : " << endl;
+
+    string report = clockScheduler.stallReport(); //  Stall reports for all boxes.
+    cout << report;
+    if (reportFile.is_open())
+        reportFile << report;
+
+    cout << "Stall report written into StallReport.txt file." << endl;    
+    reportFile.close();
+    createSnapshot();
+
+    return true;
+}
+
 void PerfModel::simulationLoop(cgeModelAbstractLevel MAL)
 {
     U32 width, height;
@@ -3168,30 +2427,42 @@ void PerfModel::simulationLoop(cgeModelAbstractLevel MAL)
     bool end;
     current = this;
     simulationStarted = true;
+
+    clockScheduler.reset(); //  Start all the clock domains at cycle 0.
+
+    if (clockProfilePeriod != 0) //  Create the host profiler for the mdu clock calls.  The clock calls of each domain are profiled separately.
+    {
+        clockProfiler = new cmoClockProfiler(clockProfilePeriod);
+        clockScheduler.setProfiler(clockProfiler);
+    }
    
-    for(cycle = 0, end = false, dotCount = 0; !end; cycle++) //  Simulation loop.
+    for(end = false, dotCount = 0; !end; ) //  Simulation loop.
     {
-        if (cycle == 0) { fprintf(stderr, "[PerfModel] Entering simulation loop\n"); fflush(stderr); }
-        //CG_WARN("Cycle %ld ----------------------------\n", cycle);  // Disabled: too verbose for normal simulation runs.
-        if (ArchConf.sim.dumpSignalTrace && (cycle >= ArchConf.sim.startDump) && (cycle <= (ArchConf.sim.startDump + ArchConf.sim.dumpCycles)))  //  Dump the signals.
-            sigBinder.dumpSignalTrace(cycle);
+        if (clockScheduler.getCycle(0) == 0) { fprintf(stderr, "[PerfModel] Entering simulation loop\n"); fflush(stderr); }
+        U64 cycle = clockMainCycle(false); //  Clock all the domains up to the next cycle of the main (GPU) clock domain.
         cyclesCounter->inc(); //  Update cycle counter statistic.
 
-        for(i = 0; i < GpuPerfModel.MduArray.size(); i++) // Clock all the boxes.
-            GpuPerfModel.MduArray[i]->clock(cycle);
-
         if (ArchConf.sim.statistics) //  Check if statistics generation is active.
         {
             gpuStatistics::StatisticsManager::instance().clock(cycle); //  Update statistics.
             if (GpuPerfModel.CP->endOfBatch() && ArchConf.sim.perBatchStatistics) //  Check if current batch has finished.
+            {
+                TIMELINE_BEGIN("batch statistics")
                 gpuStatistics::StatisticsManager::instance().batch(); //  Update statistics.
+                TIMELINE_END()
+            }
            
             if (GpuPerfModel.CP->isSwap() && ArchConf.sim.perFrameStatistics) //  Check if statistics and per frame statistics are enabled.
+            {
+                TIMELINE_BEGIN("frame statistics")
                 gpuStatistics::StatisticsManager::instance().frame(frameCounter); //  Update statistics.
+                TIMELINE_END()
+            }
         }
 
         if (GpuPerfModel.CP->endOfBatch())  //  Check end of batch event.
         {
+            TIMELINE_INSTANT("batch", batchCounter, cycle)
             batchCounter++; //  Update rendered batches counter.
             frameBatch++; //  Update rendered batches in the current frame.
         }
@@ -3204,6 +2475,7 @@ void PerfModel::simulationLoop(cgeModelAbstractLevel MAL)
                     latencyMap[i] = GpuPerfModel.colorWriteV2[i]->getLatencyMap(width, height);
                 dumpLatencyMap(width, height); //  Dump the latency map.
             }
+            TIMELINE_INSTANT("frame", frameCounter, cycle)
             frameCounter++; //  Update frame counter.
             frameBatch = 0; //  Reset batch counter for the current batch.
             if (ArchConf.sim.simFrames != 0) //  Determine end of simulation.
@@ -3226,339 +2498,50 @@ void PerfModel::simulationLoop(cgeModelAbstractLevel MAL)
             end = end || ((cycle + 1) == ArchConf.sim.simCycles);
         
         if (ArchConf.sim.detectStalls && (cycle % 100000) == 99999)  //  Check stalls every 100K cycles.
-        {
-            bool gpuStalled = false;
-            for(i = 0; i < GpuPerfModel.MduArray.size() && !gpuStalled; i++)
-            {
-                bool stallDetectionEnabled;
-                bool boxStalled;
-
-                GpuPerfModel.MduArray[i]->detectStall(cycle, stallDetectionEnabled, boxStalled);
-                gpuStalled = gpuStalled || (stallDetectionEnabled && boxStalled);
-                CG_INFO_COND(gpuStalled, "Stall detected on mdu %s at cycle %lld\n", GpuPerfModel.MduArray[i]->getName(), cycle);
-            }
-            
-            if (gpuStalled)
-            {
-                ofstream reportFile;
-                reportFile.open("StallReport.txt");                               
-                if (!reportFile.is_open())
-                    cout << "ERROR: Couldn't create report file." << endl;
-                cout << "Reporting stall for all boxes : " << endl;
+            end = end || checkStalls();  //  End the simulation if a stall was detected.
+    } // for(end = false, dotCount = 0; !end; ) //  Simulation loop.
 
-                if (reportFile.is_open())
-                    reportFile <<  "Reporting stall for all boxes : " << endl;
+    clockSameTime(); //  Issue the ticks of the other clock domains at the time of the last main clock domain tick.
 
-                for(i = 0; i < GpuPerfModel.MduArray.size(); i++) //  Dump stall reports for all boxes.
-                {
-                    string report;
-                    GpuPerfModel.MduArray[i]->stallReport(cycle, report);
-                    cout << report << endl;
-                    if (reportFile.is_open())
-                        reportFile << report << endl;
-                }
-                cout << "Stall report written into StallReport.txt file." << endl;    
-                reportFile.close();
-                createSnapshot();
-            } // if (gpuStalled)
-            end = end || gpuStalled;  //  End the simulation if a stall was detected.                  
-        } // if (ArchConf.sim.detectStalls && ((cycle% 100000) == 99999))  //  Check stalls every 100K cycles.
-    } // for(cycle = 0, end = false, dotCount = 0; !end; cycle++) //  Simulation loop.
+    if (clockScheduler.getNumDomains() > 1) //  Cycles simulated in each clock domain.
+    {
+        printf("\n");
+        for(i = 0; i < clockScheduler.getNumDomains(); i++)
+            printf("%s Domain. END Cycle %lld ----------------------------\n", clockScheduler.getName(i), clockScheduler.getCycle(i));
+        printf("\n");
+    }
 
-    GPU_DEBUG( printf("\nEND Cycle %lld ----------------------------\n", cycle); )
+    GPU_DEBUG( printf("\nEND Cycle %lld ----------------------------\n", clockScheduler.getCycle(0)); )
 
     if (ArchConf.sim.dumpSignalTrace)           //  Check signal trace dump enabled. 
         sigBinder.endSignalTrace();     //  End signal tracing.  
 
     DynamicMemoryOpt::usage();
     gpuStatistics::StatisticsManager::instance().finish();
+    clockScheduler.setProfiler(NULL);
+    writeClockProfile();
 
     //DynamicMemoryOpt::dumpDynamicMemoryState(FALSE, FALSE);
 }
 
 void PerfModel::simulationLoopMultiClock()
 {
-    U32 width, height;
-    U32 i;
-    bool end;
-
-    current = this;
+    simulationLoop(CG_PERF_MODEL);
+}
 
-    // Initialize clock, step counters, etc.
-    gpuCycle = 0;
-    shaderCycle = 0;
-    memoryCycle = 0;
-    nextGPUClock = gpuClockPeriod;
-    nextShaderClock = shaderClockPeriod;
-    nextMemoryClock = memoryClockPeriod;
-    end = false;
-    
-    simulationStarted = true;
+void PerfModel::setClockProfiling(U32 period)
+{
+    clockProfilePeriod = period;
+}
 
-    while(!end)
+void PerfModel::writeClockProfile()
+{
+    if (clockProfiler != NULL)
     {
-        //
-        //  WARNING: Signal Trace Dump not supported yet with multi clock domain.
-        //
-        //  Dump the signals.
-        //if (ArchConf.sim.dumpSignalTrace && (cycle >= ArchConf.sim.startDump) && (cycle <= (ArchConf.sim.startDump + ArchConf.sim.dumpCycles)))
-        //    sigBinder.dumpSignalTrace(cycle);
-
-        //  Determine the picoseconds to the next clock.
-        U32 nextStep = GPU_MIN(GPU_MIN(nextGPUClock, nextShaderClock), nextMemoryClock);
-        
-        //printf("Clock -> Next GPU Clock = %d | Next Shader Clock = %d | Next Memory Clock = %d | Next Step = %d | GPU Cycle = %lld | Shader Cycle = %lld | MemoryCycle = %lld\n",
-        //    nextGPUClock, nextShaderClock, nextMemoryClock, nextStep, gpuCycle, shaderCycle, memoryCycle);
-                        
-        //  Update step counters for both clock domains.
-        nextGPUClock -= nextStep;
-        nextShaderClock -= nextStep;
-        nextMemoryClock -= nextStep;
-        
-        //  Check if a gpu domain tick has to be issued.
-        if (nextGPUClock == 0)
-        {
-            GPU_DEBUG(
-                printf("GPU Domain. Cycle %lld ----------------------------\n", gpuCycle);
-            )
-
-            // Clock all the boxes in the GPU Domain.
-            for(i = 0; i < GpuPerfModel.GpuDomainMduArray.size(); i++)
-                GpuPerfModel.GpuDomainMduArray[i]->clock(gpuCycle);
-                
-            //  Clock boxes with multiple domains.
-            for(i = 0; i < GpuPerfModel.ShaderDomainMduArray.size(); i++)
-                GpuPerfModel.ShaderDomainMduArray[i]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
-
-            for(i = 0; i < GpuPerfModel.MemoryDomainMduArray.size(); i++)
-                GpuPerfModel.MemoryDomainMduArray[i]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
-
-            //  Update cycle counter statistic.
-            cyclesCounter->inc();
-            
-            //  Check if statistics generation is active.
-            if (ArchConf.sim.statistics)
-            {
-                //  Update statistics.
-                gpuStatistics::StatisticsManager::instance().clock(gpuCycle);
-
-                //  Check if current batch has finished.
-                if (GpuPerfModel.CP->endOfBatch() && ArchConf.sim.perBatchStatistics)
-                {
-                    //  Update statistics.
-                    gpuStatistics::StatisticsManager::instance().batch();
-                }
-
-
-                //  Check if statistics and per frame statistics are enabled.
-                if (GpuPerfModel.CP->isSwap() && ArchConf.sim.perFrameStatistics)
-                {
-                    //  Update statistics.  
-                    gpuStatistics::StatisticsManager::instance().frame(frameCounter);
-                }
-            }
-            
-            //  Check end of batch event.
-            if (GpuPerfModel.CP->endOfBatch())
-            {
-                //  Update rendered batches counter.
-                batchCounter++;
-                
-                //  Update rendered batches in the current frame.
-                frameBatch++;
-            }
-
-            //  Check if color buffer swap has started and fragment map is enabled.
-            if (GpuPerfModel.CP->isSwap())
-            {
-                //  Check if fragment map dumping is enabled.
-                if  (ArchConf.sim.fragmentMap)
-                {
-                    //  Get the latency maps from the color write units.
-                    for(i = 0; i < ArchConf.gpu.numStampUnits; i++)
-                        latencyMap[i] = GpuPerfModel.colorWriteV2[i]->getLatencyMap(width, height);
-
-                    //  Dump the latency map.
-                    dumpLatencyMap(width, height);
-                }
-
-                //  Update frame counter.
-                frameCounter++;
-                
-                //  Reset batch counter for the current batch.
-                frameBatch = 0;
-
-                //  Determine end of simulation.
-                if (ArchConf.sim.simFrames != 0)
-                {
-                    //  End if the number of requested frames has been rendered.
-                    end = end || ((frameCounter - ArchConf.sim.startFrame) == ArchConf.sim.simFrames);
-                }
-            }
-            
-            //  Update progress counter.
-            dotCount++;
-
-            //  Display progress dots.
-            if (dotCount == 10000)
-            {
-                dotCount = 0;
-                putchar('.');
-                fflush(stdout);
-
-//DynamicMemoryOpt::usage();
-
-                //  Check if trace has finished.
-                end = end || GpuPerfModel.CP->isEndOfTrace();
-            }
-
-            //  Determine end of simulation.
-            if (ArchConf.sim.simCycles != 0)
-            {
-                end = end || ((gpuCycle + 1) == ArchConf.sim.simCycles);
-            }
-            
-            //  Check stalls every 100K cycles.
-            if (ArchConf.sim.detectStalls && ((gpuCycle % 100000) == 99999))
-            {
-                bool gpuStalled = false;
-                            
-                for(i = 0; i < GpuPerfModel.GpuDomainMduArray.size() && !gpuStalled; i++)
-                {
-                    bool stallDetectionEnabled;
-                    bool boxStalled;
-                 
-                    GpuPerfModel.GpuDomainMduArray[i]->detectStall(gpuCycle, stallDetectionEnabled, boxStalled);
-                    
-                    gpuStalled |= stallDetectionEnabled && boxStalled;
-                    
-                    if (gpuStalled)
-                    {
-                        printf("Stall detected on mdu %s at cycle (GPU Domain) %lld\n", GpuPerfModel.GpuDomainMduArray[i]->getName(), gpuCycle);
-                    }
-                }
-
-                for(i = 0; i < GpuPerfModel.ShaderDomainMduArray.size() && !gpuStalled; i++)
-                {
-                    bool stallDetectionEnabled;
-                    bool boxStalled;
-                 
-                    GpuPerfModel.ShaderDomainMduArray[i]->detectStall(shaderCycle, stallDetectionEnabled, boxStalled);
-                    
-                    gpuStalled |= stallDetectionEnabled && boxStalled;
-                    
-                    if (gpuStalled)
-                    {
-                        printf("Stall detected on mdu %s at cycle (Shader Domain) %lld\n", GpuPerfModel.ShaderDomainMduArray[i]->getName(), shaderCycle);
-                    }
-                }
-                
-                if (gpuStalled)
-                {
-                    ofstream reportFile;
-                    
-                    reportFile.open("StallReport.txt");                               
-                    
-                    if (!reportFile.is_open())
-                        cout << "ERROR: Couldn't create report file." << endl;
-                    
-                    cout << "Reporting stall for all boxes : " << endl;
-                    
-                    if (reportFile.is_open())
-                        reportFile <<  "Reporting stall for all boxes : " << endl;
-                    
-                    //  Dump stall reports for all boxes.
-                    for(i = 0; i < GpuPerfModel.MduArray.size(); i++)
-                    {
-                        string report;
-                        GpuPerfModel.MduArray[i]->stallReport(gpuCycle, report);
-                                            
-                        //cout << report << endl;
-                        
-                        if (reportFile.is_open())
-                            reportFile << report << endl;
-                    }
-                
-                    cout << "Stall report written into StallReport.txt file." << endl;    
-                    
-                    reportFile.close();
-                }
-                
-                //  End the simulation if a stall was detected.                  
-                end = end || gpuStalled;
-            }
-            
-            //  Update GPU domain clock and step counter.
-            gpuCycle++;
-            nextGPUClock = gpuClockPeriod;
-        }
-        
-        //  Check if a shader domain tick must be issued.
-        if (nextShaderClock == 0)
-        {
-            if (GpuPerfModel.shaderClockDomain)
-            {
-                GPU_DEBUG(
-                    printf("Shader Domain. Cycle %lld ----------------------------\n", shaderCycle);
-                )
-
-                //  Clock boxes with multiple domains.
-                for(i = 0; i < GpuPerfModel.ShaderDomainMduArray.size(); i++)
-                    GpuPerfModel.ShaderDomainMduArray[i]->clock(SHADER_CLOCK_DOMAIN, shaderCycle);
-
-                //  Update shader domain clock and step counter.
-                shaderCycle++;
-            }
-            
-            nextShaderClock = shaderClockPeriod;
-        }        
-        
-        //  Check if a memory domain tick must be issued.
-        if (nextMemoryClock == 0)
-        {
-            if (GpuPerfModel.memoryClockDomain)
-            {
-                GPU_DEBUG(
-                    printf("Memory Domain. Cycle %lld ----------------------------\n", memoryCycle);
-                )
-                
-                //  Clock boxes with multiple domains.
-                for(i = 0; i < GpuPerfModel.MemoryDomainMduArray.size(); i++)
-                    GpuPerfModel.MemoryDomainMduArray[i]->clock(MEMORY_CLOCK_DOMAIN, memoryCycle);
-
-                //  Update memory domain clock and step counter.
-                memoryCycle++;
-            }
-            
-            nextMemoryClock = memoryClockPeriod;            
-        }
+        clockProfiler->writeReport(HOST_PROFILE_FILE);
+        delete clockProfiler;
+        clockProfiler = NULL;
     }
-    
-    //GPU_DEBUG(
-        printf("\n");
-        printf("GPU Domain. END Cycle %lld ----------------------------\n", gpuCycle);
-        if (GpuPerfModel.shaderClockDomain)
-            printf("Shader Domain. END Cycle %lld ----------------------------\n", shaderCycle);
-        if (GpuPerfModel.memoryClockDomain)
-            printf("Memory Domain. END Cycle %lld ----------------------------\n", memoryCycle);
-        printf("\n");
-    //)
-
-    //
-    //  WARNING:  Signal trace dump not supported with multiple clock domains.
-    //
-    
-    //  Check signal trace dump enabled.  */
-    //if (ArchConf.sim.dumpSignalTrace)
-    //{
-        //  End signal tracing.  */
-    //    sigBinder.endSignalTrace();
-    //}
-
-    DynamicMemoryOpt::usage();
-    gpuStatistics::StatisticsManager::instance().finish();
-
-    //DynamicMemoryOpt::dumpDynamicMemoryState(FALSE, FALSE);
 }
 
 void PerfModel::getCounters(U32 &frame, U32 &batch, U32 &totalBatches)
@@ -3570,24 +2553,12 @@ void PerfModel::getCounters(U32 &frame, U32 &batch, U32 &totalBatches)
 
 void PerfModel::getCycles(U64 &_gpuCycle, U64 &_shaderCycle, U64 &_memCycle)
 {
-    if (GpuPerfModel.multiClock)
-    {
-        _gpuCycle = gpuCycle;
-        if (GpuPerfModel.shaderClockDomain)
-            _shaderCycle = shaderCycle;
-        else
-            _shaderCycle = 0;
-        if (GpuPerfModel.memoryClockDomain)
-            _memCycle = memoryCycle;
-        else
-            _memCycle = 0;
-    }
-    else
-    {
-        _gpuCycle = cycle;
-        _shaderCycle = 0;
-        _memCycle = 0;
-    }
+    U32 shaderDomain = clockScheduler.findDomain(SHADER_CLOCK_DOMAIN);
+    U32 memoryDomain = clockScheduler.findDomain(MEMORY_CLOCK_DOMAIN);
+
+    _gpuCycle = clockScheduler.getCycle(0);
+    _shaderCycle = (shaderDomain < clockScheduler.getNumDomains()) ? clockScheduler.getCycle(shaderDomain) : 0;
+    _memCycle = (memoryDomain < clockScheduler.getNumDomains()) ? clockScheduler.getCycle(memoryDomain) : 0;
 }
 
 void PerfModel::abortSimulation()
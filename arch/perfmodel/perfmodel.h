@@ -19,6 +19,7 @@
 #include "DynamicMemoryOpt.h"
 
 #include "GpuTop.h"
+#include "ClockScheduler.h"
 
 #include "zfstream.h"
 
@@ -27,6 +28,8 @@
 namespace arch
 {
 
+class ValidationChecker;
+class cmoClockProfiler;
 
 /**
  *  GPU Simulator class.
@@ -43,13 +46,7 @@ private:
     cgoTraceDriverBase *TraceDriver;  //  Pointer to a cgoTraceDriverBase object that will provide the MetaStreams to simulate.  */
     cmoSignalBinder &sigBinder;      //  Reference to the cmoSignalBinder that tracks all signals between and in the simulator modules.  */
 
-    U64 cycle;              //  Cycle counter for GPU clock domain (unified clock architecture).  */
-    U64 gpuCycle;           //  Cycle counter for GPU clock domain.  */
-    U64 shaderCycle;        //  Cycle counter for shader clock domain.  */
-    U64 memoryCycle;        //  Cycle counter for memory clock domain.  */
-    U32 nextGPUClock;       //  Stores the picoseconds (ps) to next gpu clock.  */
-    U32 nextShaderClock;    //  Stores the picoseconds (ps) to next shader clock.  */
-    U32 nextMemoryClock;    //  Stores the picoseconds (ps) to next memory clock.  */
+    cmoClockScheduler clockScheduler;   //  Orders the clock ticks of the clock domains.  The first domain is the main (GPU) domain.  */
 
     U32 gpuClockPeriod;     //  Period of the GPU clock in picoseconds (ps).  */
     U32 shaderClockPeriod;  //  Period of the shader clock in picoseconds (ps).  */
@@ -83,6 +80,9 @@ private:
     bool validationMode;       //  Stores if the validation mode is enabled.  */
     bool skipValidation;       //  Used to skip validation when loading a snapshot.  */
     BhavModel *GpuBehavMdl;  //  Pointer to the associated GPU behaviorModel for validation purposes.  */
+    ValidationChecker *validationChecker;  //  Runs the behaviorModel in a separate thread and compares the batch logs.  */
+    U32 clockProfilePeriod;                 //  Sampling period of the mdu clock host profiler (0: disabled).  */
+    cmoClockProfiler *clockProfiler;        //  Samples the host time spent in the mdu clock calls.  */
     
     /**
      *  Saves the simulator state to the 'state.snapshot' file.
@@ -95,6 +95,40 @@ private:
      *  Saves the simulator configuration parameters (cgsArchConfig structure) to the 'config.snapshot' file.
      */
     void saveSimConfig();
+
+    /**
+     *  Writes the host profiler report and deletes the host profiler.
+     */
+    void writeClockProfile();
+
+    /**
+     *  Issues the clock ticks of all the clock domains up to and including the next tick of the
+     *  main (GPU) clock domain.  Dumps the signal trace of the ticks in the signal trace window.
+     *  @param sameTime Also issue the ticks of the other clock domains at the time of the main
+     *  clock domain tick.
+     *  @return The main clock domain cycle simulated.
+     */
+    U64 clockMainCycle(bool sameTime);
+
+    /**
+     *  Issues the pending ticks of the other clock domains at the time of the last main clock
+     *  domain tick.
+     */
+    void clockSameTime();
+
+    /**
+     *  Issues a clock tick of a clock domain.
+     *  @param domain Index of the clock domain in the clock scheduler.
+     *  @param mainCycle Main clock domain cycle that defines the signal trace window.
+     */
+    void clockTick(U32 domain, U64 mainCycle);
+
+    /**
+     *  Checks all the mdus for stalls.  On a stall writes the stall report of all the mdus to
+     *  the StallReport.txt file and creates a snapshot.
+     *  @return If a stall was detected.
+     */
+    bool checkStalls();
     
 public:
 
@@ -123,15 +157,26 @@ public:
     ~PerfModel();
     
     /**
-     *  Fire-and-forget simulation loop for a single clock domain architecture.
+     *  Fire-and-forget simulation loop.  The clock ticks of all the clock domains are ordered
+     *  by the clock scheduler.
      */
     void simulationLoop(cgeModelAbstractLevel MAL = CG_PERF_MODEL);
 
     /**
-     *  Fire-and-forget simulation loop for a multi-clock domain architecture.
+     *  Fire-and-forget simulation loop for a multi-clock domain architecture.  Same as
+     *  simulationLoop().
      */
     void simulationLoopMultiClock();            
 
+    /**
+     *  Enables sampling the host time spent in the clock calls of the mdus in the simulation
+     *  loops.  The report is written to HOST_PROFILE_FILE when the simulation loop ends.
+     *  @param period Average number of cycles between sampled cycles (0 disables the profiler).
+     */
+    void setClockProfiling(U32 period);
+
+    static const char *HOST_PROFILE_FILE;
+
     /**
      *  Fire-and-forget simulation loop with integrated debugger.
      */
@@ -302,6 +347,14 @@ public:
      */
     bool simForcedCommand();
 
+    /**
+     *  Runs the simulation until the trace driver state matches the last MetaStream simulated
+     *  (see cgoTraceDriverBase::prepareCheckpoint), the driver thread generates MetaStreams ahead
+     *  of the simulation.
+     *  @return If the trace has not finished.
+     */
+    bool simTraceDriverCheckpoint();
+
     /**
      *  Implements the 'emulatortrace' command of the GPU simulator integrated debugger.
      *  The 'emulatortrace' command is used to enable/disable the trace log from the GPU behaviorModel
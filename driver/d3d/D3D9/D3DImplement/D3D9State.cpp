@@ -81,6 +81,10 @@ D3D9State::D3D9State()
     ccwStencilPass = libGAL::GAL_STENCIL_OP_KEEP;
     ccwStencilFunc = libGAL::GAL_COMPARE_FUNCTION_ALWAYS;
 
+    constantVersion = 0;
+    shaderConstantsSet = 0;
+    shaderConstantsSent = 0;
+
     for(U32 c = 0; c < MAX_VERTEX_SHADER_CONSTANTS; c++)
     {
         settedVertexShaderConstants[c] = new libGAL::gal_float[4];
@@ -88,7 +92,7 @@ D3D9State::D3D9State()
         settedVertexShaderConstants[c][1] = 0.0f;
         settedVertexShaderConstants[c][2] = 0.0f;
         settedVertexShaderConstants[c][3] = 0.0f;
-        settedVertexShaderConstantsTouched[c] = false;
+        settedVertexShaderConstantsVersion[c] = 0;
     }
     
     for(U32 c = 0; c < 16; c++)
@@ -98,10 +102,10 @@ D3D9State::D3D9State()
         settedVertexShaderConstantsInt[c][1] = 0;
         settedVertexShaderConstantsInt[c][2] = 0;
         settedVertexShaderConstantsInt[c][3] = 0;
-        settedVertexShaderConstantsIntTouched[c] = false;
+        settedVertexShaderConstantsIntVersion[c] = 0;
         
         settedVertexShaderConstantsBool[c] = false;
-        settedVertexShaderConstantsBoolTouched[c] = false;
+        settedVertexShaderConstantsBoolVersion[c] = 0;
     }
 
     for(U32 c = 0; c < MAX_PIXEL_SHADER_CONSTANTS; c++)
@@ -111,7 +115,7 @@ D3D9State::D3D9State()
         settedPixelShaderConstants[c][1] = 0.0f;
         settedPixelShaderConstants[c][2] = 0.0f;
         settedPixelShaderConstants[c][3] = 0.0f;
-        settedPixelShaderConstantsTouched[c] = false;
+        settedPixelShaderConstantsVersion[c] = 0;
     }
 
     for(U32 c = 0; c < 16; c++)
@@ -121,10 +125,10 @@ D3D9State::D3D9State()
         settedPixelShaderConstantsInt[c][1] = 0;
         settedPixelShaderConstantsInt[c][2] = 0;
         settedPixelShaderConstantsInt[c][3] = 0;
-        settedPixelShaderConstantsIntTouched[c] = false;
+        settedPixelShaderConstantsIntVersion[c] = 0;
         
         settedPixelShaderConstantsBool[c] = false;
-        settedPixelShaderConstantsBoolTouched[c] = false;
+        settedPixelShaderConstantsBoolVersion[c] = 0;
     }
     
     for (U32 i = 0; i < MAX_RENDER_TARGETS; i++){
@@ -1053,7 +1057,8 @@ void D3D9State::setVertexShaderConstant(UINT first, CONST float* data, UINT vect
         settedVertexShaderConstants[first + c][2] = data[c * 4 + 2];
         settedVertexShaderConstants[first + c][3] = data[c * 4 + 3];
 
-        settedVertexShaderConstantsTouched[first + c] = true;
+        settedVertexShaderConstantsVersion[first + c] = ++constantVersion;
+        shaderConstantsSet++;
     }
 }
 
@@ -1075,7 +1080,8 @@ void D3D9State::setVertexShaderConstant(UINT first, CONST int* data, UINT vector
         settedVertexShaderConstantsInt[first + c][2] = data[c * 4 + 2];
         settedVertexShaderConstantsInt[first + c][3] = data[c * 4 + 3];
 
-        settedVertexShaderConstantsIntTouched[first + c] = true;
+        settedVertexShaderConstantsIntVersion[first + c] = ++constantVersion;
+        shaderConstantsSet++;
     }
 }
 
@@ -1093,7 +1099,8 @@ void D3D9State::setVertexShaderConstantBool(UINT first, CONST BOOL* data, UINT v
 
         // Add the new constant setted to the setted constants map
         settedVertexShaderConstantsBool[first + c] = data[c];
-        settedVertexShaderConstantsBoolTouched[first + c] = true;
+        settedVertexShaderConstantsBoolVersion[first + c] = ++constantVersion;
+        shaderConstantsSet++;
     }
 }
 
@@ -1117,7 +1124,8 @@ void D3D9State::setPixelShaderConstant(UINT first, CONST float* data, UINT vecto
         settedPixelShaderConstants[first + c][2] = data[c * 4 + 2];
         settedPixelShaderConstants[first + c][3] = data[c * 4 + 3];
 
-        settedPixelShaderConstantsTouched[first + c] = true;
+        settedPixelShaderConstantsVersion[first + c] = ++constantVersion;
+        shaderConstantsSet++;
     }
 }
 
@@ -1139,7 +1147,8 @@ void D3D9State::setPixelShaderConstant(UINT first, CONST int* data, UINT vectorC
         settedPixelShaderConstantsInt[first + c][2] = data[c * 4 + 2];
         settedPixelShaderConstantsInt[first + c][3] = data[c * 4 + 3];
 
-        settedPixelShaderConstantsIntTouched[first + c] = true;
+        settedPixelShaderConstantsIntVersion[first + c] = ++constantVersion;
+        shaderConstantsSet++;
     }
 }
 
@@ -1157,7 +1166,8 @@ void D3D9State::setPixelShaderConstantBool(UINT first, CONST BOOL* data, UINT ve
 
         // Add the new constant setted to the setted constants map
         settedPixelShaderConstantsBool[first + c] = data[c];
-        settedPixelShaderConstantsBoolTouched[first + c] = true;
+        settedPixelShaderConstantsBoolVersion[first + c] = ++constantVersion;
+        shaderConstantsSet++;
     }
 }
 
@@ -2313,7 +2323,8 @@ void D3D9State::draw(D3DPRIMITIVETYPE type, UINT start, UINT count)
             settedVertexShaderConstants[r][1] = wvp[r][1];
             settedVertexShaderConstants[r][2] = wvp[r][2];
             settedVertexShaderConstants[r][3] = wvp[r][3];
-            settedVertexShaderConstantsTouched[r] = true;
+            settedVertexShaderConstantsVersion[r] = ++constantVersion;
+            shaderConstantsSet++;
         }
     }
 
@@ -2449,7 +2460,8 @@ void D3D9State::drawIndexed(D3DPRIMITIVETYPE type, INT baseVertexIndex, UINT min
             settedVertexShaderConstants[r][1] = wvp[r][1];
             settedVertexShaderConstants[r][2] = wvp[r][2];
             settedVertexShaderConstants[r][3] = wvp[r][3];
-            settedVertexShaderConstantsTouched[r] = true;
+            settedVertexShaderConstantsVersion[r] = ++constantVersion;
+            shaderConstantsSet++;
         }
     }
 
@@ -2543,6 +2555,9 @@ void D3D9State::drawIndexed(D3DPRIMITIVETYPE type, INT baseVertexIndex, UINT min
 
 void D3D9State::swapBuffers() {
 
+    cout << "D3D9State::swapBuffers() - Shader constants: " << shaderConstantsSet << " set | "
+         << shaderConstantsSent << " sent" << endl;
+
     // Swap buffers
     GalDev->swapBuffers();
 
@@ -2550,6 +2565,77 @@ void D3D9State::swapBuffers() {
 
 
 
+libGAL::gal_uint D3D9State::getShaderConstantVersion(bool pixelShader, U32 reg) const
+{
+    if (reg < BOOLEAN_CONSTANT_START)
+        return pixelShader ? settedPixelShaderConstantsVersion[reg] : settedVertexShaderConstantsVersion[reg];
+    else if (reg < INTEGER_CONSTANT_START)
+        return pixelShader ? settedPixelShaderConstantsBoolVersion[reg - BOOLEAN_CONSTANT_START] :
+                             settedVertexShaderConstantsBoolVersion[reg - BOOLEAN_CONSTANT_START];
+    else
+        return pixelShader ? settedPixelShaderConstantsIntVersion[reg - INTEGER_CONSTANT_START] :
+                             settedVertexShaderConstantsIntVersion[reg - INTEGER_CONSTANT_START];
+}
+
+void D3D9State::getShaderConstant(bool pixelShader, U32 reg, libGAL::gal_float *vect4) const
+{
+    const libGAL::gal_float *constant;
+
+    if (reg < BOOLEAN_CONSTANT_START)
+        constant = pixelShader ? settedPixelShaderConstants[reg] : settedVertexShaderConstants[reg];
+    else if (reg >= INTEGER_CONSTANT_START)
+        constant = (libGAL::gal_float *) (pixelShader ? settedPixelShaderConstantsInt[reg - INTEGER_CONSTANT_START] :
+                                                        settedVertexShaderConstantsInt[reg - INTEGER_CONSTANT_START]);
+    else
+    {
+        *((BOOL *) &vect4[0]) = pixelShader ? settedPixelShaderConstantsBool[reg - BOOLEAN_CONSTANT_START] :
+                                              settedVertexShaderConstantsBool[reg - BOOLEAN_CONSTANT_START];
+        vect4[1] = 0.0f;
+        vect4[2] = 0.0f;
+        vect4[3] = 0.0f;
+        return;
+    }
+
+    vect4[0] = constant[0];
+    vect4[1] = constant[1];
+    vect4[2] = constant[2];
+    vect4[3] = constant[3];
+}
+
+//  Sends to the GAL shader program the constants set since the last time the program was used.  Consecutive
+//  constants are sent with a single call.
+void D3D9State::syncShaderConstants(libGAL::GALShaderProgram *program, bool pixelShader)
+{
+    std::vector<libGAL::gal_uint> &sent = sentConstantVersions[program];
+
+    if (sent.empty())
+        sent.resize(SHADER_CONSTANT_REGISTERS, 0);
+
+    libGAL::gal_float constants[SHADER_CONSTANT_REGISTERS][4];
+
+    U32 reg = 0;
+    while (reg < SHADER_CONSTANT_REGISTERS)
+    {
+        //  Search the next constant changed since the last update of the program.
+        if (getShaderConstantVersion(pixelShader, reg) == sent[reg])
+        {
+            reg++;
+            continue;
+        }
+
+        //  Collect the range of consecutive changed constants.
+        U32 first = reg;
+        for(; (reg < SHADER_CONSTANT_REGISTERS) && (getShaderConstantVersion(pixelShader, reg) != sent[reg]); reg++)
+        {
+            getShaderConstant(pixelShader, reg, constants[reg - first]);
+            sent[reg] = getShaderConstantVersion(pixelShader, reg);
+        }
+
+        program->setConstants(first, reg - first, &constants[0][0]);
+        shaderConstantsSent += reg - first;
+    }
+}
+
 bool D3D9State::setGALShaders(NativeShader* &nativeVertexShader)
 {
     FFShaderGenerator ffShGen;
@@ -2590,27 +2676,7 @@ bool D3D9State::setGALShaders(NativeShader* &nativeVertexShader)
         //D3D_DEBUG( D3D_DEBUG( cout << "D3D9State shader binary: \n" << nativeVertexShader->debug_binary << endl; ) )
         //D3D_DEBUG( D3D_DEBUG( cout << "D3D9State shader ir: \n" << nativeVertexShader->debug_ir << endl; ) )
 
-        for(libGAL::gal_uint c = 0; c < MAX_VERTEX_SHADER_CONSTANTS; c++)
-        {
-            if (settedVertexShaderConstantsTouched[c])
-                galVertexShader->setConstant(c, settedVertexShaderConstants[c]);
-        }
-
-        for (libGAL::gal_uint c = 0; c < 16; c++)
-        {
-            if (settedVertexShaderConstantsIntTouched[c])
-                galVertexShader->setConstant(INTEGER_CONSTANT_START + c, (libGAL::gal_float *) settedVertexShaderConstantsInt[c]);
-           
-            if (settedVertexShaderConstantsBoolTouched[c])
-            {
-                libGAL::gal_float psConstant[4];
-                *((BOOL *) &psConstant[0]) = settedVertexShaderConstantsBool[c];
-                psConstant[1] = 0.0f;
-                psConstant[2] = 0.0f;
-                psConstant[3] = 0.0f;
-                galVertexShader->setConstant(BOOLEAN_CONSTANT_START + c, psConstant);
-            }
-        }
+        syncShaderConstants(galVertexShader, false);
 
         std::list<ConstRegisterDeclaration>::iterator itCRD;
         for (itCRD = nativeVertexShader->declaration.constant_registers.begin(); itCRD != nativeVertexShader->declaration.constant_registers.end(); itCRD++) {
@@ -3047,27 +3113,7 @@ bool D3D9State::setGALShaders(NativeShader* &nativeVertexShader)
         //D3D_DEBUG( D3D_DEBUG( cout << "D3D9State shader binary: \n" << nativePixelShader->debug_binary << endl; ) )
         //D3D_DEBUG( D3D_DEBUG( cout << "D3D9State shader ir: \n" << nativePixelShader->debug_ir << endl; ) )
 
-        for(libGAL::gal_uint c = 0; c < MAX_PIXEL_SHADER_CONSTANTS; c++)
-        {
-            if (settedPixelShaderConstantsTouched[c])
-                galPixelShader->setConstant(c, settedPixelShaderConstants[c]);
-        }
-        
-        for (libGAL::gal_uint c = 0; c < 16; c++)
-        {
-            if (settedPixelShaderConstantsIntTouched[c])
-                galPixelShader->setConstant(INTEGER_CONSTANT_START + c, (libGAL::gal_float *) settedPixelShaderConstantsInt[c]);
-           
-            if (settedPixelShaderConstantsBoolTouched[c])
-            {
-                libGAL::gal_float psConstant[4];
-                *((BOOL *) &psConstant[0]) = settedPixelShaderConstantsBool[c];
-                psConstant[1] = 0.0f;
-                psConstant[2] = 0.0f;
-                psConstant[3] = 0.0f;
-                galPixelShader->setConstant(BOOLEAN_CONSTANT_START + c, psConstant);
-            }
-        }
+        syncShaderConstants(galPixelShader, true);
 
         std::list<ConstRegisterDeclaration>::iterator itCRD;
         for (itCRD = nativePixelShader->declaration.constant_registers.begin(); itCRD != nativePixelShader->declaration.constant_registers.end(); itCRD++)
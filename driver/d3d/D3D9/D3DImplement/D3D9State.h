@@ -228,25 +228,40 @@ private:
     AIPixelShaderImp9* settedPixelShader;
     
     libGAL::gal_float *settedVertexShaderConstants[MAX_VERTEX_SHADER_CONSTANTS];
-    libGAL::gal_bool settedVertexShaderConstantsTouched[MAX_VERTEX_SHADER_CONSTANTS];
+    libGAL::gal_uint settedVertexShaderConstantsVersion[MAX_VERTEX_SHADER_CONSTANTS];
 
     libGAL::gal_int *settedVertexShaderConstantsInt[16];
-    libGAL::gal_bool settedVertexShaderConstantsIntTouched[16];
+    libGAL::gal_uint settedVertexShaderConstantsIntVersion[16];
 
     libGAL::gal_bool settedVertexShaderConstantsBool[16];
-    libGAL::gal_bool settedVertexShaderConstantsBoolTouched[16];
+    libGAL::gal_uint settedVertexShaderConstantsBoolVersion[16];
 
     libGAL::gal_float *settedPixelShaderConstants[MAX_PIXEL_SHADER_CONSTANTS];
-    libGAL::gal_bool settedPixelShaderConstantsTouched[MAX_VERTEX_SHADER_CONSTANTS];
+    libGAL::gal_uint settedPixelShaderConstantsVersion[MAX_PIXEL_SHADER_CONSTANTS];
 
     libGAL::gal_int *settedPixelShaderConstantsInt[16];
-    libGAL::gal_bool settedPixelShaderConstantsIntTouched[16];
+    libGAL::gal_uint settedPixelShaderConstantsIntVersion[16];
 
     libGAL::gal_bool settedPixelShaderConstantsBool[16];
-    libGAL::gal_bool settedPixelShaderConstantsBoolTouched[16];
+    libGAL::gal_uint settedPixelShaderConstantsBoolVersion[16];
 
     static const U32 BOOLEAN_CONSTANT_START = 256;
     static const U32 INTEGER_CONSTANT_START = 272;
+    static const U32 SHADER_CONSTANT_REGISTERS = INTEGER_CONSTANT_START + 16;
+
+    //  Constant versions.  Each time a constant is set it gets a new version (0 means never set).
+    libGAL::gal_uint constantVersion;
+
+    //  Constant versions last sent to each GAL shader program (indexed by native constant register).
+    std::map<libGAL::GALShaderProgram*, std::vector<libGAL::gal_uint> > sentConstantVersions;
+
+    //  Constant statistics.
+    U64 shaderConstantsSet;
+    U64 shaderConstantsSent;
+
+    libGAL::gal_uint getShaderConstantVersion(bool pixelShader, U32 reg) const;
+    void getShaderConstant(bool pixelShader, U32 reg, libGAL::gal_float *vect4) const;
+    void syncShaderConstants(libGAL::GALShaderProgram *program, bool pixelShader);
 
     typedef struct stDesc{
 
@@ -3,9 +3,11 @@
  */
 
 #include "GALBlendingStageImp.h"
+#include "GALDeviceImp.h"
 #include "GALMacros.h"
 #include "support.h"
 #include "GALSupport.h"
+#include "CheckpointStream.h"
 #include <sstream>
 
 #include "Profiler.h"
@@ -13,14 +15,14 @@
 using namespace std;
 using namespace libGAL;
 
-GALBlendingStageImp::GALBlendingStageImp(GALDeviceImp*, HAL* driver) :
-    _driver(driver), _enabled(MAX_RENDER_TARGETS, false), _syncRequired(true),
+GALBlendingStageImp::GALBlendingStageImp(GALDeviceImp* device, HAL* driver) :
+    _syncRequired(true), _driver(driver), _device(device), _enabled(MAX_RENDER_TARGETS, false),
+    _blendFunc(MAX_RENDER_TARGETS, GAL_BLEND_ADD),
     _srcBlend(MAX_RENDER_TARGETS, GAL_BLEND_ONE),
     _destBlend(MAX_RENDER_TARGETS, GAL_BLEND_ZERO),
+    _blendFuncAlpha(MAX_RENDER_TARGETS, GAL_BLEND_ADD),
     _srcBlendAlpha(MAX_RENDER_TARGETS, GAL_BLEND_ONE),
     _destBlendAlpha(MAX_RENDER_TARGETS, GAL_BLEND_ZERO),
-    _blendFunc(MAX_RENDER_TARGETS, GAL_BLEND_ADD),
-    _blendFuncAlpha(MAX_RENDER_TARGETS, GAL_BLEND_ADD),
     _blendColor(MAX_RENDER_TARGETS, GALFloatVector4(gal_float(0.0f))),
     _redMask(MAX_RENDER_TARGETS, true),
     _greenMask(MAX_RENDER_TARGETS, true),
@@ -37,6 +39,7 @@ GALBlendingStageImp::GALBlendingStageImp(GALDeviceImp*, HAL* driver) :
 void GALBlendingStageImp::setEnable(gal_uint renderTargetID, gal_bool enable)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -50,6 +53,7 @@ void GALBlendingStageImp::setEnable(gal_uint renderTargetID, gal_bool enable)
 void GALBlendingStageImp::setSrcBlend(gal_uint renderTargetID, GAL_BLEND_OPTION srcBlend)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -63,6 +67,7 @@ void GALBlendingStageImp::setSrcBlend(gal_uint renderTargetID, GAL_BLEND_OPTION
 void GALBlendingStageImp::setDestBlend(gal_uint renderTargetID, GAL_BLEND_OPTION destBlend)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -76,6 +81,7 @@ void GALBlendingStageImp::setDestBlend(gal_uint renderTargetID, GAL_BLEND_OPTION
 void GALBlendingStageImp::setSrcBlendAlpha(gal_uint renderTargetID, GAL_BLEND_OPTION srcBlendAlpha)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -89,6 +95,7 @@ void GALBlendingStageImp::setSrcBlendAlpha(gal_uint renderTargetID, GAL_BLEND_OP
 void GALBlendingStageImp::setDestBlendAlpha(gal_uint renderTargetID, GAL_BLEND_OPTION destBlendAlpha)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -102,6 +109,7 @@ void GALBlendingStageImp::setDestBlendAlpha(gal_uint renderTargetID, GAL_BLEND_O
 void GALBlendingStageImp::setBlendFunc(gal_uint renderTargetID, GAL_BLEND_FUNCTION blendFunc)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -113,6 +121,7 @@ void GALBlendingStageImp::setBlendFunc(gal_uint renderTargetID, GAL_BLEND_FUNCTI
 
 void GALBlendingStageImp::setBlendFuncAlpha(gal_uint renderTargetID, GAL_BLEND_FUNCTION blendFuncAlpha)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     CG_ASSERT(
           "Separate ALPHA blending (function/equation) is not supported yet");
 
@@ -127,6 +136,7 @@ void GALBlendingStageImp::setBlendFuncAlpha(gal_uint renderTargetID, GAL_BLEND_F
 void GALBlendingStageImp::setBlendColor(gal_uint renderTargetID, gal_float red, gal_float green, gal_float blue, gal_float alpha)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
 
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
@@ -146,6 +156,7 @@ void GALBlendingStageImp::setBlendColor(gal_uint renderTargetID, gal_float red,
 void GALBlendingStageImp::setBlendColor(gal_uint renderTargetID, const gal_float* rgba)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     setBlendColor(renderTargetID, rgba[0], rgba[1], rgba[2], rgba[3]);
     TRACING_EXIT_REGION()
 }
@@ -153,6 +164,7 @@ void GALBlendingStageImp::setBlendColor(gal_uint renderTargetID, const gal_float
 void GALBlendingStageImp::setColorMask(gal_uint renderTargetID, gal_bool red, gal_bool green, gal_bool blue, gal_bool alpha)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
 
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
@@ -179,6 +191,7 @@ gal_bool GALBlendingStageImp::getColorEnable(gal_uint renderTargetID)
 
 void GALBlendingStageImp::enableColorWrite(gal_uint renderTargetID)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -189,6 +202,7 @@ void GALBlendingStageImp::enableColorWrite(gal_uint renderTargetID)
 
 void GALBlendingStageImp::disableColorWrite(gal_uint renderTargetID)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     GAL_ASSERT(
         if ( renderTargetID >= MAX_RENDER_TARGETS )
             CG_ASSERT("Render target value greater than the maximum allowed id");
@@ -544,6 +558,7 @@ const StoredStateItem* GALBlendingStageImp::createStoredStateItem(GAL_STORED_ITE
 void GALBlendingStageImp::restoreStoredStateItem(const StoredStateItem* ssi)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
     gal_uint rTarget;
 
     const GALStoredStateItem* galssi = static_cast<const GALStoredStateItem*>(ssi);
@@ -612,6 +627,7 @@ GALStoredState* GALBlendingStageImp::saveAllState() const
 void GALBlendingStageImp::restoreAllState(const GALStoredState* state)
 {
     TRACING_ENTER_REGION("GAL", "", "")    
+    _device->setDirty(GALDeviceImp::DIRTY_BLENDING);
 
     const GALStoredStateImp* ssi = static_cast<const GALStoredStateImp*>(state);
 
@@ -630,3 +646,41 @@ void GALBlendingStageImp::restoreAllState(const GALStoredState* state)
 
     TRACING_EXIT_REGION()
 }
+
+void GALBlendingStageImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _syncRequired);
+    checkpoint::saveVector(out, _enabled);
+    checkpoint::saveVector(out, _blendFunc);
+    checkpoint::saveVector(out, _srcBlend);
+    checkpoint::saveVector(out, _destBlend);
+    checkpoint::saveVector(out, _blendFuncAlpha);
+    checkpoint::saveVector(out, _srcBlendAlpha);
+    checkpoint::saveVector(out, _destBlendAlpha);
+    checkpoint::saveVector(out, _redMask);
+    checkpoint::saveVector(out, _greenMask);
+    checkpoint::saveVector(out, _blueMask);
+    checkpoint::saveVector(out, _alphaMask);
+    checkpoint::saveVector(out, _colorWriteEnabled);
+    for ( gal_uint i = 0; i < _blendColor.size(); i++ )
+        checkpoint::saveData(out, _blendColor[i]);
+}
+
+void GALBlendingStageImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _syncRequired);
+    checkpoint::loadVector(in, _enabled);
+    checkpoint::loadVector(in, _blendFunc);
+    checkpoint::loadVector(in, _srcBlend);
+    checkpoint::loadVector(in, _destBlend);
+    checkpoint::loadVector(in, _blendFuncAlpha);
+    checkpoint::loadVector(in, _srcBlendAlpha);
+    checkpoint::loadVector(in, _destBlendAlpha);
+    checkpoint::loadVector(in, _redMask);
+    checkpoint::loadVector(in, _greenMask);
+    checkpoint::loadVector(in, _blueMask);
+    checkpoint::loadVector(in, _alphaMask);
+    checkpoint::loadVector(in, _colorWriteEnabled);
+    for ( gal_uint i = 0; i < _blendColor.size(); i++ )
+        checkpoint::loadData(in, _blendColor[i]);
+}
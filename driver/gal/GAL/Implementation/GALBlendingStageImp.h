@@ -58,12 +58,17 @@ public:
 
     void restoreAllState(const GALStoredState* ssi);
 
+    // Checkpoint support
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     static const gal_uint MAX_RENDER_TARGETS = GAL_MAX_RENDER_TARGETS;
 
     gal_bool _syncRequired;
     HAL* _driver;
+    GALDeviceImp* _device;
 
     std::vector<StateItem<gal_bool> > _enabled;
 
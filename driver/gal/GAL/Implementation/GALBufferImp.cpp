@@ -5,6 +5,8 @@
 #include "GALBufferImp.h"
 #include "GALMacros.h"
 #include "support.h"
+#include "MetaStream.h"
+#include "CheckpointStream.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
@@ -17,7 +19,7 @@ gal_uint GALBufferImp::_nextUID = 0;
 
 #define BURST_SIZE 32
 
-GALBufferImp::GALBufferImp(gal_uint size, const gal_ubyte* data) : _UID(_nextUID)
+GALBufferImp::GALBufferImp(gal_uint size, const gal_ubyte* data) : _UID(_nextUID), _size(0), _capacity(0), _data(0), _payload(0)
 {
     _nextUID++;
 
@@ -29,13 +31,10 @@ GALBufferImp::GALBufferImp(gal_uint size, const gal_ubyte* data) : _UID(_nextUID
             if ( data != 0 )
                 CG_ASSERT("Data pointer NOT null with size == 0");
         )
-        _data = 0;
-        _size = 0;
-        _capacity = 0;
     }
     else {
-        _size = _capacity = size;
-        _data = new gal_ubyte[size];
+        _allocData(size, false);
+        _size = size;
 
         if ( data != 0 )
             memcpy(_data, data, size);
@@ -46,7 +45,31 @@ GALBufferImp::GALBufferImp(gal_uint size, const gal_ubyte* data) : _UID(_nextUID
 }
 
 GALBufferImp::~GALBufferImp () {
-    delete[] _data;
+    // The memory writes still queued keep their reference to the data
+    if ( _payload != 0 )
+        _payload->release();
+}
+
+void GALBufferImp::_allocData(gal_uint capacity, gal_bool keepContents)
+{
+    arch::MetaStreamPayload* payload = ( capacity != 0 ) ? arch::MetaStreamPayload::create(capacity) : 0;
+
+    if ( keepContents && _size != 0 )
+        memcpy(payload->getData(), _data, _size);
+
+    if ( _payload != 0 )
+        _payload->release();
+
+    _payload = payload;
+    _data = ( payload != 0 ) ? payload->getData() : 0;
+    _capacity = capacity;
+}
+
+void GALBufferImp::_unshareData()
+{
+    // Copy on write, the memory writes not yet processed must see the data they were created with
+    if ( _payload != 0 && _payload->getReferences() > 1 )
+        _allocData(_capacity, true);
 }
 
 void GALBufferImp::setUsage(GAL_USAGE usage)
@@ -120,12 +143,8 @@ void GALBufferImp::resize(gal_uint size, bool discard)
     gal_uint originalCapacity = _capacity;
 
     if ( size > _capacity ) {
-        gal_ubyte* chunk = new gal_ubyte[size];
-        if ( !discard )
-            memcpy(chunk, _data, _size);
-        delete[] _data;
-        _data = chunk;
-        _capacity = _size = size; // updates new capacity and size
+        _allocData(size, !discard); // updates new capacity
+        _size = size;
     }
     else // size <= _capacity
         _size = size;
@@ -140,11 +159,9 @@ void GALBufferImp::resize(gal_uint size, bool discard)
 void GALBufferImp::clear()
 {
     // Implementando clear de los buffers para soportard glgal::discarBuffers()
-    delete[] _data;
+    _allocData(0, false);
 
     _size = 0;
-    _capacity = 0;
-    _data = 0;
 
     // Next synchronization will release previous buffer contents on GPU memory or system memory
     postReallocate(0);
@@ -153,16 +170,16 @@ void GALBufferImp::clear()
 void GALBufferImp::pushData(const gal_void* data, gal_uint size)
 {
     if ( _size + size > _capacity ) { // buffer growth is required
+        gal_uint capacity;
         if ( _size + size > static_cast<gal_uint>(_size * GROWTH_FACTOR) )
-            _capacity = _size + size;
+            capacity = _size + size;
         else
-            _capacity = static_cast<gal_uint>(_size * GROWTH_FACTOR);
+            capacity = static_cast<gal_uint>(_size * GROWTH_FACTOR);
         // growth is required
-        gal_ubyte* tmp = new gal_ubyte[_capacity];
-        memcpy(tmp, _data, _size); // Copy previous contents
-        delete[] _data; // Delete old contents
-        _data = tmp; // reassign data pointer
+        _allocData(capacity, true); // Copy previous contents
     }
+    else
+        _unshareData();
 
     // Push new data at the end of the buffer
     memcpy(_data + _size, data, size);
@@ -180,6 +197,7 @@ void GALBufferImp::updateData( gal_uint offset, gal_uint size, const gal_ubyte*
             CG_ASSERT("Buffer overflow offset + size is greater than total buffer size");
     )
 
+    _unshareData();
     memcpy(_data + offset, data, size); 
 
     
@@ -194,6 +212,30 @@ void GALBufferImp::updateData( gal_uint offset, gal_uint size, const gal_ubyte*
     preload(0, preloadData);
 }
 
+void GALBufferImp::updateStreamData( gal_uint offset, gal_uint size, const gal_ubyte* data )
+{
+    GAL_ASSERT
+    (
+        if ( offset + size > _size )
+            CG_ASSERT("Buffer overflow offset + size is greater than total buffer size");
+    )
+
+    _unshareData();
+    memcpy(_data + offset, data, size);
+
+    // Mark the memory range as dirty
+    postUpdate(0, offset, offset + size - 1);
+    preload(0, false);
+
+    // The range is not used by the previous batches, do not wait for them
+    lock(0, false);
+}
+
+void GALBufferImp::orphan()
+{
+    postOrphan(0);
+}
+
 const gal_ubyte* GALBufferImp::memoryData(gal_uint region, gal_uint& memorySizeInBytes) const
 {
     // Buffers are placed equally in CPU and GPU memory (linear), so no translation is required
@@ -207,6 +249,11 @@ const gal_ubyte* GALBufferImp::memoryData(gal_uint region, gal_uint& memorySizeI
     return _data;
 }
 
+arch::MetaStreamPayload* GALBufferImp::memoryPayload(gal_uint region) const
+{
+    return _payload;
+}
+
 const gal_char* GALBufferImp::stringType() const
 {
     return "MEMORY_OBJECT_BUFFER";
@@ -218,10 +265,7 @@ void GALBufferImp::shrink()
 
     if ( _size == _capacity )
         return ;
-    gal_ubyte* chunk = new gal_ubyte[_size];
-    memcpy(chunk, _data, _size);
-    delete[] _data;
-    _data = chunk;
+    _allocData(_size, true);
 }
 
 gal_uint GALBufferImp::capacity() const
@@ -235,6 +279,39 @@ gal_uint GALBufferImp::getUID ()
     return _UID;
 }
 
+void GALBufferImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _UID);
+    checkpoint::saveValue(out, _size);
+    checkpoint::saveValue(out, _usage);
+    checkpoint::saveValue(out, layout);
+
+    // The whole capacity is saved, resizing within the capacity keeps the previous contents
+    checkpoint::saveBytes(out, _data, _capacity);
+
+    saveRegions(out);
+}
+
+void GALBufferImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _UID);
+    if ( _nextUID <= _UID )
+        _nextUID = _UID + 1;
+
+    checkpoint::loadValue(in, _size);
+    checkpoint::loadValue(in, _usage);
+    checkpoint::loadValue(in, layout);
+
+    gal_uint capacity;
+    gal_ubyte* data = checkpoint::loadBytes(in, capacity);
+    _allocData(capacity, false);
+    if ( capacity != 0 )
+        memcpy(_data, data, capacity);
+    delete[] data;
+
+    restoreRegions(in);
+}
+
 void GALBufferImp::dumpBuffer (ofstream& out, GAL_STREAM_DATA type, gal_uint components, gal_uint stride, gal_uint offset)
 {
     gal_uint numElem = _size/getSize(type);
@@ -74,12 +74,18 @@ public:
     virtual void pushData(const gal_void* data, gal_uint size);
 
     virtual void updateData( gal_uint offset, gal_uint size, const gal_ubyte* data, gal_bool preload = false);
+
+    virtual void updateStreamData( gal_uint offset, gal_uint size, const gal_ubyte* data );
+
+    virtual void orphan();
  
     ////////////////////////////////////////////////////////
     /// MemoryObject methods that require implementation ///
     ////////////////////////////////////////////////////////
     virtual const gal_ubyte* memoryData(gal_uint region, gal_uint& memorySizeInBytes) const;
 
+    virtual arch::MetaStreamPayload* memoryPayload(gal_uint region) const;
+
     virtual const gal_char* stringType() const;
 
 
@@ -99,16 +105,27 @@ public:
 
     virtual gal_uint getUID ();
 
+    // Checkpoint support: buffer contents and memory tracking state
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     static const gal_float GROWTH_FACTOR;
     static gal_uint _nextUID; // Debug info
 
-    const gal_uint _UID;
+    gal_uint _UID;
 
     gal_uint _size;
     gal_uint _capacity;
     gal_ubyte* _data;
+    arch::MetaStreamPayload* _payload; // Holds the buffer data, shared with the memory writes
+
+    // Replaces the buffer data with a new payload, optionally keeping the current contents
+    void _allocData(gal_uint capacity, gal_bool keepContents);
+
+    // Copies the buffer data if the memory writes still reference it
+    void _unshareData();
     GAL_USAGE _usage;
 
     GAL_MEMORY_LAYOUT layout;
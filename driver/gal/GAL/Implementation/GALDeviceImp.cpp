@@ -40,29 +40,23 @@ gal_ubyte GALDeviceImp::defaultVSh[] = "mov o0, i0\n"
 gal_ubyte GALDeviceImp::defaultFSh[] = "mov o1, i1\n";
 
 GALDeviceImp::GALDeviceImp(HAL* driver) :
-    _driver(driver),
-    _requiredSync(true),
     _MAX_STREAMS(arch::MAX_STREAM_BUFFERS - 1),
-    _MAX_SAMPLES(16),
     //_MAX_STREAMS(3),
-    _indexedMode(false),
-    _clearColorBuffer(0),
+    _MAX_SAMPLES(16),
+    _driver(driver),
     _primitive(GAL_POINTS),
-    _vaMap(arch::MAX_VERTEX_ATTRIBUTES, arch::ST_INACTIVE_ATTRIBUTE),
-    _gsh(0), _gpuMemGshTrack(0),
-    _vsh(0), _gpuMemVshTrack(0),
-    _fsh(0), _gpuMemFshTrack(0),
-    _vshOutputs(arch::MAX_VERTEX_ATTRIBUTES, false),
-    _fshInputs(arch::MAX_FRAGMENT_ATTRIBUTES, false),
-    _vshResources(1),
-    _fshResources(1),
-    _shOptimizer(libGAL_opt::SHADER_ARCH_PARAMS()),
     //_stream(arch::MAX_STREAM_BUFFERS - 1),
     _stream(_MAX_STREAMS),
+    _indexedMode(false),
+    _clearColorBuffer(0),
     _zClearValue(1.0f),
     _stencilClearValue(0x00ffffff),
     _hzActivated(false),
     _hzBufferValid(false),
+    _streamStart(0),
+    _streamCount(0),
+    _streamInstances(1),
+    _streamBaseVertex(0),
     _defaultBackBuffer(0),
     _defaultFrontBuffer(0),
     _defaultZStencilBuffer(0),
@@ -70,18 +64,29 @@ GALDeviceImp::GALDeviceImp(HAL* driver) :
     _defaultRenderBuffers(false),
     _defaultZStencilBufferInUse(false),
     _colorSRGBWrite(false),
+    _vaMap(arch::MAX_VERTEX_ATTRIBUTES, arch::ST_INACTIVE_ATTRIBUTE),
+    _vshOutputs(arch::MAX_VERTEX_ATTRIBUTES, false),
+    _fshInputs(arch::MAX_FRAGMENT_ATTRIBUTES, false),
+    _vshResources(1),
+    _fshResources(1),
+    _gsh(0), _gpuMemGshTrack(0),
+    _vsh(0), _gpuMemVshTrack(0),
+    _fsh(0), _gpuMemFshTrack(0),
+    _shOptimizer(libGAL_opt::SHADER_ARCH_PARAMS()),
     _startFrame(0),
     _currentFrame(0),
     _currentBatch(0),
+    _currentColor(gal_float(0.0)),
     _alphaTest(false),
-    _streamStart(0),
-    _streamCount(0),
-    _streamInstances(1),
     _earlyZ(true),
-    _currentColor(gal_float(0.0))
+    _requiredSync(true),
+    _dirty(DIRTY_ALL),
+    _memoryChanges(0)
 {
     _driver->setContext(this);
 
+    _nextObjectID = 1;
+
     _moa = new MemoryObjectAllocator(driver);
 
     gal_uint tileLevel1Sz;
@@ -170,7 +175,9 @@ GALDeviceImp::GALDeviceImp(HAL* driver) :
 
 GALDeviceImp::~GALDeviceImp()
 {
- 
+    map<gal_uint, gal_ubyte*>::iterator it = _staleObjects.begin();
+    for ( ; it != _staleObjects.end(); ++it )
+        delete[] it->second;
 }
 
 void GALDeviceImp::setOptions(const GAL_CONFIG_OPTIONS& configOptions)
@@ -255,6 +262,7 @@ HAL& GALDeviceImp::driver() const
 void GALDeviceImp::setPrimitive(GAL_PRIMITIVE primitive)
 {
     _primitive = primitive;
+    _dirty |= DIRTY_PRIMITIVE;
 }
 
 GALBlendingStage& GALDeviceImp::blending()
@@ -274,22 +282,26 @@ GALZStencilStage& GALDeviceImp::zStencil()
 
 GALTexture2D* GALDeviceImp::createTexture2D()
 {
-    return new GALTexture2DImp();
+    GALTexture2DImp* tex = new GALTexture2DImp();
+    return _registerObject(tex, OBJECT_TEXTURE2D, tex);
 }
 
 GALTexture3D* GALDeviceImp::createTexture3D()
 {
-    return new GALTexture3DImp();
+    GALTexture3DImp* tex = new GALTexture3DImp();
+    return _registerObject(tex, OBJECT_TEXTURE3D, tex);
 }
 
 GALTextureCubeMap* GALDeviceImp::createTextureCubeMap()
 {
-    return new GALTextureCubeMapImp();
+    GALTextureCubeMapImp* tex = new GALTextureCubeMapImp();
+    return _registerObject(tex, OBJECT_TEXTURECM, tex);
 }
 
 GALBuffer* GALDeviceImp::createBuffer(gal_uint size, const gal_ubyte* data)
 {
-    return new GALBufferImp(size, data);
+    GALBufferImp* buf = new GALBufferImp(size, data);
+    return _registerObject(buf, OBJECT_BUFFER, buf);
 }
 
 gal_bool GALDeviceImp::destroy(GALResource* resourcePtr)
@@ -300,6 +312,7 @@ gal_bool GALDeviceImp::destroy(GALResource* resourcePtr)
                 GALBufferImp* bufImp = static_cast<GALBufferImp*>(resourcePtr);
                 _moa->deallocate(bufImp); // Deallocate from GPU memory if required
                 //cout << "I'm going to delete " << bufImp << "\n";
+                _unregisterObject(bufImp);
                 delete bufImp; // Release buffer interface
                 return true;
             }
@@ -326,6 +339,7 @@ gal_bool GALDeviceImp::destroy(GALShaderProgram* shProgram)
 
     _moa->deallocate(shProgramImp); // Deallocate from GPU memory if required
 
+    _unregisterObject(shProgramImp);
     delete shProgramImp; // Destroy the interface
 
     return true;
@@ -358,9 +372,9 @@ void GALDeviceImp::setResolution(gal_uint width, gal_uint height)
         format = GAL_FORMAT_ARGB_8888;
 
     //  Create the render targets for the default render buffers.
-    _defaultFrontBuffer = new GALRenderTargetImp(this, width, height, multisampling, samples, format, true, mdFront);
-    _defaultBackBuffer = new GALRenderTargetImp(this, width, height, multisampling, samples, format, true, mdBack);
-    _defaultZStencilBuffer = new GALRenderTargetImp(this, width, height, multisampling, samples, GAL_FORMAT_S8D24, true, mdZStencil);
+    _defaultFrontBuffer = _registerObject(new GALRenderTargetImp(this, width, height, multisampling, samples, format, true, mdFront), OBJECT_RENDER_TARGET, 0);
+    _defaultBackBuffer = _registerObject(new GALRenderTargetImp(this, width, height, multisampling, samples, format, true, mdBack), OBJECT_RENDER_TARGET, 0);
+    _defaultZStencilBuffer = _registerObject(new GALRenderTargetImp(this, width, height, multisampling, samples, GAL_FORMAT_S8D24, true, mdZStencil), OBJECT_RENDER_TARGET, 0);
 
     //  Set the default back buffer and z stencil buffer as the current render targets.
     _currentRenderTarget[0] = _defaultBackBuffer;
@@ -368,6 +382,7 @@ void GALDeviceImp::setResolution(gal_uint width, gal_uint height)
 
     _currentRenderTarget[0].restart();
     _currentZStencilBuffer.restart();
+    _dirty |= DIRTY_RENDER_BUFFERS;
 
     //  Set as using the default render buffers.
     _defaultRenderBuffers = true;
@@ -425,6 +440,7 @@ void GALDeviceImp::enableVertexAttribute(gal_uint vaIndex, gal_uint streamID)
 
     _vaMap[vaIndex] = streamID;
     _usedStreams.insert(streamID);
+    _dirty |= DIRTY_STREAMER;
     TRACING_EXIT_REGION()    
 }
 
@@ -441,6 +457,7 @@ void GALDeviceImp::disableVertexAttribute(gal_uint vaIndex)
     if ( stream != arch::ST_INACTIVE_ATTRIBUTE )  { // Mark this stream as free
         _usedStreams.erase(stream);
         _vaMap[vaIndex] = arch::ST_INACTIVE_ATTRIBUTE;
+        _dirty |= DIRTY_STREAMER;
     }
     TRACING_EXIT_REGION()    
 }
@@ -452,6 +469,7 @@ void GALDeviceImp::disableVertexAttributes()
     //_vaMap.assign(arch::MAX_VERTEX_ATTRIBUTES, arch::ST_INACTIVE_ATTRIBUTE);
     for(U32 a = 0; a < _vaMap.size(); a++)
         _vaMap[a] = arch::ST_INACTIVE_ATTRIBUTE;
+    _dirty |= DIRTY_STREAMER;
     TRACING_EXIT_REGION()    
 }
 
@@ -549,7 +567,7 @@ void GALDeviceImp::setIndexBuffer(GALBuffer* ib, gal_uint offset, GAL_STREAM_DAT
     TRACING_EXIT_REGION()    
 }
 
-void GALDeviceImp::_syncStreamingMode(gal_uint start, gal_uint count, gal_uint instances, gal_uint, gal_uint)
+void GALDeviceImp::_syncStreamingMode(gal_uint start, gal_uint count, gal_uint instances, gal_uint, gal_uint, gal_int baseVertexIndex)
 {
     // min & max params ignored currently
 
@@ -588,6 +606,16 @@ void GALDeviceImp::_syncStreamingMode(gal_uint start, gal_uint count, gal_uint i
             _driver->writeGPURegister(arch::GPU_INDEX_MODE, 0, data);
             _indexedMode.restart();
         }
+
+        // The GPU adds the base vertex to the indices read from the stream of indices
+        _streamBaseVertex = baseVertexIndex;
+        if(_streamBaseVertex.changed())
+        {
+            data.intVal = _streamBaseVertex;
+            _driver->writeGPURegister(arch::GPU_STREAM_BASE_VERTEX, 0, data);
+            _streamBaseVertex.restart();
+        }
+
         // Synchronize the stream of indices
         _indexStream->sync();
     }
@@ -604,7 +632,7 @@ void GALDeviceImp::_syncStreamingMode(gal_uint start, gal_uint count, gal_uint i
 
 GALRenderTarget* GALDeviceImp::createRenderTarget( GALTexture* resource, const GAL_RT_DIMENSION rtdimension, GAL_CUBEMAP_FACE face, gal_uint mipmap )
 {
-    return new GALRenderTargetImp (this, resource, rtdimension, face, mipmap);
+    return _registerObject(new GALRenderTargetImp (this, resource, rtdimension, face, mipmap), OBJECT_RENDER_TARGET, 0);
 }
 
 
@@ -618,6 +646,8 @@ gal_bool GALDeviceImp::setRenderTargets( gal_uint numRenderTargets,
 
 gal_bool GALDeviceImp::setRenderTarget(gal_uint indexRenderTarget, GALRenderTarget *renderTarget)
 {
+    _dirty |= DIRTY_RENDER_BUFFERS;
+
     if (renderTarget == NULL)
     {
         //  Disable drawing.
@@ -745,6 +775,7 @@ gal_bool GALDeviceImp::setRenderTarget(gal_uint indexRenderTarget, GALRenderTarg
 
 bool GALDeviceImp::setZStencilBuffer(GALRenderTarget *zstencilBuffer)
 {
+    _dirty |= DIRTY_RENDER_BUFFERS;
 
 //GALRenderTargetImp *currentZSB = _currentZStencilBuffer;
 //GALRenderTargetImp *defaultZSB = _defaultZStencilBuffer;
@@ -1308,223 +1339,221 @@ void GALDeviceImp::_check_deferred_dump()
     }
 };
 
-void GALDeviceImp::_addBaseVertexIndex(gal_uint baseVertexIndex, gal_uint start, gal_uint count)
+void GALDeviceImp::_syncDirtyState()
 {
+    // Memory objects (textures, buffers and programs) change outside the device setters
+    if ( MemoryObject::changes() != _memoryChanges )
+    {
+        _memoryChanges = MemoryObject::changes();
+        _dirty |= DIRTY_SAMPLERS | DIRTY_STREAMER | DIRTY_VERTEX_SHADER | DIRTY_FRAGMENT_SHADER;
+    }
 
-    /*if ( _vaMap[31] != arch::ST_INACTIVE_ATTRIBUTE)
-        CG_ASSERT("Trying to perform a draw indexed call without any stream of indexes setted");
-    else
-    {*/
-
-        GALBuffer* original = _indexStream->getBuffer(); // Stream 31 is where Indexed Stream is stored by default
-
-        gal_ubyte* originalUbyte = (gal_ubyte* )original->getData();
-        gal_ushort* originalUshort = (gal_ushort*) originalUbyte;
-        gal_uint* originalUint = (gal_uint*) originalUbyte;
-        gal_float* originalFloat = (gal_float*) originalUbyte;
-
-        GALBuffer* copy = createBuffer(0,0);
-
-        gal_uint last = count + start;
-
-        switch(_indexStream->getType())
-        {
-            case GAL_SD_UINT8:
-            case GAL_SD_INV_UINT8:
-                for(int i = start; i < last; i++)
-                {
-                    /*gal_ubyte newValue = originalUbyte[i] + baseVertexIndex;
-                    copy->pushData(&newValue, sizeof(gal_ubyte));*/
-                    gal_uint newValue = (gal_uint)(originalUbyte[i]) + baseVertexIndex;
-                    copy->pushData(&newValue, sizeof(gal_uint));
-                }
-                _indexStream->setType(GAL_SD_UINT32);
-                break;
-
-            case GAL_SD_UINT16:
-            case GAL_SD_INV_UINT16:
-                for(int i = start; i < last; i++)
-                {
-                    /*gal_ushort newValue = originalUshort[i] + baseVertexIndex;
-                    copy->pushData(&newValue, sizeof(gal_ushort));*/
-                    gal_uint newValue = (gal_uint)(originalUshort[i]) + baseVertexIndex;
-                    copy->pushData(&newValue, sizeof(gal_uint));
-                }
-                _indexStream->setType(GAL_SD_UINT32);
-                break;
-
-            case GAL_SD_UINT32:
-            case GAL_SD_INV_UINT32:
-                for(int i = start; i < last; i++)
-                {
-                    gal_uint newValue = originalUint[i] + baseVertexIndex;
-                    copy->pushData(&newValue, sizeof(gal_uint));
-                }
-                break;
-
-            case GAL_SD_FLOAT32:
-            case GAL_SD_INV_FLOAT32:
-                for(int i = start; i < last; i++)
-                {
-                    gal_float newValue = originalFloat[i] + baseVertexIndex;
-                    copy->pushData(&newValue, sizeof(gal_float));
-                }
-                break;
-
-            default:
-                CG_ASSERT("Buffer content type not available");
-        }
-
-        _indexStream->setBuffer(copy);
-    //}
-
-}
-
-void GALDeviceImp::_draw(gal_uint start, gal_uint count, gal_uint min, gal_uint max, gal_uint baseVertexIndex, gal_uint instances)
-{
     ///////////////////////////////////////////////////////////////
     /// Synchronize render buffers                              ///
     ///////////////////////////////////////////////////////////////
-    _syncRenderBuffers();
+    if ( _dirty & DIRTY_RENDER_BUFFERS )
+    {
+        _dirty &= ~DIRTY_RENDER_BUFFERS;
+        _syncRenderBuffers();
+    }
 
     ///////////////////////////////////////////////////////////////
     /// Synchronize stages Rasterization, ZStencil and Blending ///
     ///////////////////////////////////////////////////////////////
-    _rast->sync();
-    _zStencil->sync();
-    _blending->sync();
+    if ( _dirty & DIRTY_RASTERIZATION )
+    {
+        _dirty &= ~DIRTY_RASTERIZATION;
+        _rast->sync();
+    }
+
+    if ( _dirty & DIRTY_ZSTENCIL )
+    {
+        _dirty &= ~DIRTY_ZSTENCIL;
+        _zStencil->sync();
+
+        ////////////////////////////////////////////////////////////////////////////////
+        /// Enable or disable GPU Hierarchical Z depending on current ZStencil state ///
+        ////////////////////////////////////////////////////////////////////////////////
+        _syncHZRegister();
+    }
+
+    if ( _dirty & DIRTY_BLENDING )
+    {
+        _dirty &= ~DIRTY_BLENDING;
+        _blending->sync();
+    }
 
     //////////////////////////////////
     /// Synchronize primitive mode ///
     //////////////////////////////////
-    if ( _primitive.changed() )
+    if ( _dirty & DIRTY_PRIMITIVE )
     {
-        arch::GPURegData data;
-        _translatePrimitive(_primitive, &data);
-        _driver->writeGPURegister(arch::GPU_PRIMITIVE, data);
-        _primitive.restart();
+        _dirty &= ~DIRTY_PRIMITIVE;
+
+        if ( _primitive.changed() )
+        {
+            arch::GPURegData data;
+            _translatePrimitive(_primitive, &data);
+            _driver->writeGPURegister(arch::GPU_PRIMITIVE, data);
+            _primitive.restart();
+        }
     }
 
     //////////////////////////////////
     /// Synchronize bound textures ///
     //////////////////////////////////
-    _syncSamplerState();
+    if ( _dirty & DIRTY_SAMPLERS )
+    {
+        _dirty &= ~DIRTY_SAMPLERS;
+        _syncSamplerState();
+    }
 
     ////////////////////
     /// Sync shaders ///
     ////////////////////
-    _syncVertexShader();
-    _syncFragmentShader();
-
-    ////////////////////////////////////////////////////////////////////////////////
-    /// Enable or disable GPU Hierarchical Z depending on current ZStencil state ///
-    ////////////////////////////////////////////////////////////////////////////////
-    _syncHZRegister();
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    /// If a baseVertexIndex is setted, baseVertexIndex is added to each Index of the Indexed Stream ///
-    ////////////////////////////////////////////////////////////////////////////////////////////////////
-    if (_indexedMode && baseVertexIndex != 0) {
-        _addBaseVertexIndex(baseVertexIndex, start, count);
-        start = 0;
-    }
-
-    ///////////////////////////////////////////////////////////////////////////////
-    /// Synchronize streams state ((buffers attached automatically synchronized ///
-    ///////////////////////////////////////////////////////////////////////////////
-    _syncStreamerState();
-
-    //////////////////////////////////
-    /// Synchronize streaming mode ///
-    //////////////////////////////////
-    _syncStreamingMode(start, count, instances, min, max);
-
-    //////////////////////////////////////////////////////////////////////////////
-    /// Enable or disable VERTEX_OUTPUT_ATTRIBUTES & FRAGMENT_INPUT_ATTRIBUTES ///
-    //////////////////////////////////////////////////////////////////////////////
     arch::GPURegData bValue;
+    arch::GPURegData data;
 
-    const gal_uint vshOutputsCount = _vshOutputs.size();
-    for ( gal_uint i = 0; i < vshOutputsCount; ++i ) 
+    if ( _dirty & DIRTY_VERTEX_SHADER )
     {
-        if ( _vshOutputs[i].changed() ) 
+        _dirty &= ~DIRTY_VERTEX_SHADER;
+        _syncVertexShader();
+
+        //////////////////////////////////////////////////
+        /// Enable or disable VERTEX_OUTPUT_ATTRIBUTES ///
+        //////////////////////////////////////////////////
+        const gal_uint vshOutputsCount = _vshOutputs.size();
+        for ( gal_uint i = 0; i < vshOutputsCount; ++i ) 
         {
-            bValue.booleanVal = _vshOutputs[i];
-            _driver->writeGPURegister(arch::GPU_VERTEX_OUTPUT_ATTRIBUTE, i, bValue);
-            _vshOutputs[i].restart();
+            if ( _vshOutputs[i].changed() ) 
+            {
+                bValue.booleanVal = _vshOutputs[i];
+                _driver->writeGPURegister(arch::GPU_VERTEX_OUTPUT_ATTRIBUTE, i, bValue);
+                _vshOutputs[i].restart();
+            }
         }
-    }
 
-    gal_bool oneFragmentInput = false;
-
-    const gal_uint fshOutputsCount = _fshInputs.size();
-    for ( gal_uint i = 0; i < fshOutputsCount; ++i ) 
-    {
-        if ( _fshInputs[i].changed() ) 
+        if ( _vshResources.changed() )
         {
-            bValue.booleanVal = _fshInputs[i];
-            _driver->writeGPURegister(arch::GPU_FRAGMENT_INPUT_ATTRIBUTES, i, bValue);
-            _fshInputs[i].restart();
+            data.uintVal = _vshResources;
+            _driver->writeGPURegister(arch::GPU_VERTEX_THREAD_RESOURCES, data);
+            _vshResources.restart();
         }
-
-        oneFragmentInput = oneFragmentInput || _fshInputs[i];
     }
 
-    if ( !oneFragmentInput )
+    if ( _dirty & DIRTY_FRAGMENT_SHADER )
     {
-        _fshInputs[arch::COLOR_ATTRIBUTE] = true;
-        bValue.booleanVal = true;
-        _driver->writeGPURegister(arch::GPU_FRAGMENT_INPUT_ATTRIBUTES, arch::COLOR_ATTRIBUTE, bValue);
-        _fshInputs[arch::COLOR_ATTRIBUTE].restart();
-    }
+        _dirty &= ~DIRTY_FRAGMENT_SHADER;
+        _syncFragmentShader();
 
-    // EarlyZ can be actived if Z is not modified by the fragment shader
-    // If fragment depth is modified by the fragment program disable Early Z
-    GALShaderProgramImp* fsh = _fsh;
+        ///////////////////////////////////////////////////
+        /// Enable or disable FRAGMENT_INPUT_ATTRIBUTES ///
+        ///////////////////////////////////////////////////
+        gal_bool oneFragmentInput = false;
 
-    if (fsh->getOutputWritten(0) || fsh->getKillInstructions())
-    {
-        _earlyZ = false;
-        
-        if (_earlyZ.changed())
+        const gal_uint fshOutputsCount = _fshInputs.size();
+        for ( gal_uint i = 0; i < fshOutputsCount; ++i ) 
         {
-            bValue.booleanVal = false;
-            _driver->writeGPURegister(arch::GPU_EARLYZ, bValue);
-            _alphaTest.restart();
-            _earlyZ.restart();
+            if ( _fshInputs[i].changed() ) 
+            {
+                bValue.booleanVal = _fshInputs[i];
+                _driver->writeGPURegister(arch::GPU_FRAGMENT_INPUT_ATTRIBUTES, i, bValue);
+                _fshInputs[i].restart();
+            }
+
+            oneFragmentInput = oneFragmentInput || _fshInputs[i];
         }
-    }
-    else
-    {
-        _earlyZ = true;
-        if (_earlyZ.changed())
+
+        if ( !oneFragmentInput )
         {
+            _fshInputs[arch::COLOR_ATTRIBUTE] = true;
             bValue.booleanVal = true;
-            _driver->writeGPURegister(arch::GPU_EARLYZ, bValue);
-            _alphaTest.restart();
-            _earlyZ.restart();
+            _driver->writeGPURegister(arch::GPU_FRAGMENT_INPUT_ATTRIBUTES, arch::COLOR_ATTRIBUTE, bValue);
+            _fshInputs[arch::COLOR_ATTRIBUTE].restart();
         }
-    }
 
-    //////////////////////////////////////////////////////////////////////////////
-    ///                 Synchronize Shader Thread Resources                    ///
-    //////////////////////////////////////////////////////////////////////////////
+        // EarlyZ can be actived if Z is not modified by the fragment shader
+        // If fragment depth is modified by the fragment program disable Early Z
+        GALShaderProgramImp* fsh = _fsh;
 
-    arch::GPURegData data;
+        if (fsh->getOutputWritten(0) || fsh->getKillInstructions())
+        {
+            _earlyZ = false;
+            
+            if (_earlyZ.changed())
+            {
+                bValue.booleanVal = false;
+                _driver->writeGPURegister(arch::GPU_EARLYZ, bValue);
+                _alphaTest.restart();
+                _earlyZ.restart();
+            }
+        }
+        else
+        {
+            _earlyZ = true;
+            if (_earlyZ.changed())
+            {
+                bValue.booleanVal = true;
+                _driver->writeGPURegister(arch::GPU_EARLYZ, bValue);
+                _alphaTest.restart();
+                _earlyZ.restart();
+            }
+        }
 
-    if ( _vshResources.changed() )
+        if ( _fshResources.changed() )
+        {
+            data.uintVal = _fshResources;
+            _driver->writeGPURegister(arch::GPU_FRAGMENT_THREAD_RESOURCES, data);
+            _fshResources.restart();
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// Synchronize streams state ((buffers attached automatically synchronized ///
+    ///////////////////////////////////////////////////////////////////////////////
+    if ( _dirty & DIRTY_STREAMER )
     {
-        data.uintVal = _vshResources;
-        _driver->writeGPURegister(arch::GPU_VERTEX_THREAD_RESOURCES, data);
-        _vshResources.restart();
+        _dirty &= ~DIRTY_STREAMER;
+        _syncStreamerState();
     }
+}
+
+#ifdef GAL_CHECK_DIRTY_STATE
+void GALDeviceImp::_checkDirtyState()
+{
+    U64 registerChanges = _driver->registerChanges();
+    gal_ulonglong uploadedBytes = _moa->uploadedBytes();
 
-    if ( _fshResources.changed() )
+    // A full synchronization after the dirty groups were synchronized must not change the GPU state
+    _dirty = DIRTY_ALL;
+    _syncDirtyState();
+
+    if ( _driver->registerChanges() != registerChanges || _moa->uploadedBytes() != uploadedBytes )
     {
-        data.uintVal = _fshResources;
-        _driver->writeGPURegister(arch::GPU_FRAGMENT_THREAD_RESOURCES, data);
-        _fshResources.restart();
+        stringstream ss;
+        ss << "Frame " << _currentFrame << " batch " << _currentBatch << ": full state synchronization wrote "
+           << (_driver->registerChanges() - registerChanges) << " registers and uploaded "
+           << (_moa->uploadedBytes() - uploadedBytes) << " bytes not tracked by the dirty state";
+        CG_ASSERT(ss.str().c_str());
     }
+}
+#endif
+
+void GALDeviceImp::_draw(gal_uint start, gal_uint count, gal_uint min, gal_uint max, gal_int baseVertexIndex, gal_uint instances)
+{
+    ///////////////////////////////////////////////////
+    /// Synchronize the state changed since last draw ///
+    ///////////////////////////////////////////////////
+    _syncDirtyState();
+
+#ifdef GAL_CHECK_DIRTY_STATE
+    _checkDirtyState();
+#endif
+
+    //////////////////////////////////
+    /// Synchronize streaming mode ///
+    //////////////////////////////////
+    _syncStreamingMode(start, count, instances, min, max, baseVertexIndex);
 
     // Check if deferred GAL state dump is required
     _check_deferred_dump();
@@ -1555,6 +1584,8 @@ gal_bool GALDeviceImp::swapBuffers()
     TRACING_ENTER_REGION("GAL", "", "")    
     
     cout << "GALDeviceImp::swapBuffers() - OK" << endl;
+    cout << "GALDeviceImp::swapBuffers() - Memory objects: " << _moa->uploadedBytes() << " bytes uploaded | "
+         << _moa->modifiedBytes() << " bytes modified" << endl;
     _driver->sendCommand(arch::GPU_SWAPBUFFERS);
 
     //  If using the default render buffer swap front and back buffers (double buffering).
@@ -1707,6 +1738,7 @@ void GALDeviceImp::clearZStencilBuffer( gal_bool clearZ, gal_bool clearStencil,
 
             _driver->sendCommand( arch::GPU_CLEARZSTENCILBUFFER );
             _hzBufferValid = true; // HZ buffer contents are valid
+            _dirty |= DIRTY_ZSTENCIL;
         }
         else
         {
@@ -1751,6 +1783,7 @@ void GALDeviceImp::clearZStencilBuffer( gal_bool clearZ, gal_bool clearStencil,
             cout << "Warning: Clear Z implemented as Clear Z and Stencil (optimization)" << endl;
             _driver->sendCommand( arch::GPU_CLEARZSTENCILBUFFER );
             _hzBufferValid = true; // HZ buffer contents are valid
+            _dirty |= DIRTY_ZSTENCIL;
         }
         else
         {
@@ -2012,6 +2045,9 @@ void GALDeviceImp::_partialClear(gal_bool clearColor, gal_bool clearZ, gal_bool
     restoreStoredStateItem(storedState[nextReg++]);
 
     _driver->writeGPURegister(arch::GPU_VERTEX_ATTRIBUTE_DEFAULT_VALUE, arch::COLOR_ATTRIBUTE, savedRegState[0]);
+
+    // The state used by the internal draw was restored directly
+    _dirty = DIRTY_ALL;
 }
 
 void GALDeviceImp::clearRenderTarget( GALRenderTarget* rTarget,
@@ -2034,6 +2070,12 @@ void GALDeviceImp::clearZStencilTarget( GALZStencilTarget* zsTarget,
         << (clearStencil ? "TRUE," : "FALSE,") << (gal_uint)stencilValue << ") -> Not implemented yet" << endl;
 }
 
+//  Deletes the tiled render buffer data once the MetaStreams sharing it are released.
+static void releaseTiledData(void *owner, const U08 *data)
+{
+    delete[] data;
+}
+
 void GALDeviceImp::copySurfaceDataToRenderBuffer(GALTexture2D *sourceTexture, gal_uint mipLevel, GALRenderTarget *destRenderTarget, bool preload)
 {
     //  Get a pointer to the source mipmap data.
@@ -2089,20 +2131,20 @@ void GALDeviceImp::copySurfaceDataToRenderBuffer(GALTexture2D *sourceTexture, ga
     //  Get the memory descriptor to the render buffer.
     gal_uint destRenderTargetMD = _moa->md(static_cast<GALTexture2DImp*>(surface.getTexture()), mipLevel);
 
+    //  The MetaStream takes the converted data without copying it and deletes it when released.
+    arch::MetaStreamPayload *payload = arch::MetaStreamPayload::wrap(destData, destDataSize, releaseTiledData, NULL);
+
     //  Check if data is to be preloaded into GPU memory.
     if (preload)
     {
         //  Update the render buffer.
-        _driver->writeMemoryPreload(destRenderTargetMD, 0, destData, destDataSize);
+        _driver->writeMemoryPreload(destRenderTargetMD, 0, payload);
     }
     else
     {
         //  Update the render buffer.
-        _driver->writeMemory(destRenderTargetMD, destData, destDataSize, true);
+        _driver->writeMemory(destRenderTargetMD, 0, payload, true);
     }    
-    
-    //  Delete the converted data.    
-    delete[] destData;
 }
 
 
@@ -2113,25 +2155,29 @@ void GALDeviceImp::getShaderLimits(GAL_SHADER_TYPE type, GAL_SHADER_LIMITS* limi
 
 GALShaderProgram* GALDeviceImp::createShaderProgram() const
 {
-    return new GALShaderProgramImp();
+    GALShaderProgramImp* program = new GALShaderProgramImp();
+    return _registerObject(program, OBJECT_SHADER_PROGRAM, program);
 }
 
 void GALDeviceImp::setGeometryShader(GALShaderProgram* program)
 {
     GALShaderProgramImp* gsh = static_cast<GALShaderProgramImp*>(program);
     _gsh = gsh;
+    _dirty |= DIRTY_VERTEX_SHADER;
 }
 
 void GALDeviceImp::setVertexShader(GALShaderProgram* program)
 {
     GALShaderProgramImp* vsh = static_cast<GALShaderProgramImp*>(program);
     _vsh = vsh;
+    _dirty |= DIRTY_VERTEX_SHADER;
 }
 
 void GALDeviceImp::setFragmentShader(GALShaderProgram* program)
 {
     GALShaderProgramImp* fsh = static_cast<GALShaderProgramImp*>(program);
     _fsh = fsh;
+    _dirty |= DIRTY_FRAGMENT_SHADER;
 }
 
 void GALDeviceImp::setVertexDefaultValue(gal_float currentColor[4])
@@ -2143,6 +2189,7 @@ void GALDeviceImp::setVertexDefaultValue(gal_float currentColor[4])
     color[3] = currentColor[3];
 
     _currentColor = color;
+    _dirty |= DIRTY_VERTEX_SHADER;
 }
 
 void GALDeviceImp::_syncVertexShader()
@@ -2535,6 +2582,418 @@ void GALDeviceImp::destroyState(GALStoredState* state)
     delete ssi;
 }
 
+void GALDeviceImp::_registerObject(gal_uint id, ObjectKind kind, void* object, MemoryObject* memoryObject) const
+{
+    ObjectInfo info;
+    info.kind = kind;
+    info.object = object;
+    info.memoryObject = memoryObject;
+
+    _objects[id] = info;
+    _objectIDs[object] = id;
+    if ( memoryObject != 0 )
+        _memoryObjectIDs[memoryObject] = id;
+}
+
+void GALDeviceImp::_unregisterObject(const void* object)
+{
+    map<const void*, gal_uint>::iterator it = _objectIDs.find(object);
+    if ( it == _objectIDs.end() )
+        CG_ASSERT("Object not created by the device");
+
+    map<gal_uint, ObjectInfo>::iterator itObject = _objects.find(it->second);
+    if ( itObject->second.memoryObject != 0 )
+        _memoryObjectIDs.erase(itObject->second.memoryObject);
+
+    _objects.erase(itObject);
+    _objectIDs.erase(it);
+}
+
+void* GALDeviceImp::_createObject(ObjectKind kind, MemoryObject*& memoryObject)
+{
+    switch ( kind )
+    {
+        case OBJECT_BUFFER:
+            {
+                GALBufferImp* buf = new GALBufferImp(0, 0);
+                memoryObject = buf;
+                return buf;
+            }
+        case OBJECT_TEXTURE2D:
+            {
+                GALTexture2DImp* tex = new GALTexture2DImp();
+                memoryObject = tex;
+                return tex;
+            }
+        case OBJECT_TEXTURE3D:
+            {
+                GALTexture3DImp* tex = new GALTexture3DImp();
+                memoryObject = tex;
+                return tex;
+            }
+        case OBJECT_TEXTURECM:
+            {
+                GALTextureCubeMapImp* tex = new GALTextureCubeMapImp();
+                memoryObject = tex;
+                return tex;
+            }
+        case OBJECT_RENDER_TARGET:
+            memoryObject = 0;
+            return new GALRenderTargetImp(this);
+        case OBJECT_SHADER_PROGRAM:
+            {
+                GALShaderProgramImp* program = new GALShaderProgramImp();
+                memoryObject = program;
+                return program;
+            }
+        default:
+            CG_ASSERT("Unknown object kind");
+    }
+    return 0;
+}
+
+void GALDeviceImp::_deleteObject(const ObjectInfo& info)
+{
+    switch ( info.kind )
+    {
+        case OBJECT_BUFFER:         delete static_cast<GALBufferImp*>(info.object);         break;
+        case OBJECT_TEXTURE2D:      delete static_cast<GALTexture2DImp*>(info.object);      break;
+        case OBJECT_TEXTURE3D:      delete static_cast<GALTexture3DImp*>(info.object);      break;
+        case OBJECT_TEXTURECM:      delete static_cast<GALTextureCubeMapImp*>(info.object); break;
+        case OBJECT_RENDER_TARGET:  delete static_cast<GALRenderTargetImp*>(info.object);   break;
+        case OBJECT_SHADER_PROGRAM: delete static_cast<GALShaderProgramImp*>(info.object);  break;
+        default:
+            CG_ASSERT("Unknown object kind");
+    }
+}
+
+void GALDeviceImp::_saveObject(std::ostream& out, const ObjectInfo& info)
+{
+    switch ( info.kind )
+    {
+        case OBJECT_BUFFER:         static_cast<GALBufferImp*>(info.object)->saveState(out);         break;
+        case OBJECT_TEXTURE2D:      static_cast<GALTexture2DImp*>(info.object)->saveState(out);      break;
+        case OBJECT_TEXTURE3D:      static_cast<GALTexture3DImp*>(info.object)->saveState(out);      break;
+        case OBJECT_TEXTURECM:      static_cast<GALTextureCubeMapImp*>(info.object)->saveState(out); break;
+        case OBJECT_RENDER_TARGET:  static_cast<GALRenderTargetImp*>(info.object)->saveState(out);   break;
+        case OBJECT_SHADER_PROGRAM: static_cast<GALShaderProgramImp*>(info.object)->saveState(out);  break;
+        default:
+            CG_ASSERT("Unknown object kind");
+    }
+}
+
+void GALDeviceImp::_restoreObject(std::istream& in, const ObjectInfo& info)
+{
+    switch ( info.kind )
+    {
+        case OBJECT_BUFFER:         static_cast<GALBufferImp*>(info.object)->restoreState(in);         break;
+        case OBJECT_TEXTURE2D:      static_cast<GALTexture2DImp*>(info.object)->restoreState(in);      break;
+        case OBJECT_TEXTURE3D:      static_cast<GALTexture3DImp*>(info.object)->restoreState(in);      break;
+        case OBJECT_TEXTURECM:      static_cast<GALTextureCubeMapImp*>(info.object)->restoreState(in); break;
+        case OBJECT_RENDER_TARGET:  static_cast<GALRenderTargetImp*>(info.object)->restoreState(in);   break;
+        case OBJECT_SHADER_PROGRAM: static_cast<GALShaderProgramImp*>(info.object)->restoreState(in);  break;
+        default:
+            CG_ASSERT("Unknown object kind");
+    }
+}
+
+gal_uint GALDeviceImp::_objectID(const void* object)
+{
+    if ( object == 0 )
+        return 0;
+
+    map<const void*, gal_uint>::const_iterator it = _objectIDs.find(object);
+    if ( it != _objectIDs.end() )
+        return it->second;
+
+    //  Pointer to an object already destroyed.
+    it = _staleObjectIDs.find(object);
+    if ( it != _staleObjectIDs.end() )
+        return it->second;
+
+    gal_uint id = STALE_OBJECT_ID + (gal_uint) _staleObjectIDs.size();
+    _staleObjectIDs[object] = id;
+    return id;
+}
+
+void* GALDeviceImp::_objectByID(gal_uint id)
+{
+    if ( id == 0 )
+        return 0;
+
+    map<gal_uint, ObjectInfo>::const_iterator it = _objects.find(id);
+    if ( it != _objects.end() )
+        return it->second.object;
+
+    if ( id < STALE_OBJECT_ID )
+        CG_ASSERT("Object not defined in the checkpoint");
+
+    gal_ubyte*& placeholder = _staleObjects[id];
+    if ( placeholder == 0 )
+        placeholder = new gal_ubyte[1];
+    return placeholder;
+}
+
+gal_uint GALDeviceImp::objectID(const GALResource* resource)
+{
+    return _objectID(resource);
+}
+
+gal_uint GALDeviceImp::objectID(const GALRenderTarget* renderTarget)
+{
+    return _objectID(renderTarget);
+}
+
+gal_uint GALDeviceImp::objectID(const GALShaderProgram* program)
+{
+    return _objectID(program);
+}
+
+GALResource* GALDeviceImp::resourceByID(gal_uint id)
+{
+    map<gal_uint, ObjectInfo>::const_iterator it = _objects.find(id);
+    if ( it == _objects.end() )
+        return static_cast<GALResource*>(_objectByID(id));
+
+    switch ( it->second.kind )
+    {
+        case OBJECT_BUFFER:     return static_cast<GALBufferImp*>(it->second.object);
+        case OBJECT_TEXTURE2D:  return static_cast<GALTexture2DImp*>(it->second.object);
+        case OBJECT_TEXTURE3D:  return static_cast<GALTexture3DImp*>(it->second.object);
+        case OBJECT_TEXTURECM:  return static_cast<GALTextureCubeMapImp*>(it->second.object);
+        default:
+            CG_ASSERT("The object is not a resource");
+    }
+    return 0;
+}
+
+GALRenderTarget* GALDeviceImp::renderTargetByID(gal_uint id)
+{
+    map<gal_uint, ObjectInfo>::const_iterator it = _objects.find(id);
+    if ( it != _objects.end() && it->second.kind != OBJECT_RENDER_TARGET )
+        CG_ASSERT("The object is not a render target");
+
+    return static_cast<GALRenderTargetImp*>(_objectByID(id));
+}
+
+GALShaderProgram* GALDeviceImp::shaderProgramByID(gal_uint id)
+{
+    map<gal_uint, ObjectInfo>::const_iterator it = _objects.find(id);
+    if ( it != _objects.end() && it->second.kind != OBJECT_SHADER_PROGRAM )
+        CG_ASSERT("The object is not a shader program");
+
+    return static_cast<GALShaderProgramImp*>(_objectByID(id));
+}
+
+gal_uint GALDeviceImp::memoryObjectID(const MemoryObject* memoryObject)
+{
+    map<const void*, gal_uint>::const_iterator it = _memoryObjectIDs.find(memoryObject);
+    if ( it == _memoryObjectIDs.end() )
+        CG_ASSERT("Memory object not created by the device");
+    return it->second;
+}
+
+MemoryObject* GALDeviceImp::memoryObjectByID(gal_uint id)
+{
+    map<gal_uint, ObjectInfo>::const_iterator it = _objects.find(id);
+    if ( it == _objects.end() || it->second.memoryObject == 0 )
+        CG_ASSERT("Memory object not defined in the checkpoint");
+    return it->second.memoryObject;
+}
+
+void GALDeviceImp::saveState(std::ostream& out)
+{
+    _staleObjectIDs.clear();
+
+    //  Objects created by the device, first the table so the references between objects
+    //  can be restored, then their contents.
+    checkpoint::saveValue(out, _nextObjectID);
+    checkpoint::saveValue(out, (gal_uint) _objects.size());
+    map<gal_uint, ObjectInfo>::const_iterator it = _objects.begin();
+    for ( ; it != _objects.end(); ++it )
+    {
+        checkpoint::saveValue(out, it->first);
+        checkpoint::saveValue(out, it->second.kind);
+    }
+    for ( it = _objects.begin(); it != _objects.end(); ++it )
+        _saveObject(out, it->second);
+
+    _moa->saveState(out, *this);
+
+    //  Device state.
+    checkpoint::saveValue(out, zValuePartialClear);
+    checkpoint::saveValue(out, _primitive);
+    checkpoint::saveValue(out, _indexedMode);
+    checkpoint::saveValue(out, _clearColorBuffer);
+    checkpoint::saveValue(out, _zClearValue);
+    checkpoint::saveValue(out, _stencilClearValue);
+    checkpoint::saveValue(out, _hzActivated);
+    checkpoint::saveValue(out, _hzBufferValid);
+    checkpoint::saveValue(out, _streamStart);
+    checkpoint::saveValue(out, _streamCount);
+    checkpoint::saveValue(out, _streamInstances);
+    checkpoint::saveValue(out, _streamBaseVertex);
+    checkpoint::saveValue(out, _defaultRenderBuffers);
+    checkpoint::saveValue(out, _defaultZStencilBufferInUse);
+    checkpoint::saveValue(out, _mdColorBufferSavedState);
+    checkpoint::saveValue(out, _mdZStencilBufferSavedState);
+    checkpoint::saveValue(out, _colorSRGBWrite);
+    checkpoint::saveValue(out, _vshResources);
+    checkpoint::saveValue(out, _fshResources);
+    checkpoint::saveValue(out, _gpuMemGshTrack);
+    checkpoint::saveValue(out, _gpuMemVshTrack);
+    checkpoint::saveValue(out, _gpuMemFshTrack);
+    checkpoint::saveValue(out, _startFrame);
+    checkpoint::saveValue(out, _currentFrame);
+    checkpoint::saveValue(out, _currentBatch);
+    checkpoint::saveValue(out, _alphaTest);
+    checkpoint::saveValue(out, _earlyZ);
+    checkpoint::saveValue(out, _requiredSync);
+    checkpoint::saveValue(out, _dirty);
+    checkpoint::saveValue(out, _memoryChanges);
+    checkpoint::saveData(out, _currentColor);
+    checkpoint::saveVector(out, _vaMap);
+    checkpoint::saveVector(out, _vshOutputs);
+    checkpoint::saveVector(out, _fshInputs);
+    checkpoint::saveSet(out, _usedStreams);
+
+    saveObjectItem(out, _defaultBackBuffer);
+    saveObjectItem(out, _defaultFrontBuffer);
+    saveObjectItem(out, _defaultZStencilBuffer);
+    saveObjectItem(out, _currentZStencilBuffer);
+    saveObjectItem(out, _gsh);
+    saveObjectItem(out, _vsh);
+    saveObjectItem(out, _fsh);
+    for ( gal_uint i = 0; i < GAL_MAX_RENDER_TARGETS; i++ )
+        saveObjectItem(out, _currentRenderTarget[i]);
+
+    checkpoint::saveValue(out, _objectID(vertexBufferPartialClear));
+    checkpoint::saveValue(out, _objectID(_defaultVshProgram));
+    checkpoint::saveValue(out, _objectID(_defaultFshProgram));
+
+    _blending->saveState(out);
+    _rast->saveState(out);
+    _zStencil->saveState(out);
+
+    for ( gal_uint i = 0; i < _MAX_STREAMS; i++ )
+        _stream[i]->saveState(out);
+    _indexStream->saveState(out);
+
+    for ( gal_uint i = 0; i < arch::MAX_TEXTURES; i++ )
+        _sampler[i]->saveState(out);
+}
+
+void GALDeviceImp::restoreState(std::istream& in)
+{
+    gal_uint nextObjectID = checkpoint::loadValue<gal_uint>(in);
+
+    gal_uint objects = checkpoint::loadValue<gal_uint>(in);
+    vector<gal_uint> ids(objects);
+    map<gal_uint, ObjectKind> kinds;
+    for ( gal_uint i = 0; i < objects; i++ )
+    {
+        checkpoint::loadValue(in, ids[i]);
+        checkpoint::loadValue(in, kinds[ids[i]]);
+    }
+
+    //  Delete the objects not defined in the checkpoint.  No commands are sent to the GPU
+    //  driver, the allocator and driver state are restored from the checkpoint.
+    map<gal_uint, ObjectInfo>::iterator it = _objects.begin();
+    while ( it != _objects.end() )
+    {
+        map<gal_uint, ObjectKind>::const_iterator itKind = kinds.find(it->first);
+        ObjectInfo info = it->second;
+        ++it;
+
+        if ( itKind == kinds.end() || itKind->second != info.kind )
+        {
+            _unregisterObject(info.object);
+            _deleteObject(info);
+        }
+    }
+
+    //  Create the objects not yet created (objects created by this device in the same
+    //  order, before the checkpoint is loaded, are restored in place).
+    for ( gal_uint i = 0; i < objects; i++ )
+    {
+        if ( _objects.find(ids[i]) == _objects.end() )
+        {
+            MemoryObject* memoryObject;
+            void* object = _createObject(kinds[ids[i]], memoryObject);
+            _registerObject(ids[i], kinds[ids[i]], object, memoryObject);
+        }
+    }
+
+    for ( gal_uint i = 0; i < objects; i++ )
+        _restoreObject(in, _objects[ids[i]]);
+
+    _nextObjectID = nextObjectID;
+
+    _moa->restoreState(in, *this);
+
+    //  Device state.
+    checkpoint::loadValue(in, zValuePartialClear);
+    checkpoint::loadValue(in, _primitive);
+    checkpoint::loadValue(in, _indexedMode);
+    checkpoint::loadValue(in, _clearColorBuffer);
+    checkpoint::loadValue(in, _zClearValue);
+    checkpoint::loadValue(in, _stencilClearValue);
+    checkpoint::loadValue(in, _hzActivated);
+    checkpoint::loadValue(in, _hzBufferValid);
+    checkpoint::loadValue(in, _streamStart);
+    checkpoint::loadValue(in, _streamCount);
+    checkpoint::loadValue(in, _streamInstances);
+    checkpoint::loadValue(in, _streamBaseVertex);
+    checkpoint::loadValue(in, _defaultRenderBuffers);
+    checkpoint::loadValue(in, _defaultZStencilBufferInUse);
+    checkpoint::loadValue(in, _mdColorBufferSavedState);
+    checkpoint::loadValue(in, _mdZStencilBufferSavedState);
+    checkpoint::loadValue(in, _colorSRGBWrite);
+    checkpoint::loadValue(in, _vshResources);
+    checkpoint::loadValue(in, _fshResources);
+    checkpoint::loadValue(in, _gpuMemGshTrack);
+    checkpoint::loadValue(in, _gpuMemVshTrack);
+    checkpoint::loadValue(in, _gpuMemFshTrack);
+    checkpoint::loadValue(in, _startFrame);
+    checkpoint::loadValue(in, _currentFrame);
+    checkpoint::loadValue(in, _currentBatch);
+    checkpoint::loadValue(in, _alphaTest);
+    checkpoint::loadValue(in, _earlyZ);
+    checkpoint::loadValue(in, _requiredSync);
+    checkpoint::loadValue(in, _dirty);
+    checkpoint::loadValue(in, _memoryChanges);
+    checkpoint::loadData(in, _currentColor);
+    checkpoint::loadVector(in, _vaMap);
+    checkpoint::loadVector(in, _vshOutputs);
+    checkpoint::loadVector(in, _fshInputs);
+    checkpoint::loadSet(in, _usedStreams);
+
+    restoreObjectItem(in, _defaultBackBuffer);
+    restoreObjectItem(in, _defaultFrontBuffer);
+    restoreObjectItem(in, _defaultZStencilBuffer);
+    restoreObjectItem(in, _currentZStencilBuffer);
+    restoreObjectItem(in, _gsh);
+    restoreObjectItem(in, _vsh);
+    restoreObjectItem(in, _fsh);
+    for ( gal_uint i = 0; i < GAL_MAX_RENDER_TARGETS; i++ )
+        restoreObjectItem(in, _currentRenderTarget[i]);
+
+    vertexBufferPartialClear = static_cast<GALBuffer*>(resourceByID(checkpoint::loadValue<gal_uint>(in)));
+    _defaultVshProgram = static_cast<GALShaderProgramImp*>(shaderProgramByID(checkpoint::loadValue<gal_uint>(in)));
+    _defaultFshProgram = static_cast<GALShaderProgramImp*>(shaderProgramByID(checkpoint::loadValue<gal_uint>(in)));
+
+    _blending->restoreState(in);
+    _rast->restoreState(in);
+    _zStencil->restoreState(in);
+
+    for ( gal_uint i = 0; i < _MAX_STREAMS; i++ )
+        _stream[i]->restoreState(in);
+    _indexStream->restoreState(in);
+
+    for ( gal_uint i = 0; i < arch::MAX_TEXTURES; i++ )
+        _sampler[i]->restoreState(in);
+}
+
 void GALDeviceImp::DBG_dump(const gal_char* file, gal_enum flags)
 {
     _dump(file, flags);
@@ -2682,6 +3141,7 @@ void GALDeviceImp::_syncHZRegister()
 void GALDeviceImp::alphaTestEnabled(gal_bool enabled)
 {
     _alphaTest = enabled;
+    _dirty |= DIRTY_FRAGMENT_SHADER;
 }
 
 const StoredStateItem* GALDeviceImp::createStoredStateItem(GAL_STORED_ITEM_ID stateId) const
@@ -2754,6 +3214,8 @@ void GALDeviceImp::restoreStoredStateItem(const StoredStateItem* ssi)
 {
     TRACING_ENTER_REGION("GAL", "", "")
 
+    _dirty = DIRTY_ALL;
+
     const GALStoredStateItem* galssi = static_cast<const GALStoredStateItem*>(ssi);
     gal_uint aux;
 
@@ -2900,7 +3362,7 @@ void GALDeviceImp::copyMipmap (GALTexture* inTexture, libGAL::GAL_CUBEMAP_FACE i
 	if(adaptedOut.getWidth(outFace, outMipmap) > outX + outWidth || adaptedOut.getHeight(outFace, outMipmap) > outY + outHeight)
 		CG_ASSERT("The region to copy of the output texture is partially or totally out of the texture mipmap");	
 		
-    GALRenderTargetImp* outRT = new GALRenderTargetImp(this, outTexture, GAL_RT_DIMENSION_TEXTURE2D, inFace, inMipmap);
+    GALRenderTargetImp* outRT = _registerObject(new GALRenderTargetImp(this, outTexture, GAL_RT_DIMENSION_TEXTURE2D, inFace, inMipmap), OBJECT_RENDER_TARGET, 0);
     
     arch::GPURegData data;
     vector<arch::GPURegData> savedRegState;
@@ -3265,6 +3727,9 @@ void GALDeviceImp::copyTexture2RenderTarget(GALTexture2DImp* texture, GALRenderT
     _sampler[0]->restoreStoredStateItem(storedState[nextReg++]);
 
     _driver->writeGPURegister(arch::GPU_VERTEX_ATTRIBUTE_DEFAULT_VALUE, arch::COLOR_ATTRIBUTE, savedRegState[0]);
+
+    // The state used by the internal draw was restored directly
+    _dirty = DIRTY_ALL;
 }
 
 GALRenderTarget* GALDeviceImp::getFrontBufferRT()
@@ -3303,6 +3768,7 @@ void GALDeviceImp::setColorSRGBWrite(libGAL::gal_bool enable)
 {
     //  Set the color conversion from linear to sRGB on color write flag.
     _colorSRGBWrite = enable;
+    _dirty |= DIRTY_RENDER_BUFFERS;
 }
 
 gal_ubyte* GALDeviceImp::compressTexture(GAL_FORMAT originalFormat, GAL_FORMAT compressFormat, gal_uint width, gal_uint height, gal_ubyte* originalData, gal_uint selectionMode)
@@ -15,15 +15,18 @@
 #include "GALTextureCubeMap.h"
 #include "GALTexture2DImp.h"
 #include "GALSampler.h"
+#include "CheckpointStream.h"
 
 
 #include <vector>
 #include <set>
+#include <map>
 #include <string>
 
 
 //#define GAL_DUMP_STREAMS
 //#define GAL_DUMP_SAMPLERS
+//#define GAL_CHECK_DIRTY_STATE
 
 class HAL;
 
@@ -91,6 +94,14 @@ public:
     virtual GALStoredState* saveAllState() const;
     virtual void destroyState(GALStoredState* state);
     virtual void restoreState(const GALStoredState* state);
+    virtual void saveState(std::ostream& out);
+    virtual void restoreState(std::istream& in);
+    virtual gal_uint objectID(const GALResource* resource);
+    virtual gal_uint objectID(const GALRenderTarget* renderTarget);
+    virtual gal_uint objectID(const GALShaderProgram* program);
+    virtual GALResource* resourceByID(gal_uint id);
+    virtual GALRenderTarget* renderTargetByID(gal_uint id);
+    virtual GALShaderProgram* shaderProgramByID(gal_uint id);
     virtual void setStartFrame(gal_uint startFrame);
     virtual void DBG_dump(const gal_char* file, gal_enum flags);
     virtual void DBG_deferred_dump(const gal_char* file, gal_enum flags, gal_uint frame, gal_uint batch);
@@ -146,6 +157,44 @@ public:
 
     virtual gal_uint getCurrentBatch();
 
+    // Checkpoint support for the allocator, that keys its state by MemoryObject
+    gal_uint memoryObjectID(const MemoryObject* memoryObject);
+    MemoryObject* memoryObjectByID(gal_uint id);
+
+    // Checkpoint support for the state items that hold device objects (initial and current values)
+    template<class T>
+    void saveObjectItem(std::ostream& out, const StateItem<T*>& item)
+    {
+        checkpoint::saveValue(out, _objectID(item.initial()));
+        checkpoint::saveValue(out, _objectID(item));
+    }
+
+    template<class T>
+    void restoreObjectItem(std::istream& in, StateItem<T*>& item)
+    {
+        item = static_cast<T*>(_objectByID(checkpoint::loadValue<gal_uint>(in)));
+        item.restart();
+        item = static_cast<T*>(_objectByID(checkpoint::loadValue<gal_uint>(in)));
+    }
+
+    // State groups synchronized by the next draw if they were changed
+    enum DirtyState
+    {
+        DIRTY_RENDER_BUFFERS  = 0x0001,
+        DIRTY_RASTERIZATION   = 0x0002,
+        DIRTY_ZSTENCIL        = 0x0004,
+        DIRTY_BLENDING        = 0x0008,
+        DIRTY_PRIMITIVE       = 0x0010,
+        DIRTY_SAMPLERS        = 0x0020,
+        DIRTY_VERTEX_SHADER   = 0x0040,
+        DIRTY_FRAGMENT_SHADER = 0x0080,
+        DIRTY_STREAMER        = 0x0100,
+        DIRTY_ALL             = 0x01ff
+    };
+
+    // Called by the state setters of the device and its stages, samplers and streams
+    void setDirty(gal_uint groups) { _dirty |= groups; }
+
 private:
 
     static gal_uint _packRGBA8888(gal_ubyte red, gal_ubyte green, gal_uint blue, gal_uint alpha);
@@ -190,6 +239,7 @@ private:
     StateItem<gal_uint> _streamStart;
     StateItem<gal_uint> _streamCount;
     StateItem<gal_uint> _streamInstances;
+    StateItem<gal_int> _streamBaseVertex;
 
     // Enables or disables Hierarchical Z test depending on current GALDevice state
     void _syncHZRegister();
@@ -270,12 +320,68 @@ private:
 
     gal_uint _requiredSync;
 
+    gal_uint _dirty; // DirtyState groups changed since the last draw
+    gal_uint _memoryChanges; // MemoryObject::changes() at the last draw
+
+    // Synchronizes the dirty state groups
+    void _syncDirtyState();
+
+    // Objects created by the device, identified in the checkpoints by their creation order
+    enum ObjectKind
+    {
+        OBJECT_BUFFER,
+        OBJECT_TEXTURE2D,
+        OBJECT_TEXTURE3D,
+        OBJECT_TEXTURECM,
+        OBJECT_RENDER_TARGET,
+        OBJECT_SHADER_PROGRAM
+    };
+
+    struct ObjectInfo
+    {
+        ObjectKind kind;
+        void* object;               // The implementation object (GALBufferImp*, GALTexture2DImp*, ...)
+        MemoryObject* memoryObject; // The same object as a MemoryObject (NULL for render targets)
+    };
+
+    mutable gal_uint _nextObjectID;
+    mutable std::map<gal_uint, ObjectInfo> _objects;
+    mutable std::map<const void*, gal_uint> _objectIDs;
+    mutable std::map<const void*, gal_uint> _memoryObjectIDs;
+
+    // The state can keep pointers to destroyed objects (only compared, never used).  They are
+    // saved with their own identifiers and restored as placeholders owned by the device.
+    static const gal_uint STALE_OBJECT_ID = 0x80000000;
+    std::map<const void*, gal_uint> _staleObjectIDs;
+    std::map<gal_uint, gal_ubyte*> _staleObjects;
+
+    template<class T>
+    T* _registerObject(T* object, ObjectKind kind, MemoryObject* memoryObject) const
+    {
+        _registerObject(_nextObjectID++, kind, object, memoryObject);
+        return object;
+    }
+
+    void _registerObject(gal_uint id, ObjectKind kind, void* object, MemoryObject* memoryObject) const;
+    void _unregisterObject(const void* object);
+    void* _createObject(ObjectKind kind, MemoryObject*& memoryObject);
+    void _deleteObject(const ObjectInfo& info);
+    void _saveObject(std::ostream& out, const ObjectInfo& info);
+    void _restoreObject(std::istream& in, const ObjectInfo& info);
+    gal_uint _objectID(const void* object);
+    void* _objectByID(gal_uint id);
+
+#ifdef GAL_CHECK_DIRTY_STATE
+    // Asserts that a full synchronization doesn't change the GPU state after the dirty groups were synchronized
+    void _checkDirtyState();
+#endif
+
     void _syncVertexShader();
     void _syncFragmentShader();
 
     void _optimizeShader(GALShaderProgramImp* shProgramImp, GAL_SHADER_TYPE shType);
 
-    void _syncStreamingMode(gal_uint start, gal_uint count, gal_uint instances, gal_uint min, gal_uint max);
+    void _syncStreamingMode(gal_uint start, gal_uint count, gal_uint instances, gal_uint min, gal_uint max, gal_int baseVertexIndex);
 
     void _partialClear(gal_bool clearColor, gal_bool clearZ, gal_bool clearStencil, 
                        gal_ubyte red, gal_ubyte green, gal_ubyte blue, gal_ubyte alpha,
@@ -283,11 +389,9 @@ private:
     
     // Generic draw command
     void _draw(gal_uint start, gal_uint count, gal_uint min, gal_uint max,
-               gal_uint baseVertexIndex = 0,
+               gal_int baseVertexIndex = 0,
                gal_uint instances = 1);
 
-    void _addBaseVertexIndex(gal_uint baseVertexIndex, gal_uint start, gal_uint count);
-
     void _syncSamplerState();
 
     void _translatePrimitive(GAL_PRIMITIVE primitive, arch::GPURegData* data);
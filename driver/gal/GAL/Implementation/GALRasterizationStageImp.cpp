@@ -3,6 +3,8 @@
  */
 
 #include "GALRasterizationStageImp.h"
+#include "GALDeviceImp.h"
+#include "CheckpointStream.h"
 #include <iostream>
 #include <sstream>
 
@@ -37,6 +39,7 @@ GALRasterizationStageImp::GALRasterizationStageImp(GALDeviceImp* device, HAL* dr
 void GALRasterizationStageImp::setInterpolationMode(gal_uint fshInputAttribute, GAL_INTERPOLATION_MODE mode)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     if ( fshInputAttribute >= _interpolation.size() )
         CG_ASSERT("Fragment shader input attribute out of range");
 
@@ -47,6 +50,7 @@ void GALRasterizationStageImp::setInterpolationMode(gal_uint fshInputAttribute,
 void GALRasterizationStageImp::enableScissor(gal_bool enable)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _scissorEnabled = enable;
     TRACING_EXIT_REGION()
 }
@@ -54,6 +58,7 @@ void GALRasterizationStageImp::enableScissor(gal_bool enable)
 void GALRasterizationStageImp::setFillMode(GAL_FILL_MODE fillMode)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _fillMode = fillMode;
     TRACING_EXIT_REGION()
 }
@@ -61,6 +66,7 @@ void GALRasterizationStageImp::setFillMode(GAL_FILL_MODE fillMode)
 void GALRasterizationStageImp::setCullMode(GAL_CULL_MODE cullMode)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _cullMode = cullMode;
     TRACING_EXIT_REGION()
 }
@@ -68,6 +74,7 @@ void GALRasterizationStageImp::setCullMode(GAL_CULL_MODE cullMode)
 void GALRasterizationStageImp::setFaceMode(GAL_FACE_MODE faceMode)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _faceMode = faceMode;
     TRACING_EXIT_REGION()
 }
@@ -75,6 +82,7 @@ void GALRasterizationStageImp::setFaceMode(GAL_FACE_MODE faceMode)
 void GALRasterizationStageImp::useD3D9RasterizationRules(gal_bool use)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _useD3D9RasterizationRules = use;
     TRACING_EXIT_REGION()
 }
@@ -82,6 +90,7 @@ void GALRasterizationStageImp::useD3D9RasterizationRules(gal_bool use)
 void GALRasterizationStageImp::useD3D9PixelCoordConvention(gal_bool use)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _useD3D9PixelCoordConvention = use;
     TRACING_EXIT_REGION()
 }
@@ -89,6 +98,7 @@ void GALRasterizationStageImp::useD3D9PixelCoordConvention(gal_bool use)
 void GALRasterizationStageImp::setViewport(gal_int x, gal_int y, gal_uint width, gal_uint height)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _xViewport = x;
     _yViewport = y;
     _widthViewport = width;
@@ -99,6 +109,7 @@ void GALRasterizationStageImp::setViewport(gal_int x, gal_int y, gal_uint width,
 void GALRasterizationStageImp::setScissor(gal_int x, gal_int y, gal_uint width, gal_uint height)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     _xScissor = x;
     _yScissor= y;
     _widthScissor = width;
@@ -393,6 +404,7 @@ const StoredStateItem* GALRasterizationStageImp::createStoredStateItem(GAL_STORE
 void GALRasterizationStageImp::restoreStoredStateItem(const StoredStateItem* ssi)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
     const GALStoredStateItem* galssi = static_cast<const GALStoredStateItem*>(ssi);
     gal_uint interpolation;
 
@@ -474,6 +486,7 @@ GALStoredState* GALRasterizationStageImp::saveAllState() const
 void GALRasterizationStageImp::restoreAllState(const GALStoredState* state)
 {
     TRACING_ENTER_REGION("GAL", "", "")    
+    _device->setDirty(GALDeviceImp::DIRTY_RASTERIZATION);
 
     const GALStoredStateImp* ssi = static_cast<const GALStoredStateImp*>(state);
 
@@ -491,3 +504,43 @@ void GALRasterizationStageImp::restoreAllState(const GALStoredState* state)
     TRACING_EXIT_REGION()
 
 }
+
+void GALRasterizationStageImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _syncRequired);
+    checkpoint::saveValue(out, _fillMode);
+    checkpoint::saveValue(out, _cullMode);
+    checkpoint::saveValue(out, _faceMode);
+    checkpoint::saveValue(out, _xViewport);
+    checkpoint::saveValue(out, _yViewport);
+    checkpoint::saveValue(out, _widthViewport);
+    checkpoint::saveValue(out, _heightViewport);
+    checkpoint::saveValue(out, _scissorEnabled);
+    checkpoint::saveValue(out, _xScissor);
+    checkpoint::saveValue(out, _yScissor);
+    checkpoint::saveValue(out, _widthScissor);
+    checkpoint::saveValue(out, _heightScissor);
+    checkpoint::saveValue(out, _useD3D9RasterizationRules);
+    checkpoint::saveValue(out, _useD3D9PixelCoordConvention);
+    checkpoint::saveVector(out, _interpolation);
+}
+
+void GALRasterizationStageImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _syncRequired);
+    checkpoint::loadValue(in, _fillMode);
+    checkpoint::loadValue(in, _cullMode);
+    checkpoint::loadValue(in, _faceMode);
+    checkpoint::loadValue(in, _xViewport);
+    checkpoint::loadValue(in, _yViewport);
+    checkpoint::loadValue(in, _widthViewport);
+    checkpoint::loadValue(in, _heightViewport);
+    checkpoint::loadValue(in, _scissorEnabled);
+    checkpoint::loadValue(in, _xScissor);
+    checkpoint::loadValue(in, _yScissor);
+    checkpoint::loadValue(in, _widthScissor);
+    checkpoint::loadValue(in, _heightScissor);
+    checkpoint::loadValue(in, _useD3D9RasterizationRules);
+    checkpoint::loadValue(in, _useD3D9PixelCoordConvention);
+    checkpoint::loadVector(in, _interpolation);
+}
@@ -6,6 +6,7 @@
 #include "GALDeviceImp.h"
 #include "GALTexture2DImp.h"
 #include "GALSampler.h"
+#include "CheckpointStream.h"
 
 using namespace libGAL;
 
@@ -167,6 +168,31 @@ GALRenderTargetImp::GALRenderTargetImp(GALDeviceImp* device, gal_uint width, gal
 
 }
 
+GALRenderTargetImp::GALRenderTargetImp(GALDeviceImp* device) :
+    _device(device), _dimension(GAL_RT_DIMENSION_UNKNOWN), _surface(static_cast<GALTexture2D*>(0)),
+    _face(static_cast<GAL_CUBEMAP_FACE>(0)), _mipLevel(0), _compression(false)
+{
+}
+
+void GALRenderTargetImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _dimension);
+    checkpoint::saveValue(out, _device->objectID(_surface.getTexture()));
+    checkpoint::saveValue(out, _face);
+    checkpoint::saveValue(out, _mipLevel);
+    checkpoint::saveValue(out, _compression);
+}
+
+void GALRenderTargetImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _dimension);
+    GALTexture* texture = static_cast<GALTexture*>(_device->resourceByID(checkpoint::loadValue<gal_uint>(in)));
+    _surface = TextureAdapter(texture);
+    checkpoint::loadValue(in, _face);
+    checkpoint::loadValue(in, _mipLevel);
+    checkpoint::loadValue(in, _compression);
+}
+
 gal_uint GALRenderTargetImp::getWidth() const
 {
     return _surface.getWidth(_face, _mipLevel);
@@ -22,6 +22,9 @@ public:
     GALRenderTargetImp(GALDeviceImp* device, GALTexture* resource, GAL_RT_DIMENSION dimension, GAL_CUBEMAP_FACE face, gal_uint mipLevel);
     GALRenderTargetImp(GALDeviceImp* device, gal_uint width, gal_uint height, gal_bool multisampling, gal_uint samples, GAL_FORMAT format, bool compression, gal_uint md);
 
+    // Creates an undefined render target, defined later with restoreState
+    GALRenderTargetImp(GALDeviceImp* device);
+
     virtual gal_uint getWidth() const;
     virtual gal_uint getHeight() const;
     virtual gal_bool isMultisampled() const;
@@ -32,6 +35,10 @@ public:
 
     gal_uint md();
 
+    // Checkpoint support: the render target surface (the texture is saved by the device)
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
     
     GALDeviceImp* _device;
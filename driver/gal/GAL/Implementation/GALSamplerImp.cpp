@@ -12,6 +12,7 @@
 #include "GALTexture2DImp.h"
 #include "GALTextureCubeMapImp.h"
 #include "TextureAdapter.h"
+#include "CheckpointStream.h"
 #include "Profiler.h"
 
 using namespace libGAL;
@@ -50,13 +51,18 @@ GALSamplerImp::GALSamplerImp(GALDeviceImp* device, HAL* driver, gal_uint sampler
     forceSync(); // init GPU sampler(i) state registers
 }
 
-void GALSamplerImp::setEnabled(gal_bool enable) { _enabled = enable; }
+void GALSamplerImp::setEnabled(gal_bool enable)
+{
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
+    _enabled = enable;
+}
 
 gal_bool GALSamplerImp::isEnabled() const { return _enabled; }
 
 void GALSamplerImp::setTexture(GALTexture* texture)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     GAL_ASSERT(
         if ( texture->getType() == GAL_RESOURCE_TEXTURE1D )
             CG_ASSERT("1D textures are not supported yet");
@@ -70,6 +76,7 @@ void GALSamplerImp::setTexture(GALTexture* texture)
 void GALSamplerImp::setTextureAddressMode(GAL_TEXTURE_COORD coord, GAL_TEXTURE_ADDR_MODE mode)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     switch ( coord )
     {
         case GAL_TEXTURE_S_COORD:
@@ -87,6 +94,7 @@ void GALSamplerImp::setTextureAddressMode(GAL_TEXTURE_COORD coord, GAL_TEXTURE_A
 void GALSamplerImp::setNonNormalizedCoordinates(gal_bool enable)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _nonNormalizedCoords = enable;
     TRACING_EXIT_REGION()
 }
@@ -94,6 +102,7 @@ void GALSamplerImp::setNonNormalizedCoordinates(gal_bool enable)
 void GALSamplerImp::setMinFilter(GAL_TEXTURE_FILTER minFilter)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _minFilter = minFilter;
     TRACING_EXIT_REGION()
 }
@@ -101,6 +110,7 @@ void GALSamplerImp::setMinFilter(GAL_TEXTURE_FILTER minFilter)
 void GALSamplerImp::setMagFilter(GAL_TEXTURE_FILTER magFilter)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _magFilter = magFilter;
     TRACING_EXIT_REGION()
 }
@@ -108,6 +118,7 @@ void GALSamplerImp::setMagFilter(GAL_TEXTURE_FILTER magFilter)
 void GALSamplerImp::setMinLOD(gal_float minLOD)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _minLOD = minLOD;
     TRACING_EXIT_REGION()
 }
@@ -115,6 +126,7 @@ void GALSamplerImp::setMinLOD(gal_float minLOD)
 void GALSamplerImp::setEnableComparison(gal_bool enable)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _enableComparison = enable;
     TRACING_EXIT_REGION()
 }
@@ -122,6 +134,7 @@ void GALSamplerImp::setEnableComparison(gal_bool enable)
 void GALSamplerImp::setComparisonFunction(GAL_TEXTURE_COMPARISON function)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _comparisonFunction = function;
     TRACING_EXIT_REGION()
 }
@@ -129,6 +142,7 @@ void GALSamplerImp::setComparisonFunction(GAL_TEXTURE_COMPARISON function)
 void GALSamplerImp::setSRGBConversion(gal_bool enable)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _sRGBConversion = enable;
     TRACING_EXIT_REGION()
 }
@@ -136,6 +150,7 @@ void GALSamplerImp::setSRGBConversion(gal_bool enable)
 void GALSamplerImp::setMaxLOD(gal_float maxLOD)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _maxLOD = maxLOD;
     TRACING_EXIT_REGION()
 }
@@ -143,6 +158,7 @@ void GALSamplerImp::setMaxLOD(gal_float maxLOD)
 void GALSamplerImp::setMaxAnisotropy(gal_uint maxAnisotropy)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _maxAniso = maxAnisotropy;
     TRACING_EXIT_REGION()
 }
@@ -150,6 +166,7 @@ void GALSamplerImp::setMaxAnisotropy(gal_uint maxAnisotropy)
 void GALSamplerImp::setLODBias(gal_float lodBias)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _lodBias = lodBias;
     TRACING_EXIT_REGION()
 }
@@ -157,6 +174,7 @@ void GALSamplerImp::setLODBias(gal_float lodBias)
 void GALSamplerImp::setUnitLODBias(gal_float unitLodBias)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _unitLodBias = unitLodBias;
     TRACING_EXIT_REGION()
 }
@@ -164,6 +182,7 @@ void GALSamplerImp::setUnitLODBias(gal_float unitLodBias)
 void GALSamplerImp::setMinLevel(gal_uint minLevel)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     _minLevel = minLevel;
     TRACING_EXIT_REGION()
 }
@@ -1170,6 +1189,7 @@ const StoredStateItem* GALSamplerImp::createStoredStateItem(GAL_STORED_ITEM_ID s
 void GALSamplerImp::restoreStoredStateItem(const StoredStateItem* ssi)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_SAMPLERS);
     gal_uint rTarget;
 
     const GALStoredStateItem* galssi = static_cast<const GALStoredStateItem*>(ssi);
@@ -1217,3 +1237,88 @@ void GALSamplerImp::restoreStoredStateItem(const StoredStateItem* ssi)
 #undef CAST_TO_ENUM
 #undef CAST_TO_VOID
 
+void GALSamplerImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _requiredSync);
+    checkpoint::saveValue(out, _textureType);
+    checkpoint::saveValue(out, _textureFormat);
+    checkpoint::saveValue(out, _minLevel);
+    checkpoint::saveValue(out, _baseLevel);
+    checkpoint::saveValue(out, _maxLevel);
+    checkpoint::saveValue(out, _textureWidth);
+    checkpoint::saveValue(out, _textureHeight);
+    checkpoint::saveValue(out, _textureDepth);
+    checkpoint::saveValue(out, _textureWidth2);
+    checkpoint::saveValue(out, _textureHeight2);
+    checkpoint::saveValue(out, _textureDepth2);
+    checkpoint::saveValue(out, _memoryLayout);
+    checkpoint::saveValue(out, _enabled);
+    checkpoint::saveValue(out, _sCoord);
+    checkpoint::saveValue(out, _tCoord);
+    checkpoint::saveValue(out, _rCoord);
+    checkpoint::saveValue(out, _nonNormalizedCoords);
+    checkpoint::saveValue(out, _minFilter);
+    checkpoint::saveValue(out, _magFilter);
+    checkpoint::saveValue(out, _enableComparison);
+    checkpoint::saveValue(out, _comparisonFunction);
+    checkpoint::saveValue(out, _sRGBConversion);
+    checkpoint::saveValue(out, _minLOD);
+    checkpoint::saveValue(out, _maxLOD);
+    checkpoint::saveValue(out, _maxAniso);
+    checkpoint::saveValue(out, _lodBias);
+    checkpoint::saveValue(out, _unitLodBias);
+    checkpoint::saveValue(out, _blitXoffset);
+    checkpoint::saveValue(out, _blitYoffset);
+    checkpoint::saveValue(out, _blitIniX);
+    checkpoint::saveValue(out, _blitIniY);
+    checkpoint::saveValue(out, _blitHeight);
+    checkpoint::saveValue(out, _blitWidth);
+    checkpoint::saveValue(out, _blitWidth2);
+    checkpoint::saveValue(out, _blitFormat);
+    checkpoint::saveValue(out, _blitTextureBlocking);
+    checkpoint::saveVector(out, _gpuMemTrack);
+    checkpoint::saveValue(out, _device->objectID(_texture));
+}
+
+void GALSamplerImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _requiredSync);
+    checkpoint::loadValue(in, _textureType);
+    checkpoint::loadValue(in, _textureFormat);
+    checkpoint::loadValue(in, _minLevel);
+    checkpoint::loadValue(in, _baseLevel);
+    checkpoint::loadValue(in, _maxLevel);
+    checkpoint::loadValue(in, _textureWidth);
+    checkpoint::loadValue(in, _textureHeight);
+    checkpoint::loadValue(in, _textureDepth);
+    checkpoint::loadValue(in, _textureWidth2);
+    checkpoint::loadValue(in, _textureHeight2);
+    checkpoint::loadValue(in, _textureDepth2);
+    checkpoint::loadValue(in, _memoryLayout);
+    checkpoint::loadValue(in, _enabled);
+    checkpoint::loadValue(in, _sCoord);
+    checkpoint::loadValue(in, _tCoord);
+    checkpoint::loadValue(in, _rCoord);
+    checkpoint::loadValue(in, _nonNormalizedCoords);
+    checkpoint::loadValue(in, _minFilter);
+    checkpoint::loadValue(in, _magFilter);
+    checkpoint::loadValue(in, _enableComparison);
+    checkpoint::loadValue(in, _comparisonFunction);
+    checkpoint::loadValue(in, _sRGBConversion);
+    checkpoint::loadValue(in, _minLOD);
+    checkpoint::loadValue(in, _maxLOD);
+    checkpoint::loadValue(in, _maxAniso);
+    checkpoint::loadValue(in, _lodBias);
+    checkpoint::loadValue(in, _unitLodBias);
+    checkpoint::loadValue(in, _blitXoffset);
+    checkpoint::loadValue(in, _blitYoffset);
+    checkpoint::loadValue(in, _blitIniX);
+    checkpoint::loadValue(in, _blitIniY);
+    checkpoint::loadValue(in, _blitHeight);
+    checkpoint::loadValue(in, _blitWidth);
+    checkpoint::loadValue(in, _blitWidth2);
+    checkpoint::loadValue(in, _blitFormat);
+    checkpoint::loadValue(in, _blitTextureBlocking);
+    checkpoint::loadVector(in, _gpuMemTrack);
+    _texture = static_cast<GALTexture*>(_device->resourceByID(checkpoint::loadValue<gal_uint>(in)));
+}
@@ -74,6 +74,10 @@ public:
 
     void restoreStoredStateItem(const StoredStateItem* ssi);
 
+    // Checkpoint support
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
 
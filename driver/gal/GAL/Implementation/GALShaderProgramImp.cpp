@@ -5,6 +5,7 @@
 #include "GALShaderProgramImp.h"
 #include "GALMacros.h"
 #include "HAL.h"
+#include "CheckpointStream.h"
 
 using namespace libGAL;
 
@@ -106,9 +107,11 @@ void GALShaderProgramImp::setConstant(gal_uint index, const gal_float* vect4)
             CG_ASSERT("Constant index out of bounds");
     )
 
-    // track the constant as updated
-    _touched.insert(index);
+    // Rewriting the same value doesn't require synchronizing the program again
+    if ( _touched.insert(index).second || memcmp(_constantBank[index], vect4, 4*sizeof(gal_float)) != 0 )
+        postChange();
 
+    // track the constant as updated
     memcpy(_constantBank[index], vect4, 4*sizeof(gal_float));
 
     // track the last set constant (for constant printing sake of clarity).
@@ -116,6 +119,33 @@ void GALShaderProgramImp::setConstant(gal_uint index, const gal_float* vect4)
         _lastConstantSet = index;
 }
 
+void GALShaderProgramImp::setConstants(gal_uint first, gal_uint count, const gal_float* vect4s)
+{
+    GAL_ASSERT(
+        if ( first + count > CONSTANT_BANK_REGISTERS )
+            CG_ASSERT("Constant range out of bounds");
+    )
+
+    if ( count == 0 )
+        return;
+
+    // Rewriting the same values doesn't require synchronizing the program again
+    gal_bool changed = ( memcmp(_constantBank[first], vect4s, count*4*sizeof(gal_float)) != 0 );
+
+    // track the constants as updated
+    for ( gal_uint i = first; i < first + count; ++i )
+        changed = _touched.insert(i).second || changed;
+
+    if ( changed )
+        postChange();
+
+    memcpy(_constantBank[first], vect4s, count*4*sizeof(gal_float));
+
+    // track the last set constant (for constant printing sake of clarity).
+    if (_lastConstantSet < first + count - 1)
+        _lastConstantSet = first + count - 1;
+}
+
 void GALShaderProgramImp::getConstant(gal_uint index, gal_float* vect4) const
 {
     GAL_ASSERT(
@@ -184,6 +214,7 @@ void GALShaderProgramImp::setInputRead(gal_uint inputReg, gal_bool read)
         CG_ASSERT("Input register out of bounds");
 
     _inputsRead.set(inputReg, read);
+    postChange();
 }
 
 void GALShaderProgramImp::setOutputWritten(gal_uint outputReg, gal_bool written)
@@ -192,11 +223,13 @@ void GALShaderProgramImp::setOutputWritten(gal_uint outputReg, gal_bool written)
         CG_ASSERT("Output register out of bounds");
 
     _outputsWritten.set(outputReg, written);
+    postChange();
 }
 
 void GALShaderProgramImp::setMaxAliveTemps(gal_uint maxAlive)
 {
     _maxAliveTemps = maxAlive;
+    postChange();
 }
 
 gal_bool GALShaderProgramImp::getInputRead(gal_uint inputReg) const
@@ -223,6 +256,7 @@ gal_uint GALShaderProgramImp::getMaxAliveTemps() const
 void GALShaderProgramImp::setTextureUnitsUsage(gal_uint tu, gal_enum usage)
 {
     _textureUnitUsage[tu] = usage;
+    postChange();
 }
 
 gal_enum GALShaderProgramImp::getTextureUnitsUsage(gal_uint tu)
@@ -233,6 +267,7 @@ gal_enum GALShaderProgramImp::getTextureUnitsUsage(gal_uint tu)
 void GALShaderProgramImp::setKillInstructions(gal_bool kill)
 {
     _killInstructions = kill;
+    postChange();
 }
 
 gal_bool GALShaderProgramImp::getKillInstructions()
@@ -275,6 +310,52 @@ void GALShaderProgramImp::printConstants(std::ostream& os) const
     os << endl;
 }
 
+void GALShaderProgramImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveBytes(out, _bytecode, _bytecodeSize);
+    checkpoint::saveBytes(out, _optBytecode, _optBytecodeSize);
+    checkpoint::saveBytes(out, _assembler, ( _assembler != 0 ) ? _assemblerSize : 0);
+
+    checkpoint::saveValue(out, _constantBank);
+    for ( gal_uint i = 0; i < CONSTANT_BANK_REGISTERS; i++ )
+        checkpoint::saveData(out, _constantCache[i]);
+    checkpoint::saveValue(out, _lastConstantSet);
+    checkpoint::saveSet(out, _touched);
+
+    checkpoint::saveValue(out, _textureUnitUsage);
+    checkpoint::saveValue(out, _killInstructions);
+    checkpoint::saveValue(out, _inputsRead);
+    checkpoint::saveValue(out, _outputsWritten);
+    checkpoint::saveValue(out, _maxAliveTemps);
+
+    saveRegions(out);
+}
+
+void GALShaderProgramImp::restoreState(std::istream& in)
+{
+    delete[] _bytecode;
+    delete[] _optBytecode;
+    delete[] _assembler;
+
+    _bytecode = checkpoint::loadBytes(in, _bytecodeSize);
+    _optBytecode = checkpoint::loadBytes(in, _optBytecodeSize);
+    _assembler = checkpoint::loadBytes(in, _assemblerSize);
+
+    checkpoint::loadValue(in, _constantBank);
+    for ( gal_uint i = 0; i < CONSTANT_BANK_REGISTERS; i++ )
+        checkpoint::loadData(in, _constantCache[i]);
+    checkpoint::loadValue(in, _lastConstantSet);
+    checkpoint::loadSet(in, _touched);
+
+    checkpoint::loadValue(in, _textureUnitUsage);
+    checkpoint::loadValue(in, _killInstructions);
+    checkpoint::loadValue(in, _inputsRead);
+    checkpoint::loadValue(in, _outputsWritten);
+    checkpoint::loadValue(in, _maxAliveTemps);
+
+    restoreRegions(in);
+}
+
 void GALShaderProgramImp::_computeASMCode()
 {
     delete[] _assembler; // delete previous computed assembler 
@@ -37,6 +37,8 @@ public:
 
     virtual void setConstant(gal_uint index, const gal_float* vect4);
 
+    virtual void setConstants(gal_uint first, gal_uint count, const gal_float* vect4s);
+
     virtual void getConstant(gal_uint index, gal_float* vect4) const;
 
     virtual void printASM(std::ostream& os) const;
@@ -86,6 +88,10 @@ public:
 
     gal_bool getKillInstructions();
 
+    // Checkpoint support: code, constants, usage information and memory tracking state
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 
 private:
 
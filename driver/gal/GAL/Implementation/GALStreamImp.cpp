@@ -8,6 +8,7 @@
 #include "GALMacros.h"
 #include <sstream>
 #include "StateItemUtils.h"
+#include "CheckpointStream.h"
 
 #include "Profiler.h"
 
@@ -31,6 +32,7 @@ GALStreamImp::GALStreamImp(GALDeviceImp* device, HAL* driver, gal_uint streamID)
 void GALStreamImp::set( GALBuffer* buffer, const GAL_STREAM_DESC& desc )
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
     
     GALBufferImp* buf = static_cast<GALBufferImp*>(buffer);
     _buffer = buf;
@@ -104,6 +106,7 @@ void GALStreamImp::get( GALBuffer*& buffer,
 void GALStreamImp::setBuffer(GALBuffer* buffer) 
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
     GALBufferImp* buf = static_cast<GALBufferImp*>(buffer);
     _buffer = buf;
     _gpuMemTrack = 0; // Init buffer track
@@ -112,26 +115,31 @@ void GALStreamImp::setBuffer(GALBuffer* buffer)
 
 void GALStreamImp::setOffset(gal_uint offset)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
     _offset = offset;
 }
 
 void GALStreamImp::setComponents(gal_uint components)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
 _components = components;
 }
 
 void GALStreamImp::setType(GAL_STREAM_DATA componentsType)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
     _componentsType = componentsType;
 }
     
 void GALStreamImp::setStride(gal_uint stride)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
     _stride = stride;
 }
 
 void GALStreamImp::setFrequency(gal_uint frequency)
 {
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
     _frequency = frequency;
 }
 
@@ -268,6 +276,7 @@ const StoredStateItem* GALStreamImp::createStoredStateItem(GAL_STORED_ITEM_ID st
 void GALStreamImp::restoreStoredStateItem(const StoredStateItem* ssi)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
     gal_uint rTarget;
 
     const GALStoredStateItem* galssi = static_cast<const GALStoredStateItem*>(ssi);
@@ -327,6 +336,7 @@ GALStoredState* GALStreamImp::saveAllState() const
 void GALStreamImp::restoreAllState(const GALStoredState* state)
 {
     TRACING_ENTER_REGION("GAL", "", "")    
+    _device->setDirty(GALDeviceImp::DIRTY_STREAMER);
 
     const GALStoredStateImp* ssi = static_cast<const GALStoredStateImp*>(state);
 
@@ -552,3 +562,29 @@ const char* GALStreamImp::ComponentTypePrint::print(const GAL_STREAM_DATA& var)
             return "UNKNOWN";
     }
 }
+
+void GALStreamImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _requiredSync);
+    checkpoint::saveValue(out, _gpuMemTrack);
+    checkpoint::saveValue(out, _offset);
+    checkpoint::saveValue(out, _components);
+    checkpoint::saveValue(out, _componentsType);
+    checkpoint::saveValue(out, _stride);
+    checkpoint::saveValue(out, _frequency);
+    checkpoint::saveValue(out, _invertStreamType);
+    _device->saveObjectItem(out, _buffer);
+}
+
+void GALStreamImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _requiredSync);
+    checkpoint::loadValue(in, _gpuMemTrack);
+    checkpoint::loadValue(in, _offset);
+    checkpoint::loadValue(in, _components);
+    checkpoint::loadValue(in, _componentsType);
+    checkpoint::loadValue(in, _stride);
+    checkpoint::loadValue(in, _frequency);
+    checkpoint::loadValue(in, _invertStreamType);
+    _device->restoreObjectItem(in, _buffer);
+}
@@ -11,6 +11,8 @@
 #include "GALMacros.h"
 #include "GALMath.h"
 
+#include "CheckpointStream.h"
+
 #include "Profiler.h"
 
 using namespace libGAL;
@@ -45,6 +47,7 @@ GAL_USAGE GALTexture2DImp::getUsage() const
 void GALTexture2DImp::setMemoryLayout(GAL_MEMORY_LAYOUT _layout)
 {
     layout = _layout;
+    postChange();
 }
 
 GAL_MEMORY_LAYOUT GALTexture2DImp::getMemoryLayout() const
@@ -237,6 +240,13 @@ const gal_ubyte* GALTexture2DImp::memoryData(gal_uint region, gal_uint& memorySi
     return mip->getDataInMortonOrder(memorySizeInBytes);
 }
 
+arch::MetaStreamPayload* GALTexture2DImp::memoryPayload(gal_uint region) const
+{
+    const TextureMipmap* mip = _mips.find(region);
+
+    return ( mip != 0 ) ? mip->getMortonPayload() : 0;
+}
+
 const gal_char* GALTexture2DImp::stringType() const
 {
     return "TEXTURE_2D_OBJECT";
@@ -433,12 +443,14 @@ void GALTexture2DImp::setBaseLevel(gal_uint minMipLevel)
 { 
     // Clamp if required
     _baseLevel = ( minMipLevel > GAL_MAX_TEXTURE_LEVEL ? GAL_MAX_TEXTURE_LEVEL : minMipLevel );
+    postChange();
 }
 
 void GALTexture2DImp::setMaxLevel(gal_uint maxMipLevel) 
 {
     // Clamp if required
     _maxLevel = ( maxMipLevel > GAL_MAX_TEXTURE_LEVEL ? GAL_MAX_TEXTURE_LEVEL : maxMipLevel );
+    postChange();
 }
 
 gal_uint GALTexture2DImp::getSettedMipmaps()
@@ -460,3 +472,23 @@ const gal_ubyte* GALTexture2DImp::getData(gal_uint mipLevel, gal_uint& memorySiz
     
 }
 
+
+void GALTexture2DImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _baseLevel);
+    checkpoint::saveValue(out, _maxLevel);
+    checkpoint::saveValue(out, layout);
+    checkpoint::saveSet(out, _mappedMips);
+    _mips.saveState(out);
+    saveRegions(out);
+}
+
+void GALTexture2DImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _baseLevel);
+    checkpoint::loadValue(in, _maxLevel);
+    checkpoint::loadValue(in, layout);
+    checkpoint::loadSet(in, _mappedMips);
+    _mips.restoreState(in);
+    restoreRegions(in);
+}
@@ -106,6 +106,8 @@ public:
     /// Method required by MemoryObject derived classes
     virtual const gal_ubyte* memoryData(gal_uint region, gal_uint& memorySizeInBytes) const;
 
+    virtual arch::MetaStreamPayload* memoryPayload(gal_uint region) const;
+
     virtual const gal_char* stringType() const;
 
     void dumpMipmap(gal_uint region, gal_ubyte* mipName);
@@ -120,6 +122,10 @@ public:
 
     static gal_uint getTexelSize(GAL_FORMAT format) ;
 
+    // Checkpoint support: texture definition, mipmap contents and memory tracking state
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     const TextureMipmap* _getMipmap(gal_uint mipLevel, const gal_char* methodStr) const;
@@ -11,6 +11,8 @@
 #include "GALMacros.h"
 #include "GALMath.h"
 
+#include "CheckpointStream.h"
+
 #include "Profiler.h"
 
 using namespace libGAL;
@@ -45,6 +47,7 @@ GAL_USAGE GALTexture3DImp::getUsage() const
 void GALTexture3DImp::setMemoryLayout(GAL_MEMORY_LAYOUT _layout)
 {
     layout = _layout;
+    postChange();
 }
 
 GAL_MEMORY_LAYOUT GALTexture3DImp::getMemoryLayout() const
@@ -259,6 +262,13 @@ const gal_ubyte* GALTexture3DImp::memoryData(gal_uint region, gal_uint& memorySi
     return mip->getDataInMortonOrder(memorySizeInBytes);
 }
 
+arch::MetaStreamPayload* GALTexture3DImp::memoryPayload(gal_uint region) const
+{
+    const TextureMipmap* mip = _mips.find(region);
+
+    return ( mip != 0 ) ? mip->getMortonPayload() : 0;
+}
+
 const gal_char* GALTexture3DImp::stringType() const
 {
     return "TEXTURE_3D_OBJECT";
@@ -450,12 +460,14 @@ void GALTexture3DImp::setBaseLevel(gal_uint minMipLevel)
 { 
     // Clamp if required
     _baseLevel = ( minMipLevel > GAL_MAX_TEXTURE_LEVEL ? GAL_MAX_TEXTURE_LEVEL : minMipLevel );
+    postChange();
 }
 
 void GALTexture3DImp::setMaxLevel(gal_uint maxMipLevel) 
 {
     // Clamp if required
     _maxLevel = ( maxMipLevel > GAL_MAX_TEXTURE_LEVEL ? GAL_MAX_TEXTURE_LEVEL : maxMipLevel );
+    postChange();
 }
 
 gal_uint GALTexture3DImp::getSettedMipmaps()
@@ -476,3 +488,23 @@ const gal_ubyte* GALTexture3DImp::getData(gal_uint mipLevel, gal_uint& memorySiz
     
 }
 
+
+void GALTexture3DImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _baseLevel);
+    checkpoint::saveValue(out, _maxLevel);
+    checkpoint::saveValue(out, layout);
+    checkpoint::saveSet(out, _mappedMips);
+    _mips.saveState(out);
+    saveRegions(out);
+}
+
+void GALTexture3DImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _baseLevel);
+    checkpoint::loadValue(in, _maxLevel);
+    checkpoint::loadValue(in, layout);
+    checkpoint::loadSet(in, _mappedMips);
+    _mips.restoreState(in);
+    restoreRegions(in);
+}
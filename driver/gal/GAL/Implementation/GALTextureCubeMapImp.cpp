@@ -6,6 +6,7 @@
 #include "GALMacros.h"
 #include "GALMath.h"
 #include "support.h"
+#include "CheckpointStream.h"
 #include <iostream>
 #include <sstream>
 
@@ -37,6 +38,7 @@ GAL_USAGE GALTextureCubeMapImp::getUsage() const
 void GALTextureCubeMapImp::setMemoryLayout(GAL_MEMORY_LAYOUT _layout)
 {
     layout = _layout;
+    postChange();
 }
 
 GAL_MEMORY_LAYOUT GALTextureCubeMapImp::getMemoryLayout() const
@@ -243,6 +245,18 @@ const gal_ubyte* GALTextureCubeMapImp::memoryData(gal_uint region, gal_uint& mem
     return mip->getDataInMortonOrder(memorySizeInBytes);
 }
 
+arch::MetaStreamPayload* GALTextureCubeMapImp::memoryPayload(gal_uint region) const
+{
+    gal_uint mipLevel;
+    GAL_CUBEMAP_FACE face;
+
+    translate2faceMipmap(region, face, mipLevel);
+
+    const TextureMipmap* mip = _mips[face].find(mipLevel);
+
+    return ( mip != 0 ) ? mip->getMortonPayload() : 0;
+}
+
 const gal_char* GALTextureCubeMapImp::stringType() const
 {
     return "TEXTURE_CUBEMAP_OBJECT";
@@ -406,12 +420,14 @@ void GALTextureCubeMapImp::setBaseLevel(gal_uint minMipLevel)
 { 
     // Clamp if required
     _baseLevel = ( minMipLevel > GAL_MAX_TEXTURE_LEVEL ? GAL_MAX_TEXTURE_LEVEL : minMipLevel );
+    postChange();
 }
 
 void GALTextureCubeMapImp::setMaxLevel(gal_uint maxMipLevel) 
 {
     // Clamp if required
     _maxLevel = ( maxMipLevel > GAL_MAX_TEXTURE_LEVEL ? GAL_MAX_TEXTURE_LEVEL : maxMipLevel );
+    postChange();
 }
 
 gal_uint GALTextureCubeMapImp::getSettedMipmaps()
@@ -463,3 +479,29 @@ const gal_ubyte* GALTextureCubeMapImp::getData(GAL_CUBEMAP_FACE face, gal_uint m
     return data;
     
 }
+
+void GALTextureCubeMapImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _baseLevel);
+    checkpoint::saveValue(out, _maxLevel);
+    checkpoint::saveValue(out, layout);
+    for ( gal_uint face = 0; face < 6; face++ )
+    {
+        checkpoint::saveSet(out, _mappedMips[face]);
+        _mips[face].saveState(out);
+    }
+    saveRegions(out);
+}
+
+void GALTextureCubeMapImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _baseLevel);
+    checkpoint::loadValue(in, _maxLevel);
+    checkpoint::loadValue(in, layout);
+    for ( gal_uint face = 0; face < 6; face++ )
+    {
+        checkpoint::loadSet(in, _mappedMips[face]);
+        _mips[face].restoreState(in);
+    }
+    restoreRegions(in);
+}
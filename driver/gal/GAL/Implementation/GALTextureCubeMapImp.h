@@ -95,6 +95,8 @@ public:
     /// Method required by MemoryObject derived classes
     virtual const gal_ubyte* memoryData(gal_uint region, gal_uint& memorySizeInBytes) const;
 
+    virtual arch::MetaStreamPayload* memoryPayload(gal_uint region) const;
+
     const gal_char* stringType() const;
 
 
@@ -110,6 +112,10 @@ public:
 
     const gal_ubyte* getData(GAL_CUBEMAP_FACE face, gal_uint mipLevel, gal_uint& memorySizeInBytes, gal_uint& rowPitch) const;
 
+    // Checkpoint support: texture definition, mipmap contents and memory tracking state
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     const TextureMipmap* _getMipmap(GAL_CUBEMAP_FACE, gal_uint mipLevel, const gal_char* methodStr) const;
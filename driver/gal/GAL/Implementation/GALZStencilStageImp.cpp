@@ -3,7 +3,9 @@
  */
 
 #include "GALZStencilStageImp.h"
+#include "GALDeviceImp.h"
 #include "GALMacros.h"
+#include "CheckpointStream.h"
 #include <sstream>
 
 #include "GALStoredStateImp.h"
@@ -46,6 +48,7 @@ GALZStencilStageImp::GALZStencilStageImp(GALDeviceImp* device, HAL* driver) :
 void GALZStencilStageImp::setZEnabled(gal_bool enable)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     _zEnabled = enable;
     TRACING_EXIT_REGION()
 }
@@ -58,6 +61,7 @@ gal_bool GALZStencilStageImp::isZEnabled() const
 void GALZStencilStageImp::setZFunc(GAL_COMPARE_FUNCTION zFunc)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     _zFunc = zFunc;
     TRACING_EXIT_REGION()
 }
@@ -70,6 +74,7 @@ GAL_COMPARE_FUNCTION GALZStencilStageImp::getZFunc() const
 void GALZStencilStageImp::setZMask(gal_bool mask)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     _zMask = mask;
     TRACING_EXIT_REGION()
 }
@@ -82,6 +87,7 @@ gal_bool GALZStencilStageImp::getZMask() const
 void GALZStencilStageImp::setStencilEnabled(gal_bool enable)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     _stencilEnabled = enable;
     TRACING_EXIT_REGION()
 }
@@ -97,6 +103,7 @@ void GALZStencilStageImp::setStencilOp( GAL_FACE face,
                                         GAL_STENCIL_OP onStencilPassZPass)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     GAL_ASSERT
     (
         if ( face != GAL_FACE_FRONT && face != GAL_FACE_BACK && face != GAL_FACE_FRONT_AND_BACK )
@@ -139,6 +146,7 @@ void GALZStencilStageImp::getStencilOp( GAL_FACE face,
 void GALZStencilStageImp::setStencilFunc( GAL_FACE face, GAL_COMPARE_FUNCTION func, gal_uint stencilRef, gal_uint stencilMask ) 
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     GAL_ASSERT
     (
         if ( face != GAL_FACE_FRONT && face != GAL_FACE_BACK && face != GAL_FACE_FRONT_AND_BACK ) 
@@ -193,6 +201,7 @@ void GALZStencilStageImp::setStencilUpdateMask (gal_uint mask)
 void GALZStencilStageImp::setZStencilBufferDefined(gal_bool present)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     _zStencilBufferDefined = present;
     TRACING_EXIT_REGION()
 }
@@ -539,6 +548,7 @@ const StoredStateItem* GALZStencilStageImp::createStoredStateItem(GAL_STORED_ITE
 void GALZStencilStageImp::restoreStoredStateItem(const StoredStateItem* ssi)
 {
     TRACING_ENTER_REGION("GAL", "", "")
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
     const GALStoredStateItem* galssi = static_cast<const GALStoredStateItem*>(ssi);
 
     GAL_STORED_ITEM_ID stateId = galssi->getItemId();
@@ -606,6 +616,7 @@ GALStoredState* GALZStencilStageImp::saveAllState() const
 void GALZStencilStageImp::restoreAllState(const GALStoredState* state)
 {
     TRACING_ENTER_REGION("GAL", "", "")    
+    _device->setDirty(GALDeviceImp::DIRTY_ZSTENCIL);
 
     const GALStoredStateImp* ssi = static_cast<const GALStoredStateImp*>(state);
 
@@ -622,3 +633,59 @@ void GALZStencilStageImp::restoreAllState(const GALStoredState* state)
 
     TRACING_EXIT_REGION()
 }
+
+void GALZStencilStageImp::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _syncRequired);
+    checkpoint::saveValue(out, _zEnabled);
+    checkpoint::saveValue(out, _stencilEnabled);
+    checkpoint::saveValue(out, _depthRangeNear);
+    checkpoint::saveValue(out, _depthRangeFar);
+    checkpoint::saveValue(out, _d3d9DepthRange);
+    checkpoint::saveValue(out, _zFunc);
+    checkpoint::saveValue(out, _zMask);
+    checkpoint::saveValue(out, _depthSlopeFactor);
+    checkpoint::saveValue(out, _depthUnitOffset);
+    checkpoint::saveValue(out, _stencilUpdateMask);
+    checkpoint::saveValue(out, _zStencilBufferDefined);
+    checkpoint::saveValue(out, _front.onStencilFail);
+    checkpoint::saveValue(out, _front.onStencilPassZFails);
+    checkpoint::saveValue(out, _front.onStencilPassZPass);
+    checkpoint::saveValue(out, _front.stencilFunc);
+    checkpoint::saveValue(out, _front.stencilRef);
+    checkpoint::saveValue(out, _front.stencilMask);
+    checkpoint::saveValue(out, _back.onStencilFail);
+    checkpoint::saveValue(out, _back.onStencilPassZFails);
+    checkpoint::saveValue(out, _back.onStencilPassZPass);
+    checkpoint::saveValue(out, _back.stencilFunc);
+    checkpoint::saveValue(out, _back.stencilRef);
+    checkpoint::saveValue(out, _back.stencilMask);
+}
+
+void GALZStencilStageImp::restoreState(std::istream& in)
+{
+    checkpoint::loadValue(in, _syncRequired);
+    checkpoint::loadValue(in, _zEnabled);
+    checkpoint::loadValue(in, _stencilEnabled);
+    checkpoint::loadValue(in, _depthRangeNear);
+    checkpoint::loadValue(in, _depthRangeFar);
+    checkpoint::loadValue(in, _d3d9DepthRange);
+    checkpoint::loadValue(in, _zFunc);
+    checkpoint::loadValue(in, _zMask);
+    checkpoint::loadValue(in, _depthSlopeFactor);
+    checkpoint::loadValue(in, _depthUnitOffset);
+    checkpoint::loadValue(in, _stencilUpdateMask);
+    checkpoint::loadValue(in, _zStencilBufferDefined);
+    checkpoint::loadValue(in, _front.onStencilFail);
+    checkpoint::loadValue(in, _front.onStencilPassZFails);
+    checkpoint::loadValue(in, _front.onStencilPassZPass);
+    checkpoint::loadValue(in, _front.stencilFunc);
+    checkpoint::loadValue(in, _front.stencilRef);
+    checkpoint::loadValue(in, _front.stencilMask);
+    checkpoint::loadValue(in, _back.onStencilFail);
+    checkpoint::loadValue(in, _back.onStencilPassZFails);
+    checkpoint::loadValue(in, _back.onStencilPassZPass);
+    checkpoint::loadValue(in, _back.stencilFunc);
+    checkpoint::loadValue(in, _back.stencilRef);
+    checkpoint::loadValue(in, _back.stencilMask);
+}
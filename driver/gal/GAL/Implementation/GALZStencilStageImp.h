@@ -75,6 +75,10 @@ public:
 
     void restoreAllState(const GALStoredState* ssi);
 
+    // Checkpoint support
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
     std::string getInternalState() const;
 
 private:
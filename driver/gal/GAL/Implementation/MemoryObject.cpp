@@ -4,10 +4,23 @@
 
 #include "MemoryObject.h"
 #include "support.h"
+#include "CheckpointStream.h"
+#include <algorithm>
 
 using namespace libGAL;
 using namespace std;
 
+gal_uint MemoryObject::_changes = 0;
+
+gal_uint MemoryObject::changes()
+{
+    return _changes;
+}
+
+void MemoryObject::postChange()
+{
+    _changes++;
+}
 
 MemoryObject::MemoryObject() : _globalReallocs(0), _preferredMemory(MT_LocalMemory)
 {}
@@ -22,6 +35,11 @@ MemoryObject::MemoryType MemoryObject::getPreferredMemory() const
     return _preferredMemory;
 }
 
+arch::MetaStreamPayload* MemoryObject::memoryPayload(gal_uint region) const
+{
+    return 0;
+}
+
 void MemoryObject::getUpdateRange(gal_uint region, gal_uint& startByte, gal_uint& lastByte)
 {
     map<gal_uint, MemoryObjectRegion>::const_iterator it = mor.find(region);
@@ -97,6 +115,8 @@ gal_uint MemoryObject::trackRealloc() const
 
 void MemoryObject::defineRegion(gal_uint region)
 {
+    _changes++;
+
     // Discard previous region definition (if exists) and define a new region
     map<gal_uint, MemoryObjectRegion>::iterator it = mor.find(region);
     if ( it == mor.end() )
@@ -106,6 +126,8 @@ void MemoryObject::defineRegion(gal_uint region)
         info.reallocs = 0;
 		info.locked = false;
 		info.preload = false;
+        info.orphaned = false;
+        _clearUpdateRanges(info);
         mor.insert(make_pair(region,info));
     }
     else
@@ -118,11 +140,14 @@ void MemoryObject::defineRegion(gal_uint region)
 			it->second.preload = false;
             _globalReallocs++;
         }
+        it->second.orphaned = false;
     }
 }
 
 void MemoryObject::_postUpdate(gal_uint moID, MemoryObjectRegion& moRegion, gal_uint startByte, gal_uint lastByte)
 { 
+    _changes++;
+
     if ( lastByte == 0 ) { // Update from start to last region byte
         memoryData(moID, lastByte); // Get memory object region size in 'lastByte' parameter
         --lastByte;
@@ -131,6 +156,8 @@ void MemoryObject::_postUpdate(gal_uint moID, MemoryObjectRegion& moRegion, gal_
     switch ( moRegion.state )
     {
         case MOS_ReAlloc:
+            if ( moRegion.orphaned ) // Only the bytes updated after the orphan are uploaded
+                _addUpdateRange(moRegion, startByte, lastByte);
             return ; // ignore partial update, this region will be reallocated completely
         case MOS_Blit:
             //CG_ASSERT("Blitted memory regions can not be updated (not implemented)");
@@ -140,21 +167,88 @@ void MemoryObject::_postUpdate(gal_uint moID, MemoryObjectRegion& moRegion, gal_
             break;
         case MOS_Sync:
             moRegion.state = MOS_NotSync;
-            moRegion.firstByteToUpdate = startByte;
-            moRegion.lastByteToUpdate = lastByte;
+            _clearUpdateRanges(moRegion);
+            _addUpdateRange(moRegion, startByte, lastByte);
             break;
         case MOS_NotSync:
-            // Enlarge "update range" if required
-            if ( moRegion.firstByteToUpdate > startByte )
-                moRegion.firstByteToUpdate = startByte;
-            if ( moRegion.lastByteToUpdate < lastByte )
-                moRegion.lastByteToUpdate = lastByte;
+            // Add to the "update ranges" (enlarges the "update range" if required)
+            _addUpdateRange(moRegion, startByte, lastByte);
             break;
         default:
             CG_ASSERT("Unknown memory object state");
     }
 }
 
+void MemoryObject::_clearUpdateRanges(MemoryObjectRegion& moRegion)
+{
+    moRegion.updateRanges.clear();
+    moRegion.modifiedBytes = 0;
+
+    // Empty "update range"
+    moRegion.firstByteToUpdate = 1;
+    moRegion.lastByteToUpdate = 0;
+}
+
+void MemoryObject::_addUpdateRange(MemoryObjectRegion& moRegion, gal_uint startByte, gal_uint lastByte)
+{
+    UpdateRanges& ranges = moRegion.updateRanges;
+
+    // Skip the ranges that end before the new range and are not adjacent to it
+    UpdateRanges::iterator first = ranges.begin();
+    while ( first != ranges.end() && startByte > 0 && first->second < startByte - 1 )
+        ++first;
+
+    // Merge the ranges that overlap or are adjacent to the new range
+    gal_uint newFirst = startByte;
+    gal_uint newLast = lastByte;
+    gal_uint pendingBytes = 0; // bytes of the new range that were already pending
+    UpdateRanges::iterator last = first;
+    for ( ; last != ranges.end() && (last->first == 0 || last->first - 1 <= lastByte); ++last )
+    {
+        gal_uint overlapFirst = std::max(last->first, startByte);
+        gal_uint overlapLast = std::min(last->second, lastByte);
+        if ( overlapFirst <= overlapLast )
+            pendingBytes += overlapLast - overlapFirst + 1;
+
+        newFirst = std::min(newFirst, last->first);
+        newLast = std::max(newLast, last->second);
+    }
+
+    first = ranges.erase(first, last);
+    ranges.insert(first, UpdateRange(newFirst, newLast));
+
+    moRegion.modifiedBytes += (lastByte - startByte + 1) - pendingBytes;
+
+    // Too many disjoint ranges, fall back to a single range
+    if ( ranges.size() > MAX_UPDATE_RANGES )
+    {
+        UpdateRange span(ranges.front().first, ranges.back().second);
+        ranges.clear();
+        ranges.push_back(span);
+    }
+
+    moRegion.firstByteToUpdate = ranges.front().first;
+    moRegion.lastByteToUpdate = ranges.back().second;
+}
+
+const MemoryObject::UpdateRanges& MemoryObject::getUpdateRanges(gal_uint region) const
+{
+    map<gal_uint, MemoryObjectRegion>::const_iterator it = mor.find(region);
+    if ( it == mor.end() )
+        CG_ASSERT("Region not found/defined");
+
+    return it->second.updateRanges;
+}
+
+gal_uint MemoryObject::getModifiedBytes(gal_uint region) const
+{
+    map<gal_uint, MemoryObjectRegion>::const_iterator it = mor.find(region);
+    if ( it == mor.end() )
+        CG_ASSERT("Region not found/defined");
+
+    return it->second.modifiedBytes;
+}
+
 void MemoryObject::postUpdate(gal_uint region, gal_uint startByte, gal_uint lastByte)
 {
     map<gal_uint, MemoryObjectRegion>::iterator it = mor.find(region);
@@ -178,18 +272,51 @@ void MemoryObject::postReallocate(gal_uint region)
     if ( it == mor.end() )
         CG_ASSERT("Posting ReAlloc in a region that does not exist");
 
+    _changes++;
+
     if ( it->second.state != MOS_ReAlloc ) {
         it->second.state = MOS_ReAlloc;
         it->second.reallocs++; // increment reallocs if the object/region was not already in state realloc
 		it->second.locked = false;
         _globalReallocs++;
     }
+    it->second.orphaned = false; // the whole region must be written
+}
+
+void MemoryObject::postOrphan(gal_uint region)
+{
+    map<gal_uint, MemoryObjectRegion>::iterator it = mor.find(region);
+    if ( it == mor.end() )
+        CG_ASSERT("Posting Orphan in a region that does not exist");
+
+    _changes++;
+
+    if ( it->second.state != MOS_ReAlloc ) {
+        it->second.state = MOS_ReAlloc;
+        it->second.reallocs++;
+        it->second.locked = false;
+        _globalReallocs++;
+    }
+
+    // Previous contents are discarded, start with an empty "update range"
+    it->second.orphaned = true;
+    _clearUpdateRanges(it->second);
+}
+
+gal_bool MemoryObject::isOrphaned(gal_uint region) const
+{
+    map<gal_uint, MemoryObjectRegion>::const_iterator it = mor.find(region);
+    if ( it == mor.end() )
+        CG_ASSERT("Region not found/defined");
+
+    return it->second.orphaned;
 }
 
 void MemoryObject::postReallocateAll()
 {
     map<gal_uint, MemoryObjectRegion>::iterator it = mor.begin();
     const map<gal_uint, MemoryObjectRegion>::iterator itEnd = mor.end();
+    _changes++;
     for ( ; it != itEnd; ++it ) {
         if ( it->second.state != MOS_ReAlloc ) {
             it->second.state = MOS_ReAlloc;
@@ -197,6 +324,7 @@ void MemoryObject::postReallocateAll()
 			it->second.locked = false;
             _globalReallocs++;
         }
+        it->second.orphaned = false;
     }
 }
 
@@ -207,6 +335,7 @@ void MemoryObject::postBlit(gal_uint region)
         CG_ASSERT("Posting Blit in a region that does not exist");
 
     it->second.state = MOS_Blit;
+    _changes++;
 }
 
 void MemoryObject::postBlitAll()
@@ -215,6 +344,7 @@ void MemoryObject::postBlitAll()
     const map<gal_uint, MemoryObjectRegion>::iterator itEnd = mor.end();
     for ( ; it != itEnd; ++it )
         it->second.state = MOS_Blit;
+    _changes++;
 }
 
 void MemoryObject::postRenderBuffer(gal_uint region)
@@ -224,6 +354,7 @@ void MemoryObject::postRenderBuffer(gal_uint region)
         CG_ASSERT("Posting Blit in a region that does not exist");
 
     it->second.state = MOS_RenderBuffer;
+    _changes++;
 }
 
 void MemoryObject::postRenderBufferAll()
@@ -232,6 +363,7 @@ void MemoryObject::postRenderBufferAll()
     const map<gal_uint, MemoryObjectRegion>::iterator itEnd = mor.end();
     for ( ; it != itEnd; ++it )
         it->second.state = MOS_RenderBuffer;
+    _changes++;
 }
 
 const gal_char* MemoryObject::stringType() const
@@ -258,4 +390,66 @@ void MemoryObject::changeState(gal_uint region, MemoryObjectState newState)
         CG_ASSERT("Region not found/defined");
 
     it->second.state = newState;
+    if ( newState != MOS_ReAlloc )
+        it->second.orphaned = false;
+
+    // Synchronization doesn't change what the device binds
+    if ( newState != MOS_Sync )
+        _changes++;
+}
+
+void MemoryObject::saveRegions(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _preferredMemory);
+    checkpoint::saveValue(out, _globalReallocs);
+
+    checkpoint::saveValue(out, (gal_uint) mor.size());
+    map<gal_uint, MemoryObjectRegion>::const_iterator it = mor.begin();
+    for ( ; it != mor.end(); ++it )
+    {
+        const MemoryObjectRegion& info = it->second;
+        checkpoint::saveValue(out, it->first);
+        checkpoint::saveValue(out, info.state);
+        checkpoint::saveValue(out, info.firstByteToUpdate);
+        checkpoint::saveValue(out, info.lastByteToUpdate);
+        checkpoint::saveValue(out, info.reallocs);
+        checkpoint::saveValue(out, info.locked);
+        checkpoint::saveValue(out, info.preload);
+        checkpoint::saveValue(out, info.orphaned);
+        checkpoint::saveValue(out, info.modifiedBytes);
+        checkpoint::saveValue(out, (gal_uint) info.updateRanges.size());
+        for ( gal_uint i = 0; i < info.updateRanges.size(); i++ )
+        {
+            checkpoint::saveValue(out, info.updateRanges[i].first);
+            checkpoint::saveValue(out, info.updateRanges[i].second);
+        }
+    }
+}
+
+void MemoryObject::restoreRegions(std::istream& in)
+{
+    checkpoint::loadValue(in, _preferredMemory);
+    checkpoint::loadValue(in, _globalReallocs);
+
+    mor.clear();
+    gal_uint regions = checkpoint::loadValue<gal_uint>(in);
+    for ( gal_uint r = 0; r < regions; r++ )
+    {
+        gal_uint region = checkpoint::loadValue<gal_uint>(in);
+        MemoryObjectRegion& info = mor[region];
+        checkpoint::loadValue(in, info.state);
+        checkpoint::loadValue(in, info.firstByteToUpdate);
+        checkpoint::loadValue(in, info.lastByteToUpdate);
+        checkpoint::loadValue(in, info.reallocs);
+        checkpoint::loadValue(in, info.locked);
+        checkpoint::loadValue(in, info.preload);
+        checkpoint::loadValue(in, info.orphaned);
+        checkpoint::loadValue(in, info.modifiedBytes);
+        info.updateRanges.resize(checkpoint::loadValue<gal_uint>(in));
+        for ( gal_uint i = 0; i < info.updateRanges.size(); i++ )
+        {
+            checkpoint::loadValue(in, info.updateRanges[i].first);
+            checkpoint::loadValue(in, info.updateRanges[i].second);
+        }
+    }
 }
@@ -7,8 +7,14 @@
 
 #include <map>
 #include <vector>
+#include <iosfwd>
 #include "GALResource.h"
 
+namespace arch
+{
+    class MetaStreamPayload;
+}
+
 namespace libGAL
 {
 
@@ -55,6 +61,18 @@ public:
         MT_LocalMemory, ///< Data will be allocated in local GPU memory
     };
 
+    /**
+     * Range of bytes of a region that requires updating (first and last byte)
+     */
+    typedef std::pair<gal_uint, gal_uint> UpdateRange;
+    typedef std::vector<UpdateRange> UpdateRanges;
+
+    /**
+     * Maximum number of disjoint update ranges tracked per region, when exceeded
+     * the ranges are collapsed into a single range
+     */
+    static const gal_uint MAX_UPDATE_RANGES = 32;
+
     /**
      * COnstructor automatically called by each subclass
      */
@@ -142,6 +160,12 @@ public:
      */
     MemoryType getPreferredMemory() const;
 
+    /**
+     * Checks if a region in state MOS_ReAlloc was orphaned (only the update range
+     * must be written to the new GPU memory)
+     */
+    gal_bool isOrphaned(gal_uint region) const;
+
     /**
      * Gets a pointer to the binary data of a memory object region
      *
@@ -152,6 +176,17 @@ public:
      */
     virtual const gal_ubyte* memoryData(gal_uint region, gal_uint& memorySizeInBytes) const = 0;
 
+    /**
+     * Gets the payload holding the binary data returned by memoryData()
+     *
+     * The memory writes of the region reference the payload instead of copying the data,
+     * so the data must not be modified while the payload has other references
+     *
+     * @param region The memory region selected
+     * @return The payload holding the region data or NULL if the data must be copied
+     */
+    virtual arch::MetaStreamPayload* memoryPayload(gal_uint region) const;
+
     /**
      * Obtains the memory object region range that requires updating based on
      * The eg
@@ -162,15 +197,50 @@ public:
      */
     void getUpdateRange(gal_uint region, gal_uint& startByte, gal_uint& lastByte);
 
+    /**
+     * Obtains the disjoint ranges of a memory object region that require updating
+     *
+     * The ranges are sorted and adjacent or overlapping updates are coalesced.  All
+     * the ranges are contained in the range returned by getUpdateRange()
+     *
+     * @param region Region queried
+     */
+    const UpdateRanges& getUpdateRanges(gal_uint region) const;
+
+    /**
+     * Bytes of a memory object region modified since the region was synchronized
+     * (the bytes covered by the posted update ranges, a lower bound when the ranges
+     * were collapsed)
+     *
+     * @param region Region queried
+     */
+    gal_uint getModifiedBytes(gal_uint region) const;
+
     /**
      * Each subclass should define its own string type
      */
     virtual const gal_char* stringType() const;
 
+    /**
+     * Changes posted to all the memory objects (updates, reallocations, blits, render
+     * buffer writes and changes of the properties used when the object is bound)
+     *
+     * The device only synchronizes the state that binds memory objects when this
+     * counter changed since the previous draw
+     */
+    static gal_uint changes();
+
     void postBlit(gal_uint region);
 
     void postRenderBuffer(gal_uint region);
 
+    /**
+     * Checkpoint support: writes/reads the tracking state of the object regions (the
+     * contents of the object are saved by the subclass)
+     */
+    void saveRegions(std::ostream& out) const;
+    void restoreRegions(std::istream& in);
+
 protected:
 
     /**********************
@@ -180,6 +250,15 @@ protected:
     void postUpdateAll();
     void postReallocate(gal_uint region);
     void postReallocateAll();
+
+    /**
+     * Discards the GPU memory of a region without reallocating it completely
+     *
+     * The next synchronization allocates new GPU memory for the region (the previous
+     * memory is released when the GPU no longer uses it) and only uploads the bytes
+     * posted with postUpdate() after the orphan
+     */
+    void postOrphan(gal_uint region);
     
     void postBlitAll();
     
@@ -189,6 +268,9 @@ protected:
     void defineRegion(gal_uint region);
     void undefineRegion(gal_uint region);
 
+    // Must be called by subclasses when a property used to bind the object changes
+    static void postChange();
+
 private:
 
     // Can only be called by MemoryObjectAllocator
@@ -204,14 +286,22 @@ private:
         gal_uint reallocs;
 		gal_uint locked;
 		gal_bool preload;
+        gal_bool orphaned;
+        UpdateRanges updateRanges;
+        gal_uint modifiedBytes;
     };
 
     std::map<gal_uint, MemoryObjectRegion> mor;
 
     gal_uint _globalReallocs;
 
+    static gal_uint _changes;
+
     void _postUpdate(gal_uint moID, MemoryObjectRegion& moRegion, gal_uint startByte, gal_uint lastByte);
 
+    static void _clearUpdateRanges(MemoryObjectRegion& moRegion);
+    static void _addUpdateRange(MemoryObjectRegion& moRegion, gal_uint startByte, gal_uint lastByte);
+
 
 };
 
@@ -8,11 +8,13 @@
 #include "HAL.h"
 #include <sstream>
 #include "GALMacros.h"
+#include "GALDeviceImp.h"
+#include "CheckpointStream.h"
 
 using namespace libGAL;
 using namespace std;
 
-MemoryObjectAllocator::MemoryObjectAllocator(HAL* driver) : _driver(driver)
+MemoryObjectAllocator::MemoryObjectAllocator(HAL* driver) : _driver(driver), _uploadedBytes(0), _modifiedBytes(0)
 {    
     lockOutMem = &lockedMemory[0];
 	lockInMem = &lockedMemory[1];
@@ -41,23 +43,67 @@ void MemoryObjectAllocator::_update(MemoryObject* mo, MemoryObjectInfo* moi, gal
     if ( !data || memorySizeDummy == 0 )
         CG_ASSERT("MemoryObject data NULL or size 0 ");
     
-    // Get the range of the memory to update from the selected region
-    gal_uint startByte, lastByte;
-    mo->getUpdateRange(region, startByte, lastByte);
+    // Update the GPU memory corresponding to the ranges of the region that were modified
+    _writeUpdateRanges(mo, region, (*moi)[region].md, data, mo->isLocked(region));
+    
+    mo->changeState(region, MOS_Sync);
+}
+
+void MemoryObjectAllocator::_writeUpdateRanges(MemoryObject* mo, gal_uint region, gal_uint md, const gal_ubyte* data, gal_bool locked)
+{
+    const MemoryObject::UpdateRanges& ranges = mo->getUpdateRanges(region);
 
     //  Check if the region contains data to be preloaded into GPU memory.
-    if (mo->isPreload(region))
+    gal_bool preload = mo->isPreload(region);
+
+    // One memory write per disjoint range
+    MemoryObject::UpdateRanges::const_iterator it = ranges.begin();
+    for ( ; it != ranges.end(); ++it )
     {
-        // Update the GPU memory corresponding to the region 
-	    _driver->writeMemoryPreload((*moi)[region].md, startByte, data + startByte, lastByte - startByte + 1);
+        gal_uint size = it->second - it->first + 1;
+
+        _writeMemory(mo, region, md, it->first, data, size, preload, locked);
+
+        if ( !preload )
+            _uploadedBytes += size;
     }
-    else
-    {    
-        // Update the GPU memory corresponding to the region 
-	    _driver->writeMemory((*moi)[region].md, startByte, data + startByte, lastByte - startByte + 1, mo->isLocked(region));
+
+    if ( !preload )
+        _modifiedBytes += mo->getModifiedBytes(region);
+}
+
+//  Releases the reference to the region payload held by a memory write of a range of the region.
+static void releaseRegionPayload(void* owner, const U08* data)
+{
+    static_cast<arch::MetaStreamPayload*>(owner)->release();
+}
+
+void MemoryObjectAllocator::_writeMemory(MemoryObject* mo, gal_uint region, gal_uint md, gal_uint offset, const gal_ubyte* data,
+                                         gal_uint size, gal_bool preload, gal_bool locked)
+{
+    arch::MetaStreamPayload* payload = mo->memoryPayload(region);
+
+    if ( payload == 0 )
+    {
+        // The driver copies the data
+        if ( preload )
+            _driver->writeMemoryPreload(md, offset, data + offset, size);
+        else
+            _driver->writeMemory(md, offset, data + offset, size, locked);
+
+        return;
     }
-    
-    mo->changeState(region, MOS_Sync);
+
+    // The memory write references the region data, the memory object copies the data before modifying it
+    payload->acquire();
+
+    if ( offset != 0 || size != payload->getSize() )
+        payload = arch::MetaStreamPayload::wrap(data + offset, size, releaseRegionPayload, payload);
+
+    if ( preload )
+        _driver->writeMemoryPreload(md, offset, payload);
+    else
+        _driver->writeMemory(md, offset, payload, locked);
 }
 
 MemoryObjectAllocator::MemoryObjectInfo* MemoryObjectAllocator::_createMOI(MemoryObject* mo)
@@ -88,7 +134,7 @@ void MemoryObjectAllocator::_addRegionToMOI(MemoryObjectInfo* moi, gal_uint regi
 }
 
 
-void MemoryObjectAllocator::_alloc( MemoryObject* mo, MemoryObjectInfo* moi, gal_uint region )
+void MemoryObjectAllocator::_alloc( MemoryObject* mo, MemoryObjectInfo* moi, gal_uint region, gal_bool orphaned )
 {
     // Get the memory data of the memory object and its size in bytes
     gal_uint size;
@@ -110,12 +156,19 @@ void MemoryObjectAllocator::_alloc( MemoryObject* mo, MemoryObjectInfo* moi, gal
     if (mo->isPreload(region))
     {
         // Update the GPU memory
-        _driver->writeMemoryPreload(md, 0, data, size);
+        _writeMemory(mo, region, md, 0, data, size, true, false);
+    }
+    else if ( orphaned )
+    {
+        // Only the ranges updated after the orphan hold data that will be used
+        _writeUpdateRanges(mo, region, md, data, false);
     }
     else
     {
         // Update the GPU memory
-        _driver->writeMemory(md, data, size, mo->isLocked(region));
+        _writeMemory(mo, region, md, 0, data, size, false, mo->isLocked(region));
+        _uploadedBytes += size;
+        _modifiedBytes += size;
     }
     
     // Update the "memory object information" with the new allocated region information
@@ -176,16 +229,20 @@ gal_bool MemoryObjectAllocator::syncGPU(MemoryObject* mo, gal_uint region)
             //CG_ASSERT("The region has previously blit, sync from CPU not supported");
             break;
         case MOS_ReAlloc:
+        {
+            gal_bool orphaned = mo->isOrphaned(region);
+
             if ( !moi )
                 moi = _createMOI(mo); // create MOI if there is not exist yet
             else if ( moi->find(region) != moi->end() )
                 _dealloc(mo, moi, region); // deallocate previous region
 
-            _alloc(mo, moi, region);
+            _alloc(mo, moi, region, orphaned);
 
 			mo->lock(region, true);
 			lockInMem->push_back(lockedRegion(mo,region));
             break;
+        }
         case MOS_NotSync:            
             _update(mo, moi, region);
 
@@ -336,3 +393,72 @@ void MemoryObjectAllocator::realeaseLockedMemoryRegions()
 	lockOutMem = lockInMem;
 	lockInMem = aux;
 }
+
+void MemoryObjectAllocator::saveState(std::ostream& out, GALDeviceImp& device) const
+{
+    checkpoint::saveValue(out, (gal_uint) maps.size());
+    MemoryObjectMap::const_iterator it = maps.begin();
+    for ( ; it != maps.end(); ++it )
+    {
+        checkpoint::saveValue(out, device.memoryObjectID(it->first));
+        checkpoint::saveValue(out, (gal_uint) it->second.size());
+        MemoryObjectInfo::const_iterator itRegion = it->second.begin();
+        for ( ; itRegion != it->second.end(); ++itRegion )
+        {
+            checkpoint::saveValue(out, itRegion->first);
+            checkpoint::saveValue(out, itRegion->second.md);
+            checkpoint::saveValue(out, itRegion->second.size);
+        }
+    }
+
+    const std::vector<lockedRegion>* locked[2] = { lockOutMem, lockInMem };
+    for ( gal_uint l = 0; l < 2; l++ )
+    {
+        checkpoint::saveValue(out, (gal_uint) locked[l]->size());
+        for ( gal_uint i = 0; i < locked[l]->size(); i++ )
+        {
+            checkpoint::saveValue(out, device.memoryObjectID((*locked[l])[i].mo));
+            checkpoint::saveValue(out, (*locked[l])[i].region);
+        }
+    }
+
+    checkpoint::saveValue(out, _uploadedBytes);
+    checkpoint::saveValue(out, _modifiedBytes);
+    checkpoint::saveValue(out, MemoryObject::_changes);
+}
+
+void MemoryObjectAllocator::restoreState(std::istream& in, GALDeviceImp& device)
+{
+    maps.clear();
+    gal_uint objects = checkpoint::loadValue<gal_uint>(in);
+    for ( gal_uint o = 0; o < objects; o++ )
+    {
+        MemoryObjectInfo& moi = maps[device.memoryObjectByID(checkpoint::loadValue<gal_uint>(in))];
+        gal_uint regions = checkpoint::loadValue<gal_uint>(in);
+        for ( gal_uint r = 0; r < regions; r++ )
+        {
+            gal_uint region = checkpoint::loadValue<gal_uint>(in);
+            RegionInfo& info = moi[region];
+            checkpoint::loadValue(in, info.md);
+            checkpoint::loadValue(in, info.size);
+        }
+    }
+
+    lockOutMem = &lockedMemory[0];
+    lockInMem = &lockedMemory[1];
+    for ( gal_uint l = 0; l < 2; l++ )
+    {
+        lockedMemory[l].clear();
+        gal_uint regions = checkpoint::loadValue<gal_uint>(in);
+        for ( gal_uint i = 0; i < regions; i++ )
+        {
+            MemoryObject* mo = device.memoryObjectByID(checkpoint::loadValue<gal_uint>(in));
+            gal_int region = checkpoint::loadValue<gal_int>(in);
+            lockedMemory[l].push_back(lockedRegion(mo, region));
+        }
+    }
+
+    checkpoint::loadValue(in, _uploadedBytes);
+    checkpoint::loadValue(in, _modifiedBytes);
+    checkpoint::loadValue(in, MemoryObject::_changes);
+}
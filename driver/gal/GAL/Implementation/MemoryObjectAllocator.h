@@ -8,6 +8,7 @@
 #include "GALTypes.h"
 #include <map>
 #include <vector>
+#include <iosfwd>
 
 class HAL;
 
@@ -15,6 +16,7 @@ namespace libGAL
 {
 
 class MemoryObject;
+class GALDeviceImp;
 
 /**
  * This object implements a layer between MemoryObjects and low-level driver memory interface
@@ -103,6 +105,24 @@ public:
      */
 	void realeaseLockedMemoryRegions();
 
+    /**
+     * Bytes written to GPU memory to synchronize memory objects (preloaded data not included)
+     */
+    gal_ulonglong uploadedBytes() const { return _uploadedBytes; }
+
+    /**
+     * Bytes of the memory objects modified in CPU memory that were synchronized (preloaded data not included)
+     */
+    gal_ulonglong modifiedBytes() const { return _modifiedBytes; }
+
+    /**
+     * Checkpoint support: writes/reads the memory descriptors assigned to the memory object
+     * regions, the locked regions and the statistics.  The memory objects are identified
+     * by the device that created them.
+     */
+    void saveState(std::ostream& out, GALDeviceImp& device) const;
+    void restoreState(std::istream& in, GALDeviceImp& device);
+
 private:
 
     // moi[region].md --> memory descriptor
@@ -144,11 +164,22 @@ private:
     
     // Pointer to the driver interface
     HAL* _driver;
+
+    // Upload statistics
+    gal_ulonglong _uploadedBytes;
+    gal_ulonglong _modifiedBytes;
+
+    // Writes the update ranges of a region into GPU memory
+    void _writeUpdateRanges(MemoryObject* mo, gal_uint region, gal_uint md, const gal_ubyte* data, gal_bool locked);
+
+    // Writes a range of the region data, sharing the region payload if the memory object provides one
+    void _writeMemory(MemoryObject* mo, gal_uint region, gal_uint md, gal_uint offset, const gal_ubyte* data,
+                      gal_uint size, gal_bool preload, gal_bool locked);
     
     // Primitives to manage local GPU memory, the public methods are built on top this functions
     void _update(MemoryObject* mo, MemoryObjectInfo* moi, gal_uint region);
     void _dealloc(MemoryObject* mo, MemoryObjectInfo* moi, gal_uint region);
-    void _alloc(MemoryObject* mo, MemoryObjectInfo* moi, gal_uint region);
+    void _alloc(MemoryObject* mo, MemoryObjectInfo* moi, gal_uint region, gal_bool orphaned = false);
 
 };
 
@@ -32,7 +32,7 @@ TextureAdapter::TextureAdapter(GALTexture* tex)
     }
 }
 
-GALTexture* TextureAdapter::getTexture()
+GALTexture* TextureAdapter::getTexture() const
 {
     switch (_type) 
     {
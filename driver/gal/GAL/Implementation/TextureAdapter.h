@@ -31,7 +31,7 @@ public:
     TextureAdapter(GALTexture* tex);
 
 
-    GALTexture* getTexture();
+    GALTexture* getTexture() const;
 
 
     const gal_ubyte* getData(GAL_CUBEMAP_FACE face, gal_uint mipmap, gal_uint& memorySizeInBytes, gal_uint& rowPitch) const;
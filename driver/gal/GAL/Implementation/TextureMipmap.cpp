@@ -7,6 +7,8 @@
 #include <cstring>
 #include "GALMath.h"
 #include "HAL.h"
+#include "MetaStream.h"
+#include "CheckpointStream.h"
 #include <sstream>
 
 #include "Profiler.h"
@@ -54,7 +56,13 @@ void TextureMipmap::getTextureTiling(gal_uint& tileLevel1Sz, gal_uint& tileLevel
     TRACING_EXIT_REGION()
 }
 
-TextureMipmap::TextureMipmap() : _data(0), _dataSize(0), _rowPitch(0), _planePitch(0), _mortonData(0), 
+//  Deletes the morton data of a mipmap once the mipmap and the memory writes sharing it release it.
+static void releaseMortonBuffer(void* owner, const U08* data)
+{
+    delete[] data;
+}
+
+TextureMipmap::TextureMipmap() : _data(0), _dataSize(0), _rowPitch(0), _planePitch(0), _mortonData(0), _mortonPayload(0), 
                                  _width(0), _height(0), _depth(0), _format(GAL_FORMAT_RGBA_8888),
                                  _multisampling(false), _samples(1)
 {
@@ -226,11 +234,9 @@ void TextureMipmap::setData( gal_uint width, gal_uint height, gal_uint depth, GA
 
     // Delete previous mipmap contents
     delete[] _data;
-    delete[] _mortonData;
 
     // Mipmap data not converted to morton order.
-    _mortonData = 0;
-    _mortonDataSize = 0;
+    releaseMortonData();
 
     // Update mipmap properties
     _format = format;
@@ -294,11 +300,9 @@ void TextureMipmap::setData(gal_uint width, gal_uint height, gal_uint depth, gal
 
     // Delete previous mipmap contents
     delete[] _data;
-    delete[] _mortonData;
 
     // Mipmap data not converted to morton order.
-    _mortonData = 0;
-    _mortonDataSize = 0;
+    releaseMortonData();
 
     //  Create mipmap with no defined data.
     _data = 0;
@@ -320,10 +324,7 @@ void TextureMipmap::setData(gal_uint width, gal_uint height, gal_uint depth, gal
 void TextureMipmap::updateData(const gal_ubyte* srcTexelData)
 {
     // Invalidate current precomputed morton data
-    if (_mortonData != NULL)
-        delete[] _mortonData;
-
-    _mortonData = NULL;
+    releaseMortonData();
 
     memcpy(_data, srcTexelData, _dataSize);    
 }
@@ -353,10 +354,7 @@ void TextureMipmap::updateData( gal_uint xoffset, gal_uint yoffset, gal_uint zof
         CG_ASSERT("updateData requires to supply data (not NULL)");
 
     // Invalidate current precomputed morton data
-    if (_mortonData != NULL)
-        delete[] _mortonData;
-
-    _mortonData = NULL;
+    releaseMortonData();
 
     //  Clamp the 
     gal_uint heightCompr;
@@ -481,9 +479,57 @@ const gal_ubyte* TextureMipmap::getDataInMortonOrder( gal_uint& sizeInBytes ) co
 
         _mortonData = _driver->getDataInMortonOrder(_data, _width, _height, _depth, compressed, getTexelSize(), _mortonDataSize);
 
+        // The memory writes reference the morton data instead of copying it
+        _mortonPayload = arch::MetaStreamPayload::wrap(_mortonData, _mortonDataSize, releaseMortonBuffer, 0);
+
     }
 
     sizeInBytes = _mortonDataSize;
     TRACING_EXIT_REGION()
     return _mortonData;
 }
+
+arch::MetaStreamPayload* TextureMipmap::getMortonPayload() const
+{
+    return _mortonPayload;
+}
+
+void TextureMipmap::releaseMortonData()
+{
+    // The morton data is deleted when the last memory write referencing it is released
+    if (_mortonPayload != NULL)
+        _mortonPayload->release();
+
+    _mortonPayload = NULL;
+    _mortonData = NULL;
+    _mortonDataSize = 0;
+}
+
+void TextureMipmap::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _width);
+    checkpoint::saveValue(out, _height);
+    checkpoint::saveValue(out, _depth);
+    checkpoint::saveValue(out, _multisampling);
+    checkpoint::saveValue(out, _samples);
+    checkpoint::saveValue(out, _format);
+    checkpoint::saveValue(out, _rowPitch);
+    checkpoint::saveValue(out, _planePitch);
+    checkpoint::saveBytes(out, _data, ( _data != 0 ) ? _dataSize : 0);
+}
+
+void TextureMipmap::restoreState(std::istream& in)
+{
+    delete[] _data;
+    releaseMortonData();
+
+    checkpoint::loadValue(in, _width);
+    checkpoint::loadValue(in, _height);
+    checkpoint::loadValue(in, _depth);
+    checkpoint::loadValue(in, _multisampling);
+    checkpoint::loadValue(in, _samples);
+    checkpoint::loadValue(in, _format);
+    checkpoint::loadValue(in, _rowPitch);
+    checkpoint::loadValue(in, _planePitch);
+    _data = checkpoint::loadBytes(in, _dataSize);
+}
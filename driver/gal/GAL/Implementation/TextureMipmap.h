@@ -7,9 +7,15 @@
 
 #include "GALTypes.h"
 #include "GALTexture2D.h"
+#include <iosfwd>
 
 class HAL;
 
+namespace arch
+{
+    class MetaStreamPayload;
+}
+
 namespace libGAL
 {
 
@@ -42,6 +48,10 @@ private:
 
     mutable gal_ubyte* _mortonData;
     mutable gal_uint _mortonDataSize;
+    mutable arch::MetaStreamPayload* _mortonPayload; // Holds the morton data, shared with the memory writes
+
+    // Releases the morton data (the memory writes still queued keep their reference)
+    void releaseMortonData();
     
     public:
 
@@ -79,7 +89,14 @@ private:
 
     const gal_ubyte* getDataInMortonOrder(gal_uint& sizeInBytes) const;
 
+    // Returns the payload holding the data returned by getDataInMortonOrder()
+    arch::MetaStreamPayload* getMortonPayload() const;
+
     void dump2PPM (gal_ubyte* filename);
+
+    // Checkpoint support: mipmap definition and texel data (the morton order copy is rebuilt on demand)
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
 };
 
 }
@@ -3,6 +3,7 @@
  */
 
 #include "TextureMipmapChain.h"
+#include "CheckpointStream.h"
 #include <utility>
 
 using namespace std;
@@ -69,3 +70,27 @@ gal_uint TextureMipmapChain::size()
 {
 	return _mips.size();
 }
+
+void TextureMipmapChain::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, (gal_uint) _mips.size());
+    map<gal_uint, TextureMipmap*>::const_iterator it = _mips.begin();
+    for ( ; it != _mips.end(); ++it )
+    {
+        checkpoint::saveValue(out, it->first);
+        it->second->saveState(out);
+    }
+}
+
+void TextureMipmapChain::restoreState(std::istream& in)
+{
+    destroyMipmaps();
+    _mips.clear();
+
+    gal_uint mips = checkpoint::loadValue<gal_uint>(in);
+    for ( gal_uint i = 0; i < mips; i++ )
+    {
+        gal_uint mipLevel = checkpoint::loadValue<gal_uint>(in);
+        create(mipLevel)->restoreState(in);
+    }
+}
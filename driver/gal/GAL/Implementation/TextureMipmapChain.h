@@ -8,6 +8,7 @@
 #include "TextureMipmap.h"
 #include <map>
 #include <vector>
+#include <iosfwd>
 
 class HAL;
 
@@ -32,6 +33,10 @@ public:
 	
 	gal_uint size();
 
+    // Checkpoint support: defined mipmaps and their contents
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     std::map<gal_uint,TextureMipmap*> _mips;
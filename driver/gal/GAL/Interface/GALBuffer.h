@@ -69,6 +69,27 @@ public:
      */
     virtual void updateData( gal_uint offset, gal_uint size, const gal_ubyte* data, gal_bool preload = false ) = 0;
 
+    /**
+     * Updates a range of the data buffer that is not used by the batches already sent to the GPU
+     *
+     * The GPU memory is written without waiting for the end of the previous batch.  Used to
+     * append data to streaming buffers.
+     *
+     * @param offset offset in the buffer (where to start updating)
+     * @param size amount of data in the supplied pointer
+     * @param data pointer to the data to update the buffer
+     */
+    virtual void updateStreamData( gal_uint offset, gal_uint size, const gal_ubyte* data ) = 0;
+
+    /**
+     * Discards the GPU memory of the buffer
+     *
+     * The next time the buffer is used new GPU memory is allocated and only the ranges updated
+     * after the orphan are written (the previous GPU memory is released when the batches using it
+     * have finished).  The buffer size and CPU data are not changed.
+     */
+    virtual void orphan() = 0;
+
 };
 
 } // namespace libGAL
@@ -14,6 +14,7 @@
 #include "GALSampler.h"
 
 #include <list>
+#include <iosfwd>
 
 namespace libGAL
 {
@@ -569,6 +570,44 @@ public:
      */
     virtual void destroyState(GALStoredState* state) = 0;
 
+    /**
+     * Writes the whole device state to a simulation checkpoint: the state of the device,
+     * its stages, streams and samplers, and the buffers, textures, render targets and
+     * shader programs created by the device with their contents and memory assignments.
+     *
+     * Objects are identified by the order in which the device created them, the upper
+     * layers save their references to device objects with objectID().
+     *
+     * @param out The checkpoint stream
+     */
+    virtual void saveState(std::ostream& out) = 0;
+
+    /**
+     * Restores the device state saved with saveState(std::ostream&).  Objects that exist in
+     * the checkpoint are created (or redefined in place if they already exist), objects not
+     * in the checkpoint are deleted.  No commands are sent to the GPU driver, its state is
+     * restored separately.
+     *
+     * @param in The checkpoint stream
+     */
+    virtual void restoreState(std::istream& in) = 0;
+
+    /**
+     * Identifier of an object created by the device, used to save references to the object
+     * in a checkpoint (0 for NULL).
+     */
+    virtual gal_uint objectID(const GALResource* resource) = 0;
+    virtual gal_uint objectID(const GALRenderTarget* renderTarget) = 0;
+    virtual gal_uint objectID(const GALShaderProgram* program) = 0;
+
+    /**
+     * Object with the identifier returned by objectID() when the checkpoint was saved.
+     * Must only be called after restoreState(std::istream&).
+     */
+    virtual GALResource* resourceByID(gal_uint id) = 0;
+    virtual GALRenderTarget* renderTargetByID(gal_uint id) = 0;
+    virtual GALShaderProgram* shaderProgramByID(gal_uint id) = 0;
+
     /**
      * Sets the starting frame from which to track current frame and batch.
      *
@@ -54,6 +54,15 @@ public:
      */
     virtual void setConstant(gal_uint index, const gal_float* vect4) = 0;
 
+    /**
+     * Sets the value of a range of consecutive constant registers
+     *
+     * @param first first constant register index
+     * @param count number of constant registers to write
+     * @param vect4s count vectors of 4 floats to write into the constant registers
+     */
+    virtual void setConstants(gal_uint first, gal_uint count, const gal_float* vect4s) = 0;
+
     /**
      * Gets the current value of a constant register exposed by the shader architecture
      *
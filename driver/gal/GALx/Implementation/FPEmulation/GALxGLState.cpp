@@ -3,6 +3,7 @@
  */
 
 #include "GALxGLState.h"
+#include "CheckpointStream.h"
 //#include "AuxFuncsLib.h"
 #include <cmath>
 
@@ -555,3 +556,35 @@ void GALxGLState::printMatrix(ostream& os, MatrixId matId_) const
     matrixState[matId+3].dump(os);
     
 }
+
+void GALxGLState::saveState(std::ostream& out) const
+{
+    for ( GLuint i = 0; i < BASE_STATE_MATRIX; i++ )
+    {
+        for ( int c = 0; c < 4; c++ )
+            checkpoint::saveValue(out, vectorState[i][c]);
+        checkpoint::saveValue(out, dirtyVec[i]);
+    }
+
+    for ( GLuint i = 0; i < MATRICES_SIZE; i++ )
+    {
+        checkpoint::saveData(out, matrixState[i]);
+        checkpoint::saveValue(out, dirtyMat[i]);
+    }
+}
+
+void GALxGLState::restoreState(std::istream& in)
+{
+    for ( GLuint i = 0; i < BASE_STATE_MATRIX; i++ )
+    {
+        for ( int c = 0; c < 4; c++ )
+            checkpoint::loadValue(in, vectorState[i][c]);
+        checkpoint::loadValue(in, dirtyVec[i]);
+    }
+
+    for ( GLuint i = 0; i < MATRICES_SIZE; i++ )
+    {
+        checkpoint::loadData(in, matrixState[i]);
+        checkpoint::loadValue(in, dirtyMat[i]);
+    }
+}
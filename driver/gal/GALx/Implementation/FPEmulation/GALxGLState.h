@@ -186,6 +186,10 @@ public:
     const Quadf& getVector(GLuint id) const;
 
     void dump(std::ostream& os= std::cout) const;
+
+    // Checkpoint support
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
   
     
     static void normalizeQuad(Quadf& qr);
@@ -16,6 +16,7 @@
 #include "GALxTLFactory.h"
 #include "GALxTLShader.h"
 #include "GALxShaderCache.h"
+#include "CheckpointStream.h"
 #include <list>
 
 //#define ENABLE_TRACING
@@ -28,9 +29,9 @@ GALxShaderCache vShaderCache;
 GALxShaderCache fShaderCache;
 
 // Creates a fixed pipeline state interface. 
-GALxFixedPipelineState* libGAL::GALxCreateFixedPipelineState(const GALDevice*)
+GALxFixedPipelineState* libGAL::GALxCreateFixedPipelineState(GALDevice* gal_device)
 {
-    return new GALxFixedPipelineStateImp(new GALxGLState());
+    return new GALxFixedPipelineStateImp(new GALxGLState(), gal_device);
 }
 
 // Releases a GALxFixedPipelineState interface.  
@@ -442,7 +443,9 @@ void libGAL::GALxGenerateVertexProgram(GALxFixedPipelineState* fpState, const GA
     // Generate the settings adapter to get GALxTLState and GALxFPState interfaces. 
     SettingsAdapter sa(fpSettings);
 
-    if ( !vShaderCache.isCached(fpSettings, vertexProgram, finalBindingList) )
+    GALShaderProgram* vCachedProgram;
+
+    if ( !vShaderCache.isCached(fpSettings, vCachedProgram, finalBindingList) )
     {
         //cout << "VERTEX SHADER MISSSSSSSSSSSSSS " << endl;
 
@@ -482,8 +485,14 @@ void libGAL::GALxGenerateVertexProgram(GALxFixedPipelineState* fpState, const GA
         //vertexProgram->printASM(cout);
         //printf("----------------------\n");     
 
-        // Synchronize GALxFixedPipelineState states to GALxGLState
         GALxFixedPipelineStateImp* fpStateImp = static_cast<GALxFixedPipelineStateImp*>(fpState);
+
+        // Release the program created by the caller, the cached program is used instead
+        if ( vertexProgram != 0 )
+            fpStateImp->getDevice()->destroy(vertexProgram);
+        vertexProgram = vCachedProgram;
+
+        // Synchronize GALxFixedPipelineState states to GALxGLState
         fpStateImp->sync();
 
         GALxConstantBindingList::iterator iter = finalBindingList->begin();
@@ -521,7 +530,9 @@ void libGAL::GALxGenerateFragmentProgram(GALxFixedPipelineState* fpState, const
     // Generate the settings adapter to get GALxTLState and GALxFPState interfaces. 
     SettingsAdapter sa(fpSettings);
     
-    if ( !fShaderCache.isCached(fpSettings, fragmentProgram, finalBindingList) )
+    GALShaderProgram* fCachedProgram;
+
+    if ( !fShaderCache.isCached(fpSettings, fCachedProgram, finalBindingList) )
     {
         //cout << "FRAGMENT SHADER MISSSSSSSSSSSSSS " << endl;
           
@@ -561,8 +572,14 @@ void libGAL::GALxGenerateFragmentProgram(GALxFixedPipelineState* fpState, const
         //fragmentProgram->printASM(cout);
         //printf("----------------------\n");
 
-        // Synchronize GALxFixedPipelineState states to GALxGLState
         GALxFixedPipelineStateImp* fpStateImp = static_cast<GALxFixedPipelineStateImp*>(fpState);
+
+        // Release the program created by the caller, the cached program is used instead
+        if ( fragmentProgram != 0 )
+            fpStateImp->getDevice()->destroy(fragmentProgram);
+        fragmentProgram = fCachedProgram;
+
+        // Synchronize GALxFixedPipelineState states to GALxGLState
         fpStateImp->sync();
 
         GALxConstantBindingList::iterator iter = finalBindingList->begin();
@@ -604,7 +621,9 @@ void libGAL::GALxGeneratePrograms(GALxFixedPipelineState* fpState, const GALx_FI
     GALxTLShader* vtlsh;
     GALxConstantBindingList* finalBindingList;
 
-    if ( !vShaderCache.isCached(fpSettings, vertexProgram, finalBindingList) )
+    GALShaderProgram* vCachedProgram;
+
+    if ( !vShaderCache.isCached(fpSettings, vCachedProgram, finalBindingList) )
     {
         //cout << "VERTEX SHADER MISSSSSSSSSSSSSS " << endl;
 
@@ -644,8 +663,14 @@ void libGAL::GALxGeneratePrograms(GALxFixedPipelineState* fpState, const GALx_FI
         //vertexProgram->printASM(cout);
         //printf("----------------------\n");
 
-        // Synchronize GALxFixedPipelineState states to GALxGLState
         GALxFixedPipelineStateImp* fpStateImp = static_cast<GALxFixedPipelineStateImp*>(fpState);
+
+        // Release the program created by the caller, the cached program is used instead
+        if ( vertexProgram != 0 )
+            fpStateImp->getDevice()->destroy(vertexProgram);
+        vertexProgram = vCachedProgram;
+
+        // Synchronize GALxFixedPipelineState states to GALxGLState
         fpStateImp->sync();
 
         GALxConstantBindingList::iterator iter = finalBindingList->begin();
@@ -665,7 +690,9 @@ void libGAL::GALxGeneratePrograms(GALxFixedPipelineState* fpState, const GALx_FI
 
     }
     
-    if ( !fShaderCache.isCached(fpSettings, fragmentProgram, finalBindingList) )
+    GALShaderProgram* fCachedProgram;
+
+    if ( !fShaderCache.isCached(fpSettings, fCachedProgram, finalBindingList) )
     {
         //cout << "FRAGMENT SHADER MISSSSSSSSSSSSSS " << endl;
           
@@ -707,8 +734,14 @@ void libGAL::GALxGeneratePrograms(GALxFixedPipelineState* fpState, const GALx_FI
         //fragmentProgram->printASM(cout);
         //printf("----------------------\n");
 
-        // Synchronize GALxFixedPipelineState states to GALxGLState
         GALxFixedPipelineStateImp* fpStateImp = static_cast<GALxFixedPipelineStateImp*>(fpState);
+
+        // Release the program created by the caller, the cached program is used instead
+        if ( fragmentProgram != 0 )
+            fpStateImp->getDevice()->destroy(fragmentProgram);
+        fragmentProgram = fCachedProgram;
+
+        // Synchronize GALxFixedPipelineState states to GALxGLState
         fpStateImp->sync();
 
         GALxConstantBindingList::iterator iter = finalBindingList->begin();
@@ -878,3 +911,79 @@ void libGAL::GALxGetCompilationLog(GALx_COMPILATION_LOG& compileLog)
 {
     compileLog = lastResults;
 }
+
+// Builds the constant binding list of a generated vertex program without updating any GALShaderProgram.
+static GALxConstantBindingList* buildVertexProgramBindings(const GALx_FIXED_PIPELINE_SETTINGS& fpSettings)
+{
+    SettingsAdapter sa(fpSettings);
+
+    GALxTLShader* vtlsh = GALxTLFactory::constructVertexProgram(sa.getTLState());
+    GALxConstantBindingList vpcbList = vtlsh->getConstantBindingList();
+    GALxCompiledProgram* cVertexProgram = GALxCompileProgram(vtlsh->getCode());
+
+    GALxRBank<float> clusterBank(200,"clusterBank");
+    clusterBank = static_cast<const GALxCompiledProgramImp*>(cVertexProgram)->getCompiledConstantBank();
+    ClusterBankAdapter cbAdapter(&clusterBank);
+    GALxConstantBindingList* finalBindingList = cbAdapter.getFinalConstantBindings(&vpcbList);
+
+    GALxDestroyCompiledProgram(cVertexProgram);
+    delete vtlsh;
+
+    return finalBindingList;
+}
+
+// Builds the constant binding list of a generated fragment program without updating any GALShaderProgram.
+static GALxConstantBindingList* buildFragmentProgramBindings(const GALx_FIXED_PIPELINE_SETTINGS& fpSettings)
+{
+    SettingsAdapter sa(fpSettings);
+
+    GALxTLShader* ftlsh = GALxFPFactory::constructFragmentProgram(sa.getFPState());
+    GALxConstantBindingList fpcbList = ftlsh->getConstantBindingList();
+    GALxCompiledProgram* cFragmentProgram = GALxCompileProgram(ftlsh->getCode());
+
+    GALxRBank<float> clusterBank(200,"clusterBank");
+    clusterBank = static_cast<const GALxCompiledProgramImp*>(cFragmentProgram)->getCompiledConstantBank();
+    ClusterBankAdapter cbAdapter(&clusterBank);
+    GALxConstantBindingList* finalBindingList = cbAdapter.getFinalConstantBindings(&fpcbList);
+
+    GALxDestroyCompiledProgram(cFragmentProgram);
+    delete ftlsh;
+
+    return finalBindingList;
+}
+
+void libGAL::GALxSaveState(const GALxFixedPipelineState* fpState, std::ostream& out)
+{
+    const GALxFixedPipelineStateImp* fpStateImp = static_cast<const GALxFixedPipelineStateImp*>(fpState);
+
+    fpStateImp->saveState(out);
+
+    vShaderCache.saveState(out, fpStateImp->getDevice());
+    fShaderCache.saveState(out, fpStateImp->getDevice());
+
+    checkpoint::saveString(out, lastResults.vpSource);
+    checkpoint::saveValue(out, lastResults.vpNumInstructions);
+    checkpoint::saveValue(out, lastResults.vpParameterRegisters);
+    checkpoint::saveString(out, lastResults.fpSource);
+    checkpoint::saveValue(out, lastResults.fpNumInstructions);
+    checkpoint::saveValue(out, lastResults.fpParameterRegisters);
+}
+
+void libGAL::GALxRestoreState(GALxFixedPipelineState* fpState, std::istream& in)
+{
+    GALxFixedPipelineStateImp* fpStateImp = static_cast<GALxFixedPipelineStateImp*>(fpState);
+
+    fpStateImp->restoreState(in);
+
+    //  Rebuilding the binding lists compiles the cached programs again, so the compilation
+    //  log is restored last.
+    vShaderCache.restoreState(in, fpStateImp->getDevice(), buildVertexProgramBindings);
+    fShaderCache.restoreState(in, fpStateImp->getDevice(), buildFragmentProgramBindings);
+
+    lastResults.vpSource = checkpoint::loadString(in);
+    checkpoint::loadValue(in, lastResults.vpNumInstructions);
+    checkpoint::loadValue(in, lastResults.vpParameterRegisters);
+    lastResults.fpSource = checkpoint::loadString(in);
+    checkpoint::loadValue(in, lastResults.fpNumInstructions);
+    checkpoint::loadValue(in, lastResults.fpParameterRegisters);
+}
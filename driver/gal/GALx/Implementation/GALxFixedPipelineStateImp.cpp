@@ -5,6 +5,7 @@
 #include "GALxFixedPipelineStateImp.h"
 #include "GALxStoredFPStateImp.h"
 #include "StateItemUtils.h"
+#include "CheckpointStream.h"
 #include <sstream>
 #include <fstream>
 
@@ -315,9 +316,10 @@ void GALxFixedPipelineStateImp::setAlphaTestRefValue(gal_float refValue)
 // GALxFixedPipelineStateImp implementation //
 //////////////////////////////////////////////
 
-GALxFixedPipelineStateImp::GALxFixedPipelineStateImp(GALxGLState *gls)
+GALxFixedPipelineStateImp::GALxFixedPipelineStateImp(GALxGLState *gls, GALDevice* device)
 :   
     _gls(gls),
+    _device(device),
     _requiredSync(false),
 
     _light(GALx_FP_MAX_LIGHTS_LIMIT),
@@ -433,6 +435,11 @@ const GALxGLState* GALxFixedPipelineStateImp::getGLState() const
     return _gls;
 }
 
+GALDevice* GALxFixedPipelineStateImp::getDevice() const
+{
+    return _device;
+}
+
 gal_float GALxFixedPipelineStateImp::getSingleState(GALx_STORED_FP_ITEM_ID stateId) const
 {
     gal_float ret = 1.0f;
@@ -1686,3 +1693,125 @@ gal_bool GALxFixedPipelineStateImp::DBG_load(const gal_char*)
 {
     return true;
 }
+
+template<class T>
+static void saveItems(std::ostream& out, const std::vector<StateItem<T> >& items)
+{
+    for ( gal_uint i = 0; i < items.size(); i++ )
+        checkpoint::saveData(out, items[i]);
+}
+
+template<class T>
+static void loadItems(std::istream& in, std::vector<StateItem<T> >& items)
+{
+    for ( gal_uint i = 0; i < items.size(); i++ )
+        checkpoint::loadData(in, items[i]);
+}
+
+void GALxFixedPipelineStateImp::saveState(std::ostream& out) const
+{
+    _gls->saveState(out);
+
+    checkpoint::saveValue(out, _requiredSync);
+
+    checkpoint::saveData(out, _materialFrontAmbient);
+    checkpoint::saveData(out, _materialFrontDiffuse);
+    checkpoint::saveData(out, _materialFrontSpecular);
+    checkpoint::saveData(out, _materialFrontEmission);
+    checkpoint::saveData(out, _materialFrontShininess);
+    checkpoint::saveData(out, _materialBackAmbient);
+    checkpoint::saveData(out, _materialBackDiffuse);
+    checkpoint::saveData(out, _materialBackSpecular);
+    checkpoint::saveData(out, _materialBackEmission);
+    checkpoint::saveData(out, _materialBackShininess);
+
+    saveItems(out, _lightAmbient);
+    saveItems(out, _lightDiffuse);
+    saveItems(out, _lightSpecular);
+    saveItems(out, _lightPosition);
+    saveItems(out, _lightDirection);
+    saveItems(out, _lightAttenuation);
+    saveItems(out, _lightSpotDirection);
+    saveItems(out, _lightSpotCutOffAngle);
+    saveItems(out, _lightSpotExponent);
+
+    checkpoint::saveData(out, _lightModelAmbientColor);
+    checkpoint::saveData(out, _lightModelSceneFrontColor);
+    checkpoint::saveData(out, _lightModelSceneBackColor);
+
+    saveItems(out, _modelViewMatrix);
+    checkpoint::saveData(out, _projectionMatrix);
+
+    saveItems(out, _textCoordSObjectPlane);
+    saveItems(out, _textCoordTObjectPlane);
+    saveItems(out, _textCoordRObjectPlane);
+    saveItems(out, _textCoordQObjectPlane);
+    saveItems(out, _textCoordSEyePlane);
+    saveItems(out, _textCoordTEyePlane);
+    saveItems(out, _textCoordREyePlane);
+    saveItems(out, _textCoordQEyePlane);
+    saveItems(out, _textureCoordMatrix);
+    saveItems(out, _textEnvColor);
+
+    checkpoint::saveData(out, _near);
+    checkpoint::saveData(out, _far);
+    checkpoint::saveData(out, _fogBlendColor);
+    checkpoint::saveData(out, _fogDensity);
+    checkpoint::saveData(out, _fogLinearStart);
+    checkpoint::saveData(out, _fogLinearEnd);
+    checkpoint::saveData(out, _alphaTestRefValue);
+}
+
+void GALxFixedPipelineStateImp::restoreState(std::istream& in)
+{
+    _gls->restoreState(in);
+
+    checkpoint::loadValue(in, _requiredSync);
+
+    checkpoint::loadData(in, _materialFrontAmbient);
+    checkpoint::loadData(in, _materialFrontDiffuse);
+    checkpoint::loadData(in, _materialFrontSpecular);
+    checkpoint::loadData(in, _materialFrontEmission);
+    checkpoint::loadData(in, _materialFrontShininess);
+    checkpoint::loadData(in, _materialBackAmbient);
+    checkpoint::loadData(in, _materialBackDiffuse);
+    checkpoint::loadData(in, _materialBackSpecular);
+    checkpoint::loadData(in, _materialBackEmission);
+    checkpoint::loadData(in, _materialBackShininess);
+
+    loadItems(in, _lightAmbient);
+    loadItems(in, _lightDiffuse);
+    loadItems(in, _lightSpecular);
+    loadItems(in, _lightPosition);
+    loadItems(in, _lightDirection);
+    loadItems(in, _lightAttenuation);
+    loadItems(in, _lightSpotDirection);
+    loadItems(in, _lightSpotCutOffAngle);
+    loadItems(in, _lightSpotExponent);
+
+    checkpoint::loadData(in, _lightModelAmbientColor);
+    checkpoint::loadData(in, _lightModelSceneFrontColor);
+    checkpoint::loadData(in, _lightModelSceneBackColor);
+
+    loadItems(in, _modelViewMatrix);
+    checkpoint::loadData(in, _projectionMatrix);
+
+    loadItems(in, _textCoordSObjectPlane);
+    loadItems(in, _textCoordTObjectPlane);
+    loadItems(in, _textCoordRObjectPlane);
+    loadItems(in, _textCoordQObjectPlane);
+    loadItems(in, _textCoordSEyePlane);
+    loadItems(in, _textCoordTEyePlane);
+    loadItems(in, _textCoordREyePlane);
+    loadItems(in, _textCoordQEyePlane);
+    loadItems(in, _textureCoordMatrix);
+    loadItems(in, _textEnvColor);
+
+    checkpoint::loadData(in, _near);
+    checkpoint::loadData(in, _far);
+    checkpoint::loadData(in, _fogBlendColor);
+    checkpoint::loadData(in, _fogDensity);
+    checkpoint::loadData(in, _fogLinearStart);
+    checkpoint::loadData(in, _fogLinearEnd);
+    checkpoint::loadData(in, _alphaTestRefValue);
+}
@@ -17,8 +17,11 @@
 
 #include "GALxStoredFPStateImp.h"
 
+#include "GALDevice.h"
+
 #include <vector>
 #include <string>
+#include <iosfwd>
 
 namespace libGAL
 {
@@ -269,10 +272,12 @@ public:
 //////////////////////////
 public:
 
-    GALxFixedPipelineStateImp(GALxGLState *gls);
+    GALxFixedPipelineStateImp(GALxGLState *gls, GALDevice* device);
 
     const GALxGLState *getGLState() const;
 
+    GALDevice* getDevice() const;
+
     void sync();
 
     void forceSync();
@@ -305,10 +310,16 @@ public:
 
     ~GALxFixedPipelineStateImp();
 
+    // Checkpoint support (the GALxGLState is saved with the stage state)
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     GALxGLState* _gls;
 
+    GALDevice* _device;
+
     friend class GALxLightImp;
     friend class GALxMaterialImp;
 
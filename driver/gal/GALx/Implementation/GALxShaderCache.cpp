@@ -4,6 +4,7 @@
 
 #include "GALxShaderCache.h"
 #include "InternalConstantBinding.h"
+#include "CheckpointStream.h"
 
 
 using namespace std;
@@ -12,6 +13,9 @@ using namespace libGAL;
 GALxShaderCache::GALxShaderCache()
 {
     maxPrograms = 100;
+    hits = 0;
+    misses = 0;
+    clears = 0;
 }
 
 gal_bool GALxShaderCache::isCached(const GALx_FIXED_PIPELINE_SETTINGS shaderSettings, GALShaderProgram*& cachedProgram, GALxConstantBindingList*& bindingList)
@@ -30,7 +34,6 @@ gal_bool GALxShaderCache::isCached(const GALx_FIXED_PIPELINE_SETTINGS shaderSett
 			if ( compareShaderSettings(matching->second->_shaderSettings, shaderSettings) ) // Compares the input and the cache entry settings struct
             {
                 hits++; // Hit stats
-				delete cachedProgram;
                 cachedProgram = matching->second->shaderProgram;
                 bindingList = matching->second->constantBinding;
                 return true; // Return a hit
@@ -92,7 +95,7 @@ bool GALxShaderCache::compareShaderSettings(GALx_FIXED_PIPELINE_SETTINGS cachedS
         equivalent &= cachedShaderSet.textureCoordinates[i].coordQ == checkingShaderSet.textureCoordinates[i].coordQ;
         equivalent &= cachedShaderSet.textureCoordinates[i].coordR == checkingShaderSet.textureCoordinates[i].coordR;
         equivalent &= cachedShaderSet.textureCoordinates[i].coordS == checkingShaderSet.textureCoordinates[i].coordS;
-        equivalent &= cachedShaderSet.textureCoordinates[i].coordT == checkingShaderSet.textureCoordinates[i].coordR;
+        equivalent &= cachedShaderSet.textureCoordinates[i].coordT == checkingShaderSet.textureCoordinates[i].coordT;
         equivalent &= cachedShaderSet.textureCoordinates[i].textureMatrixIsIdentity == checkingShaderSet.textureCoordinates[i].textureMatrixIsIdentity;
     }
 
@@ -204,3 +207,37 @@ void GALxShaderCache::dumpStatistics() const
     cout << "clears: " << clears << "\n";
     cout << "programs in cache: " << cache.size() << endl;
 }
+
+void GALxShaderCache::saveState(std::ostream& out, GALDevice* device) const
+{
+    checkpoint::saveValue(out, hits);
+    checkpoint::saveValue(out, misses);
+    checkpoint::saveValue(out, clears);
+
+    checkpoint::saveValue(out, (gal_uint) cache.size());
+    for ( multimap<gal_uint, cachedDataType* >::const_iterator it = cache.begin(); it != cache.end(); it++ )
+    {
+        checkpoint::saveValue(out, it->second->_shaderSettings);
+        checkpoint::saveValue(out, device->objectID(it->second->shaderProgram));
+    }
+}
+
+void GALxShaderCache::restoreState(std::istream& in, GALDevice* device, GALxConstantBindingList* (*buildBindings)(const GALx_FIXED_PIPELINE_SETTINGS&))
+{
+    clear();
+
+    checkpoint::loadValue(in, hits);
+    checkpoint::loadValue(in, misses);
+    checkpoint::loadValue(in, clears);
+
+    //  Entries with the same checksum are inserted in their saved order.
+    gal_uint entries = checkpoint::loadValue<gal_uint>(in);
+    for ( gal_uint i = 0; i < entries; i++ )
+    {
+        GALx_FIXED_PIPELINE_SETTINGS shaderSettings = checkpoint::loadValue<GALx_FIXED_PIPELINE_SETTINGS>(in);
+        GALShaderProgram* program = device->shaderProgramByID(checkpoint::loadValue<gal_uint>(in));
+
+        cachedDataType* entry = new cachedDataType(shaderSettings, program, buildBindings(shaderSettings));
+        cache.insert(make_pair(computeChecksum(shaderSettings), entry));
+    }
+}
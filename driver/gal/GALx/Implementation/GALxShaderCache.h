@@ -8,7 +8,9 @@
 #include <map>
 #include <list>
 #include <vector>
+#include <iosfwd>
 #include "GALTypes.h"
+#include "GALDevice.h"
 #include "GALxTLShader.h"
 #include "GALxTLState.h"
 #include "GALxFixedPipelineSettings.h"
@@ -24,7 +26,8 @@ public:
 
     /*
      * Try to find if a previous program is in the cache, if it is found the program is returned,
-     * otherwise, it is return a false
+     * otherwise, it is return a false.  The program previously pointed by cachedProgram is not
+     * released, the caller must destroy it through the GAL device.
      */
     gal_bool isCached(const GALx_FIXED_PIPELINE_SETTINGS shaderSettings, GALShaderProgram*& cachedProgram, GALxConstantBindingList*& bindingList);
 
@@ -54,6 +57,18 @@ public:
      *
      */
     void dumpStatistics() const;
+
+    /**
+     * Saves the cache entries to a checkpoint.  The programs are saved as GAL device
+     * object identifiers.
+     */
+    void saveState(std::ostream& out, GALDevice* device) const;
+
+    /**
+     * Restores the cache entries from a checkpoint.  The constant binding lists are
+     * not saved, they are rebuilt from the entry settings with buildBindings.
+     */
+    void restoreState(std::istream& in, GALDevice* device, GALxConstantBindingList* (*buildBindings)(const GALx_FIXED_PIPELINE_SETTINGS&));
     
 private:
 
@@ -74,47 +89,9 @@ private:
             shaderProgram = cachedProgram;
             constantBinding = bindingList;
 
-            _shaderSettings.alphaTestEnabled = shaderSettings.alphaTestEnabled;
-            _shaderSettings.alphaTestFunction = shaderSettings.alphaTestFunction;
-            _shaderSettings.colorMaterialEnabledFace = shaderSettings.colorMaterialEnabledFace;
-            _shaderSettings.colorMaterialMode = shaderSettings.colorMaterialMode;
-            _shaderSettings.cullEnabled = shaderSettings.cullEnabled;
-            _shaderSettings.cullMode = shaderSettings.cullMode;
-            _shaderSettings.fogCoordinateSource = shaderSettings.fogCoordinateSource;
-            _shaderSettings.fogEnabled = shaderSettings.fogEnabled;
-            _shaderSettings.fogMode = shaderSettings.fogMode;
-            _shaderSettings.lightingEnabled = shaderSettings.lightingEnabled;
-
-			for (gal_uint i = 0; i < GALx_FIXED_PIPELINE_SETTINGS::GALx_MAX_LIGHTS; i++ )
-			{
-                _shaderSettings.lights[i].enabled = shaderSettings.lights[i].enabled;
-                _shaderSettings.lights[i].lightType = shaderSettings.lights[i].lightType;
-			}
-
-            _shaderSettings.localViewer = shaderSettings.localViewer;
-            _shaderSettings.normalizeNormals = shaderSettings.normalizeNormals;
-            _shaderSettings.separateSpecular = shaderSettings.separateSpecular;
-
-			for (gal_uint i = 0; i < GALx_FIXED_PIPELINE_SETTINGS::GALx_MAX_TEXTURE_STAGES; i++ )
-			{
-                _shaderSettings.textureCoordinates[i].coordQ = shaderSettings.textureCoordinates[i].coordQ;
-                _shaderSettings.textureCoordinates[i].coordR = shaderSettings.textureCoordinates[i].coordR;
-                _shaderSettings.textureCoordinates[i].coordS = shaderSettings.textureCoordinates[i].coordS;
-                _shaderSettings.textureCoordinates[i].coordT = shaderSettings.textureCoordinates[i].coordR;
-                _shaderSettings.textureCoordinates[i].textureMatrixIsIdentity = shaderSettings.textureCoordinates[i].textureMatrixIsIdentity;
-			}
-
-			for (gal_uint i = 0; i < GALx_FIXED_PIPELINE_SETTINGS::GALx_MAX_TEXTURE_STAGES; i++ )
-			{
-                _shaderSettings.textureStages[i].activeTextureTarget = shaderSettings.textureStages[i].activeTextureTarget;
-                _shaderSettings.textureStages[i].baseInternalFormat = shaderSettings.textureStages[i].baseInternalFormat;
-                // shaderSettings.textureStages[i].combineSettings = shaderSettings.textureStages[i].combineSettings;
-                _shaderSettings.textureStages[i].enabled = shaderSettings.textureStages[i].enabled;
-                _shaderSettings.textureStages[i].textureStageFunction = shaderSettings.textureStages[i].textureStageFunction;
-			}
-
-			_shaderSettings.twoSidedLighting = shaderSettings.twoSidedLighting;
-
+            //  The whole settings struct is kept, the constant bindings of the program can
+            //  then be rebuilt from the entry.
+            _shaderSettings = shaderSettings;
 		}
 	};
 
@@ -14,6 +14,7 @@
 #include "GALxConstantBinding.h"
 
 #include <string>
+#include <iosfwd>
 
 /**
  * The libGAL namespace containing all the GAL interface classes and methods.
@@ -78,7 +79,7 @@ enum GALx_VERTEX_ATTRIBUTE_MAP
  * @param gal_device The GAL rendering device.
  * @returns             The new created Fixed Pipeline state.
  */
-GALxFixedPipelineState* GALxCreateFixedPipelineState(const GALDevice* gal_device);
+GALxFixedPipelineState* GALxCreateFixedPipelineState(GALDevice* gal_device);
 
 /**
  * Releases a GALxFixedPipelineState interface object.
@@ -87,6 +88,27 @@ GALxFixedPipelineState* GALxCreateFixedPipelineState(const GALDevice* gal_device
  */
 void GALxDestroyFixedPipelineState(GALxFixedPipelineState* fpState);
 
+/**
+ * Saves a fixed pipeline state, the generated program caches and the compilation log
+ * to a simulation checkpoint.
+ *
+ * The cached programs are saved as object identifiers of the GAL device the state was
+ * created for, the device state must be saved to the same checkpoint.
+ *
+ * @param fpState The GALxFixedPipelineState to save.
+ * @param out     The checkpoint stream.
+ */
+void GALxSaveState(const GALxFixedPipelineState* fpState, std::ostream& out);
+
+/**
+ * Restores a fixed pipeline state saved with GALxSaveState.  The GAL device state
+ * must be restored first.
+ *
+ * @param fpState The GALxFixedPipelineState to restore.
+ * @param in      The checkpoint stream.
+ */
+void GALxRestoreState(GALxFixedPipelineState* fpState, std::istream& in);
+
 
 /////////////////////////////////////
 // Fixed Pipeline Shader Emulation //
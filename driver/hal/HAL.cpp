@@ -10,6 +10,7 @@
 #include "PixelMapper.h"
 
 #include "Profiler.h"
+#include "CheckpointStream.h"
 
 #include <cstdio>
 #include <cmath>
@@ -613,6 +614,11 @@ void HAL::readGPURegister(arch::GPURegister regID, U32 index, arch::GPURegData &
     TRACING_EXIT_REGION()
 }
 
+U64 HAL::registerChanges() const
+{
+    return registerWriteBuffer.getRegisterChanges();
+}
+
 void HAL::readGPURegister(arch::GPURegister regID, arch::GPURegData &data)
 {
     TRACING_ENTER_REGION("HAL", "", "")
@@ -757,6 +763,174 @@ cgoMetaStream* HAL::nextMetaStream()
     return NULL;
 }
 
+void HAL::saveAllocationState(ostream& out)
+{
+    CG_ASSERT_COND(setGPUParametersCalled, "setGPUParameters was not called");
+
+    out.write((char *) &gpuMemory, sizeof(gpuMemory));
+    out.write((char *) &systemMemory, sizeof(systemMemory));
+    out.write((char *) &nextMemId, sizeof(nextMemId));
+    out.write((char *) &lastBlock, sizeof(lastBlock));
+    out.write((char *) &gpuAllocBlocks, sizeof(gpuAllocBlocks));
+    out.write((char *) &systemAllocBlocks, sizeof(systemAllocBlocks));
+    out.write((char *) &batchCounter, sizeof(batchCounter));
+
+    //  Memory descriptors (ordered by memory identifier).
+    U32 mds = U32(memoryDescriptors.size());
+    out.write((char *) &mds, sizeof(mds));
+
+    map<U32, _MemoryDescriptor*>::const_iterator it = memoryDescriptors.begin();
+    for ( ; it != memoryDescriptors.end(); it++ )
+    {
+        out.write((char *) &it->second->memId, sizeof(U32));
+        out.write((char *) &it->second->firstAddress, sizeof(U32));
+        out.write((char *) &it->second->lastAddress, sizeof(U32));
+        out.write((char *) &it->second->size, sizeof(U32));
+    }
+
+    //  Releases pending until the end of the current batch.
+    U32 releases = U32(pendentReleases.size());
+    out.write((char *) &releases, sizeof(releases));
+    if ( releases > 0 )
+        out.write((char *) &pendentReleases[0], releases * sizeof(U32));
+
+    //  Block maps.
+    out.write((char *) gpuMap, gpuMemory / BLOCK_SIZE);
+    out.write((char *) systemMap, systemMemory / BLOCK_SIZE);
+}
+
+void HAL::saveState(ostream& state)
+{
+    CG_ASSERT_COND(setGPUParametersCalled, "setGPUParameters was not called");
+
+    //  GPU parameters, only checked when the state is restored.
+    checkpoint::saveValue(state, gpuMemory);
+    checkpoint::saveValue(state, systemMemory);
+    checkpoint::saveValue(state, blocksz);
+    checkpoint::saveValue(state, sblocksz);
+    checkpoint::saveValue(state, forceMSAA);
+    checkpoint::saveValue(state, forcedMSAASamples);
+    checkpoint::saveValue(state, forceFP16ColorBuffer);
+
+    //  Memory allocation.
+    checkpoint::saveValue(state, nextMemId);
+    checkpoint::saveValue(state, lastBlock);
+    checkpoint::saveValue(state, gpuAllocBlocks);
+    checkpoint::saveValue(state, systemAllocBlocks);
+    checkpoint::saveValue(state, batchCounter);
+
+    checkpoint::saveValue(state, U32(memoryDescriptors.size()));
+    map<U32, _MemoryDescriptor*>::const_iterator it = memoryDescriptors.begin();
+    for ( ; it != memoryDescriptors.end(); it++ )
+        checkpoint::saveValue(state, *it->second);
+
+    checkpoint::saveVector(state, pendentReleases);
+
+    state.write((char *) gpuMap, gpuMemory / BLOCK_SIZE);
+    state.write((char *) systemMap, systemMemory / BLOCK_SIZE);
+
+    //  GPU registers and shader instruction memory.
+    registerWriteBuffer.saveState(state);
+    shSched.saveState(state);
+
+    //  MetaStreams generated but not yet consumed by the simulator.
+    checkpoint::saveValue(state, metaStreamCount);
+    for ( int i = 0, pos = out; i < metaStreamCount; i++, INC_MOD(pos) )
+        metaStreamBuffer[pos]->serialize(state);
+
+    checkpoint::saveValue(state, hRes);
+    checkpoint::saveValue(state, vRes);
+    checkpoint::saveValue(state, setResolutionCalled);
+    checkpoint::saveValue(state, preloadMemory);
+    checkpoint::saveValue(state, batch);
+    checkpoint::saveValue(state, frame);
+
+    //  Statistics.
+    checkpoint::saveValue(state, metaStreamGenerated);
+    checkpoint::saveValue(state, memoryAllocations);
+    checkpoint::saveValue(state, memoryDeallocations);
+    checkpoint::saveValue(state, mdSearches);
+    checkpoint::saveValue(state, addressSearches);
+    checkpoint::saveValue(state, memPreloads);
+    checkpoint::saveValue(state, memWrites);
+    checkpoint::saveValue(state, memPreloadBytes);
+    checkpoint::saveValue(state, memWriteBytes);
+}
+
+void HAL::restoreState(istream& state)
+{
+    CG_ASSERT_COND(setGPUParametersCalled, "setGPUParameters was not called");
+
+    U32 savedGPUMemory = checkpoint::loadValue<U32>(state);
+    U32 savedSystemMemory = checkpoint::loadValue<U32>(state);
+    U32 savedBlocksz = checkpoint::loadValue<U32>(state);
+    U32 savedSBlocksz = checkpoint::loadValue<U32>(state);
+    bool savedForceMSAA = checkpoint::loadValue<bool>(state);
+    U32 savedMSAASamples = checkpoint::loadValue<U32>(state);
+    bool savedForceFP16 = checkpoint::loadValue<bool>(state);
+
+    CG_ASSERT_COND((savedGPUMemory == gpuMemory) && (savedSystemMemory == systemMemory) &&
+                   (savedBlocksz == blocksz) && (savedSBlocksz == sblocksz) &&
+                   (savedForceMSAA == forceMSAA) && (savedMSAASamples == forcedMSAASamples) &&
+                   (savedForceFP16 == forceFP16ColorBuffer),
+                   "Checkpoint was saved with a different GPU memory or framebuffer configuration.");
+
+    checkpoint::loadValue(state, nextMemId);
+    checkpoint::loadValue(state, lastBlock);
+    checkpoint::loadValue(state, gpuAllocBlocks);
+    checkpoint::loadValue(state, systemAllocBlocks);
+    checkpoint::loadValue(state, batchCounter);
+
+    map<U32, _MemoryDescriptor*>::iterator it = memoryDescriptors.begin();
+    for ( ; it != memoryDescriptors.end(); it++ )
+        delete it->second;
+    memoryDescriptors.clear();
+
+    U32 mds = checkpoint::loadValue<U32>(state);
+    for ( U32 i = 0; i < mds; i++ )
+    {
+        _MemoryDescriptor* md = new _MemoryDescriptor;
+        checkpoint::loadValue(state, *md);
+        memoryDescriptors[md->memId] = md;
+    }
+
+    checkpoint::loadVector(state, pendentReleases);
+
+    state.read((char *) gpuMap, gpuMemory / BLOCK_SIZE);
+    state.read((char *) systemMap, systemMemory / BLOCK_SIZE);
+
+    registerWriteBuffer.restoreState(state);
+    shSched.restoreState(state);
+
+    //  Discard the MetaStreams generated since the driver was created.
+    for ( ; metaStreamCount > 0; metaStreamCount--, INC_MOD(out) )
+        delete metaStreamBuffer[out];
+    in = out = 0;
+
+    int pendent = checkpoint::loadValue<int>(state);
+    for ( int i = 0; i < pendent; i++ )
+        _sendcgoMetaStream(cgoMetaStream::deserialize(state));
+
+    checkpoint::loadValue(state, hRes);
+    checkpoint::loadValue(state, vRes);
+    checkpoint::loadValue(state, setResolutionCalled);
+    checkpoint::loadValue(state, preloadMemory);
+    checkpoint::loadValue(state, batch);
+    checkpoint::loadValue(state, frame);
+
+    checkpoint::loadValue(state, metaStreamGenerated);
+    checkpoint::loadValue(state, memoryAllocations);
+    checkpoint::loadValue(state, memoryDeallocations);
+    checkpoint::loadValue(state, mdSearches);
+    checkpoint::loadValue(state, addressSearches);
+    checkpoint::loadValue(state, memPreloads);
+    checkpoint::loadValue(state, memWrites);
+    checkpoint::loadValue(state, memPreloadBytes);
+    checkpoint::loadValue(state, memWriteBytes);
+
+    CG_ASSERT_COND(!state.fail(), "Error reading the driver state from the checkpoint.");
+}
+
 bool HAL::setSequentialStreamingMode( U32 count, U32 start )
 {
     TRACING_ENTER_REGION("HAL", "", "")
@@ -1536,6 +1710,69 @@ bool HAL::writeMemoryPreload(U32 md, U32 offset, const U08* data, U32 dataSize)
     return true;
 }
 
+bool HAL::writeMemory( U32 md, U32 offset, MetaStreamPayload* payload, bool isLocked )
+{
+    TRACING_ENTER_REGION("HAL", "", "")
+
+    U32 dataSize = payload->getSize();
+
+    _MemoryDescriptor* memDesc = _findMD( md );
+    if ( memDesc == NULL )
+        CG_ASSERT("Memory descriptor does not exist");
+
+    if ( !CHECK_MEMORY_ACCESS(memDesc,offset,dataSize) )
+        CG_ASSERT("Access memory out of range");
+
+    UPDATE_HIGH_ADDRESS_WRITTEN(memDesc,offset,dataSize);
+
+    //  The MetaStream takes the payload reference, the data is not copied.
+    if ( preloadMemory )
+    {
+        _sendcgoMetaStream( new cgoMetaStream( META_STREAM_PRELOAD, memDesc->firstAddress + offset, payload, md) );
+
+        memPreloads++;
+        memPreloadBytes += dataSize;
+    }
+    else
+    {
+        _sendcgoMetaStream( new cgoMetaStream( META_STREAM_WRITE, memDesc->firstAddress + offset, payload, md, isLocked) );
+
+        memWrites++;
+        memWriteBytes += dataSize;
+    }
+
+    TRACING_EXIT_REGION()
+
+    return true;
+}
+
+bool HAL::writeMemoryPreload(U32 md, U32 offset, MetaStreamPayload* payload)
+{
+    TRACING_ENTER_REGION("HAL", "", "")
+
+    U32 dataSize = payload->getSize();
+
+    _MemoryDescriptor* memDesc = _findMD(md);
+    
+    if (memDesc == NULL)
+        CG_ASSERT("Memory descriptor does not exist");
+
+    if (!CHECK_MEMORY_ACCESS(memDesc,offset,dataSize))
+        CG_ASSERT("Access memory out of range");
+
+    UPDATE_HIGH_ADDRESS_WRITTEN(memDesc,offset,dataSize);
+
+    //  Create META_STREAM_PRELOAD transaction sharing the payload.
+    _sendcgoMetaStream(new cgoMetaStream(META_STREAM_PRELOAD, memDesc->firstAddress + offset, payload, md));
+
+    memPreloads++;
+    memPreloadBytes += dataSize;
+    
+    TRACING_EXIT_REGION()
+
+    return true;
+}
+
 void HAL::printMemoryUsage()
 {
     printf("HAL => Memory usage : GPU %d blocks | System %d blocks\n", gpuAllocBlocks,
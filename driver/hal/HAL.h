@@ -683,6 +683,20 @@ public:
      */
     bool writeMemory( U32 md, U32 offset, const U08* data, U32 dataSize, bool isLocked = false );
 
+    /**
+     * Writes the data of a payload in an specific portion of memory described by a memory descriptor
+     * without copying it
+     *
+     * @param md memory descriptor representing a portion of memory previously reserved
+     * @param offset logical offset added to the initial address of this memory space
+     *        before writting
+     * @param payload payload with the data we want to write in local memory.  The HAL takes
+     *        ownership of one reference, the data must not change until the payload is released
+     *
+     * @return true if the writting was succesfull, false otherwise
+     */
+    bool writeMemory( U32 md, U32 offset, arch::MetaStreamPayload* payload, bool isLocked = false );
+
     //bool writeMemoryDebug(U32 md, U32 offset, const U08* data, U32 dataSize, const std::string& debugInfo);
 
     /**
@@ -700,6 +714,22 @@ public:
      */
     bool writeMemoryPreload(U32 md, U32 offset, const U08* data, U32 dataSize);
 
+    /**
+     *
+     * Preloads the data of a payload in an specific portion of memory described by a memory
+     * descriptor without copying it
+     *
+     * @param md memory descriptor representing a portion of memory previously reserved
+     * @param offset logical offset added to the initial address of this memory space
+     *        before writting
+     * @param payload payload with the data we want to preload in local memory.  The HAL takes
+     *        ownership of one reference, the data must not change until the payload is released
+     *
+     * @return true if the preload was succesful, false otherwise
+     *
+     */
+    bool writeMemoryPreload(U32 md, U32 offset, arch::MetaStreamPayload* payload);
+
     /**
      * Writes a GPU simulator's register
      *
@@ -749,6 +779,14 @@ public:
      */
      
     void readGPURegister(arch::GPURegister regID, U32 index, arch::GPURegData &data);
+
+    /**
+     *
+     *  Returns the number of register writes that changed the value of a GPU register.
+     *
+     */
+
+    U64 registerChanges() const;
         
     /**
      * Sends a command to the GPU Simulator
@@ -793,6 +831,32 @@ public:
      */
     arch::cgoMetaStream* nextMetaStream();
 
+    /**
+     * Writes the memory allocation state (memory sizes, block maps, memory descriptors
+     * and pendent releases) to a checkpoint.
+     *
+     * @param out Output stream where to write the allocation state.
+     */
+    void saveAllocationState(std::ostream& out);
+
+    /**
+     * Writes the complete driver state to a checkpoint: memory allocation (block maps and
+     * memory descriptors), GPU register status and pendent register writes, shader
+     * instruction memory scheduling, the MetaStreams still queued for the simulator,
+     * resolution, frame/batch counters and statistics.
+     *
+     * @param out Output stream where to write the driver state.
+     */
+    void saveState(std::ostream& out);
+
+    /**
+     * Replaces the driver state with the state written by saveState.  The GPU parameters
+     * (setGPUParameters) must be the ones used when the checkpoint was saved.
+     *
+     * @param in Input stream from where to read the driver state.
+     */
+    void restoreState(std::istream& in);
+
     /**
      * Destructor
      */
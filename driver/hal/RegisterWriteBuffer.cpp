@@ -4,13 +4,14 @@
 
 #include "RegisterWriteBuffer.h"
 #include "HAL.h"
+#include "CheckpointStream.h"
 #include <iostream>
 
 using namespace std;
 using namespace arch;
 
 RegisterWriteBuffer::RegisterWriteBuffer(HAL* driver, WritePolicy wp) : driver(driver), writePolicy(wp),
-    registerWritesCount(0)
+    registerWritesCount(0), registerChanges(0)
 {}
 
 void RegisterWriteBuffer::writeRegister(GPURegister reg, U32 index,
@@ -34,6 +35,9 @@ void RegisterWriteBuffer::writeRegister(GPURegister reg, U32 index,
     else
         CG_ASSERT("GPU Register not registered.");
 
+    if (registerChanged)
+        registerChanges++;
+
     //  Check if register writes can be buffered.
     if (writePolicy == WaitUntilFlush)
     {
@@ -95,6 +99,11 @@ void RegisterWriteBuffer::readRegister(arch::GPURegister reg, U32 index, arch::G
         CG_ASSERT("GPU Register not registered.");
 }
 
+U64 RegisterWriteBuffer::getRegisterChanges() const
+{
+    return registerChanges;
+}
+
 void RegisterWriteBuffer::flush()
 {
     //cout << "RegisterWriteBuffer::flush() -> Doing pendent register writes: " << writeBuffer.size() << " (saved "
@@ -128,6 +137,56 @@ void RegisterWriteBuffer::flush()
     writeBuffer.clear(); // reset cache contents
 }
 
+void RegisterWriteBuffer::saveState(ostream& out) const
+{
+    checkpoint::saveValue(out, registerWritesCount);
+    checkpoint::saveValue(out, registerChanges);
+    checkpoint::saveValue(out, writePolicy);
+
+    //  The set of registers in the status table is fixed by initAllRegisterStatus.
+    checkpoint::saveValue(out, U32(registerStatus.size()));
+    for ( WriteBufferConstIt it = registerStatus.begin(); it != registerStatus.end(); it++ )
+    {
+        checkpoint::saveValue(out, it->second.data);
+        checkpoint::saveValue(out, it->second.md);
+    }
+
+    checkpoint::saveValue(out, U32(writeBuffer.size()));
+    for ( WriteBufferConstIt it = writeBuffer.begin(); it != writeBuffer.end(); it++ )
+    {
+        checkpoint::saveValue(out, it->first.reg);
+        checkpoint::saveValue(out, it->first.index);
+        checkpoint::saveValue(out, it->second.data);
+        checkpoint::saveValue(out, it->second.md);
+    }
+}
+
+void RegisterWriteBuffer::restoreState(istream& in)
+{
+    checkpoint::loadValue(in, registerWritesCount);
+    checkpoint::loadValue(in, registerChanges);
+    checkpoint::loadValue(in, writePolicy);
+
+    U32 registers = checkpoint::loadValue<U32>(in);
+    CG_ASSERT_COND(registers == registerStatus.size(), "Register status table in the checkpoint does not match.");
+    for ( WriteBufferIt it = registerStatus.begin(); it != registerStatus.end(); it++ )
+    {
+        checkpoint::loadValue(in, it->second.data);
+        checkpoint::loadValue(in, it->second.md);
+    }
+
+    writeBuffer.clear();
+    U32 pendent = checkpoint::loadValue<U32>(in);
+    for ( U32 i = 0; i < pendent; i++ )
+    {
+        GPURegister reg = checkpoint::loadValue<GPURegister>(in);
+        U32 index = checkpoint::loadValue<U32>(in);
+        GPURegData data = checkpoint::loadValue<GPURegData>(in);
+        U32 md = checkpoint::loadValue<U32>(in);
+        writeBuffer.insert(make_pair(RegisterIdentifier(reg, index), RegisterData(data, md)));
+    }
+}
+
 void RegisterWriteBuffer::setWritePolicy(WritePolicy wp)
 {
     flush(); // flush previous pendent register writes
@@ -580,6 +639,9 @@ void RegisterWriteBuffer::initAllRegisterStatus ()
     initRegisterStatus( GPU_COMPUTE_PARAM_BUFFER_ADDR, 0, data, 0);
     initRegisterStatus( GPU_COMPUTE_PARAM_BUFFER_SIZE, 0, data, 0);
 
+    data.intVal = 0;
+    initRegisterStatus( GPU_STREAM_BASE_VERTEX, 0, data, 0); //0
+
     //data.uintVal = 0;
     //initRegisterStatus( GPU_LAST_REGISTER, 0, data, 0);
 
@@ -680,6 +742,7 @@ void RegisterWriteBuffer::dumpRegisterInfo(ofstream& out, GPURegister reg, U32 i
         case GPU_COMPUTE_SHARED_MEM_SIZE: out << "GPU_COMPUTE_SHARED_MEM_SIZE" << "(Index: " <<index<<", Data: "<<data.uintVal<<", MD:"<< md; break;
         case GPU_COMPUTE_PARAM_BUFFER_ADDR: out << "GPU_COMPUTE_PARAM_BUFFER_ADDR" << "(Index: " <<index<<", Data: "<<data.uintVal<<", MD:"<< md; break;
         case GPU_COMPUTE_PARAM_BUFFER_SIZE: out << "GPU_COMPUTE_PARAM_BUFFER_SIZE" << "(Index: " <<index<<", Data: "<<data.uintVal<<", MD:"<< md; break;
+        case GPU_STREAM_BASE_VERTEX: out << "GPU_STREAM_BASE_VERTEX" << "(Index: " <<index<<", Data: "<<data.intVal<<", MD:"<< md; break;
         case GPU_TEXTURE_ENABLE: out << "GPU_TEXTURE_ENABLE" << "(Index: " <<index<<", Data: "<<data.booleanVal<<", MD:"<< md; break;
         case GPU_TEXTURE_ADDRESS: out << "GPU_TEXTURE_ADDRESS" << "(Index: " <<index<<", Data: "<<data.uintVal<<", MD:"<< md; break; 
         case GPU_TEXTURE_WIDTH: out << "GPU_TEXTURE_WIDTH" << "(Index: " <<index<<", Data: "<<data.uintVal<<", MD:"<< md; break;
@@ -3,6 +3,7 @@
 #define REGISTERWRITEBUFFER_H
 
 #include <map>
+#include <iosfwd>
 #include "GPUReg.h"
 
 class HAL;
@@ -27,6 +28,9 @@ public:
 
     void flush();
 
+    // Register writes that changed the value of a register since the buffer was created
+    U64 getRegisterChanges() const;
+
     void setWritePolicy(WritePolicy wp);
     WritePolicy getWritePolicy() const;
 
@@ -38,10 +42,15 @@ public:
 
     void dumpRegisterInfo(std::ofstream& out, arch::GPURegister reg, U32 index, const arch::GPURegData& data, U32 md);
 
+    // Checkpoint support: register status table, pendent (buffered) writes and counters
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 
 private:
 
     U32 registerWritesCount; // Statistic
+    U64 registerChanges; // Statistic (not reset on flush)
 
     WritePolicy writePolicy;
 
@@ -1,6 +1,7 @@
 
 #include "ShaderProgramSched.h"
 #include "HAL.h"
+#include "CheckpointStream.h"
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -53,6 +54,51 @@ ShaderProgramSched::ShaderProgramSched(HAL* driver,U32 maxInstrSlots) :
 }
 
 
+void ShaderProgramSched::saveState(ostream& out) const
+{
+    checkpoint::saveVector(out, free);
+
+    checkpoint::saveValue(out, U32(progInfo.size()));
+    for ( ProgInfoConstIt it = progInfo.begin(); it != progInfo.end(); it++ )
+    {
+        checkpoint::saveValue(out, it->first);
+        checkpoint::saveValue(out, it->second);
+    }
+
+    checkpoint::saveValue(out, selectHits);
+    checkpoint::saveValue(out, totalSelects);
+    checkpoint::saveValue(out, totalClears);
+    checkpoint::saveValue(out, programsInMemoryAccum);
+    checkpoint::saveValue(out, shaderInstrMemoryUsage);
+    checkpoint::saveValue(out, shaderInstrMemoryUsageAccum);
+    checkpoint::saveValue(out, freeSlots);
+    checkpoint::saveValue(out, lastVertexShaderMD);
+}
+
+void ShaderProgramSched::restoreState(istream& in)
+{
+    U32 slots = U32(free.size());
+    checkpoint::loadVector(in, free);
+    CG_ASSERT_COND(free.size() == slots, "Shader instruction memory size in the checkpoint does not match.");
+
+    progInfo.clear();
+    U32 programs = checkpoint::loadValue<U32>(in);
+    for ( U32 i = 0; i < programs; i++ )
+    {
+        U32 md = checkpoint::loadValue<U32>(in);
+        checkpoint::loadValue(in, progInfo[md]);
+    }
+
+    checkpoint::loadValue(in, selectHits);
+    checkpoint::loadValue(in, totalSelects);
+    checkpoint::loadValue(in, totalClears);
+    checkpoint::loadValue(in, programsInMemoryAccum);
+    checkpoint::loadValue(in, shaderInstrMemoryUsage);
+    checkpoint::loadValue(in, shaderInstrMemoryUsageAccum);
+    checkpoint::loadValue(in, freeSlots);
+    checkpoint::loadValue(in, lastVertexShaderMD);
+}
+
 U32 ShaderProgramSched::reclaimRoom(U32 nInstrSlots, ShaderTarget target)
 {    
     U32 count = 0;
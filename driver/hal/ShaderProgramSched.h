@@ -4,6 +4,7 @@
 
 #include <map>
 #include <vector>
+#include <iosfwd>
 #include "GPUReg.h"
 
 class HAL;
@@ -47,6 +48,10 @@ public:
     
     void dumpStatistics() const;
 
+    // Checkpoint support: instruction slot allocation, resident programs and statistics
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 protected:
 
     // Used to release&allocate&check room in the subclasses
@@ -10,6 +10,7 @@
 
 //#define ENABLE_TRACING
 #include "Profiler.h"
+#include "CheckpointStream.h"
 
 #include <cstring>
 #include "glext.h"
@@ -120,6 +121,40 @@ ARBProgramObject::~ARBProgramObject()
         GALxDestroyCompiledProgram(_arbCompiledProgram);
 }
 
+void ARBProgramObject::saveState(std::ostream& out, GALDevice& device) const
+{
+    checkpoint::saveString(out, _source);
+    checkpoint::saveValue(out, _format);
+    checkpoint::saveValue(out, _galDev != 0);
+    checkpoint::saveValue(out, device.objectID(_shader));
+    checkpoint::saveValue(out, _sourceCompiled);
+    _locals.saveState(out);
+}
+
+void ARBProgramObject::restoreState(std::istream& in, GALDevice& device)
+{
+    _source = checkpoint::loadString(in);
+    checkpoint::loadValue(in, _format);
+    _galDev = checkpoint::loadValue<bool>(in) ? &device : 0;
+    _shader = device.shaderProgramByID(checkpoint::loadValue<gal_uint>(in));
+    checkpoint::loadValue(in, _sourceCompiled);
+    _locals.restoreState(in);
+
+    if ( _arbCompiledProgram )
+    {
+        GALxDestroyCompiledProgram(_arbCompiledProgram);
+        _arbCompiledProgram = 0;
+    }
+
+    if ( _sourceCompiled )
+        _arbCompiledProgram = GALxCompileProgram(_source);
+}
+
+void ARBProgramObject::forgetDeviceObjects()
+{
+    _shader = 0;
+}
+
 const char* ARBProgramObject::getStringID() const
 {
     GLenum tname = getTargetName();
@@ -76,6 +76,11 @@ public:
     bool isCompiled();
 
     const char* getStringID() const;
+
+    // Checkpoint support.  The compiled program is rebuilt from the source
+    void saveState(std::ostream& out, libGAL::GALDevice& device) const;
+    void restoreState(std::istream& in, libGAL::GALDevice& device);
+    void forgetDeviceObjects();
         
     ~ARBProgramObject();
 };
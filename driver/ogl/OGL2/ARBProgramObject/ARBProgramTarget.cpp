@@ -68,3 +68,13 @@ const ARBRegisterBank& ARBProgramTarget::getEnv() const
 {
     return _envs;
 }
+
+void ARBProgramTarget::saveState(std::ostream& out) const
+{
+    _envs.saveState(out);
+}
+
+void ARBProgramTarget::restoreState(std::istream& in)
+{
+    _envs.restoreState(in);
+}
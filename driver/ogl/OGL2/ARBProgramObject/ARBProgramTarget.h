@@ -41,6 +41,10 @@ public:
     ARBRegisterBank& getEnv();
     const ARBRegisterBank& getEnv() const;
 
+    // Checkpoint support (environment parameters)
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
     ARBProgramObject& getCurrent() const { return static_cast<ARBProgramObject&>(BaseTarget::getCurrent()); }
         
 };
@@ -4,6 +4,7 @@
 
 #include "ARBRegisterBank.h"
 #include "support.h"
+#include "CheckpointStream.h"
 #include <cstring>
 
 using namespace std;
@@ -89,3 +90,19 @@ vector<GLuint> ARBRegisterBank::getModified() const
 {
     return vector<GLuint>(_modified.begin(), _modified.end());    
 }
+
+void ARBRegisterBank::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _RegisterCount);
+    out.write((const char *) _registers, _RegisterCount * sizeof(_Register));
+    checkpoint::saveSet(out, _modified);
+}
+
+void ARBRegisterBank::restoreState(std::istream& in)
+{
+    if ( checkpoint::loadValue<GLuint>(in) != _RegisterCount )
+        CG_ASSERT("Checkpoint saved with a different number of registers");
+
+    in.read((char *) _registers, _RegisterCount * sizeof(_Register));
+    checkpoint::loadSet(in, _modified);
+}
@@ -9,6 +9,7 @@
 
 #include <vector>
 #include <set>
+#include <iosfwd>
 
 namespace ogl
 {
@@ -30,6 +31,10 @@ public:
     void get(GLuint reg, GLfloat* coords) const;
     const GLfloat* get(GLuint reg) const;
 
+    // Checkpoint support
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     const GLuint _RegisterCount;
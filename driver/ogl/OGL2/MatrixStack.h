@@ -6,6 +6,7 @@
     #define MATRIX_STACK
 
 #include "GALxGlobalTypeDefinitions.h"
+#include <iosfwd>
 
 namespace ogl
 {
@@ -23,6 +24,11 @@ public:
     virtual void push() = 0;
 
     virtual void pop() = 0;
+
+    // Checkpoint support (matrices pushed, the current matrix is saved with the GALx state)
+    virtual void saveState(std::ostream& out) const = 0;
+
+    virtual void restoreState(std::istream& in) = 0;
 };
 
 }
@@ -4,10 +4,37 @@
 
 #include "MatrixStackImp.h"
 #include "support.h"
+#include "CheckpointStream.h"
+#include <vector>
 
 using namespace ogl;
 using namespace libGAL;
 
+static void saveStack(std::ostream& out, std::stack<GALxFloatMatrix4x4> stack)
+{
+    std::vector<GALxFloatMatrix4x4> matrices;
+    for ( ; !stack.empty(); stack.pop() )
+        matrices.push_back(stack.top());
+
+    // Bottom of the stack first
+    checkpoint::saveValue(out, gal_uint(matrices.size()));
+    for ( gal_uint i = gal_uint(matrices.size()); i > 0; i-- )
+        checkpoint::saveData(out, matrices[i - 1]);
+}
+
+static void restoreStack(std::istream& in, std::stack<GALxFloatMatrix4x4>& stack)
+{
+    stack = std::stack<GALxFloatMatrix4x4>();
+
+    gal_uint matrices = checkpoint::loadValue<gal_uint>(in);
+    for ( gal_uint i = 0; i < matrices; i++ )
+    {
+        GALxFloatMatrix4x4 mat;
+        checkpoint::loadData(in, mat);
+        stack.push(mat);
+    }
+}
+
 MatrixStackProjection::MatrixStackProjection(GALxTransformAndLightingStage* tl) : _tl(tl)
 {}
 
@@ -108,3 +135,33 @@ void MatrixStackTextureCoord::pop()
     _tl->setTextureCoordMatrix(_UNIT, _stack.top());
     _stack.pop(); // discard top
 }
+
+void MatrixStackProjection::saveState(std::ostream& out) const
+{
+    saveStack(out, _stack);
+}
+
+void MatrixStackProjection::restoreState(std::istream& in)
+{
+    restoreStack(in, _stack);
+}
+
+void MatrixStackModelview::saveState(std::ostream& out) const
+{
+    saveStack(out, _stack);
+}
+
+void MatrixStackModelview::restoreState(std::istream& in)
+{
+    restoreStack(in, _stack);
+}
+
+void MatrixStackTextureCoord::saveState(std::ostream& out) const
+{
+    saveStack(out, _stack);
+}
+
+void MatrixStackTextureCoord::restoreState(std::istream& in)
+{
+    restoreStack(in, _stack);
+}
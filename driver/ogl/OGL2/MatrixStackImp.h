@@ -29,6 +29,10 @@ public:
 
     void pop();
 
+    void saveState(std::ostream& out) const;
+
+    void restoreState(std::istream& in);
+
 private:
 
     libGAL::GALxTransformAndLightingStage* _tl;
@@ -51,6 +55,10 @@ public:
 
     void pop();
 
+    void saveState(std::ostream& out) const;
+
+    void restoreState(std::istream& in);
+
 private:
 
     libGAL::GALxTransformAndLightingStage* _tl;
@@ -75,6 +83,10 @@ public:
 
     void pop();
 
+    void saveState(std::ostream& out) const;
+
+    void restoreState(std::istream& in);
+
 private:
 
     libGAL::GALxTextCoordGenerationStage* _tl;
@@ -5,6 +5,7 @@
 #include "OGL.h"
 #include "support.h"
 #include <iostream>
+#include <cstdio>
 #include "GALMatrix.h"
 #include <sstream>
 
@@ -75,3 +76,21 @@ void ogl::setResolution(libGAL::gal_uint width, libGAL::gal_uint height)
 
 void ogl::swapBuffers() { _ctx->gal().swapBuffers(); }
 
+void ogl::printStreamingUsage()
+{
+    if ( StreamingBuffer::bytesStreamed() != 0 )
+        printf("OGL => Streaming buffers : %llu bytes streamed | %d wraps\n",
+            StreamingBuffer::bytesStreamed(), StreamingBuffer::wraps());
+}
+
+void ogl::saveState(std::ostream& out)
+{
+    _ctx->gal().saveState(out);
+    _ctx->saveState(out);
+}
+
+void ogl::restoreState(std::istream& in)
+{
+    _ctx->gal().restoreState(in);
+    _ctx->restoreState(in);
+}
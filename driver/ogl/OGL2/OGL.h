@@ -25,6 +25,14 @@ namespace ogl
     // Called by TraceDriverOGL to perform a swap buffers on the galDev attached to the current GLContext
     void swapBuffers();
 
+    // Prints the glBegin/glEnd streaming buffer counters (bytes streamed and buffer wraps)
+    void printStreamingUsage();
+
+    // Called by the trace drivers to write/read the GAL device and GL context state to/from
+    // a simulation checkpoint.  The HAL state is saved separately and must be restored after
+    void saveState(std::ostream& out);
+    void restoreState(std::istream& in);
+
     libGAL::GAL_PRIMITIVE trPrimitive(GLenum primitive);
 
     // Must be moved to a common GAL place
@@ -4,6 +4,7 @@
 
 #include "OGLBaseManager.h"
 #include "support.h"
+#include "CheckpointStream.h"
 #include <cstring>
 #include <sstream>
 
@@ -218,6 +219,17 @@ bool BaseManager::removeObjects(GLsizei n, const GLuint* names)
 
             if ( object != objectMap->end() )
             {
+                // Targets bound to the deleted object revert to their default object
+                for ( GLuint g = 0; g < _nGroups; g++ )
+                {
+                    _TargetGroup::iterator it = _groups[g].begin();
+                    for ( ; it != _groups[g].end(); it++ )
+                    {
+                        if ( it->second->_current == object->second )
+                            it->second->setDefaultAsCurrent();
+                    }
+                }
+
                 delete object->second;
                 objectMap->erase(object);
             }
@@ -226,3 +238,199 @@ bool BaseManager::removeObjects(GLsizei n, const GLuint* names)
     return false;
 }
 
+void BaseManager::saveObjectRef(std::ostream& out, const BaseObject* bo) const
+{
+    if ( bo != 0 )
+    {
+        for ( GLuint g = 0; g < _nGroups; g++ )
+        {
+            _TargetGroup::const_iterator it = _groups[g].begin();
+            for ( ; it != _groups[g].end(); it++ )
+            {
+                if ( it->second->_def == bo )
+                {
+                    checkpoint::saveValue(out, GLuint(_DEFAULT_OBJECT));
+                    checkpoint::saveValue(out, it->first);
+                    checkpoint::saveValue(out, g);
+                    return;
+                }
+            }
+        }
+
+        _BaseStruct::const_iterator target = _manager.begin();
+        for ( ; target != _manager.end(); target++ )
+        {
+            _BaseObjectMap::const_iterator object = target->second->begin();
+            for ( ; object != target->second->end(); object++ )
+            {
+                if ( object->second == bo )
+                {
+                    checkpoint::saveValue(out, GLuint(_NAMED_OBJECT));
+                    checkpoint::saveValue(out, target->first);
+                    checkpoint::saveValue(out, object->first);
+                    return;
+                }
+            }
+        }
+    }
+
+    checkpoint::saveValue(out, GLuint(_NULL_OBJECT));
+}
+
+BaseObject* BaseManager::restoreObjectRef(std::istream& in) const
+{
+    GLuint kind = checkpoint::loadValue<GLuint>(in);
+
+    if ( kind == _NULL_OBJECT )
+        return 0;
+
+    GLenum target = checkpoint::loadValue<GLenum>(in);
+    GLuint id = checkpoint::loadValue<GLuint>(in);
+
+    if ( kind == _DEFAULT_OBJECT )
+    {
+        if ( id >= _nGroups )
+            CG_ASSERT("Checkpoint references a target group that does not exist");
+
+        _TargetGroup::const_iterator it = _groups[id].find(target);
+        if ( it == _groups[id].end() )
+            CG_ASSERT("Checkpoint references a target that does not exist");
+
+        return it->second->_def;
+    }
+
+    _BaseStruct::const_iterator tg = _manager.find(target);
+    if ( tg == _manager.end() )
+        CG_ASSERT("Checkpoint references a target that does not exist");
+
+    _BaseObjectMap::const_iterator object = tg->second->find(id);
+    if ( object == tg->second->end() )
+        CG_ASSERT("Checkpoint references an object that does not exist");
+
+    return object->second;
+}
+
+void BaseManager::saveState(std::ostream& out, libGAL::GALDevice& device) const
+{
+    checkpoint::saveValue(out, _nGroups);
+    checkpoint::saveValue(out, _currentGroup);
+
+    checkpoint::saveValue(out, GLuint(_nextIdMap.size()));
+    map<GLenum, GLuint>::const_iterator id = _nextIdMap.begin();
+    for ( ; id != _nextIdMap.end(); id++ )
+    {
+        checkpoint::saveValue(out, id->first);
+        checkpoint::saveValue(out, id->second);
+    }
+
+    // Objects alive and the target group of the target they are attached to
+    _BaseStruct::const_iterator target = _manager.begin();
+    for ( ; target != _manager.end(); target++ )
+    {
+        checkpoint::saveValue(out, target->first);
+        checkpoint::saveValue(out, GLuint(target->second->size()));
+
+        _BaseObjectMap::const_iterator object = target->second->begin();
+        for ( ; object != target->second->end(); object++ )
+        {
+            GLuint group = 0;
+            while ( group < _nGroups )
+            {
+                _TargetGroup::const_iterator it = _groups[group].find(target->first);
+                if ( (it != _groups[group].end()) && (it->second == &object->second->getTarget()) )
+                    break;
+                group++;
+            }
+
+            if ( group == _nGroups )
+                CG_ASSERT("Object not attached to a target of the manager");
+
+            checkpoint::saveValue(out, object->first);
+            checkpoint::saveValue(out, group);
+            object->second->saveState(out, device);
+        }
+    }
+
+    // Default object, bound object and state of each target
+    for ( GLuint g = 0; g < _nGroups; g++ )
+    {
+        _TargetGroup::const_iterator it = _groups[g].begin();
+        for ( ; it != _groups[g].end(); it++ )
+        {
+            if ( it->second->_def != 0 )
+                it->second->_def->saveState(out, device);
+            saveObjectRef(out, it->second->_current);
+            it->second->saveState(out);
+        }
+    }
+}
+
+void BaseManager::restoreState(std::istream& in, libGAL::GALDevice& device)
+{
+    if ( checkpoint::loadValue<GLuint>(in) != _nGroups )
+        CG_ASSERT("Checkpoint saved with a different number of target groups");
+
+    checkpoint::loadValue(in, _currentGroup);
+
+    _nextIdMap.clear();
+    GLuint ids = checkpoint::loadValue<GLuint>(in);
+    for ( GLuint i = 0; i < ids; i++ )
+    {
+        GLenum target = checkpoint::loadValue<GLenum>(in);
+        _nextIdMap[target] = checkpoint::loadValue<GLuint>(in);
+    }
+
+    // Replace the objects alive
+    _BaseStruct::iterator target = _manager.begin();
+    for ( ; target != _manager.end(); target++ )
+    {
+        _BaseObjectMap::iterator object = target->second->begin();
+        for ( ; object != target->second->end(); object++ )
+        {
+            object->second->forgetDeviceObjects();
+            delete object->second;
+        }
+        target->second->clear();
+    }
+
+    for ( GLuint t = 0; t < _manager.size(); t++ )
+    {
+        GLenum targetName = checkpoint::loadValue<GLenum>(in);
+        _BaseStruct::iterator tg = _manager.find(targetName);
+        if ( tg == _manager.end() )
+            CG_ASSERT("Checkpoint references a target that does not exist");
+
+        GLuint objects = checkpoint::loadValue<GLuint>(in);
+        for ( GLuint o = 0; o < objects; o++ )
+        {
+            GLuint name = checkpoint::loadValue<GLuint>(in);
+            GLuint group = checkpoint::loadValue<GLuint>(in);
+
+            if ( group >= _nGroups )
+                CG_ASSERT("Checkpoint references a target group that does not exist");
+
+            _TargetGroup::iterator it = _groups[group].find(targetName);
+            if ( it == _groups[group].end() )
+                CG_ASSERT("Checkpoint references a target that does not exist");
+
+            BaseObject* bo = it->second->createObject(name);
+            bo->restoreState(in, device);
+            tg->second->insert(make_pair(name, bo));
+        }
+    }
+
+    for ( GLuint g = 0; g < _nGroups; g++ )
+    {
+        _TargetGroup::iterator it = _groups[g].begin();
+        for ( ; it != _groups[g].end(); it++ )
+        {
+            if ( it->second->_def != 0 )
+                it->second->_def->restoreState(in, device);
+            it->second->_current = restoreObjectRef(in);
+            it->second->restoreState(in);
+        }
+    }
+
+    if ( in.fail() )
+        CG_ASSERT("Error reading the object state from the checkpoint");
+}
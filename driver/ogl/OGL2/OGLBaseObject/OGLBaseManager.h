@@ -12,6 +12,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <iosfwd>
 
 namespace ogl
 {
@@ -49,6 +50,14 @@ private:
      * Counter maintaining the next free id
      */
     std::map<GLenum, GLuint> _nextIdMap;    
+
+    // Checkpoint references to objects
+    enum _ObjectRefKind
+    {
+        _NULL_OBJECT,
+        _DEFAULT_OBJECT,
+        _NAMED_OBJECT
+    };
     
 protected:
    
@@ -148,6 +157,29 @@ public:
      *          current target group
      */
     virtual BaseObject& bindObject(GLenum target, GLuint name);
+
+    /**
+     * Writes the state of the manager to a simulation checkpoint: the objects alive with
+     * their state, the default object of each target, the object bound to each target and
+     * the state of the targets
+     *
+     * @param device GAL device used to identify the GAL objects referenced by the objects
+     */
+    void saveState(std::ostream& out, libGAL::GALDevice& device) const;
+
+    /**
+     * Replaces the objects and bindings with the ones written by saveState().  Must be called
+     * after the GAL device state is restored
+     */
+    void restoreState(std::istream& in, libGAL::GALDevice& device);
+
+    /**
+     * Writes a reference to an object of this manager (a default object, a named object or
+     * NULL) that can be read with restoreObjectRef() after restoreState().  Pointers to
+     * objects already deleted are saved as NULL
+     */
+    void saveObjectRef(std::ostream& out, const BaseObject* bo) const;
+    BaseObject* restoreObjectRef(std::istream& in) const;
     
     /**
      * BaseManager is the owner of BaseTargets and BaseObjects, so it is responsible of clean up 
@@ -52,6 +52,15 @@ BaseObject::~BaseObject()
 
 
 
+void BaseObject::saveState(std::ostream& out, libGAL::GALDevice& device) const
+{}
+
+void BaseObject::restoreState(std::istream& in, libGAL::GALDevice& device)
+{}
+
+void BaseObject::forgetDeviceObjects()
+{}
+
 const char* BaseObject::getStringID() const
 {
     return "UNKNOWN Base object";
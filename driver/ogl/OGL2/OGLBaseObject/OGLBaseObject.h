@@ -8,6 +8,12 @@
 #include "gl.h"
 #include <vector>
 #include <string>
+#include <iosfwd>
+
+namespace libGAL
+{
+class GALDevice;
+}
 
 namespace ogl
 {
@@ -61,6 +67,25 @@ public:
     virtual ~BaseObject() = 0;
 
     virtual const char* getStringID() const;
+
+    /**
+     * Writes the state of the object to a simulation checkpoint (name and target are saved
+     * by the BaseManager).  References to GAL objects are saved with GALDevice::objectID()
+     */
+    virtual void saveState(std::ostream& out, libGAL::GALDevice& device) const;
+
+    /**
+     * Restores the state written by saveState().  Must be called after the GAL device
+     * state is restored
+     */
+    virtual void restoreState(std::istream& in, libGAL::GALDevice& device);
+
+    /**
+     * Drops the references to the GAL objects owned by this object so they are not destroyed
+     * with it.  Called before the objects are replaced by the objects of a checkpoint, the
+     * GAL device has already restored (or deleted) its objects
+     */
+    virtual void forgetDeviceObjects();
     
     virtual std::string toString() const;
 };    
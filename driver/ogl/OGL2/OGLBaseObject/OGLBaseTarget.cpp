@@ -42,6 +42,12 @@ bool BaseTarget::hasCurrent() const
     return (_current != 0);
 }
 
+void BaseTarget::saveState(std::ostream& out) const
+{}
+
+void BaseTarget::restoreState(std::istream& in)
+{}
+
 BaseTarget::~BaseTarget()
 {
     delete _def;
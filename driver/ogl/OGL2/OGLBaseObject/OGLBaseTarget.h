@@ -6,6 +6,7 @@
     #define OGLBASETARGET
 
 #include <map>
+#include <iosfwd>
 #include "OGLBaseObject.h"
 #include "glext.h"
 
@@ -89,6 +90,13 @@ public:
      * @return a GLuint indicating the name of the target
      */
     virtual GLuint getName() const;
+
+    /**
+     * Writes/reads the state kept by the target (not the bound objects) to/from a simulation
+     * checkpoint
+     */
+    virtual void saveState(std::ostream& out) const;
+    virtual void restoreState(std::istream& in);
     
     /**
      * Destroys the default BaseObject
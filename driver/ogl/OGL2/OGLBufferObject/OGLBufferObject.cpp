@@ -5,6 +5,7 @@
 #include "OGLBufferObject.h"
 #include "OGLBufferTarget.h"
 #include "glext.h"
+#include "CheckpointStream.h"
 #include <iostream>
 
 using namespace ogl;
@@ -112,6 +113,24 @@ libGAL::GAL_USAGE BufferObject::getGALUsage (GLenum usage)
     }
 }
 
+void BufferObject::saveState(std::ostream& out, libGAL::GALDevice& device) const
+{
+    checkpoint::saveValue(out, _galDev != 0);
+    if ( _galDev != 0 )
+        checkpoint::saveValue(out, device.objectID(_data));
+}
+
+void BufferObject::restoreState(std::istream& in, libGAL::GALDevice& device)
+{
+    if ( checkpoint::loadValue<bool>(in) )
+    {
+        _galDev = &device;
+        _data = static_cast<libGAL::GALBuffer*>(device.resourceByID(checkpoint::loadValue<libGAL::gal_uint>(in)));
+    }
+    else
+        _galDev = 0;
+}
+
 BufferObject::~BufferObject()
 {
 
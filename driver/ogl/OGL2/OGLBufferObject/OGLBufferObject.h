@@ -44,6 +44,10 @@ public:
     void setPartialContents(GLsizei offset, GLsizei size, const void* data);
 
     libGAL::GAL_USAGE getGALUsage (GLenum usage);
+
+    // Checkpoint support
+    void saveState(std::ostream& out, libGAL::GALDevice& device) const;
+    void restoreState(std::istream& in, libGAL::GALDevice& device);
     
     ~BufferObject();
     
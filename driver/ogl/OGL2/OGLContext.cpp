@@ -9,6 +9,7 @@
 #include "GALSampler.h"
 #include "GL2GAL.h"
 #include "GL2GALx.h"
+#include "CheckpointStream.h"
 #include <typeinfo>
 
 using namespace ogl;
@@ -49,7 +50,8 @@ GLContext::GLContext(GALDevice* galDev) :
     _genericAttribArrayFlags(16, false),
 	_clientTextureUnits(8,false),
 	_emulVertexProgram(0),
-	_emulFragmentProgram(0)
+	_emulFragmentProgram(0),
+	_currentFragmentProgram(0)
 
 {
     for ( gal_uint i = 0; i < TEXTURE_UNITS; ++i )
@@ -58,6 +60,13 @@ GLContext::GLContext(GALDevice* galDev) :
     for ( gal_uint i = 0; i < 16; ++i )
         _textureVBO[i] = false;
 
+    _vertexRing = new StreamingBuffer(galDev);
+    _colorRing = new StreamingBuffer(galDev);
+    _normalRing = new StreamingBuffer(galDev);
+
+    for ( gal_uint i = 0; i < 8; ++i )
+        _textureRing[i] = new StreamingBuffer(galDev);
+
     for ( gal_uint i = 0; i < 31; ++i )
         _freeStream.insert(i);
 
@@ -140,13 +149,16 @@ void GLContext::addVertex(gal_float x, gal_float y, gal_float z, gal_float w)
 {
     ++_bufferVertexes;
 
-    _vertexBuffer->pushData(&x, sizeof(gal_float));
-    _vertexBuffer->pushData(&y, sizeof(gal_float));
-    _vertexBuffer->pushData(&z, sizeof(gal_float));
-    _vertexBuffer->pushData(&w, sizeof(gal_float));
+    gal_float position[4];
+    position[0] = x;
+    position[1] = y;
+    position[2] = z;
+    position[3] = w;
+
+    _vertexRing->push(position, 4*sizeof(gal_float));
 
-    _colorBuffer->pushData(_currentColor, 4*sizeof(gal_float));
-    _normalBuffer->pushData(_currentNormal, 3*sizeof(gal_float));
+    _colorRing->push(_currentColor, 4*sizeof(gal_float));
+    _normalRing->push(_currentNormal, 3*sizeof(gal_float));
 
     gal_float aux[4];
     aux[0] = _currentTexCoord[0][0];
@@ -154,14 +166,8 @@ void GLContext::addVertex(gal_float x, gal_float y, gal_float z, gal_float w)
     aux[2] = _currentTexCoord[0][2];
     aux[3] = _currentTexCoord[0][3];
 
-    _textureBuffer[0]->pushData(aux, 4*sizeof(gal_float));
-    _textureBuffer[1]->pushData(aux, 4*sizeof(gal_float));
-    _textureBuffer[2]->pushData(aux, 4*sizeof(gal_float));
-	_textureBuffer[3]->pushData(aux, 4*sizeof(gal_float));
-	_textureBuffer[4]->pushData(aux, 4*sizeof(gal_float));
-	_textureBuffer[5]->pushData(aux, 4*sizeof(gal_float));
-	_textureBuffer[6]->pushData(aux, 4*sizeof(gal_float));
-	_textureBuffer[7]->pushData(aux, 4*sizeof(gal_float));
+    for ( gal_uint i = 0; i < 8; i++ )
+        _textureRing[i]->push(aux, 4*sizeof(gal_float));
 }
 
 void GLContext::setColor(gal_float red, gal_float green, gal_float blue, gal_float alpha)
@@ -218,13 +224,20 @@ void GLContext::initInternalBuffers(gal_bool createBuffers)
             _textureBuffer[i] = 0;
         }
 
-    if (createBuffers) {  // buffers are only created when we are using glBegin/glEnd calls; other calls attach directly the buffer
-        _vertexBuffer = _galDev->createBuffer();
-        _colorBuffer = _galDev->createBuffer();
-        _normalBuffer = _galDev->createBuffer();
+    if (createBuffers) {  // glBegin/glEnd blocks are staged in the streaming buffers; other calls attach directly the buffer
+        _vertexRing->reset();
+        _colorRing->reset();
+        _normalRing->reset();
+
+        for ( gal_int i = 0; i < 8; i++)
+            _textureRing[i]->reset();
+
+        _vertexBuffer = 0;
+        _colorBuffer = 0;
+        _normalBuffer = 0;
 
         for ( gal_int i = 0; i < 16; i++)
-            _textureBuffer[i] = _galDev->createBuffer();
+            _textureBuffer[i] = 0;
 
         _vertexVBO = false;
         _colorVBO = false;
@@ -235,6 +248,31 @@ void GLContext::initInternalBuffers(gal_bool createBuffers)
     }
 }
 
+void GLContext::commitInternalBuffers()
+{
+    //This function is used only by glEnd
+
+    // The streaming buffers are persistent, flag them as VBOs so they are never destroyed
+    _vertexDesc.offset = _vertexRing->commit();
+    _vertexBuffer = _vertexRing->buffer();
+    _vertexVBO = true;
+
+    _colorDesc.offset = _colorRing->commit();
+    _colorBuffer = _colorRing->buffer();
+    _colorVBO = true;
+
+    _normalDesc.offset = _normalRing->commit();
+    _normalBuffer = _normalRing->buffer();
+    _normalVBO = true;
+
+    for ( gal_int i = 0; i < 8; i++)
+    {
+        _textureDesc[i].offset = _textureRing[i]->commit();
+        _textureBuffer[i] = _textureRing[i]->buffer();
+        _textureVBO[i] = true;
+    }
+}
+
 void GLContext::setClearColor(gal_ubyte red, gal_ubyte green, gal_ubyte blue, gal_ubyte alpha)
 {
     _clearColorR = red;
@@ -2406,3 +2444,201 @@ void GLContext::popAttrib (void)
 
 }
 
+void GLContext::saveState(std::ostream& out) const
+{
+    using namespace checkpoint;
+
+    saveValue(out, _numTU);
+    saveSet(out, _freeStream);
+    saveSet(out, _freeSampler);
+
+    _arbProgramManager.saveState(out, *_galDev);
+    _bufferManager.saveState(out, *_galDev);
+    _textureManager.saveState(out, *_galDev);
+
+    saveValue(out, _renderStates);
+    saveValue(out, _fpSettings);
+
+    saveValue(out, _vertexDesc);
+    saveValue(out, _colorDesc);
+    saveValue(out, _normalDesc);
+    saveValue(out, _textureDesc);
+    saveValue(out, _vertexStreamMap);
+    saveValue(out, _colorStreamMap);
+    saveValue(out, _normalStreamMap);
+    saveValue(out, _textureStreamMap);
+    saveValue(out, _textureSamplerMap);
+
+    saveValue(out, _galDev->objectID(_vertexBuffer));
+    saveValue(out, _galDev->objectID(_colorBuffer));
+    saveValue(out, _galDev->objectID(_normalBuffer));
+    for ( gal_uint i = 0; i < 16; i++ )
+        saveValue(out, _galDev->objectID(_textureBuffer[i]));
+
+    saveValue(out, _vertexVBO);
+    saveValue(out, _colorVBO);
+    saveValue(out, _normalVBO);
+    saveValue(out, _textureVBO);
+
+    _vertexRing->saveState(out);
+    _colorRing->saveState(out);
+    _normalRing->saveState(out);
+    for ( gal_uint i = 0; i < 8; i++ )
+        _textureRing[i]->saveState(out);
+    StreamingBuffer::saveCounters(out);
+
+    saveValue(out, _bufferVertexes);
+    saveValue(out, _currentColor);
+    saveValue(out, _currentNormal);
+    saveValue(out, _currentTexCoord);
+
+    // Client memory pointers are saved as they are, they are only valid in the call that set them
+    saveValue(out, _posVArray);
+    saveValue(out, _colVArray);
+    saveValue(out, _norVArray);
+    saveValue(out, _indVArray);
+    saveValue(out, _edgeVArray);
+    saveVector(out, _texVArray);
+    saveVector(out, _genericVArray);
+    saveVector(out, _genericDesc);
+    saveValue(out, gal_uint(_genericBuffer.size()));
+    for ( gal_uint i = 0; i < _genericBuffer.size(); i++ )
+        saveValue(out, _galDev->objectID(_genericBuffer[i]));
+    saveVector(out, _genericStreamMap);
+    saveValue(out, _genericAttribArrayEnabled);
+    saveVector(out, _genericAttribArrayFlags);
+
+    saveValue(out, _clearColorR);
+    saveValue(out, _clearColorG);
+    saveValue(out, _clearColorB);
+    saveValue(out, _clearColorA);
+    saveValue(out, _depthClearValue);
+    saveValue(out, _stencilClearValue);
+
+    saveValue(out, _galDev->objectID(_emulVertexProgram));
+    saveValue(out, _galDev->objectID(_emulFragmentProgram));
+    saveValue(out, _galDev->objectID(_currentFragmentProgram));
+
+    for ( gal_uint g = 0; g < 3; g++ )
+        for ( gal_uint i = 0; i < _stackGroup[g].size(); i++ )
+            _stackGroup[g][i]->saveState(out);
+
+    saveValue(out, _currentStackGroup);
+    saveValue(out, _activeTextureUnit);
+    saveValue(out, _currentModelview);
+    saveValue(out, _activeBuffer);
+
+    saveValue(out, gal_uint(_textureUnits.size()));
+    for ( gal_uint i = 0; i < _textureUnits.size(); i++ )
+        _textureUnits[i].saveState(out, _textureManager);
+
+    saveValue(out, _fogStart);
+    saveValue(out, _fogEnd);
+    saveValue(out, _currentClientTextureUnit);
+    saveVector(out, _clientTextureUnits);
+
+    // Saved last, restoring the program objects recompiles their source and changes the
+    // GALx compiler state
+    libGAL::GALxSaveState(_fpState, out);
+}
+
+void GLContext::restoreState(std::istream& in)
+{
+    using namespace checkpoint;
+
+    if ( loadValue<int>(in) != _numTU )
+        CG_ASSERT("Checkpoint saved with a different number of texture units");
+
+    loadSet(in, _freeStream);
+    loadSet(in, _freeSampler);
+
+    _arbProgramManager.restoreState(in, *_galDev);
+    _bufferManager.restoreState(in, *_galDev);
+    _textureManager.restoreState(in, *_galDev);
+
+    loadValue(in, _renderStates);
+    loadValue(in, _fpSettings);
+
+    loadValue(in, _vertexDesc);
+    loadValue(in, _colorDesc);
+    loadValue(in, _normalDesc);
+    loadValue(in, _textureDesc);
+    loadValue(in, _vertexStreamMap);
+    loadValue(in, _colorStreamMap);
+    loadValue(in, _normalStreamMap);
+    loadValue(in, _textureStreamMap);
+    loadValue(in, _textureSamplerMap);
+
+    _vertexBuffer = static_cast<GALBuffer*>(_galDev->resourceByID(loadValue<gal_uint>(in)));
+    _colorBuffer = static_cast<GALBuffer*>(_galDev->resourceByID(loadValue<gal_uint>(in)));
+    _normalBuffer = static_cast<GALBuffer*>(_galDev->resourceByID(loadValue<gal_uint>(in)));
+    for ( gal_uint i = 0; i < 16; i++ )
+        _textureBuffer[i] = static_cast<GALBuffer*>(_galDev->resourceByID(loadValue<gal_uint>(in)));
+
+    loadValue(in, _vertexVBO);
+    loadValue(in, _colorVBO);
+    loadValue(in, _normalVBO);
+    loadValue(in, _textureVBO);
+
+    _vertexRing->restoreState(in);
+    _colorRing->restoreState(in);
+    _normalRing->restoreState(in);
+    for ( gal_uint i = 0; i < 8; i++ )
+        _textureRing[i]->restoreState(in);
+    StreamingBuffer::restoreCounters(in);
+
+    loadValue(in, _bufferVertexes);
+    loadValue(in, _currentColor);
+    loadValue(in, _currentNormal);
+    loadValue(in, _currentTexCoord);
+
+    loadValue(in, _posVArray);
+    loadValue(in, _colVArray);
+    loadValue(in, _norVArray);
+    loadValue(in, _indVArray);
+    loadValue(in, _edgeVArray);
+    loadVector(in, _texVArray);
+    loadVector(in, _genericVArray);
+    loadVector(in, _genericDesc);
+    _genericBuffer.resize(loadValue<gal_uint>(in));
+    for ( gal_uint i = 0; i < _genericBuffer.size(); i++ )
+        _genericBuffer[i] = static_cast<GALBuffer*>(_galDev->resourceByID(loadValue<gal_uint>(in)));
+    loadVector(in, _genericStreamMap);
+    loadValue(in, _genericAttribArrayEnabled);
+    loadVector(in, _genericAttribArrayFlags);
+
+    loadValue(in, _clearColorR);
+    loadValue(in, _clearColorG);
+    loadValue(in, _clearColorB);
+    loadValue(in, _clearColorA);
+    loadValue(in, _depthClearValue);
+    loadValue(in, _stencilClearValue);
+
+    _emulVertexProgram = _galDev->shaderProgramByID(loadValue<gal_uint>(in));
+    _emulFragmentProgram = _galDev->shaderProgramByID(loadValue<gal_uint>(in));
+    _currentFragmentProgram = _galDev->shaderProgramByID(loadValue<gal_uint>(in));
+
+    for ( gal_uint g = 0; g < 3; g++ )
+        for ( gal_uint i = 0; i < _stackGroup[g].size(); i++ )
+            _stackGroup[g][i]->restoreState(in);
+
+    loadValue(in, _currentStackGroup);
+    loadValue(in, _activeTextureUnit);
+    loadValue(in, _currentModelview);
+    loadValue(in, _activeBuffer);
+
+    if ( loadValue<gal_uint>(in) != _textureUnits.size() )
+        CG_ASSERT("Checkpoint saved with a different number of texture units");
+    for ( gal_uint i = 0; i < _textureUnits.size(); i++ )
+        _textureUnits[i].restoreState(in, _textureManager);
+
+    loadValue(in, _fogStart);
+    loadValue(in, _fogEnd);
+    loadValue(in, _currentClientTextureUnit);
+    loadVector(in, _clientTextureUnits);
+
+    libGAL::GALxRestoreState(_fpState, in);
+
+    if ( in.fail() )
+        CG_ASSERT("Error reading the OpenGL context state from the checkpoint");
+}
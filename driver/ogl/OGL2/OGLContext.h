@@ -15,6 +15,7 @@
 #include "MatrixStack.h"
 #include "GALx.h"
 #include "OGLTextureUnit.h"
+#include "OGLStreamingBuffer.h"
 #include "GALRasterizationStage.h"
 #include "GALxTextCoordGenerationStage.h"
 #include "GALZStencilStage.h"
@@ -28,6 +29,7 @@
 #include <bitset>
 #include <set>
 #include <vector>
+#include <iosfwd>
 #include <math.h>
 
 namespace ogl
@@ -162,6 +164,7 @@ public:
 
     gal_uint countInternalVertexes() const;
     void initInternalBuffers(gal_bool createBuffers);
+    void commitInternalBuffers();
     void attachInternalBuffers();
     void deattachInternalBuffers();
 
@@ -260,6 +263,20 @@ public:
     void pushAttrib (GLbitfield mask);
     void popAttrib (void);
 
+    /**
+     * Writes the context state to a simulation checkpoint: the program, buffer and texture
+     * objects, the bindings, vertex arrays, matrix stacks, texture units, internal buffers
+     * and the GALx fixed pipeline state.  References to GAL objects are saved with
+     * GALDevice::objectID(), so the GAL device state must be saved in the same checkpoint
+     */
+    void saveState(std::ostream& out) const;
+
+    /**
+     * Restores the context state written by saveState().  Must be called after the GAL
+     * device state is restored
+     */
+    void restoreState(std::istream& in);
+
 private:
 
     int _numTU;
@@ -304,6 +321,12 @@ private:
     gal_bool _normalVBO;
     gal_bool _textureVBO[16];
 
+    // Persistent streaming buffers where the glBegin/glEnd blocks are written
+    StreamingBuffer* _vertexRing;
+    StreamingBuffer* _colorRing;
+    StreamingBuffer* _normalRing;
+    StreamingBuffer* _textureRing[8];
+
     gal_uint _bufferVertexes;   // Number of vertices added (glBegin/glEng)
 
     gal_float _currentColor[4];
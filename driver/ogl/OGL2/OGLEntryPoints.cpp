@@ -529,6 +529,9 @@ GLAPI void GLAPIENTRY OGL_glEnd( void )
     // Sets the proper shader (user/auto-generated) and update GPU shader constants
     _ctx->setShaders();
 
+    // Write the vertices of the block into the streaming buffers
+    _ctx->commitInternalBuffers();
+
     // Use internal buffers to draw
     _ctx->attachInternalBuffers(); // Attach internal buffers to streams
 
@@ -545,6 +548,9 @@ GLAPI void GLAPIENTRY OGL_glEnd( void )
     _ctx->deattachInternalSamplers();
 
     _ctx->deattachInternalBuffers();
+
+    // Restore the stream offsets set by commitInternalBuffers
+    _ctx->resetDescriptors();
     TRACING_EXIT_REGION()
 }
 
@@ -0,0 +1,96 @@
+/**************************************************************************
+ *
+ */
+
+#include "OGLStreamingBuffer.h"
+#include "support.h"
+#include "CheckpointStream.h"
+
+using namespace ogl;
+using namespace libGAL;
+
+gal_ulonglong StreamingBuffer::_bytesStreamed = 0;
+gal_uint StreamingBuffer::_wraps = 0;
+
+StreamingBuffer::StreamingBuffer(GALDevice* galDev, gal_uint capacity) :
+    _galDev(galDev), _capacity(capacity), _offset(0)
+{
+    if ( capacity == 0 )
+        CG_ASSERT("Streaming buffer capacity must be greater than 0");
+
+    _buffer = _galDev->createBuffer(capacity);
+
+    // Contents are undefined, avoid uploading the whole buffer the first time it is used
+    _buffer->orphan();
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    _galDev->destroy(_buffer);
+}
+
+gal_uint StreamingBuffer::commit()
+{
+    gal_uint size = static_cast<gal_uint>(_staging.size());
+
+    if ( size == 0 )
+        return 0;
+
+    if ( size > _capacity )
+    {
+        // Grow the buffer to hold the block (not expected in steady state)
+        while ( _capacity < size )
+            _capacity *= 2;
+
+        _buffer->resize(_capacity, true);
+        _buffer->orphan();
+        _offset = 0;
+        ++_wraps;
+    }
+    else if ( _offset + size > _capacity )
+    {
+        // Orphan the buffer and restart at the beginning
+        _buffer->orphan();
+        _offset = 0;
+        ++_wraps;
+    }
+
+    gal_uint blockOffset = _offset;
+
+    _buffer->updateStreamData(blockOffset, size, &_staging[0]);
+
+    _offset = (blockOffset + size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    _bytesStreamed += size;
+
+    _staging.clear();
+
+    return blockOffset;
+}
+
+void StreamingBuffer::saveState(std::ostream& out) const
+{
+    checkpoint::saveValue(out, _galDev->objectID(_buffer));
+    checkpoint::saveValue(out, _capacity);
+    checkpoint::saveValue(out, _offset);
+    checkpoint::saveVector(out, _staging);
+}
+
+void StreamingBuffer::restoreState(std::istream& in)
+{
+    _buffer = static_cast<GALBuffer*>(_galDev->resourceByID(checkpoint::loadValue<gal_uint>(in)));
+    checkpoint::loadValue(in, _capacity);
+    checkpoint::loadValue(in, _offset);
+    checkpoint::loadVector(in, _staging);
+}
+
+void StreamingBuffer::saveCounters(std::ostream& out)
+{
+    checkpoint::saveValue(out, _bytesStreamed);
+    checkpoint::saveValue(out, _wraps);
+}
+
+void StreamingBuffer::restoreCounters(std::istream& in)
+{
+    checkpoint::loadValue(in, _bytesStreamed);
+    checkpoint::loadValue(in, _wraps);
+}
@@ -0,0 +1,102 @@
+/**************************************************************************
+ *
+ */
+
+#ifndef OGL_STREAMINGBUFFER
+    #define OGL_STREAMINGBUFFER
+
+#include "GALTypes.h"
+#include "GALDevice.h"
+#include "GALBuffer.h"
+
+#include <vector>
+#include <iosfwd>
+
+namespace ogl
+{
+
+/**
+ * Persistent streaming ring buffer for the vertex attributes specified between glBegin and glEnd
+ *
+ * The data of a glBegin/glEnd block is staged in CPU memory and appended to a GALBuffer that
+ * is created once.  Each block is written to a range of the buffer not used by the previous
+ * batches, so the GPU memory is written without waiting for them.  When a block does not fit
+ * in the remaining space the buffer is orphaned (new GPU memory is allocated, the previous
+ * memory is released when the batches using it have finished) and the block is written at
+ * the start of the buffer.
+ */
+class StreamingBuffer
+{
+public:
+
+    static const libGAL::gal_uint DEFAULT_CAPACITY = 256 * 1024;    ///< Initial buffer size in bytes
+    static const libGAL::gal_uint ALIGNMENT = 32;                   ///< Alignment of the blocks (GPU memory burst)
+
+    StreamingBuffer(libGAL::GALDevice* galDev, libGAL::gal_uint capacity = DEFAULT_CAPACITY);
+
+    ~StreamingBuffer();
+
+    /**
+     * Discards the staged data
+     */
+    void reset() { _staging.clear(); }
+
+    /**
+     * Adds data to the staged block
+     */
+    void push(const libGAL::gal_void* data, libGAL::gal_uint size)
+    {
+        const libGAL::gal_ubyte* bytes = reinterpret_cast<const libGAL::gal_ubyte*>(data);
+        _staging.insert(_staging.end(), bytes, bytes + size);
+    }
+
+    /**
+     * Writes the staged block into the buffer and discards the staged data
+     *
+     * @returns The offset of the block in the buffer
+     */
+    libGAL::gal_uint commit();
+
+    /**
+     * Gets the GAL buffer holding the committed blocks
+     */
+    libGAL::GALBuffer* buffer() const { return _buffer; }
+
+    /**
+     * Bytes written to all the streaming buffers
+     */
+    static libGAL::gal_ulonglong bytesStreamed() { return _bytesStreamed; }
+
+    /**
+     * Number of times a streaming buffer was orphaned to restart at the beginning
+     */
+    static libGAL::gal_uint wraps() { return _wraps; }
+
+    /**
+     * Checkpoint support.  The GAL buffer is saved as a reference to the device object
+     */
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
+    /**
+     * Checkpoint support for the counters shared by all the streaming buffers
+     */
+    static void saveCounters(std::ostream& out);
+    static void restoreCounters(std::istream& in);
+
+private:
+
+    libGAL::GALDevice* _galDev;
+    libGAL::GALBuffer* _buffer;
+    libGAL::gal_uint _capacity;
+    libGAL::gal_uint _offset; // First free byte in the buffer
+
+    std::vector<libGAL::gal_ubyte> _staging;
+
+    static libGAL::gal_ulonglong _bytesStreamed;
+    static libGAL::gal_uint _wraps;
+};
+
+} // namespace ogl
+
+#endif // OGL_STREAMINGBUFFER
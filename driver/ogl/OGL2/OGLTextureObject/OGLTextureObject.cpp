@@ -9,6 +9,7 @@
 #include "glext.h"
 #include "GL2GAL.h"
 #include "GL2GALx.h"
+#include "CheckpointStream.h"
 #include <iostream>
 #include <stdio.h>
 
@@ -17,7 +18,7 @@ using namespace libGAL;
 
 GLTextureObject::GLTextureObject(GLuint name, GLenum targetName) : 
                                     BaseObject(name, targetName),
-                                    _galDev(0), _texture2D(0), _textureCM(0), _textureRECT(0),
+                                    _galDev(0), _texture2D(0), _texture3D(0), _textureCM(0), _textureRECT(0),
                                     _wrapS(GL_REPEAT), _wrapT(GL_REPEAT), _wrapR(GL_REPEAT),
                                     _magFilter(GL_LINEAR), _minFilter(GL_NEAREST_MIPMAP_LINEAR), 
                                     _maxAnisotropy(1.0f), _minLOD(-1000), _maxLOD(1000), _biasLOD(0.0f),
@@ -80,6 +81,48 @@ GALTexture* GLTextureObject::getTexture ()
         return 0;
 }
 
+void GLTextureObject::saveState(std::ostream& out, libGAL::GALDevice& device) const
+{
+    checkpoint::saveValue(out, _galDev != 0);
+    checkpoint::saveValue(out, device.objectID(_texture2D));
+    checkpoint::saveValue(out, device.objectID(_texture3D));
+    checkpoint::saveValue(out, device.objectID(_textureRECT));
+    checkpoint::saveValue(out, device.objectID(_textureCM));
+
+    checkpoint::saveValue(out, _wrapS);
+    checkpoint::saveValue(out, _wrapT);
+    checkpoint::saveValue(out, _wrapR);
+    checkpoint::saveValue(out, _magFilter);
+    checkpoint::saveValue(out, _minFilter);
+    checkpoint::saveValue(out, _minLOD);
+    checkpoint::saveValue(out, _maxLOD);
+    checkpoint::saveValue(out, _biasLOD);
+    checkpoint::saveValue(out, _maxAnisotropy);
+    checkpoint::saveValue(out, _baseLevel);
+    checkpoint::saveValue(out, _maxLevel);
+}
+
+void GLTextureObject::restoreState(std::istream& in, libGAL::GALDevice& device)
+{
+    _galDev = checkpoint::loadValue<bool>(in) ? &device : 0;
+    _texture2D = static_cast<GALTexture2D*>(device.resourceByID(checkpoint::loadValue<gal_uint>(in)));
+    _texture3D = static_cast<GALTexture3D*>(device.resourceByID(checkpoint::loadValue<gal_uint>(in)));
+    _textureRECT = static_cast<GALTexture2D*>(device.resourceByID(checkpoint::loadValue<gal_uint>(in)));
+    _textureCM = static_cast<GALTextureCubeMap*>(device.resourceByID(checkpoint::loadValue<gal_uint>(in)));
+
+    checkpoint::loadValue(in, _wrapS);
+    checkpoint::loadValue(in, _wrapT);
+    checkpoint::loadValue(in, _wrapR);
+    checkpoint::loadValue(in, _magFilter);
+    checkpoint::loadValue(in, _minFilter);
+    checkpoint::loadValue(in, _minLOD);
+    checkpoint::loadValue(in, _maxLOD);
+    checkpoint::loadValue(in, _biasLOD);
+    checkpoint::loadValue(in, _maxAnisotropy);
+    checkpoint::loadValue(in, _baseLevel);
+    checkpoint::loadValue(in, _maxLevel);
+}
+
 void GLTextureObject::setContents( GLenum targetFace, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
                                     GLsizei depth, GLint border, GLenum inputFormat, GLenum type,
                                     const GLubyte* data, GLsizei compressedSize)
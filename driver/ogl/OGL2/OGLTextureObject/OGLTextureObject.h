@@ -69,6 +69,10 @@ public:
     GLuint getSize(GLenum openGLType);
     GLenum getGLTextureFormat(libGAL::GAL_FORMAT format);
 
+    // Checkpoint support
+    void saveState(std::ostream& out, libGAL::GALDevice& device) const;
+    void restoreState(std::istream& in, libGAL::GALDevice& device);
+
 
     static void convertDEPTHtoDEPTH24(const GLubyte* input, GLubyte* output,
                                     GLsizei ics, GLsizei ocs,
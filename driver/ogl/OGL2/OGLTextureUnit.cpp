@@ -5,6 +5,7 @@
 #include "OGLTextureUnit.h"
 #include "glext.h"
 #include "support.h"
+#include "CheckpointStream.h"
 #include <sstream>
 #include <cstdio>
 #include <iostream>
@@ -619,3 +620,17 @@ GLenum TextureUnit::getTexMode ()
 {
     return texFunc;
 }
+
+void TextureUnit::saveState(std::ostream& out, const BaseManager& textureManager) const
+{
+    checkpoint::saveValue(out, *this);
+    for ( int i = 0; i < NUM_TEXTURE_TYPES; i++ )
+        textureManager.saveObjectRef(out, textureObject[i]);
+}
+
+void TextureUnit::restoreState(std::istream& in, const BaseManager& textureManager)
+{
+    checkpoint::loadValue(in, *this);
+    for ( int i = 0; i < NUM_TEXTURE_TYPES; i++ )
+        textureObject[i] = static_cast<GLTextureObject*>(textureManager.restoreObjectRef(in));
+}
@@ -6,6 +6,8 @@
     #define OGL_TEXTUREUNIT_H
 
 #include "OGLTextureObject.h"
+#include "OGLBaseManager.h"
+#include <iosfwd>
 
 
 namespace ogl
@@ -145,6 +147,13 @@ public:
     
     
     GLfloat getLodBias() const { return lodBias; }
+
+    /**
+     * Checkpoint support.  The texture objects are saved as references to the objects
+     * of the texture manager, restored before the texture units
+     */
+    void saveState(std::ostream& out, const BaseManager& textureManager) const;
+    void restoreState(std::istream& in, const BaseManager& textureManager);
     
 };
 
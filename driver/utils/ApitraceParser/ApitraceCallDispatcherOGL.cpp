@@ -8,6 +8,7 @@
 #include "OGLEntryPoints.h"
 #include "../../ogl/OGLShaders/OGLShaderEntryPoints.h"
 #include "OGL.h"
+#include "CheckpointStream.h"
 #include <iostream>
 #include <vector>
 #include <map>
@@ -304,3 +305,29 @@ bool executeCall(const CallEvent& evt) {
 }
 
 #undef A
+
+void apitrace::saveDispatcherState(std::ostream& out) {
+    checkpoint::saveValue(out, isRecording);
+    checkpoint::saveValue(out, currentListId);
+    checkpoint::saveValue(out, static_cast<uint32_t>(displayLists.size()));
+    for (const auto& list : displayLists) {
+        checkpoint::saveValue(out, list.first);
+        checkpoint::saveValue(out, static_cast<uint32_t>(list.second.size()));
+        for (const CallEvent& evt : list.second)
+            ApitraceParser::saveEvent(out, evt);
+    }
+}
+
+void apitrace::restoreDispatcherState(std::istream& in) {
+    checkpoint::loadValue(in, isRecording);
+    checkpoint::loadValue(in, currentListId);
+    displayLists.clear();
+    uint32_t lists = checkpoint::loadValue<uint32_t>(in);
+    for (uint32_t i = 0; i < lists; ++i) {
+        GLuint listId = checkpoint::loadValue<GLuint>(in);
+        std::vector<CallEvent>& calls = displayLists[listId];
+        calls.resize(checkpoint::loadValue<uint32_t>(in));
+        for (CallEvent& evt : calls)
+            ApitraceParser::loadEvent(in, evt);
+    }
+}
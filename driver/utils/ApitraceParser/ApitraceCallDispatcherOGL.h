@@ -14,6 +14,7 @@
 #include "glAll.h"
 #include <map>
 #include <functional>
+#include <iosfwd>
 
 namespace apitrace {
 
@@ -79,6 +80,13 @@ inline const Value& arg(const CallEvent& evt, uint32_t idx) {
  */
 bool dispatchCall(const CallEvent& evt);
 
+/**
+ * Write/read the display lists recorded by the dispatcher (and the list being recorded)
+ * to/from a simulation checkpoint.
+ */
+void saveDispatcherState(std::ostream& out);
+void restoreDispatcherState(std::istream& in);
+
 }  // namespace apitrace
 
 #endif // APITRACECALLDISPATCHEROGL_H
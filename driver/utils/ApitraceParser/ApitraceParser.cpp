@@ -6,6 +6,7 @@
 
 #include "ApitraceParser.h"
 #include "support.h"
+#include "CheckpointStream.h"
 #include <snappy.h>
 #include <cstring>
 #include <iostream>
@@ -15,7 +16,7 @@ using namespace apitrace;
 
 // ============ SnappyStream Implementation ============
 
-SnappyStream::SnappyStream() : bufferPos_(0) {}
+SnappyStream::SnappyStream() : bufferPos_(0), chunkOffset_(0) {}
 
 SnappyStream::~SnappyStream() {
     close();
@@ -35,6 +36,7 @@ bool SnappyStream::open(const char* filename) {
     
     decompressed_.reserve(1024 * 1024); // 1MB buffer
     bufferPos_ = 0;
+    chunkOffset_ = 2;
     return true;
 }
 
@@ -51,6 +53,7 @@ bool SnappyStream::fillBuffer() {
     if (file_.eof()) return false;
     
     // Read chunk: compressed_length (uint32 LE) + compressed_data
+    chunkOffset_ = static_cast<uint64_t>(file_.tellg());
     uint32_t compressedLen;
     file_.read(reinterpret_cast<char*>(&compressedLen), 4);
     if (!file_ || compressedLen == 0 || compressedLen > 100*1024*1024) 
@@ -97,6 +100,34 @@ bool SnappyStream::read(void* buffer, size_t count) {
     return true;
 }
 
+void SnappyStream::savePosition(std::ostream& out) const {
+    checkpoint::saveValue(out, chunkOffset_);
+    checkpoint::saveValue(out, static_cast<uint64_t>(bufferPos_));
+    checkpoint::saveValue(out, !decompressed_.empty());
+}
+
+bool SnappyStream::restorePosition(std::istream& in) {
+    uint64_t offset = checkpoint::loadValue<uint64_t>(in);
+    uint64_t pos = checkpoint::loadValue<uint64_t>(in);
+    bool chunk = checkpoint::loadValue<bool>(in);
+
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(offset));
+    if (!file_) return false;
+
+    decompressed_.clear();
+    bufferPos_ = 0;
+    chunkOffset_ = offset;
+
+    // Decompress again the chunk being read
+    if (chunk) {
+        if (!fillBuffer() || pos > decompressed_.size()) return false;
+        bufferPos_ = static_cast<size_t>(pos);
+    }
+
+    return true;
+}
+
 // ============ ApitraceParser Implementation ============
 
 ApitraceParser::ApitraceParser() 
@@ -610,3 +641,201 @@ std::string ApitraceParser::detectApiType() {
     
     return detectedApiType_;
 }
+
+// ============ Checkpoint support ============
+
+static void saveTraceValue(std::ostream& out, const Value& val) {
+    checkpoint::saveValue(out, static_cast<uint8_t>(val.type));
+    checkpoint::saveValue(out, val.uintVal);
+    checkpoint::saveString(out, val.strVal);
+    checkpoint::saveVector(out, val.blobVal);
+    checkpoint::saveValue(out, static_cast<uint32_t>(val.arrayVal.size()));
+    for (const Value& element : val.arrayVal)
+        saveTraceValue(out, element);
+}
+
+static void loadTraceValue(std::istream& in, Value& val) {
+    val.type = static_cast<ValueType>(checkpoint::loadValue<uint8_t>(in));
+    checkpoint::loadValue(in, val.uintVal);
+    val.strVal = checkpoint::loadString(in);
+    checkpoint::loadVector(in, val.blobVal);
+    val.arrayVal.resize(checkpoint::loadValue<uint32_t>(in));
+    for (Value& element : val.arrayVal)
+        loadTraceValue(in, element);
+}
+
+static void saveStrings(std::ostream& out, const std::vector<std::string>& strings) {
+    checkpoint::saveValue(out, static_cast<uint32_t>(strings.size()));
+    for (const std::string& s : strings)
+        checkpoint::saveString(out, s);
+}
+
+static void loadStrings(std::istream& in, std::vector<std::string>& strings) {
+    strings.resize(checkpoint::loadValue<uint32_t>(in));
+    for (std::string& s : strings)
+        s = checkpoint::loadString(in);
+}
+
+static void saveSignature(std::ostream& out, const CallSignature& sig) {
+    checkpoint::saveValue(out, sig.id);
+    checkpoint::saveString(out, sig.functionName);
+    saveStrings(out, sig.argNames);
+}
+
+static void loadSignature(std::istream& in, CallSignature& sig) {
+    checkpoint::loadValue(in, sig.id);
+    sig.functionName = checkpoint::loadString(in);
+    loadStrings(in, sig.argNames);
+}
+
+void ApitraceParser::saveEvent(std::ostream& out, const CallEvent& event) {
+    checkpoint::saveValue(out, event.callNo);
+    checkpoint::saveValue(out, event.threadNo);
+    saveSignature(out, event.signature);
+    checkpoint::saveValue(out, static_cast<uint32_t>(event.arguments.size()));
+    for (const auto& arg : event.arguments) {
+        checkpoint::saveValue(out, arg.first);
+        saveTraceValue(out, arg.second);
+    }
+    saveTraceValue(out, event.returnValue);
+    checkpoint::saveValue(out, event.hasReturn);
+}
+
+void ApitraceParser::loadEvent(std::istream& in, CallEvent& event) {
+    checkpoint::loadValue(in, event.callNo);
+    checkpoint::loadValue(in, event.threadNo);
+    loadSignature(in, event.signature);
+    event.arguments.clear();
+    uint32_t args = checkpoint::loadValue<uint32_t>(in);
+    for (uint32_t i = 0; i < args; ++i) {
+        uint32_t argNo = checkpoint::loadValue<uint32_t>(in);
+        loadTraceValue(in, event.arguments[argNo]);
+    }
+    loadTraceValue(in, event.returnValue);
+    checkpoint::loadValue(in, event.hasReturn);
+}
+
+void ApitraceParser::savePosition(std::ostream& out) const {
+    stream_->savePosition(out);
+
+    checkpoint::saveValue(out, version_);
+    checkpoint::saveValue(out, nextCallNo_);
+
+    checkpoint::saveValue(out, static_cast<uint32_t>(signatureCache_.size()));
+    for (const auto& sig : signatureCache_)
+        saveSignature(out, sig.second);
+
+    checkpoint::saveValue(out, static_cast<uint32_t>(enumSignatureCache_.size()));
+    for (const auto& sig : enumSignatureCache_) {
+        checkpoint::saveValue(out, sig.second.id);
+        checkpoint::saveString(out, sig.second.name);
+        checkpoint::saveValue(out, static_cast<uint32_t>(sig.second.values.size()));
+        for (const auto& value : sig.second.values) {
+            checkpoint::saveString(out, value.first);
+            checkpoint::saveValue(out, value.second);
+        }
+    }
+
+    checkpoint::saveValue(out, static_cast<uint32_t>(bitmaskSignatureCache_.size()));
+    for (const auto& sig : bitmaskSignatureCache_) {
+        checkpoint::saveValue(out, sig.second.id);
+        checkpoint::saveValue(out, static_cast<uint32_t>(sig.second.flags.size()));
+        for (const auto& flag : sig.second.flags) {
+            checkpoint::saveString(out, flag.first);
+            checkpoint::saveValue(out, flag.second);
+        }
+    }
+
+    checkpoint::saveValue(out, static_cast<uint32_t>(structSignatureCache_.size()));
+    for (const auto& sig : structSignatureCache_) {
+        checkpoint::saveValue(out, sig.second.id);
+        checkpoint::saveString(out, sig.second.name);
+        saveStrings(out, sig.second.memberNames);
+    }
+
+    // Calls waiting for their LEAVE event, bottom of the stack first
+    std::stack<CallEvent> pending = pendingEnterStack_;
+    std::vector<CallEvent> stored;
+    stored.reserve(pending.size());
+    for (; !pending.empty(); pending.pop())
+        stored.push_back(pending.top());
+    checkpoint::saveValue(out, static_cast<uint32_t>(stored.size()));
+    for (size_t i = stored.size(); i > 0; --i)
+        saveEvent(out, stored[i - 1]);
+
+    checkpoint::saveString(out, detectedApiType_);
+    checkpoint::saveValue(out, apiTypeDetected_);
+    checkpoint::saveValue(out, hasFirstEvent_);
+    if (hasFirstEvent_)
+        saveEvent(out, firstEvent_);
+}
+
+bool ApitraceParser::restorePosition(std::istream& in) {
+    if (!stream_ || !stream_->restorePosition(in))
+        return false;
+
+    if (checkpoint::loadValue<uint32_t>(in) != version_)
+        return false;
+    checkpoint::loadValue(in, nextCallNo_);
+
+    signatureCache_.clear();
+    uint32_t count = checkpoint::loadValue<uint32_t>(in);
+    for (uint32_t i = 0; i < count; ++i) {
+        CallSignature sig;
+        loadSignature(in, sig);
+        signatureCache_[sig.id] = sig;
+    }
+
+    enumSignatureCache_.clear();
+    count = checkpoint::loadValue<uint32_t>(in);
+    for (uint32_t i = 0; i < count; ++i) {
+        EnumSignature sig;
+        checkpoint::loadValue(in, sig.id);
+        sig.name = checkpoint::loadString(in);
+        sig.values.resize(checkpoint::loadValue<uint32_t>(in));
+        for (auto& value : sig.values) {
+            value.first = checkpoint::loadString(in);
+            checkpoint::loadValue(in, value.second);
+        }
+        enumSignatureCache_[sig.id] = sig;
+    }
+
+    bitmaskSignatureCache_.clear();
+    count = checkpoint::loadValue<uint32_t>(in);
+    for (uint32_t i = 0; i < count; ++i) {
+        BitmaskSignature sig;
+        checkpoint::loadValue(in, sig.id);
+        sig.flags.resize(checkpoint::loadValue<uint32_t>(in));
+        for (auto& flag : sig.flags) {
+            flag.first = checkpoint::loadString(in);
+            checkpoint::loadValue(in, flag.second);
+        }
+        bitmaskSignatureCache_[sig.id] = sig;
+    }
+
+    structSignatureCache_.clear();
+    count = checkpoint::loadValue<uint32_t>(in);
+    for (uint32_t i = 0; i < count; ++i) {
+        StructSignature sig;
+        checkpoint::loadValue(in, sig.id);
+        sig.name = checkpoint::loadString(in);
+        loadStrings(in, sig.memberNames);
+        structSignatureCache_[sig.id] = sig;
+    }
+
+    pendingEnterStack_ = std::stack<CallEvent>();
+    count = checkpoint::loadValue<uint32_t>(in);
+    for (uint32_t i = 0; i < count; ++i) {
+        CallEvent evt;
+        loadEvent(in, evt);
+        pendingEnterStack_.push(evt);
+    }
+
+    detectedApiType_ = checkpoint::loadString(in);
+    checkpoint::loadValue(in, apiTypeDetected_);
+    checkpoint::loadValue(in, hasFirstEvent_);
+    if (hasFirstEvent_)
+        loadEvent(in, firstEvent_);
+
+    return !in.fail();
+}
@@ -14,6 +14,7 @@
 #include <map>
 #include <stack>
 #include <fstream>
+#include <iosfwd>
 #include <cstdint>
 
 namespace apitrace {
@@ -113,6 +114,22 @@ public:
      */
     std::string detectApiType();
 
+    /**
+     * Writes the parser position (trace file offset of the current chunk and the offset
+     * inside it) and the parser state needed to continue from it (signatures already read,
+     * call number and calls still waiting for their LEAVE event) to a simulation checkpoint.
+     */
+    void savePosition(std::ostream& out) const;
+
+    /**
+     * Moves the parser, opened on the same trace, to the position written by savePosition().
+     */
+    bool restorePosition(std::istream& in);
+
+    //! Write/read a call event to/from a checkpoint
+    static void saveEvent(std::ostream& out, const CallEvent& event);
+    static void loadEvent(std::istream& in, CallEvent& event);
+
 private:
     bool readVarUInt(uint64_t& value);
     bool readByte(uint8_t& value);
@@ -155,11 +172,14 @@ public:
     void close();
     bool read(void* buffer, size_t count);
     bool eof() const;
+    void savePosition(std::ostream& out) const;
+    bool restorePosition(std::istream& in);
 private:
     bool fillBuffer();
     std::ifstream file_;
     std::vector<uint8_t> decompressed_;
     size_t bufferPos_;
+    uint64_t chunkOffset_;  // File offset of the decompressed chunk
 };
 
 }  // namespace apitrace
@@ -0,0 +1,331 @@
+/**************************************************************************
+ *
+ * traceConverter implementation file
+ *
+ */
+
+
+/**
+ *
+ *  @file traceConverter.cpp
+ *
+ *  This file contains the tool that converts MetaStream trace files between the gzip
+ *  format and the block file format (see MetaStreamBlockFile.h).
+ *
+ */
+
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include "MetaStreamTrace.h"
+#include "MetaStreamBlockFile.h"
+#include "DynamicMemoryOpt.h"
+#include "zfstream.h"
+
+using namespace std;
+using namespace arch;
+
+//  Converts a gzip MetaStream trace file into a block file.
+static U32 convertToBlocks(const string &inputTracename, const string &outputTracename, U32 blockSize,
+                           MetaStreamBlockCodec codec)
+{
+    gzifstream inputTrace(inputTracename.c_str(), ios::in | ios::binary);
+
+    if (!inputTrace.is_open())
+    {
+        cout << "Error: Could not open input tracefile \'" << inputTracename << "\'" << endl;
+        exit(-1);
+    }
+
+    MetaStreamHeader metaTraceHeader;
+    inputTrace.read((char *) &metaTraceHeader, sizeof(metaTraceHeader));
+
+    if (string(metaTraceHeader.signature).compare(MetaStreamTRACEFILE_SIGNATURE) != 0)
+    {
+        cout << "Error: Input file isn't an CG1 MetaStream trace file" << endl;
+        exit(-1);
+    }
+
+    cgoMetaStreamBlockWriter outputTrace;
+
+    if (!outputTrace.open(outputTracename.c_str(), &metaTraceHeader, sizeof(metaTraceHeader), blockSize, codec))
+    {
+        cout << "Error: Could not create output block file \'" << outputTracename << "\'" << endl;
+        exit(-1);
+    }
+
+    U32 metaStreams = 0;
+
+    while(true)
+    {
+        cgoMetaStream *metaStream = new cgoMetaStream(&inputTrace);
+
+        //  The MetaStream read at the end of file is not valid.
+        if (inputTrace.eof())
+        {
+            delete metaStream;
+            break;
+        }
+
+        outputTrace.write(metaStream);
+        delete metaStream;
+        metaStreams++;
+    }
+
+    if (!outputTrace.close())
+    {
+        cout << "Error: Could not write output block file \'" << outputTracename << "\'" << endl;
+        exit(-1);
+    }
+
+    cout << "Converted " << metaStreams << " MetaStreams into " << outputTrace.getBlockCount() << " blocks." << endl;
+
+    return metaStreams;
+}
+
+//  Converts a MetaStream block file into a gzip trace file.
+static U32 convertToGzip(const string &inputTracename, const string &outputTracename)
+{
+    cgoMetaStreamBlockReader inputTrace;
+
+    if (!inputTrace.open(inputTracename.c_str()))
+    {
+        cout << "Error: Could not open input block file \'" << inputTracename << "\'" << endl;
+        exit(-1);
+    }
+
+    gzofstream outputTrace(outputTracename.c_str(), ios::out | ios::binary);
+
+    if (!outputTrace.is_open())
+    {
+        cout << "Error: Could not create output tracefile \'" << outputTracename << "\'" << endl;
+        exit(-1);
+    }
+
+    const vector<U08> &traceHeader = inputTrace.getTraceHeader();
+    if (!traceHeader.empty())
+        outputTrace.write((const char *) &traceHeader[0], traceHeader.size());
+
+    U32 metaStreams = 0;
+
+    cgoMetaStream *metaStream;
+    while((metaStream = inputTrace.next()) != NULL)
+    {
+        metaStream->save(&outputTrace);
+        delete metaStream;
+        metaStreams++;
+    }
+
+    outputTrace.close();
+
+    cout << "Converted " << metaStreams << " MetaStreams from " << inputTrace.getIndex().size() << " blocks." << endl;
+
+    return metaStreams;
+}
+
+//  Compares the attributes of two MetaStreams stored in a gzip trace file (see cgoMetaStream::save).
+static bool sameMetaStream(cgoMetaStream *a, cgoMetaStream *b)
+{
+    if (a->GetMetaStreamType() != b->GetMetaStreamType())
+        return false;
+
+    switch(a->GetMetaStreamType())
+    {
+        case META_STREAM_WRITE:
+        case META_STREAM_PRELOAD:
+
+            return (a->getAddress() == b->getAddress()) && (a->getMD() == b->getMD()) &&
+                   (a->getLocked() == b->getLocked()) && (a->getSize() == b->getSize()) &&
+                   (memcmp(a->getData(), b->getData(), a->getSize()) == 0);
+
+        case META_STREAM_REG_WRITE:
+        {
+            GPURegData aData = a->getGPURegData();
+            GPURegData bData = b->getGPURegData();
+
+            return (a->getGPURegister() == b->getGPURegister()) && (a->getGPUSubRegister() == b->getGPUSubRegister()) &&
+                   (memcmp(&aData, &bData, sizeof(GPURegData)) == 0) && (a->getMD() == b->getMD());
+        }
+
+        case META_STREAM_COMMAND:
+
+            return (a->getGPUCommand() == b->getGPUCommand());
+
+        case META_STREAM_EVENT:
+
+            return (a->getGPUEvent() == b->getGPUEvent()) && (a->getGPUEventMsg() == b->getGPUEventMsg());
+
+        default:
+
+            return false;
+    }
+}
+
+//  Compares the MetaStreams of a gzip trace file and a block file.
+static bool verify(const string &gzipTracename, const string &blockTracename)
+{
+    gzifstream gzipTrace(gzipTracename.c_str(), ios::in | ios::binary);
+    cgoMetaStreamBlockReader blockTrace;
+
+    if (!gzipTrace.is_open() || !blockTrace.open(blockTracename.c_str()))
+    {
+        cout << "Error: Could not open the tracefiles to verify" << endl;
+        return false;
+    }
+
+    MetaStreamHeader metaTraceHeader;
+    gzipTrace.read((char *) &metaTraceHeader, sizeof(metaTraceHeader));
+
+    if ((blockTrace.getTraceHeader().size() != sizeof(metaTraceHeader)) ||
+        (memcmp(&blockTrace.getTraceHeader()[0], &metaTraceHeader, sizeof(metaTraceHeader)) != 0))
+    {
+        cout << "Verify: trace header mismatch" << endl;
+        return false;
+    }
+
+    for(U32 metaStreams = 0; ; metaStreams++)
+    {
+        cgoMetaStream *gzipMetaStream = new cgoMetaStream(&gzipTrace);
+        cgoMetaStream *blockMetaStream = blockTrace.next();
+
+        if (gzipTrace.eof())
+        {
+            delete gzipMetaStream;
+            gzipMetaStream = NULL;
+        }
+
+        bool match;
+
+        if ((gzipMetaStream == NULL) || (blockMetaStream == NULL))
+            match = (gzipMetaStream == blockMetaStream);
+        else
+            match = sameMetaStream(gzipMetaStream, blockMetaStream);
+
+        bool end = (gzipMetaStream == NULL) || (blockMetaStream == NULL);
+
+        delete gzipMetaStream;
+        delete blockMetaStream;
+
+        if (!match)
+        {
+            cout << "Verify: MetaStream " << metaStreams << " mismatch" << endl;
+            return false;
+        }
+
+        if (end)
+        {
+            cout << "Verify: " << metaStreams << " MetaStreams match." << endl;
+            return true;
+        }
+    }
+}
+
+//  Prints the block index of a block file.
+static void printInfo(const string &inputTracename)
+{
+    cgoMetaStreamBlockReader inputTrace;
+
+    if (!inputTrace.open(inputTracename.c_str()))
+    {
+        cout << "Error: Could not open input block file \'" << inputTracename << "\'" << endl;
+        exit(-1);
+    }
+
+    const vector<cgsMetaStreamBlockEntry> &index = inputTrace.getIndex();
+
+    U64 storedBytes = 0;
+    U64 bytes = 0;
+
+    cout << "Block,Offset,StoredBytes,Bytes,FirstMetaStream,MetaStreams,FirstFrame,FirstBatch" << endl;
+
+    for(size_t b = 0; b < index.size(); b++)
+    {
+        cout << b << "," << index[b].offset << "," << index[b].storedBytes << "," << index[b].bytes << ","
+             << index[b].firstMetaStream << "," << index[b].metaStreams << "," << index[b].firstFrame << ","
+             << index[b].firstBatch << endl;
+
+        storedBytes += index[b].storedBytes;
+        bytes += index[b].bytes;
+    }
+
+    cout << "Blocks : " << index.size() << " | Codec : "
+         << ((inputTrace.getCodec() == META_STREAM_BLOCK_DEFLATE) ? "deflate" : "stored")
+         << " | Stored bytes : " << storedBytes << " | Bytes : " << bytes << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    string inputTracename;
+    string outputTracename;
+    U32 blockSize = META_STREAM_BLOCK_SIZE;
+    MetaStreamBlockCodec codec = META_STREAM_BLOCK_DEFLATE;
+    bool verifyOutput = false;
+    bool info = false;
+
+    //  Get the options and the input and output file names.
+    for(int a = 1; a < argc; a++)
+    {
+        string arg = argv[a];
+
+        if ((arg == "--block-size") && (a + 1 < argc))
+        {
+            stringstream converterStream(argv[++a]);
+            converterStream >> blockSize;
+        }
+        else if (arg == "--stored")
+            codec = META_STREAM_BLOCK_STORED;
+        else if (arg == "--verify")
+            verifyOutput = true;
+        else if (arg == "--info")
+            info = true;
+        else if (inputTracename.empty())
+            inputTracename = arg;
+        else
+            outputTracename = arg;
+    }
+
+    //  Check parameters.
+    if (inputTracename.empty() || (outputTracename.empty() && !info) || (blockSize == 0))
+    {
+        cout << "Usage: " << endl << endl;
+        cout << "traceConverter [--block-size <bytes>] [--stored] [--verify] <input filename> <output filename>" << endl;
+        cout << "traceConverter --info <block filename>" << endl << endl;
+        cout << "Converts a gzip MetaStream trace file into a block file (" << META_STREAM_BLOCK_EXTENSION << ") and a" << endl;
+        cout << "block file into a gzip MetaStream trace file." << endl;
+        exit(-1);
+    }
+
+    //  Initialize the optimized dynamic memory system.
+    DynamicMemoryOpt::initialize(256, 1024, 512, 1024, 1024, 1024);
+
+    if (info)
+    {
+        printInfo(inputTracename);
+        return 0;
+    }
+
+    cout << "Input MetaStream Tracefile : " << inputTracename << endl;
+    cout << "Output MetaStream Tracefile : " << outputTracename << endl;
+
+    bool ok = true;
+
+    if (cgoMetaStreamBlockReader::isBlockFile(inputTracename.c_str()))
+    {
+        convertToGzip(inputTracename, outputTracename);
+
+        if (verifyOutput)
+            ok = verify(outputTracename, inputTracename);
+    }
+    else
+    {
+        convertToBlocks(inputTracename, outputTracename, blockSize, codec);
+
+        if (verifyOutput)
+            ok = verify(inputTracename, outputTracename);
+    }
+
+    return ok ? 0 : -1;
+}
@@ -8,6 +8,8 @@
 
 #include "RegisterWriteBufferMeta.h"
 #include <iostream>
+#include <istream>
+#include <ostream>
 
 using namespace std;
 using namespace arch;
@@ -109,3 +111,38 @@ bool RegisterWriteBufferMeta::flushNextRegister(arch::GPURegister &reg, U32 &ind
     }
 }
 
+void RegisterWriteBufferMeta::saveState(ostream& out) const
+{
+    U32 entries = U32(writeBuffer.size());
+    out.write((char *) &entries, sizeof(entries));
+
+    for ( WriteBufferConstIt it = writeBuffer.begin(); it != writeBuffer.end(); it++ )
+    {
+        out.write((char *) &it->first.reg, sizeof(it->first.reg));
+        out.write((char *) &it->first.index, sizeof(it->first.index));
+        out.write((char *) &it->second.data, sizeof(it->second.data));
+        out.write((char *) &it->second.md, sizeof(it->second.md));
+    }
+}
+
+void RegisterWriteBufferMeta::restoreState(istream& in)
+{
+    U32 entries = 0;
+    in.read((char *) &entries, sizeof(entries));
+
+    writeBuffer.clear();
+    for ( U32 e = 0; e < entries; e++ )
+    {
+        GPURegister reg;
+        U32 index;
+        GPURegData data;
+        U32 md;
+        in.read((char *) &reg, sizeof(reg));
+        in.read((char *) &index, sizeof(index));
+        in.read((char *) &data, sizeof(data));
+        in.read((char *) &md, sizeof(md));
+        writeBuffer.insert(make_pair(RegisterIdentifier(reg, index), RegisterData(data, md)));
+    }
+
+    registerWritesCount = entries;
+}
@@ -10,6 +10,7 @@
     #define _REGISTERWRITEBUFFERMETA_STREAM_
 
 #include <map>
+#include <iosfwd>
 #include "GPUReg.h"
 
 class RegisterWriteBufferMeta
@@ -24,6 +25,10 @@ public:
     
     bool flushNextRegister(arch::GPURegister &reg, U32 &index, arch::GPURegData &data, U32 &md);
 
+    //  Write/read the buffered register writes to/from a simulation checkpoint.
+    void saveState(std::ostream& out) const;
+    void restoreState(std::istream& in);
+
 private:
 
     U32 registerWritesCount; // Statistic
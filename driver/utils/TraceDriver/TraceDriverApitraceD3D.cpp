@@ -19,7 +19,7 @@ using namespace arch;
 
 TraceDriverApitraceD3D::TraceDriverApitraceD3D(const char* traceFile, HAL* driver, U32 startFrame, U32 maxFrames)
     : driver_(driver), startFrame_(startFrame), currentFrame_(0),
-      initialized_(false)
+      initialized_(false), lastCallNo_(0), metaStreams_(0), checkpoint_(nullptr)
 {
     traceTyp = TraceTypD3d;
     maxFrames_ = maxFrames;
@@ -58,6 +58,7 @@ TraceDriverApitraceD3D::TraceDriverApitraceD3D(const char* traceFile, HAL* drive
 }
 
 TraceDriverApitraceD3D::~TraceDriverApitraceD3D() {
+    delete checkpoint_;
     parser_.close();
     D3D9::finalize();
 }
@@ -74,6 +75,24 @@ int TraceDriverApitraceD3D::startTrace() {
 }
 
 cgoMetaStream* TraceDriverApitraceD3D::nxtMetaStream() {
+    // Restore the GPU state of a checkpoint before the MetaStreams that follow it
+    if (checkpoint_ != nullptr) {
+        cgoMetaStream* restore = checkpoint_->nextMetaStream();
+        if (restore != nullptr)
+            return restore;
+
+        delete checkpoint_;
+        checkpoint_ = nullptr;
+    }
+
+    cgoMetaStream* metaStream = generateMetaStream();
+    if (metaStream != nullptr)
+        metaStreams_++;
+
+    return metaStream;
+}
+
+cgoMetaStream* TraceDriverApitraceD3D::generateMetaStream() {
     if (!initialized_ || parser_.eof())
         return nullptr;
     
@@ -110,6 +129,7 @@ cgoMetaStream* TraceDriverApitraceD3D::nxtMetaStream() {
                       << " " << fn << std::endl;
         }
         TRACING_EXIT_REGION();
+        lastCallNo_ = evt.callNo;
         
         // Handle frame boundary (Present)
         if (apitrace::d3d9::isFrameBoundary(fn)) {
@@ -138,3 +158,39 @@ cgoMetaStream* TraceDriverApitraceD3D::nxtMetaStream() {
     
     return metaStream;
 }
+
+TraceDriverCheckpoint::Position TraceDriverApitraceD3D::checkpointPosition() const {
+    TraceDriverCheckpoint::Position pos;
+    pos.frame = currentFrame_;
+    pos.callNo = lastCallNo_;
+    pos.metaStreams = metaStreams_;
+    return pos;
+}
+
+bool TraceDriverApitraceD3D::saveCheckpoint(std::fstream* f) {
+    // Frames before the start frame are dispatched in preload mode
+    if (startFrame_ > 0)
+        return false;
+
+    TraceDriverCheckpoint::save(f, traceTyp, checkpointPosition(), driver_);
+    return true;
+}
+
+bool TraceDriverApitraceD3D::loadCheckpoint(std::fstream* f) {
+    CG_ASSERT_COND((startFrame_ == 0), "Checkpoints require the trace to start at frame 0.");
+    CG_ASSERT_COND((metaStreams_ == 0) && (checkpoint_ == nullptr), "Checkpoint loaded after the start of the trace.");
+
+    checkpoint_ = new TraceDriverCheckpoint;
+    const TraceDriverCheckpoint::Position& target = checkpoint_->load(f, traceTyp, true);
+
+    // Build the D3D9, GAL and HAL state up to the checkpoint without simulating
+    cgoMetaStream* metaStream;
+    while ((metaStreams_ < target.metaStreams) && ((metaStream = generateMetaStream()) != nullptr)) {
+        metaStreams_++;
+        checkpoint_->skip(metaStream);
+    }
+
+    checkpoint_->check(checkpointPosition(), driver_);
+
+    return true;
+}
@@ -12,6 +12,7 @@
 #include "GPUType.h"
 #include "MetaStream.h"
 #include "TraceDriverBase.h"
+#include "TraceDriverCheckpoint.h"
 #include "ApitraceParser.h"
 #include "ApitraceCallDispatcherD3D.h"
 #include "HAL.h"
@@ -33,15 +34,33 @@ public:
     arch::cgoMetaStream* nxtMetaStream() override;
     U32 getTracePosition() override { return currentFrame_; }
 
+    /**
+     * Saves a replay checkpoint (see TraceDriverCheckpoint): trace position and HAL
+     * allocation state.  The D3D9 library objects are not serialized.
+     */
+    bool saveCheckpoint(std::fstream* f) override;
+
+    /**
+     * Dispatches the D3D9 calls up to a checkpoint without simulating them.  Only
+     * supported when the trace is started from frame 0.
+     */
+    bool loadCheckpoint(std::fstream* f) override;
+
 private:
     apitrace::ApitraceParser parser_;
     HAL* driver_;
     U32 startFrame_;
     U32 currentFrame_;
     bool initialized_;
+    U32 lastCallNo_;                        //!< Call number of the last D3D9 call dispatched
+    U32 metaStreams_;                       //!< MetaStreams generated from the trace
+    TraceDriverCheckpoint* checkpoint_;     //!< GPU state to restore after loading a checkpoint
     
     //! D3D9 dispatcher state (object tracker, root, device)
     apitrace::d3d9::D3D9DispatcherState dispState_;
+
+    arch::cgoMetaStream* generateMetaStream();
+    TraceDriverCheckpoint::Position checkpointPosition() const;
 };
 
 #endif // TRACEDRIVERAPITRACED3D_H
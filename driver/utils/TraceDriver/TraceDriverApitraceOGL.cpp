@@ -9,6 +9,7 @@
 #include "OGL.h"
 #include "OGLEntryPoints.h"
 #include "Profiler.h"
+#include "CheckpointStream.h"
 
 using namespace arch;
 #include "support.h"
@@ -16,8 +17,9 @@ using namespace arch;
 
 TraceDriverApitraceOGL::TraceDriverApitraceOGL(const char* traceFile, HAL* driver, U32 startFrame, U32 maxFrames)
     : driver_(driver), startFrame_(startFrame), currentFrame_(0), 
-      initialized_(false)
+      initialized_(false), lastCallNo_(0), metaStreams_(0), checkpoint_(nullptr)
 {
+    traceTyp = TraceTypOgl;
     maxFrames_ = maxFrames;
     if (!parser_.open(traceFile)) {
         std::cerr << "ERROR: Failed to open apitrace file: " << traceFile << std::endl;
@@ -44,6 +46,7 @@ TraceDriverApitraceOGL::TraceDriverApitraceOGL(const char* traceFile, HAL* drive
 }
 
 TraceDriverApitraceOGL::~TraceDriverApitraceOGL() {
+    delete checkpoint_;
     parser_.close();
 }
 
@@ -52,6 +55,26 @@ int TraceDriverApitraceOGL::startTrace() {
 }
 
 arch::cgoMetaStream* TraceDriverApitraceOGL::nxtMetaStream() {
+    // Restore the GPU state of a checkpoint before the MetaStreams that follow it
+    if (checkpoint_ != nullptr) {
+        arch::cgoMetaStream* restore = checkpoint_->nextMetaStream();
+        if (restore != nullptr)
+            return restore;
+
+        delete checkpoint_;
+        checkpoint_ = nullptr;
+    }
+
+    arch::cgoMetaStream* agpt = generateMetaStream();
+    if (agpt != nullptr) {
+        metaStreams_++;
+        tracker_.record(agpt);
+    }
+
+    return agpt;
+}
+
+arch::cgoMetaStream* TraceDriverApitraceOGL::generateMetaStream() {
     if (!initialized_ || parser_.eof()) 
         return nullptr;
     
@@ -78,6 +101,7 @@ arch::cgoMetaStream* TraceDriverApitraceOGL::nxtMetaStream() {
         TRACING_ENTER_REGION((char*)fn.c_str(), (char*)"OpenGL", (char*)"");
         apitrace::dispatchCall(evt);
         TRACING_EXIT_REGION();
+        lastCallNo_ = evt.callNo;
         
         // Handle SwapBuffers (frame boundary)
         if (fn.find("SwapBuffers") != std::string::npos) {
@@ -87,6 +111,7 @@ arch::cgoMetaStream* TraceDriverApitraceOGL::nxtMetaStream() {
             }
             currentFrame_++;
             driver_->printMemoryUsage();
+            ogl::printStreamingUsage();
             
             // Check if we've reached the frame limit
             if (maxFrames_ > 0 && currentFrame_ >= (startFrame_ + maxFrames_)) {
@@ -100,3 +125,66 @@ arch::cgoMetaStream* TraceDriverApitraceOGL::nxtMetaStream() {
     return agpt;
 }
 
+TraceDriverCheckpoint::Position TraceDriverApitraceOGL::checkpointPosition() const {
+    TraceDriverCheckpoint::Position pos;
+    pos.frame = currentFrame_;
+    pos.callNo = lastCallNo_;
+    pos.metaStreams = metaStreams_;
+    return pos;
+}
+
+// Tags of the sections written by the trace driver after the checkpoint header
+static const U32 CHECKPOINT_TAG_TRACE = 0x54524345;   // 'TRCE'
+static const U32 CHECKPOINT_TAG_OGL = 0x4F474C32;     // 'OGL2'
+static const U32 CHECKPOINT_TAG_HAL = 0x48414C30;     // 'HAL0'
+
+bool TraceDriverApitraceOGL::saveCheckpoint(std::fstream* f) {
+    // Frames skipped by the constructor were not dispatched
+    if (startFrame_ > 0 || checkpoint_ != nullptr)
+        return false;
+
+    tracker_.saveState(f, traceTyp, checkpointPosition());
+
+    checkpoint::saveTag(*f, CHECKPOINT_TAG_TRACE);
+    parser_.savePosition(*f);
+    apitrace::saveDispatcherState(*f);
+
+    // The HAL state goes last, its restore discards the MetaStreams queued by the
+    // OGL and GAL restore
+    checkpoint::saveTag(*f, CHECKPOINT_TAG_OGL);
+    ogl::saveState(*f);
+    checkpoint::saveTag(*f, CHECKPOINT_TAG_HAL);
+    driver_->saveState(*f);
+
+    return f->good();
+}
+
+bool TraceDriverApitraceOGL::loadCheckpoint(std::fstream* f) {
+    CG_ASSERT_COND((startFrame_ == 0), "Checkpoints require the trace to start at frame 0.");
+    CG_ASSERT_COND((metaStreams_ == 0) && (checkpoint_ == nullptr), "Checkpoint loaded after the start of the trace.");
+
+    const TraceDriverCheckpoint::Position& target = tracker_.load(f, traceTyp, false);
+
+    CG_ASSERT_COND(checkpoint::checkTag(*f, CHECKPOINT_TAG_TRACE), "Trace position missing from the checkpoint.");
+    CG_ASSERT_COND(parser_.restorePosition(*f), "Trace position of the checkpoint not found in the trace file.");
+    apitrace::restoreDispatcherState(*f);
+
+    CG_ASSERT_COND(checkpoint::checkTag(*f, CHECKPOINT_TAG_OGL), "OGL state missing from the checkpoint.");
+    ogl::restoreState(*f);
+    CG_ASSERT_COND(checkpoint::checkTag(*f, CHECKPOINT_TAG_HAL), "HAL state missing from the checkpoint.");
+    driver_->restoreState(*f);
+
+    CG_ASSERT_COND(f->good(), "Error reading trace driver checkpoint file.");
+
+    currentFrame_ = target.frame;
+    lastCallNo_ = target.callNo;
+    metaStreams_ = target.metaStreams;
+
+    // The recorded registers are consumed by the restore MetaStreams
+    checkpoint_ = new TraceDriverCheckpoint(tracker_);
+
+    std::cout << "TraceDriverApitraceOGL => Restored frame " << currentFrame_ << " call " << lastCallNo_
+              << " after " << metaStreams_ << " MetaStreams." << std::endl;
+
+    return true;
+}
@@ -11,6 +11,7 @@
 #include "GPUType.h"
 #include "MetaStream.h"
 #include "TraceDriverBase.h"
+#include "TraceDriverCheckpoint.h"
 #include "ApitraceParser.h"
 #include "HAL.h"
 
@@ -29,12 +30,32 @@ public:
     arch::cgoMetaStream* nxtMetaStream() override;
     U32 getTracePosition() override { return currentFrame_; }
 
+    /**
+     * Saves a state checkpoint (see TraceDriverCheckpoint): GPU registers, trace
+     * position, display lists, OGL context, GAL objects and HAL state.  Only
+     * supported when the trace is started from frame 0.
+     */
+    bool saveCheckpoint(std::fstream* f) override;
+
+    /**
+     * Restores the state saved by saveCheckpoint() and seeks the trace to the
+     * checkpoint.  Only supported when the trace is started from frame 0.
+     */
+    bool loadCheckpoint(std::fstream* f) override;
+
 private:
     apitrace::ApitraceParser parser_;
     HAL* driver_;
     U32 startFrame_;
     U32 currentFrame_;
     bool initialized_;
+    U32 lastCallNo_;                        //!< Call number of the last API call dispatched
+    U32 metaStreams_;                       //!< MetaStreams generated from the trace
+    TraceDriverCheckpoint tracker_;         //!< GPU state changed by the MetaStreams generated
+    TraceDriverCheckpoint* checkpoint_;     //!< GPU state to restore after loading a checkpoint
+
+    arch::cgoMetaStream* generateMetaStream();
+    TraceDriverCheckpoint::Position checkpointPosition() const;
 };
 
 #endif // TRACEDRIVERAPITRACEOGL_H
@@ -3,6 +3,7 @@
 
 #include "MetaStreamTrace.h"
 #include "HAL.h"
+#include <fstream>
 enum TraceTyp
 {
     TraceTypD3d, //  Flag that stores if the input trace is a D3D9 API trace (PIX).  */
@@ -53,6 +54,28 @@ public:
      */
      
     virtual U32 getTracePosition() = 0;
+
+    /**
+     *  Saves the trace driver state for a simulator snapshot.
+     *  @param f Pointer to the snapshot file.
+     *  @return If the trace driver supports checkpoints.
+     */
+    virtual bool saveCheckpoint(std::fstream *f) { return false; }
+
+    /**
+     *  Stops generating MetaStreams ahead of the simulation before a checkpoint is saved.
+     *  @return If the trace driver state matches the last MetaStream returned.  Otherwise
+     *  the simulation must consume the MetaStreams already generated and call it again.
+     */
+    virtual bool prepareCheckpoint() { return true; }
+
+    /**
+     *  Moves the trace driver to the position stored in a simulator snapshot.
+     *  Must be called before the first MetaStream is requested.
+     *  @param f Pointer to the snapshot file.
+     *  @return If the trace driver supports checkpoints.
+     */
+    virtual bool loadCheckpoint(std::fstream *f) { return false; }
 };
 
 extern "C" cgoTraceDriverBase *createTraceDriver(char *ProfilingFile, HAL* driver, U32 startFrame);
@@ -0,0 +1,246 @@
+/**************************************************************************
+ * TraceDriverCheckpoint.cpp
+ *
+ * Implementation of the checkpoint support for the apitrace trace drivers.
+ */
+
+#include "TraceDriverCheckpoint.h"
+
+using namespace arch;
+#include "support.h"
+#include <sstream>
+#include <iostream>
+
+void TraceDriverCheckpoint::saveHeader(std::fstream* f, TraceTyp traceTyp, const Position& pos, Mode mode)
+{
+    U32 type = traceTyp;
+    U32 version = VERSION;
+    U32 kind = mode;
+
+    f->write((char *) &type, sizeof(type));
+    f->write((char *) &version, sizeof(version));
+    f->write((char *) &kind, sizeof(kind));
+    f->write((char *) &pos.frame, sizeof(pos.frame));
+    f->write((char *) &pos.callNo, sizeof(pos.callNo));
+    f->write((char *) &pos.metaStreams, sizeof(pos.metaStreams));
+}
+
+void TraceDriverCheckpoint::save(std::fstream* f, TraceTyp traceTyp, const Position& pos, HAL* driver)
+{
+    std::ostringstream state;
+    driver->saveAllocationState(state);
+    std::string allocation = state.str();
+
+    U32 allocationBytes = U32(allocation.size());
+
+    saveHeader(f, traceTyp, pos, MODE_REPLAY);
+    f->write((char *) &allocationBytes, sizeof(allocationBytes));
+    f->write(allocation.data(), allocationBytes);
+}
+
+TraceDriverCheckpoint::TraceDriverCheckpoint()
+    : phase(RP_LOAD_PROGRAMS), nextLoad(0), nextLoadRegister(0)
+{
+    position.frame = 0;
+    position.callNo = 0;
+    position.metaStreams = 0;
+}
+
+TraceDriverCheckpoint::~TraceDriverCheckpoint()
+{
+}
+
+void TraceDriverCheckpoint::saveState(std::fstream* f, TraceTyp traceTyp, const Position& pos) const
+{
+    saveHeader(f, traceTyp, pos, MODE_STATE);
+
+    registerCache.saveState(*f);
+
+    U32 loads = U32(programLoads.size());
+    f->write((char *) &loads, sizeof(loads));
+    for (U32 l = 0; l < loads; l++) {
+        f->write((char *) &programLoads[l].command, sizeof(programLoads[l].command));
+        U32 registers = U32(programLoads[l].registers.size());
+        f->write((char *) &registers, sizeof(registers));
+        f->write((char *) programLoads[l].registers.data(), registers * sizeof(RegisterValue));
+    }
+}
+
+const TraceDriverCheckpoint::Position& TraceDriverCheckpoint::load(std::fstream* f, TraceTyp traceTyp, bool replay)
+{
+    U32 type;
+    U32 version;
+    U32 kind;
+
+    f->read((char *) &type, sizeof(type));
+    f->read((char *) &version, sizeof(version));
+
+    CG_ASSERT_COND(f->good() && (version == VERSION), "Unsupported trace driver checkpoint file.");
+    CG_ASSERT_COND((type == U32(traceTyp)), "Trace driver checkpoint was saved for a different trace type.");
+
+    f->read((char *) &kind, sizeof(kind));
+    CG_ASSERT_COND((kind == U32(replay ? MODE_REPLAY : MODE_STATE)), "Trace driver checkpoint kind not supported by the trace driver.");
+
+    f->read((char *) &position.frame, sizeof(position.frame));
+    f->read((char *) &position.callNo, sizeof(position.callNo));
+    f->read((char *) &position.metaStreams, sizeof(position.metaStreams));
+
+    if (replay) {
+        U32 allocationBytes;
+        f->read((char *) &allocationBytes, sizeof(allocationBytes));
+
+        allocationState.resize(allocationBytes);
+        if (allocationBytes > 0)
+            f->read(&allocationState[0], allocationBytes);
+    }
+    else {
+        registerCache.restoreState(*f);
+
+        U32 loads = 0;
+        f->read((char *) &loads, sizeof(loads));
+        programLoads.resize(loads);
+        for (U32 l = 0; l < loads; l++) {
+            U32 registers = 0;
+            f->read((char *) &programLoads[l].command, sizeof(programLoads[l].command));
+            f->read((char *) &registers, sizeof(registers));
+            programLoads[l].registers.resize(registers);
+            f->read((char *) programLoads[l].registers.data(), registers * sizeof(RegisterValue));
+        }
+    }
+
+    CG_ASSERT_COND(f->good(), "Error reading trace driver checkpoint file.");
+
+    return position;
+}
+
+void TraceDriverCheckpoint::skip(cgoMetaStream* metaStream)
+{
+    record(metaStream);
+    delete metaStream;
+}
+
+void TraceDriverCheckpoint::record(cgoMetaStream* metaStream)
+{
+    switch (metaStream->GetMetaStreamType()) {
+        case META_STREAM_REG_WRITE:
+            registerCache.writeRegister(metaStream->getGPURegister(), metaStream->getGPUSubRegister(),
+                                        metaStream->getGPURegData(), metaStream->getMD());
+            break;
+
+        case META_STREAM_COMMAND:
+            switch (metaStream->getGPUCommand()) {
+                case GPU_RESET:
+                    //  The simulator starts from the reset state.
+                    registerCache = RegisterWriteBufferMeta();
+                    programLoads.clear();
+                    break;
+
+                case GPU_LOAD_VERTEX_PROGRAM:
+                case GPU_LOAD_FRAGMENT_PROGRAM:
+                case GPU_LOAD_SHADER_PROGRAM:
+                    recordProgramLoad(metaStream->getGPUCommand());
+                    break;
+
+                default:
+                    //  Draws, clears and swaps only change the GPU memory and the block
+                    //  state, stored in the simulator snapshot.
+                    break;
+            }
+            break;
+
+        default:
+            //  Memory writes are stored in the GPU memory snapshot.
+            break;
+    }
+}
+
+void TraceDriverCheckpoint::recordProgramLoad(GPUCommand command)
+{
+    static const GPURegister vertexRegs[] = {GPU_VERTEX_PROGRAM, GPU_VERTEX_PROGRAM_SIZE, GPU_VERTEX_PROGRAM_PC};
+    static const GPURegister fragmentRegs[] = {GPU_FRAGMENT_PROGRAM, GPU_FRAGMENT_PROGRAM_SIZE, GPU_FRAGMENT_PROGRAM_PC};
+    static const GPURegister shaderRegs[] = {GPU_SHADER_PROGRAM_ADDRESS, GPU_SHADER_PROGRAM_SIZE, GPU_SHADER_PROGRAM_LOAD_PC};
+
+    const GPURegister* regs = (command == GPU_LOAD_VERTEX_PROGRAM) ? vertexRegs :
+                              (command == GPU_LOAD_FRAGMENT_PROGRAM) ? fragmentRegs : shaderRegs;
+
+    //  Address, size and load PC of the program.
+    ProgramLoad load;
+    load.command = command;
+    for (U32 r = 0; r < 3; r++) {
+        RegisterValue value = RegisterValue();
+        value.reg = regs[r];
+        registerCache.readRegister(value.reg, value.index, value.data, value.md);
+        load.registers.push_back(value);
+    }
+
+    //  Remove the previous loads to the same PC that the new load overwrites.
+    for (size_t l = 0; l < programLoads.size(); ) {
+        if ((programLoads[l].command == command) &&
+            (programLoads[l].registers[2].data.uintVal == load.registers[2].data.uintVal) &&
+            (programLoads[l].registers[1].data.uintVal <= load.registers[1].data.uintVal))
+            programLoads.erase(programLoads.begin() + l);
+        else
+            l++;
+    }
+
+    programLoads.push_back(load);
+}
+
+void TraceDriverCheckpoint::check(const Position& pos, HAL* driver)
+{
+    CG_ASSERT_COND((pos.metaStreams == position.metaStreams), "Trace ended before reaching the checkpoint.");
+    CG_ASSERT_COND((pos.frame == position.frame) && (pos.callNo == position.callNo),
+                   "Checkpoint position mismatch.  Saved frame %d call %d, reached frame %d call %d.",
+                   position.frame, position.callNo, pos.frame, pos.callNo);
+
+    std::ostringstream state;
+    driver->saveAllocationState(state);
+
+    CG_ASSERT_COND((state.str() == allocationState), "HAL memory allocation state differs from the checkpoint.");
+
+    std::cout << "TraceDriverCheckpoint => Reached frame " << position.frame << " call " << position.callNo
+              << " after " << position.metaStreams << " MetaStreams.  Restoring "
+              << programLoads.size() << " shader program loads." << std::endl;
+}
+
+cgoMetaStream* TraceDriverCheckpoint::nextMetaStream()
+{
+    GPURegister reg;
+    U32 index;
+    GPURegData data;
+    U32 md;
+
+    while (true) {
+        switch (phase) {
+            case RP_LOAD_PROGRAMS:
+                //  Load the shader programs in the original order, the instruction memory
+                //  reads the programs from the restored GPU memory.
+                if (nextLoad == programLoads.size()) {
+                    phase = RP_LOAD_REGS;
+                    break;
+                }
+
+                if (nextLoadRegister < programLoads[nextLoad].registers.size()) {
+                    const RegisterValue& value = programLoads[nextLoad].registers[nextLoadRegister++];
+                    return new cgoMetaStream(value.reg, value.index, value.data, value.md);
+                }
+
+                nextLoadRegister = 0;
+                return new cgoMetaStream(programLoads[nextLoad++].command);
+
+            case RP_LOAD_REGS:
+                if (registerCache.flushNextRegister(reg, index, data, md))
+                    return new cgoMetaStream(reg, index, data, md);
+
+                phase = RP_END_INIT;
+                break;
+
+            case RP_END_INIT:
+                phase = RP_END;
+                return new cgoMetaStream();
+
+            case RP_END:
+                return NULL;
+        }
+    }
+}
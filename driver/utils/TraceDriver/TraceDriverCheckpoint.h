@@ -0,0 +1,156 @@
+/**************************************************************************
+ * TraceDriverCheckpoint.h
+ *
+ * Checkpoint support for the apitrace trace drivers (OpenGL and D3D9).
+ *
+ * A checkpoint stores the position of the trace driver (frame, last API call
+ * dispatched and MetaStreams sent to the simulator).  The GPU memory is stored by
+ * the simulator snapshot.  There are two kinds of checkpoints:
+ *
+ * - State checkpoints (OpenGL).  The trace driver records with record() the GPU
+ *   registers and shader program loads of the MetaStreams it generates, and the
+ *   checkpoint stores them followed by the state written by the trace driver: trace
+ *   file offset, API context, GAL objects and HAL state.  Resuming restores that
+ *   state and seeks the trace to the checkpoint, so the time does not depend on the
+ *   position of the checkpoint in the trace.
+ *
+ * - Replay checkpoints (D3D9, the D3D9 driver objects can not be serialized).  The
+ *   checkpoint stores the HAL memory allocation state.  To resume, the trace driver
+ *   dispatches the API calls up to the checkpoint through the driver stack
+ *   (API -> GAL -> HAL) without simulating, the MetaStreams generated are passed to
+ *   skip() instead of the simulator, and check() verifies the HAL state reached.
+ *
+ * In both cases the last value of the GPU registers and the shader program loads
+ * are sent to the simulator before the MetaStreams that follow the checkpoint.
+ */
+
+#ifndef TRACEDRIVERCHECKPOINT_H
+#define TRACEDRIVERCHECKPOINT_H
+
+#include "GPUType.h"
+#include "GPUReg.h"
+#include "MetaStream.h"
+#include "TraceDriverBase.h"
+#include "RegisterWriteBufferMeta.h"
+#include "HAL.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+class TraceDriverCheckpoint {
+public:
+
+    /**
+     * Position of a trace driver in the trace.
+     */
+    struct Position {
+        U32 frame;          //!< Frames dispatched.
+        U32 callNo;         //!< Call number of the last API call dispatched.
+        U32 metaStreams;    //!< MetaStreams sent to the simulator.
+    };
+
+    /**
+     * Writes a replay checkpoint file.
+     * @param f Pointer to the checkpoint file.
+     * @param traceTyp Type of the trace.
+     * @param pos Position of the trace driver.
+     * @param driver HAL driver instance.
+     */
+    static void save(std::fstream* f, TraceTyp traceTyp, const Position& pos, HAL* driver);
+
+    TraceDriverCheckpoint();
+    ~TraceDriverCheckpoint();
+
+    /**
+     * Writes the header of a state checkpoint file and the GPU state recorded.  The
+     * trace driver writes its own state after it.
+     * @param f Pointer to the checkpoint file.
+     * @param traceTyp Type of the trace.
+     * @param pos Position of the trace driver.
+     */
+    void saveState(std::fstream* f, TraceTyp traceTyp, const Position& pos) const;
+
+    /**
+     * Reads the header of a checkpoint file and the HAL allocation state (replay
+     * checkpoints) or the GPU state recorded (state checkpoints).
+     * @param f Pointer to the checkpoint file.
+     * @param traceTyp Type of the trace.
+     * @param replay Kind of checkpoint expected by the trace driver.
+     * @return The position of the trace driver stored in the checkpoint.
+     */
+    const Position& load(std::fstream* f, TraceTyp traceTyp, bool replay);
+
+    /**
+     * Records the GPU state changed by a MetaStream.
+     * @param metaStream Pointer to the MetaStream.
+     */
+    void record(arch::cgoMetaStream* metaStream);
+
+    /**
+     * Records the GPU state changed by a MetaStream generated before a replay
+     * checkpoint and deletes the MetaStream.
+     * @param metaStream Pointer to the MetaStream.
+     */
+    void skip(arch::cgoMetaStream* metaStream);
+
+    /**
+     * Checks that the trace driver reached the checkpoint.
+     * @param pos Position of the trace driver.
+     * @param driver HAL driver instance.
+     */
+    void check(const Position& pos, HAL* driver);
+
+    /**
+     * Returns the next MetaStream restoring the GPU state recorded, NULL after the
+     * end of initialization MetaStream.  Consumes the recorded register values.
+     */
+    arch::cgoMetaStream* nextMetaStream();
+
+private:
+
+    static const U32 VERSION = 2;
+
+    //  Kind of checkpoint.
+    enum Mode {
+        MODE_REPLAY,
+        MODE_STATE
+    };
+
+    //  GPU register value.
+    struct RegisterValue {
+        arch::GPURegister reg;
+        U32 index;
+        arch::GPURegData data;
+        U32 md;
+    };
+
+    //  Shader program load command and the registers it reads.
+    struct ProgramLoad {
+        arch::GPUCommand command;
+        std::vector<RegisterValue> registers;
+    };
+
+    //  Restore phases.
+    enum RestorePhase {
+        RP_LOAD_PROGRAMS,
+        RP_LOAD_REGS,
+        RP_END_INIT,
+        RP_END
+    };
+
+    Position position;                  //  Position stored in the checkpoint.
+    std::string allocationState;        //  HAL memory allocation state stored in a replay checkpoint.
+
+    RegisterWriteBufferMeta registerCache;  //  Last value of the GPU registers written before the checkpoint.
+    std::vector<ProgramLoad> programLoads;  //  Shader program loads before the checkpoint.
+
+    RestorePhase phase;
+    U32 nextLoad;                       //  Next program load to restore.
+    U32 nextLoadRegister;               //  Next register of the program load to restore.
+
+    static void saveHeader(std::fstream* f, TraceTyp traceTyp, const Position& pos, Mode mode);
+    void recordProgramLoad(arch::GPUCommand command);
+};
+
+#endif // TRACEDRIVERCHECKPOINT_H
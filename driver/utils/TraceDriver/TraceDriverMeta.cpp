@@ -22,6 +22,10 @@ TraceDriverMeta::TraceDriverMeta(gzifstream *ProfilingFile, U32 startFrame_, U32
     traceTyp = TraceTypCgp;
     maxFrames_ = maxFrames;
     MetaTraceFile = ProfilingFile;
+    blockReader = NULL;
+    traceEnd = false;
+    positioned = false;
+    memoryImageAddress = 0;
 
     //  Clear the shader program data caches
     memset(fragProgramCache, 0, sizeof(fragProgramCache));
@@ -35,6 +39,20 @@ TraceDriverMeta::TraceDriverMeta(gzifstream *ProfilingFile, U32 startFrame_, U32
         
 }
 
+TraceDriverMeta::TraceDriverMeta(cgoMetaStreamBlockReader *blockReader_, U32 startFrame_, U32 traceFirstFrame_, U32 maxFrames) :
+    TraceDriverMeta((gzifstream *) NULL, startFrame_, traceFirstFrame_, maxFrames)
+{
+    blockReader = blockReader_;
+}
+
+TraceDriverMeta::~TraceDriverMeta()
+{
+    delete blockReader;
+
+    for(map<U32, MemoryImagePage*>::iterator it = memoryImage.begin(); it != memoryImage.end(); it++)
+        delete it->second;
+}
+
 int TraceDriverMeta::startTrace()
 {
     // do not do anything :-)
@@ -49,27 +67,32 @@ cgoMetaStream* TraceDriverMeta::nxtMetaStream()
     if (frameLimitReached_)
         return NULL;
     
+    //  Seek a block file to the start position before the first MetaStream is read.
+    if (!positioned)
+    {
+        positioned = true;
+
+        if ((blockReader != NULL) && (currentPhase == TP_PREINIT))
+            seekStartPosition();
+    }
+
     cgoMetaStream* metaStream = NULL;
     //  Check for the MetaStream trace file
-    if (MetaTraceFile != NULL)
+    if ((MetaTraceFile != NULL) || (blockReader != NULL))
     {
         //  Keep reading the MetaStream trace file until an MetaStream can be sent to the simulator
-        while (!MetaTraceFile->eof() && metaStream == NULL)
+        while (!traceEnd && metaStream == NULL)
         {
             //  Check if the MetaStreams are being generated by the trace reader or
             //  read from the MetaStream trace file.
             if ((currentPhase == TP_PREINIT) || (currentPhase == TP_SIMULATION))
             {
                 //  Read the next MetaStream from the input MetaStream trace file.
-                metaStream = new cgoMetaStream(MetaTraceFile);
+                metaStream = readMetaStream();
                 
                 //  Check for end of file.
-                if (MetaTraceFile->eof())
-                {
-                    delete metaStream;
-                    metaStream = NULL;
+                if (metaStream == NULL)
                     break;
-                }
                     
                 //metaStream->dump();
 
@@ -90,300 +113,20 @@ cgoMetaStream* TraceDriverMeta::nxtMetaStream()
                         currentPhase = TP_LOAD_SHADERS;
                     }
                             
-                    //  Determine what to do based on the kind of MetaStream.
-                    switch(metaStream->GetMetaStreamType())
-                    {
-                        case META_STREAM_WRITE:
-                        
-                            //  Convert all the upload operations into META_STREAM_PRELOAD transactions.
-                            metaStream->forcePreload();
-                            
-                            //  Check if this upload operation may be a shader program upload.
-                            if (metaStream->getSize() <= (SHADERINSTRUCTIONSIZE * MAXSHADERINSTRUCTIONS))
-                            {
-                                lastProgramUpload = new ProgramUpload(metaStream->getAddress(),
-                                                                      metaStream->getSize(),
-                                                                      metaStream->getData(),
-                                                                      metaStream->getMD(),
-                                                                      agpTransCount);
-                                
-
-                                //  Search the address in the list of program uploads
-                                ProgramUploadsIterator upIt = programUploads.find(metaStream->getAddress());
-                                
-                                //  Check if the upload was found
-                                if (upIt != programUploads.end())
-                                {
-                                    //  Update data.
-                                    (upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
-                                        lastProgramUpload->agpTransID);
-                                }
-                                else
-                                {
-                                    //  Insert the new program upload.
-                                    programUploads.insert(make_pair(lastProgramUpload->address, lastProgramUpload)); 
-                                }
-                            }
-                            
-                            break;
-                            
-                        case META_STREAM_PRELOAD:
-                        
-                            //  Check if this upload operation may be a shader program upload.
-                            if (metaStream->getSize() <= (SHADERINSTRUCTIONSIZE * MAXSHADERINSTRUCTIONS))
-                            {
-                                //delete lastProgramUpload;
-                                
-                                lastProgramUpload = new ProgramUpload(metaStream->getAddress(),
-                                                                      metaStream->getSize(),
-                                                                      metaStream->getData(),
-                                                                      metaStream->getMD(),
-                                                                      agpTransCount);
-                                                                      
-                                //  Search the address in the list of program uploads
-                                ProgramUploadsIterator upIt = programUploads.find(metaStream->getAddress());
-                                
-                                //  Check if the upload was found
-                                if (upIt != programUploads.end())
-                                {
-                                    //  Update data.
-                                    (upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
-                                        lastProgramUpload->agpTransID);
-                                }
-                                else
-                                {
-                                    //  Insert the new program upload.
-                                    programUploads.insert(make_pair(lastProgramUpload->address, lastProgramUpload)); 
-                                }
-                            }
-
-                            break;
-                            
-                        case META_STREAM_COMMAND:
-                        
-                            //  Determine how to skip the MetaStream based on the MetaStream command.
-                            switch(metaStream->getGPUCommand())
-                            {
-                                case GPU_DRAW:
-                                
-                                    //  Ignore all the GPU_DRAW transactions.
-                                    delete metaStream;
-                                    metaStream = NULL;
-                                    
-                                    break;
-                                    
-                                case GPU_SWAPBUFFERS:
-                              
-                                    cout << "Frame " << (traceFirstFrame + currentFrame) << " Skipped" << endl;
-                                    
-                                    //  Ignore the SWAPBUFFER command from a frame being skipped.
-                                    delete metaStream;
-                                    metaStream = NULL;
-                                    
-                                    //  Update frame counter.  
-                                    currentFrame++;
-                                    
-                                    //  Check if all the frames were skipped.
-                                    if (currentFrame == startFrame)
-                                    {
-                                        cout << "TraceDriverMeta::nxtMetaStream() -> Disabling preload..." << endl;
-                                            
-                                        //  Check if skipping commands has to end.
-                                        if (startTransaction == 0)
-                                        {
-                                            //  Start loading the cached shader programs.
-                                            currentPhase = TP_LOAD_SHADERS;
-                                        }
-                                    }
-                                    
-                                    
-                                    break;
-
-                                case GPU_LOAD_VERTEX_PROGRAM:
-                                
-                                    
-                                    //  Check the address of the program load with the last upload address.
-                                    if ((lastProgramUpload != NULL) && (lastProgramUpload->address == vertexProgramAddress))
-                                    {
-                                        //  Search the address in the list of program uploads
-                                        ProgramUploadsIterator upIt = programUploads.find(vertexProgramAddress);
-                                        
-                                        //  Check if the upload was found
-                                        if (upIt != programUploads.end())
-                                        {
-                                            //  Update data.
-                                            //(upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
-                                            //    lastProgramUpload->agpTransID);
-                                            
-                                            //  Update the shader program cache.
-                                            memcpy(&vertProgramCache[vertexProgramPC * SHADERINSTRUCTIONSIZE], lastProgramUpload->data, vertexProgramSize);
-                                        }
-                                        
-                                        lastProgramUpload = NULL;
-                                    }
-                                    else
-                                    {
-                                        //  Search the upload address in the list of uploaded programas.
-                                        
-                                        //  Search the address in the list of program uploads
-                                        ProgramUploadsIterator upIt = programUploads.find(vertexProgramAddress);
-                                        
-                                        //  Check if the upload was found
-                                        if (upIt != programUploads.end())
-                                        {
-                                            if (upIt->second->size < vertexProgramSize)
-                                            {
-                                                printf("(Vertex) PC %x Address %x Size %d Upload Size %d\n", vertexProgramPC,
-                                                    vertexProgramAddress, vertexProgramSize, upIt->second->size);
-                                                CG_ASSERT("Upload program data smaller than required by load command.");
-                                            }
-                                            
-                                            //  Update the shader program cache.
-                                            memcpy(&vertProgramCache[vertexProgramPC * SHADERINSTRUCTIONSIZE], upIt->second->data, vertexProgramSize);
-                                        }
-                                        else
-                                        {
-                                            CG_ASSERT("Data for shader program load operations was not found.");
-                                        }
-                                        
-                                    }
-                                    
-                                    //  Ignoring all commands;
-                                    delete metaStream;
-                                    metaStream = NULL;
-                                    
-                                    break;
-                                
-                                case GPU_LOAD_FRAGMENT_PROGRAM:
-                                
-                                    //  Check the address of the program load with the last upload address.
-                                    if ((lastProgramUpload != NULL) && (lastProgramUpload->address == fragmentProgramAddress))
-                                    {
-                                        //  Search the address in the list of program uploads
-                                        ProgramUploadsIterator upIt = programUploads.find(fragmentProgramAddress);
-                                        
-                                        //  Check if the upload was found
-                                        if (upIt != programUploads.end())
-                                        {
-                                            //  Update data.
-                                            //(upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
-                                            //    lastProgramUpload->agpTransID);
-                                            
-                                            //  Update the shader program cache.
-                                            memcpy(&fragProgramCache[fragmentProgramPC * SHADERINSTRUCTIONSIZE], lastProgramUpload->data, fragmentProgramSize);
-                                        }
-                                    }
-                                    else
-                                    {
-                                        //  Search the upload address in the list of uploaded programas.
-                                        
-                                        //  Search the address in the list of program uploads
-                                        ProgramUploadsIterator upIt = programUploads.find(fragmentProgramAddress);
-                                        
-                                        //  Check if the upload was found
-                                        if (upIt != programUploads.end())
-                                        {
-                                            if (upIt->second->size < fragmentProgramSize)
-                                            {
-                                                printf("(Fragment) PC %x Address %x Size %d Upload Size %d\n", fragmentProgramPC,
-                                                    fragmentProgramAddress, fragmentProgramSize, upIt->second->size);
-                                                CG_ASSERT("Upload program data smaller than required by load command.");
-                                            }
-                                            //  Update the shader program cache.
-                                            memcpy(&fragProgramCache[fragmentProgramPC * SHADERINSTRUCTIONSIZE], upIt->second->data, fragmentProgramSize);
-                                        }
-                                        else
-                                        {
-                                            CG_ASSERT("Data for shader program load operations was not found.");
-                                        }
-                                        
-                                    }
-                                    
-                                    //  Ignoring all commands;
-                                    delete metaStream;
-                                    metaStream = NULL;
-                                    
-                                    break;
-                                    
-                                case GPU_BLIT:
-                                
-                                    //  Ignore all the GPU_BLIT transactions.
-                                    delete metaStream;
-                                    metaStream = NULL;
-                                    
-                                    break;                                
-                            }
-                            
-                            break;
-                            
-                        case META_STREAM_REG_WRITE:
-                        
-                            //  Update register cache with the register write.
-                            registerCache.writeRegister(metaStream->getGPURegister(),
-                                                        metaStream->getGPUSubRegister(),
-                                                        metaStream->getGPURegData(),
-                                                        metaStream->getMD());
-                            
-                            //  Check for shader program related registers.
-                            switch(metaStream->getGPURegister())
-                            {
-                                case GPU_FRAGMENT_PROGRAM:
-                                
-                                    fragmentProgramAddress = metaStream->getGPURegData().uintVal;
-                                    
-                                    break;
-                                    
-                                case GPU_FRAGMENT_PROGRAM_PC:
+                    //  Cache the state set by the MetaStream.
+                    skipMetaStream(metaStream);
+                    
+                    break;
 
-                                    fragmentProgramPC = metaStream->getGPURegData().uintVal;
-                                    
-                                    break;
-                                    
-                                case GPU_FRAGMENT_PROGRAM_SIZE:
-                                
-                                    fragmentProgramSize = metaStream->getGPURegData().uintVal;
-                                    
-                                    break;
+                case TP_LOAD_MEMORY:
 
-                                case GPU_VERTEX_PROGRAM:
-                                
-                                    vertexProgramAddress = metaStream->getGPURegData().uintVal;
-                                    
-                                    break;
+                    //  Preload the next run of the memory image.
+                    metaStream = nextMemoryImagePreload();
 
-                                case GPU_VERTEX_PROGRAM_PC:
-                                
-                                    vertexProgramPC = metaStream->getGPURegData().uintVal;
-                                    
-                                    break;
-                                    
-                                case GPU_VERTEX_PROGRAM_SIZE:
-                                    
-                                    vertexProgramSize = metaStream->getGPURegData().uintVal;
-                                    
-                                    break;
+                    //  Continue skipping the MetaStreams from the start block.
+                    if (metaStream == NULL)
+                        currentPhase = TP_PREINIT;
 
-                                default:
-                                    break;
-                                 
-                            }
-                        
-                            //  Ignore all the register writes for frames being skipped.
-                            delete metaStream;
-                            metaStream = NULL;
-                            
-                            break;
-                            
-                        case META_STREAM_EVENT:
-                        
-                            //  Ignore events in the initialization phase.
-                            delete metaStream;
-                            metaStream = NULL;
-                            
-                            break;
-                            
-                    }            
-                    
                     break;
                     
                 case TP_LOAD_SHADERS:
@@ -583,6 +326,469 @@ cgoMetaStream* TraceDriverMeta::nxtMetaStream()
     return metaStream;
 }
 
+//  Processes a MetaStream from a frame being skipped.  Caches the register writes and the shader
+//  programs and converts the memory writes into preloads.  The other MetaStreams are deleted.
+void TraceDriverMeta::skipMetaStream(cgoMetaStream *&metaStream)
+{
+    switch(metaStream->GetMetaStreamType())
+    {
+        case META_STREAM_WRITE:
+        
+            //  Convert all the upload operations into META_STREAM_PRELOAD transactions.
+            metaStream->forcePreload();
+            
+            //  Check if this upload operation may be a shader program upload.
+            if (metaStream->getSize() <= (SHADERINSTRUCTIONSIZE * MAXSHADERINSTRUCTIONS))
+            {
+                lastProgramUpload = new ProgramUpload(metaStream->getAddress(),
+                                                      metaStream->getSize(),
+                                                      metaStream->getData(),
+                                                      metaStream->getMD(),
+                                                      agpTransCount);
+                
+
+                //  Search the address in the list of program uploads
+                ProgramUploadsIterator upIt = programUploads.find(metaStream->getAddress());
+                
+                //  Check if the upload was found
+                if (upIt != programUploads.end())
+                {
+                    //  Update data.
+                    (upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
+                        lastProgramUpload->agpTransID);
+                }
+                else
+                {
+                    //  Insert the new program upload.
+                    programUploads.insert(make_pair(lastProgramUpload->address, lastProgramUpload)); 
+                }
+            }
+            
+            break;
+            
+        case META_STREAM_PRELOAD:
+        
+            //  Check if this upload operation may be a shader program upload.
+            if (metaStream->getSize() <= (SHADERINSTRUCTIONSIZE * MAXSHADERINSTRUCTIONS))
+            {
+                //delete lastProgramUpload;
+                
+                lastProgramUpload = new ProgramUpload(metaStream->getAddress(),
+                                                      metaStream->getSize(),
+                                                      metaStream->getData(),
+                                                      metaStream->getMD(),
+                                                      agpTransCount);
+                                                      
+                //  Search the address in the list of program uploads
+                ProgramUploadsIterator upIt = programUploads.find(metaStream->getAddress());
+                
+                //  Check if the upload was found
+                if (upIt != programUploads.end())
+                {
+                    //  Update data.
+                    (upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
+                        lastProgramUpload->agpTransID);
+                }
+                else
+                {
+                    //  Insert the new program upload.
+                    programUploads.insert(make_pair(lastProgramUpload->address, lastProgramUpload)); 
+                }
+            }
+
+            break;
+            
+        case META_STREAM_COMMAND:
+        
+            //  Determine how to skip the MetaStream based on the MetaStream command.
+            switch(metaStream->getGPUCommand())
+            {
+                case GPU_DRAW:
+                
+                    //  Ignore all the GPU_DRAW transactions.
+                    delete metaStream;
+                    metaStream = NULL;
+                    
+                    break;
+                    
+                case GPU_SWAPBUFFERS:
+              
+                    cout << "Frame " << (traceFirstFrame + currentFrame) << " Skipped" << endl;
+                    
+                    //  Ignore the SWAPBUFFER command from a frame being skipped.
+                    delete metaStream;
+                    metaStream = NULL;
+                    
+                    //  Update frame counter.  
+                    currentFrame++;
+                    
+                    //  Check if all the frames were skipped.
+                    if (currentFrame == startFrame)
+                    {
+                        cout << "TraceDriverMeta::nxtMetaStream() -> Disabling preload..." << endl;
+                            
+                        //  Check if skipping commands has to end.
+                        if (startTransaction == 0)
+                        {
+                            //  Start loading the cached shader programs.
+                            currentPhase = TP_LOAD_SHADERS;
+                        }
+                    }
+                    
+                    
+                    break;
+
+                case GPU_LOAD_VERTEX_PROGRAM:
+                
+                    
+                    //  Check the address of the program load with the last upload address.
+                    if ((lastProgramUpload != NULL) && (lastProgramUpload->address == vertexProgramAddress))
+                    {
+                        //  Search the address in the list of program uploads
+                        ProgramUploadsIterator upIt = programUploads.find(vertexProgramAddress);
+                        
+                        //  Check if the upload was found
+                        if (upIt != programUploads.end())
+                        {
+                            //  Update data.
+                            //(upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
+                            //    lastProgramUpload->agpTransID);
+                            
+                            //  Update the shader program cache.
+                            memcpy(&vertProgramCache[vertexProgramPC * SHADERINSTRUCTIONSIZE], lastProgramUpload->data, vertexProgramSize);
+                        }
+                        
+                        lastProgramUpload = NULL;
+                    }
+                    else
+                    {
+                        //  Search the upload address in the list of uploaded programas.
+                        
+                        //  Search the address in the list of program uploads
+                        ProgramUploadsIterator upIt = programUploads.find(vertexProgramAddress);
+                        
+                        //  Check if the upload was found
+                        if (upIt != programUploads.end())
+                        {
+                            if (upIt->second->size < vertexProgramSize)
+                            {
+                                printf("(Vertex) PC %x Address %x Size %d Upload Size %d\n", vertexProgramPC,
+                                    vertexProgramAddress, vertexProgramSize, upIt->second->size);
+                                CG_ASSERT("Upload program data smaller than required by load command.");
+                            }
+                            
+                            //  Update the shader program cache.
+                            memcpy(&vertProgramCache[vertexProgramPC * SHADERINSTRUCTIONSIZE], upIt->second->data, vertexProgramSize);
+                        }
+                        else
+                        {
+                            CG_ASSERT("Data for shader program load operations was not found.");
+                        }
+                        
+                    }
+                    
+                    //  Ignoring all commands;
+                    delete metaStream;
+                    metaStream = NULL;
+                    
+                    break;
+                
+                case GPU_LOAD_FRAGMENT_PROGRAM:
+                
+                    //  Check the address of the program load with the last upload address.
+                    if ((lastProgramUpload != NULL) && (lastProgramUpload->address == fragmentProgramAddress))
+                    {
+                        //  Search the address in the list of program uploads
+                        ProgramUploadsIterator upIt = programUploads.find(fragmentProgramAddress);
+                        
+                        //  Check if the upload was found
+                        if (upIt != programUploads.end())
+                        {
+                            //  Update data.
+                            //(upIt->second)->updateData(lastProgramUpload->data, lastProgramUpload->size,
+                            //    lastProgramUpload->agpTransID);
+                            
+                            //  Update the shader program cache.
+                            memcpy(&fragProgramCache[fragmentProgramPC * SHADERINSTRUCTIONSIZE], lastProgramUpload->data, fragmentProgramSize);
+                        }
+                    }
+                    else
+                    {
+                        //  Search the upload address in the list of uploaded programas.
+                        
+                        //  Search the address in the list of program uploads
+                        ProgramUploadsIterator upIt = programUploads.find(fragmentProgramAddress);
+                        
+                        //  Check if the upload was found
+                        if (upIt != programUploads.end())
+                        {
+                            if (upIt->second->size < fragmentProgramSize)
+                            {
+                                printf("(Fragment) PC %x Address %x Size %d Upload Size %d\n", fragmentProgramPC,
+                                    fragmentProgramAddress, fragmentProgramSize, upIt->second->size);
+                                CG_ASSERT("Upload program data smaller than required by load command.");
+                            }
+                            //  Update the shader program cache.
+                            memcpy(&fragProgramCache[fragmentProgramPC * SHADERINSTRUCTIONSIZE], upIt->second->data, fragmentProgramSize);
+                        }
+                        else
+                        {
+                            CG_ASSERT("Data for shader program load operations was not found.");
+                        }
+                        
+                    }
+                    
+                    //  Ignoring all commands;
+                    delete metaStream;
+                    metaStream = NULL;
+                    
+                    break;
+                    
+                case GPU_BLIT:
+                
+                    //  Ignore all the GPU_BLIT transactions.
+                    delete metaStream;
+                    metaStream = NULL;
+                    
+                    break;                                
+            }
+            
+            break;
+            
+        case META_STREAM_REG_WRITE:
+        
+            //  Update register cache with the register write.
+            registerCache.writeRegister(metaStream->getGPURegister(),
+                                        metaStream->getGPUSubRegister(),
+                                        metaStream->getGPURegData(),
+                                        metaStream->getMD());
+            
+            //  Check for shader program related registers.
+            switch(metaStream->getGPURegister())
+            {
+                case GPU_FRAGMENT_PROGRAM:
+                
+                    fragmentProgramAddress = metaStream->getGPURegData().uintVal;
+                    
+                    break;
+                    
+                case GPU_FRAGMENT_PROGRAM_PC:
+
+                    fragmentProgramPC = metaStream->getGPURegData().uintVal;
+                    
+                    break;
+                    
+                case GPU_FRAGMENT_PROGRAM_SIZE:
+                
+                    fragmentProgramSize = metaStream->getGPURegData().uintVal;
+                    
+                    break;
+
+                case GPU_VERTEX_PROGRAM:
+                
+                    vertexProgramAddress = metaStream->getGPURegData().uintVal;
+                    
+                    break;
+
+                case GPU_VERTEX_PROGRAM_PC:
+                
+                    vertexProgramPC = metaStream->getGPURegData().uintVal;
+                    
+                    break;
+                    
+                case GPU_VERTEX_PROGRAM_SIZE:
+                    
+                    vertexProgramSize = metaStream->getGPURegData().uintVal;
+                    
+                    break;
+
+                default:
+                    break;
+                 
+            }
+        
+            //  Ignore all the register writes for frames being skipped.
+            delete metaStream;
+            metaStream = NULL;
+            
+            break;
+            
+        case META_STREAM_EVENT:
+        
+            //  Ignore events in the initialization phase.
+            delete metaStream;
+            metaStream = NULL;
+            
+            break;
+            
+    }            
+}
+
+//  Replays the blocks before the start position and seeks the block reader to the start block.
+void TraceDriverMeta::seekStartPosition()
+{
+    const vector<cgsMetaStreamBlockEntry> &index = blockReader->getIndex();
+
+    //  The start position of a snapshot is a MetaStream, otherwise the start of a frame.
+    U32 block = (startTransaction > 0) ? blockReader->findMetaStreamBlock(startTransaction - 1) :
+                                         blockReader->findFrameBlock(startFrame);
+
+    if (block == 0)
+        return;
+
+    cout << "TraceDriverMeta => Seeking to block " << block << " (MetaStream " << index[block].firstMetaStream
+         << ", frame " << (traceFirstFrame + index[block].firstFrame) << ")." << endl;
+
+    //  The worker threads decompress the start blocks while the previous blocks are replayed.
+    blockReader->start(block);
+
+    cgoMetaStreamBlockReader stateReader;
+
+    if (!stateReader.open(blockReader->getFileName().c_str()))
+        CG_ASSERT("Error opening the MetaStream block file to replay the blocks before the start block.");
+
+    stateReader.start(0, block);
+
+    cgoMetaStream *metaStream;
+
+    while((metaStream = stateReader.next()) != NULL)
+    {
+        agpTransCount++;
+
+        skipMetaStream(metaStream);
+
+        //  The memory writes are merged into the memory image and preloaded once.
+        if (metaStream != NULL)
+        {
+            writeMemoryImage(metaStream);
+            delete metaStream;
+        }
+    }
+
+    CG_ASSERT_COND(((agpTransCount == index[block].firstMetaStream) && (currentFrame == index[block].firstFrame)),
+                   "MetaStream block file index doesn't match the MetaStreams before block %d.", block);
+
+    memoryImageAddress = 0;
+    currentPhase = TP_LOAD_MEMORY;
+}
+
+//  Writes the data of a memory write into the memory image.
+void TraceDriverMeta::writeMemoryImage(cgoMetaStream *metaStream)
+{
+    U32 address = metaStream->getAddress();
+    U32 size = metaStream->getSize();
+    U08 *data = metaStream->getData();
+
+    U32 offset = 0;
+
+    while(offset < size)
+    {
+        U32 pageAddress = (address + offset) & ~(MEMORY_IMAGE_PAGE - 1);
+        U32 pageOffset = (address + offset) - pageAddress;
+        U32 bytes = ((size - offset) < (MEMORY_IMAGE_PAGE - pageOffset)) ? (size - offset) : (MEMORY_IMAGE_PAGE - pageOffset);
+
+        MemoryImagePage *&page = memoryImage[pageAddress];
+
+        if (page == NULL)
+        {
+            page = new MemoryImagePage;
+            memset(page->written, 0, sizeof(page->written));
+        }
+
+        memcpy(&page->data[pageOffset], &data[offset], bytes);
+        memset(&page->written[pageOffset], 1, bytes);
+
+        offset += bytes;
+    }
+}
+
+//  Creates the preload for the next run of written bytes in the memory image.
+cgoMetaStream *TraceDriverMeta::nextMemoryImagePreload()
+{
+    //  Search the first written byte.  The pages already preloaded are released.
+    U64 start = 0;
+    bool found = false;
+
+    while(!found && !memoryImage.empty())
+    {
+        map<U32, MemoryImagePage*>::iterator it = memoryImage.begin();
+
+        U64 pageEnd = U64(it->first) + MEMORY_IMAGE_PAGE;
+
+        for(U64 a = (memoryImageAddress > it->first) ? memoryImageAddress : it->first; !found && (a < pageEnd); a++)
+        {
+            found = (it->second->written[a - it->first] != 0);
+            start = a;
+        }
+
+        if (!found)
+        {
+            delete it->second;
+            memoryImage.erase(it);
+        }
+    }
+
+    if (!found)
+        return NULL;
+
+    //  Extend the run over the contiguous written bytes.
+    U64 runEnd = (start & ~U64(MEMORY_IMAGE_RUN - 1)) + MEMORY_IMAGE_RUN;
+    U64 end = start;
+
+    map<U32, MemoryImagePage*>::iterator it = memoryImage.begin();
+
+    while((end < runEnd) && (it != memoryImage.end()) && (end >= it->first) &&
+          (it->second->written[end - it->first] != 0))
+    {
+        end++;
+
+        if (end == (U64(it->first) + MEMORY_IMAGE_PAGE))
+            it++;
+    }
+
+    MetaStreamPayload *payload = MetaStreamPayload::create(U32(end - start));
+    U08 *runData = payload->getData();
+
+    for(U64 a = start; a < end; )
+    {
+        U32 pageAddress = U32(a) & ~(MEMORY_IMAGE_PAGE - 1);
+        U32 pageOffset = U32(a) - pageAddress;
+        U32 bytes = ((end - a) < (MEMORY_IMAGE_PAGE - pageOffset)) ? U32(end - a) : (MEMORY_IMAGE_PAGE - pageOffset);
+
+        memcpy(&runData[a - start], &memoryImage[pageAddress]->data[pageOffset], bytes);
+
+        a += bytes;
+    }
+
+    memoryImageAddress = end;
+
+    return new cgoMetaStream(META_STREAM_PRELOAD, U32(start), payload, 0);
+}
+
+//  Reads the next MetaStream from the trace file.
+cgoMetaStream *TraceDriverMeta::readMetaStream()
+{
+    cgoMetaStream *metaStream;
+
+    if (blockReader != NULL)
+        metaStream = blockReader->next();
+    else
+    {
+        metaStream = new cgoMetaStream(MetaTraceFile);
+
+        //  The MetaStream read at the end of file is not valid.
+        if (MetaTraceFile->eof())
+        {
+            delete metaStream;
+            metaStream = NULL;
+        }
+    }
+
+    traceEnd = (metaStream == NULL);
+
+    return metaStream;
+}
+
 //  Saves in a file the current frame position.
 void TraceDriverMeta::saveTracePosition(fstream *f)
 {
@@ -6,11 +6,13 @@
 
 #include "GPUType.h"
 #include "MetaStream.h"
+#include "MetaStreamBlockFile.h"
 #include "TraceDriverBase.h"
 //#include "GLExec.h"
 #include "zfstream.h"
 #include "RegisterWriteBufferMeta.h"
 #include <cstring>
+#include <map>
 
 /**
  *
@@ -30,10 +32,14 @@ private:
     U32 traceFirstFrame;
     U32 currentFrame;
     gzifstream *MetaTraceFile;
+    arch::cgoMetaStreamBlockReader *blockReader;    ///<  Reader for MetaStream block files, NULL for gzip trace files.
+    bool traceEnd;                                  ///<  Set when the last MetaStream was read from the trace file.
+    bool positioned;                                ///<  Set when the first MetaStream was requested (see seekStartPosition).
     
     enum TracePhase
     {
         TP_PREINIT,             //  Preinitialization phase.  Skip draw, blit and swap commands.
+        TP_LOAD_MEMORY,         //  Memory image load phase.  Preload the memory written by the blocks skipped by the seek.
         TP_LOAD_REGS,           //  Register load phase.  Load the cached GPU register writes into the GPU.
         TP_LOAD_SHADERS,        //  Shader program load phase.  Load the cached shader programs into the GPU.
         TP_CLEARZSTBUFFER,      //  Clear z and stencil buffer phase.
@@ -125,7 +131,58 @@ private:
     U32 vertexProgramPC;             ///<  Stores the vertex program PC GPU register.
     U32 vertexProgramAddress;        ///<  Stores the vertex program address GPU register.
     U32 vertexProgramSize;           ///<  Stores the vertex program size GPU register.
+
+    static const U32 MEMORY_IMAGE_PAGE = 4096;          ///<  Bytes per page of the memory image.
+    static const U32 MEMORY_IMAGE_RUN = 1024 * 1024;    ///<  The memory image preloads don't cross a multiple of this size.
+
+    /**
+     *
+     *  This structure stores a page of the memory image built from the memory writes of the blocks
+     *  skipped by the seek to the start position.
+     *
+     */
+
+    struct MemoryImagePage
+    {
+        U08 data[MEMORY_IMAGE_PAGE];        ///<  Last data written to each byte of the page.
+        U08 written[MEMORY_IMAGE_PAGE];     ///<  Set for the bytes written.
+    };
+
+    std::map<U32, MemoryImagePage*> memoryImage;    ///<  Pages of the memory image indexed by page address.
+    U64 memoryImageAddress;                          ///<  Address from where to search the next memory image preload.
+
+    /**
+     *  Processes a MetaStream from a frame being skipped.  The register writes and the shader programs
+     *  are cached and the memory writes are converted into preloads.  The other MetaStreams are deleted.
+     *  @param metaStream Reference to the pointer to the MetaStream, set to NULL if the MetaStream was deleted.
+     */
+    void skipMetaStream(arch::cgoMetaStream *&metaStream);
+
+    /**
+     *  Seeks the MetaStream block file to the block with the start position (start frame or the
+     *  snapshot position).  The state set by the previous blocks is replayed:  the register writes
+     *  and the shader programs are cached as for the skipped frames and the memory writes are merged
+     *  into the memory image.
+     */
+    void seekStartPosition();
+
+    /**
+     *  Writes the data of a memory write into the memory image.
+     *  @param metaStream Pointer to the memory write MetaStream.
+     */
+    void writeMemoryImage(arch::cgoMetaStream *metaStream);
+
+    /**
+     *  Creates the preload for the next run of written bytes in the memory image.
+     *  @return A pointer to the preload MetaStream, NULL after the last run.
+     */
+    arch::cgoMetaStream *nextMemoryImagePreload();
     
+    /**
+     *  Reads the next MetaStream from the gzip trace file or the block file.
+     *  @return A pointer to the MetaStream, NULL at the end of the trace file.
+     */
+    arch::cgoMetaStream *readMetaStream();
     
 public:
 
@@ -145,6 +202,25 @@ public:
      */
      
     TraceDriverMeta(gzifstream *ProfilingFile, U32 startFrame, U32 traceFirstFrame, U32 maxFrames = 0);
+
+    /**
+     *
+     *  MetaStream Trace Driver Constructor for MetaStream block files.
+     *
+     *  @param blockReader Pointer to an opened MetaStream block file reader.  The Trace Driver
+     *  deletes the reader.
+     *  @param startFrame Start simulation frame.
+     *  @param traceFirstFrame First frame in the MetaStream tracefile.
+     *
+     */
+
+    TraceDriverMeta(arch::cgoMetaStreamBlockReader *blockReader, U32 startFrame, U32 traceFirstFrame, U32 maxFrames = 0);
+
+    /**
+     *  MetaStream Trace Driver destructor.  Deletes the block file reader.
+     */
+
+    ~TraceDriverMeta();
      
     
     /**
@@ -0,0 +1,261 @@
+/**************************************************************************
+ * TraceDriverPipelined.cpp
+ *
+ * Implementation of the pipelined trace driver front-end.
+ */
+
+#include "TraceDriverPipelined.h"
+#include "Timeline.h"
+
+using namespace arch;
+#include "support.h"
+
+TraceDriverPipelined::TraceDriverPipelined(cgoTraceDriverBase* driver, U32 queueSize)
+    : driver_(driver), queueSize_(queueSize), started_(false), producerStarted_(false), stopped_(false), stop_(false),
+      finished_(false), hold_(false), producing_(false), requests_(0), position_(0), consumerStalls_(0), producerStalls_(0)
+{
+    CG_ASSERT_COND((queueSize_ > 0), "The MetaStream queue requires at least one entry.");
+
+    traceTyp = driver_->getTraceTyp();
+    maxFrames_ = driver_->getMaxFrames();
+}
+
+TraceDriverPipelined::~TraceDriverPipelined() {
+    stop();
+    delete driver_;
+}
+
+void TraceDriverPipelined::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    spaceAvailable_.notify_all();
+
+    if (producer_.joinable())
+        producer_.join();
+
+    // Discard the MetaStreams not consumed
+    for (size_t i = 0; i < queue_.size(); i++)
+        delete queue_[i].metaStream;
+    queue_.clear();
+    finished_ = true;
+
+    if (producerStarted_ && !stopped_)
+        DynamicMemoryOpt::endConcurrentAccess();
+
+    stopped_ = true;
+}
+
+int TraceDriverPipelined::startTrace() {
+    if (started_ || stopped_)
+        return 0;
+
+    int result = driver_->startTrace();
+    if (result != 0)
+        return result;
+
+    started_ = true;
+
+    return 0;
+}
+
+void TraceDriverPipelined::startProducer() {
+    // The MetaStreams are created in the producer thread and destroyed by the simulator
+    DynamicMemoryOpt::beginConcurrentAccess();
+    producerStarted_ = true;
+
+    producer_ = std::thread(&TraceDriverPipelined::producerLoop, this);
+}
+
+bool TraceDriverPipelined::drained() const {
+    // Only the end of trace mark is left in the queue
+    return !producing_ && !error_ && (queue_.empty() || (queue_.front().metaStream == nullptr));
+}
+
+bool TraceDriverPipelined::prepareCheckpoint() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!producerStarted_ || stopped_)
+        return true;
+
+    // Wait for the wrapped driver call in progress
+    hold_ = true;
+    dataAvailable_.wait(lock, [this] { return !producing_; });
+
+    return drained();
+}
+
+bool TraceDriverPipelined::saveCheckpoint(std::fstream* f) {
+    bool saved = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // The wrapped driver is only at the simulation position when the queue is drained
+        if (!producerStarted_ || (hold_ && drained()))
+            saved = driver_->saveCheckpoint(f);
+        else
+            CG_WARN("MetaStreams queued by the driver thread, the trace driver checkpoint is not saved.");
+
+        hold_ = false;
+    }
+    spaceAvailable_.notify_one();
+
+    return saved;
+}
+
+bool TraceDriverPipelined::loadCheckpoint(std::fstream* f) {
+    CG_ASSERT_COND(!producerStarted_ && (requests_ == 0), "Checkpoint loaded after the start of the trace.");
+
+    return driver_->loadCheckpoint(f);
+}
+
+void TraceDriverPipelined::producerLoop() {
+    U64 produced = 0;
+
+    TIMELINE_THREAD_NAME("driver")
+
+    try {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+
+                // Backpressure: wait for the simulation to consume MetaStreams.  A checkpoint
+                // holds the producer until it is saved.
+                if (!stop_ && (hold_ || (queue_.size() >= queueSize_))) {
+                    if (!hold_)
+                        producerStalls_++;
+                    spaceAvailable_.wait(lock, [this] { return stop_ || (!hold_ && (queue_.size() < queueSize_)); });
+                }
+
+                if (stop_)
+                    return;
+
+                producing_ = true;
+            }
+
+            // Run the driver stack outside the lock
+            QueueEntry entry;
+            entry.firstCookie = DynamicObject::getNextCookie();
+            entry.metaStream = driver_->nxtMetaStream();
+            entry.position = driver_->getTracePosition();
+            entry.cookies = DynamicObject::getNextCookie() - entry.firstCookie;
+            entry.cookiesReserved = false;
+
+            bool syncRead = (entry.metaStream != nullptr) &&
+                            ((entry.metaStream->GetMetaStreamType() == META_STREAM_READ) ||
+                             (entry.metaStream->GetMetaStreamType() == META_STREAM_REG_READ));
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(entry);
+                producing_ = false;
+                produced++;
+                finished_ = (entry.metaStream == nullptr);
+            }
+            dataAvailable_.notify_one();
+
+            if (entry.metaStream == nullptr)
+                return;  // End of trace
+
+            // The data read is only available after the simulation has processed the read,
+            // wait until the simulation asks for the next MetaStream
+            if (syncRead) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                spaceAvailable_.wait(lock, [this, produced] { return stop_ || (requests_ > produced); });
+
+                if (stop_)
+                    return;
+            }
+        }
+    } catch (...) {
+        // Rethrown in the simulation thread when the queued MetaStreams are consumed
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            producing_ = false;
+            finished_ = true;
+        }
+        dataAvailable_.notify_one();
+    }
+}
+
+arch::cgoMetaStream* TraceDriverPipelined::nxtMetaStream() {
+    CG_ASSERT_COND(started_ || stopped_, "Pipelined trace driver not started.");
+
+    if (!producerStarted_ && !stopped_)
+        startProducer();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (stopped_)
+        return nullptr;
+
+    // The simulation needs a MetaStream not generated yet, release a producer held for a checkpoint
+    if (hold_ && queue_.empty() && !finished_)
+        hold_ = false;
+
+    // Wake up a producer waiting for a read to be processed
+    requests_++;
+    spaceAvailable_.notify_one();
+
+    if (queue_.empty() && !finished_) {
+        consumerStalls_++;
+        dataAvailable_.wait(lock, [this] { return !queue_.empty() || finished_; });
+    }
+
+    if (queue_.empty()) {
+        if (error_)
+            std::rethrow_exception(error_);
+
+        return nullptr;
+    }
+
+    // Reserve the cookies drawn by the driver call as if the call was made from this thread
+    QueueEntry& front = queue_.front();
+    if (!front.cookiesReserved) {
+        CookieRange range;
+        range.producerFirst = front.firstCookie;
+        range.consumerFirst = DynamicObject::reserveCookies(front.cookies);
+        range.count = front.cookies;
+        cookieRanges_.push_back(range);
+        front.cookiesReserved = true;
+    }
+
+    // The end of trace mark stays in the queue
+    QueueEntry entry = front;
+    position_ = entry.position;
+    if (entry.metaStream == nullptr)
+        return nullptr;
+
+    queue_.pop_front();
+    spaceAvailable_.notify_one();
+
+    renumberCookie(entry.metaStream);
+
+    return entry.metaStream;
+}
+
+void TraceDriverPipelined::renumberCookie(cgoMetaStream* metaStream) {
+    U32 numCookies;
+    U32 cookie = metaStream->getCookies(numCookies)[0];
+
+    if (numCookies != 1)
+        return;
+
+    // The MetaStreams are returned in creation order, the ranges before the cookie are not used again
+    while (!cookieRanges_.empty()) {
+        const CookieRange& range = cookieRanges_.front();
+
+        if (cookie < range.producerFirst)
+            return;     // Not drawn in a driver call
+
+        if ((cookie - range.producerFirst) < range.count) {
+            metaStream->setCookie(range.consumerFirst + (cookie - range.producerFirst));
+            return;
+        }
+
+        cookieRanges_.pop_front();
+    }
+}
@@ -0,0 +1,137 @@
+/**************************************************************************
+ * TraceDriverPipelined.h
+ *
+ * Pipelined trace driver front-end.
+ * Runs a trace driver (apitrace decode -> GL/D3D9 -> GAL -> HAL) in a
+ * producer thread that fills a bounded queue of MetaStreams consumed by
+ * the simulation loop.
+ */
+
+#ifndef TRACEDRIVERPIPELINED_H
+#define TRACEDRIVERPIPELINED_H
+
+#include "GPUType.h"
+#include "MetaStream.h"
+#include "TraceDriverBase.h"
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+
+/**
+ * Trace driver front-end running the wrapped driver in its own thread.
+ *
+ * - The producer thread calls nxtMetaStream() of the wrapped driver and queues the
+ *   MetaStreams with the trace position after each one.  It blocks when the queue is full.
+ * - nxtMetaStream() returns the MetaStreams in the same order, so the simulation sees the
+ *   same MetaStream sequence as with the wrapped driver.  getTracePosition() returns the
+ *   position of the last MetaStream returned.
+ * - After a read MetaStream (META_STREAM_READ, META_STREAM_REG_READ) the producer waits
+ *   until the simulation asks for the next MetaStream, the data read is only available
+ *   once the read has been processed.
+ * - Errors (CG_ASSERT) in the producer thread are rethrown by nxtMetaStream() when the
+ *   simulation reaches the failing point.
+ * - The dynamic object cookies drawn by each call to the wrapped driver are reserved from
+ *   the simulation thread generator when the MetaStream of the call is returned, and the
+ *   MetaStream cookie is renumbered into the reserved range, so the cookies (signal trace)
+ *   are the same as running the wrapped driver in the simulation thread.
+ *
+ * - The producer thread is started by the first nxtMetaStream() call, so loadCheckpoint()
+ *   is forwarded to the wrapped driver before any MetaStream is generated.
+ * - prepareCheckpoint() holds the producer between two driver calls.  Once the simulation
+ *   has consumed the MetaStreams queued the wrapped driver is at the position of the last
+ *   MetaStream returned and saveCheckpoint() is forwarded to it, which releases the producer.
+ *
+ * The wrapped driver is started by startTrace() and owned by the front-end.  Dynamic
+ * objects are allocated from both threads while the producer runs (see
+ * DynamicMemoryOpt::beginConcurrentAccess).
+ */
+class TraceDriverPipelined : public cgoTraceDriverBase {
+public:
+    static const U32 DEFAULT_QUEUE_SIZE = 1024;     //  Default number of MetaStreams queued.
+
+    /**
+     * Constructor.
+     * @param driver Trace driver to run in the producer thread (owned by the front-end)
+     * @param queueSize Maximum number of MetaStreams queued
+     */
+    TraceDriverPipelined(cgoTraceDriverBase* driver, U32 queueSize);
+
+    /**
+     * Stops the producer thread and deletes the MetaStreams not consumed and the wrapped driver.
+     */
+    ~TraceDriverPipelined();
+
+    /**
+     * Stops the producer thread and deletes the MetaStreams not consumed.
+     * nxtMetaStream() returns NULL after the producer is stopped.
+     */
+    void stop();
+
+    int startTrace() override;
+    arch::cgoMetaStream* nxtMetaStream() override;
+    U32 getTracePosition() override { return position_; }
+    bool saveCheckpoint(std::fstream* f) override;
+    bool prepareCheckpoint() override;
+
+    /**
+     * Forwarded to the wrapped driver.  Must be called before the first MetaStream is requested.
+     */
+    bool loadCheckpoint(std::fstream* f) override;
+
+    /**
+     * Returns the number of times the simulation had to wait for the producer.
+     */
+    U64 getConsumerStalls() const { return consumerStalls_; }
+
+    /**
+     * Returns the number of times the producer had to wait for the simulation.
+     */
+    U64 getProducerStalls() const { return producerStalls_; }
+
+private:
+    struct QueueEntry {
+        arch::cgoMetaStream* metaStream;    //  NULL marks the end of the trace.
+        U32 position;                       //  Trace position after the MetaStream.
+        U32 firstCookie;                    //  First cookie drawn by the producer in the driver call.
+        U32 cookies;                        //  Cookies drawn by the producer in the driver call.
+        bool cookiesReserved;               //  The cookies were reserved in the simulation thread.
+    };
+
+    //  Cookies drawn by a driver call in the producer and reserved in the simulation thread.
+    struct CookieRange {
+        U32 producerFirst;
+        U32 consumerFirst;
+        U32 count;
+    };
+
+    void startProducer();
+    void producerLoop();
+    bool drained() const;
+    void renumberCookie(arch::cgoMetaStream* metaStream);
+
+    cgoTraceDriverBase* driver_;
+    U32 queueSize_;
+    std::deque<QueueEntry> queue_;
+    std::mutex mutex_;
+    std::condition_variable dataAvailable_;     //  Signaled by the producer.
+    std::condition_variable spaceAvailable_;    //  Signaled by the consumer.
+    std::thread producer_;
+    bool started_;
+    bool producerStarted_;                      //  The producer thread was started (see nxtMetaStream).
+    bool stopped_;                              //  The producer was stopped (see stop).
+    bool stop_;                                 //  Stop the producer.
+    bool finished_;                             //  The producer queued the end of the trace or failed.
+    bool hold_;                                 //  Do not call the wrapped driver (see prepareCheckpoint).
+    bool producing_;                            //  The producer is inside a wrapped driver call.
+    std::exception_ptr error_;                  //  Error raised in the producer thread.
+    U64 requests_;                              //  MetaStreams requested by the consumer.
+    U32 position_;
+    std::deque<CookieRange> cookieRanges_;      //  Ranges of the MetaStreams not returned yet.
+    U64 consumerStalls_;
+    U64 producerStalls_;
+};
+
+#endif // TRACEDRIVERPIPELINED_H
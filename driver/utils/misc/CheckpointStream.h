@@ -0,0 +1,166 @@
+/**************************************************************************
+ *
+ * Helpers used by the driver layers (HAL, GAL, GALx, OGL) to write and read
+ * their state to/from a simulation checkpoint stream.
+ *
+ * Values are stored in the native byte order with the raw
+ * out.write((char *) &value, sizeof(value)) layout used by the rest of
+ * the checkpoint code, so a checkpoint can only be loaded by a binary built
+ * for the same platform.
+ *
+ */
+
+#ifndef CHECKPOINTSTREAM_H
+    #define CHECKPOINTSTREAM_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <type_traits>
+
+namespace checkpoint
+{
+
+template<typename T>
+inline void saveValue(std::ostream& out, const T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be trivially copyable");
+    out.write((const char *) &value, sizeof(T));
+}
+
+template<typename T>
+inline void loadValue(std::istream& in, T& value)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be trivially copyable");
+    in.read((char *) &value, sizeof(T));
+}
+
+template<typename T>
+inline T loadValue(std::istream& in)
+{
+    T value;
+    loadValue(in, value);
+    return value;
+}
+
+/**
+ *  Raw copy of plain data classes that define their own copy operators and so are not
+ *  trivially copyable (vectors, matrices and the state items holding them).
+ */
+template<typename T>
+inline void saveData(std::ostream& out, const T& value)
+{
+    static_assert(std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value, "checkpoint data must be plain data");
+    out.write((const char *) &value, sizeof(T));
+}
+
+template<typename T>
+inline void loadData(std::istream& in, T& value)
+{
+    static_assert(std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value, "checkpoint data must be plain data");
+    in.read((char *) &value, sizeof(T));
+}
+
+inline void saveBytes(std::ostream& out, const void* data, unsigned int size)
+{
+    saveValue(out, size);
+    if ( size > 0 )
+        out.write((const char *) data, size);
+}
+
+/**
+ *  Reads a block written with saveBytes.  The returned buffer is allocated with new[]
+ *  (NULL for empty blocks).
+ */
+inline unsigned char* loadBytes(std::istream& in, unsigned int& size)
+{
+    loadValue(in, size);
+    if ( size == 0 )
+        return 0;
+    unsigned char* data = new unsigned char[size];
+    in.read((char *) data, size);
+    return data;
+}
+
+inline void saveString(std::ostream& out, const std::string& s)
+{
+    saveBytes(out, s.data(), (unsigned int) s.size());
+}
+
+inline std::string loadString(std::istream& in)
+{
+    unsigned int size = loadValue<unsigned int>(in);
+    std::string s(size, '\0');
+    if ( size > 0 )
+        in.read(&s[0], size);
+    return s;
+}
+
+template<typename T>
+inline void saveVector(std::ostream& out, const std::vector<T>& v)
+{
+    saveValue(out, (unsigned int) v.size());
+    for ( unsigned int i = 0; i < v.size(); i++ )
+        saveValue(out, v[i]);
+}
+
+template<typename T>
+inline void loadVector(std::istream& in, std::vector<T>& v)
+{
+    v.resize(loadValue<unsigned int>(in));
+    for ( unsigned int i = 0; i < v.size(); i++ )
+        loadValue(in, v[i]);
+}
+
+inline void saveVector(std::ostream& out, const std::vector<bool>& v)
+{
+    saveValue(out, (unsigned int) v.size());
+    for ( unsigned int i = 0; i < v.size(); i++ )
+        saveValue(out, (bool) v[i]);
+}
+
+inline void loadVector(std::istream& in, std::vector<bool>& v)
+{
+    v.resize(loadValue<unsigned int>(in));
+    for ( unsigned int i = 0; i < v.size(); i++ )
+        v[i] = loadValue<bool>(in);
+}
+
+template<typename T>
+inline void saveSet(std::ostream& out, const std::set<T>& s)
+{
+    saveValue(out, (unsigned int) s.size());
+    for ( typename std::set<T>::const_iterator it = s.begin(); it != s.end(); it++ )
+        saveValue(out, *it);
+}
+
+template<typename T>
+inline void loadSet(std::istream& in, std::set<T>& s)
+{
+    s.clear();
+    unsigned int size = loadValue<unsigned int>(in);
+    for ( unsigned int i = 0; i < size; i++ )
+        s.insert(loadValue<T>(in));
+}
+
+/**
+ *  Writes/checks a section tag.  Used between the layers of a checkpoint so a mismatch
+ *  between the writer and the reader is detected where it happens.
+ */
+inline void saveTag(std::ostream& out, unsigned int tag)
+{
+    saveValue(out, tag);
+}
+
+inline bool checkTag(std::istream& in, unsigned int tag)
+{
+    unsigned int read = 0;
+    loadValue(in, read);
+    return in.good() && (read == tag);
+}
+
+} // namespace checkpoint
+
+#endif // CHECKPOINTSTREAM_H
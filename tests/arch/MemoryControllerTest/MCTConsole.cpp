@@ -5,9 +5,12 @@
 #include "MCTConsole.h"
 #include "MCSplitter.h"
 #include "MCSplitter2.h"
+#include "ChannelTransaction.h"
+#include "DDRBurst.h"
 #include "MemorySpace.h"
 #include <string>
 #include <fstream>
+#include <algorithm>
 
 
 using namespace arch;
@@ -58,6 +61,38 @@ static const char* SendStr =
 "----------------------------------------------------------\n";
 
 
+static const char* StressStr =
+"----------------------------------------------------------\n"
+" STRESS information\n"
+"  Syntax: STRESS REQUESTS [SEED]\n"
+"  Queues a deterministic mix of READ and WRITE requests from\n"
+"  the command processor, streamer, z stencil, color write and\n"
+"  texture units.  Requests mostly walk sequential 64 byte\n"
+"  blocks (row hits) with random jumps (row misses and bank\n"
+"  conflicts).  The same SEED (1 by default) always generates\n"
+"  the same requests\n"
+"----------------------------------------------------------\n";
+
+static const char* VerifyStr =
+"----------------------------------------------------------\n"
+" LOG and VERIFY information\n"
+"  Syntax: LOG LOG_FILE\n"
+"          VERIFY REFERENCE_LOG_FILE\n"
+"  LOG writes a line per transaction sent to or received from\n"
+"  the memory controller (cycle, transaction and data checksum)\n"
+"  VERIFY closes the log and compares it with a reference log\n"
+"  created with LOG, any difference (cycle, order or data)\n"
+"  aborts the test.  VERIFY also checks that all the read\n"
+"  requests have been served and that no channel transactions\n"
+"  or DDR bursts are still alive in the memory controller\n"
+"\n"
+"  Example (reference created with a trusted build):\n"
+"    LOG mct.log\n"
+"    STRESS 4000 7\n"
+"    RUN 100000\n"
+"    VERIFY mct.reference.log\n"
+"----------------------------------------------------------\n";
+
 string MCTConsole::parseParams(const vector<string>& params)
 {
     if ( params.empty() )
@@ -70,6 +105,8 @@ string MCTConsole::parseParams(const vector<string>& params)
         cmd = cmd + " " + *it;
 
     pendingCommands.push_back(cmd);
+
+    return string();
 }
 
 
@@ -266,12 +303,15 @@ bool MCTConsole::processHelpCommand(const vector<string>& params)
         " 'Loadmem': Loads the GDDR memory's contents from a file\n"
         " 'Savemem': Stores the GDDR memory's contents into a file\n"
         " 'Script' : Executes the commands in an input text file\n"
-        "            'repeat' param can be used to execute it N times\n";
+        "            'repeat' param can be used to execute it N times\n"
         " 'Arch'   : Prints information about the current\n"
         "            memory controller architecture simulated\n"
         " 'Stats'  : Prints basic stats about read/write transactions\n"
         " 'MCDebug': Outputs the current debug information of the MC\n"
         " 'Print'  : Outputs data of the last last MT received by a unit\n"
+        " 'Stress' : Sends a deterministic mix of read and write requests\n"
+        " 'Log'    : Logs the transactions sent and received into a file\n"
+        " 'Verify' : Compares the transaction log with a reference log\n"
         "----------------------------------------------------------------\n";
     
 	if ( params.size() > 0 ) {
@@ -282,6 +322,10 @@ bool MCTConsole::processHelpCommand(const vector<string>& params)
             cout << HelpStr;
 		else if ( cmd == "SEND" || cmd == "READ" || cmd == "WRITE" )
             cout << SendStr;
+        else if ( cmd == "STRESS" )
+            cout << StressStr;
+        else if ( cmd == "LOG" || cmd == "VERIFY" )
+            cout << VerifyStr;
         else
             cout << "NO EXTENDED INFORMTATION FOR COMMAND: " << cmd << "\n";
     }
@@ -435,6 +479,190 @@ bool MCTConsole::processSendCommand(const vector<string>& params)
     return true;
 }
 
+bool MCTConsole::processStressCommand(const vector<string>& params)
+{
+    if ( params.empty() ) {
+        cout << " STRESS command requires the number of requests (and optionally a seed)" << endl;
+        return false;
+    }
+
+    U32 requests = MC_INVALID_INTEGER;
+    U32 seed = 1;
+
+    stringstream ss(params[0]);
+    ss >> requests;
+    if ( requests == MC_INVALID_INTEGER || requests == 0 ) {
+        cout << " Error: The number of requests must be a positive integer" << endl;
+        return false;
+    }
+
+    if ( params.size() > 1 ) {
+        stringstream ss2(params[1]);
+        seed = MC_INVALID_INTEGER;
+        ss2 >> seed;
+        if ( seed == MC_INVALID_INTEGER ) {
+            cout << " Error: The seed must be a non-negative integer" << endl;
+            return false;
+        }
+    }
+
+    // Clients generating the requests (texture units and the streamer only read)
+    struct StressClient
+    {
+        GPUUnit unit;
+        U32 subunit;
+        bool writes;
+        U32 nextAddress;
+    };
+
+    vector<StressClient> clients;
+    StressClient sc;
+
+    sc.unit = COMMANDPROCESSOR; sc.subunit = 0; sc.writes = true;
+    clients.push_back(sc);
+    sc.unit = STREAMERFETCH; sc.subunit = 0; sc.writes = false;
+    clients.push_back(sc);
+    for ( U32 i = 0; i < lastData[ZSTENCILTEST].size(); ++i ) {
+        sc.unit = ZSTENCILTEST; sc.subunit = i; sc.writes = true;
+        clients.push_back(sc);
+    }
+    for ( U32 i = 0; i < lastData[COLORWRITE].size(); ++i ) {
+        sc.unit = COLORWRITE; sc.subunit = i; sc.writes = true;
+        clients.push_back(sc);
+    }
+    for ( U32 i = 0; i < lastData[TEXTUREUNIT].size(); ++i ) {
+        sc.unit = TEXTUREUNIT; sc.subunit = i; sc.writes = false;
+        clients.push_back(sc);
+    }
+
+    // Keep the requests in the first 16 MBs of GPU memory (or less if the memory is smaller)
+    const U32 memoryBlocks = (std::min(ArchConfig().mem.memSize, U32(16)) * 1024 * 1024) / 64;
+
+    U64 state = U64(seed) * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    for ( U32 c = 0; c < clients.size(); ++c ) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        clients[c].nextAddress = U32((state >> 33) % memoryBlocks) * 64;
+    }
+
+    U08 data[64];
+
+    for ( U32 r = 0; r < requests; ++r ) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        U32 rnd = U32(state >> 32);
+
+        StressClient& client = clients[rnd % clients.size()];
+
+        // 1 out of 4 requests jumps to a random block
+        if ( ((rnd >> 8) & 0x3) == 0 )
+            client.nextAddress = ((rnd >> 10) % memoryBlocks) * 64;
+
+        U32 address = client.nextAddress;
+        U32 bytes = ((rnd >> 28) == 0) ? 32 : 64;
+        bool write = client.writes && (((rnd >> 24) & 0x3) == 0);
+
+        client.nextAddress = (address + 64) % (memoryBlocks * 64);
+
+        if ( write ) {
+            for ( U32 b = 0; b < bytes; ++b )
+                data[b] = U08('a' + ((r + b) % 26));
+            sendRequest(client.unit, client.subunit, WRITE_REQUEST, bytes, address, data);
+        }
+        else
+            sendRequest(client.unit, client.subunit, READ_REQUEST, bytes, address, 0);
+    }
+
+    cout << " " << requests << " requests queued (seed = " << seed << ")" << endl;
+
+    return true;
+}
+
+bool MCTConsole::processLogCommand(const vector<string>& params)
+{
+    if ( params.size() != 1 ) {
+        cout << " LOG command requires the log file name" << endl;
+        return false;
+    }
+
+    if ( transactionLog.is_open() )
+        transactionLog.close();
+
+    transactionLog.open(params[0].c_str());
+    if ( !transactionLog.is_open() ) {
+        cout << " Error: the log file '" << params[0] << "' could not be created" << endl;
+        return false;
+    }
+
+    transactionLogName = params[0];
+    return true;
+}
+
+bool MCTConsole::processVerifyCommand(const vector<string>& params)
+{
+    if ( params.size() != 1 ) {
+        cout << " VERIFY command requires the reference log file name" << endl;
+        return false;
+    }
+
+    if ( !transactionLog.is_open() ) {
+        cout << " Error: LOG command must be used before VERIFY" << endl;
+        return false;
+    }
+
+    transactionLog.close();
+
+    ifstream current(transactionLogName.c_str());
+    ifstream reference(params[0].c_str());
+
+    if ( !reference ) {
+        cout << " Error: the reference log file '" << params[0] << "' could not be opened" << endl;
+        return false;
+    }
+
+    string currentLine;
+    string referenceLine;
+    U32 line = 0;
+    bool currentEnd = false;
+    bool referenceEnd = false;
+
+    while ( true ) {
+        currentEnd = !getline(current, currentLine);
+        referenceEnd = !getline(reference, referenceLine);
+        if ( currentEnd || referenceEnd )
+            break;
+        ++line;
+        if ( currentLine != referenceLine ) {
+            cout << " Transaction log mismatch at line " << line << "\n"
+                 << "   current:   " << currentLine << "\n"
+                 << "   reference: " << referenceLine << endl;
+            CG_ASSERT("Transaction log differs from the reference log");
+        }
+    }
+
+    if ( currentEnd != referenceEnd ) {
+        cout << " Transaction log mismatch after line " << line << ": the "
+             << (currentEnd ? "current" : "reference") << " log is shorter" << endl;
+        CG_ASSERT("Transaction log differs from the reference log");
+    }
+
+    if ( stats.gpuReadRequestsSent != stats.gpuReadRequestsReceived ||
+         stats.systemReadRequestsSent != stats.systemReadRequestsReceived )
+        CG_ASSERT("Read requests pending at VERIFY (RUN more cycles)");
+
+    if ( ArchConfig().mem.memoryControllerV2 ) {
+        U32 liveTransactions = memorycontroller::ChannelTransaction::countInstances();
+        U32 liveBursts = memorycontroller::DDRBurst::countInstances();
+        if ( liveTransactions != 0 || liveBursts != 0 ) {
+            cout << " Channel transactions alive: " << liveTransactions << "  DDR bursts alive: " << liveBursts << endl;
+            CG_ASSERT("Memory controller objects leaked or still in flight at VERIFY");
+        }
+    }
+
+    cout << " Transaction log matches the reference (" << line << " transactions)" << endl;
+
+    return true;
+}
+
 U32 MCTConsole::parseAddress(string addressStr)
 {
     U32 dots = static_cast<U32>(std::count(addressStr.begin(), addressStr.end(), '.'));
@@ -732,6 +960,12 @@ void MCTConsole::clock_test(U64 cycle)
             processReadCommand(cmdParams);
         else if ( cmd == "WRITE" || cmd == "W" )
             processWriteCommand(cmdParams);
+        else if ( cmd == "STRESS" )
+            processStressCommand(cmdParams);
+        else if ( cmd == "LOG" )
+            processLogCommand(cmdParams);
+        else if ( cmd == "VERIFY" )
+            processVerifyCommand(cmdParams);
         else
             cout << " Unsupported '" << cmd << "' command (command ignored!)" << endl;
     }
@@ -766,6 +1000,13 @@ void MCTConsole::handler_receiveTransaction(U64 cycle, MemoryTransaction* mt)
 
     lastData[unit][subunit] = string(reinterpret_cast<char*>(mt->getData()), mt->getSize());
 
+    if ( transactionLog.is_open() ) {
+        U32 checksum = 0;
+        for ( U32 i = 0; i < mt->getSize(); ++i )
+            checksum = checksum * 31 + mt->getData()[i];
+        transactionLog << cycle << " R " << mt->toString(true) << " sum=" << hex << checksum << dec << "\n";
+    }
+
 
     MemoryControllerTestBase::handler_receiveTransaction(cycle, mt);
 }
@@ -796,6 +1037,9 @@ void MCTConsole::handler_sendTransaction(U64 cycle, MemoryTransaction* mt)
                 CG_ASSERT("Unnexpected type of request sent!");
         }
     }
+    if ( transactionLog.is_open() )
+        transactionLog << cycle << " S " << mt->toString(true) << "\n";
+
     MemoryControllerTestBase::handler_sendTransaction(cycle, mt);
 }
 
@@ -9,6 +9,7 @@
 #include "MemoryRequestSplitter.h"
 #include <vector>
 #include <list>
+#include <fstream>
 
 namespace arch
 {
@@ -51,6 +52,9 @@ private:
     bool processPrintCommand(const std::vector<std::string>& params);
     bool processReadCommand(const std::vector<std::string>& params);
     bool processWriteCommand(const std::vector<std::string>& params);
+    bool processStressCommand(const std::vector<std::string>& params);
+    bool processLogCommand(const std::vector<std::string>& params);
+    bool processVerifyCommand(const std::vector<std::string>& params);
 
 
     static std::string parseUnitName(string unitName, U32& unit, U32& subunit);
@@ -66,6 +70,10 @@ private:
 
     // Last data received from each client
     std::vector<std::string> lastData[LASTGPUBUS];
+
+    // Log of the transactions sent and received (LOG and VERIFY commands)
+    std::ofstream transactionLog;
+    std::string transactionLogName;
     
 
 protected:
@@ -5,7 +5,7 @@
 #include "MemoryControllerTest.h"
 #include "MemoryControllerSelector.h"
 #include "MemoryControllerTestBase.h"
-#include "ConfigLoader.h"
+#include "param_loader.hpp"
 #include "DynamicMemoryOpt.h"
 #include <iostream>
 #include "MCTConsole.h"
@@ -28,13 +28,45 @@ int main(int argc, char **argv)
     cgsArchConfig arch;
 
     // Get signal binder
-    SignalBinder &sigBinder = SignalBinder::getBinder();
+    cmoSignalBinder &sigBinder = cmoSignalBinder::getBinder();
+
+    //  The architecture version (ARCH_VERSION column of archParams.csv) can be selected with MCT_ARCH.
+    const char* archName = getenv("MCT_ARCH");
+    const char* paramFile = "archParams.csv";
+
+    //  Leading options select the parameter file (--param <csv>), the architecture version (--arch <ver>)
+    //  and override parameters (<PARAMETER>=<value>).  The remaining arguments are a console command.
+    vector<pair<string, string> > overrides;
+    int argIndex = 1;
+    while ( argIndex < argc ) {
+        string arg = argv[argIndex];
+        size_t equal = arg.find('=');
+        if ( (arg == "--param") && (argIndex + 1 < argc) ) {
+            paramFile = argv[argIndex + 1];
+            argIndex += 2;
+        }
+        else if ( (arg == "--arch") && (argIndex + 1 < argc) ) {
+            archName = argv[argIndex + 1];
+            argIndex += 2;
+        }
+        else if ( (equal != string::npos) && (equal > 0) ) {
+            overrides.push_back(make_pair(arg.substr(0, equal), arg.substr(equal + 1)));
+            argIndex++;
+        }
+        else
+            break;
+    }
 
-    ConfigLoader cl("archParams.csv");
-    cl.getParameters(&arch);
+    ArchParams::init(paramFile, (archName != NULL) ? archName : "1.0");
+    for ( size_t o = 0; o < overrides.size(); o++ ) {
+        CG_ASSERT_COND(!(ArchParams::instance().get_param_map().find(overrides[o].first) == ArchParams::instance().get_param_map().end()),
+                       "Unknown parameter %s.", overrides[o].first.c_str());
+        ArchParams::instance().set(overrides[o].first, overrides[o].second);
+    }
+    ArchParams::instance().populateArchConfig(&arch);
     
-    DynamicMemoryOpt::initialize(arch.objectSize0, arch.bucketSize0, arch.objectSize1, arch.bucketSize1,
-        arch.objectSize2, arch.bucketSize2);
+    DynamicMemoryOpt::initialize(arch.sim.objectSize0, arch.sim.bucketSize0, arch.sim.objectSize1, arch.sim.bucketSize1,
+        arch.sim.objectSize2, arch.sim.bucketSize2);
 
     
     //  Allocate pointer array for the texture unit prefixes.
@@ -95,10 +127,8 @@ int main(int argc, char **argv)
                                      (const char**)slPrefixes, "MyMCTest", mcProxy, 0);
 
     vector<string> params;
-    if ( argc > 1 ) {
-        for ( int i = 1; i < argc; ++i ) {
-            params.push_back(argv[i]);
-        }
+    for ( int i = argIndex; i < argc; ++i ) {
+        params.push_back(argv[i]);
     }
 
     mctest->parseParams(params);
@@ -114,22 +144,22 @@ int main(int argc, char **argv)
         CG_ASSERT("Signal connections undefined");
     }
 
-    if ( arch.dumpSignalTrace ) {
-        sigTraceFile.open(arch.signalDumpFile, ios::out | ios::binary);
+    if ( arch.sim.dumpSignalTrace ) {
+        sigTraceFile.open(arch.sim.signalDumpFile, ios::out | ios::binary);
         if ( !sigTraceFile.is_open() )
             CG_ASSERT("Error opening signal trace file");
         sigBinder.initSignalTrace(&sigTraceFile);
         cout << "MCT info: !!! GENERATING SIGNAL TRACE !!!" << endl;
     }
 
-    if ( arch.statistics ) {
+    if ( arch.sim.statistics ) {
         //  Initialize the statistics manager.  
-        out.open(arch.statsFile, ios::out | ios::binary);
+        out.open(arch.sim.statsFile, ios::out | ios::binary);
 
         if ( !out.is_open() )
             CG_ASSERT("Error opening per cycle statistics file");
 
-        gpuStatistics::StatisticsManager::instance().setDumpScheduling(0, arch.statsRate);
+        gpuStatistics::StatisticsManager::instance().setDumpScheduling(0, arch.sim.statsRate);
         gpuStatistics::StatisticsManager::instance().setOutputStream(out);
     }
 
@@ -155,12 +185,12 @@ int main(int argc, char **argv)
         
         if ( !multiClock ) // Unified clock domain clocking
         {
-            if ( arch.dumpSignalTrace ) // Dump the signals
+            if ( arch.sim.dumpSignalTrace ) // Dump the signals
                 sigBinder.dumpSignalTrace(cycle);
             cyclesCounter->inc();
             mc->clock(cycle);
             mctest->clock(cycle);
-            if ( arch.statistics ) // Update GPU Statistics
+            if ( arch.sim.statistics ) // Update GPU Statistics
                 gpuStatistics::StatisticsManager::instance().clock(cycle);
             cycle ++;
 
@@ -179,7 +209,7 @@ int main(int argc, char **argv)
                 cyclesCounter->inc();
                 mctest->clock(gpuCycle);
                 static_cast<memorycontroller::MemoryController*>(mc)->clock(GPU_CLOCK_DOMAIN, gpuCycle);
-                if ( arch.statistics ) // Update GPU Statistics
+                if ( arch.sim.statistics ) // Update GPU Statistics
                     gpuStatistics::StatisticsManager::instance().clock(gpuCycle);
 
                 if ( gpuCycle % 1000 == 0 ){
@@ -199,7 +229,7 @@ int main(int argc, char **argv)
     }
 
     // Signal trace finished
-    if ( arch.dumpSignalTrace ) 
+    if ( arch.sim.dumpSignalTrace ) 
         sigBinder.endSignalTrace();
 
     //DynamicMemoryOpt::usage();
@@ -12,7 +12,7 @@
 #include <queue>
 #include "MemoryTransaction.h"
 #include "MemoryControllerCommand.h"
-#include "ConfigLoader.h"
+#include "archParams.h"
 #include "MemoryControllerProxy.h"
 
 namespace arch {
@@ -0,0 +1,310 @@
+/**************************************************************************
+ *
+ *  Clock scheduler tick order test.
+ *
+ *  Usage: testClockScheduler
+ *
+ *  Replays the clock calls issued by cmoClockScheduler, driven as in
+ *  PerfModel::simulationLoop and PerfModel::advanceTime, against the countdown
+ *  loops of the previous single clock and multi clock simulation loops:
+ *
+ *   - the single clock architecture (one domain with period 1),
+ *   - the GPU, shader and memory clock domains with equal, multiple and
+ *     unrelated periods, with and without the shader and memory domains.
+ *
+ *  The clock calls (mdu, clock domain, cycle) must be issued in the same
+ *  order, including the shader and memory ticks at the time of the last
+ *  GPU tick.
+ *
+ */
+
+#include "ClockScheduler.h"
+#include "MduBase.h"
+#include "MultiClockMdu.h"
+#include "GPUReg.h"
+#include "GPUMath.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace arch;
+
+//  Clock call issued to a test mdu.
+struct ClockCall
+{
+    U32 mdu;
+    U32 domain;
+    U64 cycle;
+
+    bool operator==(const ClockCall &c) const { return (mdu == c.mdu) && (domain == c.domain) && (cycle == c.cycle); }
+};
+
+static std::vector<ClockCall> calls;
+
+class TestMdu : public cmoMduBase
+{
+public:
+
+    TestMdu(const char *name, U32 id) : cmoMduBase(name, 0), id(id) {}
+
+    void clock(U64 cycle)
+    {
+        ClockCall c = {id, GPU_CLOCK_DOMAIN, cycle};
+        calls.push_back(c);
+    }
+
+private:
+
+    U32 id;
+};
+
+class TestMultiClockMdu : public cmoMduMultiClk
+{
+public:
+
+    TestMultiClockMdu(const char *name, U32 id) : cmoMduMultiClk(name, 0), id(id) {}
+
+    void clock(U64 cycle)
+    {
+        clock(GPU_CLOCK_DOMAIN, cycle);
+    }
+
+    void clock(U32 domain, U64 cycle)
+    {
+        ClockCall c = {id, domain, cycle};
+        calls.push_back(c);
+    }
+
+private:
+
+    U32 id;
+};
+
+//  Test configuration of the clock domains.
+struct ClockConfig
+{
+    bool multiClock;
+    U32 gpuPeriod;
+    U32 shaderPeriod;
+    U32 memoryPeriod;
+    bool shaderClockDomain;
+    bool memoryClockDomain;
+};
+
+static TestMdu *gpuMdus[2];
+static TestMultiClockMdu *shaderMdus[2];
+static TestMultiClockMdu *memoryMdus[2];
+
+//  Previous single clock and multi clock simulation loops.  The simulation ends at a GPU tick,
+//  the multi clock loop completes the step of the last GPU tick.
+static void countdownLoop(const ClockConfig &config, U64 gpuCycles)
+{
+    if (!config.multiClock)
+    {
+        for(U64 cycle = 0; cycle < gpuCycles; cycle++)
+        {
+            for(U32 m = 0; m < 2; m++)
+                gpuMdus[m]->clock(cycle);
+            for(U32 m = 0; m < 2; m++)
+                shaderMdus[m]->clock(cycle);
+            for(U32 m = 0; m < 2; m++)
+                memoryMdus[m]->clock(cycle);
+        }
+
+        return;
+    }
+
+    U64 gpuCycle = 0;
+    U64 shaderCycle = 0;
+    U64 memoryCycle = 0;
+    U32 nextGPUClock = config.gpuPeriod;
+    U32 nextShaderClock = config.shaderPeriod;
+    U32 nextMemoryClock = config.memoryPeriod;
+    bool end = false;
+
+    while(!end)
+    {
+        U32 nextStep = GPU_MIN(GPU_MIN(nextGPUClock, nextShaderClock), nextMemoryClock);
+
+        nextGPUClock -= nextStep;
+        nextShaderClock -= nextStep;
+        nextMemoryClock -= nextStep;
+
+        if (nextGPUClock == 0)
+        {
+            for(U32 m = 0; m < 2; m++)
+                gpuMdus[m]->clock(gpuCycle);
+            for(U32 m = 0; m < 2; m++)
+                shaderMdus[m]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
+            for(U32 m = 0; m < 2; m++)
+                memoryMdus[m]->clock(GPU_CLOCK_DOMAIN, gpuCycle);
+
+            gpuCycle++;
+            nextGPUClock = config.gpuPeriod;
+            end = (gpuCycle == gpuCycles);
+        }
+
+        if (nextShaderClock == 0)
+        {
+            if (config.shaderClockDomain)
+            {
+                for(U32 m = 0; m < 2; m++)
+                    shaderMdus[m]->clock(SHADER_CLOCK_DOMAIN, shaderCycle);
+                shaderCycle++;
+            }
+
+            nextShaderClock = config.shaderPeriod;
+        }
+
+        if (nextMemoryClock == 0)
+        {
+            if (config.memoryClockDomain)
+            {
+                for(U32 m = 0; m < 2; m++)
+                    memoryMdus[m]->clock(MEMORY_CLOCK_DOMAIN, memoryCycle);
+                memoryCycle++;
+            }
+
+            nextMemoryClock = config.memoryPeriod;
+        }
+    }
+}
+
+//  Same domain definition as the PerfModel constructor.  In the single clock architecture all the
+//  mdus are single clock mdus (MduArray).
+static void defineDomains(cmoClockScheduler &scheduler, const ClockConfig &config)
+{
+    if (!config.multiClock)
+    {
+        scheduler.addDomain("GPU", GPU_CLOCK_DOMAIN, 1);
+        for(U32 m = 0; m < 2; m++)
+            scheduler.addMdu(0, (cmoMduBase *) gpuMdus[m]);
+        for(U32 m = 0; m < 2; m++)
+            scheduler.addMdu(0, (cmoMduBase *) shaderMdus[m]);
+        for(U32 m = 0; m < 2; m++)
+            scheduler.addMdu(0, (cmoMduBase *) memoryMdus[m]);
+    }
+    else
+    {
+        U32 gpuDomain = scheduler.addDomain("GPU", GPU_CLOCK_DOMAIN, config.gpuPeriod);
+        for(U32 m = 0; m < 2; m++)
+            scheduler.addMdu(gpuDomain, (cmoMduBase *) gpuMdus[m]);
+        for(U32 m = 0; m < 2; m++)
+            scheduler.addMdu(gpuDomain, shaderMdus[m]);
+        for(U32 m = 0; m < 2; m++)
+            scheduler.addMdu(gpuDomain, memoryMdus[m]);
+
+        if (config.shaderClockDomain)
+        {
+            U32 shaderDomain = scheduler.addDomain("Shader", SHADER_CLOCK_DOMAIN, config.shaderPeriod);
+            for(U32 m = 0; m < 2; m++)
+                scheduler.addMdu(shaderDomain, shaderMdus[m]);
+        }
+
+        if (config.memoryClockDomain)
+        {
+            U32 memoryDomain = scheduler.addDomain("Memory", MEMORY_CLOCK_DOMAIN, config.memoryPeriod);
+            for(U32 m = 0; m < 2; m++)
+                scheduler.addMdu(memoryDomain, memoryMdus[m]);
+        }
+    }
+
+    scheduler.reset();
+}
+
+//  Issues the ticks at the time of the last main clock domain tick (PerfModel::clockSameTime).
+static void clockSameTime(cmoClockScheduler &scheduler)
+{
+    U64 mainTime = scheduler.getTime(0);
+
+    while(scheduler.peekTime() == mainTime)
+        scheduler.clock(scheduler.next());
+}
+
+//  Clock scheduler driven as PerfModel::simulationLoop (sameTime false) or PerfModel::advanceTime (sameTime true).
+static void schedulerLoop(const ClockConfig &config, U64 gpuCycles, bool sameTime)
+{
+    cmoClockScheduler scheduler;
+    defineDomains(scheduler, config);
+
+    for(U64 cycle = 0; cycle < gpuCycles; cycle++)
+    {
+        U32 domain;
+
+        do
+        {
+            domain = scheduler.next();
+            scheduler.clock(domain);
+        }
+        while(domain != 0);
+
+        if (sameTime)
+            clockSameTime(scheduler);
+    }
+
+    clockSameTime(scheduler);
+}
+
+int main()
+{
+    for(U32 m = 0; m < 2; m++)
+    {
+        char name[32];
+        sprintf(name, "GpuMdu%d", m);
+        gpuMdus[m] = new TestMdu(name, m);
+        sprintf(name, "ShaderMdu%d", m);
+        shaderMdus[m] = new TestMultiClockMdu(name, 2 + m);
+        sprintf(name, "MemoryMdu%d", m);
+        memoryMdus[m] = new TestMultiClockMdu(name, 4 + m);
+    }
+
+    const ClockConfig configs[] =
+    {
+        {false, 1, 1, 1, false, false},
+        {true, 1000, 1000, 1000, true, true},
+        {true, 1000, 500, 250, true, true},
+        {true, 1000, 2000, 4000, true, true},
+        {true, 1000, 700, 400, true, true},
+        {true, 3, 2, 5, true, true},
+        {true, 2500, 1250, 3333, true, true},
+        {true, 1000, 700, 400, false, true},
+        {true, 1000, 700, 400, true, false},
+        {true, 1000, 700, 400, false, false},
+    };
+
+    const U64 gpuCycles[] = {1, 2, 7, 1000};
+
+    U32 errors = 0;
+
+    for(U32 c = 0; c < (sizeof(configs) / sizeof(configs[0])); c++)
+    {
+        for(U32 n = 0; n < (sizeof(gpuCycles) / sizeof(gpuCycles[0])); n++)
+        {
+            calls.clear();
+            countdownLoop(configs[c], gpuCycles[n]);
+            std::vector<ClockCall> reference = calls;
+
+            for(U32 sameTime = 0; sameTime < 2; sameTime++)
+            {
+                calls.clear();
+                schedulerLoop(configs[c], gpuCycles[n], sameTime != 0);
+
+                if (!(calls == reference))
+                {
+                    size_t i = 0;
+                    while((i < calls.size()) && (i < reference.size()) && (calls[i] == reference[i]))
+                        i++;
+
+                    printf("FAILED: periods %d/%d/%d, %lld GPU cycles, %s: %d clock calls (expected %d), first difference at call %d\n",
+                           configs[c].gpuPeriod, configs[c].shaderPeriod, configs[c].memoryPeriod, gpuCycles[n],
+                           sameTime ? "advanceTime" : "simulationLoop", U32(calls.size()), U32(reference.size()), U32(i));
+                    errors++;
+                }
+            }
+        }
+    }
+
+    printf("%s\n", (errors == 0) ? "PASSED" : "FAILED");
+
+    return (errors == 0) ? 0 : 1;
+}
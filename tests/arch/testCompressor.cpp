@@ -1,116 +1,248 @@
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
+/**************************************************************************
+ *
+ *  Color and depth block compressor round trip test.
+ *
+ *  Usage: testCompressor [corpus file]...
+ *
+ *  Compresses and uncompresses blocks with the compressors created by
+ *  bmoColorCompressor and bmoDepthCompressor:
+ *
+ *   - every single bit change of every element of flat blocks (hilo levels and
+ *     the reordering of the bits),
+ *   - every two color pattern of a 16 sample subblock (msaa levels),
+ *   - depth planes, flat, two and four color blocks, clustered values, values
+ *     around 0 and 0xffffffff and noise,
+ *   - the blocks captured with --capture-blocks (corpus files).
+ *
+ *  The uncompressed blocks must be equal to the original blocks and every kernel
+ *  implementation supported by the CPU must produce the same compressed blocks
+ *  than the scalar kernels.
+ *
+ */
 
-//#include "bmoHiloCompressor.h"
-#include "bmoMsaaCompressor.h"
+#include "HiloCompressor.h"
+#include "MsaaCompressor.h"
+#include "ColorCompressor.h"
+#include "DepthCompressor.h"
+#include "CompressorKernels.h"
+#include "BlockCorpus.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
 
 using namespace arch;
 
-int fd;
-bool eof = false;
-
-int next() {
-	char b[4];
-	int s = read(fd, b, 4);
-	eof = s <= 0;
-	int d = b[3] << 24
-			| b[2] << 16
-			| b[1] << 8
-			| b[0];
-	return d;
+static const U32 BLOCK_ELEMENTS = 64;
+
+struct TestCompressor
+{
+    const char *name;
+    bmoCompressor *scalar;                      //  Compressor using the scalar kernels.
+    std::vector<bmoCompressor *> kernels;       //  Compressors using the other kernels.
+    U32 levels[8];                              //  Blocks compressed per level (last entry:  not compressed).
+};
+
+static U32 errors = 0;
+
+static void testBlock(TestCompressor &test, const U32 *block)
+{
+    U32 compressed[BLOCK_ELEMENTS];
+    U32 output[BLOCK_ELEMENTS];
+
+    memset(compressed, 0, sizeof(compressed));
+    CompressorInfo info = test.scalar->compress(block, compressed, BLOCK_ELEMENTS);
+    test.levels[info.success ? info.level : 7]++;
+
+    if (info.success)
+    {
+        test.scalar->uncompress(compressed, output, BLOCK_ELEMENTS, info.level);
+
+        if (memcmp(output, block, sizeof(output)) != 0)
+        {
+            if (errors++ < 10)
+                printf("ERROR: %s round trip mismatch (level %d).\n", test.name, info.level);
+        }
+    }
+
+    for(size_t k = 0; k < test.kernels.size(); k++)
+    {
+        U32 kernelCompressed[BLOCK_ELEMENTS];
+        memset(kernelCompressed, 0, sizeof(kernelCompressed));
+        CompressorInfo kernelInfo = test.kernels[k]->compress(block, kernelCompressed, BLOCK_ELEMENTS);
+
+        bool match = (kernelInfo.success == info.success) && (kernelInfo.level == info.level) &&
+                     (kernelInfo.size == info.size) &&
+                     (memcmp(kernelCompressed, compressed, sizeof(compressed)) == 0);
+
+        if (match && info.success)
+        {
+            test.kernels[k]->uncompress(compressed, output, BLOCK_ELEMENTS, info.level);
+            match = (memcmp(output, block, sizeof(output)) == 0);
+        }
+
+        if (!match && (errors++ < 10))
+            printf("ERROR: %s kernels %u differ from the scalar kernels.\n", test.name, U32(k + 1));
+    }
 }
 
-void readline(U32* data, int size) {
-	char b[size*4];
-	int s = read(fd, b, size*4);
-	for (int i = 0; i < size; i++) {
-		int p = i * 4;
-		int d = b[p+3] << 24 | b[p+2] << 16
-					| b[p+1] << 8 | b[p+0];
-		data[i] = d;
-	}
+static U64 state = 0x9e3779b97f4a7c15ULL;
+
+static U32 random32()
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return U32(state >> 32);
 }
 
-class cl {
-	int m1, m2;
-};
+static void testBitChanges(TestCompressor &test)
+{
+    static const U32 bases[] = {0x00000000, 0xffffffff, 0x80000000, 0x7fffffff, 0x12345678, 0xff204080};
+
+    U32 block[BLOCK_ELEMENTS];
+
+    for(U32 b = 0; b < sizeof(bases) / sizeof(U32); b++)
+        for(U32 e = 0; e < BLOCK_ELEMENTS; e++)
+            for(U32 bit = 0; bit < 32; bit++)
+            {
+                for(U32 i = 0; i < BLOCK_ELEMENTS; i++)
+                    block[i] = bases[b];
+                block[e] ^= 1U << bit;
+                testBlock(test, block);
+            }
+}
+
+static void testSubblockPatterns(TestCompressor &test)
+{
+    U32 block[BLOCK_ELEMENTS];
+
+    for(U32 mask = 0; mask < 0x10000; mask++)
+    {
+        U32 ref1 = random32();
+        U32 ref2 = ((mask & 0x0f) == 0x05) ? random32() : (ref1 ^ (1U << (mask & 0x1f)));
+
+        for(U32 i = 0; i < BLOCK_ELEMENTS; i++)
+        {
+            U32 pattern = (mask >> (i & 0x0f)) & 1;
+
+            //  Subblocks with a third color for some masks.
+            block[i] = (((mask & 0x300) == 0x300) && (i == ((mask >> 10) & 0x3f))) ? ~ref1 :
+                       ((pattern != 0) ? ref2 : ref1);
+        }
+
+        testBlock(test, block);
+    }
+}
+
+static void testSyntheticBlocks(TestCompressor &test)
+{
+    U32 block[BLOCK_ELEMENTS];
+
+    for(U32 n = 0; n < 50000; n++)
+    {
+        U32 base = random32();
+        U32 other = random32();
+        U32 shift = random32() % 32;
+        U32 dx = random32() % 64;
+        U32 dy = random32() % 64;
+
+        for(U32 i = 0; i < BLOCK_ELEMENTS; i++)
+        {
+            U32 x = i & 0x07;
+            U32 y = i >> 3;
+
+            switch(n % 8)
+            {
+                case 0: block[i] = random32(); break;
+                case 1: block[i] = base; break;
+                case 2: block[i] = base + x * dx + y * dy; break;
+                case 3: block[i] = base + ((random32() % 3) << shift); break;
+                case 4: block[i] = ((random32() & 1) != 0) ? base : other; break;
+                case 5: block[i] = ((n & 8) != 0) ? (0xffffffff - random32() % 300) : (random32() % 300); break;
+                case 6: block[i] = base + (random32() & ((1U << (n % 24)) - 1)); break;
+                case 7: block[i] = (((i >> 2) % 3) == 0) ? base : ((((i >> 1) & 1) != 0) ? other : ~base); break;
+            }
+        }
+
+        testBlock(test, block);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    U32 numKernels;
+    const bmoCompressorKernels *const *kernels = bmoCompressorKernels::getAvailable(numKernels);
+
+    //  Same configurations as bmoColorCompressor::configureCompressor and bmoDepthCompressor::configureCompressor.
+    TestCompressor tests[4];
+    tests[0].name = "hilo";
+    tests[1].name = "hilore";
+    tests[2].name = "msaa";
+    tests[3].name = "hiloz";
+
+    for(U32 k = 0; k < numKernels; k++)
+    {
+        bmoHiloCompressor *hilo = new bmoHiloCompressor(2, bmoColorCompressor::colorMask, false);
+        bmoHiloCompressor *hilore = new bmoHiloCompressor(3, bmoColorCompressor::colorMask, true);
+        bmoMsaaCompressor *msaa = new bmoMsaaCompressor(bmoColorCompressor::blockSize);
+        bmoHiloCompressor *hiloz = new bmoHiloCompressor(bmoDepthCompressor::levels, bmoDepthCompressor::depthMask, false);
+
+        hilo->setKernels(*kernels[k]);
+        hilore->setKernels(*kernels[k]);
+        msaa->setKernels(*kernels[k]);
+        hiloz->setKernels(*kernels[k]);
+
+        bmoCompressor *compressors[4] = {hilo, hilore, msaa, hiloz};
+
+        for(U32 t = 0; t < 4; t++)
+        {
+            if (k == 0)
+                tests[t].scalar = compressors[t];
+            else
+                tests[t].kernels.push_back(compressors[t]);
+        }
+    }
+
+    printf("Kernels:");
+    for(U32 k = 0; k < numKernels; k++)
+        printf(" %s", kernels[k]->name);
+    printf("\n");
+
+    std::vector<U32> corpus;
+    for(int a = 1; a < argc; a++)
+    {
+        S32 loaded = bmoBlockCorpus::load(argv[a], BLOCK_ELEMENTS, corpus);
+
+        if (loaded < 0)
+        {
+            printf("ERROR: opening corpus file %s\n", argv[a]);
+            return -1;
+        }
+
+        printf("Corpus %s : %d blocks\n", argv[a], loaded);
+    }
+
+    for(U32 t = 0; t < 4; t++)
+    {
+        memset(tests[t].levels, 0, sizeof(tests[t].levels));
+
+        testBitChanges(tests[t]);
+        testSubblockPatterns(tests[t]);
+        testSyntheticBlocks(tests[t]);
+
+        for(size_t b = 0; b < corpus.size(); b += BLOCK_ELEMENTS)
+            testBlock(tests[t], &corpus[b]);
+
+        printf("%-8s level 0 : %7u level 1 : %7u level 2 : %7u level 3 : %7u level 4 : %7u uncompressed : %7u\n",
+               tests[t].name, tests[t].levels[0], tests[t].levels[1], tests[t].levels[2], tests[t].levels[3],
+               tests[t].levels[4], tests[t].levels[7]);
+    }
+
+    if (errors != 0)
+    {
+        printf("FAILED: %u errors.\n", errors);
+        return -1;
+    }
 
-int main() {
-	U32 data1[64];
-	U32 data2[64];
-	U32 cdata1[64];
-	U32 cdata2[64];
-	
-	//bmoHiloCompressor compr(3, 0xffffffff);
-	bmoMsaaCompressor compr(64);
-
-	fd = open("cdata.bin", O_RDONLY);
-	if (fd < 0) {
-		printf("\nERROR: opening data file!!!\n");
-		exit(-1);
-	}
-
-	int lines = 0;
-	
-	while (!eof) {
-		int size = next();
-		readline(data1, size);
-		lines++;
-		
-		if (lines > 0 && size > 0)
-		{
-			printf(">");
-			/*for (int i = 0; i < size; i++)
-				printf("%08x ", data1[i]);
-			printf("(%i)", size);*/
-			
-			memset(cdata1, 0, size*4);
-			CompressorInfo info = compr.compress(data1, cdata1, size);
-			
-			printf(" level=%i  csize=%i\n", info.level, info.size);
-			
-			/*printf("*");
-			for (int i = 0; i < info.size / 4; i++)
-				printf("%08x ", cdata[i]);
-			printf("\n");*/
-			
-			if (info.success) {
-				memset(cdata2, 0, size*4);
-				memcpy(cdata2, cdata1, info.size);
-				
-				//printf("+");
-				memset(data2, 0, size*4);
-				CompressorInfo info2 = compr.uncompress(cdata2, data2, size, info.level);
-				
-				if (info2.level != info.level) {
-					printf("\nERROR: different levels!!!\n");
-					exit(-1);
-				}
-				for (int i = 0; i < size; i++) {
-					//printf("%08x ", data2[i]);
-					if (data1[i] != data2[i]) {
-						printf("\nERROR: data differences!!!\n");
-						memset(cdata1, 0, size*4);
-						CompressorInfo info = compr.compress(data1, cdata1, size);
-						
-						memset(cdata2, 0, size*4);
-						memcpy(cdata2, cdata1, info.size);
-										
-						memset(data2, 0, size*4);
-						compr.uncompress(cdata2, data2, size, info.level);
-						exit(-1);
-					}
-				}
-				//printf("\n\n");
-			}
-			else {
-				//printf("-");
-			}
-		}
-	}
-	
-	close(fd);
-	return 0;
+    printf("PASSED.\n");
+    return 0;
 }
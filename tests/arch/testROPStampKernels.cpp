@@ -0,0 +1,590 @@
+/**************************************************************************
+ *
+ *  ROP stamp kernels test.
+ *
+ *  Checks that the stamp wide kernels of the ROP stages (ROPStampKernels) are bit-exact with
+ *  the per pixel scalar reference:  the color conversions of the behavior model (see
+ *  bmoGpuTop::colorRGBA8ToRGBA32F, ..., bmoGpuTop::colorSRGBToLinear), GPU_CLAMP and
+ *  bmoFragmentOperator::blend and logicOp.
+ *
+ *  Every kernel is tested with randomized stamps for all the MSAA sample counts.  The pixel
+ *  counts that are not a multiple of the SIMD width are also tested for the conversion, clamp
+ *  and mask kernels so the remainder pixels go through the scalar code of the kernels.  The
+ *  random color values include out of range values, -0, denormals, float16 denormals, infinite
+ *  and NaN.
+ *
+ */
+
+#include "GPUType.h"
+#include "GPUMath.h"
+#include "ROPStampKernels.h"
+#include "bmFragmentOperator.h"
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+using namespace arch;
+
+//  Number of random stamps tested for each configuration.
+static const U32 RANDOM_STAMPS = 64;
+
+//  Number of blend equation modes (BLEND_FUNC_ADD to BLEND_MAX) and blend functions.
+static const U32 BLEND_EQUATIONS = 5;
+static const U32 BLEND_FUNCTIONS = 15;
+
+//  Number of logic operation modes (LOGICOP_CLEAR to LOGICOP_SET).
+static const U32 LOGIC_OPS = 16;
+
+#define GAMMA(x) F32(GPU_POWER(F64(x), F64(1.0f / 2.2f)))
+#define LINEAR(x) F32(GPU_POWER(F64(x), F64(2.2f)))
+
+static U64 state64 = 0x0123456789ABCDEFULL;
+
+static U32 random32()
+{
+    state64 = state64 * 6364136223846793005ULL + 1442695040888963407ULL;
+    return U32(state64 >> 32);
+}
+
+static F32 fromBits(U32 bits)
+{
+    F32 f;
+    memcpy(&f, &bits, sizeof(F32));
+    return f;
+}
+
+static U32 toBits(F32 f)
+{
+    U32 bits;
+    memcpy(&bits, &f, sizeof(U32));
+    return bits;
+}
+
+//  Returns a random color component value, mostly in [0, 1].
+static F32 randomComponent()
+{
+    U32 r = random32();
+
+    switch(r & 0x0F)
+    {
+        case 0:     return F32(S32(r >> 8) - 0x400000) / F32(0x200000);    //  [-2, 2]
+        case 1:     return fromBits(random32());                            //  Any value, including NaN.
+        case 2:     return fromBits((r >> 8) & 0x007FFFFF);                 //  Float32 denormal.
+        case 3:     return F32((r >> 8) & 0xFFFF) * 1.0e-9f;                //  Float16 denormal.
+        case 4:     return F32((r >> 8) & 0xFFFF) * 2.0f;                   //  Float16 overflow.
+
+        case 5:
+            switch((r >> 8) & 0x07)
+            {
+                case 0:     return 0.0f;
+                case 1:     return -0.0f;
+                case 2:     return 1.0f;
+                case 3:     return -1.0f;
+                case 4:     return std::numeric_limits<F32>::infinity();
+                case 5:     return -std::numeric_limits<F32>::infinity();
+                case 6:     return std::numeric_limits<F32>::quiet_NaN();
+                default:    return -std::numeric_limits<F32>::quiet_NaN();
+            }
+
+        default:    return F32(r >> 8) / F32(0x00FFFFFF);                   //  [0, 1]
+    }
+}
+
+static void randomStamp(ROPColorStamp &stamp, U32 pixels)
+{
+    for(U32 c = 0; c < 4; c++)
+        for(U32 p = 0; p < pixels; p++)
+            stamp.component[c][p] = randomComponent();
+}
+
+static void randomData(U08 *data, U32 bytes)
+{
+    for(U32 b = 0; b < bytes; b++)
+        data[b] = U08(random32() >> 24);
+}
+
+//  Reference conversion from render target data to RGBA32F for a pixel.
+static void decodePixel(TextureFormat format, bool sRGB, const U08 *in, U32 p, F32 *out)
+{
+    switch(format)
+    {
+        case GPU_RGBA8888:
+            for(U32 c = 0; c < 4; c++)
+                out[c] = F32(in[p * 4 + c]) * (1.0f / 255.0f);
+            break;
+
+        case GPU_RGBA16:
+            for(U32 c = 0; c < 4; c++)
+                out[c] = F32(((const U16 *) in)[p * 4 + c]) * (1.0f / 65535.0f);
+            break;
+
+        case GPU_RGBA16F:
+            for(U32 c = 0; c < 4; c++)
+                out[c] = GPUMath::convertFP16ToFP32(((const U16 *) in)[p * 4 + c]);
+            break;
+
+        case GPU_RG16F:
+            out[0] = GPUMath::convertFP16ToFP32(((const U16 *) in)[p * 2]);
+            out[1] = GPUMath::convertFP16ToFP32(((const U16 *) in)[p * 2 + 1]);
+            out[2] = 0.0f;
+            out[3] = 1.0f;
+            break;
+
+        case GPU_R32F:
+            memcpy(&out[0], &in[p * 4], sizeof(F32));
+            out[1] = 0.0f;
+            out[2] = 0.0f;
+            out[3] = 1.0f;
+            break;
+
+        default:
+            CG_ASSERT("Unsupported render target format.");
+            break;
+    }
+
+    if (sRGB)
+        for(U32 c = 0; c < 3; c++)
+            out[c] = LINEAR(out[c]);
+}
+
+//  Reference conversion from RGBA32F to render target data for a pixel.
+static void encodePixel(TextureFormat format, bool sRGB, const F32 *in, U32 p, U08 *out)
+{
+    F32 color[4];
+
+    for(U32 c = 0; c < 4; c++)
+        color[c] = in[c];
+
+    if (sRGB)
+        for(U32 c = 0; c < 3; c++)
+            color[c] = GAMMA(color[c]);
+
+    switch(format)
+    {
+        case GPU_RGBA8888:
+            for(U32 c = 0; c < 4; c++)
+                out[p * 4 + c] = U08(255.0f * GPU_CLAMP(color[c], 0.0f, 1.0f));
+            break;
+
+        case GPU_RGBA16:
+            for(U32 c = 0; c < 4; c++)
+                ((U16 *) out)[p * 4 + c] = U16(65535.0f * GPU_CLAMP(color[c], 0.0f, 1.0f));
+            break;
+
+        case GPU_RGBA16F:
+            for(U32 c = 0; c < 4; c++)
+                ((U16 *) out)[p * 4 + c] = GPUMath::convertFP32ToFP16(color[c]);
+            break;
+
+        case GPU_RG16F:
+            ((U16 *) out)[p * 2]     = GPUMath::convertFP32ToFP16(color[0]);
+            ((U16 *) out)[p * 2 + 1] = GPUMath::convertFP32ToFP16(color[1]);
+            break;
+
+        case GPU_R32F:
+            memcpy(&out[p * 4], &color[0], sizeof(F32));
+            break;
+
+        default:
+            CG_ASSERT("Unsupported render target format.");
+            break;
+    }
+}
+
+class KernelTester
+{
+private:
+
+    const char *name;
+    U32 tested;
+    U32 errors;
+
+public:
+
+    KernelTester(const char *name) : name(name), tested(0), errors(0)
+    {
+    }
+
+    //  Compares the color of a stamp with the reference color.  When anyNaN is set all the NaN
+    //  values are considered equal.
+    void compare(const char *config, const ROPColorStamp &result, const ROPColorStamp &reference, U32 pixels,
+                 bool anyNaN = false)
+    {
+        for(U32 p = 0; p < pixels; p++)
+        {
+            for(U32 c = 0; c < 4; c++)
+            {
+                U32 bits = toBits(result.component[c][p]);
+                U32 refBits = toBits(reference.component[c][p]);
+
+                bool bothNaN = (result.component[c][p] != result.component[c][p]) &&
+                               (reference.component[c][p] != reference.component[c][p]);
+
+                if ((bits != refBits) && !(anyNaN && bothNaN))
+                {
+                    if (errors < 16)
+                        printf("%s : %s pixel %d component %d is %08x, expected %08x\n", name, config, p, c, bits, refBits);
+
+                    errors++;
+                }
+            }
+        }
+
+        tested += pixels;
+    }
+
+    //  Compares the data of a stamp with the reference data.
+    void compare(const char *config, const U08 *result, const U08 *reference, U32 pixels, U32 bytesPixel)
+    {
+        for(U32 p = 0; p < pixels; p++)
+        {
+            if (memcmp(&result[p * bytesPixel], &reference[p * bytesPixel], bytesPixel) != 0)
+            {
+                if (errors < 16)
+                {
+                    printf("%s : %s pixel %d is ", name, config, p);
+                    for(U32 b = 0; b < bytesPixel; b++)
+                        printf("%02x", result[p * bytesPixel + b]);
+                    printf(", expected ");
+                    for(U32 b = 0; b < bytesPixel; b++)
+                        printf("%02x", reference[p * bytesPixel + b]);
+                    printf("\n");
+                }
+
+                errors++;
+            }
+        }
+
+        tested += pixels;
+    }
+
+    //  Reports the result.
+    bool finish()
+    {
+        printf("%-14s : %10d pixels tested, %d errors\n", name, tested, errors);
+        return (errors == 0);
+    }
+};
+
+//  Render target formats supported by the color kernels.
+static const TextureFormat formats[] = {GPU_RGBA8888, GPU_RG16F, GPU_R32F, GPU_RGBA16, GPU_RGBA16F};
+static const char *formatNames[] = {"RGBA8", "RG16F", "R32F", "RGBA16", "RGBA16F"};
+static const U32 FORMATS = sizeof(formats) / sizeof(formats[0]);
+
+static bool testConversion()
+{
+    KernelTester decode("decode");
+    KernelTester encode("encode");
+
+    ROPColorStamp color;
+    ROPColorStamp reference;
+    U08 data[MAX_STAMP_PIXELS * MAX_BYTES_PER_COLOR];
+    U08 refData[MAX_STAMP_PIXELS * MAX_BYTES_PER_COLOR];
+    char config[64];
+
+    for(U32 f = 0; f < FORMATS; f++)
+    {
+        for(U32 s = 0; s < 2; s++)
+        {
+            bool sRGB = (s == 1);
+            ROPColorKernels kernels;
+
+            ROPStampKernels::selectColorKernels(formats[f], sRGB, kernels);
+
+            snprintf(config, sizeof(config), "%s%s", formatNames[f], sRGB ? " sRGB" : "");
+
+            //  All the pixel counts up to a stamp with the maximum number of MSAA samples.
+            for(U32 pixels = 1; pixels <= MAX_STAMP_PIXELS; pixels++)
+            {
+                for(U32 t = 0; t < RANDOM_STAMPS; t++)
+                {
+                    randomData(data, pixels * kernels.bytesPixel);
+
+                    kernels.decode(data, color, pixels);
+
+                    for(U32 p = 0; p < pixels; p++)
+                    {
+                        F32 pixel[4];
+                        decodePixel(formats[f], sRGB, data, p, pixel);
+                        for(U32 c = 0; c < 4; c++)
+                            reference.component[c][p] = pixel[c];
+                    }
+
+                    decode.compare(config, color, reference, pixels);
+
+                    randomStamp(color, pixels);
+
+                    for(U32 p = 0; p < pixels; p++)
+                    {
+                        F32 pixel[4];
+                        for(U32 c = 0; c < 4; c++)
+                            pixel[c] = color.component[c][p];
+                        encodePixel(formats[f], sRGB, pixel, p, refData);
+                    }
+
+                    kernels.encode(color, data, pixels);
+
+                    encode.compare(config, data, refData, pixels, kernels.bytesPixel);
+                }
+            }
+        }
+    }
+
+    bool ok = decode.finish();
+    ok = encode.finish() && ok;
+
+    return ok;
+}
+
+static bool testClamp()
+{
+    KernelTester clamp("clamp");
+
+    ROPColorStamp color;
+    ROPColorStamp reference;
+
+    for(U32 pixels = 1; pixels <= MAX_STAMP_PIXELS; pixels++)
+    {
+        for(U32 t = 0; t < RANDOM_STAMPS; t++)
+        {
+            randomStamp(color, pixels);
+
+            for(U32 c = 0; c < 4; c++)
+                for(U32 p = 0; p < pixels; p++)
+                    reference.component[c][p] = GPU_CLAMP(color.component[c][p], 0.0f, 1.0f);
+
+            ROPStampKernels::clamp(color, pixels);
+
+            clamp.compare("clamp", color, reference, pixels);
+        }
+    }
+
+    return clamp.finish();
+}
+
+static bool testMasks()
+{
+    KernelTester colorMask("colorWriteMask");
+    KernelTester mask("writeMask");
+
+    bool pixelMask[MAX_BYTES_PER_COLOR];
+    bool reference[MAX_BYTES_PER_COLOR];
+    bool covered[MAX_STAMP_PIXELS];
+    bool stampMask[MAX_STAMP_PIXELS * MAX_BYTES_PER_COLOR];
+    bool refStampMask[MAX_STAMP_PIXELS * MAX_BYTES_PER_COLOR];
+
+    for(U32 f = 0; f < FORMATS; f++)
+    {
+        for(U32 w = 0; w < 16; w++)
+        {
+            bool write[4] = {(w & 1) != 0, (w & 2) != 0, (w & 4) != 0, (w & 8) != 0};
+
+            U32 bytesPixel = ROPStampKernels::colorWriteMask(formats[f], write[0], write[1], write[2], write[3], pixelMask);
+
+            //  The bytes of each component in the render target format (see the color write stage).
+            switch(formats[f])
+            {
+                case GPU_RGBA8888:
+                    for(U32 b = 0; b < 4; b++)
+                        reference[b] = write[b];
+                    break;
+
+                case GPU_RG16F:
+                    for(U32 b = 0; b < 4; b++)
+                        reference[b] = write[b / 2];
+                    break;
+
+                case GPU_R32F:
+                    for(U32 b = 0; b < 4; b++)
+                        reference[b] = write[0];
+                    break;
+
+                default:
+                    for(U32 b = 0; b < 8; b++)
+                        reference[b] = write[b / 2];
+                    break;
+            }
+
+            colorMask.compare(formatNames[f], (const U08 *) pixelMask, (const U08 *) reference, 1, bytesPixel);
+
+            for(U32 pixels = 1; pixels <= MAX_STAMP_PIXELS; pixels++)
+            {
+                for(U32 c = 0; c < pixels; c++)
+                    covered[c] = ((random32() >> 31) != 0);
+
+                //  A NULL coverage writes all the pixels.
+                for(U32 n = 0; n < 2; n++)
+                {
+                    const bool *coverage = (n == 0) ? covered : NULL;
+
+                    for(U32 p = 0; p < pixels; p++)
+                        for(U32 b = 0; b < bytesPixel; b++)
+                            refStampMask[p * bytesPixel + b] = ((coverage == NULL) || coverage[p]) && pixelMask[b];
+
+                    ROPStampKernels::writeMask(stampMask, pixelMask, bytesPixel, coverage, pixels);
+
+                    mask.compare(formatNames[f], (const U08 *) stampMask, (const U08 *) refStampMask, pixels, bytesPixel);
+                }
+            }
+        }
+    }
+
+    bool ok = colorMask.finish();
+    ok = mask.finish() && ok;
+
+    return ok;
+}
+
+static bool testBlend()
+{
+#ifndef ROP_BLEND_KERNELS
+    //  The blend emulation is used when the compiler may fuse multiply-adds.
+    printf("blend          : blend kernels disabled (FMA), not tested\n");
+    return true;
+#else
+    KernelTester blend("blend");
+
+    bmoFragmentOperator frEmu(STAMP_FRAGMENTS);
+    ROPBlendState state;
+    ROPColorStamp color;
+    ROPColorStamp dest;
+    ROPColorStamp reference;
+    Vec4FP32 source[STAMP_FRAGMENTS];
+    Vec4FP32 destination[STAMP_FRAGMENTS];
+    char config[64];
+
+    for(U32 e = 0; e < BLEND_EQUATIONS; e++)
+    {
+        BlendEquation eq = BlendEquation(BLEND_FUNC_ADD + e);
+
+        for(U32 s = 0; s < BLEND_FUNCTIONS; s++)
+        {
+            for(U32 d = 0; d < BLEND_FUNCTIONS; d++)
+            {
+                BlendFunction sRGB = BlendFunction(s);
+                BlendFunction dRGB = BlendFunction(d);
+                BlendFunction sA = BlendFunction((s * 7 + d) % BLEND_FUNCTIONS);
+                BlendFunction dA = BlendFunction((d * 11 + s) % BLEND_FUNCTIONS);
+
+                Vec4FP32 constant(randomComponent(), randomComponent(), randomComponent(), randomComponent());
+
+                ROPStampKernels::setupBlend(state, eq, sRGB, sA, dRGB, dA, constant);
+                frEmu.setBlending(0, eq, sRGB, sA, dRGB, dA, constant);
+
+                snprintf(config, sizeof(config), "eq %d src %d/%d dst %d/%d", e, s, sA, d, dA);
+
+                //  A stamp for each number of MSAA samples.
+                for(U32 samples = 1; samples <= MAX_MSAA_SAMPLES; samples = samples * 2)
+                {
+                    U32 pixels = STAMP_FRAGMENTS * samples;
+
+                    for(U32 t = 0; t < (RANDOM_STAMPS / 8); t++)
+                    {
+                        randomStamp(color, pixels);
+                        randomStamp(dest, pixels);
+
+                        for(U32 first = 0; first < pixels; first += STAMP_FRAGMENTS)
+                        {
+                            for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+                            {
+                                for(U32 c = 0; c < 4; c++)
+                                {
+                                    source[f][c] = color.component[c][first + f];
+                                    destination[f][c] = dest.component[c][first + f];
+                                }
+                            }
+
+                            frEmu.blend(0, source, source, destination);
+
+                            for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+                                for(U32 c = 0; c < 4; c++)
+                                    reference.component[c][first + f] = source[f][c];
+                        }
+
+                        ROPStampKernels::blend(state, color, dest, pixels);
+
+                        //  The sign of the NaN produced by an operation with two NaN operands (or an
+                        //  invalid operation and a NaN) depends on the operand order the compiler
+                        //  selects for the commutative operations, in the reference too.
+                        blend.compare(config, color, reference, pixels, true);
+                    }
+                }
+            }
+        }
+    }
+
+    return blend.finish();
+#endif
+}
+
+static bool testLogicOp()
+{
+    KernelTester logicOp("logicOp");
+
+    bmoFragmentOperator frEmu(STAMP_FRAGMENTS);
+    ROPColorKernels kernels;
+    ROPColorStamp color;
+    U08 data[MAX_STAMP_PIXELS * 4];
+    U08 refData[MAX_STAMP_PIXELS * 4];
+    U08 dest[MAX_STAMP_PIXELS * 4];
+    char config[64];
+
+    //  The logic operation is applied to the encoded RGBA8 color of each sample (see the color
+    //  write stage), so the input comes from the encode kernel.
+    ROPStampKernels::selectColorKernels(GPU_RGBA8888, false, kernels);
+
+    for(U32 op = 0; op < LOGIC_OPS; op++)
+    {
+        frEmu.setLogicOpMode(LogicOpMode(op));
+
+        snprintf(config, sizeof(config), "mode %d", op);
+
+        for(U32 samples = 1; samples <= MAX_MSAA_SAMPLES; samples = samples * 2)
+        {
+            U32 pixels = STAMP_FRAGMENTS * samples;
+
+            for(U32 t = 0; t < RANDOM_STAMPS; t++)
+            {
+                randomStamp(color, pixels);
+                randomData(dest, pixels * 4);
+
+                for(U32 p = 0; p < pixels; p++)
+                {
+                    F32 pixel[4];
+                    for(U32 c = 0; c < 4; c++)
+                        pixel[c] = color.component[c][p];
+                    encodePixel(GPU_RGBA8888, false, pixel, p, refData);
+                }
+
+                kernels.encode(color, data, pixels);
+
+                for(U32 s = 0; s < samples; s++)
+                {
+                    U32 offset = STAMP_FRAGMENTS * s * 4;
+                    frEmu.logicOp(&data[offset], &data[offset], &dest[offset]);
+                    frEmu.logicOp(&refData[offset], &refData[offset], &dest[offset]);
+                }
+
+                logicOp.compare(config, data, refData, pixels, 4);
+            }
+        }
+    }
+
+    return logicOp.finish();
+}
+
+int main()
+{
+    printf("Kernel implementation : %s\n", ROPStampKernels::getImplementation());
+
+    bool ok = testConversion();
+    ok = testClamp() && ok;
+    ok = testMasks() && ok;
+    ok = testBlend() && ok;
+    ok = testLogicOp() && ok;
+
+    printf("%s\n", ok ? "PASSED" : "FAILED");
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,279 @@
+/**************************************************************************
+ *
+ *  Texture block decompression test.
+ *
+ *  Checks that the batch block decompression functions of the Texture Behavior Model
+ *  (decompressDXT1RGB, ..., decompressLATC2Signed) are bit-exact with the per-block
+ *  reference decoders (decodeBlockDXT1RGB, ..., decodeBlockLATC2Signed).
+ *
+ *  For every format all the pairs of reference values (all pairs of 8-bit reference values for
+ *  LATC and DXT5 alpha, all the 565 first reference colors against a set of second reference
+ *  colors for the S3TC colors) are tested with code patterns that place every code in every
+ *  texel of the block.
+ *
+ */
+
+#include "GPUType.h"
+#include "bmTextureProcessor.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace arch;
+
+//  Number of blocks decompressed per call to the batch decompression function.
+static const U32 BATCH_BLOCKS = 64;
+
+typedef void (*DecodeBlockFunction)(U08 *, U08 *);
+typedef void (*DecompressFunction)(U08 *, U08 *, U32);
+
+class BlockTester
+{
+private:
+
+    const char *name;
+    DecodeBlockFunction decodeBlock;
+    DecompressFunction decompress;
+    U32 blockSize;
+    U32 decodedSize;
+    std::vector<U08> input;
+    std::vector<U08> output;
+    std::vector<U08> reference;
+    U32 blocks;
+    U32 tested;
+    U32 errors;
+
+    void check()
+    {
+        if (blocks == 0)
+            return;
+
+        decompress(&input[0], &output[0], blocks * blockSize);
+
+        for(U32 b = 0; b < blocks; b++)
+        {
+            decodeBlock(&input[b * blockSize], &reference[b * decodedSize]);
+
+            if (memcmp(&output[b * decodedSize], &reference[b * decodedSize], decodedSize) != 0)
+            {
+                if (errors < 16)
+                {
+                    printf("%s : mismatch for block ", name);
+                    for(U32 i = 0; i < blockSize; i++)
+                        printf("%02x", input[b * blockSize + i]);
+                    printf("\n");
+                }
+
+                errors++;
+            }
+        }
+
+        tested += blocks;
+        blocks = 0;
+    }
+
+public:
+
+    BlockTester(const char *name, DecodeBlockFunction decodeBlock, DecompressFunction decompress, U32 blockSize, U32 decodedSize) :
+        name(name), decodeBlock(decodeBlock), decompress(decompress), blockSize(blockSize), decodedSize(decodedSize),
+        input(blockSize * BATCH_BLOCKS), output(decodedSize * BATCH_BLOCKS), reference(decodedSize * BATCH_BLOCKS),
+        blocks(0), tested(0), errors(0)
+    {
+    }
+
+    //  Adds a block to the current batch.
+    void add(const U08 *block)
+    {
+        memcpy(&input[blocks * blockSize], block, blockSize);
+        blocks++;
+
+        if (blocks == BATCH_BLOCKS)
+            check();
+    }
+
+    //  Tests the pending blocks and reports the result.
+    bool finish()
+    {
+        check();
+        printf("%-14s : %10d blocks tested, %d errors\n", name, tested, errors);
+        return (errors == 0);
+    }
+};
+
+//  Returns 48 code bits with the 3-bit code (texel + pattern) mod 8 for each texel.
+static U64 codes3(U32 pattern)
+{
+    U64 codes = 0;
+    for(U32 t = 0; t < 16; t++)
+        codes = codes | (U64((t + pattern) & 0x07) << (3 * t));
+    return codes;
+}
+
+//  Returns 32 code bits with the 2-bit code (texel + pattern) mod 4 for each texel.
+static U32 codes2(U32 pattern)
+{
+    U32 codes = 0;
+    for(U32 t = 0; t < 16; t++)
+        codes = codes | (((t + pattern) & 0x03) << (2 * t));
+    return codes;
+}
+
+static void store16(U08 *buffer, U32 value)
+{
+    buffer[0] = U08(value & 0xFF);
+    buffer[1] = U08((value >> 8) & 0xFF);
+}
+
+static void store32(U08 *buffer, U32 value)
+{
+    for(U32 b = 0; b < 4; b++)
+        buffer[b] = U08((value >> (8 * b)) & 0xFF);
+}
+
+static void store48(U08 *buffer, U64 value)
+{
+    for(U32 b = 0; b < 6; b++)
+        buffer[b] = U08((value >> (8 * b)) & 0xFF);
+}
+
+//  Second reference colors tested against every first reference color.
+static void secondColors(U32 color0, U32 &numColors, U32 *colors)
+{
+    static U32 seed = 0x12345678;
+
+    numColors = 0;
+    colors[numColors++] = color0;
+    colors[numColors++] = color0 ^ 0x0001;
+    colors[numColors++] = (color0 + 1) & 0xFFFF;
+    colors[numColors++] = (~color0) & 0xFFFF;
+    colors[numColors++] = 0x0000;
+    colors[numColors++] = 0xFFFF;
+
+    for(U32 c = 0; c < 10; c++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        colors[numColors++] = (seed >> 16) & 0xFFFF;
+    }
+}
+
+static bool testLATC()
+{
+    BlockTester latc1("LATC1", bmoTextureProcessor::decodeBlockLATC1, bmoTextureProcessor::decompressLATC1, 8, 16);
+    BlockTester latc1s("LATC1_SIGNED", bmoTextureProcessor::decodeBlockLATC1Signed, bmoTextureProcessor::decompressLATC1Signed, 8, 16);
+    BlockTester latc2("LATC2", bmoTextureProcessor::decodeBlockLATC2, bmoTextureProcessor::decompressLATC2, 16, 32);
+    BlockTester latc2s("LATC2_SIGNED", bmoTextureProcessor::decodeBlockLATC2Signed, bmoTextureProcessor::decompressLATC2Signed, 16, 32);
+
+    U08 block[16];
+
+    for(U32 r = 0; r < 65536; r++)
+    {
+        for(U32 p = 0; p < 8; p++)
+        {
+            block[0] = U08(r & 0xFF);
+            block[1] = U08(r >> 8);
+            store48(&block[2], codes3(p));
+
+            //  Alpha reference values are the luminance reference values swapped.
+            block[8] = block[1];
+            block[9] = block[0];
+            store48(&block[10], codes3(7 - p));
+
+            latc1.add(block);
+            latc1s.add(block);
+            latc2.add(block);
+            latc2s.add(block);
+        }
+    }
+
+    bool ok = latc1.finish();
+    ok = latc1s.finish() && ok;
+    ok = latc2.finish() && ok;
+    ok = latc2s.finish() && ok;
+
+    return ok;
+}
+
+static bool testDXT()
+{
+    BlockTester dxt1rgb("DXT1_RGB", bmoTextureProcessor::decodeBlockDXT1RGB, bmoTextureProcessor::decompressDXT1RGB, 8, 64);
+    BlockTester dxt1rgba("DXT1_RGBA", bmoTextureProcessor::decodeBlockDXT1RGBA, bmoTextureProcessor::decompressDXT1RGBA, 8, 64);
+    BlockTester dxt3("DXT3_RGBA", bmoTextureProcessor::decodeBlockDXT3RGBA, bmoTextureProcessor::decompressDXT3RGBA, 16, 64);
+    BlockTester dxt5("DXT5_RGBA", bmoTextureProcessor::decodeBlockDXT5RGBA, bmoTextureProcessor::decompressDXT5RGBA, 16, 64);
+
+    U08 block[16];
+    U32 colors[16];
+    U32 numColors;
+
+    //  S3TC colors.
+    for(U32 color0 = 0; color0 < 65536; color0++)
+    {
+        secondColors(color0, numColors, colors);
+
+        for(U32 c = 0; c < numColors; c++)
+        {
+            for(U32 p = 0; p < 4; p++)
+            {
+                store16(&block[0], color0);
+                store16(&block[2], colors[c]);
+                store32(&block[4], codes2(p));
+
+                dxt1rgb.add(block);
+                dxt1rgba.add(block);
+
+                //  DXT3 alpha literals ((texel + pattern) mod 16) and DXT5 alpha reference values and codes.
+                for(U32 t = 0; t < 8; t++)
+                    block[t] = U08((((2 * t + p + c) & 0x0F)) | (((2 * t + 1 + p + c) & 0x0F) << 4));
+                store16(&block[8], color0);
+                store16(&block[10], colors[c]);
+                store32(&block[12], codes2(p));
+
+                dxt3.add(block);
+                dxt5.add(block);
+            }
+        }
+    }
+
+    //  All the DXT5 alpha reference values.
+    for(U32 r = 0; r < 65536; r++)
+    {
+        for(U32 p = 0; p < 8; p++)
+        {
+            block[0] = U08(r & 0xFF);
+            block[1] = U08(r >> 8);
+            store48(&block[2], codes3(p));
+            store16(&block[8], r);
+            store16(&block[10], (r * 40503) & 0xFFFF);
+            store32(&block[12], codes2(p));
+
+            dxt5.add(block);
+        }
+    }
+
+    //  Non initialized memory.
+    store32(&block[0], 0xDEADCAFE);
+    store32(&block[4], 0xDEADCAFE);
+    store32(&block[8], 0xDEADCAFE);
+    store32(&block[12], 0xDEADCAFE);
+    dxt1rgb.add(block);
+    dxt1rgba.add(block);
+    dxt3.add(block);
+    dxt5.add(block);
+
+    bool ok = dxt1rgb.finish();
+    ok = dxt1rgba.finish() && ok;
+    ok = dxt3.finish() && ok;
+    ok = dxt5.finish() && ok;
+
+    return ok;
+}
+
+int main()
+{
+    bool ok = testLATC();
+    ok = testDXT() && ok;
+
+    printf("%s\n", ok ? "PASSED" : "FAILED");
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,280 @@
+/**************************************************************************
+ *
+ *  Simulator microbenchmark harness implementation file.
+ *
+ *  Usage: simbench [--filter <substring>]... [--min-time <seconds>] [--reps <n>]
+ *                  [--json <file>] [--list]
+ *
+ *  The JSON file is the input of tools/script/regression/compare-bench.py.
+ *
+ */
+
+#include "SimBench.h"
+#include "DynamicMemoryOpt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+
+//
+//  Heap allocation counters.  Replacing the global operators counts every
+//  allocation done by the simulator code and the standard library (the
+//  DynamicMemoryOpt pools don't go through these operators).
+//
+
+static U64 heapAllocs = 0;
+static U64 heapBytes = 0;
+
+static void *countedAlloc(size_t size)
+{
+    heapAllocs++;
+    heapBytes += size;
+    void *p = malloc((size == 0) ? 1 : size);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(size_t size) { return countedAlloc(size); }
+void *operator new[](size_t size) { return countedAlloc(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    heapAllocs++;
+    heapBytes += size;
+    return malloc((size == 0) ? 1 : size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    heapAllocs++;
+    heapBytes += size;
+    return malloc((size == 0) ? 1 : size);
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+namespace simbench
+{
+
+volatile U64 benchSink = 0;
+
+U64 allocCount() { return heapAllocs; }
+U64 allocBytes() { return heapBytes; }
+
+BenchRunner::BenchRunner(F64 minT, U32 reps, const std::vector<std::string> &f, bool list) :
+    minTime(minT), repetitions(reps), filters(f), listOnly(list)
+{
+}
+
+bool BenchRunner::selected(const char *name) const
+{
+    if (filters.empty())
+        return true;
+
+    for(size_t f = 0; f < filters.size(); f++)
+        if (strstr(name, filters[f].c_str()) != NULL)
+            return true;
+
+    return false;
+}
+
+F64 BenchRunner::runOnce(const BenchFunction &function, U64 iterations, BenchCounters &counters,
+                         U64 &allocs, U64 &bytes)
+{
+    counters.ops = 0;
+    counters.bytes = 0;
+
+    U64 startAllocs = heapAllocs;
+    U64 startBytes = heapBytes;
+    auto start = std::chrono::steady_clock::now();
+
+    function(iterations, counters);
+
+    auto end = std::chrono::steady_clock::now();
+    allocs = heapAllocs - startAllocs;
+    bytes = heapBytes - startBytes;
+
+    return std::chrono::duration<F64>(end - start).count();
+}
+
+void BenchRunner::run(const char *name, const BenchFunction &function)
+{
+    if (!selected(name))
+        return;
+
+    if (listOnly)
+    {
+        printf("%s\n", name);
+        return;
+    }
+
+    BenchCounters counters;
+    U64 allocs;
+    U64 bytes;
+
+    //  Warm up and calibrate the number of iterations to run for at least the minimum time.
+    U64 iterations = 1;
+    F64 elapsed = runOnce(function, iterations, counters, allocs, bytes);
+    while (elapsed < minTime)
+    {
+        F64 scale = (elapsed > 0.0) ? (minTime * 1.2 / elapsed) : 100.0;
+        scale = std::min(std::max(scale, 2.0), 100.0);
+        iterations = U64(F64(iterations) * scale);
+        elapsed = runOnce(function, iterations, counters, allocs, bytes);
+    }
+
+    struct Sample
+    {
+        F64 nsPerOp;
+        F64 seconds;
+        BenchCounters counters;
+        U64 allocs;
+        U64 bytes;
+    };
+
+    std::vector<Sample> samples(repetitions);
+    for(U32 r = 0; r < repetitions; r++)
+    {
+        Sample &s = samples[r];
+        s.seconds = runOnce(function, iterations, s.counters, s.allocs, s.bytes);
+        s.nsPerOp = s.seconds * 1e9 / F64(std::max(s.counters.ops, U64(1)));
+    }
+
+    std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) { return a.nsPerOp < b.nsPerOp; });
+    const Sample &median = samples[samples.size() / 2];
+    F64 ops = F64(std::max(median.counters.ops, U64(1)));
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.ops = median.counters.ops;
+    result.nsPerOp = median.nsPerOp;
+    result.minNsPerOp = samples[0].nsPerOp;
+    result.opsPerSec = ops / median.seconds;
+    result.bytesPerSec = F64(median.counters.bytes) / median.seconds;
+    result.allocsPerOp = F64(median.allocs) / ops;
+    result.allocBytesPerOp = F64(median.bytes) / ops;
+    results.push_back(result);
+
+    printf("%-40s %12.2f ns/op %14.0f ops/s %10.2f MB/s %10.3f allocs/op %10.1f B/op\n",
+           name, result.nsPerOp, result.opsPerSec, result.bytesPerSec / (1024.0 * 1024.0),
+           result.allocsPerOp, result.allocBytesPerOp);
+    fflush(stdout);
+}
+
+} // namespace simbench
+
+using namespace simbench;
+
+static const char *simdName()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+static bool writeJSON(const char *fileName, const std::vector<BenchResult> &results, F64 minTime, U32 reps)
+{
+    FILE *f = fopen(fileName, "w");
+    if (f == NULL)
+    {
+        printf("ERROR: can't create %s\n", fileName);
+        return false;
+    }
+
+    char date[64];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"context\": {\"date\": \"%s\", \"simd\": \"%s\", \"min_time\": %g, \"repetitions\": %d, \"debug\": %s},\n",
+            date, simdName(), minTime, reps,
+#ifdef NDEBUG
+            "false"
+#else
+            "true"
+#endif
+            );
+    fprintf(f, "  \"benchmarks\": [\n");
+    for(size_t r = 0; r < results.size(); r++)
+    {
+        const BenchResult &b = results[r];
+        fprintf(f, "    {\"name\": \"%s\", \"iterations\": %llu, \"ops\": %llu, \"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, "
+                   "\"ops_per_sec\": %.2f, \"bytes_per_sec\": %.2f, \"allocs_per_op\": %.6f, \"alloc_bytes_per_op\": %.4f}%s\n",
+                b.name.c_str(), (unsigned long long) b.iterations, (unsigned long long) b.ops, b.nsPerOp, b.minNsPerOp,
+                b.opsPerSec, b.bytesPerSec, b.allocsPerOp, b.allocBytesPerOp, (r + 1 < results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+    fclose(f);
+
+    return true;
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [--filter <substring>]... [--min-time <seconds>] [--reps <n>] [--json <file>] [--list]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> filters;
+    F64 minTime = 0.25;
+    U32 reps = 5;
+    const char *jsonFile = NULL;
+    bool listOnly = false;
+
+    for(int a = 1; a < argc; a++)
+    {
+        if ((strcmp(argv[a], "--filter") == 0) && (a + 1 < argc))
+            filters.push_back(argv[++a]);
+        else if ((strcmp(argv[a], "--min-time") == 0) && (a + 1 < argc))
+            minTime = atof(argv[++a]);
+        else if ((strcmp(argv[a], "--reps") == 0) && (a + 1 < argc))
+            reps = std::max(atoi(argv[++a]), 1);
+        else if ((strcmp(argv[a], "--json") == 0) && (a + 1 < argc))
+            jsonFile = argv[++a];
+        else if (strcmp(argv[a], "--list") == 0)
+            listOnly = true;
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    //  Same memory pools as the default simulator configuration.
+    DynamicMemoryOpt::initialize(512, 262144, 4096, 32768, 64, 65536);
+
+    BenchRunner runner(minTime, reps, filters, listOnly);
+
+    try
+    {
+        benchSignal(runner);
+        benchCache(runner);
+        benchRasterizer(runner);
+        benchShader(runner);
+        benchApitrace(runner);
+        benchCompressor(runner);
+        benchROP(runner);
+    }
+    catch(...)
+    {
+        printf("ERROR: benchmark aborted\n");
+        return -1;
+    }
+
+    if ((jsonFile != NULL) && !listOnly)
+        return writeJSON(jsonFile, runner.getResults(), minTime, reps) ? 0 : -1;
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**************************************************************************
+ *
+ *  Simulator microbenchmark harness definition file.
+ *
+ *  The benchmarks run the simulator hot paths (signals, cache template,
+ *  rasterizer, shader, apitrace parser, compressors and ROP kernels) with fixed synthetic
+ *  inputs.  Each benchmark is calibrated to run for a minimum time and is
+ *  repeated several times, the median repetition is reported as ns/op,
+ *  throughput and allocations per operation.
+ *
+ */
+
+#ifndef __SIMBENCH_H__
+#define __SIMBENCH_H__
+
+#include "GPUType.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace simbench
+{
+
+using namespace arch;
+
+/**
+ *  Work done by a benchmark run.  Filled by the benchmark function.
+ */
+struct BenchCounters
+{
+    U64 ops;        //  Operations performed (the unit of the ns/op figure).
+    U64 bytes;      //  Bytes processed (0 if the benchmark has no byte throughput).
+};
+
+/**
+ *  Result of a benchmark.
+ */
+struct BenchResult
+{
+    std::string name;       //  Benchmark name (<group>/<case>).
+    U64 iterations;         //  Iterations per repetition.
+    U64 ops;                //  Operations per repetition.
+    F64 nsPerOp;            //  Median nanoseconds per operation.
+    F64 minNsPerOp;         //  Fastest repetition nanoseconds per operation.
+    F64 opsPerSec;          //  Operations per second (median repetition).
+    F64 bytesPerSec;        //  Bytes per second (median repetition).
+    F64 allocsPerOp;        //  Heap allocations per operation (median repetition).
+    F64 allocBytesPerOp;    //  Heap bytes allocated per operation (median repetition).
+};
+
+/**
+ *  Benchmark function.  Performs the requested number of iterations and
+ *  fills the counters with the work done.
+ */
+typedef std::function<void(U64 iterations, BenchCounters &counters)> BenchFunction;
+
+/**
+ *  Runs and records the benchmarks.
+ */
+class BenchRunner
+{
+private:
+
+    F64 minTime;                        //  Minimum time in seconds of a repetition.
+    U32 repetitions;                    //  Repetitions per benchmark.
+    std::vector<std::string> filters;   //  Only run benchmarks containing one of these strings.
+    bool listOnly;                      //  Only list the benchmark names.
+    std::vector<BenchResult> results;   //  Results of the benchmarks run.
+
+    /**
+     *  Runs one repetition and returns the elapsed time in seconds.
+     */
+    static F64 runOnce(const BenchFunction &function, U64 iterations, BenchCounters &counters,
+                       U64 &allocs, U64 &allocBytes);
+
+public:
+
+    BenchRunner(F64 minTime, U32 repetitions, const std::vector<std::string> &filters, bool listOnly);
+
+    /**
+     *  Checks if a benchmark is selected by the filters.
+     */
+    bool selected(const char *name) const;
+
+    /**
+     *  Calibrates, runs and records a benchmark (if selected).
+     *
+     *  @param name Benchmark name.
+     *  @param function Benchmark function.
+     */
+    void run(const char *name, const BenchFunction &function);
+
+    const std::vector<BenchResult> &getResults() const { return results; }
+};
+
+/**
+ *  Heap allocation counters (global operator new replacement).
+ */
+U64 allocCount();
+U64 allocBytes();
+
+/**
+ *  Sink for benchmark results so the compiler can't remove the benchmarked code.
+ */
+extern volatile U64 benchSink;
+
+//  Benchmark groups.
+void benchSignal(BenchRunner &runner);
+void benchCache(BenchRunner &runner);
+void benchRasterizer(BenchRunner &runner);
+void benchShader(BenchRunner &runner);
+void benchApitrace(BenchRunner &runner);
+void benchCompressor(BenchRunner &runner);
+void benchROP(BenchRunner &runner);
+
+} // namespace simbench
+
+#endif // __SIMBENCH_H__
@@ -0,0 +1,271 @@
+/**************************************************************************
+ *
+ *  Apitrace parser event decoding microbenchmarks.
+ *
+ *  Writes a synthetic OpenGL apitrace file (snappy compressed, format version 6)
+ *  with a fixed mix of calls and decodes it with ApitraceParser.  One operation
+ *  is one decoded call event, the byte throughput is measured on the
+ *  uncompressed event stream.
+ *
+ */
+
+#include "SimBench.h"
+#include "ApitraceParser.h"
+
+#include <snappy.h>
+#include <cstdio>
+#include <cstring>
+
+namespace simbench
+{
+
+static const char *SYNTHETIC_TRACE = "simbench.synthetic.trace";
+
+//  Apitrace binary format writer.
+class SyntheticTraceWriter
+{
+private:
+
+    static const size_t CHUNK_SIZE = 1024 * 1024;
+
+    FILE *file;
+    std::string chunk;
+    U64 totalBytes;
+    U64 events;
+    U32 nextCall;
+    std::vector<bool> sigWritten;
+    std::vector<bool> enumWritten;
+
+    void flushChunk()
+    {
+        if (chunk.empty())
+            return;
+
+        std::string compressed;
+        snappy::Compress(chunk.data(), chunk.size(), &compressed);
+        U32 length = U32(compressed.size());
+        fwrite(&length, 4, 1, file);
+        fwrite(compressed.data(), 1, compressed.size(), file);
+        totalBytes += chunk.size();
+        chunk.clear();
+    }
+
+public:
+
+    SyntheticTraceWriter(const char *fileName) : totalBytes(0), events(0), nextCall(0), sigWritten(8, false), enumWritten(8, false)
+    {
+        file = fopen(fileName, "wb");
+        if (file != NULL)
+            fwrite("at", 1, 2, file);
+    }
+
+    ~SyntheticTraceWriter()
+    {
+        if (file != NULL)
+        {
+            flushChunk();
+            fclose(file);
+        }
+    }
+
+    bool isOpen() const { return file != NULL; }
+    U64 getTotalBytes() { flushChunk(); return totalBytes; }
+    U64 getEvents() const { return events; }
+
+    void byte(U08 b) { chunk.push_back(char(b)); }
+
+    void varUInt(U64 v)
+    {
+        do
+        {
+            U08 b = U08(v & 0x7f);
+            v >>= 7;
+            byte((v != 0) ? (b | 0x80) : b);
+        } while (v != 0);
+    }
+
+    void string(const char *s)
+    {
+        size_t len = strlen(s);
+        varUInt(len);
+        chunk.append(s, len);
+    }
+
+    void uintValue(U64 v) { byte(apitrace::VALUE_UINT); varUInt(v); }
+    void floatValue(F32 f) { byte(apitrace::VALUE_FLOAT); chunk.append((const char *) &f, 4); }
+    void opaqueValue(U64 p) { byte(apitrace::VALUE_OPAQUE); varUInt(p); }
+
+    void blobValue(const U08 *data, U32 size)
+    {
+        byte(apitrace::VALUE_BLOB);
+        varUInt(size);
+        chunk.append((const char *) data, size);
+    }
+
+    void enumValue(U32 sigId, const char *name, U32 value)
+    {
+        byte(apitrace::VALUE_ENUM);
+        varUInt(sigId);
+        if (!enumWritten[sigId])
+        {
+            enumWritten[sigId] = true;
+            varUInt(1);
+            string(name);
+            byte(apitrace::VALUE_UINT);
+            varUInt(value);
+        }
+        uintValue(value);
+    }
+
+    void header()
+    {
+        varUInt(6);
+        varUInt(2);
+        string("API");
+        string("GL");
+        string("");
+    }
+
+    void enter(U32 sigId, const char *name, const char * const *argNames, U32 numArgs)
+    {
+        byte(apitrace::EVENT_CALL_ENTER);
+        varUInt(0);
+        varUInt(sigId);
+        if (!sigWritten[sigId])
+        {
+            sigWritten[sigId] = true;
+            string(name);
+            varUInt(numArgs);
+            for(U32 a = 0; a < numArgs; a++)
+                string(argNames[a]);
+        }
+    }
+
+    void arg(U32 argNo) { byte(apitrace::DETAIL_ARG); varUInt(argNo); }
+    void endDetails() { byte(apitrace::DETAIL_END); }
+
+    void leave()
+    {
+        byte(apitrace::EVENT_CALL_LEAVE);
+        varUInt(nextCall++);
+        endDetails();
+        events++;
+        if (chunk.size() >= CHUNK_SIZE)
+            flushChunk();
+    }
+};
+
+//  Writes the synthetic trace.  Returns the uncompressed size of the event stream.
+static U64 writeSyntheticTrace(U64 &events)
+{
+    static const char * const attribArgs[] = {"index", "x", "y", "z", "w"};
+    static const char * const drawArgs[] = {"mode", "first", "count"};
+    static const char * const bufferArgs[] = {"target", "size", "data", "usage"};
+    static const char * const uniformArgs[] = {"location", "count", "value"};
+    static const char * const swapArgs[] = {"dpy", "drawable"};
+
+    SyntheticTraceWriter w(SYNTHETIC_TRACE);
+    if (!w.isOpen())
+        return 0;
+
+    U08 blob[1024];
+    for(U32 b = 0; b < sizeof(blob); b++)
+        blob[b] = U08(b * 7 + (b >> 5));
+
+    w.header();
+
+    for(U32 frame = 0; frame < 64; frame++)
+    {
+        for(U32 batch = 0; batch < 16; batch++)
+        {
+            w.enter(2, "glBufferData", bufferArgs, 4);
+            w.arg(0); w.enumValue(0, "GL_ARRAY_BUFFER", 0x8892);
+            w.arg(1); w.uintValue(sizeof(blob));
+            w.arg(2); w.blobValue(blob, sizeof(blob));
+            w.arg(3); w.enumValue(1, "GL_STATIC_DRAW", 0x88E4);
+            w.endDetails();
+            w.leave();
+
+            for(U32 u = 0; u < 2; u++)
+            {
+                w.enter(3, "glUniform4fv", uniformArgs, 3);
+                w.arg(0); w.uintValue(u);
+                w.arg(1); w.uintValue(4);
+                w.arg(2); w.byte(apitrace::VALUE_ARRAY); w.varUInt(16);
+                for(U32 f = 0; f < 16; f++)
+                    w.floatValue(F32(frame) * 0.5f + F32(f));
+                w.endDetails();
+                w.leave();
+            }
+
+            for(U32 v = 0; v < 12; v++)
+            {
+                w.enter(0, "glVertexAttrib4f", attribArgs, 5);
+                w.arg(0); w.uintValue(v & 3);
+                w.arg(1); w.floatValue(F32(v) * 0.25f);
+                w.arg(2); w.floatValue(F32(batch));
+                w.arg(3); w.floatValue(-F32(frame));
+                w.arg(4); w.floatValue(1.0f);
+                w.endDetails();
+                w.leave();
+            }
+
+            w.enter(1, "glDrawArrays", drawArgs, 3);
+            w.arg(0); w.enumValue(2, "GL_TRIANGLES", 0x0004);
+            w.arg(1); w.uintValue(batch * 3);
+            w.arg(2); w.uintValue(3 * (batch + 1));
+            w.endDetails();
+            w.leave();
+        }
+
+        w.enter(4, "glXSwapBuffers", swapArgs, 2);
+        w.arg(0); w.opaqueValue(0x5581a2c0);
+        w.arg(1); w.uintValue(0x04000002);
+        w.endDetails();
+        w.leave();
+    }
+
+    events = w.getEvents();
+    return w.getTotalBytes();
+}
+
+static void decodeEvents(U64 traceEvents, U64 traceBytes, U64 iterations, BenchCounters &counters)
+{
+    U64 decoded = 0;
+    U64 args = 0;
+
+    //  The parser keeps the signature caches after close() so a new parser is used for each pass.
+    while (decoded < iterations)
+    {
+        apitrace::ApitraceParser parser;
+        if (!parser.open(SYNTHETIC_TRACE))
+            CG_ASSERT("Error opening the synthetic apitrace file.");
+
+        apitrace::CallEvent event;
+        while ((decoded < iterations) && parser.readEvent(event))
+        {
+            args += event.arguments.size();
+            decoded++;
+        }
+    }
+
+    benchSink = benchSink + args;
+    counters.ops = decoded;
+    counters.bytes = U64(F64(decoded) * F64(traceBytes) / F64(traceEvents));
+}
+
+void benchApitrace(BenchRunner &runner)
+{
+    if (!runner.selected("apitrace/decode_events"))
+        return;
+
+    U64 traceEvents = 0;
+    U64 traceBytes = writeSyntheticTrace(traceEvents);
+    CG_ASSERT_COND((traceBytes != 0), "Error writing the synthetic apitrace file.");
+
+    runner.run("apitrace/decode_events", [=](U64 n, BenchCounters &c) { decodeEvents(traceEvents, traceBytes, n, c); });
+
+    remove(SYNTHETIC_TRACE);
+}
+
+} // namespace simbench
@@ -0,0 +1,174 @@
+/**************************************************************************
+ *
+ *  Cache template lookup microbenchmarks.
+ *
+ *  Runs a fixed pseudo-random address stream (75% of the accesses to 1/8 of a
+ *  working set twice the cache size) through bmoCacheTemplate and through a
+ *  reference cache model with the previous layout (per way tag and valid arrays
+ *  scanned linearly).  Both caches implement their own round robin replacement
+ *  on top of the tag lookup, as FetchCache does.  One operation is one lookup.
+ *
+ *  Before the benchmarks the hit counts of the template and the reference model
+ *  are compared for several configurations, they must be identical.
+ *
+ */
+
+#include "SimBench.h"
+#include "CacheTemplate.h"
+
+namespace simbench
+{
+
+template<typename ADDRTYP>
+class BenchCache : public bmoCacheTemplate<ADDRTYP>
+{
+private:
+
+    std::vector<U32> nextVictim;    //  Next victim way per line index.
+
+public:
+
+    BenchCache(U32 ways, U32 lines, U32 lineSize) : bmoCacheTemplate<ADDRTYP>(ways, lines, lineSize), nextVictim(lines, 0) {}
+
+    bool access(ADDRTYP address)
+    {
+        U32 line;
+        U32 way;
+
+        if (this->search(address, line, way))
+            return true;
+
+        way = nextVictim[line];
+        nextVictim[line] = (way + 1) % this->numWays;
+
+        this->replace(address, way);
+
+        return false;
+    }
+};
+
+template<typename ADDRTYP>
+class RefCache
+{
+private:
+
+    U32 numWays;
+    U32 numLines;
+    U32 lineShift;
+    U32 lineMask;
+    U32 tagShift;
+    std::vector< std::vector<ADDRTYP> > tags;
+    std::vector< std::vector<bool> > valid;
+    std::vector<U32> nextVictim;
+
+    U32 lineIndex(ADDRTYP address) { return (numLines == 1) ? 0 : ((U32(address) >> lineShift) & lineMask); }
+
+public:
+
+    RefCache(U32 ways, U32 lines, U32 lineSize) :
+        numWays(ways), numLines(lines), tags(ways, std::vector<ADDRTYP>(lines, 0)),
+        valid(ways, std::vector<bool>(lines, false)), nextVictim(lines, 0)
+    {
+        lineShift = GPUMath::calculateShift(lineSize);
+        lineMask = GPUMath::buildMask(lines);
+        tagShift = (lines == 1) ? lineShift : GPUMath::calculateShift(lines) + lineShift;
+    }
+
+    bool access(ADDRTYP address)
+    {
+        U32 line = lineIndex(address);
+
+        for(U32 way = 0; way < numWays; way++)
+            if (valid[way][line] && (tags[way][line] == (address >> tagShift)))
+                return true;
+
+        U32 way = nextVictim[line];
+        nextVictim[line] = (way + 1) % numWays;
+
+        tags[way][line] = address >> tagShift;
+        valid[way][line] = true;
+
+        return false;
+    }
+};
+
+static const U32 CACHE_STREAM_LENGTH = 1 << 16;
+
+template<typename ADDRTYP>
+static void buildStream(std::vector<ADDRTYP> &stream, U32 workingSet)
+{
+    stream.resize(CACHE_STREAM_LENGTH);
+
+    U64 state = 0x853c49e6748fea9bULL;
+    U64 base = (sizeof(ADDRTYP) == 8) ? 0x0000000100000000ULL : 0;
+
+    for(U32 a = 0; a < CACHE_STREAM_LENGTH; a++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        U32 r = U32(state >> 33);
+        U32 offset = ((r & 0x03) != 0) ? (r >> 2) % (workingSet >> 3) : (r >> 2) % workingSet;
+        stream[a] = ADDRTYP(base + (U64(offset) & ~U64(0x03)));
+    }
+}
+
+//  Compares the hits of the cache template and the reference model.
+template<typename ADDRTYP>
+static void checkCache(U32 ways, U32 lines, U32 lineSize)
+{
+    std::vector<ADDRTYP> stream;
+    buildStream(stream, 2 * ways * lines * lineSize);
+
+    BenchCache<ADDRTYP> cache(ways, lines, lineSize);
+    RefCache<ADDRTYP> reference(ways, lines, lineSize);
+
+    U32 hits = 0;
+    U32 refHits = 0;
+    for(U32 a = 0; a < CACHE_STREAM_LENGTH; a++)
+    {
+        hits += cache.access(stream[a]) ? 1 : 0;
+        refHits += reference.access(stream[a]) ? 1 : 0;
+    }
+
+    CG_ASSERT_COND((hits == refHits), "Cache template hits (%d) differ from the reference model hits (%d) with %d ways and %d lines.",
+                   hits, refHits, ways, lines);
+}
+
+template<typename CACHE, typename ADDRTYP>
+static void cacheLookup(U32 ways, U32 lines, U32 lineSize, U64 iterations, BenchCounters &counters)
+{
+    static std::vector<ADDRTYP> stream;
+    if (stream.empty())
+        buildStream(stream, 2 * 16 * 64 * 64);
+
+    CACHE cache(ways, lines, lineSize);
+
+    U64 hits = 0;
+    for(U64 i = 0; i < iterations; i++)
+        hits += cache.access(stream[i & (CACHE_STREAM_LENGTH - 1)]) ? 1 : 0;
+
+    benchSink = benchSink + hits;
+    counters.ops = iterations;
+}
+
+void benchCache(BenchRunner &runner)
+{
+    if (runner.selected("cache/"))
+    {
+        static const U32 configs[][3] = {{4, 64, 64}, {8, 64, 64}, {16, 16, 256}, {32, 1, 64}, {64, 1, 64}, {4, 256, 256}};
+
+        for(U32 c = 0; c < (sizeof(configs) / sizeof(configs[0])); c++)
+        {
+            checkCache<U32>(configs[c][0], configs[c][1], configs[c][2]);
+            checkCache<U64>(configs[c][0], configs[c][1], configs[c][2]);
+        }
+    }
+
+    runner.run("cache/lookup_4w_256l", [](U64 n, BenchCounters &c) { cacheLookup<BenchCache<U32>, U32>(4, 256, 64, n, c); });
+    runner.run("cache/lookup_16w_64l", [](U64 n, BenchCounters &c) { cacheLookup<BenchCache<U32>, U32>(16, 64, 64, n, c); });
+    runner.run("cache/lookup_64w_1l", [](U64 n, BenchCounters &c) { cacheLookup<BenchCache<U32>, U32>(64, 1, 64, n, c); });
+    runner.run("cache/lookup_16w_64l_u64", [](U64 n, BenchCounters &c) { cacheLookup<BenchCache<U64>, U64>(16, 64, 64, n, c); });
+    runner.run("cache/lookup_ref_16w_64l", [](U64 n, BenchCounters &c) { cacheLookup<RefCache<U32>, U32>(16, 64, 64, n, c); });
+    runner.run("cache/lookup_ref_64w_1l", [](U64 n, BenchCounters &c) { cacheLookup<RefCache<U32>, U32>(64, 1, 64, n, c); });
+}
+
+} // namespace simbench
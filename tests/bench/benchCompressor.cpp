@@ -0,0 +1,134 @@
+/**************************************************************************
+ *
+ *  Color and depth block compressor microbenchmarks.
+ *
+ *  Compresses and uncompresses a fixed set of 64 element (256 byte) blocks with
+ *  the compressors created by bmoColorCompressor and bmoDepthCompressor.  Half
+ *  of the blocks are compressible (depth planes, flat and two color blocks) and
+ *  the other half are noise.  One operation is one block.
+ *
+ */
+
+#include "SimBench.h"
+#include "HiloCompressor.h"
+#include "MsaaCompressor.h"
+#include "ColorCompressor.h"
+#include "DepthCompressor.h"
+
+#include <cstring>
+
+namespace simbench
+{
+
+static const U32 COMPRESSOR_BLOCKS = 64;
+static const U32 BLOCK_ELEMENTS = 64;
+
+static void buildBlocks(std::vector<U32> &blocks, bool depth)
+{
+    blocks.resize(COMPRESSOR_BLOCKS * BLOCK_ELEMENTS);
+
+    U64 state = depth ? 0x2545f4914f6cdd1dULL : 0x9e3779b97f4a7c15ULL;
+
+    for(U32 b = 0; b < COMPRESSOR_BLOCKS; b++)
+    {
+        U32 *block = &blocks[b * BLOCK_ELEMENTS];
+
+        for(U32 e = 0; e < BLOCK_ELEMENTS; e++)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            U32 r = U32(state >> 32);
+            U32 x = e & 0x07;
+            U32 y = e >> 3;
+
+            if ((b & 1) != 0)
+                block[e] = r;
+            else if (depth)
+                block[e] = 0x00800000 + b * 0x1000 + x * 0x15 + y * 0x0b;
+            else if ((b & 2) != 0)
+                block[e] = 0xff204080 + b;
+            else
+                block[e] = ((x + y) < 6) ? 0xff102030 : 0xffa0b0c0;
+        }
+    }
+}
+
+static void compressBlocks(bmoCompressor &compressor, bool depth, U64 iterations, BenchCounters &counters)
+{
+    std::vector<U32> blocks;
+    buildBlocks(blocks, depth);
+
+    U32 output[BLOCK_ELEMENTS];
+    U64 compressedSize = 0;
+
+    for(U64 i = 0; i < iterations; i++)
+    {
+        const U32 *block = &blocks[(i % COMPRESSOR_BLOCKS) * BLOCK_ELEMENTS];
+        CompressorInfo info = compressor.compress(block, output, BLOCK_ELEMENTS);
+        compressedSize += info.success ? info.size : BLOCK_ELEMENTS * 4;
+    }
+
+    benchSink = benchSink + compressedSize;
+    counters.ops = iterations;
+    counters.bytes = iterations * BLOCK_ELEMENTS * 4;
+}
+
+static void uncompressBlocks(bmoCompressor &compressor, bool depth, U64 iterations, BenchCounters &counters)
+{
+    std::vector<U32> blocks;
+    buildBlocks(blocks, depth);
+
+    //  Compress the blocks that can be compressed and check the round trip.
+    std::vector<U32> compressed(COMPRESSOR_BLOCKS * BLOCK_ELEMENTS);
+    std::vector<S32> levels;
+    std::vector<U32> compressedBlocks;
+
+    for(U32 b = 0; b < COMPRESSOR_BLOCKS; b++)
+    {
+        U32 output[BLOCK_ELEMENTS];
+        CompressorInfo info = compressor.compress(&blocks[b * BLOCK_ELEMENTS], &compressed[b * BLOCK_ELEMENTS], BLOCK_ELEMENTS);
+        if (info.success)
+        {
+            compressor.uncompress(&compressed[b * BLOCK_ELEMENTS], output, BLOCK_ELEMENTS, info.level);
+            CG_ASSERT_COND((memcmp(output, &blocks[b * BLOCK_ELEMENTS], sizeof(output)) == 0),
+                           "Compressor round trip mismatch in block %d.", b);
+            levels.push_back(info.level);
+            compressedBlocks.push_back(b);
+        }
+    }
+
+    CG_ASSERT_COND(!compressedBlocks.empty(), "No compressible blocks.");
+
+    U32 output[BLOCK_ELEMENTS];
+    U64 check = 0;
+
+    for(U64 i = 0; i < iterations; i++)
+    {
+        U32 c = U32(i % compressedBlocks.size());
+        compressor.uncompress(&compressed[compressedBlocks[c] * BLOCK_ELEMENTS], output, BLOCK_ELEMENTS, levels[c]);
+        check += output[i & (BLOCK_ELEMENTS - 1)];
+    }
+
+    benchSink = benchSink + check;
+    counters.ops = iterations;
+    counters.bytes = iterations * BLOCK_ELEMENTS * 4;
+}
+
+void benchCompressor(BenchRunner &runner)
+{
+    //  Same configurations as bmoColorCompressor::configureCompressor and bmoDepthCompressor::configureCompressor.
+    static bmoHiloCompressor hilo(2, bmoColorCompressor::colorMask, false);
+    static bmoHiloCompressor hilore(3, bmoColorCompressor::colorMask, true);
+    static bmoMsaaCompressor msaa(bmoColorCompressor::blockSize);
+    static bmoHiloCompressor hiloz(bmoDepthCompressor::levels, bmoDepthCompressor::depthMask, false);
+
+    runner.run("compressor/hilo_color_compress", [](U64 n, BenchCounters &c) { compressBlocks(hilo, false, n, c); });
+    runner.run("compressor/hilo_color_uncompress", [](U64 n, BenchCounters &c) { uncompressBlocks(hilo, false, n, c); });
+    runner.run("compressor/hilore_color_compress", [](U64 n, BenchCounters &c) { compressBlocks(hilore, false, n, c); });
+    runner.run("compressor/hilore_color_uncompress", [](U64 n, BenchCounters &c) { uncompressBlocks(hilore, false, n, c); });
+    runner.run("compressor/msaa_color_compress", [](U64 n, BenchCounters &c) { compressBlocks(msaa, false, n, c); });
+    runner.run("compressor/msaa_color_uncompress", [](U64 n, BenchCounters &c) { uncompressBlocks(msaa, false, n, c); });
+    runner.run("compressor/hilo_depth_compress", [](U64 n, BenchCounters &c) { compressBlocks(hiloz, true, n, c); });
+    runner.run("compressor/hilo_depth_uncompress", [](U64 n, BenchCounters &c) { uncompressBlocks(hiloz, true, n, c); });
+}
+
+} // namespace simbench
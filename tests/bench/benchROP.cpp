@@ -0,0 +1,82 @@
+/**************************************************************************
+ *
+ *  ROP stamp kernel microbenchmarks.
+ *
+ *  Decodes the color buffer data, blends (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+ *  and encodes the result for a 4x MSAA stamp (16 pixels) with the kernels
+ *  selected by ROPStampKernels.  One operation is one stamp.
+ *
+ */
+
+#include "SimBench.h"
+#include "ROPStampKernels.h"
+
+namespace simbench
+{
+
+static const U32 ROP_STAMPS = 64;
+static const U32 ROP_STAMP_PIXELS = STAMP_FRAGMENTS * 4;
+
+static void blendStamps(TextureFormat format, bool sRGB, U64 iterations, BenchCounters &counters)
+{
+    ROPColorKernels kernels;
+    ROPStampKernels::selectColorKernels(format, sRGB, kernels);
+
+    ROPBlendState state;
+    ROPStampKernels::setupBlend(state, BLEND_FUNC_ADD, BLEND_SRC_ALPHA, BLEND_SRC_ALPHA,
+                                BLEND_ONE_MINUS_SRC_ALPHA, BLEND_ONE_MINUS_SRC_ALPHA, Vec4FP32(0.0f, 0.0f, 0.0f, 0.0f));
+
+    //  Build the input colors and the color buffer data for the stamps.
+    std::vector<ROPColorStamp> input(ROP_STAMPS);
+    std::vector<U08> data(ROP_STAMPS * ROP_STAMP_PIXELS * kernels.bytesPixel);
+
+    U64 state64 = 0x9e3779b97f4a7c15ULL;
+
+    for(U32 s = 0; s < ROP_STAMPS; s++)
+    {
+        for(U32 p = 0; p < ROP_STAMP_PIXELS; p++)
+        {
+            for(U32 c = 0; c < 4; c++)
+            {
+                state64 = state64 * 6364136223846793005ULL + 1442695040888963407ULL;
+                input[s].component[c][p] = F32(U32(state64 >> 40)) / F32(1 << 24);
+            }
+        }
+
+        ROPColorStamp dest = input[(s + 1) % ROP_STAMPS];
+        kernels.encode(dest, &data[s * ROP_STAMP_PIXELS * kernels.bytesPixel], ROP_STAMP_PIXELS);
+    }
+
+    ROPColorStamp color;
+    ROPColorStamp dest;
+    U64 check = 0;
+
+    for(U64 i = 0; i < iterations; i++)
+    {
+        U32 s = U32(i % ROP_STAMPS);
+        U08 *stampData = &data[s * ROP_STAMP_PIXELS * kernels.bytesPixel];
+
+        color = input[s];
+        if (kernels.clampInput)
+            ROPStampKernels::clamp(color, ROP_STAMP_PIXELS);
+        kernels.decode(stampData, dest, ROP_STAMP_PIXELS);
+        ROPStampKernels::blend(state, color, dest, ROP_STAMP_PIXELS);
+        kernels.encode(color, stampData, ROP_STAMP_PIXELS);
+
+        check += stampData[i & (ROP_STAMP_PIXELS - 1)];
+    }
+
+    benchSink = benchSink + check;
+    counters.ops = iterations;
+    counters.bytes = iterations * ROP_STAMP_PIXELS * kernels.bytesPixel;
+}
+
+void benchROP(BenchRunner &runner)
+{
+    runner.run("rop/blend_rgba8", [](U64 n, BenchCounters &c) { blendStamps(GPU_RGBA8888, false, n, c); });
+    runner.run("rop/blend_rgba8_srgb", [](U64 n, BenchCounters &c) { blendStamps(GPU_RGBA8888, true, n, c); });
+    runner.run("rop/blend_rgba16", [](U64 n, BenchCounters &c) { blendStamps(GPU_RGBA16, false, n, c); });
+    runner.run("rop/blend_rgba16f", [](U64 n, BenchCounters &c) { blendStamps(GPU_RGBA16F, false, n, c); });
+}
+
+} // namespace simbench
@@ -0,0 +1,126 @@
+/**************************************************************************
+ *
+ *  Rasterizer behavior model stamp generation microbenchmarks.
+ *
+ *  Sets up and rasterizes a fixed set of triangles with the recursive
+ *  algorithm used by bmoGpuTop::emulateRasterization.  One operation is one
+ *  generated stamp (fragment quad).
+ *
+ */
+
+#include "SimBench.h"
+#include "bmRasterizer.h"
+
+namespace simbench
+{
+
+static const U32 RAST_WIDTH = 1024;
+static const U32 RAST_HEIGHT = 768;
+
+//  Triangle positions in normalized device coordinates.
+struct BenchTriangle
+{
+    F32 v[3][2];
+};
+
+static void rasterizeTriangles(const BenchTriangle *triangles, U32 numTriangles, U64 iterations, BenchCounters &counters)
+{
+    bmoRasterizer raster(
+        1,                          //  Active triangles.
+        MAX_FRAGMENT_ATTRIBUTES,    //  Attributes per fragment.
+        16, 16,                     //  Scan tile.
+        16, 16,                     //  Over scan tile.
+        2, 2,                       //  Generation tile.
+        false,                      //  Bounding box optimization.
+        16                          //  Subpixel precision.
+        );
+
+    raster.setViewport(false, 0, 0, RAST_WIDTH, RAST_HEIGHT);
+    raster.setScissor(RAST_WIDTH, RAST_HEIGHT, false, 0, 0, RAST_WIDTH, RAST_HEIGHT);
+    raster.setDepthRange(false, 0.0f, 1.0f);
+    raster.setPolygonOffset(0.0f, 0.0f);
+    raster.setFaceMode(GPU_CCW);
+    raster.setDepthPrecission(24);
+    raster.setD3D9RasterizationRules(false);
+
+    U64 stamps = 0;
+    U64 inside = 0;
+
+    for(U64 i = 0; i < iterations; i++)
+    {
+        const BenchTriangle &t = triangles[i % numTriangles];
+
+        //  The setup triangle owns the attribute arrays.
+        Vec4FP32 *attrib[3];
+        for(U32 v = 0; v < 3; v++)
+        {
+            attrib[v] = new Vec4FP32[MAX_VERTEX_ATTRIBUTES];
+            attrib[v][POSITION_ATTRIBUTE] = Vec4FP32(t.v[v][0], t.v[v][1], 0.5f, 1.0f);
+            for(U32 a = 1; a < MAX_VERTEX_ATTRIBUTES; a++)
+                attrib[v][a] = Vec4FP32(F32(v), F32(a), 0.0f, 1.0f);
+        }
+
+        U32 triangleID = raster.setup(attrib[0], attrib[1], attrib[2]);
+
+        if (raster.triangleArea(triangleID) < 0)
+            raster.invertTriangleFacing(triangleID);
+
+        U32 batchID = raster.startRecursiveMulti(&triangleID, 1, false);
+        raster.updateRecursiveMultiv2(batchID);
+
+        while (!raster.lastFragment(triangleID))
+        {
+            U32 currentTriangleID;
+            Fragment **stamp = raster.nextStampRecursiveMulti(batchID, currentTriangleID);
+
+            if (stamp != NULL)
+            {
+                for(U32 f = 0; f < STAMP_FRAGMENTS; f++)
+                {
+                    inside += stamp[f]->isInsideTriangle() ? 1 : 0;
+                    delete stamp[f];
+                }
+                delete[] stamp;
+                stamps++;
+            }
+            else
+                raster.updateRecursiveMultiv2(batchID);
+        }
+
+        raster.destroyTriangle(triangleID);
+    }
+
+    benchSink = benchSink + inside;
+    counters.ops = stamps;
+}
+
+void benchRasterizer(BenchRunner &runner)
+{
+    //  A quarter of the viewport.
+    static const BenchTriangle large[] = {
+        {{{-0.5f, -0.5f}, { 0.5f, -0.5f}, { 0.0f,  0.5f}}},
+        {{{-0.9f, -0.9f}, { 0.1f, -0.8f}, {-0.4f,  0.2f}}},
+    };
+
+    //  Around 400 pixels.
+    static const BenchTriangle medium[] = {
+        {{{ 0.00f,  0.00f}, { 0.05f,  0.00f}, { 0.02f,  0.07f}}},
+        {{{-0.31f,  0.22f}, {-0.25f,  0.25f}, {-0.30f,  0.29f}}},
+        {{{ 0.41f, -0.63f}, { 0.46f, -0.58f}, { 0.38f, -0.57f}}},
+        {{{-0.72f,  0.51f}, {-0.66f,  0.50f}, {-0.69f,  0.56f}}},
+    };
+
+    //  Micro triangles of a few pixels.
+    static const BenchTriangle small[] = {
+        {{{ 0.000f,  0.000f}, { 0.006f,  0.000f}, { 0.002f,  0.008f}}},
+        {{{-0.310f,  0.220f}, {-0.304f,  0.224f}, {-0.309f,  0.229f}}},
+        {{{ 0.411f, -0.633f}, { 0.417f, -0.629f}, { 0.409f, -0.627f}}},
+        {{{-0.721f,  0.512f}, {-0.715f,  0.511f}, {-0.718f,  0.518f}}},
+    };
+
+    runner.run("rasterizer/stamps_large", [](U64 n, BenchCounters &c) { rasterizeTriangles(large, 2, n, c); });
+    runner.run("rasterizer/stamps_medium", [](U64 n, BenchCounters &c) { rasterizeTriangles(medium, 4, n, c); });
+    runner.run("rasterizer/stamps_small", [](U64 n, BenchCounters &c) { rasterizeTriangles(small, 4, n, c); });
+}
+
+} // namespace simbench
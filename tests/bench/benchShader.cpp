@@ -0,0 +1,126 @@
+/**************************************************************************
+ *
+ *  Unified shader behavior model instruction dispatch microbenchmarks.
+ *
+ *  Executes a fixed ALU program for a stamp of threads with the same fetch and
+ *  execute loop used by bmoGpuTop::emulateFragmentShader, with the stored decoded
+ *  instructions (behavior model) and with the light fetch (perfmodel shader
+ *  fetch).  One operation is one instruction executed by one thread.
+ *
+ */
+
+#include "SimBench.h"
+#include "bmUnifiedShader.h"
+
+namespace simbench
+{
+
+//  Instruction with up to three operands.
+static cgoShaderInstr *aluInstr(ShOpcode opc, Bank op1B, U32 op1R, Bank op2B, U32 op2R, Bank op3B, U32 op3R,
+                                Bank resB, U32 resR, SwizzleMode op1M = XYZW, bool op2N = false,
+                                bool op1A = false, bool last = false)
+{
+    return new cgoShaderInstr(opc,
+                              op1B, op1R, false, op1A, op1M,
+                              op2B, op2R, op2N, false, XYZW,
+                              op3B, op3R, false, false, XYZW,
+                              resB, resR, false, mXYZW,
+                              false, false, 0,
+                              false, 0, 0, 0,
+                              last);
+}
+
+//  Builds the benchmark program.  Returns the number of instructions.
+static U32 buildProgram(std::vector<U08> &code)
+{
+    std::vector<cgoShaderInstr *> program;
+
+    program.push_back(aluInstr(CG_ISA_OPCODE_MUL, arch::IN, 0, PARAM, 0, INVALID, 0, TEMP, 0));
+    program.push_back(aluInstr(CG_ISA_OPCODE_MAD, arch::IN, 1, PARAM, 1, TEMP, 0, TEMP, 1));
+    program.push_back(aluInstr(CG_ISA_OPCODE_DP4, TEMP, 1, PARAM, 2, INVALID, 0, TEMP, 2));
+    program.push_back(aluInstr(CG_ISA_OPCODE_ADD, TEMP, 1, TEMP, 2, INVALID, 0, TEMP, 3, XYZW, true));
+    program.push_back(aluInstr(CG_ISA_OPCODE_MAX, TEMP, 3, PARAM, 3, INVALID, 0, TEMP, 4));
+    program.push_back(aluInstr(CG_ISA_OPCODE_MIN, TEMP, 4, PARAM, 4, INVALID, 0, TEMP, 5));
+    program.push_back(aluInstr(CG_ISA_OPCODE_RCP, TEMP, 5, INVALID, 0, INVALID, 0, TEMP, 6, XXXX));
+    program.push_back(aluInstr(CG_ISA_OPCODE_MUL, TEMP, 6, TEMP, 1, INVALID, 0, TEMP, 7));
+    program.push_back(aluInstr(CG_ISA_OPCODE_DP3, TEMP, 7, PARAM, 5, INVALID, 0, TEMP, 8));
+    program.push_back(aluInstr(CG_ISA_OPCODE_FRC, TEMP, 8, INVALID, 0, INVALID, 0, TEMP, 9));
+    program.push_back(aluInstr(CG_ISA_OPCODE_MAD, TEMP, 9, PARAM, 6, TEMP, 7, TEMP, 10));
+    program.push_back(aluInstr(CG_ISA_OPCODE_RSQ, TEMP, 10, INVALID, 0, INVALID, 0, TEMP, 11, XXXX, false, true));
+    program.push_back(aluInstr(CG_ISA_OPCODE_MUL, TEMP, 11, TEMP, 10, INVALID, 0, TEMP, 12));
+    program.push_back(aluInstr(CG_ISA_OPCODE_ADD, TEMP, 12, TEMP, 3, INVALID, 0, OUT, 0, XYZW, false, false, true));
+
+    U32 numInstr = U32(program.size());
+    code.assign(numInstr * cgoShaderInstr::CG_ISA_INSTR_SIZE, 0);
+    for(U32 i = 0; i < numInstr; i++)
+    {
+        program[i]->getCode(&code[i * cgoShaderInstr::CG_ISA_INSTR_SIZE]);
+        delete program[i];
+    }
+
+    return numInstr;
+}
+
+static void shaderDispatch(bool storeDecoded, U64 iterations, BenchCounters &counters)
+{
+    bmoUnifiedShader shader((char *) "BenchShader", UNIFIED, CG_BEHV_MODEL, STAMP_FRAGMENTS, storeDecoded, STAMP_FRAGMENTS, 16);
+
+    std::vector<U08> code;
+    buildProgram(code);
+    shader.loadShaderProgram(&code[0], 0, U32(code.size()), VERTEX_PARTITION);
+
+    for(U32 c = 0; c < 8; c++)
+        shader.loadShaderState(0, PARAM, c, Vec4FP32(0.5f + F32(c), 0.25f, -1.0f + F32(c) * 0.125f, 1.0f));
+
+    Vec4FP32 input[MAX_VERTEX_ATTRIBUTES];
+    Vec4FP32 output[MAX_VERTEX_ATTRIBUTES];
+    U64 executed = 0;
+    F32 check = 0.0f;
+
+    //  Each iteration shades a stamp.
+    for(U64 i = 0; i < iterations; i++)
+    {
+        for(U32 t = 0; t < STAMP_FRAGMENTS; t++)
+        {
+            for(U32 a = 0; a < MAX_VERTEX_ATTRIBUTES; a++)
+                input[a] = Vec4FP32(F32(i & 0xff) * 0.01f, F32(t), F32(a), 1.0f);
+
+            shader.resetShaderState(t);
+            shader.loadShaderState(t, arch::IN, input);
+            shader.setThreadPC(t, 0);
+        }
+
+        bool programEnd = false;
+        for(U32 pc = 0; !programEnd; pc++)
+        {
+            for(U32 t = 0; t < STAMP_FRAGMENTS; t++)
+            {
+                //  The light fetch (used by the perfmodel shader fetch) decodes a new instruction
+                //  that is deleted after execution.
+                cgoShaderInstr::cgoShaderInstrEncoding *shDecInstr = storeDecoded ?
+                    shader.FetchInstr(t, pc) : shader.fetchShaderInstructionLight(t, pc, VERTEX_PARTITION);
+                shader.execShaderInstruction(shDecInstr);
+                programEnd = shDecInstr->getShaderInstruction()->getEndFlag();
+
+                if (!storeDecoded)
+                    delete shDecInstr;
+
+                executed++;
+            }
+        }
+
+        shader.readShaderState(0, arch::OUT, output);
+        check += output[0][0];
+    }
+
+    benchSink = benchSink + U64(check != 0.0f);
+    counters.ops = executed;
+}
+
+void benchShader(BenchRunner &runner)
+{
+    runner.run("shader/dispatch_decoded", [](U64 n, BenchCounters &c) { shaderDispatch(true, n, c); });
+    runner.run("shader/dispatch_fetch_light", [](U64 n, BenchCounters &c) { shaderDispatch(false, n, c); });
+}
+
+} // namespace simbench
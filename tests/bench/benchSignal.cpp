@@ -0,0 +1,169 @@
+/**************************************************************************
+ *
+ *  Signal read/write microbenchmarks.
+ *
+ *  Every cycle the consumer reads all the objects that arrive and the producer
+ *  writes bandwidth objects, the same pattern the MDUs use in clock().  One
+ *  operation is the transfer of one object (a write and its read).
+ *
+ *  The state benchmarks send an MDU state upstream every cycle, the state
+ *  changes every STATE_CHANGE_CYCLES cycles.  One operation is one cycle.
+ *
+ */
+
+#include "SimBench.h"
+#include "GPUSignal.h"
+#include "DynamicObject.h"
+#include "StateWire.h"
+#include "RasterizerStateInfo.h"
+
+namespace simbench
+{
+
+//  Transfers preallocated objects through the signal.
+static void signalTransfer(U32 bandwidth, U32 latency, U64 iterations, BenchCounters &counters)
+{
+    Signal signal("BenchSignal", bandwidth, latency);
+
+    std::vector<DynamicObject *> objects(bandwidth);
+    for(U32 o = 0; o < bandwidth; o++)
+        objects[o] = new DynamicObject();
+
+    U64 transfers = 0;
+    U64 cycle = 0;
+
+    for(; cycle < iterations; cycle++)
+    {
+        DynamicObject *object;
+        while (signal.read(cycle, object))
+            transfers++;
+
+        for(U32 w = 0; w < bandwidth; w++)
+            signal.write(cycle, objects[w]);
+    }
+
+    //  Drain the signal.
+    for(U32 c = 0; c <= latency; c++, cycle++)
+    {
+        DynamicObject *object;
+        while (signal.read(cycle, object))
+            transfers++;
+    }
+
+    for(U32 o = 0; o < bandwidth; o++)
+        delete objects[o];
+
+    benchSink = benchSink + transfers;
+    counters.ops = transfers;
+}
+
+//  Transfers objects created by the producer and deleted by the consumer.
+static void signalTransferNewDelete(U32 bandwidth, U32 latency, U64 iterations, BenchCounters &counters)
+{
+    Signal signal("BenchSignal", bandwidth, latency);
+
+    U64 transfers = 0;
+    U64 cycle = 0;
+
+    for(; cycle < iterations; cycle++)
+    {
+        DynamicObject *object;
+        while (signal.read(cycle, object))
+        {
+            delete object;
+            transfers++;
+        }
+
+        for(U32 w = 0; w < bandwidth; w++)
+            signal.write(cycle, new DynamicObject());
+    }
+
+    for(U32 c = 0; c <= latency; c++, cycle++)
+    {
+        DynamicObject *object;
+        while (signal.read(cycle, object))
+        {
+            delete object;
+            transfers++;
+        }
+    }
+
+    benchSink = benchSink + transfers;
+    counters.ops = transfers;
+}
+
+static const U32 STATE_CHANGE_CYCLES = 64;
+
+static RasterizerState benchState(U64 cycle)
+{
+    return ((cycle / STATE_CHANGE_CYCLES) & 1) ? RAST_DRAWING : RAST_READY;
+}
+
+//  Sends a new state object every cycle, deleted by the consumer.
+static void stateNewDelete(U64 iterations, BenchCounters &counters)
+{
+    Signal signal("BenchState", 1, 1);
+
+    DynamicObject *initial[1];
+    initial[0] = new RasterizerStateInfo(RAST_RESET);
+    signal.setData(initial);
+
+    U64 check = 0;
+
+    for(U64 cycle = 0; cycle < iterations; cycle++)
+    {
+        RasterizerStateInfo *stateInfo;
+        if (signal.read(cycle, (DynamicObject *&) stateInfo))
+        {
+            check += stateInfo->getState();
+            delete stateInfo;
+        }
+
+        signal.write(cycle, new RasterizerStateInfo(benchState(cycle)));
+    }
+
+    DynamicObject *object;
+    if (signal.read(iterations, object))
+        delete object;
+
+    benchSink = benchSink + check;
+    counters.ops = iterations;
+}
+
+//  Sends the state through a state wire.
+static void stateWire(U64 iterations, BenchCounters &counters)
+{
+    Signal signal("BenchState", 1, 1);
+
+    StateWire<RasterizerStateInfo> writer;
+    StateWire<RasterizerStateInfo> reader;
+    writer = &signal;
+    reader = &signal;
+    writer.setInitial(RAST_RESET);
+
+    U64 check = 0;
+
+    for(U64 cycle = 0; cycle < iterations; cycle++)
+    {
+        RasterizerState state;
+        if (reader.read(cycle, state))
+            check += state;
+
+        writer.write(cycle, benchState(cycle));
+    }
+
+    benchSink = benchSink + check;
+    counters.ops = iterations;
+}
+
+void benchSignal(BenchRunner &runner)
+{
+    runner.run("signal/transfer_bw1_lat1", [](U64 n, BenchCounters &c) { signalTransfer(1, 1, n, c); });
+    runner.run("signal/transfer_bw4_lat2", [](U64 n, BenchCounters &c) { signalTransfer(4, 2, n, c); });
+    runner.run("signal/transfer_bw16_lat8", [](U64 n, BenchCounters &c) { signalTransfer(16, 8, n, c); });
+    runner.run("signal/transfer_new_delete_bw4_lat2", [](U64 n, BenchCounters &c) { signalTransferNewDelete(4, 2, n, c); });
+    runner.run("signal/state_new_delete", [](U64 n, BenchCounters &c) { stateNewDelete(n, c); });
+    runner.run("signal/state_wire", [](U64 n, BenchCounters &c) { stateWire(n, c); });
+}
+
+} // namespace simbench
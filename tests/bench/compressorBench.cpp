@@ -0,0 +1,242 @@
+/**************************************************************************
+ *
+ *  Color and depth block compressor throughput benchmark.
+ *
+ *  Usage: compressorbench [--color <corpus file>]... [--depth <corpus file>]...
+ *                         [--kernels <name>] [--min-time <seconds>]
+ *
+ *  Compresses and uncompresses the blocks captured with the simulator option
+ *  --capture-blocks <prefix> (<prefix>.ColorCache.bin for --color and
+ *  <prefix>.ZCache.bin for --depth) with the color and depth compressors and each
+ *  kernel implementation supported by the CPU.  Reports blocks per second and the
+ *  compression ratio (uncompressed bytes / compressed bytes).  Without corpus files
+ *  synthetic blocks are used.
+ *
+ */
+
+#include "HiloCompressor.h"
+#include "MsaaCompressor.h"
+#include "ColorCompressor.h"
+#include "DepthCompressor.h"
+#include "CompressorKernels.h"
+#include "BlockCorpus.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace arch;
+
+static const U32 BLOCK_ELEMENTS = 64;
+
+static volatile U64 sink = 0;
+
+//  Same synthetic blocks as the simbench compressor benchmarks.
+static void buildBlocks(std::vector<U32> &blocks, bool depth)
+{
+    static const U32 SYNTHETIC_BLOCKS = 4096;
+
+    blocks.resize(SYNTHETIC_BLOCKS * BLOCK_ELEMENTS);
+
+    U64 state = depth ? 0x2545f4914f6cdd1dULL : 0x9e3779b97f4a7c15ULL;
+
+    for(U32 b = 0; b < SYNTHETIC_BLOCKS; b++)
+    {
+        U32 *block = &blocks[b * BLOCK_ELEMENTS];
+
+        for(U32 e = 0; e < BLOCK_ELEMENTS; e++)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            U32 r = U32(state >> 32);
+            U32 x = e & 0x07;
+            U32 y = e >> 3;
+
+            if ((b & 1) != 0)
+                block[e] = r;
+            else if (depth)
+                block[e] = 0x00800000 + b * 0x1000 + x * 0x15 + y * 0x0b;
+            else if ((b & 2) != 0)
+                block[e] = 0xff204080 + b;
+            else
+                block[e] = ((x + y) < 6) ? 0xff102030 : 0xffa0b0c0;
+        }
+    }
+}
+
+static F64 seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void runCompressor(const char *name, bmoCompressor &compressor, const char *kernels,
+                          const std::vector<U32> &blocks, F64 minTime)
+{
+    U32 numBlocks = U32(blocks.size() / BLOCK_ELEMENTS);
+    std::vector<U32> compressed(blocks.size());
+    std::vector<CompressorInfo> info(numBlocks);
+    U32 output[BLOCK_ELEMENTS];
+
+    //  Compression ratio and levels.
+    U64 compressedBytes = 0;
+    U32 levels[8] = {0};
+
+    for(U32 b = 0; b < numBlocks; b++)
+    {
+        info[b] = compressor.compress(&blocks[b * BLOCK_ELEMENTS], &compressed[b * BLOCK_ELEMENTS], BLOCK_ELEMENTS);
+        compressedBytes += info[b].size;
+        levels[info[b].success ? info[b].level : 7]++;
+    }
+
+    //  Compression throughput.
+    U64 passes = 0;
+    U64 check = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    F64 compressTime;
+
+    do
+    {
+        for(U32 b = 0; b < numBlocks; b++)
+            check += compressor.compress(&blocks[b * BLOCK_ELEMENTS], output, BLOCK_ELEMENTS).size;
+        passes++;
+    } while ((compressTime = seconds(start)) < minTime);
+
+    F64 compressRate = F64(passes * numBlocks) / compressTime;
+
+    //  Uncompression throughput (compressed blocks only).
+    U64 uncompressed = 0;
+    passes = 0;
+    start = std::chrono::steady_clock::now();
+    F64 uncompressTime;
+
+    do
+    {
+        for(U32 b = 0; b < numBlocks; b++)
+        {
+            if (info[b].success)
+            {
+                compressor.uncompress(&compressed[b * BLOCK_ELEMENTS], output, BLOCK_ELEMENTS, info[b].level);
+                check += output[b & (BLOCK_ELEMENTS - 1)];
+                uncompressed++;
+            }
+        }
+        passes++;
+    } while (((uncompressTime = seconds(start)) < minTime) && (uncompressed != 0));
+
+    F64 uncompressRate = F64(uncompressed) / uncompressTime;
+
+    sink = sink + check;
+
+    printf("%-8s %-8s %14.0f blocks/s %14.0f blocks/s %8.3f  %5.1f%% %5.1f%% %5.1f%% %5.1f%% %5.1f%% %5.1f%%\n",
+           name, kernels, compressRate, uncompressRate,
+           F64(numBlocks) * BLOCK_ELEMENTS * sizeof(U32) / F64(compressedBytes),
+           100.0 * levels[0] / numBlocks, 100.0 * levels[1] / numBlocks, 100.0 * levels[2] / numBlocks,
+           100.0 * levels[3] / numBlocks, 100.0 * levels[4] / numBlocks, 100.0 * levels[7] / numBlocks);
+    fflush(stdout);
+}
+
+static void usage(const char *program)
+{
+    printf("Usage: %s [--color <corpus file>]... [--depth <corpus file>]... [--kernels <name>] [--min-time <seconds>]\n",
+           program);
+}
+
+static bool loadCorpus(const std::vector<const char *> &files, std::vector<U32> &blocks)
+{
+    for(size_t f = 0; f < files.size(); f++)
+    {
+        S32 loaded = bmoBlockCorpus::load(files[f], BLOCK_ELEMENTS, blocks);
+
+        if (loaded < 0)
+        {
+            printf("ERROR: can't read %s\n", files[f]);
+            return false;
+        }
+
+        printf("%s : %d blocks\n", files[f], loaded);
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<const char *> colorFiles;
+    std::vector<const char *> depthFiles;
+    const char *kernelsName = NULL;
+    F64 minTime = 0.5;
+
+    for(int a = 1; a < argc; a++)
+    {
+        if ((strcmp(argv[a], "--color") == 0) && (a + 1 < argc))
+            colorFiles.push_back(argv[++a]);
+        else if ((strcmp(argv[a], "--depth") == 0) && (a + 1 < argc))
+            depthFiles.push_back(argv[++a]);
+        else if ((strcmp(argv[a], "--kernels") == 0) && (a + 1 < argc))
+            kernelsName = argv[++a];
+        else if ((strcmp(argv[a], "--min-time") == 0) && (a + 1 < argc))
+            minTime = atof(argv[++a]);
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    std::vector<U32> colorBlocks;
+    std::vector<U32> depthBlocks;
+
+    if (!loadCorpus(colorFiles, colorBlocks) || !loadCorpus(depthFiles, depthBlocks))
+        return -1;
+
+    if (colorFiles.empty() && depthFiles.empty())
+    {
+        buildBlocks(colorBlocks, false);
+        buildBlocks(depthBlocks, true);
+        printf("Synthetic blocks : %u color, %u depth\n", U32(colorBlocks.size() / BLOCK_ELEMENTS),
+               U32(depthBlocks.size() / BLOCK_ELEMENTS));
+    }
+
+    U32 numKernels;
+    const bmoCompressorKernels *const *kernels = bmoCompressorKernels::getAvailable(numKernels);
+
+    if ((kernelsName != NULL) && (bmoCompressorKernels::find(kernelsName) == NULL))
+    {
+        printf("ERROR: kernels %s not supported\n", kernelsName);
+        return -1;
+    }
+
+    printf("%-8s %-8s %23s %23s %8s  %6s %6s %6s %6s %6s %6s\n", "", "kernels", "compress", "uncompress", "ratio",
+           "lvl 0", "lvl 1", "lvl 2", "lvl 3", "lvl 4", "none");
+
+    for(U32 k = 0; k < numKernels; k++)
+    {
+        if ((kernelsName != NULL) && (strcmp(kernelsName, kernels[k]->name) != 0))
+            continue;
+
+        //  Same configurations as bmoColorCompressor::configureCompressor and bmoDepthCompressor::configureCompressor.
+        bmoHiloCompressor hilo(2, bmoColorCompressor::colorMask, false);
+        bmoHiloCompressor hilore(3, bmoColorCompressor::colorMask, true);
+        bmoMsaaCompressor msaa(bmoColorCompressor::blockSize);
+        bmoHiloCompressor hiloz(bmoDepthCompressor::levels, bmoDepthCompressor::depthMask, false);
+
+        hilo.setKernels(*kernels[k]);
+        hilore.setKernels(*kernels[k]);
+        msaa.setKernels(*kernels[k]);
+        hiloz.setKernels(*kernels[k]);
+
+        if (!colorBlocks.empty())
+        {
+            runCompressor("hilo", hilo, kernels[k]->name, colorBlocks, minTime);
+            runCompressor("hilore", hilore, kernels[k]->name, colorBlocks, minTime);
+            runCompressor("msaa", msaa, kernels[k]->name, colorBlocks, minTime);
+        }
+
+        if (!depthBlocks.empty())
+            runCompressor("hiloz", hiloz, kernels[k]->name, depthBlocks, minTime);
+    }
+
+    return 0;
+}
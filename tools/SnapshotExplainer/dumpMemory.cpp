@@ -0,0 +1,124 @@
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include "PagedSnapshot.h"
+
+using namespace std;
+using namespace arch;
+
+//  Prints the header of every file in a paged snapshot chain.
+void dumpChain(const string &fileName);
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage:\n");
+        printf("  dumpMemory <paged memory snapshot file> [output memory image]\n");
+        printf("\n");
+        printf("  Paged memory snapshots (*.psnap) only store the pages changed since the parent snapshot.\n");
+        printf("  If an output file is defined the snapshot chain is restored into a flat memory image.\n");
+        exit(-1);
+    }
+
+    cgsPagedSnapshotHeader header;
+    string parentName;
+
+    if (!cgoPagedSnapshot::readHeader(argv[1], header, parentName))
+    {
+        printf("Error opening paged memory snapshot file\n");
+        exit(-1);
+    }
+
+    dumpChain(argv[1]);
+
+    //  Restore the chain and count the pages restored from each file in the chain.
+    vector<U08> image;
+    vector<U32> pagesPerDepth(header.chainDepth + 1, 0);
+    U32 numPages = U32((header.memorySize + header.pageSize - 1) / header.pageSize);
+    vector<bool> touched(numPages, false);
+
+    bool extract = (argc > 2);
+
+    if (extract)
+        image.resize(size_t(header.memorySize));
+
+    bool restored = cgoPagedSnapshot::restore(argv[1],
+        [&image, extract](U64 offset, const U08 *buffer, U32 bytes)
+        {
+            if (extract)
+                memcpy(&image[size_t(offset)], buffer, bytes);
+        },
+        [&pagesPerDepth, &touched](U32 page, U32 depth)
+        {
+            pagesPerDepth[depth]++;
+            touched[page] = true;
+        });
+
+    if (!restored)
+    {
+        printf("Error restoring the paged memory snapshot chain\n");
+        exit(-1);
+    }
+
+    U32 touchedPages = 0;
+    for(U32 p = 0; p < numPages; p++)
+        touchedPages += touched[p] ? 1 : 0;
+
+    printf("\n");
+    for(U32 d = 0; d <= header.chainDepth; d++)
+        printf("Chain depth %2d : %8d pages\n", d, pagesPerDepth[d]);
+    printf("Touched footprint : %d of %d pages (%.2f MB)\n", touchedPages, numPages,
+           double(touchedPages) * header.pageSize / (1024.0 * 1024.0));
+
+    if (extract)
+    {
+        ofstream out(argv[2], ios::binary);
+
+        if (!out.is_open())
+        {
+            printf("Error creating output memory image file\n");
+            exit(-1);
+        }
+
+        out.write((char *) &image[0], image.size());
+        out.close();
+
+        printf("Memory image written to %s\n", argv[2]);
+    }
+}
+
+void dumpChain(const string &fileName)
+{
+    string current = fileName;
+
+    while (!current.empty())
+    {
+        cgsPagedSnapshotHeader header;
+        string parentName;
+
+        if (!cgoPagedSnapshot::readHeader(current, header, parentName))
+        {
+            printf("Error reading paged memory snapshot file %s\n", current.c_str());
+            return;
+        }
+
+        printf("File = %s\n", current.c_str());
+        printf("  Version = %d\n", header.version);
+        printf("  Page Size = %d\n", header.pageSize);
+        printf("  Memory Size = %llu\n", (unsigned long long) header.memorySize);
+        printf("  Stored Pages = %d\n", header.pageCount);
+        printf("  Chain Depth = %d\n", header.chainDepth);
+        printf("  Fill Pattern = %08x\n", header.fillPattern);
+
+        if (header.chainDepth > 0)
+            printf("  Parent = %s\n", parentName.c_str());
+
+        current = (header.chainDepth > 0) ? parentName : string();
+    }
+}
@@ -138,6 +138,7 @@ void dumpRegisters(cgsGpuRegister &state)
     printf("StreamStart = %d\n", state.streamStart);
     printf("StreamCount = %d\n", state.streamCount);
     printf("StreamInstances = %d\n", state.streamInstances);
+    printf("StreamBaseVertex = %d\n", state.streamBaseVertex);
     printf("IndexedMode = %s\n", state.indexedMode ? "T" : "F");
     printf("IndexStream = %d\n", state.indexStream);
     for (U32 s = 0; s < MAX_STREAM_BUFFERS; s++)
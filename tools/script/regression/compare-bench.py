@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# -*- coding: UTF-8 -*-
+
+#
+# Compares two simbench JSON reports (simbench --json file).
+#
+# A benchmark is reported as a regression when the median time per operation
+# grows more than the threshold (percent) or when it allocates more per operation.
+# Exits with a non zero value when a regression is found.
+#
+
+import sys
+import json
+
+if len(sys.argv) < 3:
+    print ("Usage:", sys.argv[0], "baseline_json", "current_json", "[threshold_percent]")
+    sys.exit(-1)
+
+baseline_file = sys.argv[1]
+current_file = sys.argv[2]
+
+if len(sys.argv) > 3:
+    threshold = float(sys.argv[3])
+else:
+    threshold = 10.0
+
+def load_report(file_name):
+    try:
+        with open(file_name, 'r') as f:
+            report = json.load(f)
+    except (IOError, ValueError) as e:
+        print("Error reading " + file_name + ": " + str(e))
+        sys.exit(-1)
+
+    if 'benchmarks' not in report:
+        print("Not recognized report in " + file_name + ". \'benchmarks\' was expected.")
+        sys.exit(-1)
+
+    return report, dict((b['name'], b) for b in report['benchmarks'])
+
+baseline_report, baseline = load_report(baseline_file)
+current_report, current = load_report(current_file)
+
+for name, report in ((baseline_file, baseline_report), (current_file, current_report)):
+    context = report.get('context', {})
+    if context.get('debug', False):
+        print("Warning: " + name + " was generated by a debug build.")
+
+print("%-44s %14s %14s %9s %12s  %s" % ("Benchmark", "Base ns/op", "Curr ns/op", "Ratio", "Allocs/op", "Status"))
+
+regressions = 0
+
+for name in [b['name'] for b in baseline_report['benchmarks']]:
+    if name not in current:
+        continue
+
+    base = baseline[name]
+    curr = current[name]
+
+    base_ns = base['ns_per_op']
+    curr_ns = curr['ns_per_op']
+    ratio = (curr_ns / base_ns) if base_ns > 0 else 1.0
+
+    status = "ok"
+    if ratio > (1.0 + threshold / 100.0):
+        status = "REGRESSION"
+    elif ratio < (1.0 - threshold / 100.0):
+        status = "improved"
+
+    # Allocations per operation are deterministic, any increase is reported.
+    base_allocs = base.get('allocs_per_op', 0.0)
+    curr_allocs = curr.get('allocs_per_op', 0.0)
+    if curr_allocs > base_allocs + max(0.01, base_allocs * 0.01):
+        status = "REGRESSION (allocs %.3f -> %.3f)" % (base_allocs, curr_allocs)
+
+    if status.startswith("REGRESSION"):
+        regressions += 1
+
+    print("%-44s %14.2f %14.2f %9.3f %12.3f  %s" % (name, base_ns, curr_ns, ratio, curr_allocs, status))
+
+missing = [n for n in baseline if n not in current]
+added = [n for n in current if n not in baseline]
+
+if len(missing) > 0:
+    print("")
+    print("Missing in " + current_file + ": " + ", ".join(sorted(missing)))
+
+if len(added) > 0:
+    print("")
+    print("New in " + current_file + ": " + ", ".join(sorted(added)))
+
+print("")
+print("Threshold: " + str(threshold) + "%.  Regressions: " + str(regressions))
+
+if regressions > 0:
+    sys.exit(1)